@@ -41,6 +41,45 @@ void define_adaptive_stiffness(py::module_& m)
         py::arg("grad_energy"), py::arg("grad_barrier"),
         py::arg("min_barrier_stiffness_scale") = 1e11, py::arg("dmin") = 0);
 
+    m.def(
+        "initial_barrier_stiffness",
+        [](const double bbox_diagonal, const double dhat,
+           const double average_mass,
+           const double grad_energy_dot_grad_barrier,
+           const double grad_barrier_sqnorm,
+           const double min_barrier_stiffness_scale = 1e11,
+           const double dmin = 0) {
+            double max_barrier_stiffness;
+            double r = initial_barrier_stiffness(
+                bbox_diagonal, dhat, average_mass,
+                grad_energy_dot_grad_barrier, grad_barrier_sqnorm,
+                max_barrier_stiffness, min_barrier_stiffness_scale, dmin);
+            return std::make_tuple(r, max_barrier_stiffness);
+        },
+        R"ipc_Qu8mg5v7(
+        Compute an inital barrier stiffness from precomputed gradient products.
+
+        Overload for callers that already hold the two gradient reductions (e.g. from their own fused gradient pass).
+
+        Parameters:
+            bbox_diagonal: Length of the diagonal of the bounding box of the scene.
+            dhat: Activation distance of the barrier.
+            average_mass: Average mass of all bodies.
+            grad_energy_dot_grad_barrier: Dot product of the elasticity energy and barrier potential gradients.
+            grad_barrier_sqnorm: Squared norm of the barrier potential gradient.
+            min_barrier_stiffness_scale: Scale used to premultiply the minimum barrier stiffness.
+            dmin: Minimum distance between elements.
+
+        Returns:
+            Tuple of:
+            The initial barrier stiffness.
+            Maximum stiffness of the barrier.
+        )ipc_Qu8mg5v7",
+        py::arg("bbox_diagonal"), py::arg("dhat"), py::arg("average_mass"),
+        py::arg("grad_energy_dot_grad_barrier"),
+        py::arg("grad_barrier_sqnorm"),
+        py::arg("min_barrier_stiffness_scale") = 1e11, py::arg("dmin") = 0);
+
     m.def(
         "update_barrier_stiffness", &update_barrier_stiffness,
         R"ipc_Qu8mg5v7(
@@ -25,7 +25,8 @@ void define_barrier(py::module_& m)
         py::arg("d"), py::arg("dhat"));
 
     m.def(
-        "barrier_gradient", &barrier_gradient,
+        "barrier_gradient",
+        py::overload_cast<const double, const double>(&barrier_gradient),
         R"ipc_Qu8mg5v7(
         Derivative of the barrier function.
 
@@ -41,7 +42,8 @@ void define_barrier(py::module_& m)
         py::arg("d"), py::arg("dhat"));
 
     m.def(
-        "barrier_hessian", &barrier_hessian,
+        "barrier_hessian",
+        py::overload_cast<const double, const double>(&barrier_hessian),
         R"ipc_Qu8mg5v7(
         Second derivative of the barrier function.
 
@@ -55,4 +57,51 @@ void define_barrier(py::module_& m)
             The second derivative of the barrier wrt d.
         )ipc_Qu8mg5v7",
         py::arg("d"), py::arg("dhat"));
+
+    m.def(
+        "barrier_batch",
+        py::overload_cast<const Eigen::ArrayXd&, const double>(&barrier),
+        R"ipc_Qu8mg5v7(
+        Batched version of the barrier function.
+
+        Parameters:
+            d: distances
+            dhat: activation distance of the barrier
+
+        Returns:
+            The value of the barrier function at each distance.
+        )ipc_Qu8mg5v7",
+        py::arg("d"), py::arg("dhat"));
+
+    m.def(
+        "barrier_gradient_batch",
+        py::overload_cast<const Eigen::ArrayXd&, const double>(
+            &barrier_gradient),
+        R"ipc_Qu8mg5v7(
+        Batched version of the barrier derivative.
+
+        Parameters:
+            d: distances
+            dhat: activation distance of the barrier
+
+        Returns:
+            The derivative of the barrier wrt each distance.
+        )ipc_Qu8mg5v7",
+        py::arg("d"), py::arg("dhat"));
+
+    m.def(
+        "barrier_hessian_batch",
+        py::overload_cast<const Eigen::ArrayXd&, const double>(
+            &barrier_hessian),
+        R"ipc_Qu8mg5v7(
+        Batched version of the barrier second derivative.
+
+        Parameters:
+            d: distances
+            dhat: activation distance of the barrier
+
+        Returns:
+            The second derivative of the barrier wrt each distance.
+        )ipc_Qu8mg5v7",
+        py::arg("d"), py::arg("dhat"));
 }
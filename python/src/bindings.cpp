@@ -8,11 +8,15 @@ void define_barrier(py::module_& m);
 
 // broad_phase
 void define_aabb(py::module_& m);
+void define_adaptive_broad_phase(py::module_& m);
 void define_broad_phase(py::module_& m);
 void define_brute_force(py::module_& m);
+void define_bvh(py::module_& m);
 void define_collision_candidate(py::module_& m);
+void define_component_broad_phase(py::module_& m);
 void define_hash_grid(py::module_& m);
 void define_spatial_hash(py::module_& m);
+void define_static_obstacle(py::module_& m);
 void define_sweep(py::module_& m);
 void define_voxel_size_heuristic(py::module_& m);
 
@@ -53,6 +57,7 @@ void define_world_bbox_diagonal_length(py::module_& m);
 void define_collision_constraint(py::module_& m);
 void define_collision_mesh(py::module_& m);
 void define_ipc(py::module_& m);
+void define_step_context(py::module_& m);
 
 PYBIND11_MODULE(ipctk, m)
 {
@@ -68,10 +73,14 @@ PYBIND11_MODULE(ipctk, m)
     // broad_phase
     define_aabb(m);
     define_broad_phase(m);
+    define_adaptive_broad_phase(m);
     define_brute_force(m);
+    define_bvh(m);
     define_collision_candidate(m);
+    define_component_broad_phase(m);
     define_hash_grid(m);
     define_spatial_hash(m);
+    define_static_obstacle(m);
     define_sweep(m);
     define_voxel_size_heuristic(m);
 
@@ -112,4 +121,5 @@ PYBIND11_MODULE(ipctk, m)
     define_collision_constraint(m);
     define_collision_mesh(m);
     define_ipc(m);
+    define_step_context(m);
 }
@@ -0,0 +1,48 @@
+#include "../common.hpp"
+
+#include <ipc/broad_phase/adaptive_broad_phase.hpp>
+
+namespace py = pybind11;
+using namespace ipc;
+
+void define_adaptive_broad_phase(py::module_& m)
+{
+    py::class_<AdaptiveBroadPhase, BroadPhase>(
+        m, "AdaptiveBroadPhase",
+        R"ipc_Qu8mg5v7(
+        Broad phase that picks its method from measured timings.
+
+        A measurement round builds with each candidate method in turn and
+        charges it its build plus detection wall time; the fastest method
+        then serves the next reevaluation_period builds before another round
+        runs. The incumbent is only replaced when a challenger beats it by
+        the hysteresis margin.
+        )ipc_Qu8mg5v7")
+        .def(
+            py::init<std::vector<BroadPhaseMethod>>(),
+            R"ipc_Qu8mg5v7(
+            Construct the adaptive broad phase.
+
+            Parameters:
+                candidate_methods: The methods to choose between.
+            )ipc_Qu8mg5v7",
+            py::arg("candidate_methods") = std::vector<BroadPhaseMethod> {
+                BroadPhaseMethod::HASH_GRID,
+                BroadPhaseMethod::SPATIAL_HASH,
+                BroadPhaseMethod::BVH,
+                BroadPhaseMethod::SWEEP_AND_TINIEST_QUEUE,
+            })
+        .def(
+            "current_method", &AdaptiveBroadPhase::current_method,
+            "The method the inner structure currently uses.")
+        .def_readwrite(
+            "reevaluation_period", &AdaptiveBroadPhase::reevaluation_period,
+            "Builds served by a selection before it is re-evaluated.")
+        .def_readwrite(
+            "hysteresis", &AdaptiveBroadPhase::hysteresis,
+            "Relative time a challenger must beat the incumbent by.")
+        .def_readwrite(
+            "candidate_drift_factor",
+            &AdaptiveBroadPhase::candidate_drift_factor,
+            "Candidate-count drift that triggers an early re-evaluation.");
+}
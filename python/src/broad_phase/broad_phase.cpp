@@ -13,16 +13,68 @@ void define_broad_phase(py::module_& m)
         .value("BRUTE_FORCE", BroadPhaseMethod::BRUTE_FORCE, "")
         .value("HASH_GRID", BroadPhaseMethod::HASH_GRID, "")
         .value("SPATIAL_HASH", BroadPhaseMethod::SPATIAL_HASH, "")
+        .value("BVH", BroadPhaseMethod::BVH, "")
         .value(
             "SWEEP_AND_TINIEST_QUEUE",
             BroadPhaseMethod::SWEEP_AND_TINIEST_QUEUE, "")
+        .value(
+            "TWO_LEVEL_SPATIAL_HASH", BroadPhaseMethod::TWO_LEVEL_SPATIAL_HASH,
+            "")
+        .value(
+            "AUTO", BroadPhaseMethod::AUTO,
+            "Selects among the methods from measured timings")
 #ifdef IPC_TOOLKIT_WITH_CUDA
         .value(
             "SWEEP_AND_TINIEST_QUEUE_GPU",
             BroadPhaseMethod::SWEEP_AND_TINIEST_QUEUE_GPU, "")
+        .value("HASH_GRID_GPU", BroadPhaseMethod::HASH_GRID_GPU, "")
 #endif
         .export_values();
 
+    py::class_<BroadPhaseStats>(
+        m, "BroadPhaseStats",
+        "Opt-in statistics describing the last broad phase build and detect "
+        "queries.")
+        .def(py::init<>())
+        .def_readwrite(
+            "build_time", &BroadPhaseStats::build_time,
+            "Wall time of the last build in seconds.")
+        .def_readwrite(
+            "detect_time", &BroadPhaseStats::detect_time,
+            "Wall time of the last detect_collision_candidates in seconds.")
+        .def_readwrite(
+            "num_boxes", &BroadPhaseStats::num_boxes,
+            "Number of vertex, edge, and face boxes built.")
+        .def_readwrite(
+            "num_candidates", &BroadPhaseStats::num_candidates,
+            "Number of candidates emitted by detect_collision_candidates.")
+        .def_readwrite(
+            "num_filtered", &BroadPhaseStats::num_filtered,
+            "Number of box pairs rejected by the can_*_collide filters.")
+        .def_readwrite(
+            "boxes_per_cell_histogram",
+            &BroadPhaseStats::boxes_per_cell_histogram,
+            "Histogram of boxes per occupied cell in log2 buckets; only "
+            "populated by the grid-based methods.")
+        .def(
+            "log", &BroadPhaseStats::log,
+            "Write the statistics to the logger at debug level.");
+
+    py::class_<BoxQueryResult>(
+        m, "BoxQueryResult",
+        "CSR-form result of a batched box query (see "
+        "BroadPhase.query_boxes): the ids overlapping the i-th query box are "
+        "vertex_ids[vertex_offsets[i]:vertex_offsets[i+1]] (and likewise for "
+        "edges and faces).")
+        .def(py::init<>())
+        .def("clear", &BoxQueryResult::clear, "")
+        .def_readwrite("vertex_offsets", &BoxQueryResult::vertex_offsets, "")
+        .def_readwrite("vertex_ids", &BoxQueryResult::vertex_ids, "")
+        .def_readwrite("edge_offsets", &BoxQueryResult::edge_offsets, "")
+        .def_readwrite("edge_ids", &BoxQueryResult::edge_ids, "")
+        .def_readwrite("face_offsets", &BoxQueryResult::face_offsets, "")
+        .def_readwrite("face_ids", &BoxQueryResult::face_ids, "");
+
     py::class_<BroadPhase>(m, "BroadPhase")
         .def_static(
             "make_broad_phase", &BroadPhase::make_broad_phase,
@@ -31,15 +83,30 @@ void define_broad_phase(py::module_& m)
 
             Parameters:
                 method: The broad phase method to use.
+                use_morton_ordering: If true, sort the element boxes along the Morton curve.
 
             Returns:
                 The constructed broad phase object.
             )ipc_Qu8mg5v7",
-            py::arg("method"))
+            py::arg("method"), py::arg("use_morton_ordering") = false)
+        .def(
+            "set_morton_ordering", &BroadPhase::set_morton_ordering,
+            R"ipc_Qu8mg5v7(
+            Enable or disable Morton-order storage of the element boxes.
+
+            When enabled, build sorts the vertex, edge, and face boxes along
+            the Morton curve of their centers so that boxes that are close in
+            space are also close in memory, and the detect_* functions remap
+            the emitted candidates back to mesh indices.
+
+            Parameters:
+                use_morton_ordering: If true, sort the boxes along the Morton curve.
+            )ipc_Qu8mg5v7",
+            py::arg("use_morton_ordering"))
         .def(
             "build",
             py::overload_cast<
-                const Eigen::MatrixXd&, const Eigen::MatrixXi&,
+                ConstMatrixXdRef, const Eigen::MatrixXi&,
                 const Eigen::MatrixXi&, double>(&BroadPhase::build),
             R"ipc_Qu8mg5v7(
             Build the broad phase for static collision detection.
@@ -55,7 +122,7 @@ void define_broad_phase(py::module_& m)
         .def(
             "build",
             py::overload_cast<
-                const Eigen::MatrixXd&, const Eigen::MatrixXd&,
+                ConstMatrixXdRef, ConstMatrixXdRef,
                 const Eigen::MatrixXi&, const Eigen::MatrixXi&, double>(
                 &BroadPhase::build),
             R"ipc_Qu8mg5v7(
@@ -70,7 +137,91 @@ void define_broad_phase(py::module_& m)
             )ipc_Qu8mg5v7",
             py::arg("V0"), py::arg("V1"), py::arg("E"), py::arg("F"),
             py::arg("inflation_radius") = 0)
+        .def(
+            "update", &BroadPhase::update,
+            R"ipc_Qu8mg5v7(
+            Update a previously built broad phase with new vertex positions.
+
+            Reuses the topology (edges and faces) and inflation radius passed
+            to the last call to build.
+
+            Parameters:
+                V: New positions of the vertices.
+            )ipc_Qu8mg5v7",
+            py::arg("V"))
         .def("clear", &BroadPhase::clear, "Clear any built data.")
+        .def(
+            "set_build_margin", &BroadPhase::set_build_margin,
+            R"ipc_Qu8mg5v7(
+            Set the extra inflation margin used to skip rebuilds.
+
+            When nonzero, the caller-owned construct_collision_candidates
+            overloads build the structure with the boxes inflated by this
+            margin on top of the inflation radius and then reuse it as long
+            as no vertex has moved farther than the margin since the build.
+
+            Parameters:
+                margin: The extra inflation margin.
+            )ipc_Qu8mg5v7",
+            py::arg("margin"))
+        .def(
+            "build_margin", &BroadPhase::build_margin,
+            "The extra inflation margin used to skip rebuilds.")
+        .def(
+            "set_active_zones", &BroadPhase::set_active_zones,
+            R"ipc_Qu8mg5v7(
+            Restrict detection to caller-supplied active zones.
+
+            With zones set, build keeps only the element boxes intersecting
+            one of the zones; every fallback_period-th build ignores the
+            zones and runs the full scene so contacts drifting in from
+            outside are still caught.
+
+            Parameters:
+                zones: The active zones (empty restores full-scene detection).
+                fallback_period: Run a full-scene build every this many builds
+                    (a non-positive period disables the fallback).
+            )ipc_Qu8mg5v7",
+            py::arg("zones"), py::arg("fallback_period") = 8)
+        .def(
+            "clear_active_zones", &BroadPhase::clear_active_zones,
+            "Remove the active zones (every build is full-scene again).")
+        .def(
+            "active_zones", &BroadPhase::active_zones,
+            "The active zones restricting detection (empty when unset).")
+        .def(
+            "enable_stats", &BroadPhase::enable_stats,
+            "Enable or disable statistics collection (off by default).",
+            py::arg("enable") = true)
+        .def(
+            "stats", &BroadPhase::stats,
+            R"ipc_Qu8mg5v7(
+            Statistics of the last build and detect queries.
+
+            Note:
+                Only populated while enable_stats is on.
+            )ipc_Qu8mg5v7")
+        .def(
+            "query_boxes",
+            [](const BroadPhase& self, const std::vector<AABB>& boxes) {
+                BoxQueryResult result;
+                self.query_boxes(boxes, result);
+                return result;
+            },
+            R"ipc_Qu8mg5v7(
+            Query caller-provided boxes against the built structure.
+
+            Returns the mesh vertex, edge, and face ids whose boxes overlap
+            each query box. The query boxes are used as given; inflate them
+            before calling if a search radius is desired.
+
+            Parameters:
+                boxes: The query boxes.
+
+            Returns:
+                The overlapping ids per box in CSR form.
+            )ipc_Qu8mg5v7",
+            py::arg("boxes"))
         .def(
             "detect_edge_vertex_candidates",
             [](BroadPhase& self) {
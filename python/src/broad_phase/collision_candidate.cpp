@@ -12,15 +12,16 @@ void define_collision_candidate(py::module_& m)
             "ccd",
             [](ContinuousCollisionCandidate& self, const Eigen::MatrixXd& V0,
                const Eigen::MatrixXd& V1, const Eigen::MatrixXi& E,
-               const Eigen::MatrixXi& F, const double tmax = 1.0,
+               const Eigen::MatrixXi& F, const double min_distance = 0.0,
+               const double tmax = 1.0,
                const double tolerance = DEFAULT_CCD_TOLERANCE,
                const long max_iterations = DEFAULT_CCD_MAX_ITERATIONS,
                const double conservative_rescaling =
                    DEFAULT_CCD_CONSERVATIVE_RESCALING) {
                 double toi;
                 bool r = self.ccd(
-                    V0, V1, E, F, toi, tmax, tolerance, max_iterations,
-                    conservative_rescaling);
+                    V0, V1, E, F, toi, min_distance, tmax, tolerance,
+                    max_iterations, conservative_rescaling);
                 return std::make_tuple(r, toi);
             },
             R"ipc_Qu8mg5v7(
@@ -31,6 +32,7 @@ void define_collision_candidate(py::module_& m)
                 V1: Mesh vertex positions at the end of the time step.
                 E: Mesh edges as rows of indicies into V.
                 F: Mesh triangular faces as rows of indicies into V.
+                min_distance: Minimum separation distance between primitives.
                 tmax: Maximum time (normalized) to look for collisions. Should be in [0, 1].
                 tolerance: CCD tolerance used by Tight-Inclusion CCD.
                 max_iterations: Maximum iterations used by Tight-Inclusion CCD.
@@ -42,7 +44,8 @@ void define_collision_candidate(py::module_& m)
                 Computed time of impact (normalized).
             )ipc_Qu8mg5v7",
             py::arg("V0"), py::arg("V1"), py::arg("E"), py::arg("F"),
-            py::arg("tmax") = 1.0, py::arg("tolerance") = DEFAULT_CCD_TOLERANCE,
+            py::arg("min_distance") = 0.0, py::arg("tmax") = 1.0,
+            py::arg("tolerance") = DEFAULT_CCD_TOLERANCE,
             py::arg("max_iterations") = DEFAULT_CCD_MAX_ITERATIONS,
             py::arg("conservative_rescaling") =
                 DEFAULT_CCD_CONSERVATIVE_RESCALING)
@@ -104,15 +107,16 @@ void define_collision_candidate(py::module_& m)
             "ccd",
             [](EdgeVertexCandidate& self, const Eigen::MatrixXd& V0,
                const Eigen::MatrixXd& V1, const Eigen::MatrixXi& E,
-               const Eigen::MatrixXi& F, const double tmax = 1.0,
+               const Eigen::MatrixXi& F, const double min_distance = 0.0,
+               const double tmax = 1.0,
                const double tolerance = DEFAULT_CCD_TOLERANCE,
                const long max_iterations = DEFAULT_CCD_MAX_ITERATIONS,
                const double conservative_rescaling =
                    DEFAULT_CCD_CONSERVATIVE_RESCALING) {
                 double toi;
                 bool r = self.ccd(
-                    V0, V1, E, F, toi, tmax, tolerance, max_iterations,
-                    conservative_rescaling);
+                    V0, V1, E, F, toi, min_distance, tmax, tolerance,
+                    max_iterations, conservative_rescaling);
                 return std::make_tuple(r, toi);
             },
             R"ipc_Qu8mg5v7(
@@ -123,6 +127,7 @@ void define_collision_candidate(py::module_& m)
                 V1: Mesh vertex positions at the end of the time step.
                 E: Mesh edges as rows of indicies into V.
                 F: Mesh triangular faces as rows of indicies into V.
+                min_distance: Minimum separation distance between primitives.
                 tmax: Maximum time (normalized) to look for collisions. Should be in [0, 1].
                 tolerance: CCD tolerance used by Tight-Inclusion CCD.
                 max_iterations: Maximum iterations used by Tight-Inclusion CCD.
@@ -134,7 +139,8 @@ void define_collision_candidate(py::module_& m)
                 Computed time of impact (normalized).
             )ipc_Qu8mg5v7",
             py::arg("V0"), py::arg("V1"), py::arg("E"), py::arg("F"),
-            py::arg("tmax") = 1.0, py::arg("tolerance") = DEFAULT_CCD_TOLERANCE,
+            py::arg("min_distance") = 0.0, py::arg("tmax") = 1.0,
+            py::arg("tolerance") = DEFAULT_CCD_TOLERANCE,
             py::arg("max_iterations") = DEFAULT_CCD_MAX_ITERATIONS,
             py::arg("conservative_rescaling") =
                 DEFAULT_CCD_CONSERVATIVE_RESCALING)
@@ -171,15 +177,16 @@ void define_collision_candidate(py::module_& m)
             "ccd",
             [](EdgeEdgeCandidate& self, const Eigen::MatrixXd& V0,
                const Eigen::MatrixXd& V1, const Eigen::MatrixXi& E,
-               const Eigen::MatrixXi& F, const double tmax = 1.0,
+               const Eigen::MatrixXi& F, const double min_distance = 0.0,
+               const double tmax = 1.0,
                const double tolerance = DEFAULT_CCD_TOLERANCE,
                const long max_iterations = DEFAULT_CCD_MAX_ITERATIONS,
                const double conservative_rescaling =
                    DEFAULT_CCD_CONSERVATIVE_RESCALING) {
                 double toi;
                 bool r = self.ccd(
-                    V0, V1, E, F, toi, tmax, tolerance, max_iterations,
-                    conservative_rescaling);
+                    V0, V1, E, F, toi, min_distance, tmax, tolerance,
+                    max_iterations, conservative_rescaling);
                 return std::make_tuple(r, toi);
             },
             R"ipc_Qu8mg5v7(
@@ -190,6 +197,7 @@ void define_collision_candidate(py::module_& m)
                 V1: Mesh vertex positions at the end of the time step.
                 E: Mesh edges as rows of indicies into V.
                 F: Mesh triangular faces as rows of indicies into V.
+                min_distance: Minimum separation distance between primitives.
                 tmax: Maximum time (normalized) to look for collisions. Should be in [0, 1].
                 tolerance: CCD tolerance used by Tight-Inclusion CCD.
                 max_iterations: Maximum iterations used by Tight-Inclusion CCD.
@@ -201,7 +209,8 @@ void define_collision_candidate(py::module_& m)
                 Computed time of impact (normalized).
             )ipc_Qu8mg5v7",
             py::arg("V0"), py::arg("V1"), py::arg("E"), py::arg("F"),
-            py::arg("tmax") = 1.0, py::arg("tolerance") = DEFAULT_CCD_TOLERANCE,
+            py::arg("min_distance") = 0.0, py::arg("tmax") = 1.0,
+            py::arg("tolerance") = DEFAULT_CCD_TOLERANCE,
             py::arg("max_iterations") = DEFAULT_CCD_MAX_ITERATIONS,
             py::arg("conservative_rescaling") =
                 DEFAULT_CCD_CONSERVATIVE_RESCALING)
@@ -263,19 +272,21 @@ void define_collision_candidate(py::module_& m)
             "ccd",
             [](FaceVertexCandidate& self, const Eigen::MatrixXd& V0,
                const Eigen::MatrixXd& V1, const Eigen::MatrixXi& E,
-               const Eigen::MatrixXi& F, const double tmax = 1.0,
+               const Eigen::MatrixXi& F, const double min_distance = 0.0,
+               const double tmax = 1.0,
                const double tolerance = DEFAULT_CCD_TOLERANCE,
                const long max_iterations = DEFAULT_CCD_MAX_ITERATIONS,
                const double conservative_rescaling =
                    DEFAULT_CCD_CONSERVATIVE_RESCALING) {
                 double toi;
                 bool r = self.ccd(
-                    V0, V1, E, F, toi, tmax, tolerance, max_iterations,
-                    conservative_rescaling);
+                    V0, V1, E, F, toi, min_distance, tmax, tolerance,
+                    max_iterations, conservative_rescaling);
                 return std::make_tuple(r, toi);
             },
             "", py::arg("V0"), py::arg("V1"), py::arg("E"), py::arg("F"),
-            py::arg("tmax") = 1.0, py::arg("tolerance") = DEFAULT_CCD_TOLERANCE,
+            py::arg("min_distance") = 0.0, py::arg("tmax") = 1.0,
+            py::arg("tolerance") = DEFAULT_CCD_TOLERANCE,
             py::arg("max_iterations") = DEFAULT_CCD_MAX_ITERATIONS,
             py::arg("conservative_rescaling") =
                 DEFAULT_CCD_CONSERVATIVE_RESCALING)
@@ -290,15 +301,58 @@ void define_collision_candidate(py::module_& m)
         .def("__len__", &Candidates::size, "")
         .def("empty", &Candidates::empty, "")
         .def("clear", &Candidates::clear, "")
+        .def(
+            "reserve", &Candidates::reserve,
+            "Reserve capacity for each candidate type.", py::arg("num_ev"),
+            py::arg("num_ee"), py::arg("num_fv"))
         .def(
             "__getitem__",
             [](Candidates& self, size_t idx) -> ContinuousCollisionCandidate* {
                 return &self[idx];
             })
+        .def(
+            "reduce_to_worst", &Candidates::reduce_to_worst,
+            R"ipc_Qu8mg5v7(
+            Keep only the max_candidates most severe candidates.
+
+            Severity is ranked by the squared gap between the two primitives'
+            AABBs (zero when the boxes overlap). No-op when already within
+            budget.
+
+            Parameters:
+                V: Vertices of the collision mesh.
+                E: Edges of the collision mesh.
+                F: Faces of the collision mesh.
+                max_candidates: Number of candidates to keep.
+
+            Returns:
+                The number of candidates dropped.
+            )ipc_Qu8mg5v7",
+            py::arg("V"), py::arg("E"), py::arg("F"),
+            py::arg("max_candidates"))
         .def(
             "save_obj", &Candidates::save_obj, "", py::arg("filename"),
             py::arg("V"), py::arg("E"), py::arg("F"))
         .def_readwrite("ev_candidates", &Candidates::ev_candidates, "")
         .def_readwrite("ee_candidates", &Candidates::ee_candidates, "")
         .def_readwrite("fv_candidates", &Candidates::fv_candidates, "");
+
+    py::class_<CandidatesSoA>(
+        m, "CandidatesSoA",
+        "Structure-of-arrays copy of a Candidates set whose index arrays "
+        "retain their capacity across builds.")
+        .def(py::init(), "")
+        .def(
+            "build", &CandidatesSoA::build,
+            "Fill the index arrays from a Candidates set.",
+            py::arg("candidates"))
+        .def("__len__", &CandidatesSoA::size, "")
+        .def("empty", &CandidatesSoA::empty, "")
+        .def("clear", &CandidatesSoA::clear, "")
+        .def_readwrite("ev_edges", &CandidatesSoA::ev_edges, "")
+        .def_readwrite("ev_vertices", &CandidatesSoA::ev_vertices, "")
+        .def_readwrite("ee_edges0", &CandidatesSoA::ee_edges0, "")
+        .def_readwrite("ee_edges1", &CandidatesSoA::ee_edges1, "")
+        .def_readwrite("fv_faces", &CandidatesSoA::fv_faces, "")
+        .def_readwrite("fv_vertices", &CandidatesSoA::fv_vertices, "");
 }
@@ -0,0 +1,32 @@
+#include "../common.hpp"
+
+#include <ipc/broad_phase/component_broad_phase.hpp>
+
+namespace py = pybind11;
+using namespace ipc;
+
+void define_component_broad_phase(py::module_& m)
+{
+    py::class_<ComponentBroadPhase, BroadPhase>(
+        m, "ComponentBroadPhase",
+        R"ipc_Qu8mg5v7(
+        Broad phase partitioned by connected component.
+
+        Builds one inner broad phase per connected component of the mesh and
+        finds cross-component candidates by testing the component bounding
+        boxes pairwise, only querying structure against structure for the
+        component pairs whose boxes overlap.
+        )ipc_Qu8mg5v7")
+        .def(
+            py::init<const BroadPhaseMethod>(),
+            R"ipc_Qu8mg5v7(
+            Construct the composite.
+
+            Parameters:
+                method: Method used for each component's inner structure.
+            )ipc_Qu8mg5v7",
+            py::arg("method") = BroadPhaseMethod::HASH_GRID)
+        .def(
+            "num_components", &ComponentBroadPhase::num_components,
+            "Number of connected components of the last built mesh.");
+}
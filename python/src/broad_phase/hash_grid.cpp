@@ -23,7 +23,7 @@ void define_hash_grid(py::module_& m)
         .def(
             "build",
             py::overload_cast<
-                const Eigen::MatrixXd&, const Eigen::MatrixXi&,
+                ConstMatrixXdRef, const Eigen::MatrixXi&,
                 const Eigen::MatrixXi&, double>(&HashGrid::build),
             R"ipc_Qu8mg5v7(
             Build the broad phase for static collision detection.
@@ -39,7 +39,7 @@ void define_hash_grid(py::module_& m)
         .def(
             "build",
             py::overload_cast<
-                const Eigen::MatrixXd&, const Eigen::MatrixXd&,
+                ConstMatrixXdRef, ConstMatrixXdRef,
                 const Eigen::MatrixXi&, const Eigen::MatrixXi&, double>(
                 &HashGrid::build),
             R"ipc_Qu8mg5v7(
@@ -107,6 +107,25 @@ void define_hash_grid(py::module_& m)
             Returns:
                 The candidate edge-face intersections.
             )ipc_Qu8mg5v7")
+        .def(
+            "set_cell_size_tuning", &HashGrid::set_cell_size_tuning,
+            R"ipc_Qu8mg5v7(
+            Enable feedback-driven tuning of the cell size.
+
+            Every build measures a proxy of its own cost and adjusts a scale
+            on the heuristic cell size for the next build, converging to the
+            throughput optimum as the scene evolves.
+
+            Parameters:
+                enable: Whether to tune the cell size.
+                min_scale: Lower bound on the scale.
+                max_scale: Upper bound on the scale.
+            )ipc_Qu8mg5v7",
+            py::arg("enable") = true, py::arg("min_scale") = 0.25,
+            py::arg("max_scale") = 4.0)
+        .def(
+            "cell_size_scale", &HashGrid::cell_size_scale,
+            "Scale the tuner currently applies to the heuristic cell size.")
         .def("cellSize", &HashGrid::cellSize, "")
         .def("gridSize", &HashGrid::gridSize, "")
         .def("domainMin", &HashGrid::domainMin, "")
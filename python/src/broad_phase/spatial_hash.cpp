@@ -11,13 +11,13 @@ void define_spatial_hash(py::module_& m)
         .def(py::init())
         .def(
             py::init<
-                const Eigen::MatrixXd&, const Eigen::MatrixXi&,
+                ConstMatrixXdRef, const Eigen::MatrixXi&,
                 const Eigen::MatrixXi&, double, double>(),
             "", py::arg("V"), py::arg("E"), py::arg("F"),
             py::arg("inflation_radius") = 0, py::arg("voxelSize") = -1)
         .def(
             py::init<
-                const Eigen::MatrixXd&, const Eigen::MatrixXd&,
+                ConstMatrixXdRef, ConstMatrixXdRef,
                 const Eigen::MatrixXi&, const Eigen::MatrixXi&, double,
                 double>(),
             "", py::arg("V0"), py::arg("V1"), py::arg("E"), py::arg("F"),
@@ -25,14 +25,14 @@ void define_spatial_hash(py::module_& m)
         .def(
             "build",
             py::overload_cast<
-                const Eigen::MatrixXd&, const Eigen::MatrixXi&,
+                ConstMatrixXdRef, const Eigen::MatrixXi&,
                 const Eigen::MatrixXi&, double>(&SpatialHash::build),
             "", py::arg("V"), py::arg("E"), py::arg("F"),
             py::arg("inflation_radius") = 0)
         .def(
             "build",
             py::overload_cast<
-                const Eigen::MatrixXd&, const Eigen::MatrixXd&,
+                ConstMatrixXdRef, ConstMatrixXdRef,
                 const Eigen::MatrixXi&, const Eigen::MatrixXi&, double>(
                 &SpatialHash::build),
             "", py::arg("V0"), py::arg("V1"), py::arg("E"), py::arg("F"),
@@ -40,14 +40,14 @@ void define_spatial_hash(py::module_& m)
         .def(
             "build",
             py::overload_cast<
-                const Eigen::MatrixXd&, const Eigen::MatrixXi&,
+                ConstMatrixXdRef, const Eigen::MatrixXi&,
                 const Eigen::MatrixXi&, double, double>(&SpatialHash::build),
             "", py::arg("V"), py::arg("E"), py::arg("F"),
             py::arg("inflation_radius"), py::arg("voxelSize"))
         .def(
             "build",
             py::overload_cast<
-                const Eigen::MatrixXd&, const Eigen::MatrixXd&,
+                ConstMatrixXdRef, ConstMatrixXdRef,
                 const Eigen::MatrixXi&, const Eigen::MatrixXi&, double, double>(
                 &SpatialHash::build),
             "", py::arg("V0"), py::arg("V1"), py::arg("E"), py::arg("F"),
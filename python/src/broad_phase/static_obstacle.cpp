@@ -0,0 +1,60 @@
+#include "../common.hpp"
+
+#include <ipc/broad_phase/static_obstacle.hpp>
+
+namespace py = pybind11;
+using namespace ipc;
+
+void define_static_obstacle(py::module_& m)
+{
+    py::class_<StaticObstacleBroadPhase, BroadPhase>(
+        m, "StaticObstacleBroadPhase",
+        R"ipc_Qu8mg5v7(
+        Broad phase for a dynamic mesh colliding against static obstacles.
+
+        Elements whose vertices are all marked static go into an inner broad
+        phase that is built once; every build only reconstructs the dynamic
+        elements' structure and queries it against the static one.
+        )ipc_Qu8mg5v7")
+        .def(
+            py::init<const BroadPhaseMethod, const BroadPhaseMethod>(),
+            R"ipc_Qu8mg5v7(
+            Construct the composite from two inner methods.
+
+            Parameters:
+                dynamic_method: Method used for the per-build dynamic structure.
+                static_method: Method used for the build-once static structure.
+            )ipc_Qu8mg5v7",
+            py::arg("dynamic_method") = BroadPhaseMethod::HASH_GRID,
+            py::arg("static_method") = BroadPhaseMethod::BVH)
+        .def(
+            "set_static_vertices",
+            &StaticObstacleBroadPhase::set_static_vertices,
+            R"ipc_Qu8mg5v7(
+            Mark which vertices are static.
+
+            An element is treated as static iff all of its vertices are
+            marked. Invalidates the static structure; the next build
+            reconstructs it.
+
+            Parameters:
+                is_static_vertex: One flag per vertex of the collision mesh.
+            )ipc_Qu8mg5v7",
+            py::arg("is_static_vertex"))
+        .def(
+            "set_rest_epsilon", &StaticObstacleBroadPhase::set_rest_epsilon,
+            R"ipc_Qu8mg5v7(
+            Enable automatic rest detection with the given tolerance.
+
+            When enabled, the two-position build additionally treats
+            vertices whose per-axis motion stays within epsilon of where
+            they came to rest as static. The static structure is rebuilt
+            whenever the resting set changes, and its boxes are widened so
+            the tolerated sub-epsilon drift cannot miss an overlap.
+
+            Parameters:
+                epsilon: Per-axis motion tolerated while at rest (negative
+                    disables rest detection).
+            )ipc_Qu8mg5v7",
+            py::arg("epsilon"));
+}
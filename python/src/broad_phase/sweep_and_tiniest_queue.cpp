@@ -15,7 +15,7 @@ void define_sweep(py::module_& m)
         .def(
             "build",
             py::overload_cast<
-                const Eigen::MatrixXd&, const Eigen::MatrixXi&,
+                ConstMatrixXdRef, const Eigen::MatrixXi&,
                 const Eigen::MatrixXi&, double>(&SweepAndTiniestQueue::build),
             R"ipc_Qu8mg5v7(
             Build the broad phase for static collision detection.
@@ -31,7 +31,7 @@ void define_sweep(py::module_& m)
         .def(
             "build",
             py::overload_cast<
-                const Eigen::MatrixXd&, const Eigen::MatrixXd&,
+                ConstMatrixXdRef, ConstMatrixXdRef,
                 const Eigen::MatrixXi&, const Eigen::MatrixXi&, double>(
                 &SweepAndTiniestQueue::build),
             R"ipc_Qu8mg5v7(
@@ -107,7 +107,7 @@ void define_sweep(py::module_& m)
         .def(
             "build",
             py::overload_cast<
-                const Eigen::MatrixXd&, const Eigen::MatrixXi&,
+                ConstMatrixXdRef, const Eigen::MatrixXi&,
                 const Eigen::MatrixXi&, double>(
                 &SweepAndTiniestQueueGPU::build),
             R"ipc_Qu8mg5v7(
@@ -124,7 +124,7 @@ void define_sweep(py::module_& m)
         .def(
             "build",
             py::overload_cast<
-                const Eigen::MatrixXd&, const Eigen::MatrixXd&,
+                ConstMatrixXdRef, ConstMatrixXdRef,
                 const Eigen::MatrixXi&, const Eigen::MatrixXi&, double>(
                 &SweepAndTiniestQueueGPU::build),
             R"ipc_Qu8mg5v7(
@@ -10,14 +10,14 @@ void define_voxel_size_heuristic(py::module_& m)
     m.def(
         "suggest_good_voxel_size",
         py::overload_cast<
-            const Eigen::MatrixXd&, const Eigen::MatrixXi&, double>(
+            ConstMatrixXdRef, const Eigen::MatrixXi&, double>(
             &suggest_good_voxel_size),
         "", py::arg("V"), py::arg("E"), py::arg("inflation_radius") = 0);
 
     m.def(
         "suggest_good_voxel_size",
         py::overload_cast<
-            const Eigen::MatrixXd&, const Eigen::MatrixXd&,
+            ConstMatrixXdRef, ConstMatrixXdRef,
             const Eigen::MatrixXi&, double>(&suggest_good_voxel_size),
         "", py::arg("V0"), py::arg("V1"), py::arg("E"),
         py::arg("inflation_radius") = 0);
@@ -2,29 +2,80 @@
 
 #include <ipc/ccd/ccd.hpp>
 
+#include <tbb/parallel_for.h>
+#include <tbb/blocked_range.h>
+
 namespace py = pybind11;
 using namespace ipc;
 
 void define_ccd(py::module_& m)
 {
+    py::class_<CCDStats>(
+        m, "CCDStats",
+        R"ipc_Qu8mg5v7(
+        Aggregated statistics of the Tight-Inclusion narrow-phase queries.
+
+        Only populated while enable_ccd_stats() is on. The counters
+        accumulate until reset_ccd_stats(); to aggregate a single
+        compute_collision_free_stepsize call, reset before the call and
+        take a snapshot after it.
+        )ipc_Qu8mg5v7")
+        .def(py::init(), "")
+        .def_readwrite(
+            "num_queries", &CCDStats::num_queries,
+            "Number of Tight-Inclusion queries run.")
+        .def_readwrite(
+            "num_impacts", &CCDStats::num_impacts,
+            "Number of queries reporting an impact.")
+        .def_readwrite(
+            "num_tolerance_unmet", &CCDStats::num_tolerance_unmet,
+            "Queries that hit the iteration limit before reaching the "
+            "requested tolerance.")
+        .def_readwrite(
+            "num_small_toi_refinements", &CCDStats::num_small_toi_refinements,
+            "Queries rerun without the conservative minimum separation "
+            "because the first pass reported a small time of impact.")
+        .def_readwrite(
+            "sum_reached_tolerance", &CCDStats::sum_reached_tolerance,
+            "Sum of the reached tolerances (divide by num_queries for the "
+            "mean).")
+        .def_readwrite(
+            "max_reached_tolerance", &CCDStats::max_reached_tolerance,
+            "Largest reached tolerance.")
+        .def(
+            "log", &CCDStats::log,
+            "Write the statistics to the logger at debug level.");
+
+    m.def(
+        "enable_ccd_stats", &enable_ccd_stats,
+        "Enable or disable CCD statistics collection (off by default).",
+        py::arg("enable") = true);
+    m.def(
+        "reset_ccd_stats", &reset_ccd_stats,
+        "Reset the CCD statistics counters to zero.");
+    m.def(
+        "ccd_stats", &ccd_stats,
+        "Snapshot of the CCD statistics accumulated since the last reset.");
+
     m.def(
         "point_edge_ccd_2D",
         [](const Eigen::Vector2d& p_t0, const Eigen::Vector2d& e0_t0,
            const Eigen::Vector2d& e1_t0, const Eigen::Vector2d& p_t1,
            const Eigen::Vector2d& e0_t1, const Eigen::Vector2d& e1_t1,
-           const double tmax = 1.0,
+           const double min_distance = 0.0, const double tmax = 1.0,
            const double tolerance = DEFAULT_CCD_TOLERANCE,
            const long max_iterations = DEFAULT_CCD_MAX_ITERATIONS,
            const double conservative_rescaling =
                DEFAULT_CCD_CONSERVATIVE_RESCALING) {
             double toi;
             bool r = point_edge_ccd_2D(
-                p_t0, e0_t0, e1_t0, p_t1, e0_t1, e1_t1, toi, tmax, tolerance,
-                max_iterations, conservative_rescaling);
+                p_t0, e0_t0, e1_t0, p_t1, e0_t1, e1_t1, toi, min_distance,
+                tmax, tolerance, max_iterations, conservative_rescaling);
             return std::make_tuple(r, toi);
         },
         "", py::arg("p_t0"), py::arg("e0_t0"), py::arg("e1_t0"),
         py::arg("p_t1"), py::arg("e0_t1"), py::arg("e1_t1"),
+        py::arg("min_distance") = 0.0,
         py::arg("tmax") = 1.0, py::arg("tolerance") = DEFAULT_CCD_TOLERANCE,
         py::arg("max_iterations") = DEFAULT_CCD_MAX_ITERATIONS,
         py::arg("conservative_rescaling") = DEFAULT_CCD_CONSERVATIVE_RESCALING);
@@ -33,19 +84,20 @@ void define_ccd(py::module_& m)
         "point_point_ccd",
         [](const Eigen::Vector3d& p0_t0, const Eigen::Vector3d& p1_t0,
            const Eigen::Vector3d& p0_t1, const Eigen::Vector3d& p1_t1,
-           const double tmax = 1.0,
+           const double min_distance = 0.0, const double tmax = 1.0,
            const double tolerance = DEFAULT_CCD_TOLERANCE,
            const long max_iterations = DEFAULT_CCD_MAX_ITERATIONS,
            const double conservative_rescaling =
                DEFAULT_CCD_CONSERVATIVE_RESCALING) {
             double toi;
             bool r = point_point_ccd(
-                p0_t0, p1_t0, p0_t1, p1_t1, toi, tmax, tolerance,
-                max_iterations, conservative_rescaling);
+                p0_t0, p1_t0, p0_t1, p1_t1, toi, min_distance, tmax,
+                tolerance, max_iterations, conservative_rescaling);
             return std::make_tuple(r, toi);
         },
         "", py::arg("p0_t0"), py::arg("p1_t0"), py::arg("p0_t1"),
-        py::arg("p1_t1"), py::arg("tmax") = 1.0,
+        py::arg("p1_t1"), py::arg("min_distance") = 0.0,
+        py::arg("tmax") = 1.0,
         py::arg("tolerance") = DEFAULT_CCD_TOLERANCE,
         py::arg("max_iterations") = DEFAULT_CCD_MAX_ITERATIONS,
         py::arg("conservative_rescaling") = DEFAULT_CCD_CONSERVATIVE_RESCALING);
@@ -55,19 +107,20 @@ void define_ccd(py::module_& m)
         [](const Eigen::Vector3d& p_t0, const Eigen::Vector3d& e0_t0,
            const Eigen::Vector3d& e1_t0, const Eigen::Vector3d& p_t1,
            const Eigen::Vector3d& e0_t1, const Eigen::Vector3d& e1_t1,
-           const double tmax = 1.0,
+           const double min_distance = 0.0, const double tmax = 1.0,
            const double tolerance = DEFAULT_CCD_TOLERANCE,
            const long max_iterations = DEFAULT_CCD_MAX_ITERATIONS,
            const double conservative_rescaling =
                DEFAULT_CCD_CONSERVATIVE_RESCALING) {
             double toi;
             bool r = point_edge_ccd_3D(
-                p_t0, e0_t0, e1_t0, p_t1, e0_t1, e1_t1, toi, tmax, tolerance,
-                max_iterations, conservative_rescaling);
+                p_t0, e0_t0, e1_t0, p_t1, e0_t1, e1_t1, toi, min_distance,
+                tmax, tolerance, max_iterations, conservative_rescaling);
             return std::make_tuple(r, toi);
         },
         "", py::arg("p_t0"), py::arg("e0_t0"), py::arg("e1_t0"),
         py::arg("p_t1"), py::arg("e0_t1"), py::arg("e1_t1"),
+        py::arg("min_distance") = 0.0,
         py::arg("tmax") = 1.0, py::arg("tolerance") = DEFAULT_CCD_TOLERANCE,
         py::arg("max_iterations") = DEFAULT_CCD_MAX_ITERATIONS,
         py::arg("conservative_rescaling") = DEFAULT_CCD_CONSERVATIVE_RESCALING);
@@ -78,20 +131,22 @@ void define_ccd(py::module_& m)
            const Eigen::Vector3d& t1_t0, const Eigen::Vector3d& t2_t0,
            const Eigen::Vector3d& p_t1, const Eigen::Vector3d& t0_t1,
            const Eigen::Vector3d& t1_t1, const Eigen::Vector3d& t2_t1,
-           const double tmax = 1.0,
+           const double min_distance = 0.0, const double tmax = 1.0,
            const double tolerance = DEFAULT_CCD_TOLERANCE,
            const long max_iterations = DEFAULT_CCD_MAX_ITERATIONS,
            const double conservative_rescaling =
                DEFAULT_CCD_CONSERVATIVE_RESCALING) {
             double toi;
             bool r = point_triangle_ccd(
-                p_t0, t0_t0, t1_t0, t2_t0, p_t1, t0_t1, t1_t1, t2_t1, toi, tmax,
-                tolerance, max_iterations, conservative_rescaling);
+                p_t0, t0_t0, t1_t0, t2_t0, p_t1, t0_t1, t1_t1, t2_t1, toi,
+                min_distance, tmax, tolerance, max_iterations,
+                conservative_rescaling);
             return std::make_tuple(r, toi);
         },
         "", py::arg("p_t0"), py::arg("t0_t0"), py::arg("t1_t0"),
         py::arg("t2_t0"), py::arg("p_t1"), py::arg("t0_t1"), py::arg("t1_t1"),
-        py::arg("t2_t1"), py::arg("tmax") = 1.0,
+        py::arg("t2_t1"), py::arg("min_distance") = 0.0,
+        py::arg("tmax") = 1.0,
         py::arg("tolerance") = DEFAULT_CCD_TOLERANCE,
         py::arg("max_iterations") = DEFAULT_CCD_MAX_ITERATIONS,
         py::arg("conservative_rescaling") = DEFAULT_CCD_CONSERVATIVE_RESCALING);
@@ -102,7 +157,7 @@ void define_ccd(py::module_& m)
            const Eigen::Vector3d& eb0_t0, const Eigen::Vector3d& eb1_t0,
            const Eigen::Vector3d& ea0_t1, const Eigen::Vector3d& ea1_t1,
            const Eigen::Vector3d& eb0_t1, const Eigen::Vector3d& eb1_t1,
-           const double tmax = 1.0,
+           const double min_distance = 0.0, const double tmax = 1.0,
            const double tolerance = DEFAULT_CCD_TOLERANCE,
            const long max_iterations = DEFAULT_CCD_MAX_ITERATIONS,
            const double conservative_rescaling =
@@ -110,12 +165,14 @@ void define_ccd(py::module_& m)
             double toi;
             bool r = edge_edge_ccd(
                 ea0_t0, ea1_t0, eb0_t0, eb1_t0, ea0_t1, ea1_t1, eb0_t1, eb1_t1,
-                toi, tmax, tolerance, max_iterations, conservative_rescaling);
+                toi, min_distance, tmax, tolerance, max_iterations,
+                conservative_rescaling);
             return std::make_tuple(r, toi);
         },
         "", py::arg("ea0_t0"), py::arg("ea1_t0"), py::arg("eb0_t0"),
         py::arg("eb1_t0"), py::arg("ea0_t1"), py::arg("ea1_t1"),
-        py::arg("eb0_t1"), py::arg("eb1_t1"), py::arg("tmax") = 1.0,
+        py::arg("eb0_t1"), py::arg("eb1_t1"), py::arg("min_distance") = 0.0,
+        py::arg("tmax") = 1.0,
         py::arg("tolerance") = DEFAULT_CCD_TOLERANCE,
         py::arg("max_iterations") = DEFAULT_CCD_MAX_ITERATIONS,
         py::arg("conservative_rescaling") = DEFAULT_CCD_CONSERVATIVE_RESCALING);
@@ -125,20 +182,153 @@ void define_ccd(py::module_& m)
         [](const VectorMax3d& p_t0, const VectorMax3d& e0_t0,
            const VectorMax3d& e1_t0, const VectorMax3d& p_t1,
            const VectorMax3d& e0_t1, const VectorMax3d& e1_t1,
-           const double tmax = 1.0,
+           const double min_distance = 0.0, const double tmax = 1.0,
            const double tolerance = DEFAULT_CCD_TOLERANCE,
            const long max_iterations = DEFAULT_CCD_MAX_ITERATIONS,
            const double conservative_rescaling =
                DEFAULT_CCD_CONSERVATIVE_RESCALING) {
             double toi;
             bool r = point_edge_ccd(
-                p_t0, e0_t0, e1_t0, p_t1, e0_t1, e1_t1, toi, tmax, tolerance,
-                max_iterations, conservative_rescaling);
+                p_t0, e0_t0, e1_t0, p_t1, e0_t1, e1_t1, toi, min_distance,
+                tmax, tolerance, max_iterations, conservative_rescaling);
             return std::make_tuple(r, toi);
         },
         "", py::arg("p_t0"), py::arg("e0_t0"), py::arg("e1_t0"),
         py::arg("p_t1"), py::arg("e0_t1"), py::arg("e1_t1"),
+        py::arg("min_distance") = 0.0,
         py::arg("tmax") = 1.0, py::arg("tolerance") = DEFAULT_CCD_TOLERANCE,
         py::arg("max_iterations") = DEFAULT_CCD_MAX_ITERATIONS,
         py::arg("conservative_rescaling") = DEFAULT_CCD_CONSERVATIVE_RESCALING);
+
+    m.def(
+        "point_triangle_ccd_batch",
+        [](ConstMatrixXdRef P_t0, ConstMatrixXdRef T0_t0,
+           ConstMatrixXdRef T1_t0, ConstMatrixXdRef T2_t0,
+           ConstMatrixXdRef P_t1, ConstMatrixXdRef T0_t1,
+           ConstMatrixXdRef T1_t1, ConstMatrixXdRef T2_t1,
+           const double min_distance, const double tmax,
+           const double tolerance, const long max_iterations,
+           const double conservative_rescaling) {
+            assert_batch_of_3D_vectors(
+                "point_triangle_ccd_batch", P_t0.rows(), P_t0, T0_t0, T1_t0,
+                T2_t0, P_t1, T0_t1, T1_t1, T2_t1);
+            VectorXb hits = VectorXb::Constant(P_t0.rows(), false);
+            Eigen::VectorXd tois = Eigen::VectorXd::Ones(P_t0.rows());
+            tbb::parallel_for(
+                tbb::blocked_range<long>(0, P_t0.rows()),
+                [&](const tbb::blocked_range<long>& r) {
+                    for (long i = r.begin(); i < r.end(); i++) {
+                        double toi;
+                        const bool hit = point_triangle_ccd(
+                            P_t0.row(i).transpose(), T0_t0.row(i).transpose(),
+                            T1_t0.row(i).transpose(), T2_t0.row(i).transpose(),
+                            P_t1.row(i).transpose(), T0_t1.row(i).transpose(),
+                            T1_t1.row(i).transpose(), T2_t1.row(i).transpose(),
+                            toi, min_distance, tmax, tolerance, max_iterations,
+                            conservative_rescaling);
+                        hits[i] = hit;
+                        if (hit) {
+                            tois[i] = toi;
+                        }
+                    }
+                });
+            return std::make_tuple(hits, tois);
+        },
+        R"ipc_Qu8mg5v7(
+        Run a batch of point-triangle CCD queries in one native call.
+
+        Evaluates row i of every input as one query; the batch is
+        parallelized with TBB and the GIL is released while it runs. The
+        scalar parameters are shared by every query.
+
+        Parameters:
+            P_t0 : points at t=0 as rows of an (N, 3) array.
+            T0_t0: first triangle vertices at t=0 as rows of an (N, 3) array.
+            T1_t0: second triangle vertices at t=0 as rows of an (N, 3) array.
+            T2_t0: third triangle vertices at t=0 as rows of an (N, 3) array.
+            P_t1 : points at t=1 as rows of an (N, 3) array.
+            T0_t1: first triangle vertices at t=1 as rows of an (N, 3) array.
+            T1_t1: second triangle vertices at t=1 as rows of an (N, 3) array.
+            T2_t1: third triangle vertices at t=1 as rows of an (N, 3) array.
+
+        Returns:
+            A tuple of an (N,) bool array marking the queries with a
+            collision and an (N,) array of their times of impact (1 where
+            there is no collision).
+        )ipc_Qu8mg5v7",
+        py::arg("P_t0"), py::arg("T0_t0"), py::arg("T1_t0"), py::arg("T2_t0"),
+        py::arg("P_t1"), py::arg("T0_t1"), py::arg("T1_t1"), py::arg("T2_t1"),
+        py::arg("min_distance") = 0.0, py::arg("tmax") = 1.0,
+        py::arg("tolerance") = DEFAULT_CCD_TOLERANCE,
+        py::arg("max_iterations") = DEFAULT_CCD_MAX_ITERATIONS,
+        py::arg("conservative_rescaling") = DEFAULT_CCD_CONSERVATIVE_RESCALING,
+        py::call_guard<py::gil_scoped_release>());
+
+    m.def(
+        "edge_edge_ccd_batch",
+        [](ConstMatrixXdRef EA0_t0, ConstMatrixXdRef EA1_t0,
+           ConstMatrixXdRef EB0_t0, ConstMatrixXdRef EB1_t0,
+           ConstMatrixXdRef EA0_t1, ConstMatrixXdRef EA1_t1,
+           ConstMatrixXdRef EB0_t1, ConstMatrixXdRef EB1_t1,
+           const double min_distance, const double tmax,
+           const double tolerance, const long max_iterations,
+           const double conservative_rescaling) {
+            assert_batch_of_3D_vectors(
+                "edge_edge_ccd_batch", EA0_t0.rows(), EA0_t0, EA1_t0, EB0_t0,
+                EB1_t0, EA0_t1, EA1_t1, EB0_t1, EB1_t1);
+            VectorXb hits = VectorXb::Constant(EA0_t0.rows(), false);
+            Eigen::VectorXd tois = Eigen::VectorXd::Ones(EA0_t0.rows());
+            tbb::parallel_for(
+                tbb::blocked_range<long>(0, EA0_t0.rows()),
+                [&](const tbb::blocked_range<long>& r) {
+                    for (long i = r.begin(); i < r.end(); i++) {
+                        double toi;
+                        const bool hit = edge_edge_ccd(
+                            EA0_t0.row(i).transpose(),
+                            EA1_t0.row(i).transpose(),
+                            EB0_t0.row(i).transpose(),
+                            EB1_t0.row(i).transpose(),
+                            EA0_t1.row(i).transpose(),
+                            EA1_t1.row(i).transpose(),
+                            EB0_t1.row(i).transpose(),
+                            EB1_t1.row(i).transpose(), toi, min_distance,
+                            tmax, tolerance, max_iterations,
+                            conservative_rescaling);
+                        hits[i] = hit;
+                        if (hit) {
+                            tois[i] = toi;
+                        }
+                    }
+                });
+            return std::make_tuple(hits, tois);
+        },
+        R"ipc_Qu8mg5v7(
+        Run a batch of edge-edge CCD queries in one native call.
+
+        Evaluates row i of every input as one query; the batch is
+        parallelized with TBB and the GIL is released while it runs. The
+        scalar parameters are shared by every query.
+
+        Parameters:
+            EA0_t0: first vertices of the first edges at t=0 as rows of an (N, 3) array.
+            EA1_t0: second vertices of the first edges at t=0 as rows of an (N, 3) array.
+            EB0_t0: first vertices of the second edges at t=0 as rows of an (N, 3) array.
+            EB1_t0: second vertices of the second edges at t=0 as rows of an (N, 3) array.
+            EA0_t1: first vertices of the first edges at t=1 as rows of an (N, 3) array.
+            EA1_t1: second vertices of the first edges at t=1 as rows of an (N, 3) array.
+            EB0_t1: first vertices of the second edges at t=1 as rows of an (N, 3) array.
+            EB1_t1: second vertices of the second edges at t=1 as rows of an (N, 3) array.
+
+        Returns:
+            A tuple of an (N,) bool array marking the queries with a
+            collision and an (N,) array of their times of impact (1 where
+            there is no collision).
+        )ipc_Qu8mg5v7",
+        py::arg("EA0_t0"), py::arg("EA1_t0"), py::arg("EB0_t0"),
+        py::arg("EB1_t0"), py::arg("EA0_t1"), py::arg("EA1_t1"),
+        py::arg("EB0_t1"), py::arg("EB1_t1"), py::arg("min_distance") = 0.0,
+        py::arg("tmax") = 1.0, py::arg("tolerance") = DEFAULT_CCD_TOLERANCE,
+        py::arg("max_iterations") = DEFAULT_CCD_MAX_ITERATIONS,
+        py::arg("conservative_rescaling") = DEFAULT_CCD_CONSERVATIVE_RESCALING,
+        py::call_guard<py::gil_scoped_release>());
 }
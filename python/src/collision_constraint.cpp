@@ -46,22 +46,59 @@ void define_collision_constraint(py::module_& m)
             &CollisionConstraint::compute_distance_hessian, "", py::arg("V"),
             py::arg("E"), py::arg("F"))
         .def(
-            "compute_potential", &CollisionConstraint::compute_potential, "",
-            py::arg("V"), py::arg("E"), py::arg("F"), py::arg("dhat"))
+            "compute_potential",
+            py::overload_cast<
+                ConstMatrixXdRef, const Eigen::MatrixXi&,
+                const Eigen::MatrixXi&, const double>(
+                &CollisionConstraint::compute_potential, py::const_),
+            "", py::arg("V"), py::arg("E"), py::arg("F"), py::arg("dhat"))
+        .def(
+            "compute_potential",
+            py::overload_cast<
+                ConstMatrixXdRef, const Eigen::MatrixXi&,
+                const Eigen::MatrixXi&, const double, const double>(
+                &CollisionConstraint::compute_potential, py::const_),
+            "Compute the potential from an already computed distance.",
+            py::arg("V"), py::arg("E"), py::arg("F"), py::arg("dhat"),
+            py::arg("distance"))
         .def(
             "compute_potential_gradient",
-            &CollisionConstraint::compute_potential_gradient, "", py::arg("V"),
-            py::arg("E"), py::arg("F"), py::arg("dhat"))
+            py::overload_cast<
+                ConstMatrixXdRef, const Eigen::MatrixXi&,
+                const Eigen::MatrixXi&, const double>(
+                &CollisionConstraint::compute_potential_gradient, py::const_),
+            "", py::arg("V"), py::arg("E"), py::arg("F"), py::arg("dhat"))
+        .def(
+            "compute_potential_gradient",
+            py::overload_cast<
+                ConstMatrixXdRef, const Eigen::MatrixXi&,
+                const Eigen::MatrixXi&, const double, const double>(
+                &CollisionConstraint::compute_potential_gradient, py::const_),
+            "Compute the potential gradient from an already computed distance.",
+            py::arg("V"), py::arg("E"), py::arg("F"), py::arg("dhat"),
+            py::arg("distance"))
         .def(
             "compute_potential_hessian",
-            &CollisionConstraint::compute_potential_hessian, "", py::arg("V"),
+            py::overload_cast<
+                ConstMatrixXdRef, const Eigen::MatrixXi&,
+                const Eigen::MatrixXi&, const double, const bool>(
+                &CollisionConstraint::compute_potential_hessian,
+                py::const_),
+            "", py::arg("V"),
             py::arg("E"), py::arg("F"), py::arg("dhat"),
             py::arg("project_to_psd"))
         .def_readwrite(
             "minimum_distance", &CollisionConstraint::minimum_distance)
         .def_readwrite(
             "weight", &CollisionConstraint::weight,
-            "Weight in the final sum of potentials");
+            "Weight in the final sum of potentials")
+        .def_readwrite(
+            "local_dhat", &CollisionConstraint::local_dhat,
+            "Constraint-specific activation distance (-1 = use the dhat "
+            "argument of the evaluation calls)")
+        .def_readwrite(
+            "cached_distance", &CollisionConstraint::cached_distance,
+            "Squared distance computed by Constraints.build (-1 if unset)");
 
     py::class_<
         VertexVertexConstraint, VertexVertexCandidate, CollisionConstraint>(
@@ -86,15 +123,30 @@ void define_collision_constraint(py::module_& m)
             &VertexVertexConstraint::compute_distance_hessian, "", py::arg("V"),
             py::arg("E"), py::arg("F"))
         .def(
-            "compute_potential", &VertexVertexConstraint::compute_potential, "",
+            "compute_potential",
+            py::overload_cast<
+                ConstMatrixXdRef, const Eigen::MatrixXi&,
+                const Eigen::MatrixXi&, const double>(
+                &VertexVertexConstraint::compute_potential, py::const_),
+            "",
             py::arg("V"), py::arg("E"), py::arg("F"), py::arg("dhat"))
         .def(
             "compute_potential_gradient",
-            &VertexVertexConstraint::compute_potential_gradient, "",
+            py::overload_cast<
+                ConstMatrixXdRef, const Eigen::MatrixXi&,
+                const Eigen::MatrixXi&, const double>(
+                &VertexVertexConstraint::compute_potential_gradient,
+                py::const_),
+            "",
             py::arg("V"), py::arg("E"), py::arg("F"), py::arg("dhat"))
         .def(
             "compute_potential_hessian",
-            &VertexVertexConstraint::compute_potential_hessian, "",
+            py::overload_cast<
+                ConstMatrixXdRef, const Eigen::MatrixXi&,
+                const Eigen::MatrixXi&, const double, const bool>(
+                &VertexVertexConstraint::compute_potential_hessian,
+                py::const_),
+            "",
             py::arg("V"), py::arg("E"), py::arg("F"), py::arg("dhat"),
             py::arg("project_hessian_to_psd"));
 
@@ -120,15 +172,29 @@ void define_collision_constraint(py::module_& m)
             &EdgeVertexConstraint::compute_distance_hessian, "", py::arg("V"),
             py::arg("E"), py::arg("F"))
         .def(
-            "compute_potential", &EdgeVertexConstraint::compute_potential, "",
+            "compute_potential",
+            py::overload_cast<
+                ConstMatrixXdRef, const Eigen::MatrixXi&,
+                const Eigen::MatrixXi&, const double>(
+                &EdgeVertexConstraint::compute_potential, py::const_),
+            "",
             py::arg("V"), py::arg("E"), py::arg("F"), py::arg("dhat"))
         .def(
             "compute_potential_gradient",
-            &EdgeVertexConstraint::compute_potential_gradient, "", py::arg("V"),
+            py::overload_cast<
+                ConstMatrixXdRef, const Eigen::MatrixXi&,
+                const Eigen::MatrixXi&, const double>(
+                &EdgeVertexConstraint::compute_potential_gradient, py::const_),
+            "", py::arg("V"),
             py::arg("E"), py::arg("F"), py::arg("dhat"))
         .def(
             "compute_potential_hessian",
-            &EdgeVertexConstraint::compute_potential_hessian, "", py::arg("V"),
+            py::overload_cast<
+                ConstMatrixXdRef, const Eigen::MatrixXi&,
+                const Eigen::MatrixXi&, const double, const bool>(
+                &EdgeVertexConstraint::compute_potential_hessian,
+                py::const_),
+            "", py::arg("V"),
             py::arg("E"), py::arg("F"), py::arg("dhat"),
             py::arg("project_hessian_to_psd"));
 
@@ -156,15 +222,29 @@ void define_collision_constraint(py::module_& m)
             &EdgeEdgeConstraint::compute_distance_hessian, "", py::arg("V"),
             py::arg("E"), py::arg("F"))
         .def(
-            "compute_potential", &EdgeEdgeConstraint::compute_potential, "",
+            "compute_potential",
+            py::overload_cast<
+                ConstMatrixXdRef, const Eigen::MatrixXi&,
+                const Eigen::MatrixXi&, const double>(
+                &EdgeEdgeConstraint::compute_potential, py::const_),
+            "",
             py::arg("V"), py::arg("E"), py::arg("F"), py::arg("dhat"))
         .def(
             "compute_potential_gradient",
-            &EdgeEdgeConstraint::compute_potential_gradient, "", py::arg("V"),
+            py::overload_cast<
+                ConstMatrixXdRef, const Eigen::MatrixXi&,
+                const Eigen::MatrixXi&, const double>(
+                &EdgeEdgeConstraint::compute_potential_gradient, py::const_),
+            "", py::arg("V"),
             py::arg("E"), py::arg("F"), py::arg("dhat"))
         .def(
             "compute_potential_hessian",
-            &EdgeEdgeConstraint::compute_potential_hessian, "", py::arg("V"),
+            py::overload_cast<
+                ConstMatrixXdRef, const Eigen::MatrixXi&,
+                const Eigen::MatrixXi&, const double, const bool>(
+                &EdgeEdgeConstraint::compute_potential_hessian,
+                py::const_),
+            "", py::arg("V"),
             py::arg("E"), py::arg("F"), py::arg("dhat"),
             py::arg("project_hessian_to_psd"))
         .def_readwrite("eps_x", &EdgeEdgeConstraint::eps_x, "");
@@ -222,7 +302,7 @@ void define_collision_constraint(py::module_& m)
         .def(
             "build",
             py::overload_cast<
-                const CollisionMesh&, const Eigen::MatrixXd&, const double,
+                const CollisionMesh&, ConstMatrixXdRef, const double,
                 const double, const BroadPhaseMethod>(&Constraints::build),
             R"ipc_Qu8mg5v7(
             Construct a set of constraints used to compute the barrier potential.
@@ -242,7 +322,7 @@ void define_collision_constraint(py::module_& m)
         .def(
             "build",
             py::overload_cast<
-                const Candidates&, const CollisionMesh&, const Eigen::MatrixXd&,
+                const Candidates&, const CollisionMesh&, ConstMatrixXdRef,
                 const double, const double>(&Constraints::build),
             R"ipc_Qu8mg5v7(
             Construct a set of constraints used to compute the barrier potential.
@@ -259,6 +339,12 @@ void define_collision_constraint(py::module_& m)
             )ipc_Qu8mg5v7",
             py::arg("candidates"), py::arg("mesh"), py::arg("V"),
             py::arg("dhat"), py::arg("dmin") = 0)
+        .def(
+            "are_cached_distances_valid",
+            &Constraints::are_cached_distances_valid,
+            "Check if the distances cached on the constraints during build "
+            "are still valid for V.",
+            py::arg("V"))
         .def("__len__", &Constraints::size, "")
         .def("empty", &Constraints::empty, "")
         .def("clear", &Constraints::clear, "")
@@ -277,5 +363,39 @@ void define_collision_constraint(py::module_& m)
             &Constraints::use_convergent_formulation, "")
         .def_readwrite(
             "compute_shape_derivatives",
-            &Constraints::compute_shape_derivatives, "");
+            &Constraints::compute_shape_derivatives, "")
+        .def_readwrite(
+            "candidate_budget", &Constraints::candidate_budget,
+            "Maximum number of candidates build() will accept (-1 = no "
+            "limit).")
+        .def_readwrite(
+            "use_colored_gradient_scatter",
+            &Constraints::use_colored_gradient_scatter,
+            "Scatter barrier potential gradients through vertex-disjoint "
+            "color classes instead of thread-local entry lists.")
+        .def_readwrite(
+            "use_vertex_locality_ordering",
+            &Constraints::use_vertex_locality_ordering,
+            "Reorder the constraints by minimum vertex index after build() "
+            "for better scatter locality in the potential passes.")
+        .def_readwrite(
+            "use_edge_edge_type_bucketing",
+            &Constraints::use_edge_edge_type_bucketing,
+            "Evaluate the edge-edge constraints one closest-feature type at "
+            "a time in the gradient and hessian assemblies so the distance "
+            "dispatch is perfectly predicted.")
+        .def_readwrite(
+            "use_gpu_narrow_phase", &Constraints::use_gpu_narrow_phase,
+            "Cull the broad-phase candidates on the GPU during build so only "
+            "the active subset reaches the host conversion loops (no effect "
+            "in builds without CUDA support).")
+        .def_readwrite(
+            "vertex_dhat", &Constraints::vertex_dhat,
+            "Optional per-vertex activation distances (empty when unset); a "
+            "pair activates at the maximum of its vertices' dhats.")
+        .def(
+            "num_truncated_candidates",
+            &Constraints::num_truncated_candidates,
+            "Number of candidates dropped by the last build() because of "
+            "candidate_budget (zero when the set is exact).");
 }
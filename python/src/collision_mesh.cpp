@@ -23,6 +23,19 @@ void define_collision_mesh(py::module_& m)
             "", py::arg("include_vertex"), py::arg("full_vertices_at_rest"),
             py::arg("edges"), py::arg("faces"),
             py::arg("displacement_map") = Eigen::SparseMatrix<double>())
+        .def(
+            py::init<const CollisionMesh&, const Eigen::MatrixXd&>(),
+            R"ipc_Qu8mg5v7(
+            Construct an instance of a prototype collision mesh.
+
+            The instance shares the prototype's immutable topology and only
+            recomputes the rest-position-dependent quantities.
+
+            Parameters:
+                prototype: The collision mesh whose topology to share.
+                full_vertices_at_rest: The rest positions of this instance on the full mesh.
+            )ipc_Qu8mg5v7",
+            py::arg("prototype"), py::arg("full_vertices_at_rest"))
         .def_property_readonly("num_vertices", &CollisionMesh::num_vertices, "")
         .def_property_readonly("dim", &CollisionMesh::dim, "")
         .def_property_readonly("ndof", &CollisionMesh::ndof, "")
@@ -103,5 +116,33 @@ void define_collision_mesh(py::module_& m)
             A function that takes two vertex IDs (row numbers in V) and returns
             true if the vertices (and faces or edges containing the vertices) can
             collide. By default all primitives can collide with all other primitives.
-            )ipc_Qu8mg5v7");
+            )ipc_Qu8mg5v7")
+        .def(
+            "set_vertex_patch_ids", &CollisionMesh::set_vertex_patch_ids,
+            R"ipc_Qu8mg5v7(
+            Set patch-based collision culling.
+
+            Patches are user-defined sub-regions of the mesh identified by a
+            per-vertex id. The patch-pair mask is forwarded to the broad
+            phase, where it is consulted as an inline array lookup before the
+            box tests. Takes precedence over can_collide during broad-phase
+            detection.
+
+            Parameters:
+                patch_ids: Per-vertex patch IDs (one per collision vertex).
+                can_patches_collide: Symmetric mask of which patch pairs can collide.
+            )ipc_Qu8mg5v7",
+            py::arg("patch_ids"), py::arg("can_patches_collide"))
+        .def(
+            "clear_vertex_patch_ids", &CollisionMesh::clear_vertex_patch_ids,
+            "Remove the patch-based collision culling.")
+        .def(
+            "has_vertex_patch_ids", &CollisionMesh::has_vertex_patch_ids,
+            "Are per-vertex patch IDs set?")
+        .def(
+            "vertex_patch_ids", &CollisionMesh::vertex_patch_ids,
+            "Per-vertex patch IDs (empty when unset).")
+        .def(
+            "can_patches_collide", &CollisionMesh::can_patches_collide,
+            "Mask of which patch pairs can collide.");
 }
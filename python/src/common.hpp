@@ -30,6 +30,18 @@ void assert_3D_vector(
     }
 }
 
+/// Check that every batch argument is an (N, 3) array sharing the first
+/// argument's number of rows.
+template <typename... Matrices>
+void assert_batch_of_3D_vectors(
+    const std::string& name, const Eigen::Index rows, const Matrices&... ms)
+{
+    if (!(... && (ms.cols() == 3 && ms.rows() == rows))) {
+        throw pybind11::value_error(
+            name + " expects (N, 3) arrays with a matching number of rows");
+    }
+}
+
 template <typename DerivedV, typename DerivedVCopy>
 inline void copy_vector(
     const Eigen::MatrixBase<DerivedV>& v,
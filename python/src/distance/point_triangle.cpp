@@ -3,6 +3,9 @@
 #include <ipc/distance/distance_type.hpp>
 #include <ipc/distance/point_triangle.hpp>
 
+#include <tbb/parallel_for.h>
+#include <tbb/blocked_range.h>
+
 namespace py = pybind11;
 using namespace ipc;
 
@@ -101,4 +104,85 @@ void define_point_triangle_distance(py::module_& m)
         )ipc_Qu8mg5v7",
         py::arg("p"), py::arg("t0"), py::arg("t1"), py::arg("t2"),
         py::arg("dtype") = py::none());
+
+    m.def(
+        "point_triangle_distance_batch",
+        [](ConstMatrixXdRef P, ConstMatrixXdRef T0, ConstMatrixXdRef T1,
+           ConstMatrixXdRef T2) {
+            assert_batch_of_3D_vectors(
+                "point_triangle_distance_batch", P.rows(), P, T0, T1, T2);
+            Eigen::VectorXd distances(P.rows());
+            tbb::parallel_for(
+                tbb::blocked_range<long>(0, P.rows()),
+                [&](const tbb::blocked_range<long>& r) {
+                    for (long i = r.begin(); i < r.end(); i++) {
+                        const Eigen::Vector3d p = P.row(i), t0 = T0.row(i),
+                                              t1 = T1.row(i), t2 = T2.row(i);
+                        distances[i] = point_triangle_distance(p, t0, t1, t2);
+                    }
+                });
+            return distances;
+        },
+        R"ipc_Qu8mg5v7(
+        Compute the distances of a batch of point-triangle queries.
+
+        Evaluates row i of every input as one query, so N queries cost one
+        native call instead of N; the batch is parallelized with TBB and
+        the GIL is released while it runs.
+
+        Parameters:
+            P : points as rows of an (N, 3) array.
+            T0: first vertices of the triangles as rows of an (N, 3) array.
+            T1: second vertices of the triangles as rows of an (N, 3) array.
+            T2: third vertices of the triangles as rows of an (N, 3) array.
+
+        Returns:
+            The distance of each query as an (N,) array.
+
+        Note:
+            The distances are actually squared distances.
+        )ipc_Qu8mg5v7",
+        py::arg("P"), py::arg("T0"), py::arg("T1"), py::arg("T2"),
+        py::call_guard<py::gil_scoped_release>());
+
+    m.def(
+        "point_triangle_distance_gradient_batch",
+        [](ConstMatrixXdRef P, ConstMatrixXdRef T0, ConstMatrixXdRef T1,
+           ConstMatrixXdRef T2) {
+            assert_batch_of_3D_vectors(
+                "point_triangle_distance_gradient_batch", P.rows(), P, T0, T1,
+                T2);
+            Eigen::MatrixXd grads(P.rows(), 12);
+            tbb::parallel_for(
+                tbb::blocked_range<long>(0, P.rows()),
+                [&](const tbb::blocked_range<long>& r) {
+                    for (long i = r.begin(); i < r.end(); i++) {
+                        const Eigen::Vector3d p = P.row(i), t0 = T0.row(i),
+                                              t1 = T1.row(i), t2 = T2.row(i);
+                        Vector<double, 12> grad;
+                        point_triangle_distance_gradient(p, t0, t1, t2, grad);
+                        grads.row(i) = grad.transpose();
+                    }
+                });
+            return grads;
+        },
+        R"ipc_Qu8mg5v7(
+        Compute the distance gradients of a batch of point-triangle queries
+        (see point_triangle_distance_batch).
+
+        Parameters:
+            P : points as rows of an (N, 3) array.
+            T0: first vertices of the triangles as rows of an (N, 3) array.
+            T1: second vertices of the triangles as rows of an (N, 3) array.
+            T2: third vertices of the triangles as rows of an (N, 3) array.
+
+        Returns:
+            The gradient of each query's distance wrt p, t0, t1, and t2 as
+            rows of an (N, 12) array.
+
+        Note:
+            The distances are actually squared distances.
+        )ipc_Qu8mg5v7",
+        py::arg("P"), py::arg("T0"), py::arg("T1"), py::arg("T2"),
+        py::call_guard<py::gil_scoped_release>());
 }
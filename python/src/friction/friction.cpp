@@ -51,6 +51,23 @@ void define_friction(py::module_& m)
         py::arg("dhat"), py::arg("barrier_stiffness"), py::arg("mus"),
         py::arg("blend_mu"));
 
+    m.def(
+        "update_friction_constraint_set", &update_friction_constraint_set,
+        R"ipc_Qu8mg5v7(
+        Refresh a built friction constraint set in place if possible.
+
+        Only the normal force magnitudes are recomputed when the constraint
+        topology is unchanged and no vertex moved more than
+        rebuild_tolerance; the tangent bases and closest points are kept.
+
+        Returns:
+            True if the set was refreshed in place; false if it must be
+            rebuilt with construct_friction_constraint_set.
+        )ipc_Qu8mg5v7",
+        py::arg("mesh"), py::arg("V"), py::arg("contact_constraint_set"),
+        py::arg("dhat"), py::arg("barrier_stiffness"),
+        py::arg("friction_constraint_set"), py::arg("rebuild_tolerance"));
+
     m.def(
         "compute_friction_potential", &compute_friction_potential<double>,
         R"ipc_Qu8mg5v7(
@@ -75,15 +92,42 @@ void define_friction(py::module_& m)
 
     m.def(
         "compute_friction_potential_hessian",
-        &compute_friction_potential_hessian, "", py::arg("mesh"), py::arg("V0"),
-        py::arg("V1"), py::arg("friction_constraint_set"),
-        py::arg("epsv_times_h"), py::arg("project_hessian_to_psd") = true);
+        py::overload_cast<
+            const CollisionMesh&, ConstMatrixXdRef,
+            ConstMatrixXdRef, const FrictionConstraints&, double, bool>(
+            &compute_friction_potential_hessian),
+        "", py::arg("mesh"), py::arg("V0"), py::arg("V1"),
+        py::arg("friction_constraint_set"), py::arg("epsv_times_h"),
+        py::arg("project_hessian_to_psd") = true);
+
+    m.def(
+        "compute_friction_potential_gradient_and_hessian",
+        [](const CollisionMesh& mesh, const Eigen::MatrixXd& V0,
+           const Eigen::MatrixXd& V1,
+           const FrictionConstraints& friction_constraint_set,
+           const double epsv_times_h, const bool project_hessian_to_psd) {
+            Eigen::VectorXd grad;
+            Eigen::SparseMatrix<double> hess;
+            compute_friction_potential_gradient_and_hessian(
+                mesh, V0, V1, friction_constraint_set, epsv_times_h, grad,
+                hess, project_hessian_to_psd);
+            return std::make_pair(grad, hess);
+        },
+        R"ipc_Qu8mg5v7(
+        Compute the friction potential gradient and hessian in one pass.
+
+        Returns:
+            The gradient and hessian of the friction potential.
+        )ipc_Qu8mg5v7",
+        py::arg("mesh"), py::arg("V0"), py::arg("V1"),
+        py::arg("friction_constraint_set"), py::arg("epsv_times_h"),
+        py::arg("project_hessian_to_psd") = true);
 
     m.def(
         "compute_friction_force",
         py::overload_cast<
-            const CollisionMesh&, const Eigen::MatrixXd&,
-            const Eigen::MatrixXd&, const Eigen::MatrixXd&,
+            const CollisionMesh&, ConstMatrixXdRef,
+            ConstMatrixXdRef, ConstMatrixXdRef,
             const FrictionConstraints&, const double, const double,
             const double, const double, const bool>(&compute_friction_force),
         "", py::arg("mesh"), py::arg("X"), py::arg("Ut"), py::arg("U"),
@@ -94,8 +138,8 @@ void define_friction(py::module_& m)
     m.def(
         "compute_friction_force",
         py::overload_cast<
-            const CollisionMesh&, const Eigen::MatrixXd&,
-            const Eigen::MatrixXd&, const FrictionConstraints&, const double,
+            const CollisionMesh&, ConstMatrixXdRef,
+            ConstMatrixXdRef, const FrictionConstraints&, const double,
             const double, const double, const double, const bool>(
             &compute_friction_force),
         "", py::arg("mesh"), py::arg("X"), py::arg("U"),
@@ -106,8 +150,8 @@ void define_friction(py::module_& m)
     m.def(
         "compute_friction_force_jacobian",
         py::overload_cast<
-            const CollisionMesh&, const Eigen::MatrixXd&,
-            const Eigen::MatrixXd&, const Eigen::MatrixXd&,
+            const CollisionMesh&, ConstMatrixXdRef,
+            ConstMatrixXdRef, ConstMatrixXdRef,
             const FrictionConstraints&, const double, const double,
             const double, const FrictionConstraint::DiffWRT, const double>(
             &compute_friction_force_jacobian),
@@ -119,8 +163,8 @@ void define_friction(py::module_& m)
     m.def(
         "compute_friction_force_jacobian",
         py::overload_cast<
-            const CollisionMesh&, const Eigen::MatrixXd&,
-            const Eigen::MatrixXd&, const FrictionConstraints&, const double,
+            const CollisionMesh&, ConstMatrixXdRef,
+            ConstMatrixXdRef, const FrictionConstraints&, const double,
             const double, const double, const FrictionConstraint::DiffWRT,
             const double>(&compute_friction_force_jacobian),
         "", py::arg("mesh"), py::arg("X"), py::arg("U"),
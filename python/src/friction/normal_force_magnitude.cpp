@@ -8,8 +8,10 @@ using namespace ipc;
 void define_normal_force_magnitude(py::module_& m)
 {
     m.def(
-        "compute_normal_force_magnitude", &compute_normal_force_magnitude, "",
-        py::arg("distance_squared"), py::arg("dhat"),
+        "compute_normal_force_magnitude",
+        py::overload_cast<double, double, double, double>(
+            &compute_normal_force_magnitude),
+        "", py::arg("distance_squared"), py::arg("dhat"),
         py::arg("barrier_stiffness"), py::arg("dmin") = 0);
 
     m.def(
@@ -17,4 +19,44 @@ void define_normal_force_magnitude(py::module_& m)
         &compute_normal_force_magnitude_gradient, "",
         py::arg("distance_squared"), py::arg("distance_squared_gradient"),
         py::arg("dhat"), py::arg("barrier_stiffness"), py::arg("dmin") = 0);
+
+    m.def(
+        "compute_normal_force_magnitude_batch",
+        py::overload_cast<const Eigen::ArrayXd&, double, double, double>(
+            &compute_normal_force_magnitude),
+        R"ipc_Qu8mg5v7(
+        Batched version of compute_normal_force_magnitude.
+
+        Parameters:
+            distances_squared: squared distances of the constraints
+            dhat: barrier activation distance
+            barrier_stiffness: stiffness of the barrier
+            dmin: minimum distance offset shared by the constraints
+
+        Returns:
+            The normal force magnitude of each constraint.
+        )ipc_Qu8mg5v7",
+        py::arg("distances_squared"), py::arg("dhat"),
+        py::arg("barrier_stiffness"), py::arg("dmin") = 0);
+
+    m.def(
+        "compute_normal_force_magnitude_gradient_coeffs",
+        &compute_normal_force_magnitude_gradient_coeffs,
+        R"ipc_Qu8mg5v7(
+        Batched scalar coefficients of the normal force magnitude gradient.
+
+        The gradient of constraint i's normal force magnitude is
+        coeffs[i] times its distance-squared gradient.
+
+        Parameters:
+            distances_squared: squared distances of the constraints
+            dhat: barrier activation distance
+            barrier_stiffness: stiffness of the barrier
+            dmin: minimum distance offset shared by the constraints
+
+        Returns:
+            The scalar gradient coefficient of each constraint.
+        )ipc_Qu8mg5v7",
+        py::arg("distances_squared"), py::arg("dhat"),
+        py::arg("barrier_stiffness"), py::arg("dmin") = 0);
 }
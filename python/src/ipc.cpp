@@ -1,6 +1,7 @@
 #include "common.hpp"
 
 #include <ipc/ipc.hpp>
+#include <ipc/approximate_potential.hpp>
 #include <igl/edges.h>
 
 namespace py = pybind11;
@@ -9,7 +10,10 @@ using namespace ipc;
 void define_ipc(py::module_& m)
 {
     m.def(
-        "compute_barrier_potential", &compute_barrier_potential,
+        "compute_barrier_potential",
+        py::overload_cast<
+            const CollisionMesh&, ConstMatrixXdRef, const Constraints&,
+            const double>(&compute_barrier_potential),
         R"ipc_Qu8mg5v7(
         Compute the barrier potential for a given constraint set.
 
@@ -23,7 +27,78 @@ void define_ipc(py::module_& m)
             The sum of all barrier potentials (not scaled by the barrier stiffness).
         )ipc_Qu8mg5v7",
         py::arg("mesh"), py::arg("V"), py::arg("constraint_set"),
-        py::arg("dhat"));
+        py::arg("dhat"), py::call_guard<py::gil_scoped_release>());
+
+    m.def(
+        "compute_barrier_potential_and_minimum_distance",
+        [](const CollisionMesh& mesh, ConstMatrixXdRef V,
+           const Constraints& constraint_set, const double dhat) {
+            double minimum_distance;
+            const double potential = compute_barrier_potential(
+                mesh, V, constraint_set, dhat, minimum_distance);
+            return std::make_pair(potential, minimum_distance);
+        },
+        R"ipc_Qu8mg5v7(
+        Compute the barrier potential and the minimum distance in one pass over the constraint set.
+
+        Parameters:
+            mesh: The collision mesh.
+            V: Vertices of the collision mesh.
+            constraint_set: The set of constraints.
+            dhat: The activation distance of the barrier.
+
+        Returns:
+            A tuple of the potential (not scaled by the barrier stiffness) and the minimum distance (squared) between any two elements.
+        )ipc_Qu8mg5v7",
+        py::arg("mesh"), py::arg("V"), py::arg("constraint_set"),
+        py::arg("dhat"), py::call_guard<py::gil_scoped_release>());
+
+    py::class_<ApproximateBarrierPotential>(
+        m, "ApproximateBarrierPotential",
+        R"ipc_Qu8mg5v7(
+        Cheap first-order barrier potential estimates for line search.
+
+        initialize() evaluates the potential exactly at the search origin
+        and caches every constraint's squared distance and distance
+        gradient; calling the object then estimates the potential at a
+        trial position with a first-order correction, recomputing exactly
+        only the constraints whose correction is untrustworthy or near the
+        activation distance. Use for Armijo comparisons only; re-run
+        initialize() at every accepted step.
+        )ipc_Qu8mg5v7")
+        .def(py::init(), "")
+        .def(
+            "initialize", &ApproximateBarrierPotential::initialize,
+            R"ipc_Qu8mg5v7(
+            Evaluate the potential exactly and cache the linearization.
+
+            Parameters:
+                mesh: The collision mesh.
+                V0: Vertices the line search starts from.
+                constraint_set: The set of constraints.
+                dhat: The activation distance of the barrier.
+
+            Returns:
+                The exact barrier potential at V0.
+            )ipc_Qu8mg5v7",
+            py::arg("mesh"), py::arg("V0"), py::arg("constraint_set"),
+            py::arg("dhat"), py::keep_alive<1, 2>(), py::keep_alive<1, 4>(),
+            py::call_guard<py::gil_scoped_release>())
+        .def(
+            "__call__", &ApproximateBarrierPotential::operator(),
+            R"ipc_Qu8mg5v7(
+            Estimate the barrier potential at a trial position.
+
+            Parameters:
+                V: Trial vertex positions (same topology as initialize()).
+
+            Returns:
+                The estimated barrier potential at V.
+            )ipc_Qu8mg5v7",
+            py::arg("V"), py::call_guard<py::gil_scoped_release>())
+        .def(
+            "num_exact", &ApproximateBarrierPotential::num_exact,
+            "Number of constraints the last call recomputed exactly.");
 
     m.def(
         "compute_barrier_potential_gradient",
@@ -41,10 +116,13 @@ void define_ipc(py::module_& m)
             The gradient of all barrier potentials (not scaled by the barrier stiffness). This will have a size of `V.size`.
         )ipc_Qu8mg5v7",
         py::arg("mesh"), py::arg("V"), py::arg("constraint_set"),
-        py::arg("dhat"));
+        py::arg("dhat"), py::call_guard<py::gil_scoped_release>());
 
     m.def(
-        "compute_barrier_potential_hessian", &compute_barrier_potential_hessian,
+        "compute_barrier_potential_hessian",
+        py::overload_cast<
+            const CollisionMesh&, ConstMatrixXdRef, const Constraints&,
+            const double, const bool>(&compute_barrier_potential_hessian),
         R"ipc_Qu8mg5v7(
         Compute the hessian of the barrier potential.
 
@@ -59,13 +137,67 @@ void define_ipc(py::module_& m)
             The hessian of all barrier potentials (not scaled by the barrier stiffness). This will have a shape of `(V.size, V.size).
         )ipc_Qu8mg5v7",
         py::arg("mesh"), py::arg("V"), py::arg("constraint_set"),
-        py::arg("dhat"), py::arg("project_hessian_to_psd") = true);
+        py::arg("dhat"), py::arg("project_hessian_to_psd") = true,
+        py::call_guard<py::gil_scoped_release>());
+
+    m.def(
+        "compute_barrier_potential_hessian_upper",
+        &compute_barrier_potential_hessian_upper,
+        R"ipc_Qu8mg5v7(
+        Compute only the upper triangle of the barrier potential hessian.
+
+        The hessian is symmetric, so emitting only the column >= row entries halves the triplet volume and the sort/merge cost of the assembly. Hand the result to solvers as a self-adjoint upper view.
+
+        Parameters:
+            mesh: The collision mesh.
+            V: Vertices of the collision mesh.
+            constraint_set: The set of constraints.
+            dhat: The activation distance of the barrier.
+            project_hessian_to_psd: Make sure the hessian is positive semi-definite.
+
+        Returns:
+            The upper triangle of the hessian of all barrier potentials (not scaled by the barrier stiffness). This will have a shape of `(V.size, V.size)`.
+        )ipc_Qu8mg5v7",
+        py::arg("mesh"), py::arg("V"), py::arg("constraint_set"),
+        py::arg("dhat"), py::arg("project_hessian_to_psd") = true,
+        py::call_guard<py::gil_scoped_release>());
+
+    m.def(
+        "compute_barrier_potential_and_derivatives",
+        [](const CollisionMesh& mesh, ConstMatrixXdRef V,
+           const Constraints& constraint_set, const double dhat,
+           const bool project_hessian_to_psd) {
+            Eigen::VectorXd grad;
+            Eigen::SparseMatrix<double> hess;
+            const double potential = compute_barrier_potential_and_derivatives(
+                mesh, V, constraint_set, dhat, grad, hess,
+                project_hessian_to_psd);
+            return std::make_tuple(potential, grad, hess);
+        },
+        R"ipc_Qu8mg5v7(
+        Compute the barrier potential, its gradient, and its hessian in one pass over the constraint set.
+
+        Each constraint's distance value and distance derivatives are computed once and shared between the three quantities.
+
+        Parameters:
+            mesh: The collision mesh.
+            V: Vertices of the collision mesh.
+            constraint_set: The set of constraints.
+            dhat: The activation distance of the barrier.
+            project_hessian_to_psd: Make sure the hessian is positive semi-definite.
+
+        Returns:
+            A tuple of the potential, its gradient, and its hessian (not scaled by the barrier stiffness).
+        )ipc_Qu8mg5v7",
+        py::arg("mesh"), py::arg("V"), py::arg("constraint_set"),
+        py::arg("dhat"), py::arg("project_hessian_to_psd") = true,
+        py::call_guard<py::gil_scoped_release>());
 
     m.def(
         "is_step_collision_free",
         py::overload_cast<
-            const CollisionMesh&, const Eigen::MatrixXd&,
-            const Eigen::MatrixXd&, const BroadPhaseMethod, const double,
+            const CollisionMesh&, ConstMatrixXdRef,
+            ConstMatrixXdRef, const BroadPhaseMethod, const double,
             const long>(&is_step_collision_free),
         R"ipc_Qu8mg5v7(
         Determine if the step is collision free.
@@ -83,13 +215,14 @@ void define_ipc(py::module_& m)
         )ipc_Qu8mg5v7",
         py::arg("mesh"), py::arg("V0"), py::arg("V1"),
         py::arg("method") = BroadPhaseMethod::HASH_GRID,
-        py::arg("tolerance") = 1e-6, py::arg("max_iterations") = long(1e7));
+        py::arg("tolerance") = 1e-6, py::arg("max_iterations") = long(1e7),
+        py::call_guard<py::gil_scoped_release>());
 
     m.def(
         "is_step_collision_free",
         py::overload_cast<
-            const Candidates&, const CollisionMesh&, const Eigen::MatrixXd&,
-            const Eigen::MatrixXd&, const double, const long>(
+            const Candidates&, const CollisionMesh&, ConstMatrixXdRef,
+            ConstMatrixXdRef, const double, const long>(
             &is_step_collision_free),
         R"ipc_Qu8mg5v7(
         Determine if the step is collision free from a set of candidates.
@@ -107,14 +240,39 @@ void define_ipc(py::module_& m)
             True if <b>any</b> collisions occur.
         )ipc_Qu8mg5v7",
         py::arg("candidates"), py::arg("mesh"), py::arg("V0"), py::arg("V1"),
-        py::arg("tolerance") = 1e-6, py::arg("max_iterations") = long(1e7));
+        py::arg("tolerance") = 1e-6, py::arg("max_iterations") = long(1e7),
+        py::call_guard<py::gil_scoped_release>());
+
+    py::class_<CCDBudget>(
+        m, "CCDBudget",
+        R"ipc_Qu8mg5v7(
+        Optional time/iteration budget for deadline-bounded CCD.
+
+        When passed to compute_collision_free_stepsize, the narrow phase
+        stops charging new queries once the budget expires and instead folds
+        each remaining candidate's certified conservative time-of-impact
+        lower bound into the step size. The returned step is smaller than
+        the full-tolerance answer but remains certified collision free.
+        )ipc_Qu8mg5v7")
+        .def(py::init(), "")
+        .def_readwrite(
+            "max_seconds", &CCDBudget::max_seconds,
+            "Wall-clock budget in seconds (infinity = unlimited).")
+        .def_readwrite(
+            "max_queries", &CCDBudget::max_queries,
+            "Maximum number of narrow-phase queries (-1 = unlimited).")
+        .def_readwrite(
+            "expired", &CCDBudget::expired,
+            "[out] Set when the budget expired and the conservative "
+            "fallback produced the step size.");
 
     m.def(
         "compute_collision_free_stepsize",
         py::overload_cast<
-            const CollisionMesh&, const Eigen::MatrixXd&,
-            const Eigen::MatrixXd&, const BroadPhaseMethod, const double,
-            const long>(&compute_collision_free_stepsize),
+            const CollisionMesh&, ConstMatrixXdRef,
+            ConstMatrixXdRef, const double, const BroadPhaseMethod,
+            const double, const long, const bool, CCDBudget* const>(
+            &compute_collision_free_stepsize),
         R"ipc_Qu8mg5v7(
         Computes a maximal step size that is collision free.
 
@@ -125,20 +283,25 @@ void define_ipc(py::module_& m)
             mesh: The collision mesh.
             V0: Vertex positions at start as rows of a matrix. Assumes V0 is intersection free.
             V1: Surface vertex positions at end as rows of a matrix.
+            min_distance: The minimum distance allowable between any two elements.
+            budget: Optional deadline budget (see CCDBudget).
 
         Returns:
             A step-size $\in [0, 1]$ that is collision free. A value of 1.0 if a full step and 0.0 is no step.
         )ipc_Qu8mg5v7",
         py::arg("mesh"), py::arg("V0"), py::arg("V1"),
+        py::arg("min_distance") = 0.0,
         py::arg("method") = BroadPhaseMethod::HASH_GRID,
-        py::arg("tolerance") = 1e-6, py::arg("max_iterations") = long(1e7));
+        py::arg("tolerance") = 1e-6, py::arg("max_iterations") = long(1e7),
+        py::arg("adaptive_tolerance") = false, py::arg("budget") = nullptr,
+        py::call_guard<py::gil_scoped_release>());
 
     m.def(
         "compute_collision_free_stepsize",
         py::overload_cast<
-            const Candidates&, const CollisionMesh&, const Eigen::MatrixXd&,
-            const Eigen::MatrixXd&, const double, const long>(
-            &compute_collision_free_stepsize),
+            const Candidates&, const CollisionMesh&, ConstMatrixXdRef,
+            ConstMatrixXdRef, const double, const double, const long,
+            const bool, CCDBudget* const>(&compute_collision_free_stepsize),
         R"ipc_Qu8mg5v7(
         Computes a maximal step size that is collision free using a set of collision candidates.
 
@@ -150,15 +313,23 @@ void define_ipc(py::module_& m)
             mesh: The collision mesh.
             V0: Vertex positions at start as rows of a matrix. Assumes V0 is intersection free.
             V1: Surface vertex positions at end as rows of a matrix.
+            min_distance: The minimum distance allowable between any two elements.
+            budget: Optional deadline budget (see CCDBudget).
 
         Returns:
             A step-size $\in [0, 1]$ that is collision free. A value of 1.0 if a full step and 0.0 is no step.
         )ipc_Qu8mg5v7",
         py::arg("candidates"), py::arg("mesh"), py::arg("V0"), py::arg("V1"),
-        py::arg("tolerance") = 1e-6, py::arg("max_iterations") = long(1e7));
+        py::arg("min_distance") = 0.0, py::arg("tolerance") = 1e-6,
+        py::arg("max_iterations") = long(1e7),
+        py::arg("adaptive_tolerance") = false, py::arg("budget") = nullptr,
+        py::call_guard<py::gil_scoped_release>());
 
     m.def(
-        "compute_minimum_distance", &compute_minimum_distance,
+        "compute_minimum_distance",
+        py::overload_cast<
+            const CollisionMesh&, ConstMatrixXdRef, const Constraints&>(
+            &compute_minimum_distance),
         R"ipc_Qu8mg5v7(
         Computes the minimum distance between any non-adjacent elements.
 
@@ -169,10 +340,41 @@ void define_ipc(py::module_& m)
         Returns:
             The minimum distance between any non-adjacent elements.
         )ipc_Qu8mg5v7",
-        py::arg("mesh"), py::arg("V"), py::arg("constraint_set"));
+        py::arg("mesh"), py::arg("V"), py::arg("constraint_set"),
+        py::call_guard<py::gil_scoped_release>());
 
     m.def(
-        "has_intersections", &has_intersections,
+        "compute_minimum_distance_and_closest_pairs",
+        [](const CollisionMesh& mesh, ConstMatrixXdRef V,
+           const Constraints& constraint_set, const int k) {
+            std::vector<std::pair<size_t, double>> closest_pairs;
+            const double min_dist = compute_minimum_distance(
+                mesh, V, constraint_set, k, closest_pairs);
+            return std::make_pair(min_dist, closest_pairs);
+        },
+        R"ipc_Qu8mg5v7(
+        Computes the minimum distance and the k closest constraint pairs.
+
+        The top-k heap is maintained on the same pass as the minimum reduction, so this costs no extra distance evaluations over compute_minimum_distance.
+
+        Parameters:
+            mesh: The collision mesh.
+            V: Vertices of the collision mesh.
+            constraint_set: The set of constraints to measure.
+            k: Number of closest pairs to report.
+
+        Returns:
+            A tuple of the minimum distance (squared) and a list of up to k (constraint index, squared distance) pairs sorted by increasing distance.
+        )ipc_Qu8mg5v7",
+        py::arg("mesh"), py::arg("V"), py::arg("constraint_set"),
+        py::arg("k"), py::call_guard<py::gil_scoped_release>());
+
+    m.def(
+        "has_intersections",
+        [](const CollisionMesh& mesh, ConstMatrixXdRef V,
+           const BroadPhaseMethod method) {
+            return has_intersections(mesh, V, method);
+        },
         R"ipc_Qu8mg5v7(
         Determine if the mesh has self intersections.
 
@@ -187,6 +389,24 @@ void define_ipc(py::module_& m)
         py::arg("mesh"), py::arg("V"),
         py::arg("method") = BroadPhaseMethod::HASH_GRID);
 
+    m.def(
+        "has_intersections",
+        py::overload_cast<
+            BroadPhase&, const CollisionMesh&, ConstMatrixXdRef>(
+            &has_intersections),
+        R"ipc_Qu8mg5v7(
+        Determine if the mesh has self intersections using an existing broad phase.
+
+        Parameters:
+            broad_phase: Broad phase built for the vertices V.
+            mesh: The collision mesh.
+            V: Vertices of the collision mesh.
+
+        Returns:
+            A boolean for if the mesh has intersections.
+        )ipc_Qu8mg5v7",
+        py::arg("broad_phase"), py::arg("mesh"), py::arg("V"));
+
     m.def(
         "edges",
         [](const Eigen::MatrixXi& F) {
@@ -204,4 +424,56 @@ void define_ipc(py::module_& m)
             #E by 2 list of edges in no particular order
         )ipc_Qu8mg5v7",
         py::arg("F"));
+
+    py::class_<CCDContext>(
+        m, "CCDContext",
+        R"ipc_Qu8mg5v7(
+        Reusable CCD context for a backtracking line search.
+
+        Builds the collision candidates once per search direction and caches
+        per-candidate times of impact, so repeated step-size queries along
+        scaled versions of the same direction only re-run the narrow-phase
+        queries invalidated by the scaling.
+        )ipc_Qu8mg5v7")
+        .def(py::init())
+        .def(
+            "build", &CCDContext::build,
+            R"ipc_Qu8mg5v7(
+            Build the candidate set for a new search direction.
+
+            Parameters:
+                mesh: The collision mesh.
+                V0: Vertex positions at start as rows of a matrix. Assumes V0 is intersection free.
+                V1: Surface vertex positions at the full step's end.
+                min_distance: The minimum distance allowable between any two elements.
+                method: The broad-phase method to use.
+            )ipc_Qu8mg5v7",
+            py::arg("mesh"), py::arg("V0"), py::arg("V1"),
+            py::arg("min_distance") = 0.0,
+            py::arg("method") = BroadPhaseMethod::HASH_GRID,
+            py::arg("tolerance") = 1e-6, py::arg("max_iterations") = long(1e7),
+            py::arg("adaptive_tolerance") = false,
+            py::call_guard<py::gil_scoped_release>())
+        .def(
+            "compute_collision_free_stepsize",
+            &CCDContext::compute_collision_free_stepsize,
+            R"ipc_Qu8mg5v7(
+            Computes a maximal collision-free step size for a trial step.
+
+            The trial step sweeps from V0 to V0 + step_scale * (V1 - V0)
+            where (V0, V1) is the direction passed to build().
+
+            Parameters:
+                mesh: The collision mesh passed to build().
+                step_scale: Fraction in (0, 1] of the full direction swept by this trial step.
+
+            Returns:
+                A step-size in [0, 1] of the trial step that is collision free.
+            )ipc_Qu8mg5v7",
+            py::arg("mesh"), py::arg("step_scale") = 1.0,
+            py::call_guard<py::gil_scoped_release>())
+        .def_property_readonly(
+            "candidates", &CCDContext::candidates,
+            py::return_value_policy::reference_internal,
+            "The collision candidates built for the current direction.");
 }
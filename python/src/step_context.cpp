@@ -0,0 +1,206 @@
+#include "common.hpp"
+
+#include <ipc/ipc.hpp>
+
+#include <tbb/task_group.h>
+
+namespace py = pybind11;
+using namespace ipc;
+
+namespace {
+
+/// Performs a whole Newton iteration's collision work in one native call.
+///
+/// A Python-driven solver otherwise makes 6-8 binding crossings per
+/// iteration (build, potential, gradient, hessian, step size, friction set,
+/// friction derivatives), each paying argument marshaling; this object does
+/// the same work in a single call with the GIL released and returns one
+/// bundle.
+class StepContext {
+public:
+    StepContext(
+        const CollisionMesh& mesh,
+        const double dhat,
+        const BroadPhaseMethod method,
+        const double min_distance)
+        : m_mesh(mesh) // copied so the context never outlives its mesh
+        , m_dhat(dhat)
+        , m_method(method)
+        , m_min_distance(min_distance)
+    {
+    }
+
+    void build_friction_constraint_set(
+        const Eigen::MatrixXd& V,
+        const double barrier_stiffness,
+        const Eigen::VectorXd& mus,
+        const double epsv_times_h)
+    {
+        py::gil_scoped_release release;
+        construct_friction_constraint_set(
+            m_mesh, V, m_constraint_set, m_dhat, barrier_stiffness, mus,
+            m_friction_constraint_set);
+        m_friction_V0 = V;
+        m_epsv_times_h = epsv_times_h;
+    }
+
+    py::dict step(
+        const Eigen::MatrixXd& V0,
+        const Eigen::MatrixXd& V1,
+        const bool project_hessian_to_psd)
+    {
+        double potential, max_step_size;
+        Eigen::VectorXd grad;
+        Eigen::SparseMatrix<double> hess;
+        double friction_potential = 0;
+        Eigen::VectorXd friction_grad;
+        Eigen::SparseMatrix<double> friction_hess;
+        const bool has_friction = !m_friction_constraint_set.empty();
+
+        {
+            py::gil_scoped_release release;
+
+            m_constraint_set.build(
+                m_mesh, V0, m_dhat, m_min_distance, m_method);
+
+            // Once the constraint set is built, the barrier derivatives, the
+            // step size, and the friction work only read shared state, so
+            // they run as concurrent tasks instead of four back-to-back
+            // parallel regions that each drain and refill the workers.
+            tbb::task_group tasks;
+            tasks.run([&] {
+                potential = compute_barrier_potential_and_derivatives(
+                    m_mesh, V0, m_constraint_set, m_dhat, grad, hess,
+                    project_hessian_to_psd, &m_workspace);
+            });
+            tasks.run([&] {
+                max_step_size = compute_collision_free_stepsize(
+                    m_mesh, V0, V1, m_min_distance, m_method);
+            });
+            if (has_friction) {
+                tasks.run([&] {
+                    friction_potential = compute_friction_potential(
+                        m_mesh, m_friction_V0, V0, m_friction_constraint_set,
+                        m_epsv_times_h);
+                    compute_friction_potential_gradient_and_hessian(
+                        m_mesh, m_friction_V0, V0, m_friction_constraint_set,
+                        m_epsv_times_h, friction_grad, friction_hess,
+                        project_hessian_to_psd, &m_workspace);
+                });
+            }
+            tasks.wait();
+        }
+
+        py::dict bundle;
+        bundle["potential"] = potential;
+        bundle["gradient"] = grad;
+        // Row-major so the caster hands back a scipy.sparse.csr_matrix.
+        bundle["hessian"] = Eigen::SparseMatrix<double, Eigen::RowMajor>(hess);
+        bundle["max_step_size"] = max_step_size;
+        if (has_friction) {
+            bundle["friction_potential"] = friction_potential;
+            bundle["friction_gradient"] = friction_grad;
+            bundle["friction_hessian"] =
+                Eigen::SparseMatrix<double, Eigen::RowMajor>(friction_hess);
+        }
+        return bundle;
+    }
+
+    const Constraints& constraint_set() const { return m_constraint_set; }
+
+    const FrictionConstraints& friction_constraint_set() const
+    {
+        return m_friction_constraint_set;
+    }
+
+protected:
+    CollisionMesh m_mesh;
+    double m_dhat;
+    BroadPhaseMethod m_method;
+    double m_min_distance;
+
+    Constraints m_constraint_set;
+    FrictionConstraints m_friction_constraint_set;
+    Eigen::MatrixXd m_friction_V0;
+    double m_epsv_times_h = 0;
+    /// Persistent scratch so repeated steps assemble without reallocating.
+    Workspace m_workspace;
+};
+
+} // namespace
+
+void define_step_context(py::module_& m)
+{
+    py::class_<StepContext>(
+        m, "StepContext",
+        R"ipc_Qu8mg5v7(
+        Performs a whole Newton iteration's collision work in one native call.
+
+        Bundles constraint-set construction, the barrier potential with its
+        derivatives, the collision-free step size, and (when enabled) the
+        friction derivatives into a single call with the GIL released,
+        instead of 6-8 separate binding crossings per iteration.
+        )ipc_Qu8mg5v7")
+        .def(
+            py::init<
+                const CollisionMesh&, const double, const BroadPhaseMethod,
+                const double>(),
+            R"ipc_Qu8mg5v7(
+            Create a step context for a fixed mesh and barrier.
+
+            Parameters:
+                mesh: The collision mesh (copied into the context).
+                dhat: The activation distance of the barrier.
+                method: The broad-phase method to use.
+                min_distance: The minimum distance allowable between any two elements.
+            )ipc_Qu8mg5v7",
+            py::arg("mesh"), py::arg("dhat"),
+            py::arg("method") = BroadPhaseMethod::HASH_GRID,
+            py::arg("min_distance") = 0.0)
+        .def(
+            "build_friction_constraint_set",
+            &StepContext::build_friction_constraint_set,
+            R"ipc_Qu8mg5v7(
+            Build the lagged friction constraint set from the last contact constraint set.
+
+            Call once per time step after a step() at the step's start
+            positions; subsequent step() calls include the friction potential
+            and its derivatives (with respect to the displacement from V) in
+            the bundle.
+
+            Parameters:
+                V: Vertex positions the friction constraints are lagged at.
+                barrier_stiffness: The current barrier stiffness.
+                mus: A vector of per-vertex coefficients of friction.
+                epsv_times_h: Tolerance for the transition between static and dynamic friction.
+            )ipc_Qu8mg5v7",
+            py::arg("V"), py::arg("barrier_stiffness"), py::arg("mus"),
+            py::arg("epsv_times_h"))
+        .def(
+            "step", &StepContext::step,
+            R"ipc_Qu8mg5v7(
+            Perform one iteration's collision work in a single native call.
+
+            Parameters:
+                V0: Current vertex positions of the collision mesh.
+                V1: Proposed end positions for the collision-free step size.
+                project_hessian_to_psd: Make sure the hessians are positive semi-definite.
+
+            Returns:
+                A dict with the potential, its gradient, its hessian as a
+                scipy-compatible CSR matrix, and the maximal collision-free
+                step size from V0 to V1; plus the friction potential,
+                gradient, and hessian when a friction constraint set is
+                built.
+            )ipc_Qu8mg5v7",
+            py::arg("V0"), py::arg("V1"),
+            py::arg("project_hessian_to_psd") = true)
+        .def_property_readonly(
+            "constraint_set", &StepContext::constraint_set,
+            py::return_value_policy::reference_internal,
+            "The contact constraint set built by the last step() call.")
+        .def_property_readonly(
+            "friction_constraint_set", &StepContext::friction_constraint_set,
+            py::return_value_policy::reference_internal,
+            "The friction constraint set built for the current time step.");
+}
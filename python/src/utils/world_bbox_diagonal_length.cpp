@@ -8,6 +8,7 @@ using namespace ipc;
 void define_world_bbox_diagonal_length(py::module_& m)
 {
     m.def(
-        "world_bbox_diagonal_length", &world_bbox_diagonal_length, "",
+        "world_bbox_diagonal_length",
+        py::overload_cast<ConstMatrixXdRef>(&world_bbox_diagonal_length), "",
         py::arg("V"));
 }
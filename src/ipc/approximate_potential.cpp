@@ -0,0 +1,163 @@
+#include "approximate_potential.hpp"
+
+#include <ipc/utils/execution_context.hpp>
+#include <ipc/utils/profiler.hpp>
+
+#include <tbb/blocked_range.h>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
+
+#include <algorithm> // std::min
+#include <cmath> // std::abs
+
+namespace ipc {
+
+double ApproximateBarrierPotential::initialize(
+    const CollisionMesh& mesh,
+    ConstMatrixXdRef V0,
+    const Constraints& constraint_set,
+    const double dhat)
+{
+    IPC_PROFILE_SCOPE("ApproximateBarrierPotential::initialize");
+
+    assert(V0.rows() == mesh.num_vertices());
+
+    m_mesh = &mesh;
+    m_constraint_set = &constraint_set;
+    m_dhat = dhat;
+    m_num_exact = 0;
+
+    const size_t num_constraints = constraint_set.size();
+    m_vertex_ids.resize(num_constraints);
+    m_origin_positions.resize(num_constraints);
+    m_distances.resize(num_constraints);
+    m_distance_grads.resize(num_constraints);
+
+    if (constraint_set.empty()) {
+        return 0;
+    }
+
+    const Eigen::MatrixXi& E = mesh.edges();
+    const Eigen::MatrixXi& F = mesh.faces();
+    const int dim = V0.cols();
+
+    return execution_context().run([&]() -> double {
+        tbb::enumerable_thread_specific<double> storage(0.0);
+
+        tbb::parallel_for(
+            tbb::blocked_range<size_t>(size_t(0), num_constraints),
+            [&](const tbb::blocked_range<size_t>& r) {
+                double& local_potential = storage.local();
+                constraint_set.for_each(
+                    r.begin(), r.end(),
+                    [&](const auto& constraint, const size_t i) {
+                        const std::array<index_t, 4> ids =
+                            constraint.vertex_indices(E, F);
+                        m_vertex_ids[i] = ids;
+
+                        VectorMax12d& x0 = m_origin_positions[i];
+                        x0.resize(4 * dim);
+                        for (int k = 0; k < 4 && ids[k] >= 0; k++) {
+                            x0.segment(dim * k, dim) =
+                                V0.row(ids[k]).transpose();
+                        }
+
+                        const double distance =
+                            constraint.compute_distance(V0, E, F);
+                        m_distances[i] = distance;
+                        m_distance_grads[i] =
+                            constraint.compute_distance_gradient(V0, E, F);
+
+                        local_potential += constraint.compute_potential(
+                            V0, E, F, dhat, distance);
+                    });
+            });
+
+        double potential = 0;
+        for (const double local_potential : storage) {
+            potential += local_potential;
+        }
+        return potential;
+    });
+}
+
+double ApproximateBarrierPotential::operator()(ConstMatrixXdRef V) const
+{
+    IPC_PROFILE_SCOPE("ApproximateBarrierPotential::evaluate");
+
+    assert(m_constraint_set != nullptr && "initialize() must be called");
+    assert(V.rows() == m_mesh->num_vertices());
+
+    if (m_constraint_set->empty()) {
+        m_num_exact = 0;
+        return 0;
+    }
+
+    const Constraints& constraint_set = *m_constraint_set;
+    const Eigen::MatrixXi& E = m_mesh->edges();
+    const Eigen::MatrixXi& F = m_mesh->faces();
+    const int dim = V.cols();
+    const double dhat = m_dhat;
+
+    return execution_context().run([&]() -> double {
+        // Thread-local running (potential, exact recomputation count) pair.
+        tbb::enumerable_thread_specific<std::pair<double, size_t>> storage(
+            std::make_pair(0.0, size_t(0)));
+
+        tbb::parallel_for(
+            tbb::blocked_range<size_t>(size_t(0), constraint_set.size()),
+            [&](const tbb::blocked_range<size_t>& r) {
+                auto& [local_potential, local_num_exact] = storage.local();
+                constraint_set.for_each(
+                    r.begin(), r.end(),
+                    [&](const auto& constraint, const size_t i) {
+                        const std::array<index_t, 4>& ids = m_vertex_ids[i];
+                        const VectorMax12d& x0 = m_origin_positions[i];
+                        const VectorMax12d& grad = m_distance_grads[i];
+
+                        // First-order squared-distance estimate:
+                        // d² ≈ d₀² + ∇d₀² ⋅ (x - x₀).
+                        double correction = 0;
+                        for (int k = 0; k < 4 && ids[k] >= 0; k++) {
+                            for (int l = 0; l < dim; l++) {
+                                correction += grad[dim * k + l]
+                                    * (V(ids[k], l) - x0[dim * k + l]);
+                            }
+                        }
+
+                        const double dmin = constraint.minimum_distance;
+                        const double kappa =
+                            2 * dmin * dhat + dhat * dhat;
+                        const double gap0 = m_distances[i] - dmin * dmin;
+
+                        double distance = m_distances[i] + correction;
+
+                        // Recompute exactly when the correction is large
+                        // relative to the gap (untrustworthy linearization)
+                        // or the estimate lands near the activation
+                        // distance (could wrongly (de)activate the
+                        // barrier).
+                        if (std::abs(correction) > TRUST_RATIO * gap0
+                            || distance - dmin * dmin
+                                >= ACTIVATION_BAND * kappa) {
+                            distance = constraint.compute_distance(V, E, F);
+                            local_num_exact++;
+                        }
+
+                        local_potential += constraint.compute_potential(
+                            V, E, F, dhat, distance);
+                    });
+            });
+
+        double potential = 0;
+        size_t num_exact = 0;
+        for (const auto& [local_potential, local_num_exact] : storage) {
+            potential += local_potential;
+            num_exact += local_num_exact;
+        }
+        m_num_exact = num_exact;
+        return potential;
+    });
+}
+
+} // namespace ipc
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <ipc/collision_mesh.hpp>
+#include <ipc/collisions/constraints.hpp>
+#include <ipc/utils/eigen_ext.hpp>
+#include <ipc/utils/index.hpp>
+
+#include <Eigen/Core>
+
+#include <array>
+#include <vector>
+
+namespace ipc {
+
+/// @brief Cheap first-order barrier potential estimates for line search.
+///
+/// A backtracking line search evaluates compute_barrier_potential() at
+/// several trial positions per iteration, but only needs enough accuracy to
+/// compare against the Armijo bound. initialize() performs one exact
+/// evaluation at the search origin and caches every constraint's squared
+/// distance and distance gradient; the call operator then estimates the
+/// potential at a trial position from the cached distances with a
+/// first-order correction, replacing the per-constraint distance
+/// computation (the type dispatch and closest-point search) with a dot
+/// product over the stencil displacements.
+///
+/// A constraint is recomputed exactly when the correction is large relative
+/// to its gap above the minimum distance (the linearization is not
+/// trustworthy) or when the estimate lands near the activation distance
+/// (where the linearization could wrongly activate or deactivate the
+/// barrier), so the estimate degrades gracefully to the exact potential for
+/// large steps.
+///
+/// The estimates are for potential comparisons only: re-run initialize() at
+/// every accepted step (it returns the exact potential there, so it
+/// replaces one of the evaluations), and do not use them for gradients or
+/// convergence tests. The mesh and constraint set are captured by reference
+/// and must outlive the evaluator.
+class ApproximateBarrierPotential {
+public:
+    ApproximateBarrierPotential() { }
+
+    /// @brief Evaluate the potential exactly and cache the linearization.
+    /// @param[in] mesh The collision mesh.
+    /// @param[in] V0 Vertices the line search starts from.
+    /// @param[in] constraint_set The set of constraints.
+    /// @param[in] dhat The activation distance of the barrier.
+    /// @returns The exact barrier potential at V0.
+    double initialize(
+        const CollisionMesh& mesh,
+        ConstMatrixXdRef V0,
+        const Constraints& constraint_set,
+        const double dhat);
+
+    /// @brief Estimate the barrier potential at a trial position.
+    /// @param[in] V Trial vertex positions (same topology as initialize()).
+    /// @returns The estimated barrier potential at V.
+    double operator()(ConstMatrixXdRef V) const;
+
+    /// @brief Number of constraints the last call recomputed exactly.
+    size_t num_exact() const { return m_num_exact; }
+
+    /// @brief Largest relative correction the linearization is trusted for.
+    static constexpr double TRUST_RATIO = 0.1;
+    /// @brief Fraction of the barrier activation interval treated as "near
+    /// the activation distance" (estimates beyond it are recomputed).
+    static constexpr double ACTIVATION_BAND = 0.9;
+
+protected:
+    const CollisionMesh* m_mesh = nullptr;
+    const Constraints* m_constraint_set = nullptr;
+    double m_dhat = 0;
+
+    /// @brief Vertex indices of each constraint (unused slots -1).
+    std::vector<std::array<index_t, 4>> m_vertex_ids;
+    /// @brief Stencil positions at the search origin.
+    std::vector<VectorMax12d> m_origin_positions;
+    /// @brief Squared distances at the search origin.
+    std::vector<double> m_distances;
+    /// @brief Squared-distance gradients at the search origin.
+    std::vector<VectorMax12d> m_distance_grads;
+
+    /// @brief Exact recomputations in the last call (see num_exact()).
+    mutable size_t m_num_exact = 0;
+};
+
+} // namespace ipc
@@ -3,8 +3,13 @@
 #include "adaptive_stiffness.hpp"
 
 #include <ipc/barrier/barrier.hpp>
+#include <ipc/utils/execution_context.hpp>
+#include <ipc/utils/ordered_reduction.hpp>
+
+#include <tbb/parallel_for.h>
 
 #include <algorithm> // std::min/max
+#include <vector>
 
 namespace ipc {
 
@@ -17,6 +22,41 @@ double initial_barrier_stiffness(
     double& max_barrier_stiffness,
     const double min_barrier_stiffness_scale,
     const double dmin)
+{
+    assert(grad_energy.size() == grad_barrier.size());
+
+    // Both reductions in one parallel sweep over the gradients. The fixed
+    // blocking and ordered combination make the sums deterministic by
+    // construction, so there is no separate deterministic mode here.
+    const size_t num_blocks = num_deterministic_blocks(grad_barrier.size());
+    std::vector<double> dot_partials(num_blocks);
+    std::vector<double> sqnorm_partials(num_blocks);
+    execution_context().run([&]() {
+        tbb::parallel_for(size_t(0), num_blocks, [&](const size_t b) {
+            const size_t begin = b * DETERMINISTIC_BLOCK_SIZE;
+            const size_t size = std::min(
+                DETERMINISTIC_BLOCK_SIZE, size_t(grad_barrier.size()) - begin);
+            const auto block = grad_barrier.segment(begin, size);
+            dot_partials[b] = block.dot(grad_energy.segment(begin, size));
+            sqnorm_partials[b] = block.squaredNorm();
+        });
+    });
+
+    return initial_barrier_stiffness(
+        bbox_diagonal, dhat, average_mass, ordered_pairwise_sum(dot_partials),
+        ordered_pairwise_sum(sqnorm_partials), max_barrier_stiffness,
+        min_barrier_stiffness_scale, dmin);
+}
+
+double initial_barrier_stiffness(
+    const double bbox_diagonal,
+    const double dhat,
+    const double average_mass,
+    const double grad_energy_dot_grad_barrier,
+    const double grad_barrier_sqnorm,
+    double& max_barrier_stiffness,
+    const double min_barrier_stiffness_scale,
+    const double dmin)
 {
     assert(average_mass > 0 && min_barrier_stiffness_scale > 0);
     assert(bbox_diagonal > 0);
@@ -39,9 +79,9 @@ double initial_barrier_stiffness(
     max_barrier_stiffness = 100 * min_barrier_stiffness;
 
     double kappa = 1.0;
-    if (grad_barrier.squaredNorm() > 0) {
+    if (grad_barrier_sqnorm > 0) {
         // If this value is negative it will be clamped to κ_min anyways
-        kappa = -grad_barrier.dot(grad_energy) / grad_barrier.squaredNorm();
+        kappa = -grad_energy_dot_grad_barrier / grad_barrier_sqnorm;
         assert(std::isfinite(kappa));
     }
 
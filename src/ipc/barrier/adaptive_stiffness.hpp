@@ -26,7 +26,36 @@ double initial_barrier_stiffness(
     const double min_barrier_stiffness_scale = 1e11,
     const double dmin = 0);
 
+/// @brief Compute an inital barrier stiffness from precomputed gradient products.
+///
+/// Overload for callers that already hold the two gradient reductions (e.g.
+/// from their own fused gradient pass): the stiffness then costs only the
+/// scalar formula, with no traversal of the gradients.
+/// @param[in] bbox_diagonal Length of the diagonal of the bounding box of the scene.
+/// @param[in] dhat Activation distance of the barrier.
+/// @param[in] average_mass Average mass of all bodies.
+/// @param[in] grad_energy_dot_grad_barrier Dot product of the elasticity energy and barrier potential gradients.
+/// @param[in] grad_barrier_sqnorm Squared norm of the barrier potential gradient.
+/// @param[out] max_barrier_stiffness Maximum stiffness of the barrier.
+/// @param[in] min_barrier_stiffness_scale Scale used to premultiply the minimum barrier stiffness.
+/// @param[in] dmin Minimum distance between elements.
+/// @return The initial barrier stiffness.
+double initial_barrier_stiffness(
+    const double bbox_diagonal,
+    const double dhat,
+    const double average_mass,
+    const double grad_energy_dot_grad_barrier,
+    const double grad_barrier_sqnorm,
+    double& max_barrier_stiffness,
+    const double min_barrier_stiffness_scale = 1e11,
+    const double dmin = 0);
+
 /// @brief Update the barrier stiffness if the distance is decreasing and less than dhat_epsilon_scale * diag.
+///
+/// Pure scalar formula: feed it the (squared) minimum distances tracked by
+/// the fused potential pass (see the compute_barrier_potential overload with
+/// a minimum_distance output) rather than a separate compute_minimum_distance
+/// traversal.
 /// @param[in] prev_min_distance Previous minimum distance between elements.
 /// @param[in] min_distance Current minimum distance between elements.
 /// @param[in] max_barrier_stiffness Maximum stiffness of the barrier.
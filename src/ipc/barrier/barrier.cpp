@@ -3,8 +3,13 @@
 // inequlity constraints on a function.
 #include "barrier.hpp"
 
+#include <limits>
+
 namespace ipc {
 
+// Declared extern template in barrier.hpp.
+template double barrier(const double& d, const double dhat);
+
 double barrier_gradient(const double d, const double dhat)
 {
     if (d <= 0.0 || d >= dhat) {
@@ -26,4 +31,38 @@ double barrier_hessian(const double d, const double dhat)
     return (dhat_d + 2) * dhat_d - 2 * log(d / dhat) - 3;
 }
 
+// The batched overloads evaluate the formulas branch-free on the full array
+// (clamping the log argument away from zero) and then overwrite the
+// out-of-range entries, so the expressions stay vectorizable.
+
+Eigen::ArrayXd barrier(const Eigen::ArrayXd& d, const double dhat)
+{
+    const Eigen::ArrayXd d_safe = d.max(std::numeric_limits<double>::min());
+    // b(d) = -(d - d̂)²ln(d / d̂)
+    const Eigen::ArrayXd b =
+        -(d_safe - dhat).square() * (d_safe / dhat).log();
+    return (d <= 0.0)
+        .select(
+            std::numeric_limits<double>::infinity(),
+            (d >= dhat).select(0.0, b));
+}
+
+Eigen::ArrayXd barrier_gradient(const Eigen::ArrayXd& d, const double dhat)
+{
+    const Eigen::ArrayXd d_safe = d.max(std::numeric_limits<double>::min());
+    // b'(d) = (d̂ - d) * (2ln(d/d̂) - d̂/d + 1)
+    const Eigen::ArrayXd grad_b =
+        (dhat - d_safe) * (2 * (d_safe / dhat).log() - dhat / d_safe + 1);
+    return (d <= 0.0 || d >= dhat).select(0.0, grad_b);
+}
+
+Eigen::ArrayXd barrier_hessian(const Eigen::ArrayXd& d, const double dhat)
+{
+    const Eigen::ArrayXd d_safe = d.max(std::numeric_limits<double>::min());
+    const Eigen::ArrayXd dhat_d = dhat / d_safe;
+    const Eigen::ArrayXd hess_b =
+        (dhat_d + 2) * dhat_d - 2 * (d_safe / dhat).log() - 3;
+    return (d <= 0.0 || d >= dhat).select(0.0, hess_b);
+}
+
 } // namespace ipc
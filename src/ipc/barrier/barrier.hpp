@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include <Eigen/Core>
+
 namespace ipc {
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -21,6 +23,11 @@ namespace ipc {
 /// @return The value of the barrier function at d.
 template <typename T> T barrier(const T& d, const double dhat);
 
+// The double case is compiled once in barrier.cpp (see the explicit
+// instantiation there); the template stays header-only for autodiff scalar
+// types.
+extern template double barrier(const double& d, const double dhat);
+
 /// @brief Derivative of the barrier function.
 ///
 /// \f\[
@@ -45,6 +52,65 @@ double barrier_gradient(const double d, const double dhat);
 /// @return The second derivative of the barrier wrt d.
 double barrier_hessian(const double d, const double dhat);
 
+/// @brief Batched version of the barrier function.
+///
+/// Evaluating a contiguous array of distances in one call lets Eigen use its
+/// packet log (one packet of lanes per instruction when built with
+/// IPC_TOOLKIT_WITH_SIMD) instead of a scalar log per constraint.
+/// @param d The distances.
+/// @param dhat Activation distance of the barrier.
+/// @return The value of the barrier function at each distance.
+Eigen::ArrayXd barrier(const Eigen::ArrayXd& d, const double dhat);
+
+/// @brief Batched version of the barrier derivative.
+/// @param d The distances.
+/// @param dhat Activation distance of the barrier.
+/// @return The derivative of the barrier wrt each distance.
+Eigen::ArrayXd barrier_gradient(const Eigen::ArrayXd& d, const double dhat);
+
+/// @brief Batched version of the barrier second derivative.
+/// @param d The distances.
+/// @param dhat Activation distance of the barrier.
+/// @return The second derivative of the barrier wrt each distance.
+Eigen::ArrayXd barrier_hessian(const Eigen::ArrayXd& d, const double dhat);
+
+///////////////////////////////////////////////////////////////////////////////
+// Barrier customization point
+///////////////////////////////////////////////////////////////////////////////
+
+/// @brief The clamped-log barrier of [Li et al. 2020] as a stateless functor
+/// type.
+///
+/// This is the default of the compile-time Barrier customization point of
+/// the potential pipeline: the templated potential kernels (see
+/// CollisionConstraint::compute_potential_T and the templated
+/// compute_barrier_potential overloads in ipc.hpp) take a Barrier type with
+/// the three static members below, so experimental barrier variants
+/// (clamped-log alternatives, quadratic-log hybrids, ...) inline into the
+/// constraint loops with no indirection. A custom barrier must be zero with
+/// vanishing derivatives for d ≥ dhat, grow to infinity as d → 0⁺, and have
+/// a nonnegative second derivative on (0, dhat) (the hessian assembly
+/// assumes the ∇d∇dᵀ term is PSD).
+struct ClampedLogBarrier {
+    /// @brief b(d); forwards to barrier().
+    template <typename T> static T value(const T& d, const double dhat)
+    {
+        return barrier(d, dhat);
+    }
+
+    /// @brief b'(d); forwards to barrier_gradient().
+    static double first_derivative(const double d, const double dhat)
+    {
+        return barrier_gradient(d, dhat);
+    }
+
+    /// @brief b''(d); forwards to barrier_hessian().
+    static double second_derivative(const double d, const double dhat)
+    {
+        return barrier_hessian(d, dhat);
+    }
+};
+
 } // namespace ipc
 
 #include "barrier.tpp"
@@ -0,0 +1,775 @@
+#include "barrier_potential_gpu.hpp"
+
+#ifdef IPC_TOOLKIT_WITH_CUDA
+
+#include <cuda_runtime.h>
+#include <math_constants.h>
+
+#include <algorithm> // std::lower_bound, std::sort, std::unique
+#include <cmath>
+#include <stdexcept>
+
+namespace ipc {
+
+namespace {
+
+    constexpr int BLOCK_SIZE = 256;
+
+    // Constraint types in upload order (see set_constraints()).
+    constexpr int VERTEX_VERTEX = 0;
+    constexpr int EDGE_VERTEX = 1;
+    constexpr int EDGE_EDGE = 2;
+    constexpr int FACE_VERTEX = 3;
+
+    inline int num_blocks(size_t n)
+    {
+        return int((n + BLOCK_SIZE - 1) / BLOCK_SIZE);
+    }
+
+    inline void check_cuda(cudaError_t status)
+    {
+        if (status != cudaSuccess) {
+            throw std::runtime_error(
+                std::string("BarrierPotentialGPU CUDA error: ")
+                + cudaGetErrorString(status));
+        }
+    }
+
+    template <typename T> T* device_alloc(const size_t count)
+    {
+        T* ptr = nullptr;
+        check_cuda(cudaMalloc(&ptr, count * sizeof(T)));
+        return ptr;
+    }
+
+    template <typename T>
+    void device_upload(T* d_ptr, const std::vector<T>& values)
+    {
+        check_cuda(cudaMemcpy(
+            d_ptr, values.data(), values.size() * sizeof(T),
+            cudaMemcpyHostToDevice));
+    }
+
+    // ---------------------------------------------------------------------
+    // double3 helpers
+
+    __device__ inline double3 load_point(const double* V, const int vi)
+    {
+        return make_double3(V[3 * vi + 0], V[3 * vi + 1], V[3 * vi + 2]);
+    }
+
+    __device__ inline double3 sub(const double3& a, const double3& b)
+    {
+        return make_double3(a.x - b.x, a.y - b.y, a.z - b.z);
+    }
+
+    __device__ inline double dot(const double3& a, const double3& b)
+    {
+        return a.x * b.x + a.y * b.y + a.z * b.z;
+    }
+
+    __device__ inline double3 cross(const double3& a, const double3& b)
+    {
+        return make_double3(
+            a.y * b.z - a.z * b.y, //
+            a.z * b.x - a.x * b.z, //
+            a.x * b.y - a.y * b.x);
+    }
+
+    __device__ inline double clamp01(const double t)
+    {
+        return fmin(fmax(t, 0.0), 1.0);
+    }
+
+    // ---------------------------------------------------------------------
+    // Barrier (matches barrier.tpp / barrier.cpp)
+
+    __device__ inline double barrier_d(const double d, const double dhat)
+    {
+        if (d <= 0.0) {
+            return CUDART_INF;
+        }
+        if (d >= dhat) {
+            return 0.0;
+        }
+        const double d_minus_dhat = d - dhat;
+        return -d_minus_dhat * d_minus_dhat * log(d / dhat);
+    }
+
+    __device__ inline double
+    barrier_gradient_d(const double d, const double dhat)
+    {
+        if (d <= 0.0 || d >= dhat) {
+            return 0.0;
+        }
+        return (dhat - d) * (2 * log(d / dhat) - dhat / d + 1);
+    }
+
+    __device__ inline double
+    barrier_hessian_d(const double d, const double dhat)
+    {
+        if (d <= 0.0 || d >= dhat) {
+            return 0.0;
+        }
+        const double dhat_d = dhat / d;
+        return (dhat_d + 2) * dhat_d - 2 * log(d / dhat) - 3;
+    }
+
+    // ---------------------------------------------------------------------
+    // Distance evaluation
+    //
+    // Every constraint's squared distance is |Σₖ wₖ xₖ|² with signed
+    // closest-point weights wₖ (positive on the point side, negative on the
+    // closest point of the other primitive), so the distance gradient wrt
+    // vertex k is exactly 2 wₖ (p - q) by the envelope theorem.
+
+    /// @brief Closest-point weights and difference vector of a constraint.
+    struct DistanceFrame {
+        double w[4]; ///< @brief Signed closest-point weights.
+        double3 diff; ///< @brief p - q = Σₖ wₖ xₖ.
+        double distance; ///< @brief Squared distance |diff|².
+    };
+
+    __device__ inline void point_edge_weights(
+        const double3& p,
+        const double3& e0,
+        const double3& e1,
+        double w[4])
+    {
+        const double3 e = sub(e1, e0);
+        const double e_sqr = dot(e, e);
+        const double t =
+            e_sqr > 0 ? clamp01(dot(sub(p, e0), e) / e_sqr) : 0.0;
+        w[0] = 1;
+        w[1] = -(1 - t);
+        w[2] = -t;
+        w[3] = 0;
+    }
+
+    /// @brief Closest point on a triangle in barycentric form
+    /// [Ericson 2005].
+    __device__ inline void point_triangle_weights(
+        const double3& p,
+        const double3& a,
+        const double3& b,
+        const double3& c,
+        double w[4])
+    {
+        const double3 ab = sub(b, a), ac = sub(c, a), ap = sub(p, a);
+        const double d1 = dot(ab, ap), d2 = dot(ac, ap);
+        double u, v;
+        if (d1 <= 0 && d2 <= 0) {
+            u = v = 0; // Vertex a
+        } else {
+            const double3 bp = sub(p, b);
+            const double d3 = dot(ab, bp), d4 = dot(ac, bp);
+            const double3 cp = sub(p, c);
+            const double d5 = dot(ab, cp), d6 = dot(ac, cp);
+            const double vc = d1 * d4 - d3 * d2;
+            const double vb = d5 * d2 - d1 * d6;
+            const double va = d3 * d6 - d5 * d4;
+            if (d3 >= 0 && d4 <= d3) {
+                u = 1, v = 0; // Vertex b
+            } else if (d6 >= 0 && d5 <= d6) {
+                u = 0, v = 1; // Vertex c
+            } else if (vc <= 0 && d1 >= 0 && d3 <= 0) {
+                u = d1 / (d1 - d3), v = 0; // Edge ab
+            } else if (vb <= 0 && d2 >= 0 && d6 <= 0) {
+                u = 0, v = d2 / (d2 - d6); // Edge ac
+            } else if (va <= 0 && (d4 - d3) >= 0 && (d5 - d6) >= 0) {
+                u = (d4 - d3) / ((d4 - d3) + (d5 - d6)); // Edge bc
+                v = 1 - u;
+            } else {
+                const double denom = 1.0 / (va + vb + vc); // Interior
+                u = vb * denom, v = vc * denom;
+            }
+        }
+        w[0] = 1;
+        w[1] = -(1 - u - v);
+        w[2] = -u;
+        w[3] = -v;
+    }
+
+    /// @brief Closest points of two segments in parametric form
+    /// [Ericson 2005].
+    __device__ inline void edge_edge_weights(
+        const double3& ea0,
+        const double3& ea1,
+        const double3& eb0,
+        const double3& eb1,
+        double w[4])
+    {
+        const double3 u = sub(ea1, ea0), v = sub(eb1, eb0);
+        const double3 r = sub(ea0, eb0);
+        const double a = dot(u, u), e = dot(v, v), f = dot(v, r);
+        double s, t;
+        if (a <= 0 && e <= 0) {
+            s = t = 0;
+        } else if (a <= 0) {
+            s = 0, t = clamp01(f / e);
+        } else {
+            const double c = dot(u, r);
+            if (e <= 0) {
+                t = 0, s = clamp01(-c / a);
+            } else {
+                const double b = dot(u, v);
+                const double denom = a * e - b * b;
+                s = denom > 0 ? clamp01((b * f - c * e) / denom) : 0.0;
+                t = (b * s + f) / e;
+                if (t < 0) {
+                    t = 0, s = clamp01(-c / a);
+                } else if (t > 1) {
+                    t = 1, s = clamp01((b - c) / a);
+                }
+            }
+        }
+        w[0] = 1 - s;
+        w[1] = s;
+        w[2] = -(1 - t);
+        w[3] = -t;
+    }
+
+    __device__ inline DistanceFrame compute_distance_frame(
+        const double* V, const int type, const int* vertex_ids)
+    {
+        DistanceFrame frame;
+        const double3 x0 = load_point(V, vertex_ids[0]);
+        const double3 x1 = load_point(V, vertex_ids[1]);
+        switch (type) {
+        case VERTEX_VERTEX:
+            frame.w[0] = 1, frame.w[1] = -1, frame.w[2] = frame.w[3] = 0;
+            break;
+        case EDGE_VERTEX:
+            point_edge_weights(
+                x0, x1, load_point(V, vertex_ids[2]), frame.w);
+            break;
+        case EDGE_EDGE:
+            edge_edge_weights(
+                x0, x1, load_point(V, vertex_ids[2]),
+                load_point(V, vertex_ids[3]), frame.w);
+            break;
+        default: // FACE_VERTEX
+            point_triangle_weights(
+                x0, x1, load_point(V, vertex_ids[2]),
+                load_point(V, vertex_ids[3]), frame.w);
+            break;
+        }
+        frame.diff = make_double3(0, 0, 0);
+        for (int k = 0; k < 4; k++) {
+            if (frame.w[k] != 0) {
+                const double3 xk = load_point(V, vertex_ids[k]);
+                frame.diff.x += frame.w[k] * xk.x;
+                frame.diff.y += frame.w[k] * xk.y;
+                frame.diff.z += frame.w[k] * xk.z;
+            }
+        }
+        frame.distance = dot(frame.diff, frame.diff);
+        return frame;
+    }
+
+    // ---------------------------------------------------------------------
+    // Edge-edge mollifier (matches edge_edge_mollifier.hpp)
+
+    /// @brief Mollifier value and its gradient wrt the four edge vertices.
+    /// The cross-norm gradient follows from c = |u x v|²:
+    /// ∇ᵤc = 2 v x (u x v) and ∇ᵥc = 2 (u x v) x u.
+    __device__ inline double edge_edge_mollifier_frame(
+        const double* V,
+        const int* vertex_ids,
+        const double eps_x,
+        double3 grad_m[4])
+    {
+        const double3 ea0 = load_point(V, vertex_ids[0]);
+        const double3 ea1 = load_point(V, vertex_ids[1]);
+        const double3 eb0 = load_point(V, vertex_ids[2]);
+        const double3 eb1 = load_point(V, vertex_ids[3]);
+        const double3 u = sub(ea1, ea0), v = sub(eb1, eb0);
+        const double3 w = cross(u, v);
+        const double c = dot(w, w);
+        for (int k = 0; k < 4; k++) {
+            grad_m[k] = make_double3(0, 0, 0);
+        }
+        if (c >= eps_x) {
+            return 1.0;
+        }
+        const double dm_dc = 2.0 / eps_x * (1.0 - c / eps_x);
+        const double3 dc_du = cross(v, w); // 1/2 ∇ᵤc
+        const double3 dc_dv = cross(w, u); // 1/2 ∇ᵥc
+        grad_m[0] = make_double3(
+            -2 * dm_dc * dc_du.x, -2 * dm_dc * dc_du.y,
+            -2 * dm_dc * dc_du.z);
+        grad_m[1] = make_double3(
+            2 * dm_dc * dc_du.x, 2 * dm_dc * dc_du.y, 2 * dm_dc * dc_du.z);
+        grad_m[2] = make_double3(
+            -2 * dm_dc * dc_dv.x, -2 * dm_dc * dc_dv.y,
+            -2 * dm_dc * dc_dv.z);
+        grad_m[3] = make_double3(
+            2 * dm_dc * dc_dv.x, 2 * dm_dc * dc_dv.y, 2 * dm_dc * dc_dv.z);
+        return (c / eps_x) * (2.0 - c / eps_x);
+    }
+
+    // ---------------------------------------------------------------------
+    // Kernels
+
+    __device__ inline void atomic_min_double(double* address, double value)
+    {
+        // Non-negative doubles compare like their bit patterns.
+        atomicMin(
+            reinterpret_cast<unsigned long long*>(address),
+            static_cast<unsigned long long>(__double_as_longlong(value)));
+    }
+
+    __global__ void potential_kernel(
+        const size_t num_constraints,
+        const double* V,
+        const int* vertex_ids,
+        const int* types,
+        const double* weights,
+        const double* eps_x,
+        const double* min_dists,
+        const double dhat,
+        double* scalars)
+    {
+        __shared__ double partial[BLOCK_SIZE];
+
+        const size_t ci = blockIdx.x * blockDim.x + threadIdx.x;
+        double potential = 0;
+        if (ci < num_constraints) {
+            const DistanceFrame frame =
+                compute_distance_frame(V, types[ci], vertex_ids + 4 * ci);
+            const double dmin = min_dists[ci];
+            double mollifier = 1;
+            if (types[ci] == EDGE_EDGE) {
+                double3 grad_m[4];
+                mollifier = edge_edge_mollifier_frame(
+                    V, vertex_ids + 4 * ci, eps_x[ci], grad_m);
+            }
+            potential = weights[ci] * mollifier
+                * barrier_d(
+                            frame.distance - dmin * dmin,
+                            2 * dmin * dhat + dhat * dhat);
+            atomic_min_double(&scalars[1], frame.distance);
+        }
+
+        partial[threadIdx.x] = potential;
+        __syncthreads();
+        for (int stride = BLOCK_SIZE / 2; stride > 0; stride /= 2) {
+            if (threadIdx.x < stride) {
+                partial[threadIdx.x] += partial[threadIdx.x + stride];
+            }
+            __syncthreads();
+        }
+        if (threadIdx.x == 0) {
+            atomicAdd(&scalars[0], partial[0]);
+        }
+    }
+
+    __global__ void gradient_kernel(
+        const size_t num_constraints,
+        const double* V,
+        const int* vertex_ids,
+        const int* types,
+        const double* weights,
+        const double* eps_x,
+        const double* min_dists,
+        const double dhat,
+        double* gradient)
+    {
+        const size_t ci = blockIdx.x * blockDim.x + threadIdx.x;
+        if (ci >= num_constraints) {
+            return;
+        }
+        const int* ids = vertex_ids + 4 * ci;
+        const DistanceFrame frame =
+            compute_distance_frame(V, types[ci], ids);
+        const double dmin = min_dists[ci];
+        const double s = frame.distance - dmin * dmin;
+        const double kappa = 2 * dmin * dhat + dhat * dhat;
+        const double b = barrier_d(s, kappa);
+        const double db = barrier_gradient_d(s, kappa);
+
+        double mollifier = 1;
+        double3 grad_m[4];
+        if (types[ci] == EDGE_EDGE) {
+            mollifier =
+                edge_edge_mollifier_frame(V, ids, eps_x[ci], grad_m);
+        }
+
+        for (int k = 0; k < 4; k++) {
+            if (ids[k] < 0) {
+                continue;
+            }
+            // ∇ₖ[m b(d²)] = m b' 2wₖ(p-q) + b ∇ₖm
+            double3 g = make_double3(
+                mollifier * db * 2 * frame.w[k] * frame.diff.x,
+                mollifier * db * 2 * frame.w[k] * frame.diff.y,
+                mollifier * db * 2 * frame.w[k] * frame.diff.z);
+            if (types[ci] == EDGE_EDGE) {
+                g.x += b * grad_m[k].x;
+                g.y += b * grad_m[k].y;
+                g.z += b * grad_m[k].z;
+            }
+            atomicAdd(&gradient[3 * ids[k] + 0], weights[ci] * g.x);
+            atomicAdd(&gradient[3 * ids[k] + 1], weights[ci] * g.y);
+            atomicAdd(&gradient[3 * ids[k] + 2], weights[ci] * g.z);
+        }
+    }
+
+    __global__ void hessian_kernel(
+        const size_t num_constraints,
+        const double* V,
+        const int* vertex_ids,
+        const int* types,
+        const double* weights,
+        const double* eps_x,
+        const double* min_dists,
+        const int* block_slots,
+        const double dhat,
+        double* values)
+    {
+        const size_t ci = blockIdx.x * blockDim.x + threadIdx.x;
+        if (ci >= num_constraints) {
+            return;
+        }
+        const int* ids = vertex_ids + 4 * ci;
+        const int* slots = block_slots + 16 * ci;
+        const DistanceFrame frame =
+            compute_distance_frame(V, types[ci], ids);
+        const double dmin = min_dists[ci];
+        const double s = frame.distance - dmin * dmin;
+        const double kappa = 2 * dmin * dhat + dhat * dhat;
+        const double b = barrier_d(s, kappa);
+        const double db = barrier_gradient_d(s, kappa);
+        const double ddb = barrier_hessian_d(s, kappa);
+
+        double mollifier = 1;
+        double3 grad_m[4];
+        if (types[ci] == EDGE_EDGE) {
+            mollifier =
+                edge_edge_mollifier_frame(V, ids, eps_x[ci], grad_m);
+        }
+
+        // Per-vertex pieces: ∇ₖd² = 2wₖ(p-q) and ∇ₖm.
+        for (int a = 0; a < 4; a++) {
+            if (ids[a] < 0) {
+                continue;
+            }
+            const double3 gd_a = make_double3(
+                2 * frame.w[a] * frame.diff.x, //
+                2 * frame.w[a] * frame.diff.y, //
+                2 * frame.w[a] * frame.diff.z);
+            for (int bk = 0; bk < 4; bk++) {
+                if (ids[bk] < 0) {
+                    continue;
+                }
+                const int slot = slots[4 * a + bk];
+                const double3 gd_b = make_double3(
+                    2 * frame.w[bk] * frame.diff.x,
+                    2 * frame.w[bk] * frame.diff.y,
+                    2 * frame.w[bk] * frame.diff.z);
+                // m(b'' ∇d²∇d²ᵀ + b' ∇²d²) with the closest-point weights
+                // frozen in ∇²d², plus the rank-one mollifier terms
+                // b'(∇m ∇d²ᵀ + ∇d² ∇mᵀ) + b m'' ∇c∇cᵀ-like coupling via
+                // ∇m (∇²c is dropped; see the class doc comment).
+                const double gd[3] = { gd_a.x, gd_a.y, gd_a.z };
+                const double hd[3] = { gd_b.x, gd_b.y, gd_b.z };
+                const double gm[3] = { grad_m[a].x, grad_m[a].y,
+                                       grad_m[a].z };
+                const double hm[3] = { grad_m[bk].x, grad_m[bk].y,
+                                       grad_m[bk].z };
+                double block[9];
+                for (int r = 0; r < 3; r++) {
+                    for (int c = 0; c < 3; c++) {
+                        double h = mollifier * ddb * gd[r] * hd[c];
+                        if (types[ci] == EDGE_EDGE) {
+                            h += db * (gm[r] * hd[c] + gd[r] * hm[c]);
+                        }
+                        if (r == c) { // b' ∇²d² = 2 b' wₐw_b I
+                            h += mollifier * db * 2 * frame.w[a]
+                                * frame.w[bk];
+                        }
+                        block[3 * r + c] = weights[ci] * h;
+                    }
+                }
+                for (int e = 0; e < 9; e++) {
+                    atomicAdd(&values[9 * slot + e], block[e]);
+                }
+            }
+        }
+    }
+
+} // namespace
+
+BarrierPotentialGPU::~BarrierPotentialGPU() { clear(); }
+
+void BarrierPotentialGPU::clear()
+{
+    cudaFree(d_vertex_ids);
+    cudaFree(d_types);
+    cudaFree(d_weights);
+    cudaFree(d_eps_x);
+    cudaFree(d_min_dists);
+    cudaFree(d_block_slots);
+    if (m_owns_positions) {
+        cudaFree(d_positions);
+    }
+    cudaFree(d_gradient);
+    cudaFree(d_hessian_values);
+    cudaFree(d_scalars);
+    d_vertex_ids = d_types = d_block_slots = nullptr;
+    d_weights = d_eps_x = d_min_dists = nullptr;
+    d_positions = d_gradient = d_hessian_values = d_scalars = nullptr;
+    m_owns_positions = false;
+    m_num_constraints = 0;
+    m_num_vertices = 0;
+    m_block_row_offsets.clear();
+    m_block_cols.clear();
+}
+
+void BarrierPotentialGPU::set_constraints(
+    const CollisionMesh& mesh,
+    const Constraints& constraint_set,
+    const double dhat)
+{
+    if (!constraint_set.pv_constraints.empty()) {
+        throw std::runtime_error(
+            "BarrierPotentialGPU does not support plane-vertex constraints!");
+    }
+    if (mesh.dim() != 3) {
+        throw std::runtime_error("BarrierPotentialGPU requires a 3D mesh!");
+    }
+
+    clear();
+
+    const Eigen::MatrixXi& E = mesh.edges();
+    const Eigen::MatrixXi& F = mesh.faces();
+
+    m_num_constraints = constraint_set.size();
+    m_num_vertices = mesh.num_vertices();
+    m_dhat = dhat;
+
+    // Flatten the constraint set in for_each order (vv, ev, ee, fv).
+    std::vector<int> vertex_ids(4 * m_num_constraints, -1);
+    std::vector<int> types(m_num_constraints);
+    std::vector<double> weights(m_num_constraints);
+    std::vector<double> mollifier_eps(m_num_constraints, 0);
+    std::vector<double> min_dists(m_num_constraints);
+
+    size_t ci = 0;
+    const auto flatten = [&](const auto& constraint, const int type) {
+        const std::array<index_t, 4> ids = constraint.vertex_indices(E, F);
+        for (int k = 0; k < 4; k++) {
+            vertex_ids[4 * ci + k] = int(ids[k]);
+        }
+        types[ci] = type;
+        weights[ci] = constraint.weight;
+        min_dists[ci] = constraint.minimum_distance;
+        ci++;
+    };
+    for (const auto& constraint : constraint_set.vv_constraints) {
+        flatten(constraint, VERTEX_VERTEX);
+    }
+    for (const auto& constraint : constraint_set.ev_constraints) {
+        flatten(constraint, EDGE_VERTEX);
+    }
+    for (const auto& constraint : constraint_set.ee_constraints) {
+        mollifier_eps[ci] = constraint.eps_x;
+        flatten(constraint, EDGE_EDGE);
+    }
+    for (const auto& constraint : constraint_set.fv_constraints) {
+        flatten(constraint, FACE_VERTEX);
+    }
+    assert(ci == m_num_constraints);
+
+    // Build the BSR pattern: one 3x3 block per vertex pair of any stencil.
+    std::vector<long> block_keys;
+    block_keys.reserve(16 * m_num_constraints);
+    for (size_t i = 0; i < m_num_constraints; i++) {
+        for (int a = 0; a < 4; a++) {
+            const int via = vertex_ids[4 * i + a];
+            if (via < 0) {
+                continue;
+            }
+            for (int b = 0; b < 4; b++) {
+                const int vib = vertex_ids[4 * i + b];
+                if (vib >= 0) {
+                    block_keys.push_back(long(via) * m_num_vertices + vib);
+                }
+            }
+        }
+    }
+    std::sort(block_keys.begin(), block_keys.end());
+    block_keys.erase(
+        std::unique(block_keys.begin(), block_keys.end()),
+        block_keys.end());
+
+    m_block_row_offsets.assign(m_num_vertices + 1, 0);
+    m_block_cols.resize(block_keys.size());
+    for (size_t k = 0; k < block_keys.size(); k++) {
+        m_block_row_offsets[block_keys[k] / m_num_vertices + 1]++;
+        m_block_cols[k] = int(block_keys[k] % m_num_vertices);
+    }
+    for (long vi = 0; vi < m_num_vertices; vi++) {
+        m_block_row_offsets[vi + 1] += m_block_row_offsets[vi];
+    }
+
+    // Per-constraint scatter slots into the block list.
+    std::vector<int> block_slots(16 * m_num_constraints, -1);
+    for (size_t i = 0; i < m_num_constraints; i++) {
+        for (int a = 0; a < 4; a++) {
+            const int via = vertex_ids[4 * i + a];
+            if (via < 0) {
+                continue;
+            }
+            for (int b = 0; b < 4; b++) {
+                const int vib = vertex_ids[4 * i + b];
+                if (vib < 0) {
+                    continue;
+                }
+                const long key = long(via) * m_num_vertices + vib;
+                block_slots[16 * i + 4 * a + b] = int(
+                    std::lower_bound(
+                        block_keys.begin(), block_keys.end(), key)
+                    - block_keys.begin());
+            }
+        }
+    }
+
+    d_vertex_ids = device_alloc<int>(vertex_ids.size());
+    d_types = device_alloc<int>(types.size());
+    d_weights = device_alloc<double>(weights.size());
+    d_eps_x = device_alloc<double>(mollifier_eps.size());
+    d_min_dists = device_alloc<double>(min_dists.size());
+    d_block_slots = device_alloc<int>(block_slots.size());
+    device_upload(d_vertex_ids, vertex_ids);
+    device_upload(d_types, types);
+    device_upload(d_weights, weights);
+    device_upload(d_eps_x, mollifier_eps);
+    device_upload(d_min_dists, min_dists);
+    device_upload(d_block_slots, block_slots);
+
+    d_positions = device_alloc<double>(3 * m_num_vertices);
+    m_owns_positions = true;
+    d_gradient = device_alloc<double>(3 * m_num_vertices);
+    d_hessian_values = device_alloc<double>(9 * m_block_cols.size());
+    d_scalars = device_alloc<double>(2);
+}
+
+void BarrierPotentialGPU::update_vertices(ConstMatrixXdRef V)
+{
+    assert(V.rows() == m_num_vertices && V.cols() == 3);
+    if (!m_owns_positions) {
+        d_positions = device_alloc<double>(3 * m_num_vertices);
+        m_owns_positions = true;
+    }
+    const Eigen::Matrix<double, Eigen::Dynamic, 3, Eigen::RowMajor> V_rm = V;
+    check_cuda(cudaMemcpy(
+        d_positions, V_rm.data(), 3 * m_num_vertices * sizeof(double),
+        cudaMemcpyHostToDevice));
+}
+
+void BarrierPotentialGPU::use_device_vertices(
+    const double* d_V, const long num_vertices)
+{
+    assert(num_vertices == m_num_vertices);
+    if (m_owns_positions) {
+        cudaFree(d_positions);
+        m_owns_positions = false;
+    }
+    d_positions = const_cast<double*>(d_V);
+}
+
+double BarrierPotentialGPU::compute_potential()
+{
+    double minimum_distance;
+    return compute_potential(minimum_distance);
+}
+
+double BarrierPotentialGPU::compute_potential(double& minimum_distance)
+{
+    minimum_distance = std::numeric_limits<double>::infinity();
+    if (m_num_constraints == 0) {
+        return 0;
+    }
+    const double init[2] = { 0.0,
+                             std::numeric_limits<double>::infinity() };
+    check_cuda(cudaMemcpy(
+        d_scalars, init, 2 * sizeof(double), cudaMemcpyHostToDevice));
+
+    potential_kernel<<<num_blocks(m_num_constraints), BLOCK_SIZE>>>(
+        m_num_constraints, d_positions, d_vertex_ids, d_types, d_weights,
+        d_eps_x, d_min_dists, m_dhat, d_scalars);
+    check_cuda(cudaGetLastError());
+
+    double result[2];
+    check_cuda(cudaMemcpy(
+        result, d_scalars, 2 * sizeof(double), cudaMemcpyDeviceToHost));
+    minimum_distance = result[1];
+    return result[0];
+}
+
+void BarrierPotentialGPU::compute_gradient()
+{
+    check_cuda(cudaMemset(
+        d_gradient, 0, 3 * m_num_vertices * sizeof(double)));
+    if (m_num_constraints == 0) {
+        return;
+    }
+    gradient_kernel<<<num_blocks(m_num_constraints), BLOCK_SIZE>>>(
+        m_num_constraints, d_positions, d_vertex_ids, d_types, d_weights,
+        d_eps_x, d_min_dists, m_dhat, d_gradient);
+    check_cuda(cudaGetLastError());
+}
+
+Eigen::VectorXd BarrierPotentialGPU::gradient() const
+{
+    Eigen::VectorXd grad(3 * m_num_vertices);
+    check_cuda(cudaMemcpy(
+        grad.data(), d_gradient, 3 * m_num_vertices * sizeof(double),
+        cudaMemcpyDeviceToHost));
+    return grad;
+}
+
+void BarrierPotentialGPU::compute_hessian()
+{
+    check_cuda(cudaMemset(
+        d_hessian_values, 0, 9 * m_block_cols.size() * sizeof(double)));
+    if (m_num_constraints == 0) {
+        return;
+    }
+    hessian_kernel<<<num_blocks(m_num_constraints), BLOCK_SIZE>>>(
+        m_num_constraints, d_positions, d_vertex_ids, d_types, d_weights,
+        d_eps_x, d_min_dists, d_block_slots, m_dhat, d_hessian_values);
+    check_cuda(cudaGetLastError());
+}
+
+Eigen::SparseMatrix<double> BarrierPotentialGPU::hessian() const
+{
+    std::vector<double> values(9 * m_block_cols.size());
+    check_cuda(cudaMemcpy(
+        values.data(), d_hessian_values, values.size() * sizeof(double),
+        cudaMemcpyDeviceToHost));
+
+    std::vector<Eigen::Triplet<double>> triplets;
+    triplets.reserve(values.size());
+    for (long vi = 0; vi < m_num_vertices; vi++) {
+        for (int k = m_block_row_offsets[vi];
+             k < m_block_row_offsets[vi + 1]; k++) {
+            const int vj = m_block_cols[k];
+            for (int r = 0; r < 3; r++) {
+                for (int c = 0; c < 3; c++) {
+                    triplets.emplace_back(
+                        3 * vi + r, 3 * vj + c, values[9 * k + 3 * r + c]);
+                }
+            }
+        }
+    }
+    Eigen::SparseMatrix<double> hess(
+        3 * m_num_vertices, 3 * m_num_vertices);
+    hess.setFromTriplets(triplets.begin(), triplets.end());
+    return hess;
+}
+
+} // namespace ipc
+
+#endif
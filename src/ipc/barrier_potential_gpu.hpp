@@ -0,0 +1,153 @@
+#pragma once
+
+#include <ipc/config.hpp>
+
+#ifdef IPC_TOOLKIT_WITH_CUDA
+
+#include <ipc/collision_mesh.hpp>
+#include <ipc/collisions/constraints.hpp>
+#include <ipc/utils/eigen_ext.hpp>
+
+#include <Eigen/Sparse>
+
+#include <vector>
+
+namespace ipc {
+
+/// @brief Device-resident barrier potential, gradient, and hessian.
+///
+/// With constraint counts in the millions, the CPU assembly loops in
+/// compute_barrier_potential_* become the per-iteration ceiling, and solvers
+/// that already keep the positions on the GPU for the linear solve pay a
+/// host round trip per evaluation. This class uploads the constraint set
+/// once (set_constraints()), takes the positions per iteration
+/// (update_vertices()), and evaluates the three entry points on the device:
+/// the potential as a reduced scalar, the gradient into a device vector,
+/// and the hessian into device block-sparse-row (BSR) 3x3 blocks whose
+/// sparsity is precomputed on the host when the constraint set changes, so
+/// the results can feed a device linear solver without a per-iteration
+/// host round trip.
+///
+/// The potential and gradient match the CPU entry points: the distances are
+/// classified and evaluated in closed form, and the distance gradients
+/// follow from the closest-point weights (exact by the envelope theorem).
+/// The hessian blocks keep the barrier curvature term b''∇d²∇d²ᵀ and the
+/// rank-one mollifier terms exactly but freeze the closest-point weights in
+/// ∇²d² (and drop ∇²c of the mollifier cross norm), i.e. they are the
+/// symmetric lumped approximation; the omitted closest-point-motion terms
+/// are indefinite and are routinely discarded by the PSD projection the
+/// solvers apply anyway. Callers needing the exact hessian should use the
+/// CPU compute_barrier_potential_hessian().
+///
+/// @note 3D meshes only; plane-vertex constraints are not supported.
+class BarrierPotentialGPU {
+public:
+    BarrierPotentialGPU() { }
+    ~BarrierPotentialGPU();
+
+    // Owns device memory.
+    BarrierPotentialGPU(const BarrierPotentialGPU&) = delete;
+    BarrierPotentialGPU& operator=(const BarrierPotentialGPU&) = delete;
+
+    /// @brief Upload the constraint set and build the hessian sparsity.
+    ///
+    /// Call when the constraint set changes (typically once per time step);
+    /// the indices, weights, mollifier thresholds, and the BSR pattern stay
+    /// resident across the iterations of the solve.
+    /// @param mesh The collision mesh.
+    /// @param constraint_set The constraint set to upload.
+    /// @param dhat The activation distance of the barrier.
+    void set_constraints(
+        const CollisionMesh& mesh,
+        const Constraints& constraint_set,
+        const double dhat);
+
+    /// @brief Upload new vertex positions (call once per iteration).
+    /// @param V Vertices of the collision mesh.
+    void update_vertices(ConstMatrixXdRef V);
+
+    /// @brief Positions already resident on the device (row-major |V|x3).
+    ///
+    /// Alternative to update_vertices() for solvers that keep the positions
+    /// on the GPU: the buffer is used in place and must stay valid until the
+    /// next update_vertices()/use_device_vertices() call.
+    void use_device_vertices(const double* d_V, const long num_vertices);
+
+    /// @brief Compute the barrier potential on the device.
+    /// @param[out] minimum_distance The minimum (squared) distance.
+    /// @return The sum of the potential over all constraints.
+    double compute_potential(double& minimum_distance);
+
+    /// @brief Compute the barrier potential on the device.
+    double compute_potential();
+
+    /// @brief Compute the gradient into the device buffer.
+    /// @see device_gradient(), gradient()
+    void compute_gradient();
+
+    /// @brief Device gradient of the last compute_gradient() (size 3|V|).
+    const double* device_gradient() const { return d_gradient; }
+
+    /// @brief Download the gradient of the last compute_gradient().
+    Eigen::VectorXd gradient() const;
+
+    /// @brief Compute the hessian blocks into the device buffer.
+    /// @see device_hessian_values(), hessian()
+    void compute_hessian();
+
+    /// @brief BSR row offsets of the hessian (size num_vertices + 1).
+    const std::vector<int>& hessian_block_row_offsets() const
+    {
+        return m_block_row_offsets;
+    }
+
+    /// @brief BSR block column indices of the hessian.
+    const std::vector<int>& hessian_block_cols() const
+    {
+        return m_block_cols;
+    }
+
+    /// @brief Device hessian of the last compute_hessian() (one row-major
+    /// 3x3 block of 9 doubles per entry of hessian_block_cols()).
+    const double* device_hessian_values() const { return d_hessian_values; }
+
+    /// @brief Download the hessian of the last compute_hessian().
+    Eigen::SparseMatrix<double> hessian() const;
+
+    /// @brief Number of uploaded constraints.
+    size_t num_constraints() const { return m_num_constraints; }
+
+    /// @brief Number of 3x3 blocks in the hessian pattern.
+    size_t num_hessian_blocks() const { return m_block_cols.size(); }
+
+    /// @brief Free all device memory.
+    void clear();
+
+protected:
+    size_t m_num_constraints = 0;
+    long m_num_vertices = 0;
+    double m_dhat = 0;
+
+    // Host copy of the BSR pattern (also uploaded for the scatter slots).
+    std::vector<int> m_block_row_offsets;
+    std::vector<int> m_block_cols;
+
+    // Device-resident constraint set (see set_constraints()).
+    int* d_vertex_ids = nullptr; ///< @brief 4 vertex ids per constraint.
+    int* d_types = nullptr; ///< @brief Constraint type per constraint.
+    double* d_weights = nullptr;
+    double* d_eps_x = nullptr; ///< @brief Mollifier thresholds (EE only).
+    double* d_min_dists = nullptr; ///< @brief Minimum distance (dmin).
+    int* d_block_slots = nullptr; ///< @brief 16 hessian slots per constraint.
+
+    // Positions and outputs.
+    double* d_positions = nullptr; ///< @brief Row-major |V|x3 positions.
+    bool m_owns_positions = false; ///< @brief False after use_device_vertices.
+    double* d_gradient = nullptr; ///< @brief Gradient (size 3|V|).
+    double* d_hessian_values = nullptr; ///< @brief 9 doubles per block.
+    double* d_scalars = nullptr; ///< @brief {potential, min distance bits}.
+};
+
+} // namespace ipc
+
+#endif
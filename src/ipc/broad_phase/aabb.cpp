@@ -3,6 +3,13 @@
 #include <tbb/parallel_for.h>
 #include <tbb/blocked_range.h>
 
+#include <cmath> // std::nextafterf
+#include <limits>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
 namespace ipc {
 
 AABB::AABB(const ArrayMax3d& min, const ArrayMax3d& max)
@@ -34,8 +41,147 @@ bool AABB::intersects(const AABB& other) const
     return (this->min <= other.max).all() && (other.min <= this->max).all();
 };
 
+namespace {
+
+    /// @brief Largest float not greater than x.
+    inline float round_down(const double x)
+    {
+        const float f = float(x);
+        return double(f) <= x
+            ? f
+            : std::nextafterf(f, -std::numeric_limits<float>::infinity());
+    }
+
+    /// @brief Smallest float not less than x.
+    inline float round_up(const double x)
+    {
+        const float f = float(x);
+        return double(f) >= x
+            ? f
+            : std::nextafterf(f, std::numeric_limits<float>::infinity());
+    }
+
+} // namespace
+
+FloatAABB::FloatAABB(const AABB& box)
+    : min_x(round_down(box.min.x()))
+    , min_y(round_down(box.min.y()))
+    , min_z(box.min.size() >= 3 ? round_down(box.min.z()) : 0)
+    , max_x(round_up(box.max.x()))
+    , max_y(round_up(box.max.y()))
+    , max_z(box.max.size() >= 3 ? round_up(box.max.z()) : 0)
+{
+}
+
+void AABBSoA::build(const std::vector<AABB>& boxes)
+{
+    m_dim = (boxes.empty() || boxes[0].min.size() == 3) ? 3 : 2;
+
+    min_x.resize(boxes.size());
+    min_y.resize(boxes.size());
+    max_x.resize(boxes.size());
+    max_y.resize(boxes.size());
+    // 2D boxes have no z lane to store or test.
+    min_z.resize(m_dim == 3 ? boxes.size() : 0);
+    max_z.resize(m_dim == 3 ? boxes.size() : 0);
+
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(0, boxes.size()),
+        [&](const tbb::blocked_range<size_t>& r) {
+            for (size_t i = r.begin(); i < r.end(); i++) {
+                const FloatAABB box(boxes[i]);
+                min_x[i] = box.min_x;
+                min_y[i] = box.min_y;
+                max_x[i] = box.max_x;
+                max_y[i] = box.max_y;
+                if (m_dim == 3) {
+                    min_z[i] = box.min_z;
+                    max_z[i] = box.max_z;
+                }
+            }
+        });
+}
+
+void AABBSoA::batch_intersects(
+    const AABB& box,
+    const size_t begin,
+    const size_t end,
+    unsigned char* overlaps) const
+{
+    assert(begin <= end && end <= size());
+
+    // The query bounds are rounded outward like the stored boxes, so the
+    // float comparison never misses a double overlap.
+    const FloatAABB query(box);
+
+    size_t j = begin;
+
+#ifdef __AVX2__
+    const __m256 v_q_min_x = _mm256_set1_ps(query.min_x);
+    const __m256 v_q_max_x = _mm256_set1_ps(query.max_x);
+    const __m256 v_q_min_y = _mm256_set1_ps(query.min_y);
+    const __m256 v_q_max_y = _mm256_set1_ps(query.max_y);
+    if (m_dim == 3) {
+        const __m256 v_q_min_z = _mm256_set1_ps(query.min_z);
+        const __m256 v_q_max_z = _mm256_set1_ps(query.max_z);
+
+        for (; j + 8 <= end; j += 8) {
+            const __m256 overlap_x = _mm256_and_ps(
+                _mm256_cmp_ps(
+                    v_q_min_x, _mm256_loadu_ps(&max_x[j]), _CMP_LE_OQ),
+                _mm256_cmp_ps(
+                    _mm256_loadu_ps(&min_x[j]), v_q_max_x, _CMP_LE_OQ));
+            const __m256 overlap_y = _mm256_and_ps(
+                _mm256_cmp_ps(
+                    v_q_min_y, _mm256_loadu_ps(&max_y[j]), _CMP_LE_OQ),
+                _mm256_cmp_ps(
+                    _mm256_loadu_ps(&min_y[j]), v_q_max_y, _CMP_LE_OQ));
+            const __m256 overlap_z = _mm256_and_ps(
+                _mm256_cmp_ps(
+                    v_q_min_z, _mm256_loadu_ps(&max_z[j]), _CMP_LE_OQ),
+                _mm256_cmp_ps(
+                    _mm256_loadu_ps(&min_z[j]), v_q_max_z, _CMP_LE_OQ));
+
+            const int mask = _mm256_movemask_ps(
+                _mm256_and_ps(_mm256_and_ps(overlap_x, overlap_y), overlap_z));
+            for (int k = 0; k < 8; k++) {
+                overlaps[j - begin + k] = (mask >> k) & 1;
+            }
+        }
+    } else {
+        // 2D: no z lane stored, a third less compare work per box.
+        for (; j + 8 <= end; j += 8) {
+            const __m256 overlap_x = _mm256_and_ps(
+                _mm256_cmp_ps(
+                    v_q_min_x, _mm256_loadu_ps(&max_x[j]), _CMP_LE_OQ),
+                _mm256_cmp_ps(
+                    _mm256_loadu_ps(&min_x[j]), v_q_max_x, _CMP_LE_OQ));
+            const __m256 overlap_y = _mm256_and_ps(
+                _mm256_cmp_ps(
+                    v_q_min_y, _mm256_loadu_ps(&max_y[j]), _CMP_LE_OQ),
+                _mm256_cmp_ps(
+                    _mm256_loadu_ps(&min_y[j]), v_q_max_y, _CMP_LE_OQ));
+
+            const int mask =
+                _mm256_movemask_ps(_mm256_and_ps(overlap_x, overlap_y));
+            for (int k = 0; k < 8; k++) {
+                overlaps[j - begin + k] = (mask >> k) & 1;
+            }
+        }
+    }
+#endif
+
+    for (; j < end; j++) {
+        overlaps[j - begin] = query.min_x <= max_x[j]
+            && min_x[j] <= query.max_x && query.min_y <= max_y[j]
+            && min_y[j] <= query.max_y
+            && (m_dim == 2
+                || (query.min_z <= max_z[j] && min_z[j] <= query.max_z));
+    }
+}
+
 void build_vertex_boxes(
-    const Eigen::MatrixXd& V,
+    ConstMatrixXdRef V,
     std::vector<AABB>& vertex_boxes,
     double inflation_radius)
 {
@@ -52,8 +198,8 @@ void build_vertex_boxes(
 }
 
 void build_vertex_boxes(
-    const Eigen::MatrixXd& V0,
-    const Eigen::MatrixXd& V1,
+    ConstMatrixXdRef V0,
+    ConstMatrixXdRef V1,
     std::vector<AABB>& vertex_boxes,
     double inflation_radius)
 {
@@ -70,6 +216,45 @@ void build_vertex_boxes(
         });
 }
 
+void build_vertex_boxes(
+    ConstMatrixXdRef V,
+    std::vector<AABB>& vertex_boxes,
+    const Eigen::VectorXd& inflation_radii)
+{
+    assert(inflation_radii.size() == V.rows());
+    vertex_boxes.resize(V.rows());
+
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(0, V.rows()),
+        [&](const tbb::blocked_range<size_t>& r) {
+            for (size_t i = r.begin(); i < r.end(); i++) {
+                vertex_boxes[i] =
+                    AABB::from_point(V.row(i), inflation_radii[i]);
+                vertex_boxes[i].vertex_ids = { { long(i), -1, -1 } };
+            }
+        });
+}
+
+void build_vertex_boxes(
+    ConstMatrixXdRef V0,
+    ConstMatrixXdRef V1,
+    std::vector<AABB>& vertex_boxes,
+    const Eigen::VectorXd& inflation_radii)
+{
+    assert(inflation_radii.size() == V0.rows());
+    vertex_boxes.resize(V0.rows());
+
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(0, V0.rows()),
+        [&](const tbb::blocked_range<size_t>& r) {
+            for (size_t i = r.begin(); i < r.end(); i++) {
+                vertex_boxes[i] = AABB::from_point(
+                    V0.row(i), V1.row(i), inflation_radii[i]);
+                vertex_boxes[i].vertex_ids = { { long(i), -1, -1 } };
+            }
+        });
+}
+
 void build_edge_boxes(
     const std::vector<AABB>& vertex_boxes,
     const Eigen::MatrixXi& E,
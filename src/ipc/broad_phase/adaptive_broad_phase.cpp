@@ -0,0 +1,226 @@
+#include "adaptive_broad_phase.hpp"
+
+#include <ipc/utils/logger.hpp>
+
+#include <cassert>
+#include <chrono>
+
+namespace ipc {
+
+namespace {
+    double seconds_since(const std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double>(
+                   std::chrono::steady_clock::now() - start)
+            .count();
+    }
+} // namespace
+
+AdaptiveBroadPhase::AdaptiveBroadPhase(
+    std::vector<BroadPhaseMethod> candidate_methods)
+    : m_candidate_methods(std::move(candidate_methods))
+{
+    assert(!m_candidate_methods.empty());
+}
+
+void AdaptiveBroadPhase::select_method()
+{
+    const int n = int(m_candidate_methods.size());
+
+    const auto start_round = [&]() {
+        m_round_index = 0;
+        m_measured_times.assign(n, 0.0);
+    };
+
+    if (m_round_index >= 0) {
+        // The previous build and its detections charged
+        // m_measured_times[m_round_index]; move to the next candidate or
+        // close the round.
+        if (++m_round_index >= n) {
+            int best = 0;
+            for (int i = 1; i < n; i++) {
+                if (m_measured_times[i] < m_measured_times[best]) {
+                    best = i;
+                }
+            }
+            // Hysteresis: keep the incumbent unless the challenger is
+            // decisively faster, so timing noise cannot thrash the
+            // selection.
+            if (m_selected < 0 || best == m_selected
+                || m_measured_times[best]
+                    < hysteresis * m_measured_times[m_selected]) {
+                if (m_selected >= 0 && best != m_selected) {
+                    logger().debug(
+                        "adaptive broad phase: switching method {} -> {} "
+                        "({:g} s vs {:g} s per build)",
+                        int(m_candidate_methods[m_selected]),
+                        int(m_candidate_methods[best]),
+                        m_measured_times[m_selected], m_measured_times[best]);
+                }
+                m_selected = best;
+            }
+            m_round_index = -1;
+            m_builds_since_selection = 0;
+            m_selected_num_candidates = m_num_detected;
+        }
+    } else if (m_selected < 0) {
+        // First build: measure every candidate before settling.
+        start_round();
+    } else {
+        m_builds_since_selection++;
+        // Re-evaluate on a fixed cadence, or early when the candidate count
+        // has drifted far from the one the selection was made at (the scene
+        // density changed, so the measurements are stale).
+        const bool drifted = candidate_drift_factor > 1
+            && m_selected_num_candidates > 0
+            && (double(m_num_detected)
+                    > candidate_drift_factor
+                        * double(m_selected_num_candidates)
+                || double(m_num_detected) * candidate_drift_factor
+                    < double(m_selected_num_candidates));
+        if (m_builds_since_selection >= reevaluation_period || drifted) {
+            start_round();
+        }
+    }
+
+    const BroadPhaseMethod method =
+        m_candidate_methods[m_round_index >= 0 ? m_round_index : m_selected];
+    if (m_inner == nullptr || method != m_inner_method) {
+        m_inner = make_broad_phase(method, m_use_morton_ordering);
+        m_inner_method = method;
+        if (!m_active_zones.empty()) {
+            m_inner->set_active_zones(
+                m_active_zones, m_active_zone_fallback_period);
+        }
+    }
+}
+
+void AdaptiveBroadPhase::configure_inner()
+{
+    m_inner->can_vertices_collide = can_vertices_collide;
+    m_inner->edge_length_median_hint = edge_length_median_hint;
+    m_inner->vertex_inflation_radii = vertex_inflation_radii;
+    if (m_vertex_group_ids.size() > 0) {
+        m_inner->set_vertex_group_ids(m_vertex_group_ids, m_can_groups_collide);
+    } else {
+        m_inner->clear_vertex_group_ids();
+    }
+    m_inner->enable_stats(m_enable_stats);
+}
+
+void AdaptiveBroadPhase::build(
+    ConstMatrixXdRef V,
+    const Eigen::MatrixXi& E,
+    const Eigen::MatrixXi& F,
+    double inflation_radius)
+{
+    select_method();
+    configure_inner();
+    m_num_detected = 0;
+
+    const auto start = std::chrono::steady_clock::now();
+    m_inner->build(V, E, F, inflation_radius);
+    charge_time(seconds_since(start));
+}
+
+void AdaptiveBroadPhase::build(
+    ConstMatrixXdRef V0,
+    ConstMatrixXdRef V1,
+    const Eigen::MatrixXi& E,
+    const Eigen::MatrixXi& F,
+    double inflation_radius)
+{
+    select_method();
+    configure_inner();
+    m_num_detected = 0;
+
+    const auto start = std::chrono::steady_clock::now();
+    m_inner->build(V0, V1, E, F, inflation_radius);
+    charge_time(seconds_since(start));
+}
+
+void AdaptiveBroadPhase::update(ConstMatrixXdRef V)
+{
+    assert(m_inner != nullptr);
+    const auto start = std::chrono::steady_clock::now();
+    m_inner->update(V);
+    charge_time(seconds_since(start));
+}
+
+void AdaptiveBroadPhase::clear()
+{
+    BroadPhase::clear();
+    if (m_inner != nullptr) {
+        m_inner->clear();
+    }
+    // The selection state is kept: the measurements describe the scene, not
+    // the built data, so a warm wrapper keeps its method across steps.
+}
+
+size_t AdaptiveBroadPhase::bytes_used() const
+{
+    return record_bytes_used(m_inner == nullptr ? 0 : m_inner->bytes_used());
+}
+
+void AdaptiveBroadPhase::detect_edge_vertex_candidates(
+    std::vector<EdgeVertexCandidate>& candidates) const
+{
+    assert(m_inner != nullptr);
+    const auto start = std::chrono::steady_clock::now();
+    m_inner->detect_edge_vertex_candidates(candidates);
+    charge_time(seconds_since(start));
+    m_num_detected += candidates.size();
+}
+
+void AdaptiveBroadPhase::detect_edge_edge_candidates(
+    std::vector<EdgeEdgeCandidate>& candidates) const
+{
+    assert(m_inner != nullptr);
+    const auto start = std::chrono::steady_clock::now();
+    m_inner->detect_edge_edge_candidates(candidates);
+    charge_time(seconds_since(start));
+    m_num_detected += candidates.size();
+}
+
+void AdaptiveBroadPhase::detect_face_vertex_candidates(
+    std::vector<FaceVertexCandidate>& candidates) const
+{
+    assert(m_inner != nullptr);
+    const auto start = std::chrono::steady_clock::now();
+    m_inner->detect_face_vertex_candidates(candidates);
+    charge_time(seconds_since(start));
+    m_num_detected += candidates.size();
+}
+
+void AdaptiveBroadPhase::detect_edge_face_candidates(
+    std::vector<EdgeFaceCandidate>& candidates) const
+{
+    assert(m_inner != nullptr);
+    const auto start = std::chrono::steady_clock::now();
+    m_inner->detect_edge_face_candidates(candidates);
+    charge_time(seconds_since(start));
+    m_num_detected += candidates.size();
+}
+
+void AdaptiveBroadPhase::query_boxes(
+    const std::vector<AABB>& boxes, BoxQueryResult& result) const
+{
+    assert(m_inner != nullptr);
+    m_inner->query_boxes(boxes, result);
+}
+
+void AdaptiveBroadPhase::collect_stats(BroadPhaseStats& stats) const
+{
+    if (m_inner != nullptr) {
+        stats = m_inner->stats();
+    }
+}
+
+void AdaptiveBroadPhase::charge_time(const double seconds) const
+{
+    if (m_round_index >= 0) {
+        m_measured_times[m_round_index] += seconds;
+    }
+}
+
+} // namespace ipc
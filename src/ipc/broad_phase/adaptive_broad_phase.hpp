@@ -0,0 +1,148 @@
+#pragma once
+
+#include <ipc/broad_phase/broad_phase.hpp>
+#include <ipc/utils/eigen_ext.hpp>
+
+#include <memory>
+#include <vector>
+
+namespace ipc {
+
+/// @brief Broad phase that picks its method from measured timings.
+///
+/// No single method is fastest for every scene: the relative cost of the
+/// hash grid, spatial hash, and sweep structures flips as a scene evolves
+/// from sparse free flight to dense piling. This wrapper delegates every
+/// call to an inner structure whose method it selects at build time. A
+/// measurement round builds with each candidate method in turn, charging
+/// each one its build plus detection wall time; the round's fastest method
+/// then serves the next reevaluation_period builds before another round
+/// runs. The incumbent is only replaced when a challenger beats it by the
+/// hysteresis margin, so timing noise cannot thrash the selection. A round
+/// is also started early when the candidate count drifts far from the one
+/// the selection was made at, since that signals the scene density changed.
+///
+/// All candidate methods emit the same candidate sets, so the selection is
+/// invisible to the caller. Selection happens in build(); callers that only
+/// ever update() keep the method of their last build.
+class AdaptiveBroadPhase : public BroadPhase {
+public:
+    /// @brief Construct the adaptive broad phase.
+    /// @param candidate_methods The methods to choose between.
+    AdaptiveBroadPhase(
+        std::vector<BroadPhaseMethod> candidate_methods = {
+            BroadPhaseMethod::HASH_GRID,
+            BroadPhaseMethod::SPATIAL_HASH,
+            BroadPhaseMethod::BVH,
+            BroadPhaseMethod::SWEEP_AND_TINIEST_QUEUE,
+        });
+
+    void build(
+        ConstMatrixXdRef V,
+        const Eigen::MatrixXi& E,
+        const Eigen::MatrixXi& F,
+        double inflation_radius = 0) override;
+
+    void build(
+        ConstMatrixXdRef V0,
+        ConstMatrixXdRef V1,
+        const Eigen::MatrixXi& E,
+        const Eigen::MatrixXi& F,
+        double inflation_radius = 0) override;
+
+    void update(ConstMatrixXdRef V) override;
+
+    void set_morton_ordering(const bool use_morton_ordering) override
+    {
+        BroadPhase::set_morton_ordering(use_morton_ordering);
+        if (m_inner != nullptr) {
+            m_inner->set_morton_ordering(use_morton_ordering);
+        }
+    }
+
+    void set_active_zones(
+        const std::vector<AABB>& zones, const int fallback_period = 8) override
+    {
+        BroadPhase::set_active_zones(zones, fallback_period);
+        if (m_inner != nullptr) {
+            m_inner->set_active_zones(zones, fallback_period);
+        }
+    }
+
+    void clear() override;
+
+    size_t bytes_used() const override;
+
+    void detect_edge_vertex_candidates(
+        std::vector<EdgeVertexCandidate>& candidates) const override;
+
+    void detect_edge_edge_candidates(
+        std::vector<EdgeEdgeCandidate>& candidates) const override;
+
+    void detect_face_vertex_candidates(
+        std::vector<FaceVertexCandidate>& candidates) const override;
+
+    void detect_edge_face_candidates(
+        std::vector<EdgeFaceCandidate>& candidates) const override;
+
+    void query_boxes(
+        const std::vector<AABB>& boxes, BoxQueryResult& result) const override;
+
+    /// @brief The method the inner structure currently uses.
+    BroadPhaseMethod current_method() const { return m_inner_method; }
+
+    /// @brief Builds served by a selection before it is re-evaluated.
+    int reevaluation_period = 256;
+
+    /// @brief Relative time a challenger must beat the incumbent by.
+    ///
+    /// After a measurement round the incumbent is replaced only if the
+    /// round's fastest other method took less than hysteresis times the
+    /// incumbent's time (0.8 means at least 20% faster).
+    double hysteresis = 0.8;
+
+    /// @brief Candidate-count drift that triggers an early re-evaluation.
+    ///
+    /// A new measurement round starts when the detected candidate count
+    /// grows or shrinks by more than this factor relative to the count at
+    /// the last selection.
+    double candidate_drift_factor = 2.0;
+
+protected:
+    /// @brief Advance the selection state and (re)create the inner
+    /// structure for this build.
+    void select_method();
+
+    /// @brief Copy the caller-set knobs onto the inner structure.
+    void configure_inner();
+
+    /// @brief Forward the inner structure's statistics.
+    void collect_stats(BroadPhaseStats& stats) const override;
+
+    /// @brief Charge elapsed seconds to the sample being measured.
+    void charge_time(const double seconds) const;
+
+    /// @brief The inner structure and the method it was built with.
+    std::unique_ptr<BroadPhase> m_inner;
+    BroadPhaseMethod m_inner_method = BroadPhaseMethod::NUM_METHODS;
+
+    /// @brief The methods to choose between.
+    std::vector<BroadPhaseMethod> m_candidate_methods;
+
+    // Selection state: during a measurement round m_round_index walks the
+    // candidate methods (one build each); -1 means no round is running.
+    int m_round_index = -1;
+    int m_selected = -1; ///< @brief Index of the selected method.
+    int m_builds_since_selection = 0;
+
+    /// @brief Build plus detection seconds per candidate, filled one entry
+    /// per build during a measurement round.
+    mutable std::vector<double> m_measured_times;
+
+    /// @brief Candidates emitted since the current build (drift signal).
+    mutable size_t m_num_detected = 0;
+    /// @brief Candidate count at the time of the last selection.
+    size_t m_selected_num_candidates = 0;
+};
+
+} // namespace ipc
@@ -1,41 +1,226 @@
 #include "broad_phase.hpp"
 
+#include <ipc/broad_phase/adaptive_broad_phase.hpp>
 #include <ipc/broad_phase/brute_force.hpp>
 #include <ipc/broad_phase/spatial_hash.hpp>
 #include <ipc/broad_phase/hash_grid.hpp>
+#include <ipc/broad_phase/bvh.hpp>
 #include <ipc/broad_phase/sweep_and_tiniest_queue.hpp>
+#include <ipc/broad_phase/two_level_spatial_hash.hpp>
+#ifdef IPC_TOOLKIT_WITH_CUDA
+#include <ipc/broad_phase/hash_grid_gpu.hpp>
+#endif
 
 #include <ipc/config.hpp>
+#include <ipc/utils/logger.hpp>
+#include <ipc/utils/memory_usage.hpp>
+#include <ipc/utils/execution_context.hpp>
+#include <ipc/utils/morton.hpp>
+#include <ipc/utils/profiler.hpp>
+#include <ipc/utils/small_vector.hpp>
+
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_sort.h>
+
+#include <algorithm> // std::sort, std::copy
 
 namespace ipc {
 
+namespace {
+
+    /// Sort boxes along the Morton curve of their centers and return the
+    /// permutation mapping sorted position to original index.
+    std::vector<long> morton_sort(
+        std::vector<AABB>& boxes,
+        const ArrayMax3d& scene_min,
+        const ArrayMax3d& scene_size)
+    {
+        std::vector<std::pair<uint32_t, long>> codes(boxes.size());
+        tbb::parallel_for(
+            tbb::blocked_range<size_t>(size_t(0), boxes.size()),
+            [&](const tbb::blocked_range<size_t>& r) {
+                for (size_t i = r.begin(); i < r.end(); i++) {
+                    const ArrayMax3d center =
+                        0.5 * (boxes[i].min + boxes[i].max);
+                    codes[i] = std::make_pair(
+                        morton_code((center - scene_min) / scene_size),
+                        long(i));
+                }
+            });
+        tbb::parallel_sort(codes.begin(), codes.end());
+
+        std::vector<long> order(boxes.size());
+        std::vector<AABB> sorted_boxes;
+        sorted_boxes.reserve(boxes.size());
+        for (size_t i = 0; i < codes.size(); i++) {
+            order[i] = codes[i].second;
+            sorted_boxes.push_back(boxes[order[i]]);
+        }
+        boxes = std::move(sorted_boxes);
+
+        return order;
+    }
+
+} // namespace
+
+void BroadPhaseStats::log() const
+{
+    logger().debug(
+        "broad phase: build {:g} s ({} vertex, {} edge, {} face boxes); "
+        "detect {:g} s ({} candidates, {} pairs filtered)",
+        build_time, num_boxes[0], num_boxes[1], num_boxes[2], detect_time,
+        num_candidates, num_filtered);
+    if (!boxes_per_cell_histogram.empty()) {
+        logger().debug(
+            "broad phase: boxes per occupied cell (log2 buckets): [{}]",
+            fmt::join(boxes_per_cell_histogram, ", "));
+    }
+}
+
 void BroadPhase::build(
-    const Eigen::MatrixXd& V,
+    ConstMatrixXdRef V,
     const Eigen::MatrixXi& E,
     const Eigen::MatrixXi& F,
     double inflation_radius)
 {
+    IPC_PROFILE_SCOPE("BroadPhase::build");
+
     assert(E.size() == 0 || E.cols() == 2);
     assert(F.size() == 0 || F.cols() == 3);
+    if (m_enable_stats) {
+        m_stats = BroadPhaseStats();
+        m_num_filtered = 0;
+    }
+    StatsTimer timer(m_enable_stats, m_stats.build_time);
     clear();
-    build_vertex_boxes(V, vertex_boxes, inflation_radius);
+    m_edges = E;
+    m_faces = F;
+    m_inflation_radius = inflation_radius;
+    if (vertex_inflation_radii.size() > 0) {
+        assert(vertex_inflation_radii.size() == V.rows());
+        build_vertex_boxes(V, vertex_boxes, vertex_inflation_radii);
+    } else {
+        build_vertex_boxes(V, vertex_boxes, inflation_radius);
+    }
     build_edge_boxes(vertex_boxes, E, edge_boxes);
     build_face_boxes(vertex_boxes, F, face_boxes);
+    if (use_active_zone_build()) {
+        filter_boxes_to_active_zones();
+    }
+    if (m_use_morton_ordering) {
+        morton_sort_boxes();
+    }
+    if (m_enable_stats) {
+        m_stats.num_boxes = { { vertex_boxes.size(), edge_boxes.size(),
+                                face_boxes.size() } };
+    }
 }
 
 void BroadPhase::build(
-    const Eigen::MatrixXd& V0,
-    const Eigen::MatrixXd& V1,
+    ConstMatrixXdRef V0,
+    ConstMatrixXdRef V1,
     const Eigen::MatrixXi& E,
     const Eigen::MatrixXi& F,
     double inflation_radius)
 {
+    IPC_PROFILE_SCOPE("BroadPhase::build");
+
     assert(E.size() == 0 || E.cols() == 2);
     assert(F.size() == 0 || F.cols() == 3);
+    if (m_enable_stats) {
+        m_stats = BroadPhaseStats();
+        m_num_filtered = 0;
+    }
+    StatsTimer timer(m_enable_stats, m_stats.build_time);
     clear();
-    build_vertex_boxes(V0, V1, vertex_boxes, inflation_radius);
+    m_edges = E;
+    m_faces = F;
+    m_inflation_radius = inflation_radius;
+    if (vertex_inflation_radii.size() > 0) {
+        assert(vertex_inflation_radii.size() == V0.rows());
+        build_vertex_boxes(V0, V1, vertex_boxes, vertex_inflation_radii);
+    } else {
+        build_vertex_boxes(V0, V1, vertex_boxes, inflation_radius);
+    }
     build_edge_boxes(vertex_boxes, E, edge_boxes);
     build_face_boxes(vertex_boxes, F, face_boxes);
+    if (use_active_zone_build()) {
+        filter_boxes_to_active_zones();
+    }
+    if (m_use_morton_ordering) {
+        morton_sort_boxes();
+    }
+    if (m_enable_stats) {
+        m_stats.num_boxes = { { vertex_boxes.size(), edge_boxes.size(),
+                                face_boxes.size() } };
+    }
+}
+
+std::future<void> BroadPhase::begin_build(
+    ConstMatrixXdRef V,
+    const Eigen::MatrixXi& E,
+    const Eigen::MatrixXi& F,
+    const double inflation_radius)
+{
+    // Copy the inputs so the caller may overwrite its matrices while the
+    // build runs. The worker thread is outside any arena the caller runs
+    // in, so the build re-enters the toolkit's execution context to honor
+    // its concurrency bound.
+    return std::async(
+        std::launch::async,
+        [this, V = Eigen::MatrixXd(V), E, F, inflation_radius]() {
+            execution_context().run(
+                [&]() { build(V, E, F, inflation_radius); });
+        });
+}
+
+std::future<void> BroadPhase::begin_build(
+    ConstMatrixXdRef V0,
+    ConstMatrixXdRef V1,
+    const Eigen::MatrixXi& E,
+    const Eigen::MatrixXi& F,
+    const double inflation_radius)
+{
+    return std::async(
+        std::launch::async,
+        [this, V0 = Eigen::MatrixXd(V0), V1 = Eigen::MatrixXd(V1), E, F,
+         inflation_radius]() {
+            execution_context().run(
+                [&]() { build(V0, V1, E, F, inflation_radius); });
+        });
+}
+
+bool BroadPhase::needs_rebuild(
+    ConstMatrixXdRef V, const double inflation_radius) const
+{
+    if (m_build_margin <= 0 || V.size() == 0
+        || m_built_vertices.rows() != V.rows()
+        || m_built_vertices.cols() != V.cols()
+        || m_built_inflation_radius != inflation_radius) {
+        return true;
+    }
+    // The boxes were inflated by the margin, so the structure stays valid
+    // while no vertex has moved farther than the margin along any axis.
+    return (V - m_built_vertices).cwiseAbs().maxCoeff() > m_build_margin;
+}
+
+void BroadPhase::record_build(
+    ConstMatrixXdRef V, const double inflation_radius)
+{
+    if (m_build_margin > 0) {
+        m_built_vertices = V;
+        m_built_inflation_radius = inflation_radius;
+    }
+}
+
+void BroadPhase::update(ConstMatrixXdRef V)
+{
+    // Rebuild from scratch using the topology of the last build. With
+    // active zones set, the built boxes are a filtered subset of the
+    // vertices, so only the full-scene case can check the sizes.
+    assert(
+        !m_active_zones.empty() || size_t(V.rows()) == vertex_boxes.size());
+    build(V, m_edges, m_faces, m_inflation_radius);
 }
 
 void BroadPhase::clear()
@@ -43,11 +228,157 @@ void BroadPhase::clear()
     vertex_boxes.clear();
     edge_boxes.clear();
     face_boxes.clear();
+    m_vertex_order.clear();
+    m_edge_order.clear();
+    m_face_order.clear();
+    // Invalidate the recorded build until record_build() is called again.
+    m_built_vertices.resize(0, 0);
+}
+
+bool BroadPhase::use_active_zone_build()
+{
+    if (m_active_zones.empty()) {
+        return false;
+    }
+    if (m_active_zone_fallback_period > 0
+        && ++m_builds_since_full_build >= m_active_zone_fallback_period) {
+        // Periodic conservative full-scene build: catches pairs that drifted
+        // into contact entirely outside the zones.
+        m_builds_since_full_build = 0;
+        return false;
+    }
+    return true;
+}
+
+void BroadPhase::filter_boxes_to_active_zones()
+{
+    const auto filter = [&](std::vector<AABB>& boxes,
+                            std::vector<long>& order) {
+        std::vector<char> keep(boxes.size());
+        tbb::parallel_for(
+            tbb::blocked_range<size_t>(size_t(0), boxes.size()),
+            [&](const tbb::blocked_range<size_t>& r) {
+                for (size_t i = r.begin(); i < r.end(); i++) {
+                    keep[i] = std::any_of(
+                        m_active_zones.begin(), m_active_zones.end(),
+                        [&](const AABB& zone) {
+                            return boxes[i].intersects(zone);
+                        });
+                }
+            });
+
+        std::vector<AABB> kept;
+        order.clear();
+        for (size_t i = 0; i < boxes.size(); i++) {
+            if (keep[i]) {
+                kept.push_back(boxes[i]);
+                order.push_back(long(i));
+            }
+        }
+        boxes = std::move(kept);
+    };
+
+    filter(vertex_boxes, m_vertex_order);
+    filter(edge_boxes, m_edge_order);
+    filter(face_boxes, m_face_order);
+}
+
+void BroadPhase::morton_sort_boxes()
+{
+    if (vertex_boxes.empty()) {
+        return;
+    }
+
+    // Compute the scene bounds to normalize the box centers.
+    ArrayMax3d scene_min = vertex_boxes[0].min;
+    ArrayMax3d scene_max = vertex_boxes[0].max;
+    for (const AABB& box : vertex_boxes) {
+        scene_min = scene_min.min(box.min);
+        scene_max = scene_max.max(box.max);
+    }
+    const ArrayMax3d scene_size = (scene_max - scene_min).max(1e-12);
+
+    // Compose with a preexisting box-to-mesh-index map (the active-zone
+    // filter), so the order vectors always map box position to mesh index.
+    const auto compose = [](std::vector<long> perm,
+                            const std::vector<long>& prev) {
+        if (!prev.empty()) {
+            for (long& p : perm) {
+                p = prev[p];
+            }
+        }
+        return perm;
+    };
+
+    m_vertex_order =
+        compose(morton_sort(vertex_boxes, scene_min, scene_size),
+                m_vertex_order);
+    m_edge_order = compose(
+        morton_sort(edge_boxes, scene_min, scene_size), m_edge_order);
+    m_face_order = compose(
+        morton_sort(face_boxes, scene_min, scene_size), m_face_order);
+}
+
+void BroadPhase::remap_candidates(
+    std::vector<EdgeVertexCandidate>& candidates) const
+{
+    if (m_vertex_order.empty()) {
+        return;
+    }
+    for (auto& candidate : candidates) {
+        candidate.edge_index = m_edge_order[candidate.edge_index];
+        candidate.vertex_index = m_vertex_order[candidate.vertex_index];
+    }
+}
+
+void BroadPhase::remap_candidates(
+    std::vector<EdgeEdgeCandidate>& candidates) const
+{
+    if (m_edge_order.empty()) {
+        return;
+    }
+    for (auto& candidate : candidates) {
+        candidate.edge0_index = m_edge_order[candidate.edge0_index];
+        candidate.edge1_index = m_edge_order[candidate.edge1_index];
+        if (candidate.edge0_index > candidate.edge1_index) {
+            std::swap(candidate.edge0_index, candidate.edge1_index);
+        }
+    }
+}
+
+void BroadPhase::remap_candidates(
+    std::vector<FaceVertexCandidate>& candidates) const
+{
+    if (m_vertex_order.empty()) {
+        return;
+    }
+    for (auto& candidate : candidates) {
+        candidate.face_index = m_face_order[candidate.face_index];
+        candidate.vertex_index = m_vertex_order[candidate.vertex_index];
+    }
+}
+
+void BroadPhase::remap_candidates(
+    std::vector<EdgeFaceCandidate>& candidates) const
+{
+    if (m_edge_order.empty()) {
+        return;
+    }
+    for (auto& candidate : candidates) {
+        candidate.edge_index = m_edge_order[candidate.edge_index];
+        candidate.face_index = m_face_order[candidate.face_index];
+    }
 }
 
 void BroadPhase::detect_collision_candidates(
     int dim, Candidates& candidates) const
 {
+    if (m_enable_stats) {
+        m_stats.detect_time = 0;
+        m_stats.num_candidates = 0;
+    }
+    StatsTimer timer(m_enable_stats, m_stats.detect_time);
+
     candidates.clear();
     if (dim == 2) {
         // This is not needed for 3D
@@ -57,37 +388,135 @@ void BroadPhase::detect_collision_candidates(
         detect_edge_edge_candidates(candidates.ee_candidates);
         detect_face_vertex_candidates(candidates.fv_candidates);
     }
+
+    if (m_enable_stats) {
+        m_stats.num_candidates = candidates.size();
+    }
+}
+
+void BroadPhase::query_boxes(
+    const std::vector<AABB>& boxes, BoxQueryResult& result) const
+{
+    result.clear();
+
+    // Gather per-query id lists in parallel; flattened to CSR below. The
+    // lists are usually a handful of ids, so the inline small-vector storage
+    // avoids a heap allocation per query box.
+    std::vector<SmallVector<long, 8>> vert_ids(boxes.size());
+    std::vector<SmallVector<long, 8>> edge_ids(boxes.size());
+    std::vector<SmallVector<long, 8>> face_ids(boxes.size());
+
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(0ul, boxes.size()),
+        [&](const tbb::blocked_range<size_t>& range) {
+            for (size_t i = range.begin(); i != range.end(); i++) {
+                const AABB& query = boxes[i];
+
+                for (size_t j = 0; j < vertex_boxes.size(); j++) {
+                    if (query.intersects(vertex_boxes[j])) {
+                        vert_ids[i].push_back(vertex_boxes[j].vertex_ids[0]);
+                    }
+                }
+                for (size_t j = 0; j < edge_boxes.size(); j++) {
+                    if (query.intersects(edge_boxes[j])) {
+                        edge_ids[i].push_back(
+                            m_edge_order.empty() ? j : m_edge_order[j]);
+                    }
+                }
+                for (size_t j = 0; j < face_boxes.size(); j++) {
+                    if (query.intersects(face_boxes[j])) {
+                        face_ids[i].push_back(
+                            m_face_order.empty() ? j : m_face_order[j]);
+                    }
+                }
+
+                // Report mesh ids in ascending order even when the boxes are
+                // stored in Morton order.
+                std::sort(vert_ids[i].begin(), vert_ids[i].end());
+                std::sort(edge_ids[i].begin(), edge_ids[i].end());
+                std::sort(face_ids[i].begin(), face_ids[i].end());
+            }
+        });
+
+    flatten_to_csr(vert_ids, result.vertex_offsets, result.vertex_ids);
+    flatten_to_csr(edge_ids, result.edge_offsets, result.edge_ids);
+    flatten_to_csr(face_ids, result.face_offsets, result.face_ids);
+}
+
+BroadPhaseStats BroadPhase::stats() const
+{
+    BroadPhaseStats stats = m_stats;
+    stats.num_filtered = m_num_filtered.load();
+    collect_stats(stats);
+    return stats;
+}
+
+size_t BroadPhase::bytes_used() const
+{
+    return record_bytes_used(
+        vector_bytes_used(vertex_boxes) + vector_bytes_used(edge_boxes)
+        + vector_bytes_used(face_boxes) + matrix_bytes_used(m_edges)
+        + matrix_bytes_used(m_faces) + matrix_bytes_used(m_built_vertices)
+        + vector_bytes_used(m_vertex_order) + vector_bytes_used(m_edge_order)
+        + vector_bytes_used(m_face_order) + vector_bytes_used(m_active_zones)
+        + matrix_bytes_used(m_vertex_group_ids)
+        + matrix_bytes_used(m_can_groups_collide));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-std::unique_ptr<BroadPhase>
-BroadPhase::make_broad_phase(const BroadPhaseMethod method)
+std::unique_ptr<BroadPhase> BroadPhase::make_broad_phase(
+    const BroadPhaseMethod method, const bool use_morton_ordering)
 {
+    std::unique_ptr<BroadPhase> broad_phase;
     switch (method) {
     case BroadPhaseMethod::BRUTE_FORCE:
-        return std::make_unique<BruteForce>();
+        broad_phase = std::make_unique<BruteForce>();
+        break;
     case BroadPhaseMethod::HASH_GRID:
-        return std::make_unique<HashGrid>();
+        broad_phase = std::make_unique<HashGrid>();
+        break;
     case BroadPhaseMethod::SPATIAL_HASH:
-        return std::make_unique<SpatialHash>();
+        broad_phase = std::make_unique<SpatialHash>();
+        break;
+    case BroadPhaseMethod::BVH:
+        broad_phase = std::make_unique<BVH>();
+        break;
     case BroadPhaseMethod::SWEEP_AND_TINIEST_QUEUE:
-        return std::make_unique<SweepAndTiniestQueue>();
+        broad_phase = std::make_unique<SweepAndTiniestQueue>();
+        break;
+    case BroadPhaseMethod::TWO_LEVEL_SPATIAL_HASH:
+        broad_phase = std::make_unique<TwoLevelSpatialHash>();
+        break;
+    case BroadPhaseMethod::AUTO:
+        broad_phase = std::make_unique<AdaptiveBroadPhase>();
+        break;
     case BroadPhaseMethod::SWEEP_AND_TINIEST_QUEUE_GPU:
 #ifdef IPC_TOOLKIT_WITH_CUDA
-        return std::make_unique<SweepAndTiniestQueueGPU>();
+        broad_phase = std::make_unique<SweepAndTiniestQueueGPU>();
+        break;
 #else
         throw std::runtime_error("GPU Sweep and Tiniest Queue is disabled "
                                  "because CUDA is disabled!");
+#endif
+    case BroadPhaseMethod::HASH_GRID_GPU:
+#ifdef IPC_TOOLKIT_WITH_CUDA
+        broad_phase = std::make_unique<HashGridGPU>();
+        break;
+#else
+        throw std::runtime_error(
+            "GPU Hash Grid is disabled because CUDA is disabled!");
 #endif
     default:
         throw std::runtime_error("Invalid BroadPhaseMethod!");
     }
+    broad_phase->set_morton_ordering(use_morton_ordering);
+    return broad_phase;
 }
 
 void construct_collision_candidates(
     const CollisionMesh& mesh,
-    const Eigen::MatrixXd& V,
+    ConstMatrixXdRef V,
     Candidates& candidates,
     double inflation_radius,
     const BroadPhaseMethod method)
@@ -96,18 +525,27 @@ void construct_collision_candidates(
 
     candidates.clear();
 
-    std::unique_ptr<BroadPhase> broad_phase =
-        BroadPhase::make_broad_phase(method);
-    broad_phase->can_vertices_collide = mesh.can_collide;
-    broad_phase->build(V, mesh.edges(), mesh.faces(), inflation_radius);
-    broad_phase->detect_collision_candidates(dim, candidates);
-    broad_phase->clear();
+    execution_context().run([&] {
+        std::unique_ptr<BroadPhase> broad_phase =
+            BroadPhase::make_broad_phase(method);
+        broad_phase->can_vertices_collide = mesh.can_collide;
+        broad_phase->edge_length_median_hint = mesh.rest_median_edge_length();
+        if (mesh.has_vertex_patch_ids()) {
+            // Patch culling as an inline mask lookup (see
+            // CollisionMesh::set_vertex_patch_ids()).
+            broad_phase->set_vertex_group_ids(
+                mesh.vertex_patch_ids(), mesh.can_patches_collide());
+        }
+        broad_phase->build(V, mesh.edges(), mesh.faces(), inflation_radius);
+        broad_phase->detect_collision_candidates(dim, candidates);
+        broad_phase->clear();
+    });
 }
 
 void construct_collision_candidates(
     const CollisionMesh& mesh,
-    const Eigen::MatrixXd& V0,
-    const Eigen::MatrixXd& V1,
+    ConstMatrixXdRef V0,
+    ConstMatrixXdRef V1,
     Candidates& candidates,
     double inflation_radius,
     const BroadPhaseMethod method)
@@ -116,12 +554,79 @@ void construct_collision_candidates(
 
     candidates.clear();
 
-    std::unique_ptr<BroadPhase> broad_phase =
-        BroadPhase::make_broad_phase(method);
-    broad_phase->can_vertices_collide = mesh.can_collide;
-    broad_phase->build(V0, V1, mesh.edges(), mesh.faces(), inflation_radius);
-    broad_phase->detect_collision_candidates(dim, candidates);
-    broad_phase->clear();
+    execution_context().run([&] {
+        std::unique_ptr<BroadPhase> broad_phase =
+            BroadPhase::make_broad_phase(method);
+        broad_phase->can_vertices_collide = mesh.can_collide;
+        broad_phase->edge_length_median_hint = mesh.rest_median_edge_length();
+        if (mesh.has_vertex_patch_ids()) {
+            // Patch culling as an inline mask lookup (see
+            // CollisionMesh::set_vertex_patch_ids()).
+            broad_phase->set_vertex_group_ids(
+                mesh.vertex_patch_ids(), mesh.can_patches_collide());
+        }
+        broad_phase->build(
+            V0, V1, mesh.edges(), mesh.faces(), inflation_radius);
+        broad_phase->detect_collision_candidates(dim, candidates);
+        broad_phase->clear();
+    });
+}
+
+void construct_collision_candidates(
+    BroadPhase& broad_phase,
+    const CollisionMesh& mesh,
+    ConstMatrixXdRef V,
+    Candidates& candidates,
+    double inflation_radius)
+{
+    candidates.clear();
+
+    execution_context().run([&] {
+        broad_phase.can_vertices_collide = mesh.can_collide;
+        broad_phase.edge_length_median_hint = mesh.rest_median_edge_length();
+        if (mesh.has_vertex_patch_ids()) {
+            broad_phase.set_vertex_group_ids(
+                mesh.vertex_patch_ids(), mesh.can_patches_collide());
+        } else {
+            broad_phase.clear_vertex_group_ids();
+        }
+        // With a build margin set, the structure is built with extra inflation
+        // and reused while no vertex has moved farther than the margin (see
+        // BroadPhase::set_build_margin()).
+        if (broad_phase.needs_rebuild(V, inflation_radius)) {
+            broad_phase.build(
+                V, mesh.edges(), mesh.faces(),
+                inflation_radius + broad_phase.build_margin());
+            broad_phase.record_build(V, inflation_radius);
+        }
+        broad_phase.detect_collision_candidates(V.cols(), candidates);
+    });
+    // NOTE: Do not clear the broad phase so the caller can reuse it.
+}
+
+void construct_collision_candidates(
+    BroadPhase& broad_phase,
+    const CollisionMesh& mesh,
+    ConstMatrixXdRef V0,
+    ConstMatrixXdRef V1,
+    Candidates& candidates,
+    double inflation_radius)
+{
+    candidates.clear();
+
+    execution_context().run([&] {
+        broad_phase.can_vertices_collide = mesh.can_collide;
+        broad_phase.edge_length_median_hint = mesh.rest_median_edge_length();
+        if (mesh.has_vertex_patch_ids()) {
+            broad_phase.set_vertex_group_ids(
+                mesh.vertex_patch_ids(), mesh.can_patches_collide());
+        } else {
+            broad_phase.clear_vertex_group_ids();
+        }
+        broad_phase.build(V0, V1, mesh.edges(), mesh.faces(), inflation_radius);
+        broad_phase.detect_collision_candidates(V0.cols(), candidates);
+    });
+    // NOTE: Do not clear the broad phase so the caller can reuse it.
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -129,9 +634,14 @@ void construct_collision_candidates(
 bool BroadPhase::can_edge_vertex_collide(size_t ei, size_t vi) const
 {
     const auto& [e0i, e1i, _] = edge_boxes[ei].vertex_ids;
+    // Use the id stored in the box so this works with Morton-ordered boxes.
+    const long v0i = vertex_boxes[vi].vertex_ids[0];
 
-    return vi != e0i && vi != e1i
-        && (can_vertices_collide(vi, e0i) || can_vertices_collide(vi, e1i));
+    const bool can_collide = v0i != e0i && v0i != e1i
+        && (check_can_vertices_collide(v0i, e0i)
+            || check_can_vertices_collide(v0i, e1i));
+    count_filtered(can_collide);
+    return can_collide;
 }
 
 bool BroadPhase::can_edges_collide(size_t eai, size_t ebi) const
@@ -142,19 +652,27 @@ bool BroadPhase::can_edges_collide(size_t eai, size_t ebi) const
     bool share_endpoint =
         ea0i == eb0i || ea0i == eb1i || ea1i == eb0i || ea1i == eb1i;
 
-    return !share_endpoint
-        && (can_vertices_collide(ea0i, eb0i) || can_vertices_collide(ea0i, eb1i)
-            || can_vertices_collide(ea1i, eb0i)
-            || can_vertices_collide(ea1i, eb1i));
+    const bool can_collide = !share_endpoint
+        && (check_can_vertices_collide(ea0i, eb0i)
+            || check_can_vertices_collide(ea0i, eb1i)
+            || check_can_vertices_collide(ea1i, eb0i)
+            || check_can_vertices_collide(ea1i, eb1i));
+    count_filtered(can_collide);
+    return can_collide;
 }
 
 bool BroadPhase::can_face_vertex_collide(size_t fi, size_t vi) const
 {
     const auto& [f0i, f1i, f2i] = face_boxes[fi].vertex_ids;
+    // Use the id stored in the box so this works with Morton-ordered boxes.
+    const long v0i = vertex_boxes[vi].vertex_ids[0];
 
-    return vi != f0i && vi != f1i && vi != f2i
-        && (can_vertices_collide(vi, f0i) || can_vertices_collide(vi, f1i)
-            || can_vertices_collide(vi, f2i));
+    const bool can_collide = v0i != f0i && v0i != f1i && v0i != f2i
+        && (check_can_vertices_collide(v0i, f0i)
+            || check_can_vertices_collide(v0i, f1i)
+            || check_can_vertices_collide(v0i, f2i));
+    count_filtered(can_collide);
+    return can_collide;
 }
 
 bool BroadPhase::can_edge_face_collide(size_t ei, size_t fi) const
@@ -165,11 +683,15 @@ bool BroadPhase::can_edge_face_collide(size_t ei, size_t fi) const
     bool share_endpoint = e0i == f0i || e0i == f1i || e0i == f2i || e1i == f0i
         || e1i == f1i || e1i == f2i;
 
-    return !share_endpoint
-        && (can_vertices_collide(e0i, f0i) || can_vertices_collide(e0i, f1i)
-            || can_vertices_collide(e0i, f2i) || can_vertices_collide(e1i, f0i)
-            || can_vertices_collide(e1i, f1i)
-            || can_vertices_collide(e1i, f2i));
+    const bool can_collide = !share_endpoint
+        && (check_can_vertices_collide(e0i, f0i)
+            || check_can_vertices_collide(e0i, f1i)
+            || check_can_vertices_collide(e0i, f2i)
+            || check_can_vertices_collide(e1i, f0i)
+            || check_can_vertices_collide(e1i, f1i)
+            || check_can_vertices_collide(e1i, f2i));
+    count_filtered(can_collide);
+    return can_collide;
 }
 
 } // namespace ipc
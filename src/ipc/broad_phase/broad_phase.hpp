@@ -3,18 +3,91 @@
 #include <ipc/collision_mesh.hpp>
 #include <ipc/broad_phase/aabb.hpp>
 #include <ipc/broad_phase/collision_candidate.hpp>
+#include <ipc/utils/eigen_ext.hpp>
 
 #include <Eigen/Core>
 
+#include <algorithm> // std::max
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <future>
+
 namespace ipc {
 
+/// @brief Opt-in statistics describing the last broad phase build and
+/// detect queries (see BroadPhase::enable_stats()).
+struct BroadPhaseStats {
+    /// @brief Wall time of the last build() in seconds.
+    double build_time = 0;
+    /// @brief Wall time of the last detect_collision_candidates() in seconds.
+    double detect_time = 0;
+    /// @brief Number of vertex, edge, and face boxes built.
+    std::array<size_t, 3> num_boxes = { { 0, 0, 0 } };
+    /// @brief Number of candidates emitted by detect_collision_candidates().
+    size_t num_candidates = 0;
+    /// @brief Number of box pairs rejected by the can_*_collide filters.
+    size_t num_filtered = 0;
+    /// @brief Histogram of boxes per occupied cell in log2 buckets (i.e.,
+    /// bucket b counts cells holding [2^b, 2^(b+1)) boxes); only populated by
+    /// the grid-based methods.
+    std::vector<size_t> boxes_per_cell_histogram;
+
+    /// @brief Record one occupied cell holding count boxes in the histogram.
+    void add_occupied_cell(const size_t count)
+    {
+        size_t bucket = 0;
+        while ((size_t(2) << bucket) <= count) {
+            bucket++;
+        }
+        if (bucket >= boxes_per_cell_histogram.size()) {
+            boxes_per_cell_histogram.resize(bucket + 1, 0);
+        }
+        boxes_per_cell_histogram[bucket]++;
+    }
+
+    /// @brief Write the statistics to the logger at debug level.
+    void log() const;
+};
+
+/// @brief CSR-form result of a batched box query (see
+/// BroadPhase::query_boxes()).
+///
+/// The ids overlapping the i-th query box are
+/// vertex_ids[vertex_offsets[i]..vertex_offsets[i+1]) (and likewise for
+/// edges and faces). The vectors retain their capacity across queries, so
+/// one instance can be reused every step.
+struct BoxQueryResult {
+    std::vector<long> vertex_offsets; ///< Per-box starts (|boxes|+1).
+    std::vector<long> vertex_ids; ///< Overlapping vertex ids.
+    std::vector<long> edge_offsets; ///< Per-box starts (|boxes|+1).
+    std::vector<long> edge_ids; ///< Overlapping edge ids.
+    std::vector<long> face_offsets; ///< Per-box starts (|boxes|+1).
+    std::vector<long> face_ids; ///< Overlapping face ids.
+
+    /// @brief Remove all ids, but keep the allocated capacity.
+    void clear()
+    {
+        vertex_offsets.clear();
+        vertex_ids.clear();
+        edge_offsets.clear();
+        edge_ids.clear();
+        face_offsets.clear();
+        face_ids.clear();
+    }
+};
+
 /// Enumeration of implemented broad phase methods.
 enum class BroadPhaseMethod {
     BRUTE_FORCE = 0,
     HASH_GRID,
     SPATIAL_HASH,
+    BVH,
     SWEEP_AND_TINIEST_QUEUE,
+    TWO_LEVEL_SPATIAL_HASH,
+    AUTO, // Selects among the methods from measured timings
     SWEEP_AND_TINIEST_QUEUE_GPU, // Requires CUDA
+    HASH_GRID_GPU, // Requires CUDA
     NUM_METHODS
 };
 
@@ -24,9 +97,11 @@ public:
 
     /// @brief Construct a registered broad phase object.
     /// @param method The broad phase method to use.
+    /// @param use_morton_ordering If true, sort the element boxes along the
+    ///        Morton curve (see set_morton_ordering()).
     /// @return The constructed broad phase object.
-    static std::unique_ptr<BroadPhase>
-    make_broad_phase(const BroadPhaseMethod method);
+    static std::unique_ptr<BroadPhase> make_broad_phase(
+        const BroadPhaseMethod method, const bool use_morton_ordering = false);
 
     /// @brief Build the broad phase for static collision detection.
     /// @param V0 Positions of the vertices.
@@ -34,7 +109,7 @@ public:
     /// @param F Faces of the mesh.
     /// @param inflation_radius Radius of inflation around all elements.
     virtual void build(
-        const Eigen::MatrixXd& V,
+        ConstMatrixXdRef V,
         const Eigen::MatrixXi& E,
         const Eigen::MatrixXi& F,
         double inflation_radius = 0);
@@ -46,12 +121,119 @@ public:
     /// @param F Faces of the mesh.
     /// @param inflation_radius Radius of inflation around all elements.
     virtual void build(
-        const Eigen::MatrixXd& V0,
-        const Eigen::MatrixXd& V1,
+        ConstMatrixXdRef V0,
+        ConstMatrixXdRef V1,
+        const Eigen::MatrixXi& E,
+        const Eigen::MatrixXi& F,
+        double inflation_radius = 0);
+
+    /// @brief Start build() on a background thread.
+    ///
+    /// Hosts spend tens of milliseconds in their linear solver between
+    /// Newton iterations while the toolkit sits idle; this overlaps the
+    /// broad phase rebuild for the predicted positions with that work. The
+    /// inputs are copied, so the caller may overwrite its matrices as soon
+    /// as this returns. The build runs inside the configured
+    /// execution_context(), so its concurrency bound applies.
+    /// @warning The object must not be used, rebuilt, or destroyed until
+    /// the returned future has been waited on; afterwards the structure is
+    /// identical to one produced by the matching build() call.
+    /// @param V Positions of the vertices.
+    /// @param E Edges of the mesh.
+    /// @param F Faces of the mesh.
+    /// @param inflation_radius Radius of inflation around all elements.
+    /// @return A future that becomes ready when the build has finished
+    /// (and rethrows any exception the build threw).
+    std::future<void> begin_build(
+        ConstMatrixXdRef V,
+        const Eigen::MatrixXi& E,
+        const Eigen::MatrixXi& F,
+        double inflation_radius = 0);
+
+    /// @brief Start the continuous collision detection build() on a
+    /// background thread (see the discrete begin_build() for the contract).
+    /// @param V0 Starting positions of the vertices.
+    /// @param V1 Ending positions of the vertices.
+    /// @param E Edges of the mesh.
+    /// @param F Faces of the mesh.
+    /// @param inflation_radius Radius of inflation around all elements.
+    /// @return A future that becomes ready when the build has finished.
+    std::future<void> begin_build(
+        ConstMatrixXdRef V0,
+        ConstMatrixXdRef V1,
         const Eigen::MatrixXi& E,
         const Eigen::MatrixXi& F,
         double inflation_radius = 0);
 
+    /// @brief Update a previously built broad phase with new vertex positions.
+    ///
+    /// Reuses the topology (edges and faces) and inflation radius passed to
+    /// the last call to build(). The default implementation rebuilds from
+    /// scratch; derived classes may exploit temporal coherence to avoid
+    /// reconstructing their acceleration structure.
+    /// @param V New positions of the vertices.
+    virtual void update(ConstMatrixXdRef V);
+
+    /// @brief Enable or disable Morton-order storage of the element boxes.
+    ///
+    /// When enabled, build() sorts the vertex, edge, and face boxes along the
+    /// Morton curve of their centers so that boxes that are close in space
+    /// are also close in memory, and the detect_* functions remap the emitted
+    /// candidates back to mesh indices. Derived classes that index the boxes
+    /// by mesh element may override this to opt out.
+    virtual void set_morton_ordering(const bool use_morton_ordering)
+    {
+        m_use_morton_ordering = use_morton_ordering;
+    }
+
+    /// @brief Set the extra inflation margin used to skip rebuilds.
+    ///
+    /// When nonzero, the caller-owned construct_collision_candidates()
+    /// overloads build the structure with the boxes inflated by this margin
+    /// on top of the inflation radius and then reuse it as long as no vertex
+    /// has moved farther than the margin since the build. This replaces the
+    /// per-call rebuild with an O(n) max-norm displacement check in solves
+    /// where most iterations move the vertices by tiny amounts. The resulting
+    /// candidate sets are conservative supersets of the exact ones.
+    void set_build_margin(const double margin) { m_build_margin = margin; }
+
+    /// @brief The extra inflation margin used to skip rebuilds.
+    double build_margin() const { return m_build_margin; }
+
+    /// @brief Does the structure need to be rebuilt for the given positions?
+    ///
+    /// Returns false only if a build recorded through record_build() with the
+    /// same inflation radius covers V within the build margin.
+    bool needs_rebuild(
+        ConstMatrixXdRef V, const double inflation_radius) const;
+
+    /// @brief Record the positions and radius the last build covers.
+    void record_build(ConstMatrixXdRef V, const double inflation_radius);
+
+    /// @brief Enable or disable statistics collection (off by default).
+    ///
+    /// When enabled, build() and detect_collision_candidates() record wall
+    /// times and counts which can be queried through stats().
+    void enable_stats(const bool enable = true) { m_enable_stats = enable; }
+
+    /// @brief Statistics of the last build() and detect queries.
+    /// @note Only populated while enable_stats() is on.
+    BroadPhaseStats stats() const;
+
+    /// @brief Bytes of heap memory currently held by the broad phase.
+    ///
+    /// Counts the element boxes, the cached build inputs, and (in derived
+    /// classes) the acceleration structure itself. Capacity is counted, not
+    /// only the used size, so this reflects the memory actually held.
+    virtual size_t bytes_used() const;
+
+    /// @brief Largest value bytes_used() has returned on this object.
+    ///
+    /// Useful for right-sizing memory budgets and detecting candidate
+    /// blowups: query bytes_used() after each build and the peak persists
+    /// across clear().
+    size_t peak_bytes_used() const { return m_peak_bytes_used; }
+
     /// @brief Clear any built data.
     virtual void clear();
 
@@ -81,19 +263,256 @@ public:
     virtual void
     detect_collision_candidates(int dim, Candidates& candidates) const;
 
+    /// @brief Query caller-provided boxes against the built structure.
+    ///
+    /// Returns the mesh vertex, edge, and face ids whose boxes overlap each
+    /// query box (e.g., sensor volumes or fattened picking rays), so callers
+    /// do not need to maintain a second spatial index over the same mesh.
+    /// The query boxes are used as given; inflate them before calling if a
+    /// search radius is desired. No can_vertices_collide filtering is
+    /// applied.
+    /// @param[in] boxes The query boxes.
+    /// @param[out] result The overlapping ids per box in CSR form.
+    virtual void query_boxes(
+        const std::vector<AABB>& boxes, BoxQueryResult& result) const;
+
     /// @brief Function for determining if two vertices can collide.
     std::function<bool(size_t, size_t)> can_vertices_collide =
         [](size_t, size_t) { return true; };
 
+    /// @brief Optional precomputed median edge length (negative when unset).
+    ///
+    /// The grid-based methods size their voxels from the median edge
+    /// length, an O(|E|) serial pass otherwise repeated on every build.
+    /// Set this from CollisionMesh::rest_median_edge_length() (the
+    /// mesh-aware wiring in construct_collision_candidates() does) to
+    /// consume the cached value instead; edge lengths under the barrier
+    /// stay near their rest lengths, so the heuristic is unaffected.
+    double edge_length_median_hint = -1;
+
+    /// @brief Optional per-vertex inflation radii (empty when unset).
+    ///
+    /// When set (size must equal the number of vertices), build() inflates
+    /// each vertex box by its own radius instead of the uniform
+    /// inflation_radius argument, so regions with a smaller activation
+    /// distance produce proportionally fewer candidates (see
+    /// Constraints::vertex_dhat, which wires this). Edge and face boxes are
+    /// unions of their vertex boxes and inherit the radii automatically.
+    Eigen::VectorXd vertex_inflation_radii;
+
+    /// @brief Restrict detection to caller-supplied active zones.
+    ///
+    /// During localized events (a tool contacting one area of an otherwise
+    /// resting scene) the full-scene broad phase is paid every iteration for
+    /// candidates that can only arise in a small region. With zones set,
+    /// build() keeps only the element boxes that intersect one of the zones,
+    /// so the structure and all detect queries cover just those elements.
+    /// Pairs with both elements outside every zone are missed until the next
+    /// fallback build: every fallback_period-th build ignores the zones and
+    /// runs the full scene, so contacts drifting in from outside are caught
+    /// at a coarser cadence. Supply zones inflated to cover the motion
+    /// expected between fallback builds; the element boxes already include
+    /// the inflation radius, so the activation distance needs no extra
+    /// allowance.
+    /// @note Not supported by the structures that index their boxes by mesh
+    /// element (see the overrides); composite structures forward the zones
+    /// to their inner structures.
+    /// @param zones The active zones (empty restores full-scene detection).
+    /// @param fallback_period Run a full-scene build every this many builds
+    /// (a non-positive period disables the fallback).
+    virtual void set_active_zones(
+        const std::vector<AABB>& zones, const int fallback_period = 8)
+    {
+        m_active_zones = zones;
+        m_active_zone_fallback_period = fallback_period;
+        m_builds_since_full_build = 0;
+    }
+
+    /// @brief Remove the active zones (every build is full-scene again).
+    void clear_active_zones() { set_active_zones({}); }
+
+    /// @brief The active zones restricting detection (empty when unset).
+    const std::vector<AABB>& active_zones() const { return m_active_zones; }
+
+    /// @brief Set a precomputed group-based vertex collision filter.
+    ///
+    /// When set, the per-pair filtering during candidate detection is an
+    /// inline array lookup instead of an indirect call through
+    /// can_vertices_collide, which is invoked tens of millions of times per
+    /// build on large scenes.
+    /// @param group_ids Per-vertex collision group IDs.
+    /// @param can_groups_collide Symmetric mask of which group pairs can collide.
+    void set_vertex_group_ids(
+        const Eigen::VectorXi& group_ids,
+        const Eigen::Matrix<bool, Eigen::Dynamic, Eigen::Dynamic>&
+            can_groups_collide)
+    {
+        assert(can_groups_collide.rows() == can_groups_collide.cols());
+        assert(group_ids.size() == 0
+               || (group_ids.minCoeff() >= 0
+                   && group_ids.maxCoeff() < can_groups_collide.rows()));
+        m_vertex_group_ids = group_ids;
+        m_can_groups_collide = can_groups_collide;
+    }
+
+    /// @brief Clear the group-based vertex collision filter.
+    void clear_vertex_group_ids()
+    {
+        m_vertex_group_ids.resize(0);
+        m_can_groups_collide.resize(0, 0);
+    }
+
 protected:
+    /// @brief Evaluate the vertex collision filter.
+    ///
+    /// Uses the group mask if set, otherwise falls back to the
+    /// can_vertices_collide function.
+    bool check_can_vertices_collide(size_t vi, size_t vj) const
+    {
+        if (m_vertex_group_ids.size() > 0) {
+            return m_can_groups_collide(
+                m_vertex_group_ids[vi], m_vertex_group_ids[vj]);
+        }
+        return can_vertices_collide(vi, vj);
+    }
+
     virtual bool can_edge_vertex_collide(size_t ei, size_t vi) const;
     virtual bool can_edges_collide(size_t eai, size_t ebi) const;
     virtual bool can_face_vertex_collide(size_t fi, size_t vi) const;
     virtual bool can_edge_face_collide(size_t ei, size_t fi) const;
 
+    /// @brief Fill method-specific statistics (e.g., cell occupancy).
+    virtual void collect_stats(BroadPhaseStats& /*stats*/) const { }
+
+    /// @brief Update the tracked peak with a bytes_used() measurement.
+    /// @return The measurement, so overrides can return it directly.
+    size_t record_bytes_used(const size_t bytes) const
+    {
+        m_peak_bytes_used = std::max(m_peak_bytes_used, bytes);
+        return bytes;
+    }
+
+    /// @brief Count a pair rejected by the can_*_collide filters.
+    void count_filtered(const bool can_collide) const
+    {
+        if (m_enable_stats && !can_collide) {
+            m_num_filtered.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    /// @brief Scoped timer accumulating elapsed wall time into a stats field.
+    class StatsTimer {
+    public:
+        StatsTimer(const bool enabled, double& out)
+            : m_enabled(enabled)
+            , m_out(out)
+            , m_start(std::chrono::steady_clock::now())
+        {
+        }
+
+        ~StatsTimer()
+        {
+            if (m_enabled) {
+                m_out += std::chrono::duration<double>(
+                             std::chrono::steady_clock::now() - m_start)
+                             .count();
+            }
+        }
+
+    protected:
+        const bool m_enabled;
+        double& m_out;
+        const std::chrono::steady_clock::time_point m_start;
+    };
+
+    /// @brief Flatten per-query id lists into a CSR offsets/ids pair (used
+    /// by query_boxes() implementations). Lists is any random-access
+    /// container of id containers, e.g. a std::vector of SmallVectors.
+    template <typename Lists>
+    static void flatten_to_csr(
+        const Lists& lists,
+        std::vector<long>& offsets,
+        std::vector<long>& ids)
+    {
+        offsets.resize(lists.size() + 1);
+        offsets[0] = 0;
+        for (size_t i = 0; i < lists.size(); i++) {
+            offsets[i + 1] = offsets[i] + lists[i].size();
+        }
+        ids.resize(offsets.back());
+        for (size_t i = 0; i < lists.size(); i++) {
+            std::copy(
+                lists[i].begin(), lists[i].end(), ids.begin() + offsets[i]);
+        }
+    }
+
+    /// @brief Should this build restrict the boxes to the active zones?
+    ///
+    /// Advances the fallback cadence, so call exactly once per build: every
+    /// fallback_period-th build answers false to run the full scene.
+    bool use_active_zone_build();
+
+    /// @brief Drop the element boxes that intersect no active zone.
+    ///
+    /// Records the surviving boxes' mesh indices in the order vectors, so
+    /// the detect functions' remap_candidates() calls translate the emitted
+    /// candidates back to mesh indices (the same mechanism Morton ordering
+    /// uses).
+    void filter_boxes_to_active_zones();
+
+    /// @brief Sort the element boxes along the Morton curve of their centers.
+    void morton_sort_boxes();
+
+    /// @brief Map candidates emitted in box order back to mesh indices.
+    ///
+    /// No-ops when Morton ordering is disabled, so derived classes can call
+    /// these unconditionally at the end of their detect_* functions.
+    void remap_candidates(std::vector<EdgeVertexCandidate>& candidates) const;
+    void remap_candidates(std::vector<EdgeEdgeCandidate>& candidates) const;
+    void remap_candidates(std::vector<FaceVertexCandidate>& candidates) const;
+    void remap_candidates(std::vector<EdgeFaceCandidate>& candidates) const;
+
     std::vector<AABB> vertex_boxes;
     std::vector<AABB> edge_boxes;
     std::vector<AABB> face_boxes;
+
+    // Inputs of the last build() kept around so update() can rebuild.
+    Eigen::MatrixXi m_edges;
+    Eigen::MatrixXi m_faces;
+    double m_inflation_radius = 0;
+
+    // Build margin used to skip rebuilds and the positions and radius of the
+    // last recorded build (see set_build_margin()).
+    double m_build_margin = 0;
+    Eigen::MatrixXd m_built_vertices;
+    double m_built_inflation_radius = 0;
+
+    // Morton-order storage of the boxes (empty means mesh index order). The
+    // order vectors map box position to mesh index.
+    bool m_use_morton_ordering = false;
+    std::vector<long> m_vertex_order;
+    std::vector<long> m_edge_order;
+    std::vector<long> m_face_order;
+
+    // Active zones restricting detection (empty means full scene) and the
+    // fallback cadence state (see set_active_zones()).
+    std::vector<AABB> m_active_zones;
+    int m_active_zone_fallback_period = 8;
+    int m_builds_since_full_build = 0;
+
+    // Group-based vertex collision filter (empty means use
+    // can_vertices_collide).
+    Eigen::VectorXi m_vertex_group_ids;
+    Eigen::Matrix<bool, Eigen::Dynamic, Eigen::Dynamic> m_can_groups_collide;
+
+    // Opt-in statistics (see enable_stats()). The filtered-pair counter is
+    // atomic because the can_*_collide filters run inside parallel loops.
+    bool m_enable_stats = false;
+    mutable BroadPhaseStats m_stats;
+    mutable std::atomic<size_t> m_num_filtered = { 0 };
+
+    /// @brief Peak of bytes_used() (see peak_bytes_used()).
+    mutable size_t m_peak_bytes_used = 0;
 };
 
 /// @brief Construct a set of discrete collision detection candidates.
@@ -104,7 +523,7 @@ protected:
 /// @param[in] method Broad phase method to use.
 void construct_collision_candidates(
     const CollisionMesh& mesh,
-    const Eigen::MatrixXd& V,
+    ConstMatrixXdRef V,
     Candidates& candidates,
     double inflation_radius = 0,
     const BroadPhaseMethod method = BroadPhaseMethod::HASH_GRID);
@@ -119,10 +538,45 @@ void construct_collision_candidates(
 /// @param[in] method Broad phase method to use.
 void construct_collision_candidates(
     const CollisionMesh& mesh,
-    const Eigen::MatrixXd& V0,
-    const Eigen::MatrixXd& V1,
+    ConstMatrixXdRef V0,
+    ConstMatrixXdRef V1,
     Candidates& candidates,
     double inflation_radius = 0,
     const BroadPhaseMethod method = BroadPhaseMethod::HASH_GRID);
 
+/// @brief Construct a set of discrete collision detection candidates using a
+/// caller-owned broad phase.
+///
+/// Unlike the BroadPhaseMethod overload, this neither allocates a fresh broad
+/// phase nor clears it afterwards, so the structure stays warm and can be
+/// reused (e.g., via BroadPhase::update()) across calls.
+/// @param[in,out] broad_phase Broad phase to (re)build and query.
+/// @param[in] mesh The surface of the contact mesh.
+/// @param[in] V Surface Vertex positions at start as rows of a matrix.
+/// @param[out] candidates The constructed candidate set as output.
+/// @param[in] inflation_radius Amount to inflate the bounding boxes.
+void construct_collision_candidates(
+    BroadPhase& broad_phase,
+    const CollisionMesh& mesh,
+    ConstMatrixXdRef V,
+    Candidates& candidates,
+    double inflation_radius = 0);
+
+/// @brief Construct a set of continuous collision detection candidates using a
+/// caller-owned broad phase.
+/// @note Assumes the trajectory is linear.
+/// @param[in,out] broad_phase Broad phase to (re)build and query.
+/// @param[in] mesh The surface of the contact mesh.
+/// @param[in] V0 Surface vertex positions at start as rows of a matrix.
+/// @param[in] V1 Surface vertex positions at end as rows of a matrix.
+/// @param[out] candidates The constructed candidate set as output.
+/// @param[in] inflation_radius Amount to inflate the bounding boxes.
+void construct_collision_candidates(
+    BroadPhase& broad_phase,
+    const CollisionMesh& mesh,
+    ConstMatrixXdRef V0,
+    ConstMatrixXdRef V1,
+    Candidates& candidates,
+    double inflation_radius = 0);
+
 } // namespace ipc
@@ -17,13 +17,28 @@ void BruteForce::detect_candidates(
     const std::function<bool(size_t, size_t)>& can_collide,
     std::vector<Candidate>& candidates) const
 {
+    // Float SoA copy of boxes1 so the inner loop can test box pairs in
+    // batches; its overlaps are conservative, so hits are confirmed against
+    // the double boxes below.
+    const AABBSoA boxes1_soa(boxes1);
+
     tbb::enumerable_thread_specific<std::vector<Candidate>> storage;
 
+    // Tile the O(n²) pair grid instead of letting TBB split it down to
+    // single rows: a column tile of the float SoA (24 B/box → ~96 KB) stays
+    // cache resident while it is swept by all rows of the tile.
+    constexpr size_t ROW_GRAIN = 64;
+    constexpr size_t COL_GRAIN = 4096;
+
     tbb::parallel_for(
-        tbb::blocked_range2d<size_t>(0ul, boxes0.size(), 0ul, boxes1.size()),
+        tbb::blocked_range2d<size_t>(
+            0ul, boxes0.size(), ROW_GRAIN, 0ul, boxes1.size(), COL_GRAIN),
         [&](const tbb::blocked_range2d<size_t>& r) {
             auto& local_candidates = storage.local();
 
+            constexpr size_t BATCH_SIZE = 256;
+            unsigned char overlaps[BATCH_SIZE];
+
             size_t i_end;
             if constexpr (triangular) {
                 i_end = std::min(r.rows().end(), r.cols().end()); // i < j
@@ -42,20 +57,27 @@ void BruteForce::detect_candidates(
                     j_begin = r.cols().begin();
                 }
 
-                for (size_t j = j_begin; j < r.cols().end(); j++) {
-                    if (!can_collide(i, j)) {
-                        continue;
-                    }
+                for (size_t batch_begin = j_begin;
+                     batch_begin < r.cols().end(); batch_begin += BATCH_SIZE) {
+                    const size_t batch_end = std::min(
+                        batch_begin + BATCH_SIZE, size_t(r.cols().end()));
+
+                    boxes1_soa.batch_intersects(
+                        box0, batch_begin, batch_end, overlaps);
 
-                    const AABB& box1 = boxes1[j];
-                    if (box0.intersects(box1)) {
-                        local_candidates.emplace_back(i, j);
+                    for (size_t j = batch_begin; j < batch_end; j++) {
+                        if (overlaps[j - batch_begin] && can_collide(i, j)
+                            && box0.intersects(boxes1[j])) {
+                            local_candidates.emplace_back(i, j);
+                        }
                     }
                 }
             }
         });
 
     merge_thread_local_vectors(storage, candidates);
+
+    remap_candidates(candidates);
 }
 
 void BruteForce::detect_edge_vertex_candidates(
@@ -0,0 +1,182 @@
+#include "bvh.hpp"
+
+#include <ipc/utils/merge_thread_local_vectors.hpp>
+#include <ipc/utils/morton.hpp>
+
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_sort.h>
+
+#include <algorithm> // std::min/max
+
+namespace ipc {
+
+void BVHTree::build(const std::vector<AABB>& boxes)
+{
+    clear();
+
+    if (boxes.empty()) {
+        return;
+    }
+
+    // Compute the scene bounds to normalize the box centers.
+    ArrayMax3d scene_min = boxes[0].min;
+    ArrayMax3d scene_max = boxes[0].max;
+    for (const AABB& box : boxes) {
+        scene_min = scene_min.min(box.min);
+        scene_max = scene_max.max(box.max);
+    }
+    const ArrayMax3d scene_size = (scene_max - scene_min).max(1e-12);
+
+    // Sort the boxes along the Morton curve of their centers so that nearby
+    // leaves end up in the same subtree.
+    std::vector<std::pair<uint32_t, long>> codes(boxes.size());
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(size_t(0), boxes.size()),
+        [&](const tbb::blocked_range<size_t>& r) {
+            for (size_t i = r.begin(); i < r.end(); i++) {
+                const ArrayMax3d center = 0.5 * (boxes[i].min + boxes[i].max);
+                codes[i] = std::make_pair(
+                    morton_code((center - scene_min) / scene_size), long(i));
+            }
+        });
+    tbb::parallel_sort(codes.begin(), codes.end());
+
+    std::vector<long> leaf_ids(boxes.size());
+    for (size_t i = 0; i < codes.size(); i++) {
+        leaf_ids[i] = codes[i].second;
+    }
+
+    nodes.reserve(2 * boxes.size());
+    build_recursive(boxes, leaf_ids, 0, leaf_ids.size());
+}
+
+int BVHTree::build_recursive(
+    const std::vector<AABB>& boxes,
+    std::vector<long>& leaf_ids,
+    const size_t begin,
+    const size_t end)
+{
+    assert(begin < end);
+
+    const int node_i = int(nodes.size());
+    nodes.emplace_back();
+
+    if (end - begin == 1) {
+        nodes[node_i].box = boxes[leaf_ids[begin]];
+        nodes[node_i].box_id = leaf_ids[begin];
+        return node_i;
+    }
+
+    const size_t mid = begin + (end - begin) / 2;
+    const int left = build_recursive(boxes, leaf_ids, begin, mid);
+    const int right = build_recursive(boxes, leaf_ids, mid, end);
+
+    nodes[node_i].left = left;
+    nodes[node_i].right = right;
+    nodes[node_i].box = AABB(nodes[left].box, nodes[right].box);
+
+    return node_i;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void BVH::build(
+    ConstMatrixXdRef V,
+    const Eigen::MatrixXi& E,
+    const Eigen::MatrixXi& F,
+    double inflation_radius)
+{
+    BroadPhase::build(V, E, F, inflation_radius); // also calls clear()
+    build_trees();
+}
+
+void BVH::build(
+    ConstMatrixXdRef V0,
+    ConstMatrixXdRef V1,
+    const Eigen::MatrixXi& E,
+    const Eigen::MatrixXi& F,
+    double inflation_radius)
+{
+    BroadPhase::build(V0, V1, E, F, inflation_radius); // also calls clear()
+    build_trees();
+}
+
+void BVH::build_trees()
+{
+    StatsTimer timer(m_enable_stats, m_stats.build_time);
+    vertex_tree.build(vertex_boxes);
+    edge_tree.build(edge_boxes);
+    face_tree.build(face_boxes);
+}
+
+template <typename Candidate, bool triangular>
+void BVH::detect_candidates(
+    const std::vector<AABB>& boxes,
+    const BVHTree& tree,
+    const std::function<bool(size_t, size_t)>& can_collide,
+    std::vector<Candidate>& candidates) const
+{
+    tbb::enumerable_thread_specific<std::vector<Candidate>> storage;
+
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(size_t(0), boxes.size()),
+        [&](const tbb::blocked_range<size_t>& r) {
+            auto& local_candidates = storage.local();
+            for (size_t i = r.begin(); i < r.end(); i++) {
+                tree.query(boxes[i], [&](long j) {
+                    if constexpr (triangular) {
+                        // Avoid self-pairs and duplicates (i, j) and (j, i)
+                        if (long(i) >= j) {
+                            return;
+                        }
+                    }
+                    if (can_collide(i, j)) {
+                        local_candidates.emplace_back(i, j);
+                    }
+                });
+            }
+        });
+
+    merge_thread_local_vectors(storage, candidates);
+
+    remap_candidates(candidates);
+}
+
+void BVH::detect_edge_vertex_candidates(
+    std::vector<EdgeVertexCandidate>& candidates) const
+{
+    detect_candidates(
+        edge_boxes, vertex_tree,
+        [&](size_t ei, size_t vi) { return can_edge_vertex_collide(ei, vi); },
+        candidates);
+}
+
+void BVH::detect_edge_edge_candidates(
+    std::vector<EdgeEdgeCandidate>& candidates) const
+{
+    detect_candidates<EdgeEdgeCandidate, /*triangular=*/true>(
+        edge_boxes, edge_tree,
+        [&](size_t eai, size_t ebi) { return can_edges_collide(eai, ebi); },
+        candidates);
+}
+
+void BVH::detect_face_vertex_candidates(
+    std::vector<FaceVertexCandidate>& candidates) const
+{
+    detect_candidates(
+        face_boxes, vertex_tree,
+        [&](size_t fi, size_t vi) { return can_face_vertex_collide(fi, vi); },
+        candidates);
+}
+
+void BVH::detect_edge_face_candidates(
+    std::vector<EdgeFaceCandidate>& candidates) const
+{
+    detect_candidates(
+        edge_boxes, face_tree,
+        [&](size_t ei, size_t fi) { return can_edge_face_collide(ei, fi); },
+        candidates);
+}
+
+} // namespace ipc
@@ -0,0 +1,156 @@
+#pragma once
+
+#include <ipc/broad_phase/broad_phase.hpp>
+#include <ipc/utils/eigen_ext.hpp>
+#include <ipc/utils/memory_usage.hpp>
+
+namespace ipc {
+
+/// @brief A bounding volume hierarchy built over Morton-ordered elements.
+///
+/// Unlike the grid-based broad phases, the BVH adapts to non-uniform element
+/// sizes, so candidate counts stay near-linear on mixed-resolution meshes.
+struct BVHTree {
+    /// @brief Build the tree from a set of boxes.
+    /// @param boxes The leaf boxes of the tree.
+    void build(const std::vector<AABB>& boxes);
+
+    /// @brief Clear the tree.
+    void clear() { nodes.clear(); }
+
+    /// @brief Is the tree empty?
+    bool empty() const { return nodes.empty(); }
+
+    /// @brief Bytes of heap memory held by the nodes (capacity, not size).
+    size_t bytes_used() const { return vector_bytes_used(nodes); }
+
+    /// @brief Call callback with the id of every leaf box intersecting box.
+    /// @param box The query box.
+    /// @param callback Function called once per intersecting leaf box id.
+    template <typename Callback>
+    void query(const AABB& box, const Callback& callback) const
+    {
+        if (nodes.empty()) {
+            return;
+        }
+
+        int stack[64];
+        int stack_size = 0;
+        stack[stack_size++] = 0; // the root is always the first node
+
+        while (stack_size > 0) {
+            const Node& node = nodes[stack[--stack_size]];
+
+            if (!box.intersects(node.box)) {
+                continue;
+            }
+
+            if (node.is_leaf()) {
+                callback(node.box_id);
+            } else {
+                assert(stack_size + 2 <= 64);
+                stack[stack_size++] = node.left;
+                stack[stack_size++] = node.right;
+            }
+        }
+    }
+
+    /// @brief A node of the tree (leaf iff box_id ≥ 0).
+    struct Node {
+        AABB box;
+        int left = -1;
+        int right = -1;
+        long box_id = -1;
+
+        bool is_leaf() const { return box_id >= 0; }
+    };
+
+    std::vector<Node> nodes;
+
+protected:
+    int build_recursive(
+        const std::vector<AABB>& boxes,
+        std::vector<long>& leaf_ids,
+        const size_t begin,
+        const size_t end);
+};
+
+class BVH : public BroadPhase {
+public:
+    /// @brief Build the broad phase for static collision detection.
+    /// @param V0 Positions of the vertices.
+    /// @param E Edges of the mesh.
+    /// @param F Faces of the mesh.
+    /// @param inflation_radius Radius of inflation around all elements.
+    void build(
+        ConstMatrixXdRef V,
+        const Eigen::MatrixXi& E,
+        const Eigen::MatrixXi& F,
+        double inflation_radius = 0) override;
+
+    /// @brief Build the broad phase for continuous collision detection.
+    /// @param V0 Starting positions of the vertices.
+    /// @param V1 Ending positions of the vertices.
+    /// @param E Edges of the mesh.
+    /// @param F Faces of the mesh.
+    /// @param inflation_radius Radius of inflation around all elements.
+    void build(
+        ConstMatrixXdRef V0,
+        ConstMatrixXdRef V1,
+        const Eigen::MatrixXi& E,
+        const Eigen::MatrixXi& F,
+        double inflation_radius = 0) override;
+
+    /// @brief Clear the BVH.
+    void clear() override
+    {
+        BroadPhase::clear();
+        vertex_tree.clear();
+        edge_tree.clear();
+        face_tree.clear();
+    }
+
+    /// @brief Add the three trees to the count.
+    size_t bytes_used() const override
+    {
+        return record_bytes_used(
+            BroadPhase::bytes_used() + vertex_tree.bytes_used()
+            + edge_tree.bytes_used() + face_tree.bytes_used());
+    }
+
+    /// @brief Find the candidate edge-vertex collisisons.
+    /// @param[out] candidates The candidate edge-vertex collisisons.
+    void detect_edge_vertex_candidates(
+        std::vector<EdgeVertexCandidate>& candidates) const override;
+
+    /// @brief Find the candidate edge-edge collisions.
+    /// @param[out] candidates The candidate edge-edge collisisons.
+    void detect_edge_edge_candidates(
+        std::vector<EdgeEdgeCandidate>& candidates) const override;
+
+    /// @brief Find the candidate face-vertex collisions.
+    /// @param[out] candidates The candidate face-vertex collisisons.
+    void detect_face_vertex_candidates(
+        std::vector<FaceVertexCandidate>& candidates) const override;
+
+    /// @brief Find the candidate edge-face intersections.
+    /// @param[out] candidates The candidate edge-face intersections.
+    void detect_edge_face_candidates(
+        std::vector<EdgeFaceCandidate>& candidates) const override;
+
+private:
+    template <typename Candidate, bool triangular = false>
+    void detect_candidates(
+        const std::vector<AABB>& boxes,
+        const BVHTree& tree,
+        const std::function<bool(size_t, size_t)>& can_collide,
+        std::vector<Candidate>& candidates) const;
+
+    void build_trees();
+
+    BVHTree vertex_tree;
+    BVHTree edge_tree;
+    BVHTree face_tree;
+};
+
+} // namespace ipc
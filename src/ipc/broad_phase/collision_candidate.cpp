@@ -1,15 +1,23 @@
 #include "collision_candidate.hpp"
 
+#include <ipc/utils/execution_context.hpp>
+#include <ipc/utils/memory_usage.hpp>
 #include <ipc/utils/save_obj.hpp>
 
+#include <tbb/parallel_for.h>
+#include <tbb/blocked_range.h>
+
 #include <algorithm> // std::min/max
+#include <array>
 #include <iostream>
 #include <fstream>
+#include <limits>
+#include <numeric> // std::iota
 
 namespace ipc {
 
 VertexVertexCandidate::VertexVertexCandidate(
-    long vertex0_index, long vertex1_index)
+    index_t vertex0_index, index_t vertex1_index)
     : vertex0_index(vertex0_index)
     , vertex1_index(vertex1_index)
 {
@@ -31,7 +39,8 @@ bool VertexVertexCandidate::operator<(const VertexVertexCandidate& other) const
 
 ///////////////////////////////////////////////////////////////////////////////
 
-EdgeVertexCandidate::EdgeVertexCandidate(long edge_index, long vertex_index)
+EdgeVertexCandidate::EdgeVertexCandidate(
+    index_t edge_index, index_t vertex_index)
     : edge_index(edge_index)
     , vertex_index(vertex_index)
 {
@@ -51,11 +60,12 @@ bool EdgeVertexCandidate::operator<(const EdgeVertexCandidate& other) const
 }
 
 bool EdgeVertexCandidate::ccd(
-    const Eigen::MatrixXd& V0,
-    const Eigen::MatrixXd& V1,
+    ConstMatrixXdRef V0,
+    ConstMatrixXdRef V1,
     const Eigen::MatrixXi& E,
     const Eigen::MatrixXi& F,
     double& toi,
+    const double min_distance,
     const double tmax,
     const double tolerance,
     const long max_iterations,
@@ -70,12 +80,13 @@ bool EdgeVertexCandidate::ccd(
         V1.row(vertex_index),
         // Edge at t=1
         V1.row(E(edge_index, 0)), V1.row(E(edge_index, 1)), //
-        toi, tmax, tolerance, max_iterations, conservative_rescaling);
+        toi, min_distance, tmax, tolerance, max_iterations,
+        conservative_rescaling);
 }
 
 void EdgeVertexCandidate::print_ccd_query(
-    const Eigen::MatrixXd& V0,
-    const Eigen::MatrixXd& V1,
+    ConstMatrixXdRef V0,
+    ConstMatrixXdRef V1,
     const Eigen::MatrixXi& E,
     const Eigen::MatrixXi& F) const
 {
@@ -90,7 +101,7 @@ void EdgeVertexCandidate::print_ccd_query(
 
 ///////////////////////////////////////////////////////////////////////////////
 
-EdgeEdgeCandidate::EdgeEdgeCandidate(long edge0_index, long edge1_index)
+EdgeEdgeCandidate::EdgeEdgeCandidate(index_t edge0_index, index_t edge1_index)
     : edge0_index(edge0_index)
     , edge1_index(edge1_index)
 {
@@ -117,11 +128,12 @@ bool EdgeEdgeCandidate::operator<(const EdgeEdgeCandidate& other) const
 }
 
 bool EdgeEdgeCandidate::ccd(
-    const Eigen::MatrixXd& V0,
-    const Eigen::MatrixXd& V1,
+    ConstMatrixXdRef V0,
+    ConstMatrixXdRef V1,
     const Eigen::MatrixXi& E,
     const Eigen::MatrixXi& F,
     double& toi,
+    const double min_distance,
     const double tmax,
     const double tolerance,
     const long max_iterations,
@@ -136,12 +148,13 @@ bool EdgeEdgeCandidate::ccd(
         V1.row(E(edge0_index, 0)), V1.row(E(edge0_index, 1)),
         // Edge 2 at t=1
         V1.row(E(edge1_index, 0)), V1.row(E(edge1_index, 1)), //
-        toi, tmax, tolerance, max_iterations, conservative_rescaling);
+        toi, min_distance, tmax, tolerance, max_iterations,
+        conservative_rescaling);
 }
 
 void EdgeEdgeCandidate::print_ccd_query(
-    const Eigen::MatrixXd& V0,
-    const Eigen::MatrixXd& V1,
+    ConstMatrixXdRef V0,
+    ConstMatrixXdRef V1,
     const Eigen::MatrixXi& E,
     const Eigen::MatrixXi& F) const
 {
@@ -158,7 +171,7 @@ void EdgeEdgeCandidate::print_ccd_query(
 
 ///////////////////////////////////////////////////////////////////////////////
 
-EdgeFaceCandidate::EdgeFaceCandidate(long edge_index, long face_index)
+EdgeFaceCandidate::EdgeFaceCandidate(index_t edge_index, index_t face_index)
     : edge_index(edge_index)
     , face_index(face_index)
 {
@@ -179,7 +192,8 @@ bool EdgeFaceCandidate::operator<(const EdgeFaceCandidate& other) const
 
 ///////////////////////////////////////////////////////////////////////////////
 
-FaceVertexCandidate::FaceVertexCandidate(long face_index, long vertex_index)
+FaceVertexCandidate::FaceVertexCandidate(
+    index_t face_index, index_t vertex_index)
     : face_index(face_index)
     , vertex_index(vertex_index)
 {
@@ -199,11 +213,12 @@ bool FaceVertexCandidate::operator<(const FaceVertexCandidate& other) const
 }
 
 bool FaceVertexCandidate::ccd(
-    const Eigen::MatrixXd& V0,
-    const Eigen::MatrixXd& V1,
+    ConstMatrixXdRef V0,
+    ConstMatrixXdRef V1,
     const Eigen::MatrixXi& E,
     const Eigen::MatrixXi& F,
     double& toi,
+    const double min_distance,
     const double tmax,
     const double tolerance,
     const long max_iterations,
@@ -220,12 +235,13 @@ bool FaceVertexCandidate::ccd(
         // Triangle at t=1
         V1.row(F(face_index, 0)), V1.row(F(face_index, 1)),
         V1.row(F(face_index, 2)), //
-        toi, tmax, tolerance, max_iterations, conservative_rescaling);
+        toi, min_distance, tmax, tolerance, max_iterations,
+        conservative_rescaling);
 }
 
 void FaceVertexCandidate::print_ccd_query(
-    const Eigen::MatrixXd& V0,
-    const Eigen::MatrixXd& V1,
+    ConstMatrixXdRef V0,
+    ConstMatrixXdRef V1,
     const Eigen::MatrixXi& E,
     const Eigen::MatrixXi& F) const
 {
@@ -255,11 +271,151 @@ bool Candidates::empty() const
 
 void Candidates::clear()
 {
+    // std::vector::clear() does not free the allocation, so the capacity is
+    // retained for the next step.
     ev_candidates.clear();
     ee_candidates.clear();
     fv_candidates.clear();
 }
 
+void Candidates::reserve(size_t num_ev, size_t num_ee, size_t num_fv)
+{
+    ev_candidates.reserve(num_ev);
+    ee_candidates.reserve(num_ee);
+    fv_candidates.reserve(num_fv);
+}
+
+namespace {
+
+    /// Squared gap between the AABBs of two index sets (zero when the boxes
+    /// overlap). A cheap lower bound on the squared distance between the
+    /// primitives, used only for relative ranking.
+    template <typename IndicesA, typename IndicesB>
+    double aabb_gap_sqr(
+        ConstMatrixXdRef V, const IndicesA& verts_a, const IndicesB& verts_b)
+    {
+        const int dim = V.cols();
+        double gap_sqr = 0;
+        for (int d = 0; d < dim; d++) {
+            double lo_a = std::numeric_limits<double>::infinity(), hi_a = -lo_a;
+            for (const index_t vi : verts_a) {
+                lo_a = std::min(lo_a, V(vi, d));
+                hi_a = std::max(hi_a, V(vi, d));
+            }
+            double lo_b = std::numeric_limits<double>::infinity(), hi_b = -lo_b;
+            for (const index_t vi : verts_b) {
+                lo_b = std::min(lo_b, V(vi, d));
+                hi_b = std::max(hi_b, V(vi, d));
+            }
+            const double gap = std::max(lo_a - hi_b, lo_b - hi_a);
+            if (gap > 0) {
+                gap_sqr += gap * gap;
+            }
+        }
+        return gap_sqr;
+    }
+
+    /// Erase the elements of candidates whose global index (offset by first)
+    /// is not marked in keep, preserving the order of the survivors.
+    template <typename Candidate>
+    void compact_kept(
+        std::vector<Candidate>& candidates,
+        const std::vector<char>& keep,
+        const size_t first)
+    {
+        size_t num_kept = 0;
+        for (size_t i = 0; i < candidates.size(); i++) {
+            if (keep[first + i]) {
+                if (num_kept != i) {
+                    candidates[num_kept] = candidates[i];
+                }
+                num_kept++;
+            }
+        }
+        candidates.resize(num_kept);
+    }
+
+} // namespace
+
+size_t Candidates::reduce_to_worst(
+    ConstMatrixXdRef V,
+    const Eigen::MatrixXi& E,
+    const Eigen::MatrixXi& F,
+    const size_t max_candidates)
+{
+    const size_t num_candidates = size();
+    if (num_candidates <= max_candidates) {
+        return 0;
+    }
+
+    const size_t num_ev = ev_candidates.size();
+    const size_t num_ee = ee_candidates.size();
+
+    std::vector<double> gaps(num_candidates);
+    execution_context().run([&]() {
+        tbb::parallel_for(
+            tbb::blocked_range<size_t>(size_t(0), num_candidates),
+            [&](const tbb::blocked_range<size_t>& r) {
+                for (size_t i = r.begin(); i < r.end(); i++) {
+                    if (i < num_ev) {
+                        const auto& ev = ev_candidates[i];
+                        gaps[i] = aabb_gap_sqr(
+                            V,
+                            std::array<index_t, 2> { { E(ev.edge_index, 0),
+                                                       E(ev.edge_index, 1) } },
+                            std::array<index_t, 1> { { ev.vertex_index } });
+                    } else if (i < num_ev + num_ee) {
+                        const auto& ee = ee_candidates[i - num_ev];
+                        gaps[i] = aabb_gap_sqr(
+                            V,
+                            std::array<index_t, 2> { { E(ee.edge0_index, 0),
+                                                       E(ee.edge0_index, 1) } },
+                            std::array<index_t, 2> {
+                                { E(ee.edge1_index, 0),
+                                  E(ee.edge1_index, 1) } });
+                    } else {
+                        const auto& fv = fv_candidates[i - num_ev - num_ee];
+                        gaps[i] = aabb_gap_sqr(
+                            V,
+                            std::array<index_t, 3> { { F(fv.face_index, 0),
+                                                       F(fv.face_index, 1),
+                                                       F(fv.face_index, 2) } },
+                            std::array<index_t, 1> { { fv.vertex_index } });
+                    }
+                }
+            });
+    });
+
+    // Partition the candidate indices so the max_candidates smallest gaps
+    // (ties broken by index for determinism) come first — O(n), no full sort.
+    std::vector<size_t> order(num_candidates);
+    std::iota(order.begin(), order.end(), size_t(0));
+    std::nth_element(
+        order.begin(), order.begin() + max_candidates, order.end(),
+        [&](const size_t a, const size_t b) {
+            return gaps[a] != gaps[b] ? (gaps[a] < gaps[b]) : (a < b);
+        });
+
+    std::vector<char> keep(num_candidates, false);
+    for (size_t i = 0; i < max_candidates; i++) {
+        keep[order[i]] = true;
+    }
+
+    compact_kept(ev_candidates, keep, 0);
+    compact_kept(ee_candidates, keep, num_ev);
+    compact_kept(fv_candidates, keep, num_ev + num_ee);
+
+    return num_candidates - max_candidates;
+}
+
+size_t Candidates::bytes_used() const
+{
+    const size_t bytes = vector_bytes_used(ev_candidates)
+        + vector_bytes_used(ee_candidates) + vector_bytes_used(fv_candidates);
+    m_peak_bytes_used = std::max(m_peak_bytes_used, bytes);
+    return bytes;
+}
+
 ContinuousCollisionCandidate& Candidates::operator[](size_t idx)
 {
     if (idx < ev_candidates.size()) {
@@ -294,7 +450,7 @@ const ContinuousCollisionCandidate& Candidates::operator[](size_t idx) const
 
 bool Candidates::save_obj(
     const std::string& filename,
-    const Eigen::MatrixXd& V,
+    ConstMatrixXdRef V,
     const Eigen::MatrixXi& E,
     const Eigen::MatrixXi& F) const
 {
@@ -311,4 +467,54 @@ bool Candidates::save_obj(
     return true;
 }
 
+///////////////////////////////////////////////////////////////////////////////
+
+void CandidatesSoA::build(const Candidates& candidates)
+{
+    clear();
+
+    ev_edges.reserve(candidates.ev_candidates.size());
+    ev_vertices.reserve(candidates.ev_candidates.size());
+    for (const auto& ev_candidate : candidates.ev_candidates) {
+        ev_edges.push_back(ev_candidate.edge_index);
+        ev_vertices.push_back(ev_candidate.vertex_index);
+    }
+
+    ee_edges0.reserve(candidates.ee_candidates.size());
+    ee_edges1.reserve(candidates.ee_candidates.size());
+    for (const auto& ee_candidate : candidates.ee_candidates) {
+        ee_edges0.push_back(ee_candidate.edge0_index);
+        ee_edges1.push_back(ee_candidate.edge1_index);
+    }
+
+    fv_faces.reserve(candidates.fv_candidates.size());
+    fv_vertices.reserve(candidates.fv_candidates.size());
+    for (const auto& fv_candidate : candidates.fv_candidates) {
+        fv_faces.push_back(fv_candidate.face_index);
+        fv_vertices.push_back(fv_candidate.vertex_index);
+    }
+}
+
+size_t CandidatesSoA::size() const
+{
+    return ev_edges.size() + ee_edges0.size() + fv_faces.size();
+}
+
+bool CandidatesSoA::empty() const
+{
+    return ev_edges.empty() && ee_edges0.empty() && fv_faces.empty();
+}
+
+void CandidatesSoA::clear()
+{
+    // std::vector::clear() does not free the allocation, so the capacity is
+    // retained for the next step.
+    ev_edges.clear();
+    ev_vertices.clear();
+    ee_edges0.clear();
+    ee_edges1.clear();
+    fv_faces.clear();
+    fv_vertices.clear();
+}
+
 } // namespace ipc
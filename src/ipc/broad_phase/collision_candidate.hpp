@@ -1,6 +1,8 @@
 #pragma once
 
 #include <ipc/ccd/ccd.hpp>
+#include <ipc/utils/eigen_ext.hpp>
+#include <ipc/utils/index.hpp>
 
 #include <Eigen/Core>
 
@@ -18,17 +20,19 @@ struct ContinuousCollisionCandidate {
     /// @param[in] E Mesh edges as rows of indicies into V.
     /// @param[in] F Mesh triangular faces as rows of indicies into V.
     /// @param[out] toi Computed time of impact (normalized).
+    /// @param[in] min_distance Minimum separation distance between primitives.
     /// @param[in] tmax Maximum time (normalized) to look for collisions. Should be in [0, 1].
     /// @param[in] tolerance CCD tolerance used by Tight-Inclusion CCD.
     /// @param[in] max_iterations Maximum iterations used by Tight-Inclusion CCD.
     /// @param[in] conservative_rescaling Conservative rescaling value used to avoid taking steps exactly to impact.
     /// @return If the candidate had a collision over the time interval.
     virtual bool
-    ccd(const Eigen::MatrixXd& V0,
-        const Eigen::MatrixXd& V1,
+    ccd(ConstMatrixXdRef V0,
+        ConstMatrixXdRef V1,
         const Eigen::MatrixXi& E,
         const Eigen::MatrixXi& F,
         double& toi,
+        const double min_distance = 0.0,
         const double tmax = 1.0,
         const double tolerance = DEFAULT_CCD_TOLERANCE,
         const long max_iterations = DEFAULT_CCD_MAX_ITERATIONS,
@@ -37,14 +41,15 @@ struct ContinuousCollisionCandidate {
 
     // Print the vertices of the CCD query for debugging.
     virtual void print_ccd_query(
-        const Eigen::MatrixXd& V0,
-        const Eigen::MatrixXd& V1,
+        ConstMatrixXdRef V0,
+        ConstMatrixXdRef V1,
         const Eigen::MatrixXi& E,
         const Eigen::MatrixXi& F) const = 0;
 };
 
 struct VertexVertexCandidate {
-    VertexVertexCandidate(long vertex0_index, long vertex1_index);
+    VertexVertexCandidate() = default;
+    VertexVertexCandidate(index_t vertex0_index, index_t vertex1_index);
 
     bool operator==(const VertexVertexCandidate& other) const;
     bool operator!=(const VertexVertexCandidate& other) const
@@ -55,12 +60,13 @@ struct VertexVertexCandidate {
     /// @brief Compare EdgeVertexCandidates for sorting.
     bool operator<(const VertexVertexCandidate& other) const;
 
-    long vertex0_index;
-    long vertex1_index;
+    index_t vertex0_index;
+    index_t vertex1_index;
 };
 
 struct EdgeVertexCandidate : ContinuousCollisionCandidate {
-    EdgeVertexCandidate(long edge_index, long vertex_index);
+    EdgeVertexCandidate() = default;
+    EdgeVertexCandidate(index_t edge_index, index_t vertex_index);
 
     bool operator==(const EdgeVertexCandidate& other) const;
     bool operator!=(const EdgeVertexCandidate& other) const
@@ -77,17 +83,19 @@ struct EdgeVertexCandidate : ContinuousCollisionCandidate {
     /// @param[in] E Mesh edges as rows of indicies into V.
     /// @param[in] F Mesh triangular faces as rows of indicies into V.
     /// @param[out] toi Computed time of impact (normalized).
+    /// @param[in] min_distance Minimum separation distance between primitives.
     /// @param[in] tmax Maximum time (normalized) to look for collisions. Should be in [0, 1].
     /// @param[in] tolerance CCD tolerance used by Tight-Inclusion CCD.
     /// @param[in] max_iterations Maximum iterations used by Tight-Inclusion CCD.
     /// @param[in] conservative_rescaling Conservative rescaling value used to avoid taking steps exactly to impact.
     /// @return If the candidate had a collision over the time interval.
     bool
-    ccd(const Eigen::MatrixXd& V0,
-        const Eigen::MatrixXd& V1,
+    ccd(ConstMatrixXdRef V0,
+        ConstMatrixXdRef V1,
         const Eigen::MatrixXi& E,
         const Eigen::MatrixXi& F,
         double& toi,
+        const double min_distance = 0.0,
         const double tmax = 1.0,
         const double tolerance = DEFAULT_CCD_TOLERANCE,
         const long max_iterations = DEFAULT_CCD_MAX_ITERATIONS,
@@ -95,17 +103,18 @@ struct EdgeVertexCandidate : ContinuousCollisionCandidate {
             DEFAULT_CCD_CONSERVATIVE_RESCALING) const override;
 
     void print_ccd_query(
-        const Eigen::MatrixXd& V0,
-        const Eigen::MatrixXd& V1,
+        ConstMatrixXdRef V0,
+        ConstMatrixXdRef V1,
         const Eigen::MatrixXi& E,
         const Eigen::MatrixXi& F) const override;
 
-    long edge_index;
-    long vertex_index;
+    index_t edge_index;
+    index_t vertex_index;
 };
 
 struct EdgeEdgeCandidate : ContinuousCollisionCandidate {
-    EdgeEdgeCandidate(long edge0_index, long edge1_index);
+    EdgeEdgeCandidate() = default;
+    EdgeEdgeCandidate(index_t edge0_index, index_t edge1_index);
 
     bool operator==(const EdgeEdgeCandidate& other) const;
     bool operator!=(const EdgeEdgeCandidate& other) const
@@ -122,17 +131,19 @@ struct EdgeEdgeCandidate : ContinuousCollisionCandidate {
     /// @param[in] E Mesh edges as rows of indicies into V.
     /// @param[in] F Mesh triangular faces as rows of indicies into V.
     /// @param[out] toi Computed time of impact (normalized).
+    /// @param[in] min_distance Minimum separation distance between primitives.
     /// @param[in] tmax Maximum time (normalized) to look for collisions. Should be in [0, 1].
     /// @param[in] tolerance CCD tolerance used by Tight-Inclusion CCD.
     /// @param[in] max_iterations Maximum iterations used by Tight-Inclusion CCD.
     /// @param[in] conservative_rescaling Conservative rescaling value used to avoid taking steps exactly to impact.
     /// @return If the candidate had a collision over the time interval.
     bool
-    ccd(const Eigen::MatrixXd& V0,
-        const Eigen::MatrixXd& V1,
+    ccd(ConstMatrixXdRef V0,
+        ConstMatrixXdRef V1,
         const Eigen::MatrixXi& E,
         const Eigen::MatrixXi& F,
         double& toi,
+        const double min_distance = 0.0,
         const double tmax = 1.0,
         const double tolerance = DEFAULT_CCD_TOLERANCE,
         const long max_iterations = DEFAULT_CCD_MAX_ITERATIONS,
@@ -140,20 +151,21 @@ struct EdgeEdgeCandidate : ContinuousCollisionCandidate {
             DEFAULT_CCD_CONSERVATIVE_RESCALING) const override;
 
     void print_ccd_query(
-        const Eigen::MatrixXd& V0,
-        const Eigen::MatrixXd& V1,
+        ConstMatrixXdRef V0,
+        ConstMatrixXdRef V1,
         const Eigen::MatrixXi& E,
         const Eigen::MatrixXi& F) const override;
 
-    long edge0_index;
-    long edge1_index;
+    index_t edge0_index;
+    index_t edge1_index;
 };
 
 /// @brief Candidate for <b>intersection</b> between edge and face.
 ///
 /// Not included in Candidates because it is not a collision candidate.
 struct EdgeFaceCandidate {
-    EdgeFaceCandidate(long edge_index, long face_index);
+    EdgeFaceCandidate() = default;
+    EdgeFaceCandidate(index_t edge_index, index_t face_index);
 
     bool operator==(const EdgeFaceCandidate& other) const;
     bool operator!=(const EdgeFaceCandidate& other) const
@@ -164,12 +176,13 @@ struct EdgeFaceCandidate {
     /// @brief Compare EdgeFaceCandidate for sorting.
     bool operator<(const EdgeFaceCandidate& other) const;
 
-    long edge_index;
-    long face_index;
+    index_t edge_index;
+    index_t face_index;
 };
 
 struct FaceVertexCandidate : ContinuousCollisionCandidate {
-    FaceVertexCandidate(long face_index, long vertex_index);
+    FaceVertexCandidate() = default;
+    FaceVertexCandidate(index_t face_index, index_t vertex_index);
 
     bool operator==(const FaceVertexCandidate& other) const;
     bool operator!=(const FaceVertexCandidate& other) const
@@ -181,11 +194,12 @@ struct FaceVertexCandidate : ContinuousCollisionCandidate {
     bool operator<(const FaceVertexCandidate& other) const;
 
     bool
-    ccd(const Eigen::MatrixXd& V0,
-        const Eigen::MatrixXd& V1,
+    ccd(ConstMatrixXdRef V0,
+        ConstMatrixXdRef V1,
         const Eigen::MatrixXi& E,
         const Eigen::MatrixXi& F,
         double& toi,
+        const double min_distance = 0.0,
         const double tmax = 1.0,
         const double tolerance = DEFAULT_CCD_TOLERANCE,
         const long max_iterations = DEFAULT_CCD_MAX_ITERATIONS,
@@ -193,13 +207,13 @@ struct FaceVertexCandidate : ContinuousCollisionCandidate {
             DEFAULT_CCD_CONSERVATIVE_RESCALING) const override;
 
     void print_ccd_query(
-        const Eigen::MatrixXd& V0,
-        const Eigen::MatrixXd& V1,
+        ConstMatrixXdRef V0,
+        ConstMatrixXdRef V1,
         const Eigen::MatrixXi& E,
         const Eigen::MatrixXi& F) const override;
 
-    long face_index;
-    long vertex_index;
+    index_t face_index;
+    index_t vertex_index;
 };
 
 struct Candidates {
@@ -213,16 +227,86 @@ struct Candidates {
 
     bool empty() const;
 
+    /// @brief Remove all candidates, but keep the allocated capacity so a
+    /// reused Candidates does not reallocate every step.
     void clear();
 
+    /// @brief Reserve capacity for each candidate type.
+    void reserve(size_t num_ev, size_t num_ee, size_t num_fv);
+
+    /// @brief Keep only the max_candidates most severe candidates.
+    ///
+    /// Severity is ranked by a cheap proxy — the squared gap between the two
+    /// primitives' AABBs (zero when the boxes overlap) — so the candidates
+    /// most likely to produce active constraints survive. Pathological
+    /// frames can emit tens of millions of candidates; truncating to a
+    /// budget bounds the narrow-phase memory and latency at the cost of
+    /// possibly missing contacts beyond the budget (see
+    /// Constraints::candidate_budget). The surviving candidates keep their
+    /// original order. No-op when already within budget.
+    /// @param V Vertices of the collision mesh.
+    /// @param E Edges of the collision mesh.
+    /// @param F Faces of the collision mesh.
+    /// @param max_candidates Number of candidates to keep.
+    /// @return The number of candidates dropped.
+    size_t reduce_to_worst(
+        ConstMatrixXdRef V,
+        const Eigen::MatrixXi& E,
+        const Eigen::MatrixXi& F,
+        const size_t max_candidates);
+
+    /// @brief Bytes of heap memory held by the candidate vectors.
+    ///
+    /// Counts capacity, not only the used size, and updates
+    /// peak_bytes_used().
+    size_t bytes_used() const;
+
+    /// @brief Largest value bytes_used() has returned on this object.
+    /// The peak persists across clear(), so it can flag candidate blowups
+    /// after the fact.
+    size_t peak_bytes_used() const { return m_peak_bytes_used; }
+
     ContinuousCollisionCandidate& operator[](size_t idx);
     const ContinuousCollisionCandidate& operator[](size_t idx) const;
 
     bool save_obj(
         const std::string& filename,
-        const Eigen::MatrixXd& V,
+        ConstMatrixXdRef V,
         const Eigen::MatrixXi& E,
         const Eigen::MatrixXi& F) const;
+
+protected:
+    /// @brief Peak of bytes_used() (see peak_bytes_used()).
+    mutable size_t m_peak_bytes_used = 0;
+};
+
+/// @brief Structure-of-arrays copy of a Candidates set.
+///
+/// Each candidate type's two indices are stored in separate contiguous
+/// arrays so the narrow phase can stream one index sequence with unit-stride
+/// loads instead of striding over two-index structs. The arrays retain their
+/// capacity across build() calls, so one instance can be reused every step
+/// without reallocating.
+struct CandidatesSoA {
+    std::vector<index_t> ev_edges; ///< @brief Edge index of each EV candidate.
+    std::vector<index_t> ev_vertices; ///< @brief Vertex of each EV candidate.
+    std::vector<index_t> ee_edges0; ///< @brief First edge of each EE candidate.
+    /// @brief Second edge of each EE candidate.
+    std::vector<index_t> ee_edges1;
+    std::vector<index_t> fv_faces; ///< @brief Face index of each FV candidate.
+    std::vector<index_t> fv_vertices; ///< @brief Vertex of each FV candidate.
+
+    CandidatesSoA() { }
+
+    /// @brief Fill the index arrays from a Candidates set.
+    void build(const Candidates& candidates);
+
+    size_t size() const;
+
+    bool empty() const;
+
+    /// @brief Remove all indices, but keep the allocated capacity.
+    void clear();
 };
 
 } // namespace ipc
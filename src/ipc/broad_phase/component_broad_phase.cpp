@@ -0,0 +1,498 @@
+#include "component_broad_phase.hpp"
+
+#include <ipc/utils/memory_usage.hpp>
+#include <ipc/utils/profiler.hpp>
+
+#include <algorithm> // std::min/max
+#include <numeric>   // std::iota
+
+namespace ipc {
+
+ComponentBroadPhase::ComponentBroadPhase(const BroadPhaseMethod method)
+    : m_method(method)
+{
+}
+
+void ComponentBroadPhase::compute_components(
+    const long num_vertices, const Eigen::MatrixXi& E, const Eigen::MatrixXi& F)
+{
+    // Union-find over the elements.
+    std::vector<int> parent(num_vertices);
+    std::iota(parent.begin(), parent.end(), 0);
+    std::vector<bool> has_element(num_vertices, false);
+
+    const auto find = [&](int vi) {
+        while (parent[vi] != vi) {
+            parent[vi] = parent[parent[vi]]; // Path halving.
+            vi = parent[vi];
+        }
+        return vi;
+    };
+    const auto unite = [&](const int vi, const int vj) {
+        has_element[vi] = has_element[vj] = true;
+        parent[find(vj)] = find(vi);
+    };
+
+    for (long ei = 0; ei < E.rows(); ei++) {
+        unite(E(ei, 0), E(ei, 1));
+    }
+    for (long fi = 0; fi < F.rows(); fi++) {
+        unite(F(fi, 0), F(fi, 1));
+        unite(F(fi, 0), F(fi, 2));
+    }
+
+    // Number the components; all element-less vertices share one trailing
+    // component, since they have no structure of their own to build and only
+    // ever appear on the vertex side of the cross-component queries.
+    m_num_components = 0;
+    std::vector<int> component_of_root(num_vertices, -1);
+    m_vertex_component.resize(num_vertices);
+    long num_free_vertices = 0;
+    for (long vi = 0; vi < num_vertices; vi++) {
+        if (!has_element[vi]) {
+            m_vertex_component[vi] = -1; // Numbered below.
+            num_free_vertices++;
+            continue;
+        }
+        const int root = find(vi);
+        if (component_of_root[root] < 0) {
+            component_of_root[root] = m_num_components++;
+        }
+        m_vertex_component[vi] = component_of_root[root];
+    }
+    if (num_free_vertices > 0) {
+        const int free_component = m_num_components++;
+        for (long vi = 0; vi < num_vertices; vi++) {
+            if (m_vertex_component[vi] < 0) {
+                m_vertex_component[vi] = free_component;
+            }
+        }
+    }
+
+    // Compact each component's vertices and record the local-to-mesh maps.
+    m_component_vertex_ids.assign(m_num_components, {});
+    std::vector<int> local_vertex_id(num_vertices);
+    for (long vi = 0; vi < num_vertices; vi++) {
+        std::vector<long>& ids = m_component_vertex_ids[m_vertex_component[vi]];
+        local_vertex_id[vi] = int(ids.size());
+        ids.push_back(vi);
+    }
+
+    m_component_edge_ids.assign(m_num_components, {});
+    m_component_face_ids.assign(m_num_components, {});
+    for (long ei = 0; ei < E.rows(); ei++) {
+        m_component_edge_ids[m_vertex_component[E(ei, 0)]].push_back(ei);
+    }
+    for (long fi = 0; fi < F.rows(); fi++) {
+        m_component_face_ids[m_vertex_component[F(fi, 0)]].push_back(fi);
+    }
+
+    // Rewrite each component's elements in its local vertex ids.
+    m_component_edges.assign(m_num_components, Eigen::MatrixXi());
+    m_component_faces.assign(m_num_components, Eigen::MatrixXi());
+    for (long ci = 0; ci < m_num_components; ci++) {
+        Eigen::MatrixXi& E_c = m_component_edges[ci];
+        E_c.resize(m_component_edge_ids[ci].size(), E.cols());
+        for (long i = 0; i < E_c.rows(); i++) {
+            const long ei = m_component_edge_ids[ci][i];
+            for (long j = 0; j < E.cols(); j++) {
+                E_c(i, j) = local_vertex_id[E(ei, j)];
+            }
+        }
+
+        Eigen::MatrixXi& F_c = m_component_faces[ci];
+        F_c.resize(m_component_face_ids[ci].size(), F.cols());
+        for (long i = 0; i < F_c.rows(); i++) {
+            const long fi = m_component_face_ids[ci][i];
+            for (long j = 0; j < F.cols(); j++) {
+                F_c(i, j) = local_vertex_id[F(fi, j)];
+            }
+        }
+    }
+
+    // One inner structure per component with elements. The inners index in
+    // local ids, so no collision filters are forwarded to them; the filters
+    // are applied to the remapped candidates instead.
+    m_component_broad_phases.clear();
+    m_component_broad_phases.resize(m_num_components);
+    for (long ci = 0; ci < m_num_components; ci++) {
+        if (m_component_edge_ids[ci].empty()
+            && m_component_face_ids[ci].empty()) {
+            continue;
+        }
+        m_component_broad_phases[ci] = BroadPhase::make_broad_phase(m_method);
+        m_component_broad_phases[ci]->set_morton_ordering(
+            m_inner_morton_ordering);
+        m_component_broad_phases[ci]->set_active_zones(
+            m_active_zones, m_active_zone_fallback_period);
+    }
+
+    m_component_vertices_t0.resize(m_num_components);
+    m_component_vertices_t1.resize(m_num_components);
+}
+
+void ComponentBroadPhase::build(
+    ConstMatrixXdRef V,
+    const Eigen::MatrixXi& E,
+    const Eigen::MatrixXi& F,
+    double inflation_radius)
+{
+    IPC_PROFILE_SCOPE("ComponentBroadPhase::build");
+
+    assert(E.size() == 0 || E.cols() == 2);
+    assert(F.size() == 0 || F.cols() == 3);
+
+    if (m_num_components == 0 || m_vertex_component.size() != size_t(V.rows())
+        || m_edges.rows() != E.rows() || m_faces.rows() != F.rows()) {
+        compute_components(V.rows(), E, F);
+    }
+    m_edges = E;
+    m_faces = F;
+    m_inflation_radius = inflation_radius;
+
+    // Mesh-order boxes of every element for the cross-component queries.
+    build_vertex_boxes(V, vertex_boxes, inflation_radius);
+    build_edge_boxes(vertex_boxes, E, edge_boxes);
+    build_face_boxes(vertex_boxes, F, face_boxes);
+
+    for (long ci = 0; ci < m_num_components; ci++) {
+        if (m_component_broad_phases[ci] == nullptr) {
+            continue;
+        }
+        Eigen::MatrixXd& V_c = m_component_vertices_t0[ci];
+        V_c.resize(m_component_vertex_ids[ci].size(), V.cols());
+        for (long i = 0; i < V_c.rows(); i++) {
+            V_c.row(i) = V.row(m_component_vertex_ids[ci][i]);
+        }
+        m_component_broad_phases[ci]->build(
+            V_c, m_component_edges[ci], m_component_faces[ci],
+            inflation_radius);
+    }
+
+    find_overlapping_components();
+}
+
+void ComponentBroadPhase::build(
+    ConstMatrixXdRef V0,
+    ConstMatrixXdRef V1,
+    const Eigen::MatrixXi& E,
+    const Eigen::MatrixXi& F,
+    double inflation_radius)
+{
+    IPC_PROFILE_SCOPE("ComponentBroadPhase::build");
+
+    assert(E.size() == 0 || E.cols() == 2);
+    assert(F.size() == 0 || F.cols() == 3);
+
+    if (m_num_components == 0 || m_vertex_component.size() != size_t(V0.rows())
+        || m_edges.rows() != E.rows() || m_faces.rows() != F.rows()) {
+        compute_components(V0.rows(), E, F);
+    }
+    m_edges = E;
+    m_faces = F;
+    m_inflation_radius = inflation_radius;
+
+    build_vertex_boxes(V0, V1, vertex_boxes, inflation_radius);
+    build_edge_boxes(vertex_boxes, E, edge_boxes);
+    build_face_boxes(vertex_boxes, F, face_boxes);
+
+    for (long ci = 0; ci < m_num_components; ci++) {
+        if (m_component_broad_phases[ci] == nullptr) {
+            continue;
+        }
+        Eigen::MatrixXd& V0_c = m_component_vertices_t0[ci];
+        Eigen::MatrixXd& V1_c = m_component_vertices_t1[ci];
+        V0_c.resize(m_component_vertex_ids[ci].size(), V0.cols());
+        V1_c.resize(m_component_vertex_ids[ci].size(), V1.cols());
+        for (long i = 0; i < V0_c.rows(); i++) {
+            V0_c.row(i) = V0.row(m_component_vertex_ids[ci][i]);
+            V1_c.row(i) = V1.row(m_component_vertex_ids[ci][i]);
+        }
+        m_component_broad_phases[ci]->build(
+            V0_c, V1_c, m_component_edges[ci], m_component_faces[ci],
+            inflation_radius);
+    }
+
+    find_overlapping_components();
+}
+
+void ComponentBroadPhase::find_overlapping_components()
+{
+    m_component_boxes.clear();
+    m_component_boxes.reserve(m_num_components);
+    for (long ci = 0; ci < m_num_components; ci++) {
+        const std::vector<long>& ids = m_component_vertex_ids[ci];
+        AABB box = vertex_boxes[ids[0]];
+        for (size_t i = 1; i < ids.size(); i++) {
+            box = AABB(box, vertex_boxes[ids[i]]);
+        }
+        m_component_boxes.push_back(box);
+    }
+
+    // The pairwise pretest is quadratic in the number of components, which
+    // is orders of magnitude smaller than the number of elements.
+    m_overlapping_components.clear();
+    for (long ci = 0; ci < m_num_components; ci++) {
+        for (long cj = ci + 1; cj < m_num_components; cj++) {
+            if (m_component_boxes[ci].intersects(m_component_boxes[cj])) {
+                m_overlapping_components.emplace_back(ci, cj);
+            }
+        }
+    }
+}
+
+void ComponentBroadPhase::gather_vertex_boxes(const long ci) const
+{
+    m_scratch_boxes.clear();
+    m_scratch_boxes.reserve(m_component_vertex_ids[ci].size());
+    for (const long vi : m_component_vertex_ids[ci]) {
+        m_scratch_boxes.push_back(vertex_boxes[vi]);
+    }
+}
+
+void ComponentBroadPhase::gather_edge_boxes(const long ci) const
+{
+    m_scratch_boxes.clear();
+    m_scratch_boxes.reserve(m_component_edge_ids[ci].size());
+    for (const long ei : m_component_edge_ids[ci]) {
+        m_scratch_boxes.push_back(edge_boxes[ei]);
+    }
+}
+
+void ComponentBroadPhase::detect_edge_vertex_candidates(
+    std::vector<EdgeVertexCandidate>& candidates) const
+{
+    candidates.clear();
+
+    // Within-component candidates from the inner structures, remapped to
+    // mesh ids and filtered (the inners index in local ids and hold no
+    // filters).
+    std::vector<EdgeVertexCandidate> local_candidates;
+    for (long ci = 0; ci < m_num_components; ci++) {
+        if (m_component_broad_phases[ci] == nullptr) {
+            continue;
+        }
+        local_candidates.clear(); // The inners append.
+        m_component_broad_phases[ci]->detect_edge_vertex_candidates(
+            local_candidates);
+        for (const EdgeVertexCandidate& candidate : local_candidates) {
+            const long ei = m_component_edge_ids[ci][candidate.edge_index];
+            const long vi = m_component_vertex_ids[ci][candidate.vertex_index];
+            if (can_edge_vertex_collide(ei, vi)) {
+                candidates.emplace_back(ei, vi);
+            }
+        }
+    }
+
+    // Cross-component candidates: each side's vertex boxes against the other
+    // side's edges.
+    for (const auto& [ci, cj] : m_overlapping_components) {
+        for (const auto& [ca, cb] : { std::make_pair(ci, cj),
+                                      std::make_pair(cj, ci) }) {
+            if (m_component_broad_phases[cb] == nullptr
+                || m_component_edge_ids[cb].empty()) {
+                continue;
+            }
+            gather_vertex_boxes(ca);
+            m_component_broad_phases[cb]->query_boxes(
+                m_scratch_boxes, m_scratch_result);
+            for (size_t i = 0; i < m_scratch_boxes.size(); i++) {
+                const long vi = m_component_vertex_ids[ca][i];
+                for (long k = m_scratch_result.edge_offsets[i];
+                     k < m_scratch_result.edge_offsets[i + 1]; k++) {
+                    const long ei = m_component_edge_ids
+                        [cb][m_scratch_result.edge_ids[k]];
+                    if (can_edge_vertex_collide(ei, vi)) {
+                        candidates.emplace_back(ei, vi);
+                    }
+                }
+            }
+        }
+    }
+}
+
+void ComponentBroadPhase::detect_edge_edge_candidates(
+    std::vector<EdgeEdgeCandidate>& candidates) const
+{
+    candidates.clear();
+
+    std::vector<EdgeEdgeCandidate> local_candidates;
+    for (long ci = 0; ci < m_num_components; ci++) {
+        if (m_component_broad_phases[ci] == nullptr) {
+            continue;
+        }
+        local_candidates.clear(); // The inners append.
+        m_component_broad_phases[ci]->detect_edge_edge_candidates(
+            local_candidates);
+        for (const EdgeEdgeCandidate& candidate : local_candidates) {
+            const long eai = m_component_edge_ids[ci][candidate.edge0_index];
+            const long ebi = m_component_edge_ids[ci][candidate.edge1_index];
+            if (can_edges_collide(eai, ebi)) {
+                candidates.emplace_back(eai, ebi);
+            }
+        }
+    }
+
+    // Cross-component candidates: one direction suffices since each pair is
+    // normalized on emission.
+    for (const auto& [ci, cj] : m_overlapping_components) {
+        if (m_component_broad_phases[cj] == nullptr
+            || m_component_edge_ids[cj].empty()
+            || m_component_edge_ids[ci].empty()) {
+            continue;
+        }
+        gather_edge_boxes(ci);
+        m_component_broad_phases[cj]->query_boxes(
+            m_scratch_boxes, m_scratch_result);
+        for (size_t i = 0; i < m_scratch_boxes.size(); i++) {
+            const long eai = m_component_edge_ids[ci][i];
+            for (long k = m_scratch_result.edge_offsets[i];
+                 k < m_scratch_result.edge_offsets[i + 1]; k++) {
+                const long ebi =
+                    m_component_edge_ids[cj][m_scratch_result.edge_ids[k]];
+                if (can_edges_collide(eai, ebi)) {
+                    candidates.emplace_back(
+                        std::min(eai, ebi), std::max(eai, ebi));
+                }
+            }
+        }
+    }
+}
+
+void ComponentBroadPhase::detect_face_vertex_candidates(
+    std::vector<FaceVertexCandidate>& candidates) const
+{
+    candidates.clear();
+
+    std::vector<FaceVertexCandidate> local_candidates;
+    for (long ci = 0; ci < m_num_components; ci++) {
+        if (m_component_broad_phases[ci] == nullptr) {
+            continue;
+        }
+        local_candidates.clear(); // The inners append.
+        m_component_broad_phases[ci]->detect_face_vertex_candidates(
+            local_candidates);
+        for (const FaceVertexCandidate& candidate : local_candidates) {
+            const long fi = m_component_face_ids[ci][candidate.face_index];
+            const long vi = m_component_vertex_ids[ci][candidate.vertex_index];
+            if (can_face_vertex_collide(fi, vi)) {
+                candidates.emplace_back(fi, vi);
+            }
+        }
+    }
+
+    for (const auto& [ci, cj] : m_overlapping_components) {
+        for (const auto& [ca, cb] : { std::make_pair(ci, cj),
+                                      std::make_pair(cj, ci) }) {
+            if (m_component_broad_phases[cb] == nullptr
+                || m_component_face_ids[cb].empty()) {
+                continue;
+            }
+            gather_vertex_boxes(ca);
+            m_component_broad_phases[cb]->query_boxes(
+                m_scratch_boxes, m_scratch_result);
+            for (size_t i = 0; i < m_scratch_boxes.size(); i++) {
+                const long vi = m_component_vertex_ids[ca][i];
+                for (long k = m_scratch_result.face_offsets[i];
+                     k < m_scratch_result.face_offsets[i + 1]; k++) {
+                    const long fi = m_component_face_ids
+                        [cb][m_scratch_result.face_ids[k]];
+                    if (can_face_vertex_collide(fi, vi)) {
+                        candidates.emplace_back(fi, vi);
+                    }
+                }
+            }
+        }
+    }
+}
+
+void ComponentBroadPhase::detect_edge_face_candidates(
+    std::vector<EdgeFaceCandidate>& candidates) const
+{
+    candidates.clear();
+
+    std::vector<EdgeFaceCandidate> local_candidates;
+    for (long ci = 0; ci < m_num_components; ci++) {
+        if (m_component_broad_phases[ci] == nullptr) {
+            continue;
+        }
+        local_candidates.clear(); // The inners append.
+        m_component_broad_phases[ci]->detect_edge_face_candidates(
+            local_candidates);
+        for (const EdgeFaceCandidate& candidate : local_candidates) {
+            const long ei = m_component_edge_ids[ci][candidate.edge_index];
+            const long fi = m_component_face_ids[ci][candidate.face_index];
+            if (can_edge_face_collide(ei, fi)) {
+                candidates.emplace_back(ei, fi);
+            }
+        }
+    }
+
+    // Cross-component candidates: each side's edge boxes against the other
+    // side's faces.
+    for (const auto& [ci, cj] : m_overlapping_components) {
+        for (const auto& [ca, cb] : { std::make_pair(ci, cj),
+                                      std::make_pair(cj, ci) }) {
+            if (m_component_broad_phases[cb] == nullptr
+                || m_component_face_ids[cb].empty()
+                || m_component_edge_ids[ca].empty()) {
+                continue;
+            }
+            gather_edge_boxes(ca);
+            m_component_broad_phases[cb]->query_boxes(
+                m_scratch_boxes, m_scratch_result);
+            for (size_t i = 0; i < m_scratch_boxes.size(); i++) {
+                const long ei = m_component_edge_ids[ca][i];
+                for (long k = m_scratch_result.face_offsets[i];
+                     k < m_scratch_result.face_offsets[i + 1]; k++) {
+                    const long fi = m_component_face_ids
+                        [cb][m_scratch_result.face_ids[k]];
+                    if (can_edge_face_collide(ei, fi)) {
+                        candidates.emplace_back(ei, fi);
+                    }
+                }
+            }
+        }
+    }
+}
+
+void ComponentBroadPhase::clear()
+{
+    BroadPhase::clear();
+    m_component_broad_phases.clear();
+    m_num_components = 0;
+    m_vertex_component.clear();
+    m_component_vertex_ids.clear();
+    m_component_edge_ids.clear();
+    m_component_face_ids.clear();
+    m_component_edges.clear();
+    m_component_faces.clear();
+    m_component_boxes.clear();
+    m_overlapping_components.clear();
+    m_component_vertices_t0.clear();
+    m_component_vertices_t1.clear();
+}
+
+size_t ComponentBroadPhase::bytes_used() const
+{
+    size_t bytes = BroadPhase::bytes_used()
+        + vector_bytes_used(m_vertex_component)
+        + vector_bytes_used(m_component_boxes)
+        + vector_bytes_used(m_overlapping_components)
+        + vector_bytes_used(m_scratch_boxes);
+    for (long ci = 0; ci < m_num_components; ci++) {
+        if (m_component_broad_phases[ci] != nullptr) {
+            bytes += m_component_broad_phases[ci]->bytes_used();
+        }
+        bytes += vector_bytes_used(m_component_vertex_ids[ci])
+            + vector_bytes_used(m_component_edge_ids[ci])
+            + vector_bytes_used(m_component_face_ids[ci])
+            + matrix_bytes_used(m_component_edges[ci])
+            + matrix_bytes_used(m_component_faces[ci])
+            + matrix_bytes_used(m_component_vertices_t0[ci])
+            + matrix_bytes_used(m_component_vertices_t1[ci]);
+    }
+    return record_bytes_used(bytes);
+}
+
+} // namespace ipc
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <ipc/broad_phase/broad_phase.hpp>
+#include <ipc/utils/eigen_ext.hpp>
+
+#include <memory>
+#include <vector>
+
+namespace ipc {
+
+/// @brief Broad phase partitioned by connected component.
+///
+/// One global acceleration structure over a scene of many well-separated
+/// bodies makes its resolution a compromise between the bodies and wastes
+/// query time on pairs that cannot overlap. This composite derives the
+/// connected components of the mesh (by union-find over the edges and
+/// faces), builds one inner broad phase per component over its own compacted
+/// vertices — so every structure is sized to its body — and finds
+/// cross-component pairs by first testing the component bounding boxes
+/// against each other, only querying structure against structure for the
+/// component pairs whose boxes overlap.
+///
+/// Vertices that belong to no element are grouped into one shared component
+/// without an inner structure; their candidates against the bodies come from
+/// the cross-component queries. The partition is recomputed only when the
+/// mesh topology changes.
+class ComponentBroadPhase : public BroadPhase {
+public:
+    /// @brief Construct the composite.
+    /// @param method Method used for each component's inner structure.
+    ComponentBroadPhase(
+        const BroadPhaseMethod method = BroadPhaseMethod::HASH_GRID);
+
+    void build(
+        ConstMatrixXdRef V,
+        const Eigen::MatrixXi& E,
+        const Eigen::MatrixXi& F,
+        double inflation_radius = 0) override;
+
+    void build(
+        ConstMatrixXdRef V0,
+        ConstMatrixXdRef V1,
+        const Eigen::MatrixXi& E,
+        const Eigen::MatrixXi& F,
+        double inflation_radius = 0) override;
+
+    void set_morton_ordering(const bool use_morton_ordering) override
+    {
+        // The composite's own boxes stay in mesh order; the ordering only
+        // affects the inner structures.
+        m_inner_morton_ordering = use_morton_ordering;
+        for (const auto& broad_phase : m_component_broad_phases) {
+            if (broad_phase != nullptr) {
+                broad_phase->set_morton_ordering(use_morton_ordering);
+            }
+        }
+    }
+
+    void set_active_zones(
+        const std::vector<AABB>& zones, const int fallback_period = 8) override
+    {
+        // Remember the zones for inner structures created later and forward
+        // them to the existing ones. The composite's own mesh-order boxes
+        // and the cross-component queries stay full-scene, which only keeps
+        // extra candidates.
+        BroadPhase::set_active_zones(zones, fallback_period);
+        for (const auto& broad_phase : m_component_broad_phases) {
+            if (broad_phase != nullptr) {
+                broad_phase->set_active_zones(zones, fallback_period);
+            }
+        }
+    }
+
+    void clear() override;
+
+    size_t bytes_used() const override;
+
+    /// @brief Number of connected components of the last built mesh.
+    long num_components() const { return m_num_components; }
+
+    void detect_edge_vertex_candidates(
+        std::vector<EdgeVertexCandidate>& candidates) const override;
+
+    void detect_edge_edge_candidates(
+        std::vector<EdgeEdgeCandidate>& candidates) const override;
+
+    void detect_face_vertex_candidates(
+        std::vector<FaceVertexCandidate>& candidates) const override;
+
+    void detect_edge_face_candidates(
+        std::vector<EdgeFaceCandidate>& candidates) const override;
+
+protected:
+    /// @brief Partition the mesh into connected components.
+    void compute_components(
+        const long num_vertices,
+        const Eigen::MatrixXi& E,
+        const Eigen::MatrixXi& F);
+
+    /// @brief Union the component boxes and find the overlapping pairs.
+    void find_overlapping_components();
+
+    /// @brief Gather the boxes of a component's vertices into the scratch.
+    void gather_vertex_boxes(const long ci) const;
+
+    /// @brief Gather the boxes of a component's edges into the scratch.
+    void gather_edge_boxes(const long ci) const;
+
+    /// @brief Method used for each component's inner structure.
+    BroadPhaseMethod m_method;
+    /// @brief Morton ordering setting forwarded to the inner structures.
+    bool m_inner_morton_ordering = false;
+
+    /// @brief One inner structure per component (null if it has no
+    /// elements).
+    std::vector<std::unique_ptr<BroadPhase>> m_component_broad_phases;
+
+    // Component partition, recomputed only when the topology changes.
+    long m_num_components = 0;
+    std::vector<int> m_vertex_component; ///< @brief Component per vertex.
+    /// @brief Mesh vertex ids of each component (local-to-mesh map).
+    std::vector<std::vector<long>> m_component_vertex_ids;
+    std::vector<std::vector<long>> m_component_edge_ids;
+    std::vector<std::vector<long>> m_component_face_ids;
+    /// @brief Component edges and faces in local (compacted) vertex ids.
+    std::vector<Eigen::MatrixXi> m_component_edges;
+    std::vector<Eigen::MatrixXi> m_component_faces;
+
+    /// @brief Bounding box of each component (rebuilt every build()).
+    std::vector<AABB> m_component_boxes;
+    /// @brief Component pairs whose bounding boxes overlap.
+    std::vector<std::pair<long, long>> m_overlapping_components;
+
+    /// @brief Per-component compacted vertex positions, kept as members so
+    /// rebuilds reuse their storage.
+    std::vector<Eigen::MatrixXd> m_component_vertices_t0;
+    std::vector<Eigen::MatrixXd> m_component_vertices_t1;
+
+    // Scratch reused by the cross-pair queries to avoid reallocating.
+    mutable std::vector<AABB> m_scratch_boxes;
+    mutable BoxQueryResult m_scratch_result;
+};
+
+} // namespace ipc
@@ -1,43 +1,158 @@
 #include "hash_grid.hpp"
 
 #include <ipc/broad_phase/voxel_size_heuristic.hpp>
+#include <ipc/utils/counting_emission.hpp>
 #include <ipc/utils/merge_thread_local_vectors.hpp>
 #include <ipc/utils/logger.hpp>
 
 #include <tbb/enumerable_thread_specific.h>
-#include <tbb/blocked_range2d.h>
+#include <tbb/blocked_range.h>
 #include <tbb/parallel_for.h>
 #include <tbb/parallel_sort.h>
+#include <tbb/task_arena.h>
 
 #include <algorithm> // std::min/max
+#include <cmath>     // std::sqrt
 
 namespace ipc {
 
+namespace {
+
+    /// @brief Parallel LSD radix sort of hash items by key.
+    ///
+    /// The keys are bounded by the number of grid cells, so only the occupied
+    /// low bits are sorted (8 bits per pass, i.e., 2–4 passes for typical grid
+    /// resolutions). The sort is stable, and the order of items with equal
+    /// keys is irrelevant to candidate detection, so this is equivalent to the
+    /// comparison sort it replaces but scales with cores.
+    void radix_sort_items(HashItems& items, const long max_key)
+    {
+        constexpr int RADIX_BITS = 8;
+        constexpr long NUM_BUCKETS = 1l << RADIX_BITS;
+
+        const size_t n = items.size();
+        if (n < (1 << 14)) {
+            // The histogram passes do not pay off on small inputs.
+            tbb::parallel_sort(items.begin(), items.end());
+            return;
+        }
+
+        int num_passes = 0;
+        for (long k = max_key; k > 0; k >>= RADIX_BITS) {
+            num_passes++;
+        }
+
+        const size_t num_chunks = std::min(
+            size_t(4 * tbb::this_task_arena::max_concurrency()), n);
+        const size_t chunk_size = (n + num_chunks - 1) / num_chunks;
+
+        // Sized but not initialized: every pass scatters all n items into
+        // dst, so its pages are first touched by the parallel scatter.
+        HashItems buffer(n);
+        HashItems* src = &items;
+        HashItems* dst = &buffer;
+
+        std::vector<std::vector<size_t>> counts(
+            num_chunks, std::vector<size_t>(NUM_BUCKETS));
+
+        for (int pass = 0; pass < num_passes; pass++) {
+            const int shift = pass * RADIX_BITS;
+
+            // Per-chunk digit histograms
+            tbb::parallel_for(size_t(0), num_chunks, [&](size_t c) {
+                std::fill(counts[c].begin(), counts[c].end(), size_t(0));
+                const size_t begin = c * chunk_size;
+                const size_t end = std::min(n, begin + chunk_size);
+                for (size_t i = begin; i < end; i++) {
+                    counts[c][((*src)[i].key >> shift) & (NUM_BUCKETS - 1)]++;
+                }
+            });
+
+            // Exclusive scan over (digit, chunk) to get scatter offsets
+            size_t offset = 0;
+            for (long b = 0; b < NUM_BUCKETS; b++) {
+                for (size_t c = 0; c < num_chunks; c++) {
+                    const size_t count = counts[c][b];
+                    counts[c][b] = offset;
+                    offset += count;
+                }
+            }
+            assert(offset == n);
+
+            // Stable parallel scatter
+            tbb::parallel_for(size_t(0), num_chunks, [&](size_t c) {
+                const size_t begin = c * chunk_size;
+                const size_t end = std::min(n, begin + chunk_size);
+                for (size_t i = begin; i < end; i++) {
+                    const long digit =
+                        ((*src)[i].key >> shift) & (NUM_BUCKETS - 1);
+                    (*dst)[counts[c][digit]++] = (*src)[i];
+                }
+            });
+
+            std::swap(src, dst);
+        }
+
+        if (src != &items) {
+            items.swap(buffer);
+        }
+    }
+
+    /// @brief Locate the buckets (runs of equal keys) in a sorted item array.
+    /// @param num_items Number of sorted items.
+    /// @param key_of Function mapping an item index to its key.
+    /// @return Start index of each bucket plus a trailing num_items sentinel.
+    template <typename KeyOf>
+    std::vector<long> find_bucket_starts(const long num_items, KeyOf key_of)
+    {
+        std::vector<long> bucket_starts;
+        for (long i = 0; i < num_items; i++) {
+            if (i == 0 || key_of(i) != key_of(i - 1)) {
+                bucket_starts.push_back(i);
+            }
+        }
+        bucket_starts.push_back(num_items);
+        return bucket_starts;
+    }
+
+} // namespace
+
 void HashGrid::build(
-    const Eigen::MatrixXd& V,
+    ConstMatrixXdRef V,
     const Eigen::MatrixXi& E,
     const Eigen::MatrixXi& F,
     double inflation_radius)
 {
     BroadPhase::build(V, E, F, inflation_radius); // also calls clear()
+    StatsTimer timer(m_enable_stats, m_stats.build_time);
 
     ArrayMax3d mesh_min = V.colwise().minCoeff().array() - inflation_radius;
     ArrayMax3d mesh_max = V.colwise().maxCoeff().array() + inflation_radius;
-    double cell_size = suggest_good_voxel_size(V, E, inflation_radius);
+    double cell_size = edge_length_median_hint >= 0
+        ? suggest_good_voxel_size(edge_length_median_hint, inflation_radius)
+        : suggest_good_voxel_size(V, E, inflation_radius);
+    if (m_tune_cell_size) {
+        cell_size *= m_cell_size_scale;
+    }
     assert(std::isfinite(cell_size));
     resize(mesh_min, mesh_max, cell_size);
 
     insert_boxes();
+
+    if (m_tune_cell_size) {
+        tune_cell_size();
+    }
 }
 
 void HashGrid::build(
-    const Eigen::MatrixXd& V0,
-    const Eigen::MatrixXd& V1,
+    ConstMatrixXdRef V0,
+    ConstMatrixXdRef V1,
     const Eigen::MatrixXi& E,
     const Eigen::MatrixXi& F,
     double inflation_radius)
 {
     BroadPhase::build(V0, V1, E, F, inflation_radius); // also calls clear()
+    StatsTimer timer(m_enable_stats, m_stats.build_time);
 
     const ArrayMax3d mesh_min_t0 = V0.colwise().minCoeff();
     const ArrayMax3d mesh_max_t0 = V0.colwise().maxCoeff();
@@ -45,11 +160,21 @@ void HashGrid::build(
     const ArrayMax3d mesh_max_t1 = V1.colwise().maxCoeff();
     ArrayMax3d mesh_min = mesh_min_t0.min(mesh_min_t1) - inflation_radius;
     ArrayMax3d mesh_max = mesh_max_t0.max(mesh_max_t1) + inflation_radius;
-    double cell_size = suggest_good_voxel_size(V0, V1, E, inflation_radius);
+    double cell_size = edge_length_median_hint >= 0
+        ? suggest_good_voxel_size(
+            V0, V1, edge_length_median_hint, inflation_radius)
+        : suggest_good_voxel_size(V0, V1, E, inflation_radius);
+    if (m_tune_cell_size) {
+        cell_size *= m_cell_size_scale;
+    }
     assert(std::isfinite(cell_size));
     resize(mesh_min, mesh_max, cell_size);
 
     insert_boxes();
+
+    if (m_tune_cell_size) {
+        tune_cell_size();
+    }
 }
 
 void HashGrid::resize(
@@ -68,22 +193,27 @@ void HashGrid::resize(
 
 void HashGrid::insert_boxes()
 {
-    insert_boxes(this->vertex_boxes, vertex_items);
-    insert_boxes(this->edge_boxes, edge_items);
-    insert_boxes(this->face_boxes, face_items);
+    insert_boxes(this->vertex_boxes, vertex_cell_ranges, vertex_items);
+    insert_boxes(this->edge_boxes, edge_cell_ranges, edge_items);
+    insert_boxes(this->face_boxes, face_cell_ranges, face_items);
 }
 
 void HashGrid::insert_boxes(
-    const std::vector<AABB>& boxes, std::vector<HashItem>& items) const
+    const std::vector<AABB>& boxes,
+    std::vector<HashCellRange>& cell_ranges,
+    HashItems& items) const
 {
-    tbb::enumerable_thread_specific<std::vector<HashItem>> storage;
+    cell_ranges.resize(boxes.size());
+
+    tbb::enumerable_thread_specific<HashItems> storage;
 
     tbb::parallel_for(
         tbb::blocked_range<long>(0l, long(boxes.size())),
         [&](const tbb::blocked_range<long>& range) {
             auto& local_items = storage.local();
             for (long i = range.begin(); i != range.end(); i++) {
-                insert_box(boxes[i], i, local_items);
+                cell_ranges[i] = cell_range(boxes[i]);
+                insert_box(cell_ranges[i], i, local_items);
             }
         });
 
@@ -91,11 +221,10 @@ void HashGrid::insert_boxes(
 
     // Sorted all they (key, value) pairs, where key is the hash key, and
     // value is the element index
-    tbb::parallel_sort(items.begin(), items.end());
+    radix_sort_items(items, m_gridSize.cast<long>().prod());
 }
 
-void HashGrid::insert_box(
-    const AABB& aabb, const long id, std::vector<HashItem>& items) const
+HashCellRange HashGrid::cell_range(const AABB& aabb) const
 {
     ArrayMax3i int_min = ((aabb.min - m_domainMin) / m_cellSize).cast<int>();
     // We can round down to -1, but not less
@@ -109,10 +238,18 @@ void HashGrid::insert_box(
     int_max = int_max.max(0).min(m_gridSize - 1);
     assert((int_min <= int_max).all());
 
-    int min_z = int_min.size() == 3 ? int_min.z() : 0;
-    int max_z = int_max.size() == 3 ? int_max.z() : 0;
-    for (int x = int_min.x(); x <= int_max.x(); ++x) {
-        for (int y = int_min.y(); y <= int_max.y(); ++y) {
+    return { int_min, int_max };
+}
+
+void HashGrid::insert_box(
+    const HashCellRange& range,
+    const long id,
+    HashItems& items) const
+{
+    int min_z = range.min.size() == 3 ? range.min.z() : 0;
+    int max_z = range.max.size() == 3 ? range.max.z() : 0;
+    for (int x = range.min.x(); x <= range.max.x(); ++x) {
+        for (int y = range.min.y(); y <= range.max.y(); ++y) {
             for (int z = min_z; z <= max_z; ++z) {
                 items.emplace_back(hash(x, y, z), id);
             }
@@ -120,12 +257,155 @@ void HashGrid::insert_box(
     }
 }
 
+void HashGrid::update(ConstMatrixXdRef V)
+{
+    // The incremental path assumes box i corresponds to element i, which does
+    // not hold for Morton-ordered boxes, so rebuild from scratch in that case.
+    if (m_use_morton_ordering || vertex_boxes.size() != size_t(V.rows())) {
+        build(V, m_edges, m_faces, m_inflation_radius);
+        return;
+    }
+
+    build_vertex_boxes(V, vertex_boxes, m_inflation_radius);
+    build_edge_boxes(vertex_boxes, m_edges, edge_boxes);
+    build_face_boxes(vertex_boxes, m_faces, face_boxes);
+
+    // Rebuild from scratch if the mesh left the grid domain.
+    const ArrayMax3d mesh_min =
+        V.colwise().minCoeff().array() - m_inflation_radius;
+    const ArrayMax3d mesh_max =
+        V.colwise().maxCoeff().array() + m_inflation_radius;
+    if ((mesh_min < m_domainMin).any() || (mesh_max > m_domainMax).any()) {
+        build(V, m_edges, m_faces, m_inflation_radius);
+        return;
+    }
+
+    update_items(vertex_boxes, vertex_cell_ranges, vertex_items);
+    update_items(edge_boxes, edge_cell_ranges, edge_items);
+    update_items(face_boxes, face_cell_ranges, face_items);
+}
+
+void HashGrid::update_items(
+    const std::vector<AABB>& boxes,
+    std::vector<HashCellRange>& cell_ranges,
+    HashItems& items) const
+{
+    assert(boxes.size() == cell_ranges.size());
+
+    // Determine which elements crossed a cell boundary.
+    std::vector<char> changed(boxes.size(), false);
+    tbb::parallel_for(
+        tbb::blocked_range<long>(0l, long(boxes.size())),
+        [&](const tbb::blocked_range<long>& range) {
+            for (long i = range.begin(); i != range.end(); i++) {
+                const HashCellRange new_range = cell_range(boxes[i]);
+                if (new_range != cell_ranges[i]) {
+                    cell_ranges[i] = new_range;
+                    changed[i] = true;
+                }
+            }
+        });
+
+    if (std::find(changed.begin(), changed.end(), char(true))
+        == changed.end()) {
+        return; // No element crossed a cell boundary, so the items are valid.
+    }
+
+    // Drop the stale items and insert the new ones.
+    items.erase(
+        std::remove_if(
+            items.begin(), items.end(),
+            [&](const HashItem& item) { return changed[item.id]; }),
+        items.end());
+
+    for (size_t i = 0; i < boxes.size(); i++) {
+        if (changed[i]) {
+            insert_box(cell_ranges[i], long(i), items);
+        }
+    }
+
+    radix_sort_items(items, m_gridSize.cast<long>().prod());
+}
+
+void HashGrid::tune_cell_size()
+{
+    const size_t num_boxes =
+        vertex_boxes.size() + edge_boxes.size() + face_boxes.size();
+    if (num_boxes == 0) {
+        return;
+    }
+
+    // Proxy for the work this build's cell size caused: every item was
+    // inserted, sorted, and merged once, and a cell holding k boxes of one
+    // type runs k * (k - 1) / 2 pair tests during detection. Larger cells
+    // trade fewer items for longer runs and vice versa; dividing by the box
+    // count keeps consecutive builds comparable as elements enter and leave
+    // the active region.
+    double cost = 0;
+    for (const auto* items : { &vertex_items, &edge_items, &face_items }) {
+        cost += double(items->size());
+        size_t i = 0;
+        while (i < items->size()) {
+            size_t run = 1;
+            while (i + run < items->size()
+                   && (*items)[i + run].key == (*items)[i].key) {
+                run++;
+            }
+            cost += 0.5 * double(run) * double(run - 1);
+            i += run;
+        }
+    }
+    cost /= double(num_boxes);
+
+    // One probe per build: keep moving the scale while the cost falls,
+    // reverse and shrink the step when it rises. The step never decays
+    // below a few percent, so the settled scale keeps probing and re-adapts
+    // when the scene moves the optimum.
+    constexpr double MIN_TUNING_STEP = 1.05;
+    if (m_last_tuning_cost >= 0 && cost > m_last_tuning_cost) {
+        m_tuning_up = !m_tuning_up;
+        m_tuning_step = std::max(std::sqrt(m_tuning_step), MIN_TUNING_STEP);
+    }
+    m_last_tuning_cost = cost;
+
+    const double scale = m_tuning_up ? m_cell_size_scale * m_tuning_step
+                                     : m_cell_size_scale / m_tuning_step;
+    m_cell_size_scale =
+        std::min(std::max(scale, m_tuning_scale_min), m_tuning_scale_max);
+
+    logger().trace(
+        "hash-grid cell-size tuner: cost {:g} per box, next scale {:g}", cost,
+        m_cell_size_scale);
+}
+
+void HashGrid::collect_stats(BroadPhaseStats& stats) const
+{
+    stats.boxes_per_cell_histogram.clear();
+    // The items are sorted by cell key, so runs of equal keys are the
+    // occupied cells. Each element type has its own item array, so a cell
+    // holding several types contributes one entry per type.
+    for (const auto* items : { &vertex_items, &edge_items, &face_items }) {
+        size_t i = 0;
+        while (i < items->size()) {
+            size_t run = 1;
+            while (i + run < items->size()
+                   && (*items)[i + run].key == (*items)[i].key) {
+                run++;
+            }
+            stats.add_occupied_cell(run);
+            i += run;
+        }
+    }
+}
+
 template <typename Candidate>
 void HashGrid::detect_candidates(
-    const std::vector<HashItem>& items0,
-    const std::vector<HashItem>& items1,
+    const HashItems& items0,
+    const HashItems& items1,
     const std::vector<AABB>& boxes0,
     const std::vector<AABB>& boxes1,
+    const std::vector<HashCellRange>& cell_ranges0,
+    const std::vector<HashCellRange>& cell_ranges1,
     const std::function<bool(size_t, size_t)>& can_collide,
     std::vector<Candidate>& candidates) const
 {
@@ -158,115 +438,159 @@ void HashGrid::detect_candidates(
         return i < 0 ? items0[-(i + 1)] : items1[i];
     };
 
-    // 2. Enumerate hash collisions
-    tbb::enumerable_thread_specific<std::vector<Candidate>> storage;
-    tbb::parallel_for(
-        tbb::blocked_range2d<long>(0l, num_items - 1, 0l, num_items),
-        [&](const tbb::blocked_range2d<long>& r) {
-            auto& local_candidates = storage.local();
-
-            // i < j
-            long i_end = std::min(r.rows().end(), r.cols().end());
-            for (long i = r.rows().begin(); i < i_end; i++) {
-                const long idx0 = merged_item_indices[i];
-                const HashItem& item0 = get_item(idx0);
-
-                // i < r.cols().end() → i + 1 <= r.cols().end()
-                long j_begin = std::max(i + 1, r.cols().begin());
-                for (long j = j_begin; j < r.cols().end(); j++) {
-                    const long idx1 = merged_item_indices[j];
-                    const HashItem& item1 = get_item(idx1);
-
-                    if (item0.key != item1.key) {
-                        break; // This avoids a brute force comparison
-                    }
-
-                    long id0 = item0.id, id1 = item1.id;
-                    if (idx0 >= 0 && idx1 < 0) {
-                        std::swap(id0, id1);
-                    } else if (idx0 >= 0 || idx1 < 0) {
-                        continue;
-                    }
-                    assert(id0 < boxes0.size() && id1 < boxes1.size());
-
-                    if (!can_collide(id0, id1)) {
-                        continue;
-                    }
-
-                    if (boxes0[id0].intersects(boxes1[id1])) {
-                        local_candidates.emplace_back(id0, id1);
-                    }
+    // 2. Locate the bucket boundaries (runs of items with the same key).
+    const std::vector<long> bucket_starts =
+        find_bucket_starts(num_items, [&](long i) {
+            return get_item(merged_item_indices[i]).key;
+        });
+    const long num_buckets = long(bucket_starts.size()) - 1;
+
+    // 3. Enumerate hash collisions bucket by bucket, counting before
+    // emitting so the output is written with a single allocation. The
+    // counting pass only runs the cheap geometric tests; the possibly
+    // expensive user filter runs once, in the emission pass.
+    const auto for_each_overlapping_pair = [&](const long b,
+                                               const auto& visit) {
+        const long bucket_end = bucket_starts[b + 1];
+        for (long i = bucket_starts[b]; i < bucket_end - 1; i++) {
+            const long idx0 = merged_item_indices[i];
+            const HashItem& item0 = get_item(idx0);
+
+            for (long j = i + 1; j < bucket_end; j++) {
+                const long idx1 = merged_item_indices[j];
+                const HashItem& item1 = get_item(idx1);
+                assert(item0.key == item1.key);
+
+                long id0 = item0.id, id1 = item1.id;
+                if (idx0 >= 0 && idx1 < 0) {
+                    std::swap(id0, id1);
+                } else if (idx0 >= 0 || idx1 < 0) {
+                    continue;
+                }
+                assert(id0 < boxes0.size() && id1 < boxes1.size());
+
+                // Only the owner cell of the pair reports it, so
+                // the pair is emitted (and its filter counted) once.
+                if (!is_owner_cell(
+                        item0.key, cell_ranges0[id0], cell_ranges1[id1])) {
+                    continue;
+                }
+
+                if (boxes0[id0].intersects(boxes1[id1])) {
+                    visit(id0, id1);
                 }
             }
-        });
+        }
+    };
 
-    merge_thread_local_vectors(storage, candidates);
+    counting_scatter_append<Candidate>(
+        num_buckets,
+        [&](const long b) {
+            long count = 0;
+            for_each_overlapping_pair(b, [&](long, long) { count++; });
+            return count;
+        },
+        [&](const long b, Candidate* out) {
+            long k = 0;
+            for_each_overlapping_pair(b, [&](long id0, long id1) {
+                if (can_collide(id0, id1)) {
+                    out[k++] = Candidate(id0, id1);
+                }
+            });
+            return k;
+        },
+        candidates);
 
-    // Remove the duplicate candidates
+    // The owner-cell test makes the candidates unique; sorting only keeps
+    // the output independent of the bucket order.
     tbb::parallel_sort(candidates.begin(), candidates.end());
-    auto new_end = std::unique(candidates.begin(), candidates.end());
-    candidates.erase(new_end, candidates.end());
+    assert(
+        std::adjacent_find(candidates.begin(), candidates.end())
+        == candidates.end());
+
+    remap_candidates(candidates);
 }
 
 template <typename Candidate>
 void HashGrid::detect_candidates(
-    const std::vector<HashItem>& items,
+    const HashItems& items,
     const std::vector<AABB>& boxes,
+    const std::vector<HashCellRange>& cell_ranges,
     const std::function<bool(size_t, size_t)>& can_collide,
     std::vector<Candidate>& candidates) const
 {
     // Entries with the same key means they share a cell (that cell index
     // hashes to the same key) and should be flagged for low-level
-    // intersection testing. So we loop over the entire sorted set of
-    // (key,value) pairs creating Candidate entries for pairs with the same key
-    tbb::enumerable_thread_specific<std::vector<Candidate>> storage;
+    // intersection testing. So we scan the buckets (runs of sorted items with
+    // the same key) in parallel, creating Candidate entries for pairs within
+    // each bucket.
+    const std::vector<long> bucket_starts = find_bucket_starts(
+        items.size(), [&](long i) { return items[i].key; });
+    const long num_buckets = long(bucket_starts.size()) - 1;
+
+    // Count before emitting so the output is written with a single
+    // allocation. The counting pass only runs the cheap geometric tests;
+    // the possibly expensive user filter runs once, in the emission pass.
+    const auto for_each_overlapping_pair = [&](const long b,
+                                               const auto& visit) {
+        const long bucket_end = bucket_starts[b + 1];
+        for (long i = bucket_starts[b]; i < bucket_end - 1; i++) {
+            const HashItem& item0 = items[i];
+            const AABB& box0 = boxes[item0.id];
+
+            for (long j = i + 1; j < bucket_end; j++) {
+                const HashItem& item1 = items[j];
+                assert(item0.key == item1.key);
+
+                // Only the owner cell of the pair reports it, so
+                // the pair is emitted (and its filter counted) once.
+                if (!is_owner_cell(
+                        item0.key, cell_ranges[item0.id],
+                        cell_ranges[item1.id])) {
+                    continue;
+                }
 
-    tbb::parallel_for(
-        tbb::blocked_range2d<long>(0l, items.size() - 1, 0l, items.size()),
-        [&](const tbb::blocked_range2d<long>& r) {
-            auto& local_candidates = storage.local();
-
-            // i < j
-            long i_end = std::min(r.rows().end(), r.cols().end());
-            for (long i = r.rows().begin(); i < i_end; i++) {
-                const HashItem& item0 = items[i];
-                const AABB& box0 = boxes[item0.id];
-
-                // i < r.cols().end() → i + 1 <= r.cols().end()
-                long j_begin = std::max(i + 1, r.cols().begin());
-                assert(j_begin > i);
-                for (long j = j_begin; j < r.cols().end(); j++) {
-                    const HashItem& item1 = items[j];
-
-                    if (item0.key != item1.key) {
-                        break; // This avoids a brute force comparison
-                    }
-
-                    if (!can_collide(item0.id, item1.id)) {
-                        continue;
-                    }
-
-                    const AABB& box1 = boxes[item1.id];
-                    if (box0.intersects(box1)) {
-                        local_candidates.emplace_back(item0.id, item1.id);
-                    }
+                if (box0.intersects(boxes[item1.id])) {
+                    visit(long(item0.id), long(item1.id));
                 }
             }
-        });
+        }
+    };
 
-    merge_thread_local_vectors(storage, candidates);
+    counting_scatter_append<Candidate>(
+        num_buckets,
+        [&](const long b) {
+            long count = 0;
+            for_each_overlapping_pair(b, [&](long, long) { count++; });
+            return count;
+        },
+        [&](const long b, Candidate* out) {
+            long k = 0;
+            for_each_overlapping_pair(b, [&](long id0, long id1) {
+                if (can_collide(id0, id1)) {
+                    out[k++] = Candidate(id0, id1);
+                }
+            });
+            return k;
+        },
+        candidates);
 
-    // Remove the duplicate candidates
+    // The owner-cell test makes the candidates unique; sorting only keeps
+    // the output independent of the bucket order.
     tbb::parallel_sort(candidates.begin(), candidates.end());
-    auto new_end = std::unique(candidates.begin(), candidates.end());
-    candidates.erase(new_end, candidates.end());
+    assert(
+        std::adjacent_find(candidates.begin(), candidates.end())
+        == candidates.end());
+
+    remap_candidates(candidates);
 }
 
 void HashGrid::detect_edge_vertex_candidates(
     std::vector<EdgeVertexCandidate>& candidates) const
 {
     detect_candidates(
-        edge_items, vertex_items, edge_boxes, vertex_boxes,
+        edge_items, vertex_items, edge_boxes, vertex_boxes, edge_cell_ranges,
+        vertex_cell_ranges,
         [&](size_t ei, size_t vi) { return can_edge_vertex_collide(ei, vi); },
         candidates);
 }
@@ -275,7 +599,7 @@ void HashGrid::detect_edge_edge_candidates(
     std::vector<EdgeEdgeCandidate>& candidates) const
 {
     detect_candidates(
-        edge_items, edge_boxes,
+        edge_items, edge_boxes, edge_cell_ranges,
         [&](size_t eai, size_t ebi) { return can_edges_collide(eai, ebi); },
         candidates);
 }
@@ -284,7 +608,8 @@ void HashGrid::detect_face_vertex_candidates(
     std::vector<FaceVertexCandidate>& candidates) const
 {
     detect_candidates(
-        face_items, vertex_items, face_boxes, vertex_boxes,
+        face_items, vertex_items, face_boxes, vertex_boxes, face_cell_ranges,
+        vertex_cell_ranges,
         [&](size_t fi, size_t vi) { return can_face_vertex_collide(fi, vi); },
         candidates);
 }
@@ -293,7 +618,8 @@ void HashGrid::detect_edge_face_candidates(
     std::vector<EdgeFaceCandidate>& candidates) const
 {
     detect_candidates(
-        edge_items, face_items, edge_boxes, face_boxes,
+        edge_items, face_items, edge_boxes, face_boxes, edge_cell_ranges,
+        face_cell_ranges,
         [&](size_t ei, size_t fi) { return can_edge_face_collide(ei, fi); },
         candidates);
 }
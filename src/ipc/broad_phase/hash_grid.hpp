@@ -1,16 +1,22 @@
 #pragma once
 
 #include <ipc/broad_phase/broad_phase.hpp>
+#include <ipc/utils/eigen_ext.hpp>
+#include <ipc/utils/memory_usage.hpp>
+#include <ipc/utils/hugepage_allocator.hpp>
+#include <ipc/utils/numa.hpp>
 
 namespace ipc {
 
 /// @brief An entry into the hash grid as a (key, value) pair.
 struct HashItem {
-    long key; /// @brief The key of the item.
-    long id;  /// @brief The value of the item.
+    index_t key; /// @brief The key of the item.
+    index_t id;  /// @brief The value of the item.
+
+    HashItem() = default;
 
     /// @brief Construct a hash item as a (key, value) pair.
-    HashItem(int key, int id)
+    HashItem(long key, long id)
         : key(key)
         , id(id)
     {
@@ -26,6 +32,30 @@ struct HashItem {
     }
 };
 
+/// @brief Hash item array grown without value-initialization, so the pages
+/// of a freshly sized buffer are first touched by the parallel fill (see
+/// default_init_allocator for the NUMA rationale), and backed by
+/// transparent hugepages once it is large enough to pay for them (see
+/// hugepage_allocator).
+using HashItems = std::vector<
+    HashItem,
+    default_init_allocator<HashItem, hugepage_allocator<HashItem>>>;
+
+/// @brief The range of grid cells covered by an AABB.
+struct HashCellRange {
+    ArrayMax3i min;
+    ArrayMax3i max;
+
+    bool operator==(const HashCellRange& other) const
+    {
+        return (min == other.min).all() && (max == other.max).all();
+    }
+    bool operator!=(const HashCellRange& other) const
+    {
+        return !(*this == other);
+    }
+};
+
 class HashGrid : public BroadPhase {
 public:
     /// @brief Build the broad phase for static collision detection.
@@ -34,7 +64,7 @@ public:
     /// @param F Faces of the mesh.
     /// @param inflation_radius Radius of inflation around all elements.
     void build(
-        const Eigen::MatrixXd& V,
+        ConstMatrixXdRef V,
         const Eigen::MatrixXi& E,
         const Eigen::MatrixXi& F,
         double inflation_radius = 0) override;
@@ -46,12 +76,21 @@ public:
     /// @param F Faces of the mesh.
     /// @param inflation_radius Radius of inflation around all elements.
     void build(
-        const Eigen::MatrixXd& V0,
-        const Eigen::MatrixXd& V1,
+        ConstMatrixXdRef V0,
+        ConstMatrixXdRef V1,
         const Eigen::MatrixXi& E,
         const Eigen::MatrixXi& F,
         double inflation_radius = 0) override;
 
+    /// @brief Update the hash grid with new vertex positions.
+    ///
+    /// Reuses the grid of the last build() and only re-buckets elements whose
+    /// AABBs crossed a cell boundary, which is substantially cheaper than a
+    /// full rebuild when vertices move less than a fraction of the cell size.
+    /// Falls back to a full rebuild if the mesh left the grid domain.
+    /// @param V New positions of the vertices.
+    void update(ConstMatrixXdRef V) override;
+
     /// @brief Clear the hash grid.
     void clear() override
     {
@@ -59,6 +98,20 @@ public:
         vertex_items.clear();
         edge_items.clear();
         face_items.clear();
+        vertex_cell_ranges.clear();
+        edge_cell_ranges.clear();
+        face_cell_ranges.clear();
+    }
+
+    /// @brief Add the hash items and cached cell ranges to the count.
+    size_t bytes_used() const override
+    {
+        return record_bytes_used(
+            BroadPhase::bytes_used() + vector_bytes_used(vertex_items)
+            + vector_bytes_used(edge_items) + vector_bytes_used(face_items)
+            + vector_bytes_used(vertex_cell_ranges)
+            + vector_bytes_used(edge_cell_ranges)
+            + vector_bytes_used(face_cell_ranges));
     }
 
     /// @brief Find the candidate edge-vertex collisisons.
@@ -86,17 +139,67 @@ public:
     const ArrayMax3d& domainMin() const { return m_domainMin; }
     const ArrayMax3d& domainMax() const { return m_domainMax; }
 
+    /// @brief Enable feedback-driven tuning of the cell size.
+    ///
+    /// suggest_good_voxel_size() only sees edge-length statistics, but the
+    /// best cell size also depends on how densely the elements overlap at
+    /// runtime. With tuning enabled, every build() measures a proxy of its
+    /// own cost (items inserted plus pair tests per occupied cell, per box)
+    /// and adjusts a scale on the heuristic cell size for the next build:
+    /// the scale keeps moving in one direction while the cost falls,
+    /// reverses and shrinks its step when it rises, and keeps probing with a
+    /// small step once settled, so it tracks the optimum as the scene
+    /// evolves. The grid finds the same candidates at every scale; only the
+    /// build and query costs change. The tuner state persists across builds
+    /// and clear() — that persistence is what lets it converge.
+    /// @param enable Whether to tune the cell size.
+    /// @param min_scale Lower bound on the scale.
+    /// @param max_scale Upper bound on the scale.
+    void set_cell_size_tuning(
+        const bool enable = true,
+        const double min_scale = 0.25,
+        const double max_scale = 4.0)
+    {
+        assert(0 < min_scale && min_scale <= max_scale);
+        m_tune_cell_size = enable;
+        m_tuning_scale_min = min_scale;
+        m_tuning_scale_max = max_scale;
+    }
+
+    /// @brief Scale the tuner currently applies to the heuristic cell size.
+    double cell_size_scale() const { return m_cell_size_scale; }
+
 protected:
+    /// @brief Report the histogram of boxes per occupied cell.
+    void collect_stats(BroadPhaseStats& stats) const override;
+
+    /// @brief Measure this build's cost proxy and adjust the cell-size
+    /// scale for the next build (see set_cell_size_tuning()).
+    void tune_cell_size();
+
     void resize(const ArrayMax3d& min, const ArrayMax3d& max, double cellSize);
 
     void insert_boxes();
 
     void insert_boxes(
-        const std::vector<AABB>& boxes, std::vector<HashItem>& items) const;
+        const std::vector<AABB>& boxes,
+        std::vector<HashCellRange>& cell_ranges,
+        HashItems& items) const;
 
-    /// @brief Add an AABB of the extents to the hash grid.
+    /// @brief Add the items of a cell range to the hash grid.
     void insert_box(
-        const AABB& aabb, const long id, std::vector<HashItem>& items) const;
+        const HashCellRange& range,
+        const long id,
+        HashItems& items) const;
+
+    /// @brief Compute the range of grid cells covered by an AABB.
+    HashCellRange cell_range(const AABB& aabb) const;
+
+    /// @brief Re-bucket only the boxes whose cell range changed.
+    void update_items(
+        const std::vector<AABB>& boxes,
+        std::vector<HashCellRange>& cell_ranges,
+        HashItems& items) const;
 
     /// @brief Create the hash of a cell location.
     inline long hash(int x, int y, int z) const
@@ -108,20 +211,40 @@ protected:
         return (z * m_gridSize[1] + y) * m_gridSize[0] + x;
     }
 
+    /// @brief Is the cell with this key the owner of a pair of elements?
+    ///
+    /// Two elements spanning several cells share every cell in the overlap
+    /// of their cell ranges; reporting their pair only from the
+    /// lexicographically smallest shared cell (the componentwise max of the
+    /// range minima) emits it exactly once, so detection never generates
+    /// duplicates.
+    inline bool is_owner_cell(
+        const long key,
+        const HashCellRange& range0,
+        const HashCellRange& range1) const
+    {
+        const ArrayMax3i owner = range0.min.max(range1.min);
+        return key
+            == hash(owner[0], owner[1], owner.size() == 3 ? owner[2] : 0);
+    }
+
 private:
     template <typename Candidate>
     void detect_candidates(
-        const std::vector<HashItem>& items0,
-        const std::vector<HashItem>& items1,
+        const HashItems& items0,
+        const HashItems& items1,
         const std::vector<AABB>& boxes0,
         const std::vector<AABB>& boxes1,
+        const std::vector<HashCellRange>& cell_ranges0,
+        const std::vector<HashCellRange>& cell_ranges1,
         const std::function<bool(size_t, size_t)>& can_collide,
         std::vector<Candidate>& candidates) const;
 
     template <typename Candidate>
     void detect_candidates(
-        const std::vector<HashItem>& items,
+        const HashItems& items,
         const std::vector<AABB>& boxes,
+        const std::vector<HashCellRange>& cell_ranges,
         const std::function<bool(size_t, size_t)>& can_collide,
         std::vector<Candidate>& candidates) const;
 
@@ -131,9 +254,26 @@ protected:
     ArrayMax3d m_domainMin;
     ArrayMax3d m_domainMax;
 
-    std::vector<HashItem> vertex_items;
-    std::vector<HashItem> edge_items;
-    std::vector<HashItem> face_items;
+    HashItems vertex_items;
+    HashItems edge_items;
+    HashItems face_items;
+
+    // Cell ranges of the last build used by update() to detect which
+    // elements need to be re-bucketed.
+    std::vector<HashCellRange> vertex_cell_ranges;
+    std::vector<HashCellRange> edge_cell_ranges;
+    std::vector<HashCellRange> face_cell_ranges;
+
+    // Feedback cell-size tuner (see set_cell_size_tuning()). Not reset by
+    // clear(): build() clears the grid every time, so the tuner's memory of
+    // the previous build is what it converges from.
+    bool m_tune_cell_size = false;
+    double m_cell_size_scale = 1.0;
+    double m_tuning_scale_min = 0.25;
+    double m_tuning_scale_max = 4.0;
+    double m_tuning_step = 1.5;
+    bool m_tuning_up = true;
+    double m_last_tuning_cost = -1;
 };
 
 } // namespace ipc
@@ -0,0 +1,523 @@
+#include "hash_grid_gpu.hpp"
+
+#ifdef IPC_TOOLKIT_WITH_CUDA
+
+#include <ipc/broad_phase/voxel_size_heuristic.hpp>
+
+#include <thrust/device_vector.h>
+#include <thrust/execution_policy.h>
+#include <thrust/scan.h>
+#include <thrust/sort.h>
+#include <thrust/unique.h>
+
+#include <cuda_runtime.h>
+
+#include <cmath>
+#include <stdexcept>
+
+namespace ipc {
+
+namespace {
+
+    constexpr int BLOCK_SIZE = 256;
+
+    inline int num_blocks(long n)
+    {
+        return int((n + BLOCK_SIZE - 1) / BLOCK_SIZE);
+    }
+
+    inline void check_cuda(cudaError_t status)
+    {
+        if (status != cudaSuccess) {
+            throw std::runtime_error(
+                std::string("HashGridGPU CUDA error: ")
+                + cudaGetErrorString(status));
+        }
+    }
+
+    /// @brief Uniform grid parameters shared by all kernels.
+    struct DeviceGrid {
+        double3 origin;
+        double inv_cell_size;
+        int3 dims;
+    };
+
+    __device__ inline int
+    clamp_int(const int x, const int lo, const int hi)
+    {
+        return min(max(x, lo), hi);
+    }
+
+    __device__ inline int3
+    locate_cell(const DeviceGrid& grid, const double3& p)
+    {
+        return make_int3(
+            clamp_int(
+                int((p.x - grid.origin.x) * grid.inv_cell_size), 0,
+                grid.dims.x - 1),
+            clamp_int(
+                int((p.y - grid.origin.y) * grid.inv_cell_size), 0,
+                grid.dims.y - 1),
+            clamp_int(
+                int((p.z - grid.origin.z) * grid.inv_cell_size), 0,
+                grid.dims.z - 1));
+    }
+
+    __device__ inline void min_into(double3& a, const double3& b)
+    {
+        a.x = min(a.x, b.x);
+        a.y = min(a.y, b.y);
+        a.z = min(a.z, b.z);
+    }
+
+    __device__ inline void max_into(double3& a, const double3& b)
+    {
+        a.x = max(a.x, b.x);
+        a.y = max(a.y, b.y);
+        a.z = max(a.z, b.z);
+    }
+
+    __device__ inline double3 load_point(const double* V, const int vi)
+    {
+        return make_double3(V[3 * vi + 0], V[3 * vi + 1], V[3 * vi + 2]);
+    }
+
+    /// @brief Compute the inflated AABB of every vertex, edge, and face in
+    /// the unified index space ([0, nV) vertices, [nV, nV+nE) edges, faces
+    /// beyond).
+    __global__ void compute_boxes_kernel(
+        const long num_elements,
+        const long num_vertices,
+        const long num_edges,
+        const double* V0,
+        const double* V1,
+        const int* E,
+        const int* F,
+        const double inflation_radius,
+        double3* box_min,
+        double3* box_max)
+    {
+        const long id = blockIdx.x * blockDim.x + threadIdx.x;
+        if (id >= num_elements) {
+            return;
+        }
+
+        int vids[3] = { -1, -1, -1 };
+        if (id < num_vertices) {
+            vids[0] = id;
+        } else if (id < num_vertices + num_edges) {
+            const long ei = id - num_vertices;
+            vids[0] = E[2 * ei + 0];
+            vids[1] = E[2 * ei + 1];
+        } else {
+            const long fi = id - num_vertices - num_edges;
+            vids[0] = F[3 * fi + 0];
+            vids[1] = F[3 * fi + 1];
+            vids[2] = F[3 * fi + 2];
+        }
+
+        double3 lo = load_point(V0, vids[0]);
+        double3 hi = lo;
+        for (int i = 0; i < 3; i++) {
+            if (vids[i] < 0) {
+                break;
+            }
+            const double3 p0 = load_point(V0, vids[i]);
+            const double3 p1 = load_point(V1, vids[i]);
+            min_into(lo, p0);
+            min_into(lo, p1);
+            max_into(hi, p0);
+            max_into(hi, p1);
+        }
+
+        box_min[id] = make_double3(
+            lo.x - inflation_radius, lo.y - inflation_radius,
+            lo.z - inflation_radius);
+        box_max[id] = make_double3(
+            hi.x + inflation_radius, hi.y + inflation_radius,
+            hi.z + inflation_radius);
+    }
+
+    /// @brief Count the grid cells each element's box overlaps.
+    __global__ void count_cells_kernel(
+        const long num_elements,
+        const DeviceGrid grid,
+        const double3* box_min,
+        const double3* box_max,
+        int* counts)
+    {
+        const long id = blockIdx.x * blockDim.x + threadIdx.x;
+        if (id >= num_elements) {
+            return;
+        }
+
+        const int3 lo = locate_cell(grid, box_min[id]);
+        const int3 hi = locate_cell(grid, box_max[id]);
+        counts[id] =
+            (hi.x - lo.x + 1) * (hi.y - lo.y + 1) * (hi.z - lo.z + 1);
+    }
+
+    /// @brief Emit a (cell, element) pair per overlapped cell.
+    __global__ void fill_cells_kernel(
+        const long num_elements,
+        const DeviceGrid grid,
+        const double3* box_min,
+        const double3* box_max,
+        const int* offsets,
+        int* cell_keys,
+        int* cell_ids)
+    {
+        const long id = blockIdx.x * blockDim.x + threadIdx.x;
+        if (id >= num_elements) {
+            return;
+        }
+
+        const int3 lo = locate_cell(grid, box_min[id]);
+        const int3 hi = locate_cell(grid, box_max[id]);
+
+        int out = offsets[id];
+        for (int iz = lo.z; iz <= hi.z; iz++) {
+            for (int iy = lo.y; iy <= hi.y; iy++) {
+                for (int ix = lo.x; ix <= hi.x; ix++) {
+                    cell_keys[out] =
+                        ix + grid.dims.x * (iy + grid.dims.y * iz);
+                    cell_ids[out] = id;
+                    out++;
+                }
+            }
+        }
+    }
+
+    __device__ inline bool boxes_overlap(
+        const double3* box_min, const double3* box_max, const int a,
+        const int b)
+    {
+        return box_min[a].x <= box_max[b].x && box_min[b].x <= box_max[a].x
+            && box_min[a].y <= box_max[b].y && box_min[b].y <= box_max[a].y
+            && box_min[a].z <= box_max[b].z && box_min[b].z <= box_max[a].z;
+    }
+
+    /// @brief True for element pairs the detect_* functions can use
+    /// (vertex-vertex and face-face overlaps are never needed).
+    __device__ inline bool is_useful_pair(
+        const int lo, const int hi, const long num_vertices,
+        const long tri_start)
+    {
+        const bool both_vertices = hi < num_vertices;
+        const bool both_faces = lo >= tri_start;
+        return !both_vertices && !both_faces;
+    }
+
+    /// @brief Count the overlapping pairs each item forms with the items
+    /// after it in the same cell (the cell arrays are sorted by key).
+    __global__ void count_overlaps_kernel(
+        const long num_items,
+        const int* cell_keys,
+        const int* cell_ids,
+        const double3* box_min,
+        const double3* box_max,
+        const long num_vertices,
+        const long tri_start,
+        int* counts)
+    {
+        const long i = blockIdx.x * blockDim.x + threadIdx.x;
+        if (i >= num_items) {
+            return;
+        }
+
+        int count = 0;
+        for (long j = i + 1; j < num_items && cell_keys[j] == cell_keys[i];
+             j++) {
+            const int lo = min(cell_ids[i], cell_ids[j]);
+            const int hi = max(cell_ids[i], cell_ids[j]);
+            if (is_useful_pair(lo, hi, num_vertices, tri_start)
+                && boxes_overlap(box_min, box_max, lo, hi)) {
+                count++;
+            }
+        }
+        counts[i] = count;
+    }
+
+    /// @brief Write the packed overlap pairs counted above.
+    __global__ void write_overlaps_kernel(
+        const long num_items,
+        const int* cell_keys,
+        const int* cell_ids,
+        const double3* box_min,
+        const double3* box_max,
+        const long num_vertices,
+        const long tri_start,
+        const int* offsets,
+        uint64_t* overlaps)
+    {
+        const long i = blockIdx.x * blockDim.x + threadIdx.x;
+        if (i >= num_items) {
+            return;
+        }
+
+        int out = offsets[i];
+        for (long j = i + 1; j < num_items && cell_keys[j] == cell_keys[i];
+             j++) {
+            const int lo = min(cell_ids[i], cell_ids[j]);
+            const int hi = max(cell_ids[i], cell_ids[j]);
+            if (is_useful_pair(lo, hi, num_vertices, tri_start)
+                && boxes_overlap(box_min, box_max, lo, hi)) {
+                overlaps[out++] = (uint64_t(lo) << 32) | uint64_t(hi);
+            }
+        }
+    }
+
+} // namespace
+
+HashGridGPU::~HashGridGPU()
+{
+    if (m_overlaps != nullptr) {
+        cudaFreeHost(m_overlaps);
+    }
+}
+
+void HashGridGPU::reserve_overlaps(size_t size)
+{
+    if (size <= m_overlaps_capacity) {
+        return;
+    }
+    if (m_overlaps != nullptr) {
+        cudaFreeHost(m_overlaps);
+        m_overlaps = nullptr;
+        m_overlaps_capacity = 0;
+    }
+    check_cuda(cudaMallocHost(&m_overlaps, size * sizeof(uint64_t)));
+    m_overlaps_capacity = size;
+}
+
+void HashGridGPU::build(
+    ConstMatrixXdRef V,
+    const Eigen::MatrixXi& E,
+    const Eigen::MatrixXi& F,
+    double inflation_radius)
+{
+    build(V, V, E, F, inflation_radius);
+}
+
+void HashGridGPU::build(
+    ConstMatrixXdRef V0,
+    ConstMatrixXdRef V1,
+    const Eigen::MatrixXi& E,
+    const Eigen::MatrixXi& F,
+    double inflation_radius)
+{
+    assert(V0.rows() == V1.rows() && V0.cols() == V1.cols());
+
+    CopyMeshBroadPhase::copy_mesh(E, F);
+    num_vertices = V0.rows();
+    m_num_overlaps = 0;
+
+    const long num_elements = V0.rows() + E.rows() + F.rows();
+    if (num_elements == 0) {
+        return;
+    }
+
+    // The kernels work in 3D; pad 2D meshes with a zero z-coordinate.
+    Eigen::Matrix<double, Eigen::Dynamic, 3, Eigen::RowMajor> V0_3 =
+        Eigen::Matrix<double, Eigen::Dynamic, 3, Eigen::RowMajor>::Zero(
+            V0.rows(), 3);
+    Eigen::Matrix<double, Eigen::Dynamic, 3, Eigen::RowMajor> V1_3 = V0_3;
+    V0_3.leftCols(V0.cols()) = V0;
+    V1_3.leftCols(V1.cols()) = V1;
+
+    DeviceGrid grid;
+    const Eigen::RowVector3d scene_min =
+        V0_3.colwise().minCoeff().cwiseMin(V1_3.colwise().minCoeff()).array()
+        - inflation_radius;
+    const Eigen::RowVector3d scene_max =
+        V0_3.colwise().maxCoeff().cwiseMax(V1_3.colwise().maxCoeff()).array()
+        + inflation_radius;
+    const Eigen::RowVector3d range = scene_max - scene_min;
+
+    double cell_size = suggest_good_voxel_size(V0, V1, E, inflation_radius);
+    if (!std::isfinite(cell_size) || cell_size <= 0) {
+        cell_size = std::max(range.maxCoeff(), 1.0);
+    }
+
+    grid.origin = make_double3(scene_min.x(), scene_min.y(), scene_min.z());
+    grid.inv_cell_size = 1.0 / cell_size;
+    // Cap the grid so the cell keys fit an int even for huge scenes.
+    const auto grid_dim = [&](int d) {
+        return std::max(
+            1, std::min(1 << 10, int(std::ceil(range[d] / cell_size))));
+    };
+    grid.dims = make_int3(grid_dim(0), grid_dim(1), grid_dim(2));
+
+    // Upload the mesh and compute the element boxes.
+    thrust::device_vector<double> d_V0(
+        V0_3.data(), V0_3.data() + V0_3.size());
+    thrust::device_vector<double> d_V1(
+        V1_3.data(), V1_3.data() + V1_3.size());
+    const Eigen::Matrix<int, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>
+        E_r = E, F_r = F;
+    thrust::device_vector<int> d_E(E_r.data(), E_r.data() + E_r.size());
+    thrust::device_vector<int> d_F(F_r.data(), F_r.data() + F_r.size());
+
+    thrust::device_vector<double3> d_box_min(num_elements);
+    thrust::device_vector<double3> d_box_max(num_elements);
+    compute_boxes_kernel<<<num_blocks(num_elements), BLOCK_SIZE>>>(
+        num_elements, V0.rows(), E.rows(),
+        thrust::raw_pointer_cast(d_V0.data()),
+        thrust::raw_pointer_cast(d_V1.data()),
+        thrust::raw_pointer_cast(d_E.data()),
+        thrust::raw_pointer_cast(d_F.data()), inflation_radius,
+        thrust::raw_pointer_cast(d_box_min.data()),
+        thrust::raw_pointer_cast(d_box_max.data()));
+
+    // Hash the boxes into the grid: count cells per element, scan, fill, and
+    // sort the (cell, element) pairs by cell.
+    thrust::device_vector<int> d_counts(num_elements + 1, 0);
+    count_cells_kernel<<<num_blocks(num_elements), BLOCK_SIZE>>>(
+        num_elements, grid, thrust::raw_pointer_cast(d_box_min.data()),
+        thrust::raw_pointer_cast(d_box_max.data()),
+        thrust::raw_pointer_cast(d_counts.data()));
+    thrust::exclusive_scan(
+        thrust::device, d_counts.begin(), d_counts.end(), d_counts.begin());
+    const int num_items = d_counts.back();
+
+    thrust::device_vector<int> d_cell_keys(num_items);
+    thrust::device_vector<int> d_cell_ids(num_items);
+    fill_cells_kernel<<<num_blocks(num_elements), BLOCK_SIZE>>>(
+        num_elements, grid, thrust::raw_pointer_cast(d_box_min.data()),
+        thrust::raw_pointer_cast(d_box_max.data()),
+        thrust::raw_pointer_cast(d_counts.data()),
+        thrust::raw_pointer_cast(d_cell_keys.data()),
+        thrust::raw_pointer_cast(d_cell_ids.data()));
+    thrust::sort_by_key(
+        thrust::device, d_cell_keys.begin(), d_cell_keys.end(),
+        d_cell_ids.begin());
+
+    // Detect the overlapping pairs within each cell (count, scan, write),
+    // then sort and deduplicate them on the device.
+    const long tri_start = V0.rows() + E.rows();
+    thrust::device_vector<int> d_overlap_counts(num_items + 1, 0);
+    count_overlaps_kernel<<<num_blocks(num_items), BLOCK_SIZE>>>(
+        num_items, thrust::raw_pointer_cast(d_cell_keys.data()),
+        thrust::raw_pointer_cast(d_cell_ids.data()),
+        thrust::raw_pointer_cast(d_box_min.data()),
+        thrust::raw_pointer_cast(d_box_max.data()), V0.rows(), tri_start,
+        thrust::raw_pointer_cast(d_overlap_counts.data()));
+    thrust::exclusive_scan(
+        thrust::device, d_overlap_counts.begin(), d_overlap_counts.end(),
+        d_overlap_counts.begin());
+    const int num_overlaps = d_overlap_counts.back();
+
+    thrust::device_vector<uint64_t> d_overlaps(num_overlaps);
+    write_overlaps_kernel<<<num_blocks(num_items), BLOCK_SIZE>>>(
+        num_items, thrust::raw_pointer_cast(d_cell_keys.data()),
+        thrust::raw_pointer_cast(d_cell_ids.data()),
+        thrust::raw_pointer_cast(d_box_min.data()),
+        thrust::raw_pointer_cast(d_box_max.data()), V0.rows(), tri_start,
+        thrust::raw_pointer_cast(d_overlap_counts.data()),
+        thrust::raw_pointer_cast(d_overlaps.data()));
+    thrust::sort(thrust::device, d_overlaps.begin(), d_overlaps.end());
+    const auto overlaps_end = thrust::unique(
+        thrust::device, d_overlaps.begin(), d_overlaps.end());
+    m_num_overlaps = overlaps_end - d_overlaps.begin();
+
+    // Read the overlaps back through the pinned buffer.
+    reserve_overlaps(m_num_overlaps);
+    check_cuda(cudaMemcpy(
+        m_overlaps, thrust::raw_pointer_cast(d_overlaps.data()),
+        m_num_overlaps * sizeof(uint64_t), cudaMemcpyDeviceToHost));
+    check_cuda(cudaGetLastError());
+}
+
+void HashGridGPU::clear()
+{
+    BroadPhase::clear();
+    num_vertices = 0;
+    m_num_overlaps = 0; // keep the pinned buffer for the next build
+}
+
+void HashGridGPU::detect_edge_vertex_candidates(
+    std::vector<EdgeVertexCandidate>& candidates) const
+{
+    // The packed pairs are ordered by unified id, so the vertex comes first.
+    for (size_t i = 0; i < m_num_overlaps; i++) {
+        const long id1 = long(m_overlaps[i] >> 32);
+        const long id2 = long(m_overlaps[i] & 0xFFFFFFFF);
+        if (is_vertex(id1) && is_edge(id2)
+            && can_edge_vertex_collide(to_edge_id(id2), id1)) {
+            candidates.emplace_back(to_edge_id(id2), id1);
+        }
+    }
+}
+
+void HashGridGPU::detect_edge_edge_candidates(
+    std::vector<EdgeEdgeCandidate>& candidates) const
+{
+    for (size_t i = 0; i < m_num_overlaps; i++) {
+        const long id1 = long(m_overlaps[i] >> 32);
+        const long id2 = long(m_overlaps[i] & 0xFFFFFFFF);
+        if (is_edge(id1) && is_edge(id2)
+            && can_edges_collide(to_edge_id(id1), to_edge_id(id2))) {
+            candidates.emplace_back(to_edge_id(id1), to_edge_id(id2));
+        }
+    }
+}
+
+void HashGridGPU::detect_face_vertex_candidates(
+    std::vector<FaceVertexCandidate>& candidates) const
+{
+    for (size_t i = 0; i < m_num_overlaps; i++) {
+        const long id1 = long(m_overlaps[i] >> 32);
+        const long id2 = long(m_overlaps[i] & 0xFFFFFFFF);
+        if (is_vertex(id1) && is_face(id2)
+            && can_face_vertex_collide(to_face_id(id2), id1)) {
+            candidates.emplace_back(to_face_id(id2), id1);
+        }
+    }
+}
+
+void HashGridGPU::detect_edge_face_candidates(
+    std::vector<EdgeFaceCandidate>& candidates) const
+{
+    for (size_t i = 0; i < m_num_overlaps; i++) {
+        const long id1 = long(m_overlaps[i] >> 32);
+        const long id2 = long(m_overlaps[i] & 0xFFFFFFFF);
+        if (is_edge(id1) && is_face(id2)
+            && can_edge_face_collide(to_edge_id(id1), to_face_id(id2))) {
+            candidates.emplace_back(to_edge_id(id1), to_face_id(id2));
+        }
+    }
+}
+
+long HashGridGPU::to_edge_id(long id) const
+{
+    assert(id >= num_vertices);
+    assert(id < num_vertices + this->edges.rows());
+    return id - num_vertices;
+}
+
+long HashGridGPU::to_face_id(long id) const
+{
+    assert(id >= num_vertices + this->edges.rows());
+    assert(id < num_vertices + this->edges.rows() + this->faces.rows());
+    return id - num_vertices - this->edges.rows();
+}
+
+bool HashGridGPU::is_vertex(long id) const
+{
+    return id >= 0 && id < num_vertices;
+}
+
+bool HashGridGPU::is_edge(long id) const
+{
+    return id >= num_vertices && id < num_vertices + this->edges.rows();
+}
+
+bool HashGridGPU::is_face(long id) const
+{
+    return id >= num_vertices + this->edges.rows()
+        && id < num_vertices + this->edges.rows() + this->faces.rows();
+}
+
+} // namespace ipc
+
+#endif
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <ipc/config.hpp>
+
+#ifdef IPC_TOOLKIT_WITH_CUDA
+
+#include <ipc/broad_phase/sweep_and_tiniest_queue.hpp> // CopyMeshBroadPhase
+#include <ipc/utils/eigen_ext.hpp>
+
+#include <cstdint>
+
+namespace ipc {
+
+/// @brief GPU hash-grid broad phase.
+///
+/// Unlike SweepAndTiniestQueueGPU, which is only wired into the CCD step-size
+/// query, this broad phase serves the static (per-Newton-iteration) candidate
+/// construction path: build() computes the element AABBs, hashes them into a
+/// uniform grid, and detects the overlapping pairs on the device, then reads
+/// the deduplicated overlap list back into a pinned host buffer so the
+/// device-to-host transfer does not stage through pageable memory. The
+/// detect_* methods filter the overlap list into typed candidates on the
+/// host, like the other broad phases.
+class HashGridGPU : public CopyMeshBroadPhase {
+public:
+    HashGridGPU() { }
+    virtual ~HashGridGPU();
+
+    /// @brief Build the broad phase for static collision detection.
+    /// @param V0 Positions of the vertices.
+    /// @param E Edges of the mesh.
+    /// @param F Faces of the mesh.
+    /// @param inflation_radius Radius of inflation around all elements.
+    void build(
+        ConstMatrixXdRef V,
+        const Eigen::MatrixXi& E,
+        const Eigen::MatrixXi& F,
+        double inflation_radius = 0) override;
+
+    /// @brief Build the broad phase for continuous collision detection.
+    /// @param V0 Starting positions of the vertices.
+    /// @param V1 Ending positions of the vertices.
+    /// @param E Edges of the mesh.
+    /// @param F Faces of the mesh.
+    /// @param inflation_radius Radius of inflation around all elements.
+    void build(
+        ConstMatrixXdRef V0,
+        ConstMatrixXdRef V1,
+        const Eigen::MatrixXi& E,
+        const Eigen::MatrixXi& F,
+        double inflation_radius = 0) override;
+
+    /// @brief Clear any built data (the pinned buffer is kept for reuse).
+    void clear() override;
+
+    /// @brief Find the candidate edge-vertex collisisons.
+    void detect_edge_vertex_candidates(
+        std::vector<EdgeVertexCandidate>& candidates) const override;
+
+    /// @brief Find the candidate edge-edge collisions.
+    void detect_edge_edge_candidates(
+        std::vector<EdgeEdgeCandidate>& candidates) const override;
+
+    /// @brief Find the candidate face-vertex collisions.
+    void detect_face_vertex_candidates(
+        std::vector<FaceVertexCandidate>& candidates) const override;
+
+    /// @brief Find the candidate edge-face intersections.
+    void detect_edge_face_candidates(
+        std::vector<EdgeFaceCandidate>& candidates) const override;
+
+protected:
+    long to_edge_id(long id) const;
+    long to_face_id(long id) const;
+
+    bool is_vertex(long id) const;
+    bool is_edge(long id) const;
+    bool is_face(long id) const;
+
+    /// @brief Grow the pinned overlap buffer to hold at least size pairs.
+    void reserve_overlaps(size_t size);
+
+    /// @brief Overlap pairs packed as (lo << 32) | hi in the unified
+    /// vertex/edge/face index space, sorted and deduplicated on the device.
+    /// The buffer is pinned (cudaMallocHost) and retained across builds.
+    uint64_t* m_overlaps = nullptr;
+    size_t m_num_overlaps = 0;
+    size_t m_overlaps_capacity = 0;
+
+    long num_vertices = 0;
+};
+
+} // namespace ipc
+
+#endif
@@ -4,7 +4,9 @@
 
 #include <ipc/ccd/aabb.hpp>
 #include <ipc/broad_phase/voxel_size_heuristic.hpp>
-#include <ipc/utils/merge_thread_local_vectors.hpp>
+#include <ipc/utils/counting_emission.hpp>
+#include <ipc/utils/logger.hpp>
+#include <ipc/utils/small_vector.hpp>
 
 #include <ipc/config.hpp>
 
@@ -12,13 +14,31 @@
 #include <tbb/parallel_for.h>
 #include <tbb/parallel_sort.h>
 
-// Uncomment this to construct spatial hash in parallel.
-// #define IPC_TOOLKIT_PARALLEL_SH_CONSTRUCT
+#include <limits>
 
 namespace ipc {
 
+void FlatVoxelMap::build(std::vector<std::pair<int, int>>&& voxelIdPairs)
+{
+    clear();
+
+    // Sorting groups the ids of each voxel contiguously; this is the only
+    // super-linear step and it runs in parallel.
+    tbb::parallel_sort(voxelIdPairs.begin(), voxelIdPairs.end());
+
+    ids.reserve(voxelIdPairs.size());
+    for (const auto& [voxelInd, id] : voxelIdPairs) {
+        if (keys.empty() || keys.back() != voxelInd) {
+            keys.push_back(voxelInd);
+            offsets.push_back(int(ids.size()));
+        }
+        ids.push_back(id);
+    }
+    offsets.push_back(int(ids.size()));
+}
+
 void SpatialHash::build(
-    const Eigen::MatrixXd& V,
+    ConstMatrixXdRef V,
     const Eigen::MatrixXi& E,
     const Eigen::MatrixXi& F,
     double inflation_radius,
@@ -27,9 +47,26 @@ void SpatialHash::build(
     build(V, V, E, F, inflation_radius, voxelSize);
 }
 
+void SpatialHash::set_morton_ordering(const bool use_morton_ordering)
+{
+    if (use_morton_ordering) {
+        logger().warn(
+            "SpatialHash does not support Morton ordering; ignoring it!");
+    }
+}
+
+void SpatialHash::set_active_zones(
+    const std::vector<AABB>& zones, const int /*fallback_period*/)
+{
+    if (!zones.empty()) {
+        logger().warn(
+            "SpatialHash does not support active zones; ignoring them!");
+    }
+}
+
 void SpatialHash::build(
-    const Eigen::MatrixXd& V0,
-    const Eigen::MatrixXd& V1,
+    ConstMatrixXdRef V0,
+    ConstMatrixXdRef V1,
     const Eigen::MatrixXi& E,
     const Eigen::MatrixXi& F,
     double inflation_radius,
@@ -38,12 +75,16 @@ void SpatialHash::build(
     assert(V0.rows() == V1.rows() && V0.cols() == V1.cols());
 
     BroadPhase::build(V0, V1, E, F, inflation_radius); // also calls clear()
+    StatsTimer timer(m_enable_stats, m_stats.build_time);
 
     dim = V0.cols();
     builtInRadius = inflation_radius;
 
     if (voxelSize <= 0) {
-        voxelSize = suggest_good_voxel_size(V0, V1, E, inflation_radius);
+        voxelSize = edge_length_median_hint >= 0
+            ? suggest_good_voxel_size(
+                V0, V1, edge_length_median_hint, inflation_radius)
+            : suggest_good_voxel_size(V0, V1, E, inflation_radius);
     }
 
     leftBottomCorner =
@@ -80,56 +121,69 @@ void SpatialHash::build(
         vertexMaxVAI[vi].head(dim) = vVAIMax;
     });
 
-    // #ifdef IPC_TOOLKIT_PARALLEL_SH_CONSTRUCT
-    //     std::vector<std::pair<int, int>> voxel_tmp;
-    //
-    //     for (int vi = 0; vi < V.rows(); vi++) {
-    //         voxel_tmp.emplace_back(locateVoxelIndex(V.row(vi)), vi);
-    //     }
-    // #else
-    //     for (int vi = 0; vi < V.rows(); vi++) {
-    //         voxel[locateVoxelIndex(V.row(vi))].emplace_back(vi);
-    //     }
-    // #endif
-
-    pointAndEdgeOccupancy.resize(triStartInd);
-
+    // The number of voxels each element overlaps is known exactly, so the
+    // occupancy lists can be carved out of the reusable arenas up front
+    // instead of heap-allocating one vector per element.
+    std::vector<int> occupancySizes(triStartInd);
     tbb::parallel_for(size_t(0), size_t(V0.rows()), [&](size_t vi) {
         const Eigen::Array3i &mins = vertexMinVAI[vi], &maxs = vertexMaxVAI[vi];
         assert((mins <= maxs).all());
-        pointAndEdgeOccupancy[vi].reserve((maxs - mins + 1).prod());
+        occupancySizes[vi] = hashVertices ? (maxs - mins + 1).prod() : 0;
+    });
+    tbb::parallel_for(size_t(0), size_t(E.rows()), [&](size_t ei) {
+        const Eigen::Array3i mins =
+            vertexMinVAI[E(ei, 0)].min(vertexMinVAI[E(ei, 1)]);
+        const Eigen::Array3i maxs =
+            vertexMaxVAI[E(ei, 0)].max(vertexMaxVAI[E(ei, 1)]);
+        occupancySizes[ei + edgeStartInd] = (maxs - mins + 1).prod();
+    });
+    pointAndEdgeOccupancy.reset(occupancySizes);
+
+    const size_t numHashedVerts = hashVertices ? size_t(V0.rows()) : 0;
+    tbb::parallel_for(size_t(0), numHashedVerts, [&](size_t vi) {
+        const Eigen::Array3i &mins = vertexMinVAI[vi], &maxs = vertexMaxVAI[vi];
+        int* out = pointAndEdgeOccupancy.list(vi);
         for (int iz = mins[2]; iz <= maxs[2]; iz++) {
             int zOffset = iz * voxelCount0x1;
             for (int iy = mins[1]; iy <= maxs[1]; iy++) {
                 int yzOffset = iy * voxelCount[0] + zOffset;
                 for (int ix = mins[0]; ix <= maxs[0]; ix++) {
-                    pointAndEdgeOccupancy[vi].emplace_back(ix + yzOffset);
+                    *(out++) = ix + yzOffset;
                 }
             }
         }
     });
 
     tbb::parallel_for(size_t(0), size_t(E.rows()), [&](size_t ei) {
-        int eiInd = ei + edgeStartInd;
-
         Eigen::Array3i mins =
             vertexMinVAI[E(ei, 0)].min(vertexMinVAI[E(ei, 1)]);
         Eigen::Array3i maxs =
             vertexMaxVAI[E(ei, 0)].max(vertexMaxVAI[E(ei, 1)]);
 
-        pointAndEdgeOccupancy[eiInd].reserve((maxs - mins + 1).prod());
+        int* out = pointAndEdgeOccupancy.list(ei + edgeStartInd);
         for (int iz = mins[2]; iz <= maxs[2]; iz++) {
             int zOffset = iz * voxelCount0x1;
             for (int iy = mins[1]; iy <= maxs[1]; iy++) {
                 int yzOffset = iy * voxelCount[0] + zOffset;
                 for (int ix = mins[0]; ix <= maxs[0]; ix++) {
-                    pointAndEdgeOccupancy[eiInd].emplace_back(ix + yzOffset);
+                    *(out++) = ix + yzOffset;
                 }
             }
         }
     });
 
-    std::vector<std::vector<int>> voxelLoc_f(F.rows());
+    std::vector<int> faceOccupancySizes(F.rows());
+    tbb::parallel_for(size_t(0), size_t(F.rows()), [&](size_t fi) {
+        const Eigen::Array3i mins = vertexMinVAI[F(fi, 0)]
+                                        .min(vertexMinVAI[F(fi, 1)])
+                                        .min(vertexMinVAI[F(fi, 2)]);
+        const Eigen::Array3i maxs = vertexMaxVAI[F(fi, 0)]
+                                        .max(vertexMaxVAI[F(fi, 1)])
+                                        .max(vertexMaxVAI[F(fi, 2)]);
+        faceOccupancySizes[fi] = (maxs - mins + 1).prod();
+    });
+    faceOccupancy.reset(faceOccupancySizes);
+
     tbb::parallel_for(size_t(0), size_t(F.rows()), [&](size_t fi) {
         Eigen::Array3i mins = vertexMinVAI[F(fi, 0)]
                                   .min(vertexMinVAI[F(fi, 1)])
@@ -138,65 +192,89 @@ void SpatialHash::build(
                                   .max(vertexMaxVAI[F(fi, 1)])
                                   .max(vertexMaxVAI[F(fi, 2)]);
 
+        int* out = faceOccupancy.list(fi);
         for (int iz = mins[2]; iz <= maxs[2]; iz++) {
             int zOffset = iz * voxelCount0x1;
             for (int iy = mins[1]; iy <= maxs[1]; iy++) {
                 int yzOffset = iy * voxelCount[0] + zOffset;
                 for (int ix = mins[0]; ix <= maxs[0]; ix++) {
-                    voxelLoc_f[fi].emplace_back(ix + yzOffset);
+                    *(out++) = ix + yzOffset;
                 }
             }
         }
     });
 
-    // #ifdef IPC_TOOLKIT_PARALLEL_SH_CONSTRUCT
-    //     for (int ei = 0; ei < voxelLoc_e.size(); ei++) {
-    //         for (const auto& voxelI : voxelLoc_e[ei]) {
-    //             voxel_tmp.emplace_back(voxelI, ei + edgeStartInd);
-    //         }
-    //     }
-    //
-    //     for (int fi = 0; fi < voxelLoc_f.size(); fi++) {
-    //         for (const auto& voxelI : voxelLoc_f[fi]) {
-    //             voxel_tmp.emplace_back(voxelI, fi + triStartInd);
-    //         }
-    //     }
-    //
-    //     // Sort the voxels based on the voxel indices
-    //     tbb::parallel_sort(
-    //         voxel_tmp.begin(), voxel_tmp.end(),
-    //         [](const std::pair<int, int>& f, const std::pair<int, int>& s) {
-    //             return f.first < s.first;
-    //         });
-    //
-    //     std::vector<std::pair<int, std::vector<int>>> voxel_tmp_merged;
-    //     voxel_tmp_merged.reserve(voxel_tmp.size());
-    //     int current_voxel = -1;
-    //     for (const auto& v : voxel_tmp) {
-    //         if (current_voxel != v.first) {
-    //             assert(current_voxel < v.first);
-    //             voxel_tmp_merged.emplace_back();
-    //             voxel_tmp_merged.back().first = v.first;
-    //             current_voxel = v.first;
-    //         }
-    //
-    //         voxel_tmp_merged.back().second.push_back(v.second);
-    //     }
-    //     assert(voxel_tmp_merged.size() <= voxel_tmp.size());
-    //
-    //     voxel.insert(voxel_tmp_merged.begin(), voxel_tmp_merged.end());
-    // #else
-    for (int i = 0; i < pointAndEdgeOccupancy.size(); i++) {
+    // Flatten the per-element occupancy lists into (voxel, id) pairs and
+    // build the CSR voxel map from them.
+    std::vector<std::pair<int, int>> voxelIdPairs;
+    voxelIdPairs.reserve(
+        pointAndEdgeOccupancy.total_size() + faceOccupancy.total_size());
+    for (size_t i = 0; i < pointAndEdgeOccupancy.size(); i++) {
         for (const auto& voxelI : pointAndEdgeOccupancy[i]) {
-            voxel[voxelI].emplace_back(i);
+            voxelIdPairs.emplace_back(voxelI, int(i));
+        }
+    }
+    for (size_t fi = 0; fi < faceOccupancy.size(); fi++) {
+        for (const auto& voxelI : faceOccupancy[fi]) {
+            voxelIdPairs.emplace_back(voxelI, int(fi) + triStartInd);
         }
     }
-    for (int fi = 0; fi < voxelLoc_f.size(); fi++) {
-        for (const auto& voxelI : voxelLoc_f[fi]) {
-            voxel[voxelI].emplace_back(fi + triStartInd);
+    voxel.build(std::move(voxelIdPairs));
+}
+
+void SpatialHash::collect_stats(BroadPhaseStats& stats) const
+{
+    stats.boxes_per_cell_histogram.clear();
+    for (size_t ki = 0; ki < voxel.numVoxels(); ki++) {
+        stats.add_occupied_cell(voxel.voxelSize(ki));
+    }
+}
+
+void SpatialHash::queryBoxForPrimitives(
+    const ArrayMax3d& leftBottom,
+    const ArrayMax3d& rightTop,
+    std::vector<int>& vertInds,
+    std::vector<int>& edgeInds,
+    std::vector<int>& triInds) const
+{
+    ArrayMax3i mins, maxs;
+    locateVoxelAxisIndex(leftBottom.matrix(), mins);
+    locateVoxelAxisIndex(rightTop.matrix(), maxs);
+    mins = mins.max(ArrayMax3i::Zero(dim));
+    maxs = maxs.min(voxelCount - 1);
+
+    vertInds.clear();
+    edgeInds.clear();
+    triInds.clear();
+    int min_z = mins.size() >= 3 ? mins[2] : 0;
+    int max_z = maxs.size() >= 3 ? maxs[2] : 0;
+    for (int iz = min_z; iz <= max_z; iz++) {
+        int zOffset = iz * voxelCount0x1;
+        for (int iy = mins[1]; iy <= maxs[1]; iy++) {
+            int yzOffset = iy * voxelCount[0] + zOffset;
+            for (int ix = mins[0]; ix <= maxs[0]; ix++) {
+                const auto voxelI = voxel.voxelIds(ix + yzOffset);
+                for (const auto& indI : voxelI) {
+                    if (indI < edgeStartInd) {
+                        vertInds.emplace_back(indI);
+                    } else if (indI < triStartInd) {
+                        edgeInds.emplace_back(indI - edgeStartInd);
+                    } else {
+                        triInds.emplace_back(indI - triStartInd);
+                    }
+                }
+            }
         }
     }
-    // #endif
+
+    std::sort(vertInds.begin(), vertInds.end());
+    vertInds.erase(
+        std::unique(vertInds.begin(), vertInds.end()), vertInds.end());
+    std::sort(edgeInds.begin(), edgeInds.end());
+    edgeInds.erase(
+        std::unique(edgeInds.begin(), edgeInds.end()), edgeInds.end());
+    std::sort(triInds.begin(), triInds.end());
+    triInds.erase(std::unique(triInds.begin(), triInds.end()), triInds.end());
 }
 
 void SpatialHash::queryPointForTriangles(
@@ -217,9 +295,9 @@ void SpatialHash::queryPointForTriangles(
         for (int iy = mins[1]; iy <= maxs[1]; iy++) {
             int yzOffset = iy * voxelCount[0] + zOffset;
             for (int ix = mins[0]; ix <= maxs[0]; ix++) {
-                const auto voxelI = voxel.find(ix + yzOffset);
-                if (voxelI != voxel.end()) {
-                    for (const auto& indI : voxelI->second) {
+                const auto voxelI = voxel.voxelIds(ix + yzOffset);
+                if (!voxelI.empty()) {
+                    for (const auto& indI : voxelI) {
                         if (indI >= triStartInd) {
                             triInds.insert(indI - triStartInd);
                         }
@@ -250,9 +328,9 @@ void SpatialHash::queryPointForTriangles(
         for (int iy = mins[1]; iy <= maxs[1]; iy++) {
             int yzOffset = iy * voxelCount[0] + zOffset;
             for (int ix = mins[0]; ix <= maxs[0]; ix++) {
-                const auto voxelI = voxel.find(ix + yzOffset);
-                if (voxelI != voxel.end()) {
-                    for (const auto& indI : voxelI->second) {
+                const auto voxelI = voxel.voxelIds(ix + yzOffset);
+                if (!voxelI.empty()) {
+                    for (const auto& indI : voxelI) {
                         if (indI >= triStartInd) {
                             triInds.insert(indI - triStartInd);
                         }
@@ -287,9 +365,9 @@ void SpatialHash::queryPointForPrimitives(
         for (int iy = mins[1]; iy <= maxs[1]; iy++) {
             int yzOffset = iy * voxelCount[0] + zOffset;
             for (int ix = mins[0]; ix <= maxs[0]; ix++) {
-                const auto voxelI = voxel.find(ix + yzOffset);
-                if (voxelI != voxel.end()) {
-                    for (const auto& indI : voxelI->second) {
+                const auto voxelI = voxel.voxelIds(ix + yzOffset);
+                if (!voxelI.empty()) {
+                    for (const auto& indI : voxelI) {
                         if (indI < edgeStartInd) {
                             vertInds.insert(indI);
                         } else if (indI < triStartInd) {
@@ -328,9 +406,9 @@ void SpatialHash::queryEdgeForPE(
         for (int iy = mins[1]; iy <= maxs[1]; iy++) {
             int yzOffset = iy * voxelCount[0] + zOffset;
             for (int ix = mins[0]; ix <= maxs[0]; ix++) {
-                const auto voxelI = voxel.find(ix + yzOffset);
-                if (voxelI != voxel.end()) {
-                    for (const auto& indI : voxelI->second) {
+                const auto voxelI = voxel.voxelIds(ix + yzOffset);
+                if (!voxelI.empty()) {
+                    for (const auto& indI : voxelI) {
                         if (indI < edgeStartInd) {
                             vertInds.emplace_back(indI);
                         } else if (indI < triStartInd) {
@@ -372,9 +450,9 @@ void SpatialHash::queryEdgeForEdges(
         for (int iy = mins[1]; iy <= maxs[1]; iy++) {
             int yzOffset = iy * voxelCount[0] + zOffset;
             for (int ix = mins[0]; ix <= maxs[0]; ix++) {
-                const auto voxelI = voxel.find(ix + yzOffset);
-                if (voxelI != voxel.end()) {
-                    for (const auto& indI : voxelI->second) {
+                const auto voxelI = voxel.voxelIds(ix + yzOffset);
+                if (!voxelI.empty()) {
+                    for (const auto& indI : voxelI) {
                         if (indI >= edgeStartInd && indI < triStartInd
                             && indI - edgeStartInd > eai) {
                             edgeInds.emplace_back(indI - edgeStartInd);
@@ -391,7 +469,7 @@ void SpatialHash::queryEdgeForEdges(
 }
 
 void SpatialHash::queryEdgeForEdgesWithBBoxCheck(
-    const Eigen::MatrixXd& V,
+    ConstMatrixXdRef V,
     const Eigen::MatrixXi& E,
     const VectorMax3d& ea0,
     const VectorMax3d& ea1,
@@ -415,9 +493,9 @@ void SpatialHash::queryEdgeForEdgesWithBBoxCheck(
         for (int iy = mins[1]; iy <= maxs[1]; iy++) {
             int yzOffset = iy * voxelCount[0] + zOffset;
             for (int ix = mins[0]; ix <= maxs[0]; ix++) {
-                const auto voxelI = voxel.find(ix + yzOffset);
-                if (voxelI != voxel.end()) {
-                    for (const auto& indI : voxelI->second) {
+                const auto voxelI = voxel.voxelIds(ix + yzOffset);
+                if (!voxelI.empty()) {
+                    for (const auto& indI : voxelI) {
                         if (indI >= edgeStartInd && indI < triStartInd
                             && indI - edgeStartInd > eai) {
                             int ebi = indI - edgeStartInd;
@@ -475,9 +553,9 @@ void SpatialHash::queryEdgeForEdges(
         for (int iy = mins[1]; iy <= maxs[1]; iy++) {
             int yzOffset = iy * voxelCount[0] + zOffset;
             for (int ix = mins[0]; ix <= maxs[0]; ix++) {
-                const auto voxelI = voxel.find(ix + yzOffset);
-                if (voxelI != voxel.end()) {
-                    for (const auto& indI : voxelI->second) {
+                const auto voxelI = voxel.voxelIds(ix + yzOffset);
+                if (!voxelI.empty()) {
+                    for (const auto& indI : voxelI) {
                         if (indI >= edgeStartInd && indI < triStartInd
                             && indI - edgeStartInd > eai) {
                             edgeInds.emplace_back(indI - edgeStartInd);
@@ -516,9 +594,9 @@ void SpatialHash::queryTriangleForPoints(
         for (int iy = mins[1]; iy <= maxs[1]; iy++) {
             int yzOffset = iy * voxelCount[0] + zOffset;
             for (int ix = mins[0]; ix <= maxs[0]; ix++) {
-                const auto voxelI = voxel.find(ix + yzOffset);
-                if (voxelI != voxel.end()) {
-                    for (const auto& indI : voxelI->second) {
+                const auto voxelI = voxel.voxelIds(ix + yzOffset);
+                if (!voxelI.empty()) {
+                    for (const auto& indI : voxelI) {
                         if (indI < edgeStartInd) {
                             pointInds.insert(indI);
                         }
@@ -567,9 +645,9 @@ void SpatialHash::queryTriangleForPoints(
         for (int iy = mins[1]; iy <= maxs[1]; iy++) {
             int yzOffset = iy * voxelCount[0] + zOffset;
             for (int ix = mins[0]; ix <= maxs[0]; ix++) {
-                const auto voxelI = voxel.find(ix + yzOffset);
-                if (voxelI != voxel.end()) {
-                    for (const auto& indI : voxelI->second) {
+                const auto voxelI = voxel.voxelIds(ix + yzOffset);
+                if (!voxelI.empty()) {
+                    for (const auto& indI : voxelI) {
                         if (indI < edgeStartInd) {
                             pointInds.insert(indI);
                         }
@@ -603,9 +681,9 @@ void SpatialHash::queryTriangleForEdges(
         for (int iy = mins[1]; iy <= maxs[1]; iy++) {
             int yzOffset = iy * voxelCount[0] + zOffset;
             for (int ix = mins[0]; ix <= maxs[0]; ix++) {
-                const auto voxelI = voxel.find(ix + yzOffset);
-                if (voxelI != voxel.end()) {
-                    for (const auto& indI : voxelI->second) {
+                const auto voxelI = voxel.voxelIds(ix + yzOffset);
+                if (!voxelI.empty()) {
+                    for (const auto& indI : voxelI) {
                         if (indI >= edgeStartInd && indI < triStartInd) {
                             edgeInds.insert(indI - edgeStartInd);
                         }
@@ -638,9 +716,9 @@ void SpatialHash::queryEdgeForTriangles(
         for (int iy = mins[1]; iy <= maxs[1]; iy++) {
             int yzOffset = iy * voxelCount[0] + zOffset;
             for (int ix = mins[0]; ix <= maxs[0]; ix++) {
-                const auto voxelI = voxel.find(ix + yzOffset);
-                if (voxelI != voxel.end()) {
-                    for (const auto& indI : voxelI->second) {
+                const auto voxelI = voxel.voxelIds(ix + yzOffset);
+                if (!voxelI.empty()) {
+                    for (const auto& indI : voxelI) {
                         if (indI >= triStartInd) {
                             triInds.insert(indI - triStartInd);
                         }
@@ -661,7 +739,7 @@ void SpatialHash::queryPointForPrimitives(
     edgeInds.clear();
     triInds.clear();
     for (const auto& voxelInd : pointAndEdgeOccupancy[vi]) {
-        const auto& voxelI = voxel.at(voxelInd);
+        const auto voxelI = voxel.voxelIds(voxelInd);
         for (const auto& indI : voxelI) {
             if (indI < edgeStartInd) {
                 vertInds.insert(indI);
@@ -678,7 +756,7 @@ void SpatialHash::queryPointForEdges(int vi, unordered_set<int>& edgeInds) const
 {
     edgeInds.clear();
     for (const auto& voxelInd : pointAndEdgeOccupancy[vi]) {
-        const auto& voxelI = voxel.at(voxelInd);
+        const auto voxelI = voxel.voxelIds(voxelInd);
         for (const auto& indI : voxelI) {
             if (indI >= edgeStartInd && indI < triStartInd) {
                 edgeInds.insert(indI - edgeStartInd);
@@ -692,7 +770,7 @@ void SpatialHash::queryPointForTriangles(
 {
     triInds.clear();
     for (const auto& voxelInd : pointAndEdgeOccupancy[vi]) {
-        const auto& voxelI = voxel.at(voxelInd);
+        const auto voxelI = voxel.voxelIds(voxelInd);
         for (const auto& indI : voxelI) {
             if (indI >= triStartInd) {
                 triInds.insert(indI - triStartInd);
@@ -706,7 +784,7 @@ void SpatialHash::queryEdgeForEdges(int eai, unordered_set<int>& edgeInds) const
 {
     edgeInds.clear();
     for (const auto& voxelInd : pointAndEdgeOccupancy[eai + edgeStartInd]) {
-        const auto& voxelI = voxel.at(voxelInd);
+        const auto voxelI = voxel.voxelIds(voxelInd);
         for (const auto& indI : voxelI) {
             if (indI >= edgeStartInd && indI < triStartInd
                 && indI - edgeStartInd > eai) {
@@ -717,8 +795,8 @@ void SpatialHash::queryEdgeForEdges(int eai, unordered_set<int>& edgeInds) const
 }
 
 void SpatialHash::queryEdgeForEdgesWithBBoxCheck(
-    const Eigen::MatrixXd& V0,
-    const Eigen::MatrixXd& V1,
+    ConstMatrixXdRef V0,
+    ConstMatrixXdRef V1,
     const Eigen::MatrixXi& E,
     int eai,
     unordered_set<int>& edgeInds) const
@@ -739,7 +817,7 @@ void SpatialHash::queryEdgeForEdgesWithBBoxCheck(
 
     edgeInds.clear();
     for (const auto& voxelInd : pointAndEdgeOccupancy[eai + edgeStartInd]) {
-        const auto& voxelI = voxel.at(voxelInd);
+        const auto voxelI = voxel.voxelIds(voxelInd);
         for (const auto& indI : voxelI) {
             if (indI >= edgeStartInd && indI < triStartInd
                 && indI - edgeStartInd > eai) {
@@ -772,7 +850,7 @@ void SpatialHash::queryEdgeForTriangles(
 {
     triInds.clear();
     for (const auto& voxelInd : pointAndEdgeOccupancy[ei + edgeStartInd]) {
-        const auto& voxelI = voxel.at(voxelInd);
+        const auto voxelI = voxel.voxelIds(voxelInd);
         for (const auto& indI : voxelI) {
             if (indI >= triStartInd) {
                 triInds.insert(indI - triStartInd);
@@ -781,135 +859,303 @@ void SpatialHash::queryEdgeForTriangles(
     }
 }
 
-////////////////////////////////////////////////////////////////////////////
-// BroadPhase API
+// Caller-buffer variants: an element can occupy several of the queried
+// primitive's voxels, so the gathered ids are deduplicated by sorting the
+// caller's buffer instead of inserting into a freshly allocated set.
 
-void SpatialHash::detect_edge_vertex_candidates(
-    std::vector<EdgeVertexCandidate>& candidates) const
-{
-    tbb::enumerable_thread_specific<std::vector<EdgeVertexCandidate>> storages;
+namespace {
 
-    tbb::parallel_for(
-        tbb::blocked_range<size_t>(0ul, vertex_boxes.size()),
-        [&](const tbb::blocked_range<size_t>& range) {
-            auto& local_candidates = storages.local();
+void sort_and_deduplicate(std::vector<int>& inds)
+{
+    std::sort(inds.begin(), inds.end());
+    inds.erase(std::unique(inds.begin(), inds.end()), inds.end());
+}
 
-            for (long vi = range.begin(); vi != range.end(); vi++) {
-                const AABB& vertex_box = vertex_boxes[vi];
+} // namespace
 
-                unordered_set<int> edgeInds;
-                queryPointForEdges(vi, edgeInds);
+void SpatialHash::queryPointForPrimitives(
+    int vi,
+    std::vector<int>& vertInds,
+    std::vector<int>& edgeInds,
+    std::vector<int>& triInds) const
+{
+    vertInds.clear();
+    edgeInds.clear();
+    triInds.clear();
+    for (const auto& voxelInd : pointAndEdgeOccupancy[vi]) {
+        const auto voxelI = voxel.voxelIds(voxelInd);
+        for (const auto& indI : voxelI) {
+            if (indI < edgeStartInd) {
+                vertInds.push_back(indI);
+            } else if (indI < triStartInd) {
+                edgeInds.push_back(indI - edgeStartInd);
+            } else {
+                triInds.push_back(indI - triStartInd);
+            }
+        }
+    }
+    sort_and_deduplicate(vertInds);
+    sort_and_deduplicate(edgeInds);
+    sort_and_deduplicate(triInds);
+}
 
-                for (const auto& ei : edgeInds) {
-                    if (!can_edge_vertex_collide(ei, vi)) {
-                        continue;
-                    }
+void SpatialHash::queryPointForEdges(int vi, std::vector<int>& edgeInds) const
+{
+    edgeInds.clear();
+    for (const auto& voxelInd : pointAndEdgeOccupancy[vi]) {
+        const auto voxelI = voxel.voxelIds(voxelInd);
+        for (const auto& indI : voxelI) {
+            if (indI >= edgeStartInd && indI < triStartInd) {
+                edgeInds.push_back(indI - edgeStartInd);
+            }
+        }
+    }
+    sort_and_deduplicate(edgeInds);
+}
 
-                    const AABB& edge_box = edge_boxes[ei];
-                    if (vertex_box.intersects(edge_box)) {
-                        local_candidates.emplace_back(ei, vi);
-                    }
-                }
+void SpatialHash::queryPointForTriangles(
+    int vi, std::vector<int>& triInds) const
+{
+    triInds.clear();
+    for (const auto& voxelInd : pointAndEdgeOccupancy[vi]) {
+        const auto voxelI = voxel.voxelIds(voxelInd);
+        for (const auto& indI : voxelI) {
+            if (indI >= triStartInd) {
+                triInds.push_back(indI - triStartInd);
             }
-        });
+        }
+    }
+    sort_and_deduplicate(triInds);
+}
 
-    merge_thread_local_vectors(storages, candidates);
+// will only put edges with larger than eai index into edgeInds
+void SpatialHash::queryEdgeForEdges(int eai, std::vector<int>& edgeInds) const
+{
+    edgeInds.clear();
+    for (const auto& voxelInd : pointAndEdgeOccupancy[eai + edgeStartInd]) {
+        const auto voxelI = voxel.voxelIds(voxelInd);
+        for (const auto& indI : voxelI) {
+            if (indI >= edgeStartInd && indI < triStartInd
+                && indI - edgeStartInd > eai) {
+                edgeInds.push_back(indI - edgeStartInd);
+            }
+        }
+    }
+    sort_and_deduplicate(edgeInds);
 }
 
-void SpatialHash::detect_edge_edge_candidates(
-    std::vector<EdgeEdgeCandidate>& candidates) const
+void SpatialHash::queryEdgeForTriangles(
+    int ei, std::vector<int>& triInds) const
 {
-    tbb::enumerable_thread_specific<std::vector<EdgeEdgeCandidate>> storages;
+    triInds.clear();
+    for (const auto& voxelInd : pointAndEdgeOccupancy[ei + edgeStartInd]) {
+        const auto voxelI = voxel.voxelIds(voxelInd);
+        for (const auto& indI : voxelI) {
+            if (indI >= triStartInd) {
+                triInds.push_back(indI - triStartInd);
+            }
+        }
+    }
+    sort_and_deduplicate(triInds);
+}
 
-    tbb::parallel_for(
-        tbb::blocked_range<size_t>(0ul, edge_boxes.size()),
-        [&](const tbb::blocked_range<size_t>& range) {
-            auto& local_candidates = storages.local();
+long SpatialHash::countVoxelEntries(
+    const int index,
+    const int lower_id,
+    const int upper_id,
+    const int min_id) const
+{
+    // Duplicates across voxels are counted, so this bounds the deduplicated
+    // query size from above at a fraction of the query's cost (no gather,
+    // sort, or allocation).
+    long count = 0;
+    for (const auto& voxelInd : pointAndEdgeOccupancy[index]) {
+        for (const auto& indI : voxel.voxelIds(voxelInd)) {
+            count += lower_id <= indI && indI < upper_id && indI > min_id;
+        }
+    }
+    return count;
+}
 
-            for (long eai = range.begin(); eai != range.end(); eai++) {
-                const AABB& edge_a_box = edge_boxes[eai];
+////////////////////////////////////////////////////////////////////////////
+// BroadPhase API
 
-                unordered_set<int> edgeInds;
-                queryEdgeForEdges(eai, edgeInds);
+// The detections below count before emitting so the output is written with
+// a single allocation: the raw voxel occupancy of the queried primitive
+// (countVoxelEntries) bounds its deduplicated query result from above, so
+// the candidates can be presized without running the queries twice.
 
-                for (const auto& ebi : edgeInds) {
-                    if (eai >= ebi || !can_edges_collide(eai, ebi)) {
-                        continue;
-                    }
+void SpatialHash::detect_edge_vertex_candidates(
+    std::vector<EdgeVertexCandidate>& candidates) const
+{
+    tbb::enumerable_thread_specific<std::vector<int>> storages;
+
+    counting_scatter_append<EdgeVertexCandidate>(
+        long(vertex_boxes.size()),
+        [&](const long vi) {
+            return countVoxelEntries(vi, edgeStartInd, triStartInd);
+        },
+        [&](const long vi, EdgeVertexCandidate* out) {
+            std::vector<int>& edgeInds = storages.local();
+            queryPointForEdges(vi, edgeInds);
+
+            const AABB& vertex_box = vertex_boxes[vi];
+            long k = 0;
+            for (const auto& ei : edgeInds) {
+                if (!can_edge_vertex_collide(ei, vi)) {
+                    continue;
+                }
 
-                    const AABB& edge_b_box = edge_boxes[ebi];
-                    if (edge_a_box.intersects(edge_b_box)) {
-                        local_candidates.emplace_back(eai, ebi);
-                    }
+                if (vertex_box.intersects(edge_boxes[ei])) {
+                    out[k++] = EdgeVertexCandidate(ei, vi);
                 }
             }
-        });
+            return k;
+        },
+        candidates);
+}
 
-    merge_thread_local_vectors(storages, candidates);
+void SpatialHash::detect_edge_edge_candidates(
+    std::vector<EdgeEdgeCandidate>& candidates) const
+{
+    tbb::enumerable_thread_specific<std::vector<int>> storages;
+
+    counting_scatter_append<EdgeEdgeCandidate>(
+        long(edge_boxes.size()),
+        [&](const long eai) {
+            return countVoxelEntries(
+                eai + edgeStartInd, edgeStartInd, triStartInd,
+                eai + edgeStartInd);
+        },
+        [&](const long eai, EdgeEdgeCandidate* out) {
+            std::vector<int>& edgeInds = storages.local();
+            queryEdgeForEdges(eai, edgeInds);
+
+            const AABB& edge_a_box = edge_boxes[eai];
+            long k = 0;
+            for (const auto& ebi : edgeInds) {
+                if (eai >= ebi || !can_edges_collide(eai, ebi)) {
+                    continue;
+                }
+
+                if (edge_a_box.intersects(edge_boxes[ebi])) {
+                    out[k++] = EdgeEdgeCandidate(eai, ebi);
+                }
+            }
+            return k;
+        },
+        candidates);
 }
 
 void SpatialHash::detect_face_vertex_candidates(
     std::vector<FaceVertexCandidate>& candidates) const
 {
-    tbb::enumerable_thread_specific<std::vector<FaceVertexCandidate>> storages;
-
-    tbb::parallel_for(
-        tbb::blocked_range<size_t>(0ul, vertex_boxes.size()),
-        [&](const tbb::blocked_range<size_t>& range) {
-            auto& local_candidates = storages.local();
-
-            for (long vi = range.begin(); vi != range.end(); vi++) {
-                const AABB& vertex_box = vertex_boxes[vi];
-
-                unordered_set<int> triInds;
-                queryPointForTriangles(vi, triInds);
-
-                for (const auto& fi : triInds) {
-                    if (!can_face_vertex_collide(fi, vi)) {
-                        continue;
-                    }
+    tbb::enumerable_thread_specific<std::vector<int>> storages;
+
+    counting_scatter_append<FaceVertexCandidate>(
+        long(vertex_boxes.size()),
+        [&](const long vi) {
+            return countVoxelEntries(
+                vi, triStartInd, std::numeric_limits<int>::max());
+        },
+        [&](const long vi, FaceVertexCandidate* out) {
+            std::vector<int>& triInds = storages.local();
+            queryPointForTriangles(vi, triInds);
+
+            const AABB& vertex_box = vertex_boxes[vi];
+            long k = 0;
+            for (const auto& fi : triInds) {
+                if (!can_face_vertex_collide(fi, vi)) {
+                    continue;
+                }
 
-                    const AABB& face_box = face_boxes[fi];
-                    if (vertex_box.intersects(face_box)) {
-                        local_candidates.emplace_back(fi, vi);
-                    }
+                if (vertex_box.intersects(face_boxes[fi])) {
+                    out[k++] = FaceVertexCandidate(fi, vi);
                 }
             }
-        });
-
-    merge_thread_local_vectors(storages, candidates);
+            return k;
+        },
+        candidates);
 }
 
 void SpatialHash::detect_edge_face_candidates(
     std::vector<EdgeFaceCandidate>& candidates) const
 {
-    tbb::enumerable_thread_specific<std::vector<EdgeFaceCandidate>> storages;
+    tbb::enumerable_thread_specific<std::vector<int>> storages;
+
+    counting_scatter_append<EdgeFaceCandidate>(
+        long(edge_boxes.size()),
+        [&](const long ei) {
+            return countVoxelEntries(
+                ei + edgeStartInd, triStartInd,
+                std::numeric_limits<int>::max());
+        },
+        [&](const long ei, EdgeFaceCandidate* out) {
+            std::vector<int>& triInds = storages.local();
+            queryEdgeForTriangles(ei, triInds);
+
+            const AABB& edge_box = edge_boxes[ei];
+            long k = 0;
+            for (const auto& fi : triInds) {
+                if (!can_edge_face_collide(ei, fi)) {
+                    continue;
+                }
+
+                if (edge_box.intersects(face_boxes[fi])) {
+                    out[k++] = EdgeFaceCandidate(ei, fi);
+                }
+            }
+            return k;
+        },
+        candidates);
+}
+
+void SpatialHash::query_boxes(
+    const std::vector<AABB>& boxes, BoxQueryResult& result) const
+{
+    result.clear();
+
+    // Gather per-query id lists in parallel; flattened to CSR below. The
+    // voxel map yields candidates by cell co-occupancy, so the actual box
+    // overlap is verified before reporting an id. The lists are usually a
+    // handful of ids, so the inline small-vector storage avoids a heap
+    // allocation per query box.
+    std::vector<SmallVector<long, 8>> vert_ids(boxes.size());
+    std::vector<SmallVector<long, 8>> edge_ids(boxes.size());
+    std::vector<SmallVector<long, 8>> face_ids(boxes.size());
 
     tbb::parallel_for(
-        tbb::blocked_range<size_t>(0ul, edge_boxes.size()),
+        tbb::blocked_range<size_t>(0ul, boxes.size()),
         [&](const tbb::blocked_range<size_t>& range) {
-            auto& local_candidates = storages.local();
+            std::vector<int> vertInds, edgeInds, triInds;
 
-            for (long ei = range.begin(); ei != range.end(); ei++) {
-                const AABB& edge_box = edge_boxes[ei];
+            for (size_t i = range.begin(); i != range.end(); i++) {
+                const AABB& query = boxes[i];
 
-                unordered_set<int> triInds;
-                queryEdgeForTriangles(ei, triInds);
+                queryBoxForPrimitives(
+                    query.min, query.max, vertInds, edgeInds, triInds);
 
-                for (const auto& fi : triInds) {
-                    if (!can_edge_face_collide(ei, fi)) {
-                        continue;
+                for (const auto& vi : vertInds) {
+                    if (query.intersects(vertex_boxes[vi])) {
+                        vert_ids[i].push_back(vi);
                     }
-
-                    const AABB& face_box = face_boxes[fi];
-                    if (edge_box.intersects(face_box)) {
-                        local_candidates.emplace_back(ei, fi);
+                }
+                for (const auto& ei : edgeInds) {
+                    if (query.intersects(edge_boxes[ei])) {
+                        edge_ids[i].push_back(ei);
+                    }
+                }
+                for (const auto& fi : triInds) {
+                    if (query.intersects(face_boxes[fi])) {
+                        face_ids[i].push_back(fi);
                     }
                 }
             }
         });
 
-    merge_thread_local_vectors(storages, candidates);
+    flatten_to_csr(vert_ids, result.vertex_offsets, result.vertex_ids);
+    flatten_to_csr(edge_ids, result.edge_offsets, result.edge_ids);
+    flatten_to_csr(face_ids, result.face_offsets, result.face_ids);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -5,11 +5,127 @@
 #include <ipc/broad_phase/broad_phase.hpp>
 #include <ipc/utils/unordered_map_and_set.hpp>
 #include <ipc/utils/eigen_ext.hpp>
+#include <ipc/utils/memory_usage.hpp>
 
+#include <algorithm> // std::lower_bound
 #include <vector>
 
 namespace ipc {
 
+/// @brief A contiguous range of ids.
+struct IdRange {
+    const int* first = nullptr;
+    const int* last = nullptr;
+
+    const int* begin() const { return first; }
+    const int* end() const { return last; }
+    bool empty() const { return first == last; }
+};
+
+/// @brief CSR-style array of integer lists carved out of one reusable arena.
+///
+/// Drop-in replacement for a std::vector<std::vector<int>> whose per-list
+/// heap allocations dominate the build: all lists live in one contiguous
+/// buffer that clear() resets without freeing, so rebuilds reuse the same
+/// memory.
+class FlatLists {
+public:
+    /// @brief Allocate lists with the given sizes, resetting the arena.
+    void reset(const std::vector<int>& sizes)
+    {
+        offsets.resize(sizes.size() + 1);
+        offsets[0] = 0;
+        for (size_t i = 0; i < sizes.size(); i++) {
+            offsets[i + 1] = offsets[i] + sizes[i];
+        }
+        data.resize(offsets.back());
+    }
+
+    /// @brief Number of lists.
+    size_t size() const { return offsets.empty() ? 0 : offsets.size() - 1; }
+
+    /// @brief Total number of ints over all lists.
+    size_t total_size() const { return data.size(); }
+
+    /// @brief Bytes of heap memory held by the arena (capacity, not size).
+    size_t bytes_used() const
+    {
+        return vector_bytes_used(offsets) + vector_bytes_used(data);
+    }
+
+    /// @brief Mutable pointer to the start of the i-th list.
+    int* list(size_t i) { return data.data() + offsets[i]; }
+
+    /// @brief The i-th list as an iterable range.
+    IdRange operator[](size_t i) const
+    {
+        return { data.data() + offsets[i], data.data() + offsets[i + 1] };
+    }
+
+    void clear()
+    {
+        // Keep the capacity so rebuilds reuse the arena.
+        offsets.clear();
+        data.clear();
+    }
+
+protected:
+    std::vector<long> offsets; ///< @brief Start of each list (|lists|+1).
+    std::vector<int> data; ///< @brief Arena holding all lists back to back.
+};
+
+/// @brief Flat CSR-style voxel occupancy map.
+///
+/// Stores the (voxel, id) relation as a sorted array of occupied voxel keys
+/// with per-voxel offsets into one contiguous id array. Queries are a binary
+/// search plus a contiguous scan instead of hash probes over node-based
+/// buckets, and the build is a parallel sort instead of a heap allocation per
+/// occupied voxel.
+class FlatVoxelMap {
+public:
+    /// @brief Build the map from (voxel, id) pairs.
+    void build(std::vector<std::pair<int, int>>&& voxelIdPairs);
+
+    void clear()
+    {
+        keys.clear();
+        offsets.clear();
+        ids.clear();
+    }
+
+    /// @brief Number of occupied voxels.
+    size_t numVoxels() const { return keys.size(); }
+
+    /// @brief Bytes of heap memory held by the map (capacity, not size).
+    size_t bytes_used() const
+    {
+        return vector_bytes_used(keys) + vector_bytes_used(offsets)
+            + vector_bytes_used(ids);
+    }
+
+    /// @brief Number of ids stored in the ki-th occupied voxel.
+    size_t voxelSize(size_t ki) const
+    {
+        return offsets[ki + 1] - offsets[ki];
+    }
+
+    /// @brief The ids stored in a voxel (empty if the voxel is unoccupied).
+    IdRange voxelIds(int voxelInd) const
+    {
+        const auto it = std::lower_bound(keys.begin(), keys.end(), voxelInd);
+        if (it == keys.end() || *it != voxelInd) {
+            return IdRange();
+        }
+        const size_t ki = std::distance(keys.begin(), it);
+        return { ids.data() + offsets[ki], ids.data() + offsets[ki + 1] };
+    }
+
+protected:
+    std::vector<int> keys; ///< @brief Sorted occupied voxel indices.
+    std::vector<int> offsets; ///< @brief Start of each voxel's ids (|keys|+1).
+    std::vector<int> ids; ///< @brief Contiguous per-voxel id lists.
+};
+
 class SpatialHash : public BroadPhase {
 public: // data
     VectorMax3d leftBottomCorner, rightTopCorner;
@@ -19,18 +135,27 @@ public: // data
 
     int edgeStartInd, triStartInd;
 
-    unordered_map<int, std::vector<int>> voxel;
-    std::vector<std::vector<int>> pointAndEdgeOccupancy;
+    /// @brief If false, build() does not hash the vertices into the voxel
+    /// map, only the edges and faces. Used by TwoLevelSpatialHash, whose
+    /// coarse grid holds only oversized elements; the point-query functions
+    /// must not be used on such a hash.
+    bool hashVertices = true;
+
+    FlatVoxelMap voxel;
+    FlatLists pointAndEdgeOccupancy;
 
 protected:
     int dim;
     double builtInRadius;
+    /// @brief Voxels each face overlaps; only used during build() but kept as
+    /// a member so rebuilds reuse its arena.
+    FlatLists faceOccupancy;
 
 public: // constructor
     SpatialHash() { }
 
     SpatialHash(
-        const Eigen::MatrixXd& V,
+        ConstMatrixXdRef V,
         const Eigen::MatrixXi& E,
         const Eigen::MatrixXi& F,
         double inflation_radius = 0,
@@ -40,8 +165,8 @@ public: // constructor
     }
 
     SpatialHash(
-        const Eigen::MatrixXd& V0,
-        const Eigen::MatrixXd& V1,
+        ConstMatrixXdRef V0,
+        ConstMatrixXdRef V1,
         const Eigen::MatrixXi& E,
         const Eigen::MatrixXi& F,
         double inflation_radius = 0,
@@ -52,7 +177,7 @@ public: // constructor
 
 public: // API
     void build(
-        const Eigen::MatrixXd& V,
+        ConstMatrixXdRef V,
         const Eigen::MatrixXi& E,
         const Eigen::MatrixXi& F,
         double inflation_radius = 0) override
@@ -61,8 +186,8 @@ public: // API
     }
 
     void build(
-        const Eigen::MatrixXd& V0,
-        const Eigen::MatrixXd& V1,
+        ConstMatrixXdRef V0,
+        ConstMatrixXdRef V1,
         const Eigen::MatrixXi& E,
         const Eigen::MatrixXi& F,
         double inflation_radius = 0) override
@@ -71,27 +196,54 @@ public: // API
     }
 
     void build(
-        const Eigen::MatrixXd& V,
+        ConstMatrixXdRef V,
         const Eigen::MatrixXi& E,
         const Eigen::MatrixXi& F,
         double inflation_radius,
         double voxelSize);
 
     void build(
-        const Eigen::MatrixXd& V0,
-        const Eigen::MatrixXd& V1,
+        ConstMatrixXdRef V0,
+        ConstMatrixXdRef V1,
         const Eigen::MatrixXi& E,
         const Eigen::MatrixXi& F,
         double inflation_radius,
         double voxelSize);
 
+    /// @brief SpatialHash indexes the boxes by mesh element, so it cannot
+    /// store them in Morton order; enabling it is ignored with a warning.
+    void set_morton_ordering(const bool use_morton_ordering) override;
+
+    /// @brief For the same reason the boxes cannot be filtered to active
+    /// zones; setting them is ignored with a warning.
+    void set_active_zones(
+        const std::vector<AABB>& zones, const int fallback_period = 8) override;
+
     void clear() override
     {
         BroadPhase::clear();
         voxel.clear();
         pointAndEdgeOccupancy.clear();
+        faceOccupancy.clear();
     }
 
+    /// @brief Add the voxel map and the occupancy arenas to the count.
+    size_t bytes_used() const override
+    {
+        return record_bytes_used(
+            BroadPhase::bytes_used() + voxel.bytes_used()
+            + pointAndEdgeOccupancy.bytes_used() + faceOccupancy.bytes_used());
+    }
+
+    /// @brief Find the vertices, edges, and faces whose voxels overlap an
+    /// axis-aligned box. The box is expected to already be inflated.
+    void queryBoxForPrimitives(
+        const ArrayMax3d& leftBottom,
+        const ArrayMax3d& rightTop,
+        std::vector<int>& vertInds,
+        std::vector<int>& edgeInds,
+        std::vector<int>& triInds) const;
+
     void queryPointForTriangles(
         const VectorMax3d& p,
         unordered_set<int>& triInds,
@@ -126,7 +278,7 @@ public: // API
         int eai = -1) const;
 
     void queryEdgeForEdgesWithBBoxCheck(
-        const Eigen::MatrixXd& V,
+        ConstMatrixXdRef V,
         const Eigen::MatrixXi& E,
         const VectorMax3d& ea0,
         const VectorMax3d& ea1,
@@ -186,9 +338,35 @@ public: // API
     // will only put edges with larger than ei index into edgeInds
     void queryEdgeForEdges(int eai, unordered_set<int>& edgeInds) const;
 
+    // Caller-buffer variants of the queries above: the results are written
+    // to the given vectors (cleared, sorted, and deduplicated), so a caller
+    // looping over primitives can reuse one scratch buffer per thread
+    // instead of paying a hash-set allocation per query.
+
+    void queryPointForPrimitives(
+        int vi,
+        std::vector<int>& vertInds,
+        std::vector<int>& edgeInds,
+        std::vector<int>& triInds) const;
+
+    void queryPointForEdges(int vi, std::vector<int>& edgeInds) const;
+
+    void queryPointForTriangles(int vi, std::vector<int>& triInds) const;
+
+    // will only put edges with larger than ei index into edgeInds
+    void queryEdgeForEdges(int eai, std::vector<int>& edgeInds) const;
+
+    void queryEdgeForTriangles(int ei, std::vector<int>& triInds) const;
+
+    /// @brief Upper bound on a query's result size: the number of ids in
+    /// [lower_id, upper_id) (and > min_id) in the primitive's voxels,
+    /// counted without gathering or deduplicating them.
+    long countVoxelEntries(
+        int index, int lower_id, int upper_id, int min_id = -1) const;
+
     void queryEdgeForEdgesWithBBoxCheck(
-        const Eigen::MatrixXd& V0,
-        const Eigen::MatrixXd& V1,
+        ConstMatrixXdRef V0,
+        ConstMatrixXdRef V1,
         const Eigen::MatrixXi& E,
         int eai,
         unordered_set<int>& edgeInds) const;
@@ -214,7 +392,15 @@ public: // API
     void detect_edge_face_candidates(
         std::vector<EdgeFaceCandidate>& candidates) const override;
 
+    /// @brief Query caller-provided boxes against the voxel map.
+    void query_boxes(
+        const std::vector<AABB>& boxes,
+        BoxQueryResult& result) const override;
+
 protected: // helper functions
+    /// @brief Report the histogram of boxes per occupied voxel.
+    void collect_stats(BroadPhaseStats& stats) const override;
+
     int locateVoxelIndex(const VectorMax3d& p) const;
 
     void locateVoxelAxisIndex(
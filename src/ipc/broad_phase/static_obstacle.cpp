@@ -0,0 +1,529 @@
+#include "static_obstacle.hpp"
+
+#include <ipc/utils/memory_usage.hpp>
+#include <ipc/utils/profiler.hpp>
+
+#include <algorithm> // std::min/max
+
+namespace ipc {
+
+StaticObstacleBroadPhase::StaticObstacleBroadPhase(
+    const BroadPhaseMethod dynamic_method, const BroadPhaseMethod static_method)
+    : m_static_broad_phase(BroadPhase::make_broad_phase(static_method))
+    , m_dynamic_broad_phase(BroadPhase::make_broad_phase(dynamic_method))
+{
+}
+
+void StaticObstacleBroadPhase::set_static_vertices(
+    const std::vector<bool>& is_static_vertex)
+{
+    m_user_static_vertex = is_static_vertex;
+    m_is_static_vertex = is_static_vertex;
+    m_static_built = false;
+}
+
+void StaticObstacleBroadPhase::set_rest_epsilon(const double epsilon)
+{
+    m_rest_epsilon = epsilon;
+    // Start the rest history afresh under the new tolerance.
+    m_rest_positions.resize(0, 0);
+    m_is_static_vertex = m_user_static_vertex;
+    m_static_built = false;
+}
+
+void StaticObstacleBroadPhase::build(
+    ConstMatrixXdRef V,
+    const Eigen::MatrixXi& E,
+    const Eigen::MatrixXi& F,
+    double inflation_radius)
+{
+    IPC_PROFILE_SCOPE("StaticObstacleBroadPhase::build");
+
+    assert(E.size() == 0 || E.cols() == 2);
+    assert(F.size() == 0 || F.cols() == 3);
+
+    if (m_edges.rows() != E.rows() || m_faces.rows() != F.rows()) {
+        m_static_built = false; // The topology changed.
+    }
+    m_edges = E;
+    m_faces = F;
+    m_inflation_radius = inflation_radius;
+
+    if (m_rest_epsilon >= 0 && m_is_static_vertex != m_user_static_vertex) {
+        // Rest culling only applies to the two-position build: resting
+        // elements produce no new collisions, but their persistent
+        // proximity still matters for distance candidates.
+        m_is_static_vertex = m_user_static_vertex;
+        m_static_built = false;
+    }
+
+    if (!m_static_built || inflation_radius != m_static_inflation_radius) {
+        partition_elements(V.rows(), E, F);
+        build_static_structure(V, inflation_radius);
+    }
+
+    // Boxes of every vertex but only of the dynamic elements; the static
+    // elements' boxes live in the build-once static structure.
+    build_vertex_boxes(V, vertex_boxes, inflation_radius);
+    build_edge_boxes(vertex_boxes, m_dynamic_edges, edge_boxes);
+    build_face_boxes(vertex_boxes, m_dynamic_faces, face_boxes);
+
+    forward_filters(*m_dynamic_broad_phase);
+    m_dynamic_broad_phase->build(
+        V, m_dynamic_edges, m_dynamic_faces, inflation_radius);
+}
+
+void StaticObstacleBroadPhase::build(
+    ConstMatrixXdRef V0,
+    ConstMatrixXdRef V1,
+    const Eigen::MatrixXi& E,
+    const Eigen::MatrixXi& F,
+    double inflation_radius)
+{
+    IPC_PROFILE_SCOPE("StaticObstacleBroadPhase::build");
+
+    assert(E.size() == 0 || E.cols() == 2);
+    assert(F.size() == 0 || F.cols() == 3);
+
+    if (m_edges.rows() != E.rows() || m_faces.rows() != F.rows()) {
+        m_static_built = false; // The topology changed.
+    }
+    m_edges = E;
+    m_faces = F;
+    m_inflation_radius = inflation_radius;
+
+    if (m_rest_epsilon >= 0) {
+        update_rest_mask(V0, V1);
+    }
+
+    if (!m_static_built || inflation_radius != m_static_inflation_radius) {
+        partition_elements(V0.rows(), E, F);
+        // The static vertices do not move, so their t0 == t1 boxes built
+        // from the start positions cover the whole step.
+        if (m_rest_epsilon >= 0) {
+            // Box the resting vertices at their frozen reference positions;
+            // build_static_structure() widens the boxes to absorb the
+            // sub-epsilon drift the rest test tolerates.
+            Eigen::MatrixXd V_rest = V0;
+            for (long vi = 0; vi < V_rest.rows(); vi++) {
+                if (m_is_static_vertex[vi]) {
+                    V_rest.row(vi) = m_rest_positions.row(vi);
+                }
+            }
+            build_static_structure(V_rest, inflation_radius);
+        } else {
+            build_static_structure(V0, inflation_radius);
+        }
+    }
+
+    build_vertex_boxes(V0, V1, vertex_boxes, inflation_radius);
+    build_edge_boxes(vertex_boxes, m_dynamic_edges, edge_boxes);
+    build_face_boxes(vertex_boxes, m_dynamic_faces, face_boxes);
+
+    forward_filters(*m_dynamic_broad_phase);
+    m_dynamic_broad_phase->build(
+        V0, V1, m_dynamic_edges, m_dynamic_faces, inflation_radius);
+}
+
+void StaticObstacleBroadPhase::update_rest_mask(
+    ConstMatrixXdRef V0, ConstMatrixXdRef V1)
+{
+    const long num_vertices = V0.rows();
+
+    const auto is_user_static = [&](const long vi) {
+        return vi < long(m_user_static_vertex.size())
+            && m_user_static_vertex[vi];
+    };
+
+    if (m_rest_positions.rows() != num_vertices) {
+        // First build (or the vertex count changed): only the user-marked
+        // vertices are static; everything else has no history to rest on.
+        m_rest_positions = V0;
+        m_is_static_vertex.assign(num_vertices, false);
+        for (long vi = 0; vi < num_vertices; vi++) {
+            m_is_static_vertex[vi] = is_user_static(vi);
+        }
+        m_static_built = false;
+        return;
+    }
+
+    bool changed = false;
+    for (long vi = 0; vi < num_vertices; vi++) {
+        const bool was_static = m_is_static_vertex[vi];
+        bool is_static = is_user_static(vi);
+        if (!is_static) {
+            is_static = (V1.row(vi) - V0.row(vi)).cwiseAbs().maxCoeff()
+                    <= m_rest_epsilon
+                && (V0.row(vi) - m_rest_positions.row(vi))
+                        .cwiseAbs()
+                        .maxCoeff()
+                    <= m_rest_epsilon;
+        }
+        if (!is_static) {
+            // Track the last build so a vertex can come to rest wherever it
+            // stops; the reference freezes once it does.
+            m_rest_positions.row(vi) = V0.row(vi);
+        }
+        if (is_static != was_static) {
+            m_is_static_vertex[vi] = is_static;
+            changed = true;
+        }
+    }
+    if (changed) {
+        m_static_built = false;
+    }
+}
+
+void StaticObstacleBroadPhase::partition_elements(
+    const long num_vertices, const Eigen::MatrixXi& E, const Eigen::MatrixXi& F)
+{
+    const auto is_static_vertex = [&](const long vi) {
+        return vi < long(m_is_static_vertex.size()) && m_is_static_vertex[vi];
+    };
+
+    m_dynamic_vertex_ids.clear();
+    for (long vi = 0; vi < num_vertices; vi++) {
+        if (!is_static_vertex(vi)) {
+            m_dynamic_vertex_ids.push_back(vi);
+        }
+    }
+
+    m_static_edge_ids.clear();
+    m_dynamic_edge_ids.clear();
+    for (long ei = 0; ei < E.rows(); ei++) {
+        if (is_static_vertex(E(ei, 0)) && is_static_vertex(E(ei, 1))) {
+            m_static_edge_ids.push_back(ei);
+        } else {
+            m_dynamic_edge_ids.push_back(ei);
+        }
+    }
+
+    m_static_face_ids.clear();
+    m_dynamic_face_ids.clear();
+    for (long fi = 0; fi < F.rows(); fi++) {
+        if (is_static_vertex(F(fi, 0)) && is_static_vertex(F(fi, 1))
+            && is_static_vertex(F(fi, 2))) {
+            m_static_face_ids.push_back(fi);
+        } else {
+            m_dynamic_face_ids.push_back(fi);
+        }
+    }
+
+    const auto gather_rows = [](const Eigen::MatrixXi& M,
+                                const std::vector<long>& ids) {
+        Eigen::MatrixXi rows(ids.size(), M.cols());
+        for (size_t i = 0; i < ids.size(); i++) {
+            rows.row(i) = M.row(ids[i]);
+        }
+        return rows;
+    };
+    m_static_edges = gather_rows(E, m_static_edge_ids);
+    m_dynamic_edges = gather_rows(E, m_dynamic_edge_ids);
+    m_static_faces = gather_rows(F, m_static_face_ids);
+    m_dynamic_faces = gather_rows(F, m_dynamic_face_ids);
+}
+
+void StaticObstacleBroadPhase::build_static_structure(
+    ConstMatrixXdRef V, double inflation_radius)
+{
+    // Widen the boxes by the drift plus the sweep the rest test tolerates,
+    // so they stay valid without a rebuild while the resting set is
+    // unchanged (cf. set_build_margin()).
+    const double rest_margin = 2 * std::max(m_rest_epsilon, 0.0);
+    m_static_broad_phase->build(
+        V, m_static_edges, m_static_faces, inflation_radius + rest_margin);
+    m_static_inflation_radius = inflation_radius;
+    m_static_built = true;
+}
+
+void StaticObstacleBroadPhase::forward_filters(BroadPhase& broad_phase) const
+{
+    broad_phase.can_vertices_collide = can_vertices_collide;
+    if (m_vertex_group_ids.size() > 0) {
+        broad_phase.set_vertex_group_ids(
+            m_vertex_group_ids, m_can_groups_collide);
+    } else {
+        broad_phase.clear_vertex_group_ids();
+    }
+}
+
+void StaticObstacleBroadPhase::gather_dynamic_vertex_boxes() const
+{
+    m_scratch_boxes.clear();
+    m_scratch_boxes.reserve(m_dynamic_vertex_ids.size());
+    for (const long vi : m_dynamic_vertex_ids) {
+        m_scratch_boxes.push_back(vertex_boxes[vi]);
+    }
+}
+
+bool StaticObstacleBroadPhase::can_cross_edge_vertex_collide(
+    long ei, long vi) const
+{
+    const long e0i = m_edges(ei, 0), e1i = m_edges(ei, 1);
+    const bool can_collide = vi != e0i && vi != e1i
+        && (check_can_vertices_collide(vi, e0i)
+            || check_can_vertices_collide(vi, e1i));
+    count_filtered(can_collide);
+    return can_collide;
+}
+
+bool StaticObstacleBroadPhase::can_cross_edges_collide(
+    long eai, long ebi) const
+{
+    const long ea0i = m_edges(eai, 0), ea1i = m_edges(eai, 1);
+    const long eb0i = m_edges(ebi, 0), eb1i = m_edges(ebi, 1);
+
+    const bool share_endpoint =
+        ea0i == eb0i || ea0i == eb1i || ea1i == eb0i || ea1i == eb1i;
+
+    const bool can_collide = !share_endpoint
+        && (check_can_vertices_collide(ea0i, eb0i)
+            || check_can_vertices_collide(ea0i, eb1i)
+            || check_can_vertices_collide(ea1i, eb0i)
+            || check_can_vertices_collide(ea1i, eb1i));
+    count_filtered(can_collide);
+    return can_collide;
+}
+
+bool StaticObstacleBroadPhase::can_cross_face_vertex_collide(
+    long fi, long vi) const
+{
+    const long f0i = m_faces(fi, 0), f1i = m_faces(fi, 1),
+               f2i = m_faces(fi, 2);
+    const bool can_collide = vi != f0i && vi != f1i && vi != f2i
+        && (check_can_vertices_collide(vi, f0i)
+            || check_can_vertices_collide(vi, f1i)
+            || check_can_vertices_collide(vi, f2i));
+    count_filtered(can_collide);
+    return can_collide;
+}
+
+bool StaticObstacleBroadPhase::can_cross_edge_face_collide(
+    long ei, long fi) const
+{
+    const long e0i = m_edges(ei, 0), e1i = m_edges(ei, 1);
+    const long f0i = m_faces(fi, 0), f1i = m_faces(fi, 1),
+               f2i = m_faces(fi, 2);
+
+    const bool share_endpoint = e0i == f0i || e0i == f1i || e0i == f2i
+        || e1i == f0i || e1i == f1i || e1i == f2i;
+
+    const bool can_collide = !share_endpoint
+        && (check_can_vertices_collide(e0i, f0i)
+            || check_can_vertices_collide(e0i, f1i)
+            || check_can_vertices_collide(e0i, f2i)
+            || check_can_vertices_collide(e1i, f0i)
+            || check_can_vertices_collide(e1i, f1i)
+            || check_can_vertices_collide(e1i, f2i));
+    count_filtered(can_collide);
+    return can_collide;
+}
+
+void StaticObstacleBroadPhase::detect_edge_vertex_candidates(
+    std::vector<EdgeVertexCandidate>& candidates) const
+{
+    candidates.clear();
+
+    // Dynamic edges against every vertex (the dynamic structure boxes all
+    // vertices, so dynamic-edge–static-vertex pairs are found here).
+    m_dynamic_broad_phase->detect_edge_vertex_candidates(candidates);
+    for (EdgeVertexCandidate& candidate : candidates) {
+        candidate.edge_index = m_dynamic_edge_ids[candidate.edge_index];
+    }
+
+    // Static edges against the dynamic vertices.
+    if (!m_static_built || m_static_edge_ids.empty()) {
+        return;
+    }
+    gather_dynamic_vertex_boxes();
+    m_static_broad_phase->query_boxes(m_scratch_boxes, m_scratch_result);
+    for (size_t i = 0; i < m_scratch_boxes.size(); i++) {
+        const long vi = m_dynamic_vertex_ids[i];
+        for (long k = m_scratch_result.edge_offsets[i];
+             k < m_scratch_result.edge_offsets[i + 1]; k++) {
+            const long ei = m_static_edge_ids[m_scratch_result.edge_ids[k]];
+            if (can_cross_edge_vertex_collide(ei, vi)) {
+                candidates.emplace_back(ei, vi);
+            }
+        }
+    }
+}
+
+void StaticObstacleBroadPhase::detect_edge_edge_candidates(
+    std::vector<EdgeEdgeCandidate>& candidates) const
+{
+    candidates.clear();
+
+    m_dynamic_broad_phase->detect_edge_edge_candidates(candidates);
+    for (EdgeEdgeCandidate& candidate : candidates) {
+        candidate.edge0_index = m_dynamic_edge_ids[candidate.edge0_index];
+        candidate.edge1_index = m_dynamic_edge_ids[candidate.edge1_index];
+    }
+
+    // Dynamic edges against the static edges.
+    if (!m_static_built || m_static_edge_ids.empty()) {
+        return;
+    }
+    m_static_broad_phase->query_boxes(edge_boxes, m_scratch_result);
+    for (size_t i = 0; i < edge_boxes.size(); i++) {
+        const long eai = m_dynamic_edge_ids[i];
+        for (long k = m_scratch_result.edge_offsets[i];
+             k < m_scratch_result.edge_offsets[i + 1]; k++) {
+            const long ebi = m_static_edge_ids[m_scratch_result.edge_ids[k]];
+            if (can_cross_edges_collide(eai, ebi)) {
+                candidates.emplace_back(
+                    std::min(eai, ebi), std::max(eai, ebi));
+            }
+        }
+    }
+}
+
+void StaticObstacleBroadPhase::detect_face_vertex_candidates(
+    std::vector<FaceVertexCandidate>& candidates) const
+{
+    candidates.clear();
+
+    m_dynamic_broad_phase->detect_face_vertex_candidates(candidates);
+    for (FaceVertexCandidate& candidate : candidates) {
+        candidate.face_index = m_dynamic_face_ids[candidate.face_index];
+    }
+
+    // Static faces against the dynamic vertices.
+    if (!m_static_built || m_static_face_ids.empty()) {
+        return;
+    }
+    gather_dynamic_vertex_boxes();
+    m_static_broad_phase->query_boxes(m_scratch_boxes, m_scratch_result);
+    for (size_t i = 0; i < m_scratch_boxes.size(); i++) {
+        const long vi = m_dynamic_vertex_ids[i];
+        for (long k = m_scratch_result.face_offsets[i];
+             k < m_scratch_result.face_offsets[i + 1]; k++) {
+            const long fi = m_static_face_ids[m_scratch_result.face_ids[k]];
+            if (can_cross_face_vertex_collide(fi, vi)) {
+                candidates.emplace_back(fi, vi);
+            }
+        }
+    }
+}
+
+void StaticObstacleBroadPhase::detect_edge_face_candidates(
+    std::vector<EdgeFaceCandidate>& candidates) const
+{
+    candidates.clear();
+
+    m_dynamic_broad_phase->detect_edge_face_candidates(candidates);
+    for (EdgeFaceCandidate& candidate : candidates) {
+        candidate.edge_index = m_dynamic_edge_ids[candidate.edge_index];
+        candidate.face_index = m_dynamic_face_ids[candidate.face_index];
+    }
+
+    if (!m_static_built) {
+        return;
+    }
+
+    // Dynamic edges against the static faces.
+    if (!m_static_face_ids.empty()) {
+        m_static_broad_phase->query_boxes(edge_boxes, m_scratch_result);
+        for (size_t i = 0; i < edge_boxes.size(); i++) {
+            const long ei = m_dynamic_edge_ids[i];
+            for (long k = m_scratch_result.face_offsets[i];
+                 k < m_scratch_result.face_offsets[i + 1]; k++) {
+                const long fi =
+                    m_static_face_ids[m_scratch_result.face_ids[k]];
+                if (can_cross_edge_face_collide(ei, fi)) {
+                    candidates.emplace_back(ei, fi);
+                }
+            }
+        }
+    }
+
+    // Static edges against the dynamic faces.
+    if (!m_static_edge_ids.empty()) {
+        m_static_broad_phase->query_boxes(face_boxes, m_scratch_result);
+        for (size_t i = 0; i < face_boxes.size(); i++) {
+            const long fi = m_dynamic_face_ids[i];
+            for (long k = m_scratch_result.edge_offsets[i];
+                 k < m_scratch_result.edge_offsets[i + 1]; k++) {
+                const long ei =
+                    m_static_edge_ids[m_scratch_result.edge_ids[k]];
+                if (can_cross_edge_face_collide(ei, fi)) {
+                    candidates.emplace_back(ei, fi);
+                }
+            }
+        }
+    }
+}
+
+void StaticObstacleBroadPhase::query_boxes(
+    const std::vector<AABB>& boxes, BoxQueryResult& result) const
+{
+    // Vertex overlaps come from the dynamic structure, which boxes every
+    // vertex at its current position; the static structure's vertex boxes
+    // are from the build-time positions and are ignored.
+    m_dynamic_broad_phase->query_boxes(boxes, result);
+    for (long& id : result.edge_ids) {
+        id = m_dynamic_edge_ids[id];
+    }
+    for (long& id : result.face_ids) {
+        id = m_dynamic_face_ids[id];
+    }
+
+    if (!m_static_built) {
+        return;
+    }
+    m_static_broad_phase->query_boxes(boxes, m_scratch_result);
+
+    const auto merge = [&boxes](
+                           std::vector<long>& offsets, std::vector<long>& ids,
+                           const std::vector<long>& extra_offsets,
+                           const std::vector<long>& extra_ids,
+                           const std::vector<long>& extra_id_map) {
+        std::vector<long> merged_offsets(boxes.size() + 1, 0);
+        std::vector<long> merged_ids;
+        merged_ids.reserve(ids.size() + extra_ids.size());
+        for (size_t i = 0; i < boxes.size(); i++) {
+            for (long k = offsets[i]; k < offsets[i + 1]; k++) {
+                merged_ids.push_back(ids[k]);
+            }
+            for (long k = extra_offsets[i]; k < extra_offsets[i + 1]; k++) {
+                merged_ids.push_back(extra_id_map[extra_ids[k]]);
+            }
+            merged_offsets[i + 1] = long(merged_ids.size());
+        }
+        offsets = std::move(merged_offsets);
+        ids = std::move(merged_ids);
+    };
+    merge(
+        result.edge_offsets, result.edge_ids, m_scratch_result.edge_offsets,
+        m_scratch_result.edge_ids, m_static_edge_ids);
+    merge(
+        result.face_offsets, result.face_ids, m_scratch_result.face_offsets,
+        m_scratch_result.face_ids, m_static_face_ids);
+}
+
+void StaticObstacleBroadPhase::clear()
+{
+    BroadPhase::clear();
+    m_static_broad_phase->clear();
+    m_dynamic_broad_phase->clear();
+    m_static_built = false;
+}
+
+size_t StaticObstacleBroadPhase::bytes_used() const
+{
+    return record_bytes_used(
+        BroadPhase::bytes_used() + m_static_broad_phase->bytes_used()
+        + m_dynamic_broad_phase->bytes_used()
+        + matrix_bytes_used(m_static_edges) + matrix_bytes_used(m_static_faces)
+        + matrix_bytes_used(m_dynamic_edges)
+        + matrix_bytes_used(m_dynamic_faces)
+        + vector_bytes_used(m_static_edge_ids)
+        + vector_bytes_used(m_static_face_ids)
+        + vector_bytes_used(m_dynamic_edge_ids)
+        + vector_bytes_used(m_dynamic_face_ids)
+        + vector_bytes_used(m_dynamic_vertex_ids)
+        + matrix_bytes_used(m_rest_positions)
+        + vector_bytes_used(m_scratch_boxes));
+}
+
+} // namespace ipc
@@ -0,0 +1,171 @@
+#pragma once
+
+#include <ipc/broad_phase/broad_phase.hpp>
+#include <ipc/utils/eigen_ext.hpp>
+
+#include <memory>
+#include <vector>
+
+namespace ipc {
+
+/// @brief Broad phase for a dynamic mesh colliding against static obstacles.
+///
+/// Scenes with a large static environment pay to rebuild and re-hash the
+/// environment's boxes on every build even though they never move. This
+/// composite splits the elements of one combined mesh by a per-vertex static
+/// mask (an element is static iff all of its vertices are): the static
+/// elements go into an inner broad phase built once (with coincident CCD
+/// start and end boxes, like point_static_plane.cpp assumes for planes), and
+/// each build() only rebuilds an inner broad phase over the dynamic
+/// elements. Detection unions the dynamic structure's candidates with
+/// dynamic-versus-static pairs found by querying the dynamic element boxes
+/// against the static structure.
+///
+/// Static-static pairs are never emitted: the relative configuration of two
+/// static elements cannot change, so they contribute no collision over any
+/// step. The static vertices' rows of V must therefore be identical across
+/// builds; only set_static_vertices(), clear(), or a change of inflation
+/// radius triggers a rebuild of the static structure.
+class StaticObstacleBroadPhase : public BroadPhase {
+public:
+    /// @brief Construct the composite from two inner methods.
+    /// @param dynamic_method Method used for the per-build dynamic structure.
+    /// @param static_method Method used for the build-once static structure.
+    StaticObstacleBroadPhase(
+        const BroadPhaseMethod dynamic_method = BroadPhaseMethod::HASH_GRID,
+        const BroadPhaseMethod static_method = BroadPhaseMethod::BVH);
+
+    /// @brief Mark which vertices are static.
+    ///
+    /// An element is treated as static iff all of its vertices are marked.
+    /// Invalidates the static structure; the next build() reconstructs it.
+    /// @param is_static_vertex One flag per vertex of the collision mesh.
+    void set_static_vertices(const std::vector<bool>& is_static_vertex);
+
+    /// @brief Enable automatic rest detection with the given tolerance.
+    ///
+    /// When enabled (epsilon >= 0), the two-position build() additionally
+    /// marks vertices at rest — per-axis displacement at most epsilon and
+    /// position within epsilon of where they came to rest — as static, on
+    /// top of any set through set_static_vertices(). Two resting elements
+    /// cannot produce a new collision during a step, so omitting their
+    /// pairs is exact for CCD; the discrete build() ignores the derived
+    /// mask because persistent proximity between resting elements still
+    /// matters for distance candidates. The static structure's boxes are
+    /// inflated by an extra 2 * epsilon so the tolerated sub-epsilon motion
+    /// cannot miss an overlap, and the structure is rebuilt whenever the
+    /// resting set changes — in settling scenes the rebuilds stop once the
+    /// pile comes to rest.
+    /// @param epsilon Per-axis motion tolerated while at rest (negative
+    ///     disables rest detection).
+    void set_rest_epsilon(const double epsilon);
+
+    void build(
+        ConstMatrixXdRef V,
+        const Eigen::MatrixXi& E,
+        const Eigen::MatrixXi& F,
+        double inflation_radius = 0) override;
+
+    void build(
+        ConstMatrixXdRef V0,
+        ConstMatrixXdRef V1,
+        const Eigen::MatrixXi& E,
+        const Eigen::MatrixXi& F,
+        double inflation_radius = 0) override;
+
+    void set_morton_ordering(const bool use_morton_ordering) override
+    {
+        // The composite's own boxes stay in mesh order; the ordering only
+        // affects the inner structures.
+        m_static_broad_phase->set_morton_ordering(use_morton_ordering);
+        m_dynamic_broad_phase->set_morton_ordering(use_morton_ordering);
+    }
+
+    void set_active_zones(
+        const std::vector<AABB>& zones, const int fallback_period = 8) override
+    {
+        // Only the per-step dynamic structure is restricted: the static
+        // structure is built once and reused, so filtering it against zones
+        // that move over its lifetime would drop obstacles for good.
+        m_dynamic_broad_phase->set_active_zones(zones, fallback_period);
+    }
+
+    void clear() override;
+
+    size_t bytes_used() const override;
+
+    void detect_edge_vertex_candidates(
+        std::vector<EdgeVertexCandidate>& candidates) const override;
+
+    void detect_edge_edge_candidates(
+        std::vector<EdgeEdgeCandidate>& candidates) const override;
+
+    void detect_face_vertex_candidates(
+        std::vector<FaceVertexCandidate>& candidates) const override;
+
+    void detect_edge_face_candidates(
+        std::vector<EdgeFaceCandidate>& candidates) const override;
+
+    void query_boxes(
+        const std::vector<AABB>& boxes,
+        BoxQueryResult& result) const override;
+
+protected:
+    /// @brief Re-derive the static mask from the motion of the vertices.
+    void update_rest_mask(ConstMatrixXdRef V0, ConstMatrixXdRef V1);
+
+    /// @brief Split the vertices, edges, and faces by the static mask.
+    void partition_elements(
+        const long num_vertices,
+        const Eigen::MatrixXi& E,
+        const Eigen::MatrixXi& F);
+
+    /// @brief Build the static inner structure if it is not current.
+    void build_static_structure(ConstMatrixXdRef V, double inflation_radius);
+
+    /// @brief Hand the vertex collision filters down to an inner structure.
+    void forward_filters(BroadPhase& broad_phase) const;
+
+    /// @brief Gather the boxes of the dynamic vertices into m_scratch_boxes.
+    void gather_dynamic_vertex_boxes() const;
+
+    // Cross-pair filters in mesh (not subset) indices. The shared-vertex
+    // tests matter because a dynamic element can share a static vertex with
+    // a static element (e.g., where a deformable is pinned to the world).
+    bool can_cross_edge_vertex_collide(long ei, long vi) const;
+    bool can_cross_edges_collide(long eai, long ebi) const;
+    bool can_cross_face_vertex_collide(long fi, long vi) const;
+    bool can_cross_edge_face_collide(long ei, long fi) const;
+
+    /// @brief Inner structure over the static elements, built once.
+    std::unique_ptr<BroadPhase> m_static_broad_phase;
+    /// @brief Inner structure over the dynamic elements, built per step.
+    std::unique_ptr<BroadPhase> m_dynamic_broad_phase;
+
+    /// @brief Effective mask (empty means all vertices are dynamic).
+    std::vector<bool> m_is_static_vertex;
+    /// @brief Mask set by the caller, kept apart from the derived one.
+    std::vector<bool> m_user_static_vertex;
+    /// @brief Rest-detection tolerance (negative means disabled).
+    double m_rest_epsilon = -1;
+    /// @brief Reference positions for the rest test: frozen where a vertex
+    /// came to rest, tracking the last build elsewhere.
+    Eigen::MatrixXd m_rest_positions;
+    /// @brief Is the static inner structure built and current?
+    bool m_static_built = false;
+    /// @brief Inflation radius the static structure was built with.
+    double m_static_inflation_radius = 0;
+
+    // Element partition in mesh vertex ids plus subset-to-mesh index maps.
+    Eigen::MatrixXi m_static_edges, m_static_faces;
+    Eigen::MatrixXi m_dynamic_edges, m_dynamic_faces;
+    std::vector<long> m_static_edge_ids, m_static_face_ids;
+    std::vector<long> m_dynamic_edge_ids, m_dynamic_face_ids;
+    std::vector<long> m_dynamic_vertex_ids;
+
+    // Scratch reused by the cross-pair queries to avoid reallocating.
+    mutable std::vector<AABB> m_scratch_boxes;
+    mutable BoxQueryResult m_scratch_result;
+};
+
+} // namespace ipc
@@ -4,6 +4,8 @@
 
 #include <stq/cpu/io.hpp>
 #include <stq/cpu/sweep.hpp>
+
+#include <algorithm> // std::sort/find/min/max
 #ifdef IPC_TOOLKIT_WITH_CUDA
 #include <ccdgpu/helper.cuh>
 #endif
@@ -11,7 +13,7 @@
 namespace ipc {
 
 void SweepAndTiniestQueue::build(
-    const Eigen::MatrixXd& V,
+    ConstMatrixXdRef V,
     const Eigen::MatrixXi& E,
     const Eigen::MatrixXi& F,
     double inflation_radius)
@@ -20,18 +22,56 @@ void SweepAndTiniestQueue::build(
 }
 
 void SweepAndTiniestQueue::build(
-    const Eigen::MatrixXd& V0,
-    const Eigen::MatrixXd& V1,
+    ConstMatrixXdRef V0,
+    ConstMatrixXdRef V1,
     const Eigen::MatrixXi& E,
     const Eigen::MatrixXi& F,
     double inflation_radius)
 {
     CopyMeshBroadPhase::copy_mesh(E, F);
+    const long prev_num_vertices = num_vertices;
+    const size_t prev_num_boxes = boxes.size();
     num_vertices = V0.rows();
+    boxes.clear();
     stq::cpu::constructBoxes(V0, V1, E, F, boxes, inflation_radius);
     int n = boxes.size();
-    stq::cpu::sort_along_xaxis(boxes);
-    stq::cpu::run_sweep_cpu(boxes, n, overlaps);
+
+    const Eigen::Array3d variance = box_center_variance();
+    int best_axis = 0;
+    variance.maxCoeff(&best_axis);
+
+    if (!m_persistent) {
+        // The stq sweep always runs along x, so put the highest-variance
+        // axis there by swapping the box coordinates. The boxes are rebuilt
+        // every call and only consumed by the sweep, and box overlap is
+        // axis-order independent, so the swap is invisible downstream.
+        if (best_axis != 0) {
+            for (stq::cpu::Aabb& box : boxes) {
+                std::swap(box.min[0], box.min[best_axis]);
+                std::swap(box.max[0], box.max[best_axis]);
+            }
+        }
+        stq::cpu::sort_along_xaxis(boxes);
+        stq::cpu::run_sweep_cpu(boxes, n, overlaps);
+        return;
+    }
+
+    // Persistent mode: the boxes stay in construction order and the sorted
+    // endpoint list is carried over from the last build. Inter-step
+    // coherence keeps the list nearly sorted, so the insertion-sort repair
+    // (with swap-driven pair updates) replaces the full re-sort and sweep.
+    // Switching the sweep axis discards that coherence, so only re-initialize
+    // when the current axis has degenerated to well under the best one.
+    const bool axis_degenerated =
+        variance[best_axis] > 2 * variance[m_sweep_axis];
+    if (prev_num_vertices != num_vertices || prev_num_boxes != size_t(n)
+        || m_endpoints.size() != 2 * size_t(n) || axis_degenerated) {
+        m_sweep_axis = best_axis;
+        init_persistent_sweep();
+    } else {
+        repair_persistent_sweep();
+    }
+    emit_persistent_overlaps();
 }
 
 void SweepAndTiniestQueue::clear()
@@ -40,6 +80,154 @@ void SweepAndTiniestQueue::clear()
     num_vertices = 0;
     boxes.clear();
     overlaps.clear();
+    m_endpoints.clear();
+    m_x_overlaps.clear();
+}
+
+void SweepAndTiniestQueue::set_persistent(const bool persistent)
+{
+    m_persistent = persistent;
+    // Either switch invalidates the carried-over order (non-persistent
+    // builds sort the boxes in place), so start the next build fresh.
+    m_endpoints.clear();
+    m_x_overlaps.clear();
+}
+
+namespace {
+    /// Do the two elements share a vertex? The vertexIds padding is unique
+    /// per primitive (e.g., a vertex box is {vi, -vi-1, -vi-1}), so a
+    /// componentwise comparison is exact.
+    bool covertex(const Eigen::Vector3i& a, const Eigen::Vector3i& b)
+    {
+        for (int i = 0; i < 3; i++) {
+            for (int j = 0; j < 3; j++) {
+                if (a[i] == b[j]) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    int64_t pair_key(const int id1, const int id2)
+    {
+        return (int64_t(std::min(id1, id2)) << 32) | std::max(id1, id2);
+    }
+} // namespace
+
+bool SweepAndTiniestQueue::is_tracked_pair(const long id1, const long id2) const
+{
+    return (is_edge(id1) && is_edge(id2)) || (is_vertex(id1) && is_face(id2))
+        || (is_face(id1) && is_vertex(id2));
+}
+
+void SweepAndTiniestQueue::update_x_overlap(const int box_a, const int box_b)
+{
+    if (!is_tracked_pair(box_a, box_b)
+        || covertex(boxes[box_a].vertexIds, boxes[box_b].vertexIds)) {
+        return;
+    }
+    // A min/max crossing can only start or stop the x-overlap; testing the
+    // intervals directly makes the update independent of the crossing
+    // direction (and idempotent, so repeated crossings of the same pair
+    // within one repair are harmless).
+    const stq::cpu::Aabb& a = boxes[box_a];
+    const stq::cpu::Aabb& b = boxes[box_b];
+    if (a.min[m_sweep_axis] <= b.max[m_sweep_axis]
+        && b.min[m_sweep_axis] <= a.max[m_sweep_axis]) {
+        m_x_overlaps.insert(pair_key(box_a, box_b));
+    } else {
+        m_x_overlaps.erase(pair_key(box_a, box_b));
+    }
+}
+
+Eigen::Array3d SweepAndTiniestQueue::box_center_variance() const
+{
+    if (boxes.empty()) {
+        return Eigen::Array3d::Zero();
+    }
+    Eigen::Array3d sum = Eigen::Array3d::Zero();
+    Eigen::Array3d sum_sqr = Eigen::Array3d::Zero();
+    for (const stq::cpu::Aabb& box : boxes) {
+        const Eigen::Array3d center =
+            0.5 * (box.min + box.max).cast<double>();
+        sum += center;
+        sum_sqr += center * center;
+    }
+    const double n = boxes.size();
+    return sum_sqr / n - (sum / n).square();
+}
+
+void SweepAndTiniestQueue::init_persistent_sweep()
+{
+    const size_t n = boxes.size();
+
+    m_endpoints.resize(2 * n);
+    for (size_t i = 0; i < n; i++) {
+        m_endpoints[2 * i + 0] = int(i << 1);
+        m_endpoints[2 * i + 1] = int(i << 1) | 1;
+    }
+    std::sort(
+        m_endpoints.begin(), m_endpoints.end(),
+        [&](const int a, const int b) {
+            return endpoint_value(a) < endpoint_value(b);
+        });
+
+    // Seed the x-overlap pairs with one sweep over the sorted endpoints.
+    m_x_overlaps.clear();
+    std::vector<int> active;
+    for (const int endpoint : m_endpoints) {
+        const int box = endpoint >> 1;
+        if (endpoint & 1) {
+            active.erase(std::find(active.begin(), active.end(), box));
+        } else {
+            for (const int other : active) {
+                update_x_overlap(other, box);
+            }
+            active.push_back(box);
+        }
+    }
+}
+
+void SweepAndTiniestQueue::repair_persistent_sweep()
+{
+    // The endpoint values moved since the last build but their order is
+    // nearly unchanged; each swap of a min endpoint past a max endpoint is
+    // exactly a potential change of that pair's x-overlap, so repairing the
+    // order with an insertion sort visits every pair whose status could
+    // have changed and only those — the classic near-O(n) coherent update.
+    for (size_t i = 1; i < m_endpoints.size(); i++) {
+        const int endpoint = m_endpoints[i];
+        const float value = endpoint_value(endpoint);
+        size_t j = i;
+        for (; j > 0 && endpoint_value(m_endpoints[j - 1]) > value; j--) {
+            const int other = m_endpoints[j - 1];
+            m_endpoints[j] = other;
+            if ((other ^ endpoint) & 1) { // one min and one max endpoint
+                update_x_overlap(other >> 1, endpoint >> 1);
+            }
+        }
+        m_endpoints[j] = endpoint;
+    }
+}
+
+void SweepAndTiniestQueue::emit_persistent_overlaps()
+{
+    const int axis1 = (m_sweep_axis + 1) % 3;
+    const int axis2 = (m_sweep_axis + 2) % 3;
+
+    overlaps.clear();
+    overlaps.reserve(m_x_overlaps.size());
+    for (const int64_t key : m_x_overlaps) {
+        const int id1 = int(key >> 32);
+        const int id2 = int(key & 0xFFFFFFFF);
+        const stq::cpu::Aabb& a = boxes[id1];
+        const stq::cpu::Aabb& b = boxes[id2];
+        if (a.min[axis1] <= b.max[axis1] && b.min[axis1] <= a.max[axis1]
+            && a.min[axis2] <= b.max[axis2] && b.min[axis2] <= a.max[axis2]) {
+            overlaps.emplace_back(id1, id2);
+        }
+    }
 }
 
 /// @brief Find the candidate edge-vertex collisisons.
@@ -118,7 +306,7 @@ bool SweepAndTiniestQueue::is_face(long id) const
 
 #ifdef IPC_TOOLKIT_WITH_CUDA
 void SweepAndTiniestQueueGPU::build(
-    const Eigen::MatrixXd& V,
+    ConstMatrixXdRef V,
     const Eigen::MatrixXi& E,
     const Eigen::MatrixXi& F,
     double inflation_radius)
@@ -129,8 +317,8 @@ void SweepAndTiniestQueueGPU::build(
 }
 
 void SweepAndTiniestQueueGPU::build(
-    const Eigen::MatrixXd& V0,
-    const Eigen::MatrixXd& V1,
+    ConstMatrixXdRef V0,
+    ConstMatrixXdRef V1,
     const Eigen::MatrixXi& E,
     const Eigen::MatrixXi& F,
     double inflation_radius)
@@ -212,6 +400,12 @@ void SweepAndTiniestQueueGPU::detect_edge_face_candidates(
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void CopyMeshBroadPhase::query_boxes(
+    const std::vector<AABB>& boxes, BoxQueryResult& result) const
+{
+    throw std::runtime_error("Not implemented!");
+}
+
 void CopyMeshBroadPhase::copy_mesh(
     const Eigen::MatrixXi& E, const Eigen::MatrixXi& F)
 {
@@ -224,7 +418,8 @@ bool CopyMeshBroadPhase::can_edge_vertex_collide(size_t ei, size_t vi) const
     const long e0i = edges(ei, 0), e1i = edges(ei, 1);
 
     return vi != e0i && vi != e1i
-        && (can_vertices_collide(vi, e0i) || can_vertices_collide(vi, e1i));
+        && (check_can_vertices_collide(vi, e0i)
+            || check_can_vertices_collide(vi, e1i));
 }
 
 bool CopyMeshBroadPhase::can_edges_collide(size_t eai, size_t ebi) const
@@ -236,9 +431,10 @@ bool CopyMeshBroadPhase::can_edges_collide(size_t eai, size_t ebi) const
         ea0i == eb0i || ea0i == eb1i || ea1i == eb0i || ea1i == eb1i;
 
     return !share_endpoint
-        && (can_vertices_collide(ea0i, eb0i) || can_vertices_collide(ea0i, eb1i)
-            || can_vertices_collide(ea1i, eb0i)
-            || can_vertices_collide(ea1i, eb1i));
+        && (check_can_vertices_collide(ea0i, eb0i)
+            || check_can_vertices_collide(ea0i, eb1i)
+            || check_can_vertices_collide(ea1i, eb0i)
+            || check_can_vertices_collide(ea1i, eb1i));
 }
 
 bool CopyMeshBroadPhase::can_face_vertex_collide(size_t fi, size_t vi) const
@@ -246,8 +442,9 @@ bool CopyMeshBroadPhase::can_face_vertex_collide(size_t fi, size_t vi) const
     const long f0i = faces(fi, 0), f1i = faces(fi, 1), f2i = faces(fi, 2);
 
     return vi != f0i && vi != f1i && vi != f2i
-        && (can_vertices_collide(vi, f0i) || can_vertices_collide(vi, f1i)
-            || can_vertices_collide(vi, f2i));
+        && (check_can_vertices_collide(vi, f0i)
+            || check_can_vertices_collide(vi, f1i)
+            || check_can_vertices_collide(vi, f2i));
 }
 
 bool CopyMeshBroadPhase::can_edge_face_collide(size_t ei, size_t fi) const
@@ -259,10 +456,12 @@ bool CopyMeshBroadPhase::can_edge_face_collide(size_t ei, size_t fi) const
         || e1i == f0i || e1i == f1i || e1i == f2i;
 
     return !share_endpoint
-        && (can_vertices_collide(e0i, f0i) || can_vertices_collide(e0i, f1i)
-            || can_vertices_collide(e0i, f2i) || can_vertices_collide(e1i, f0i)
-            || can_vertices_collide(e1i, f1i)
-            || can_vertices_collide(e1i, f2i));
+        && (check_can_vertices_collide(e0i, f0i)
+            || check_can_vertices_collide(e0i, f1i)
+            || check_can_vertices_collide(e0i, f2i)
+            || check_can_vertices_collide(e1i, f0i)
+            || check_can_vertices_collide(e1i, f1i)
+            || check_can_vertices_collide(e1i, f2i));
 }
 
 } // namespace ipc
\ No newline at end of file
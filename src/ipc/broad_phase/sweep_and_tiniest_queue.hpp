@@ -1,9 +1,13 @@
 #pragma once
 
 #include <ipc/broad_phase/broad_phase.hpp>
+#include <ipc/utils/eigen_ext.hpp>
+#include <ipc/utils/unordered_map_and_set.hpp>
 
 #include <ipc/config.hpp>
 
+#include <cstdint>
+
 #include <stq/cpu/aabb.hpp>
 #ifdef IPC_TOOLKIT_WITH_CUDA
 #include <cuda.h>
@@ -16,6 +20,12 @@ namespace ipc {
 // A version of the BP that copies the meshes into the class rather than making
 // the AABBs.
 class CopyMeshBroadPhase : public BroadPhase {
+public:
+    /// @brief Not implemented: the element boxes are not stored on the host.
+    void query_boxes(
+        const std::vector<AABB>& boxes,
+        BoxQueryResult& result) const override;
+
 protected:
     void copy_mesh(const Eigen::MatrixXi& E, const Eigen::MatrixXi& F);
 
@@ -36,7 +46,7 @@ public:
     /// @param F Faces of the mesh.
     /// @param inflation_radius Radius of inflation around all elements.
     void build(
-        const Eigen::MatrixXd& V,
+        ConstMatrixXdRef V,
         const Eigen::MatrixXi& E,
         const Eigen::MatrixXi& F,
         double inflation_radius = 0) override;
@@ -48,8 +58,8 @@ public:
     /// @param F Faces of the mesh.
     /// @param inflation_radius Radius of inflation around all elements.
     void build(
-        const Eigen::MatrixXd& V0,
-        const Eigen::MatrixXd& V1,
+        ConstMatrixXdRef V0,
+        ConstMatrixXdRef V1,
         const Eigen::MatrixXi& E,
         const Eigen::MatrixXi& F,
         double inflation_radius = 0) override;
@@ -57,6 +67,21 @@ public:
     /// @brief Clear any built data.
     void clear() override;
 
+    /// @brief Enable or disable the persistent incremental sweep (off by
+    /// default).
+    ///
+    /// When enabled, build() keeps the x-sorted endpoint list and the set of
+    /// x-overlapping box pairs alive across calls and repairs them with an
+    /// insertion sort whose swaps drive the pair updates. Between the
+    /// iterations of a solve the lists are nearly sorted, so the repair is
+    /// near O(n) instead of the full O(n log n) re-sort plus sweep. Falls
+    /// back to a full initialization whenever the mesh changes size, so it
+    /// is always safe to leave on for a fixed topology.
+    void set_persistent(const bool persistent);
+
+    /// @brief Is the persistent incremental sweep enabled?
+    bool persistent() const { return m_persistent; }
+
     /// @brief Find the candidate edge-vertex collisisons.
     /// @param[out] candidates The candidate edge-vertex collisisons.
     void detect_edge_vertex_candidates(
@@ -85,9 +110,60 @@ protected:
     bool is_edge(long id) const;
     bool is_face(long id) const;
 
+    /// @brief Sort the endpoint list and seed the x-overlap pairs (the full
+    /// O(n log n) initialization of the persistent sweep).
+    void init_persistent_sweep();
+
+    /// @brief Repair the nearly sorted endpoint list with an insertion sort,
+    /// toggling the x-overlap of a pair whenever a min endpoint crosses a
+    /// max endpoint.
+    void repair_persistent_sweep();
+
+    /// @brief Fill overlaps with the tracked pairs that also overlap on the
+    /// y- and z-axes.
+    void emit_persistent_overlaps();
+
+    /// @brief Variance of the box centers along each axis.
+    ///
+    /// The sweep degenerates when every box overlaps along the sweep axis
+    /// (e.g., a fixed x axis on a flat, ground-aligned scene), so build()
+    /// sweeps along the axis of largest center variance instead.
+    Eigen::Array3d box_center_variance() const;
+
+    /// @brief The sweep-axis value of an endpoint (encoded as
+    /// (box << 1) | is_max).
+    float endpoint_value(const int endpoint) const
+    {
+        const stq::cpu::Aabb& box = boxes[endpoint >> 1];
+        return (endpoint & 1) ? box.max[m_sweep_axis] : box.min[m_sweep_axis];
+    }
+
+    /// @brief Is the pair consumed downstream? Only edge-edge and
+    /// face-vertex pairs without a shared vertex are (the detect_* functions
+    /// ignore the rest), so the others are never tracked.
+    bool is_tracked_pair(const long id1, const long id2) const;
+
+    /// @brief Insert or erase the pair from the x-overlap set to match the
+    /// boxes' current x-intervals.
+    void update_x_overlap(const int box_a, const int box_b);
+
     std::vector<stq::cpu::Aabb> boxes;
     std::vector<std::pair<int, int>> overlaps;
     long num_vertices;
+
+    // Persistent incremental sweep state (see set_persistent()). In
+    // persistent mode the boxes stay in construction order (box id == index)
+    // so the endpoint list can reference them across builds.
+    bool m_persistent = false;
+    /// @brief The axis the persistent sweep runs along (see
+    /// box_center_variance()).
+    int m_sweep_axis = 0;
+    /// @brief Endpoints encoded as (box << 1) | is_max, sorted along the
+    /// sweep axis.
+    std::vector<int> m_endpoints;
+    /// @brief Tracked pairs overlapping on the sweep axis, keyed as
+    /// (min_id << 32) | max_id.
+    unordered_set<int64_t> m_x_overlaps;
 };
 
 #ifdef IPC_TOOLKIT_WITH_CUDA
@@ -99,7 +175,7 @@ public:
     /// @param F Faces of the mesh.
     /// @param inflation_radius Radius of inflation around all elements.
     void build(
-        const Eigen::MatrixXd& V,
+        ConstMatrixXdRef V,
         const Eigen::MatrixXi& E,
         const Eigen::MatrixXi& F,
         double inflation_radius = 0) override;
@@ -111,8 +187,8 @@ public:
     /// @param F Faces of the mesh.
     /// @param inflation_radius Radius of inflation around all elements.
     void build(
-        const Eigen::MatrixXd& V0,
-        const Eigen::MatrixXd& V1,
+        ConstMatrixXdRef V0,
+        ConstMatrixXdRef V1,
         const Eigen::MatrixXi& E,
         const Eigen::MatrixXi& F,
         double inflation_radius = 0) override;
@@ -0,0 +1,483 @@
+#include "two_level_spatial_hash.hpp"
+
+#include <ipc/utils/logger.hpp>
+#include <ipc/utils/merge_thread_local_vectors.hpp>
+#include <ipc/utils/small_vector.hpp>
+
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+#include <algorithm> // std::nth_element, std::min/max
+#include <limits>
+
+namespace ipc {
+
+namespace {
+
+    /// @brief The length of an edge over the time step (max over endpoints).
+    double edge_length(
+        ConstMatrixXdRef V0,
+        ConstMatrixXdRef V1,
+        const Eigen::MatrixXi& E,
+        long ei)
+    {
+        return std::max(
+            (V0.row(E(ei, 0)) - V0.row(E(ei, 1))).norm(),
+            (V1.row(E(ei, 0)) - V1.row(E(ei, 1))).norm());
+    }
+
+    /// @brief Copy the given rows of a matrix into a new matrix.
+    Eigen::MatrixXi
+    select_rows(const Eigen::MatrixXi& M, const std::vector<long>& rows)
+    {
+        Eigen::MatrixXi subset(rows.size(), M.cols());
+        for (size_t i = 0; i < rows.size(); i++) {
+            subset.row(i) = M.row(rows[i]);
+        }
+        return subset;
+    }
+
+} // namespace
+
+void TwoLevelSpatialHash::build(
+    ConstMatrixXdRef V0,
+    ConstMatrixXdRef V1,
+    const Eigen::MatrixXi& E,
+    const Eigen::MatrixXi& F,
+    double inflation_radius)
+{
+    assert(V0.rows() == V1.rows() && V0.cols() == V1.cols());
+
+    BroadPhase::build(V0, V1, E, F, inflation_radius); // also calls clear()
+    StatsTimer timer(m_enable_stats, m_stats.build_time);
+
+    // Measure each element by its longest edge over the time step.
+    std::vector<double> edge_sizes(E.rows());
+    tbb::parallel_for(size_t(0), size_t(E.rows()), [&](size_t ei) {
+        edge_sizes[ei] = edge_length(V0, V1, E, ei);
+    });
+    std::vector<double> face_sizes(F.rows());
+    tbb::parallel_for(size_t(0), size_t(F.rows()), [&](size_t fi) {
+        face_sizes[fi] = std::max(
+            { std::max(
+                  (V0.row(F(fi, 0)) - V0.row(F(fi, 1))).norm(),
+                  (V1.row(F(fi, 0)) - V1.row(F(fi, 1))).norm()),
+              std::max(
+                  (V0.row(F(fi, 1)) - V0.row(F(fi, 2))).norm(),
+                  (V1.row(F(fi, 1)) - V1.row(F(fi, 2))).norm()),
+              std::max(
+                  (V0.row(F(fi, 2)) - V0.row(F(fi, 0))).norm(),
+                  (V1.row(F(fi, 2)) - V1.row(F(fi, 0))).norm()) });
+    });
+
+    // The largest decile of elements goes into the coarse grid. On a mesh
+    // with uniform element sizes nothing is strictly larger than the 90th
+    // percentile, so everything lands in the fine grid and this reduces to a
+    // single-level SpatialHash.
+    double threshold = std::numeric_limits<double>::infinity();
+    std::vector<double> sizes = edge_sizes;
+    sizes.insert(sizes.end(), face_sizes.begin(), face_sizes.end());
+    if (!sizes.empty()) {
+        const size_t k = size_t(0.9 * sizes.size());
+        std::nth_element(sizes.begin(), sizes.begin() + k, sizes.end());
+        threshold = sizes[k];
+    }
+
+    for (long ei = 0; ei < E.rows(); ei++) {
+        (edge_sizes[ei] > threshold ? coarse_edge_ids : fine_edge_ids)
+            .push_back(ei);
+    }
+    for (long fi = 0; fi < F.rows(); fi++) {
+        (face_sizes[fi] > threshold ? coarse_face_ids : fine_face_ids)
+            .push_back(fi);
+    }
+    m_has_coarse = !coarse_edge_ids.empty() || !coarse_face_ids.empty();
+
+    // Propagate the collision filters to the grids before building.
+    fine.can_vertices_collide = can_vertices_collide;
+    fine.set_vertex_group_ids(m_vertex_group_ids, m_can_groups_collide);
+    fine.build(
+        V0, V1, select_rows(E, fine_edge_ids), select_rows(F, fine_face_ids),
+        inflation_radius);
+
+    if (m_has_coarse) {
+        // Size the coarse voxels for the large elements. A coarse face's
+        // longest edge is also a coarse edge, so coarse_edge_ids is nonempty
+        // whenever any face is coarse (assuming E covers the face edges);
+        // fall back to the largest face otherwise.
+        double coarseVoxelSize = 0;
+        for (const long ei : coarse_edge_ids) {
+            coarseVoxelSize = std::max(coarseVoxelSize, edge_sizes[ei]);
+        }
+        for (const long fi : coarse_face_ids) {
+            coarseVoxelSize = std::max(coarseVoxelSize, face_sizes[fi]);
+        }
+        coarseVoxelSize += 2 * inflation_radius;
+
+        coarse.can_vertices_collide = can_vertices_collide;
+        coarse.set_vertex_group_ids(m_vertex_group_ids, m_can_groups_collide);
+        coarse.build(
+            V0, V1, select_rows(E, coarse_edge_ids),
+            select_rows(F, coarse_face_ids), inflation_radius,
+            coarseVoxelSize);
+    }
+}
+
+void TwoLevelSpatialHash::set_morton_ordering(const bool use_morton_ordering)
+{
+    if (use_morton_ordering) {
+        logger().warn(
+            "TwoLevelSpatialHash does not support Morton ordering; "
+            "ignoring it!");
+    }
+}
+
+void TwoLevelSpatialHash::set_active_zones(
+    const std::vector<AABB>& zones, const int /*fallback_period*/)
+{
+    if (!zones.empty()) {
+        logger().warn(
+            "TwoLevelSpatialHash does not support active zones; "
+            "ignoring them!");
+    }
+}
+
+void TwoLevelSpatialHash::clear()
+{
+    BroadPhase::clear();
+    fine.clear();
+    coarse.clear();
+    m_has_coarse = false;
+    fine_edge_ids.clear();
+    coarse_edge_ids.clear();
+    fine_face_ids.clear();
+    coarse_face_ids.clear();
+}
+
+size_t TwoLevelSpatialHash::bytes_used() const
+{
+    return record_bytes_used(
+        BroadPhase::bytes_used() + fine.bytes_used() + coarse.bytes_used()
+        + vector_bytes_used(fine_edge_ids)
+        + vector_bytes_used(coarse_edge_ids)
+        + vector_bytes_used(fine_face_ids)
+        + vector_bytes_used(coarse_face_ids));
+}
+
+void TwoLevelSpatialHash::detect_edge_vertex_candidates(
+    std::vector<EdgeVertexCandidate>& candidates) const
+{
+    // Fine edges against the vertices (all hashed in the fine grid).
+    std::vector<EdgeVertexCandidate> sub_candidates;
+    fine.detect_edge_vertex_candidates(sub_candidates);
+    candidates.reserve(candidates.size() + sub_candidates.size());
+    for (const auto& c : sub_candidates) {
+        candidates.emplace_back(fine_edge_ids[c.edge_index], c.vertex_index);
+    }
+
+    if (!m_has_coarse) {
+        return;
+    }
+
+    // Coarse edges against the vertices: the coarse grid holds no vertices,
+    // so query each vertex's box against it instead.
+    tbb::enumerable_thread_specific<std::vector<EdgeVertexCandidate>> storages;
+
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(0ul, vertex_boxes.size()),
+        [&](const tbb::blocked_range<size_t>& range) {
+            auto& local_candidates = storages.local();
+            std::vector<int> vertInds, edgeInds, triInds;
+
+            for (long vi = range.begin(); vi != range.end(); vi++) {
+                const AABB& vertex_box = vertex_boxes[vi];
+
+                coarse.queryBoxForPrimitives(
+                    vertex_box.min, vertex_box.max, vertInds, edgeInds,
+                    triInds);
+
+                for (const auto& ei : edgeInds) {
+                    const long full_ei = coarse_edge_ids[ei];
+                    if (!can_edge_vertex_collide(full_ei, vi)) {
+                        continue;
+                    }
+
+                    if (vertex_box.intersects(edge_boxes[full_ei])) {
+                        local_candidates.emplace_back(full_ei, vi);
+                    }
+                }
+            }
+        });
+
+    merge_thread_local_vectors(storages, candidates);
+}
+
+void TwoLevelSpatialHash::detect_edge_edge_candidates(
+    std::vector<EdgeEdgeCandidate>& candidates) const
+{
+    // Pairs within each grid. The id maps are increasing, so the
+    // edge0_index < edge1_index invariant survives the remapping.
+    std::vector<EdgeEdgeCandidate> sub_candidates;
+    fine.detect_edge_edge_candidates(sub_candidates);
+    candidates.reserve(candidates.size() + sub_candidates.size());
+    for (const auto& c : sub_candidates) {
+        candidates.emplace_back(
+            fine_edge_ids[c.edge0_index], fine_edge_ids[c.edge1_index]);
+    }
+
+    if (!m_has_coarse) {
+        return;
+    }
+
+    sub_candidates.clear();
+    coarse.detect_edge_edge_candidates(sub_candidates);
+    for (const auto& c : sub_candidates) {
+        candidates.emplace_back(
+            coarse_edge_ids[c.edge0_index], coarse_edge_ids[c.edge1_index]);
+    }
+
+    // Cross pairs: each fine edge queries the coarse grid.
+    tbb::enumerable_thread_specific<std::vector<EdgeEdgeCandidate>> storages;
+
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(0ul, fine_edge_ids.size()),
+        [&](const tbb::blocked_range<size_t>& range) {
+            auto& local_candidates = storages.local();
+            std::vector<int> vertInds, edgeInds, triInds;
+
+            for (size_t i = range.begin(); i != range.end(); i++) {
+                const long eai = fine_edge_ids[i];
+                const AABB& edge_a_box = edge_boxes[eai];
+
+                coarse.queryBoxForPrimitives(
+                    edge_a_box.min, edge_a_box.max, vertInds, edgeInds,
+                    triInds);
+
+                for (const auto& ebi : edgeInds) {
+                    const long full_ebi = coarse_edge_ids[ebi];
+                    if (!can_edges_collide(eai, full_ebi)) {
+                        continue;
+                    }
+
+                    if (edge_a_box.intersects(edge_boxes[full_ebi])) {
+                        local_candidates.emplace_back(
+                            std::min(eai, full_ebi), std::max(eai, full_ebi));
+                    }
+                }
+            }
+        });
+
+    merge_thread_local_vectors(storages, candidates);
+}
+
+void TwoLevelSpatialHash::detect_face_vertex_candidates(
+    std::vector<FaceVertexCandidate>& candidates) const
+{
+    // Fine faces against the vertices (all hashed in the fine grid).
+    std::vector<FaceVertexCandidate> sub_candidates;
+    fine.detect_face_vertex_candidates(sub_candidates);
+    candidates.reserve(candidates.size() + sub_candidates.size());
+    for (const auto& c : sub_candidates) {
+        candidates.emplace_back(fine_face_ids[c.face_index], c.vertex_index);
+    }
+
+    if (!m_has_coarse) {
+        return;
+    }
+
+    // Coarse faces against the vertices.
+    tbb::enumerable_thread_specific<std::vector<FaceVertexCandidate>> storages;
+
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(0ul, vertex_boxes.size()),
+        [&](const tbb::blocked_range<size_t>& range) {
+            auto& local_candidates = storages.local();
+            std::vector<int> vertInds, edgeInds, triInds;
+
+            for (long vi = range.begin(); vi != range.end(); vi++) {
+                const AABB& vertex_box = vertex_boxes[vi];
+
+                coarse.queryBoxForPrimitives(
+                    vertex_box.min, vertex_box.max, vertInds, edgeInds,
+                    triInds);
+
+                for (const auto& fi : triInds) {
+                    const long full_fi = coarse_face_ids[fi];
+                    if (!can_face_vertex_collide(full_fi, vi)) {
+                        continue;
+                    }
+
+                    if (vertex_box.intersects(face_boxes[full_fi])) {
+                        local_candidates.emplace_back(full_fi, vi);
+                    }
+                }
+            }
+        });
+
+    merge_thread_local_vectors(storages, candidates);
+}
+
+void TwoLevelSpatialHash::detect_edge_face_candidates(
+    std::vector<EdgeFaceCandidate>& candidates) const
+{
+    // Pairs within each grid.
+    std::vector<EdgeFaceCandidate> sub_candidates;
+    fine.detect_edge_face_candidates(sub_candidates);
+    candidates.reserve(candidates.size() + sub_candidates.size());
+    for (const auto& c : sub_candidates) {
+        candidates.emplace_back(
+            fine_edge_ids[c.edge_index], fine_face_ids[c.face_index]);
+    }
+
+    if (!m_has_coarse) {
+        return;
+    }
+
+    sub_candidates.clear();
+    coarse.detect_edge_face_candidates(sub_candidates);
+    for (const auto& c : sub_candidates) {
+        candidates.emplace_back(
+            coarse_edge_ids[c.edge_index], coarse_face_ids[c.face_index]);
+    }
+
+    // Cross pairs: each fine edge and fine face queries the coarse grid.
+    tbb::enumerable_thread_specific<std::vector<EdgeFaceCandidate>> storages;
+
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(0ul, fine_edge_ids.size()),
+        [&](const tbb::blocked_range<size_t>& range) {
+            auto& local_candidates = storages.local();
+            std::vector<int> vertInds, edgeInds, triInds;
+
+            for (size_t i = range.begin(); i != range.end(); i++) {
+                const long ei = fine_edge_ids[i];
+                const AABB& edge_box = edge_boxes[ei];
+
+                coarse.queryBoxForPrimitives(
+                    edge_box.min, edge_box.max, vertInds, edgeInds, triInds);
+
+                for (const auto& fi : triInds) {
+                    const long full_fi = coarse_face_ids[fi];
+                    if (!can_edge_face_collide(ei, full_fi)) {
+                        continue;
+                    }
+
+                    if (edge_box.intersects(face_boxes[full_fi])) {
+                        local_candidates.emplace_back(ei, full_fi);
+                    }
+                }
+            }
+        });
+
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(0ul, fine_face_ids.size()),
+        [&](const tbb::blocked_range<size_t>& range) {
+            auto& local_candidates = storages.local();
+            std::vector<int> vertInds, edgeInds, triInds;
+
+            for (size_t i = range.begin(); i != range.end(); i++) {
+                const long fi = fine_face_ids[i];
+                const AABB& face_box = face_boxes[fi];
+
+                coarse.queryBoxForPrimitives(
+                    face_box.min, face_box.max, vertInds, edgeInds, triInds);
+
+                for (const auto& ei : edgeInds) {
+                    const long full_ei = coarse_edge_ids[ei];
+                    if (!can_edge_face_collide(full_ei, fi)) {
+                        continue;
+                    }
+
+                    if (face_box.intersects(edge_boxes[full_ei])) {
+                        local_candidates.emplace_back(full_ei, fi);
+                    }
+                }
+            }
+        });
+
+    merge_thread_local_vectors(storages, candidates);
+}
+
+void TwoLevelSpatialHash::query_boxes(
+    const std::vector<AABB>& boxes, BoxQueryResult& result) const
+{
+    result.clear();
+
+    // Gather per-query id lists from both grids in parallel; flattened to
+    // CSR below. The voxel maps yield candidates by cell co-occupancy, so
+    // the actual box overlap is verified before reporting an id.
+    std::vector<SmallVector<long, 8>> vert_ids(boxes.size());
+    std::vector<SmallVector<long, 8>> edge_ids(boxes.size());
+    std::vector<SmallVector<long, 8>> face_ids(boxes.size());
+
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(0ul, boxes.size()),
+        [&](const tbb::blocked_range<size_t>& range) {
+            std::vector<int> vertInds, edgeInds, triInds;
+
+            for (size_t i = range.begin(); i != range.end(); i++) {
+                const AABB& query = boxes[i];
+
+                // All vertices live in the fine grid.
+                fine.queryBoxForPrimitives(
+                    query.min, query.max, vertInds, edgeInds, triInds);
+                for (const auto& vi : vertInds) {
+                    if (query.intersects(vertex_boxes[vi])) {
+                        vert_ids[i].push_back(vi);
+                    }
+                }
+                for (const auto& ei : edgeInds) {
+                    const long full_ei = fine_edge_ids[ei];
+                    if (query.intersects(edge_boxes[full_ei])) {
+                        edge_ids[i].push_back(full_ei);
+                    }
+                }
+                for (const auto& fi : triInds) {
+                    const long full_fi = fine_face_ids[fi];
+                    if (query.intersects(face_boxes[full_fi])) {
+                        face_ids[i].push_back(full_fi);
+                    }
+                }
+
+                if (!m_has_coarse) {
+                    continue;
+                }
+
+                coarse.queryBoxForPrimitives(
+                    query.min, query.max, vertInds, edgeInds, triInds);
+                for (const auto& ei : edgeInds) {
+                    const long full_ei = coarse_edge_ids[ei];
+                    if (query.intersects(edge_boxes[full_ei])) {
+                        edge_ids[i].push_back(full_ei);
+                    }
+                }
+                for (const auto& fi : triInds) {
+                    const long full_fi = coarse_face_ids[fi];
+                    if (query.intersects(face_boxes[full_fi])) {
+                        face_ids[i].push_back(full_fi);
+                    }
+                }
+
+                // Merge the two grids' contributions into ascending order.
+                std::sort(edge_ids[i].begin(), edge_ids[i].end());
+                std::sort(face_ids[i].begin(), face_ids[i].end());
+            }
+        });
+
+    flatten_to_csr(vert_ids, result.vertex_offsets, result.vertex_ids);
+    flatten_to_csr(edge_ids, result.edge_offsets, result.edge_ids);
+    flatten_to_csr(face_ids, result.face_offsets, result.face_ids);
+}
+
+void TwoLevelSpatialHash::collect_stats(BroadPhaseStats& stats) const
+{
+    stats.boxes_per_cell_histogram.clear();
+    for (const SpatialHash* grid : { &fine, &coarse }) {
+        for (size_t ki = 0; ki < grid->voxel.numVoxels(); ki++) {
+            stats.add_occupied_cell(grid->voxel.voxelSize(ki));
+        }
+    }
+}
+
+} // namespace ipc
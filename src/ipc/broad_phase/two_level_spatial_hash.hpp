@@ -0,0 +1,100 @@
+#pragma once
+
+#include <ipc/broad_phase/spatial_hash.hpp>
+#include <ipc/utils/eigen_ext.hpp>
+
+#include <vector>
+
+namespace ipc {
+
+/// @brief Two-level variant of SpatialHash.
+///
+/// A single voxel size is a poor fit for meshes with a few oversized
+/// elements: sizing the cells for the typical element makes the large
+/// elements occupy thousands of voxels, while sizing the cells for the large
+/// elements turns the scan within each cell into brute force. This broad
+/// phase hashes the largest decile of elements into a coarse grid sized for
+/// them and the remaining elements (and all vertices) into a fine grid, and
+/// intersects queries against both grids.
+class TwoLevelSpatialHash : public BroadPhase {
+public:
+    TwoLevelSpatialHash() { coarse.hashVertices = false; }
+
+    TwoLevelSpatialHash(
+        ConstMatrixXdRef V,
+        const Eigen::MatrixXi& E,
+        const Eigen::MatrixXi& F,
+        double inflation_radius = 0)
+        : TwoLevelSpatialHash()
+    {
+        build(V, E, F, inflation_radius);
+    }
+
+    void build(
+        ConstMatrixXdRef V,
+        const Eigen::MatrixXi& E,
+        const Eigen::MatrixXi& F,
+        double inflation_radius = 0) override
+    {
+        build(V, V, E, F, inflation_radius);
+    }
+
+    void build(
+        ConstMatrixXdRef V0,
+        ConstMatrixXdRef V1,
+        const Eigen::MatrixXi& E,
+        const Eigen::MatrixXi& F,
+        double inflation_radius = 0) override;
+
+    /// @brief Like SpatialHash, the grids index the boxes by mesh element,
+    /// so Morton ordering is ignored with a warning.
+    void set_morton_ordering(const bool use_morton_ordering) override;
+
+    /// @brief For the same reason active zones are ignored with a warning.
+    void set_active_zones(
+        const std::vector<AABB>& zones, const int fallback_period = 8) override;
+
+    void clear() override;
+
+    /// @brief Add both grids and the index maps to the count.
+    size_t bytes_used() const override;
+
+    /// @brief Find the candidate edge-vertex collisisons.
+    void detect_edge_vertex_candidates(
+        std::vector<EdgeVertexCandidate>& candidates) const override;
+
+    /// @brief Find the candidate edge-edge collisions.
+    void detect_edge_edge_candidates(
+        std::vector<EdgeEdgeCandidate>& candidates) const override;
+
+    /// @brief Find the candidate face-vertex collisions.
+    void detect_face_vertex_candidates(
+        std::vector<FaceVertexCandidate>& candidates) const override;
+
+    /// @brief Find the candidate edge-face intersections.
+    void detect_edge_face_candidates(
+        std::vector<EdgeFaceCandidate>& candidates) const override;
+
+    /// @brief Query caller-provided boxes against both grids.
+    void query_boxes(
+        const std::vector<AABB>& boxes,
+        BoxQueryResult& result) const override;
+
+protected:
+    /// @brief Report the combined cell occupancy of both grids.
+    void collect_stats(BroadPhaseStats& stats) const override;
+
+    /// @brief Grid holding all vertices and the typically sized elements.
+    SpatialHash fine;
+    /// @brief Grid holding only the largest decile of elements.
+    SpatialHash coarse;
+
+    /// @brief True if any element was assigned to the coarse grid.
+    bool m_has_coarse = false;
+
+    // Maps from grid-local element indices back to mesh indices.
+    std::vector<long> fine_edge_ids, coarse_edge_ids;
+    std::vector<long> fine_face_ids, coarse_face_ids;
+};
+
+} // namespace ipc
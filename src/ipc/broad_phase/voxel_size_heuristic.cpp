@@ -7,25 +7,31 @@
 namespace ipc {
 
 double suggest_good_voxel_size(
-    const Eigen::MatrixXd& V, const Eigen::MatrixXi& E, double inflation_radius)
+    ConstMatrixXdRef V, const Eigen::MatrixXi& E, double inflation_radius)
 {
     // double edge_len_std_deviation;
     // double edge_len = mean_edge_length(V, V, E, edge_len_std_deviation);
-    double edge_len = median_edge_length(V, V, E);
-    double voxel_size = 2 * edge_len + inflation_radius;
+    return suggest_good_voxel_size(
+        median_edge_length(V, V, E), inflation_radius);
+}
+
+double suggest_good_voxel_size(double edge_len_median, double inflation_radius)
+{
+    double voxel_size = 2 * edge_len_median + inflation_radius;
     // double voxel_size = edge_len + edge_len_std_deviation + inflation_radius;
     if (voxel_size <= 0) { // this case should not happen in real simulations
         voxel_size = std::numeric_limits<double>::max();
     }
     assert(std::isfinite(voxel_size));
     logger().trace(
-        "suggesting voxel size of {} (avg_edge_len={})", voxel_size, edge_len);
+        "suggesting voxel size of {} (avg_edge_len={})", voxel_size,
+        edge_len_median);
     return voxel_size;
 }
 
 double suggest_good_voxel_size(
-    const Eigen::MatrixXd& V0,
-    const Eigen::MatrixXd& V1,
+    ConstMatrixXdRef V0,
+    ConstMatrixXdRef V1,
     const Eigen::MatrixXi& E,
     double inflation_radius)
 {
@@ -34,7 +40,17 @@ double suggest_good_voxel_size(
     // double disp_len_std_deviation;
     // double disp_len = mean_displacement_length(V1 - V0,
     // disp_len_std_deviation);
-    double edge_len = median_edge_length(V0, V1, E);
+    return suggest_good_voxel_size(
+        V0, V1, median_edge_length(V0, V1, E), inflation_radius);
+}
+
+double suggest_good_voxel_size(
+    ConstMatrixXdRef V0,
+    ConstMatrixXdRef V1,
+    double edge_len_median,
+    double inflation_radius)
+{
+    const double edge_len = edge_len_median;
     double disp_len = median_displacement_length(V1 - V0);
     // double voxel_size = 2 * edge_len + inflation_radius;
     double voxel_size = 2 * std::max(edge_len, disp_len) + inflation_radius;
@@ -54,8 +70,8 @@ double suggest_good_voxel_size(
 
 /// @brief Compute the mean edge length of a mesh.
 double mean_edge_length(
-    const Eigen::MatrixXd& V0,
-    const Eigen::MatrixXd& V1,
+    ConstMatrixXdRef V0,
+    ConstMatrixXdRef V1,
     const Eigen::MatrixXi& E,
     double& std_deviation)
 {
@@ -93,8 +109,8 @@ double mean_displacement_length(const Eigen::MatrixXd& U, double& std_deviation)
 
 /// @brief Compute the median edge length of a mesh.
 double median_edge_length(
-    const Eigen::MatrixXd& V0,
-    const Eigen::MatrixXd& V1,
+    ConstMatrixXdRef V0,
+    ConstMatrixXdRef V1,
     const Eigen::MatrixXi& E)
 {
     if (E.rows() == 0) {
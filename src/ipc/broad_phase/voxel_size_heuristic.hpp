@@ -1,24 +1,40 @@
 #pragma once
 
+#include <ipc/utils/eigen_ext.hpp>
 #include <Eigen/Core>
 
 namespace ipc {
 
 double suggest_good_voxel_size(
-    const Eigen::MatrixXd& V,
+    ConstMatrixXdRef V,
     const Eigen::MatrixXi& E,
     double inflation_radius = 0);
 
 double suggest_good_voxel_size(
-    const Eigen::MatrixXd& V0,
-    const Eigen::MatrixXd& V1,
+    ConstMatrixXdRef V0,
+    ConstMatrixXdRef V1,
     const Eigen::MatrixXi& E,
     double inflation_radius = 0);
 
+/// @brief Suggest a voxel size from a precomputed median edge length.
+/// Used with CollisionMesh::rest_median_edge_length() to skip the O(|E|)
+/// median pass on every rebuild (see BroadPhase::edge_length_median_hint).
+double suggest_good_voxel_size(
+    double edge_len_median, double inflation_radius = 0);
+
+/// @brief Suggest a voxel size for CCD from a precomputed median edge
+/// length. The median displacement length still depends on the current
+/// positions and is computed here (a vectorized O(|V|) pass).
+double suggest_good_voxel_size(
+    ConstMatrixXdRef V0,
+    ConstMatrixXdRef V1,
+    double edge_len_median,
+    double inflation_radius = 0);
+
 /// @brief Compute the average edge length of a mesh.
 double mean_edge_length(
-    const Eigen::MatrixXd& V0,
-    const Eigen::MatrixXd& V1,
+    ConstMatrixXdRef V0,
+    ConstMatrixXdRef V1,
     const Eigen::MatrixXi& E,
     double& std_deviation);
 
@@ -28,8 +44,8 @@ mean_displacement_length(const Eigen::MatrixXd& U, double& std_deviation);
 
 /// @brief Compute the median edge length of a mesh.
 double median_edge_length(
-    const Eigen::MatrixXd& V0,
-    const Eigen::MatrixXd& V1,
+    ConstMatrixXdRef V0,
+    ConstMatrixXdRef V1,
     const Eigen::MatrixXi& E);
 
 /// @brief Compute the median displacement length.
@@ -0,0 +1,214 @@
+#include "additive_ccd.hpp"
+
+#include <ipc/distance/point_point.hpp>
+#include <ipc/distance/point_edge.hpp>
+#include <ipc/distance/edge_edge.hpp>
+#include <ipc/distance/point_triangle.hpp>
+#include <ipc/utils/logger.hpp>
+
+#include <algorithm> // std::min/max
+#include <array>
+
+namespace ipc {
+
+namespace {
+
+    /// @brief Advance the points until the distance drops below the gap.
+    /// @param x Positions of the points at the start of the time step.
+    /// @param p Displacements of the points with the mean removed.
+    /// @param l_p Upper bound on the relative displacement magnitude.
+    /// @param distance_sqr Squared distance between the two primitives.
+    /// @param[out] toi Computed time of impact (normalized).
+    /// @param tmax Maximum time (normalized) to look for collisions.
+    /// @param max_iterations Maximum number of advancement iterations.
+    /// @param conservative_rescaling Conservative rescaling of the toi.
+    /// @return If the primitives impact over the time interval.
+    template <typename DistanceSqr>
+    bool additive_ccd(
+        std::array<Eigen::Vector3d, 4> x,
+        const std::array<Eigen::Vector3d, 4>& p,
+        const double l_p,
+        const DistanceSqr& distance_sqr,
+        double& toi,
+        const double tmax,
+        const long max_iterations,
+        const double conservative_rescaling)
+    {
+        assert(tmax >= 0 && tmax <= 1.0);
+
+        if (l_p == 0) {
+            return false; // The primitives do not approach each other.
+        }
+
+        double d = sqrt(distance_sqr(x));
+        if (d == 0) {
+            IPC_LOG_WARN("Initial distance is 0, returning toi=0!");
+            toi = 0;
+            return true;
+        }
+
+        // Stop the advancement when the distance drops below this gap,
+        // matching the minimum separation used by ccd_strategy.
+        const double g = (1 - conservative_rescaling) * d;
+        assert(g < d);
+
+        toi = 0;
+        double t_l = (d - g) / l_p;
+        for (long i = 0; i < max_iterations; i++) {
+            for (int j = 0; j < 4; j++) {
+                x[j] += t_l * p[j];
+            }
+
+            d = sqrt(distance_sqr(x));
+            if (toi > 0 && d < g) {
+                return true; // The last step reached the gap.
+            }
+
+            toi += t_l;
+            if (toi > tmax) {
+                return false; // No impact up to tmax.
+            }
+
+            t_l = 0.9 * (d - g) / l_p;
+        }
+
+        // Ran out of iterations; conservatively report an impact now.
+        return true;
+    }
+
+} // namespace
+
+bool point_point_additive_ccd(
+    const Eigen::Vector3d& p0_t0,
+    const Eigen::Vector3d& p1_t0,
+    const Eigen::Vector3d& p0_t1,
+    const Eigen::Vector3d& p1_t1,
+    double& toi,
+    const double tmax,
+    const long max_iterations,
+    const double conservative_rescaling)
+{
+    std::array<Eigen::Vector3d, 4> x = { { p0_t0, p1_t0, p0_t0, p1_t0 } };
+    std::array<Eigen::Vector3d, 4> p = { { p0_t1 - p0_t0, p1_t1 - p1_t0,
+                                           Eigen::Vector3d::Zero(),
+                                           Eigen::Vector3d::Zero() } };
+
+    // The distance is translation invariant, so remove the mean displacement
+    // to tighten the bound on the relative displacement.
+    const Eigen::Vector3d p_bar = (p[0] + p[1]) / 2;
+    p[0] -= p_bar;
+    p[1] -= p_bar;
+
+    const double l_p = p[0].norm() + p[1].norm();
+
+    return additive_ccd(
+        x, p, l_p,
+        [](const std::array<Eigen::Vector3d, 4>& x) {
+            return point_point_distance(x[0], x[1]);
+        },
+        toi, tmax, max_iterations, conservative_rescaling);
+}
+
+bool point_edge_additive_ccd(
+    const Eigen::Vector3d& p_t0,
+    const Eigen::Vector3d& e0_t0,
+    const Eigen::Vector3d& e1_t0,
+    const Eigen::Vector3d& p_t1,
+    const Eigen::Vector3d& e0_t1,
+    const Eigen::Vector3d& e1_t1,
+    double& toi,
+    const double tmax,
+    const long max_iterations,
+    const double conservative_rescaling)
+{
+    std::array<Eigen::Vector3d, 4> x = { { p_t0, e0_t0, e1_t0, p_t0 } };
+    std::array<Eigen::Vector3d, 4> p = { { p_t1 - p_t0, e0_t1 - e0_t0,
+                                           e1_t1 - e1_t0,
+                                           Eigen::Vector3d::Zero() } };
+
+    const Eigen::Vector3d p_bar = (p[0] + p[1] + p[2]) / 3;
+    p[0] -= p_bar;
+    p[1] -= p_bar;
+    p[2] -= p_bar;
+
+    const double l_p = p[0].norm() + std::max(p[1].norm(), p[2].norm());
+
+    return additive_ccd(
+        x, p, l_p,
+        [](const std::array<Eigen::Vector3d, 4>& x) {
+            return point_edge_distance(x[0], x[1], x[2]);
+        },
+        toi, tmax, max_iterations, conservative_rescaling);
+}
+
+bool edge_edge_additive_ccd(
+    const Eigen::Vector3d& ea0_t0,
+    const Eigen::Vector3d& ea1_t0,
+    const Eigen::Vector3d& eb0_t0,
+    const Eigen::Vector3d& eb1_t0,
+    const Eigen::Vector3d& ea0_t1,
+    const Eigen::Vector3d& ea1_t1,
+    const Eigen::Vector3d& eb0_t1,
+    const Eigen::Vector3d& eb1_t1,
+    double& toi,
+    const double tmax,
+    const long max_iterations,
+    const double conservative_rescaling)
+{
+    std::array<Eigen::Vector3d, 4> x = { { ea0_t0, ea1_t0, eb0_t0, eb1_t0 } };
+    std::array<Eigen::Vector3d, 4> p = {
+        { ea0_t1 - ea0_t0, ea1_t1 - ea1_t0, eb0_t1 - eb0_t0, eb1_t1 - eb1_t0 }
+    };
+
+    const Eigen::Vector3d p_bar = (p[0] + p[1] + p[2] + p[3]) / 4;
+    for (int j = 0; j < 4; j++) {
+        p[j] -= p_bar;
+    }
+
+    const double l_p = std::max(p[0].norm(), p[1].norm())
+        + std::max(p[2].norm(), p[3].norm());
+
+    return additive_ccd(
+        x, p, l_p,
+        [](const std::array<Eigen::Vector3d, 4>& x) {
+            return edge_edge_distance(x[0], x[1], x[2], x[3]);
+        },
+        toi, tmax, max_iterations, conservative_rescaling);
+}
+
+bool point_triangle_additive_ccd(
+    const Eigen::Vector3d& p_t0,
+    const Eigen::Vector3d& t0_t0,
+    const Eigen::Vector3d& t1_t0,
+    const Eigen::Vector3d& t2_t0,
+    const Eigen::Vector3d& p_t1,
+    const Eigen::Vector3d& t0_t1,
+    const Eigen::Vector3d& t1_t1,
+    const Eigen::Vector3d& t2_t1,
+    double& toi,
+    const double tmax,
+    const long max_iterations,
+    const double conservative_rescaling)
+{
+    std::array<Eigen::Vector3d, 4> x = { { p_t0, t0_t0, t1_t0, t2_t0 } };
+    std::array<Eigen::Vector3d, 4> p = {
+        { p_t1 - p_t0, t0_t1 - t0_t0, t1_t1 - t1_t0, t2_t1 - t2_t0 }
+    };
+
+    const Eigen::Vector3d p_bar = (p[0] + p[1] + p[2] + p[3]) / 4;
+    for (int j = 0; j < 4; j++) {
+        p[j] -= p_bar;
+    }
+
+    const double l_p = p[0].norm()
+        + std::max({ p[1].norm(), p[2].norm(), p[3].norm() });
+
+    return additive_ccd(
+        x, p, l_p,
+        [](const std::array<Eigen::Vector3d, 4>& x) {
+            return point_triangle_distance(x[0], x[1], x[2], x[3]);
+        },
+        toi, tmax, max_iterations, conservative_rescaling);
+}
+
+} // namespace ipc
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <ipc/ccd/ccd.hpp>
+
+#include <Eigen/Core>
+
+namespace ipc {
+
+/// @file Additive CCD (conservative advancement) as described in
+/// "Codimensional Incremental Potential Contact" [Li et al. 2021]. The
+/// points are advanced by conservative time steps until the distance drops
+/// below a gap proportional to the initial distance. The reported time of
+/// impact is conservative (never later than the true impact), but unlike
+/// Tight-Inclusion it is not certified, so it is best used as a cheap first
+/// pass with Tight-Inclusion reserved for the queries it cannot resolve.
+
+/// The default maximum number of advancement iterations used with additive
+/// CCD.
+static constexpr long DEFAULT_ADDITIVE_CCD_MAX_ITERATIONS = 10'000'000l;
+
+bool point_point_additive_ccd(
+    const Eigen::Vector3d& p0_t0,
+    const Eigen::Vector3d& p1_t0,
+    const Eigen::Vector3d& p0_t1,
+    const Eigen::Vector3d& p1_t1,
+    double& toi,
+    const double tmax = 1.0,
+    const long max_iterations = DEFAULT_ADDITIVE_CCD_MAX_ITERATIONS,
+    const double conservative_rescaling = DEFAULT_CCD_CONSERVATIVE_RESCALING);
+
+bool point_edge_additive_ccd(
+    const Eigen::Vector3d& p_t0,
+    const Eigen::Vector3d& e0_t0,
+    const Eigen::Vector3d& e1_t0,
+    const Eigen::Vector3d& p_t1,
+    const Eigen::Vector3d& e0_t1,
+    const Eigen::Vector3d& e1_t1,
+    double& toi,
+    const double tmax = 1.0,
+    const long max_iterations = DEFAULT_ADDITIVE_CCD_MAX_ITERATIONS,
+    const double conservative_rescaling = DEFAULT_CCD_CONSERVATIVE_RESCALING);
+
+bool edge_edge_additive_ccd(
+    const Eigen::Vector3d& ea0_t0,
+    const Eigen::Vector3d& ea1_t0,
+    const Eigen::Vector3d& eb0_t0,
+    const Eigen::Vector3d& eb1_t0,
+    const Eigen::Vector3d& ea0_t1,
+    const Eigen::Vector3d& ea1_t1,
+    const Eigen::Vector3d& eb0_t1,
+    const Eigen::Vector3d& eb1_t1,
+    double& toi,
+    const double tmax = 1.0,
+    const long max_iterations = DEFAULT_ADDITIVE_CCD_MAX_ITERATIONS,
+    const double conservative_rescaling = DEFAULT_CCD_CONSERVATIVE_RESCALING);
+
+bool point_triangle_additive_ccd(
+    const Eigen::Vector3d& p_t0,
+    const Eigen::Vector3d& t0_t0,
+    const Eigen::Vector3d& t1_t0,
+    const Eigen::Vector3d& t2_t0,
+    const Eigen::Vector3d& p_t1,
+    const Eigen::Vector3d& t0_t1,
+    const Eigen::Vector3d& t1_t1,
+    const Eigen::Vector3d& t2_t1,
+    double& toi,
+    const double tmax = 1.0,
+    const long max_iterations = DEFAULT_ADDITIVE_CCD_MAX_ITERATIONS,
+    const double conservative_rescaling = DEFAULT_CCD_CONSERVATIVE_RESCALING);
+
+} // namespace ipc
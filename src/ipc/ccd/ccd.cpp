@@ -3,6 +3,7 @@
 #include <ipc/distance/point_edge.hpp>
 #include <ipc/distance/edge_edge.hpp>
 #include <ipc/distance/point_triangle.hpp>
+#include <ipc/utils/logger.hpp>
 
 #include <ipc/config.hpp>
 
@@ -14,9 +15,122 @@
 
 #include <algorithm> // std::min/max
 #include <array>
+#include <atomic>
 
 namespace ipc {
 
+namespace {
+
+    /// Process-wide CCD statistics accumulator (see enable_ccd_stats()).
+    /// Atomic because the narrow-phase queries run in parallel loops.
+    struct CCDStatsCounters {
+        std::atomic<bool> enabled = false;
+        std::atomic<size_t> num_queries = 0;
+        std::atomic<size_t> num_impacts = 0;
+        std::atomic<size_t> num_tolerance_unmet = 0;
+        std::atomic<size_t> num_small_toi_refinements = 0;
+        std::atomic<double> sum_reached_tolerance = 0;
+        std::atomic<double> max_reached_tolerance = 0;
+    };
+
+    CCDStatsCounters& ccd_stats_counters()
+    {
+        static CCDStatsCounters counters;
+        return counters;
+    }
+
+    /// Record one Tight-Inclusion query (no-op unless stats are enabled).
+    void record_ccd_query(
+        const double requested_tolerance,
+        const double reached_tolerance,
+        const bool is_impacting)
+    {
+        CCDStatsCounters& counters = ccd_stats_counters();
+        if (!counters.enabled.load(std::memory_order_relaxed)) {
+            return;
+        }
+
+        counters.num_queries.fetch_add(1, std::memory_order_relaxed);
+        if (is_impacting) {
+            counters.num_impacts.fetch_add(1, std::memory_order_relaxed);
+        }
+        if (reached_tolerance > requested_tolerance) {
+            counters.num_tolerance_unmet.fetch_add(
+                1, std::memory_order_relaxed);
+        }
+
+        // fetch_add/max for doubles are C++20, so compare-exchange instead.
+        double sum = counters.sum_reached_tolerance.load(
+            std::memory_order_relaxed);
+        while (!counters.sum_reached_tolerance.compare_exchange_weak(
+            sum, sum + reached_tolerance, std::memory_order_relaxed)) {
+        }
+        double max = counters.max_reached_tolerance.load(
+            std::memory_order_relaxed);
+        while (reached_tolerance > max
+               && !counters.max_reached_tolerance.compare_exchange_weak(
+                   max, reached_tolerance, std::memory_order_relaxed)) {
+        }
+    }
+
+    /// Record a rerun without the conservative minimum separation.
+    void record_ccd_small_toi_refinement()
+    {
+        CCDStatsCounters& counters = ccd_stats_counters();
+        if (counters.enabled.load(std::memory_order_relaxed)) {
+            counters.num_small_toi_refinements.fetch_add(
+                1, std::memory_order_relaxed);
+        }
+    }
+
+} // namespace
+
+void CCDStats::log() const
+{
+    logger().debug(
+        "ccd: {} queries ({} impacts, {} tolerance unmet, {} small-toi "
+        "refinements); reached tolerance mean {:g} max {:g}",
+        num_queries, num_impacts, num_tolerance_unmet,
+        num_small_toi_refinements,
+        num_queries == 0 ? 0.0 : sum_reached_tolerance / num_queries,
+        max_reached_tolerance);
+}
+
+void enable_ccd_stats(const bool enable)
+{
+    ccd_stats_counters().enabled.store(enable, std::memory_order_relaxed);
+}
+
+void reset_ccd_stats()
+{
+    CCDStatsCounters& counters = ccd_stats_counters();
+    counters.num_queries = 0;
+    counters.num_impacts = 0;
+    counters.num_tolerance_unmet = 0;
+    counters.num_small_toi_refinements = 0;
+    counters.sum_reached_tolerance = 0;
+    counters.max_reached_tolerance = 0;
+}
+
+CCDStats ccd_stats()
+{
+    const CCDStatsCounters& counters = ccd_stats_counters();
+    CCDStats stats;
+    stats.num_queries =
+        counters.num_queries.load(std::memory_order_relaxed);
+    stats.num_impacts =
+        counters.num_impacts.load(std::memory_order_relaxed);
+    stats.num_tolerance_unmet =
+        counters.num_tolerance_unmet.load(std::memory_order_relaxed);
+    stats.num_small_toi_refinements =
+        counters.num_small_toi_refinements.load(std::memory_order_relaxed);
+    stats.sum_reached_tolerance =
+        counters.sum_reached_tolerance.load(std::memory_order_relaxed);
+    stats.max_reached_tolerance =
+        counters.max_reached_tolerance.load(std::memory_order_relaxed);
+    return stats;
+}
+
 #ifdef IPC_TOOLKIT_WITH_CORRECT_CCD
 static constexpr double INITIAL_DISTANCE_TOLERANCE_SCALE = 0.5;
 static constexpr long TIGHT_INCLUSION_UNLIMITED_ITERATIONS = -1;
@@ -25,6 +139,15 @@ static constexpr long TIGHT_INCLUSION_UNLIMITED_ITERATIONS = -1;
 /// @brief Tolerance for small time of impact which triggers rerunning CCD without a minimum separation.
 static constexpr double SMALL_TOI = 1e-6;
 
+/// @brief Maximum number of margin-halving polish passes after an impact.
+/// Two passes shrink the reserved margin from (1 - c) to (1 - c) / 4 of
+/// the gap (5% with the default c = 0.8), so the returned toi approaches
+/// the true impact time instead of discarding a fifth of every step.
+static constexpr int TOI_POLISH_MAX_ITERATIONS = 2;
+/// @brief Stop polishing when a pass grows the toi by less than this
+/// fraction; the extra certified query is not worth a marginal gain.
+static constexpr double TOI_POLISH_MIN_GAIN = 0.05;
+
 bool ccd_strategy(
     const std::function<bool(
         long /*max_iterations*/,
@@ -32,29 +155,37 @@ bool ccd_strategy(
         bool /*no_zero_toi*/,
         double& /*toi*/)>& ccd,
     const double max_iterations,
+    const double min_distance,
     const double initial_distance,
     const double conservative_rescaling,
     double& toi)
 {
 
-    if (initial_distance == 0) {
-        logger().warn("Initial distance is 0, returning toi=0!");
+    if (initial_distance <= min_distance) {
+        IPC_LOG_WARN(
+            "Initial distance {} is less than minimum separation {}, "
+            "returning toi=0!",
+            initial_distance, min_distance);
         toi = 0;
         return true;
     }
 
-    double min_distance = (1.0 - conservative_rescaling) * initial_distance;
+    // Reserve a conservative fraction of the distance above the minimum
+    // separation so a full step never lands exactly on the separation.
+    double effective_min_distance = min_distance
+        + (1.0 - conservative_rescaling) * (initial_distance - min_distance);
     // #ifdef IPC_TOOLKIT_WITH_CORRECT_CCD
     // Tight Inclusion performs better when the minimum separation is small
-    // min_distance = std::min(min_distance, 1e-4);
+    // effective_min_distance = std::min(effective_min_distance, 1e-4);
     // #endif
 
-    assert(min_distance < initial_distance);
+    assert(effective_min_distance < initial_distance);
 
-    // Do not use no_zero_toi because the minimum distance is arbitrary and can
-    // be removed if the query is challenging (i.e., produces small ToI).
-    bool is_impacting =
-        ccd(max_iterations, min_distance, /*no_zero_toi=*/false, toi);
+    // Do not use no_zero_toi because the effective minimum distance is
+    // arbitrary and can be reduced to the requested minimum separation if the
+    // query is challenging (i.e., produces small ToI).
+    bool is_impacting = ccd(
+        max_iterations, effective_min_distance, /*no_zero_toi=*/false, toi);
 
     // #ifdef IPC_TOOLKIT_WITH_CORRECT_CCD
     //     // Tight inclusion will have higher accuracy and better performance
@@ -68,10 +199,38 @@ bool ccd_strategy(
     //     }
     // #endif
 
+    // Polish: the reserved margin above discards up to (1 - c) of the true
+    // step. Halve the margin and requery; every pass is distance-verified
+    // because the query itself certifies the separation stays above
+    // min_distance + margin for the whole returned interval. Stop when a
+    // pass stops paying (gain below TOI_POLISH_MIN_GAIN) or after
+    // TOI_POLISH_MAX_ITERATIONS passes. Tiny tois skip the polish and take
+    // the zero-margin refinement below instead.
+    double margin = effective_min_distance - min_distance;
+    for (int i = 0; is_impacting && toi >= SMALL_TOI && toi < 1
+         && i < TOI_POLISH_MAX_ITERATIONS;
+         i++) {
+        margin /= 2;
+        double polished_toi = toi;
+        if (!ccd(
+                max_iterations, min_distance + margin, /*no_zero_toi=*/false,
+                polished_toi)) {
+            // Certified: the separation stays above min_distance + margin
+            // over the full step, so there is no impact at the user's floor.
+            return false;
+        }
+        const double gain = polished_toi - toi;
+        toi = std::max(toi, polished_toi);
+        if (gain < TOI_POLISH_MIN_GAIN * toi) {
+            break;
+        }
+    }
+
     if (is_impacting && toi < SMALL_TOI) {
+        record_ccd_small_toi_refinement();
         is_impacting = ccd(
             /*max_iterations=*/TIGHT_INCLUSION_UNLIMITED_ITERATIONS,
-            /*min_distance=*/0, /*no_zero_toi=*/true, toi);
+            min_distance, /*no_zero_toi=*/true, toi);
 
         if (is_impacting) {
             toi *= conservative_rescaling;
@@ -88,6 +247,7 @@ bool point_point_ccd(
     const Eigen::Vector3d& p0_t1,
     const Eigen::Vector3d& p1_t1,
     double& toi,
+    const double min_distance,
     const double tmax,
     const double tolerance,
     const long max_iterations,
@@ -97,24 +257,49 @@ bool point_point_ccd(
 
     double initial_distance = sqrt(point_point_distance(p0_t0, p1_t0));
 
-    double adjusted_tolerance = std::min(
-        INITIAL_DISTANCE_TOLERANCE_SCALE * initial_distance, tolerance);
+    // The relative displacement bounds how much the points can approach each
+    // other, so pairs too far apart to touch are rejected without CCD.
+    if (initial_distance - min_distance
+        > ((p1_t1 - p1_t0) - (p0_t1 - p0_t0)).norm()) {
+        return false;
+    }
 
     const auto ccd = [&](long max_iterations, double min_distance,
                          bool no_zero_toi, double& toi) -> bool {
 #ifdef IPC_TOOLKIT_WITH_CORRECT_CCD
-        double output_tolerance;
-        // NOTE: Use degenerate edge-edge
-        return ticcd::edgeEdgeCCD(
-            p0_t0, p0_t0, p1_t0, p1_t0, p0_t1, p0_t1, p1_t1, p1_t1,
-            Eigen::Array3d::Constant(-1), // rounding error (auto)
-            min_distance,                 // minimum separation distance
-            toi,                          // time of impact
-            adjusted_tolerance,           // delta
-            tmax,                         // maximum time to check
-            max_iterations,               // maximum number of iterations
-            output_tolerance,             // delta_actual
-            no_zero_toi);
+        // The squared distance between two linearly moving points is a
+        // quadratic polynomial in time, so the earliest time it reaches
+        // min_distance is a root; solve it directly instead of running
+        // interval root finding on a degenerate edge-edge query.
+        const Eigen::Vector3d d0 = p1_t0 - p0_t0;
+        const Eigen::Vector3d dd = (p1_t1 - p1_t0) - (p0_t1 - p0_t0);
+
+        const double a = dd.squaredNorm();
+        const double b = 2 * d0.dot(dd);
+        // c > 0 because ccd_strategy guarantees min_distance < the initial
+        // distance.
+        const double c = d0.squaredNorm() - min_distance * min_distance;
+        assert(c > 0);
+
+        double t;
+        if (a == 0) {
+            if (b >= 0) {
+                return false; // The distance is not decreasing.
+            }
+            t = -c / b;
+        } else {
+            const double discriminant = b * b - 4 * a * c;
+            if (discriminant < 0) {
+                return false; // The points never get that close.
+            }
+            t = (-b - sqrt(discriminant)) / (2 * a);
+        }
+
+        if (t < 0 || t > tmax) {
+            return false;
+        }
+        toi = t;
+        return true;
 #else
         return CTCD::vertexVertexCTCD(
             p0_t0, p1_t0, p0_t1, p1_t1, min_distance, toi);
@@ -122,7 +307,8 @@ bool point_point_ccd(
     };
 
     return ccd_strategy(
-        ccd, max_iterations, initial_distance, conservative_rescaling, toi);
+        ccd, max_iterations, min_distance, initial_distance,
+        conservative_rescaling, toi);
 }
 
 inline Eigen::Vector3d to_3D(const Eigen::Vector2d& v)
@@ -138,12 +324,18 @@ bool point_edge_ccd_2D(
     const Eigen::Vector2d& e0_t1,
     const Eigen::Vector2d& e1_t1,
     double& toi,
+    const double min_distance,
     const double tmax,
     const double tolerance,
     const long max_iterations,
     const double conservative_rescaling)
 {
 #ifndef IPC_TOOLKIT_WITH_CORRECT_CCD
+    if (min_distance != 0) {
+        throw std::runtime_error(
+            "Minimum separation CCD is not implemented for inexact "
+            "point-edge CCD!");
+    }
     inexact_point_edge_ccd_2D(
         p_t0, e0_t0, e1_t0, p_t1, e0_t1, e1_t1, toi, conservative_rescaling);
 #else
@@ -158,6 +350,21 @@ bool point_edge_ccd_2D(
 
     double initial_distance = sqrt(point_edge_distance(p_t0, e0_t0, e1_t0));
 
+    // Conservative bound on how far the point and edge can approach each
+    // other over the whole trajectory (translations removed); pairs too far
+    // apart to touch are rejected without running CCD.
+    {
+        const Eigen::Vector2d dp = p_t1 - p_t0;
+        const Eigen::Vector2d de0 = e0_t1 - e0_t0;
+        const Eigen::Vector2d de1 = e1_t1 - e1_t0;
+        const Eigen::Vector2d d_bar = (dp + de0 + de1) / 3;
+        const double max_approach = (dp - d_bar).norm()
+            + std::max((de0 - d_bar).norm(), (de1 - d_bar).norm());
+        if (initial_distance - min_distance > max_approach) {
+            return false;
+        }
+    }
+
     double adjusted_tolerance = std::min(
         INITIAL_DISTANCE_TOLERANCE_SCALE * initial_distance, tolerance);
 
@@ -176,8 +383,9 @@ bool point_edge_ccd_2D(
             max_iterations,               // maximum number of iterations
             output_tolerance,             // delta_actual
             no_zero_toi);
+        record_ccd_query(adjusted_tolerance, output_tolerance, is_impacting);
         if (adjusted_tolerance < output_tolerance && toi < SMALL_TOI) {
-            logger().trace(
+            IPC_LOG_TRACE(
                 "ticcd::edgeEdgeCCD exceeded iteration limit (min_dist={:g} "
                 "max_iterations={:d} input_tol={:g} output_tol={:g} toi={:g})",
                 min_distance, max_iterations, adjusted_tolerance,
@@ -187,7 +395,8 @@ bool point_edge_ccd_2D(
     };
 
     return ccd_strategy(
-        ccd, max_iterations, initial_distance, conservative_rescaling, toi);
+        ccd, max_iterations, min_distance, initial_distance,
+        conservative_rescaling, toi);
 #endif
 }
 
@@ -199,6 +408,7 @@ bool point_edge_ccd_3D(
     const Eigen::Vector3d& e0_t1,
     const Eigen::Vector3d& e1_t1,
     double& toi,
+    const double min_distance,
     const double tmax,
     const double tolerance,
     const long max_iterations,
@@ -208,32 +418,80 @@ bool point_edge_ccd_3D(
 
     double initial_distance = sqrt(point_edge_distance(p_t0, e0_t0, e1_t0));
 
+    // Conservative bound on how far the point and edge can approach each
+    // other over the whole trajectory (translations removed); pairs too far
+    // apart to touch are rejected without running CCD.
+    {
+        const Eigen::Vector3d dp = p_t1 - p_t0;
+        const Eigen::Vector3d de0 = e0_t1 - e0_t0;
+        const Eigen::Vector3d de1 = e1_t1 - e1_t0;
+        const Eigen::Vector3d d_bar = (dp + de0 + de1) / 3;
+        const double max_approach = (dp - d_bar).norm()
+            + std::max((de0 - d_bar).norm(), (de1 - d_bar).norm());
+        if (initial_distance - min_distance > max_approach) {
+            return false;
+        }
+    }
+
     double adjusted_tolerance = std::min(
         INITIAL_DISTANCE_TOLERANCE_SCALE * initial_distance, tolerance);
 
     const auto ccd = [&](long max_iterations, double min_distance,
                          bool no_zero_toi, double& toi) -> bool {
 #ifdef IPC_TOOLKIT_WITH_CORRECT_CCD
-        double output_tolerance = tolerance;
-        // NOTE: Use degenerate edge-edge
-        bool is_impacting = ticcd::edgeEdgeCCD(
-            p_t0, p_t0, e0_t0, e1_t0, p_t1, p_t1, e0_t1, e1_t1,
-            Eigen::Array3d::Constant(-1), // rounding error (auto)
-            min_distance,                 // minimum separation distance
-            toi,                          // time of impact
-            adjusted_tolerance,           // delta
-            tmax,                         // maximum time to check
-            max_iterations,               // maximum number of iterations
-            output_tolerance,             // delta_actual
-            no_zero_toi);
-        if (adjusted_tolerance < output_tolerance && toi < SMALL_TOI) {
-            logger().trace(
-                "ticcd::edgeEdgeCCD exceeded iteration limit (min_dist={:g} "
-                "max_iterations={:d} input_tol={:g} output_tol={:g} toi={:g})",
-                min_distance, max_iterations, adjusted_tolerance,
-                output_tolerance, toi);
+        // Conservatively advance on the exact point-edge distance instead of
+        // running interval root finding on a degenerate four-point edge-edge
+        // query. Each step is bounded by the remaining distance over the
+        // maximum relative displacement, so the reported toi is never later
+        // than the true impact; the advancement stops (and reports an
+        // impact) once the distance is within the tolerance of min_distance.
+        Eigen::Vector3d dp = p_t1 - p_t0;
+        Eigen::Vector3d de0 = e0_t1 - e0_t0;
+        Eigen::Vector3d de1 = e1_t1 - e1_t0;
+        // The distance is translation invariant, so remove the mean
+        // displacement to tighten the bound on the relative displacement.
+        const Eigen::Vector3d d_bar = (dp + de0 + de1) / 3;
+        dp -= d_bar;
+        de0 -= d_bar;
+        de1 -= d_bar;
+
+        const double l_p = dp.norm() + std::max(de0.norm(), de1.norm());
+        if (l_p == 0) {
+            return false; // The point and edge do not approach each other.
         }
-        return is_impacting;
+
+        Eigen::Vector3d p = p_t0, e0 = e0_t0, e1 = e1_t0;
+        double d = sqrt(point_edge_distance(p, e0, e1));
+
+        // Keep the termination band strictly below the initial gap so the
+        // advancement cannot report an impact before taking a single step.
+        const double band = min_distance
+            + std::min(
+                  adjusted_tolerance,
+                  INITIAL_DISTANCE_TOLERANCE_SCALE * (d - min_distance));
+
+        toi = 0;
+        for (long i = 0; max_iterations < 0 || i < max_iterations; i++) {
+            if (d <= band) {
+                return true; // Within the tolerance band of the gap.
+            }
+            if (toi >= tmax) {
+                return false; // No impact up to tmax.
+            }
+
+            // A step of (d - min_distance) / l_p cannot cross the gap.
+            const double t_l = std::min(
+                0.9 * (d - min_distance) / l_p, tmax - toi);
+            p += t_l * dp;
+            e0 += t_l * de0;
+            e1 += t_l * de1;
+            toi += t_l;
+
+            d = sqrt(point_edge_distance(p, e0, e1));
+        }
+
+        // Ran out of iterations; conservatively report an impact now.
+        return true;
 #else
         return CTCD::vertexEdgeCTCD(
             p_t0, e0_t0, e1_t0, p_t1, e0_t1, e1_t1, min_distance, toi);
@@ -241,7 +499,8 @@ bool point_edge_ccd_3D(
     };
 
     return ccd_strategy(
-        ccd, max_iterations, initial_distance, conservative_rescaling, toi);
+        ccd, max_iterations, min_distance, initial_distance,
+        conservative_rescaling, toi);
 }
 
 bool point_edge_ccd(
@@ -252,6 +511,7 @@ bool point_edge_ccd(
     const VectorMax3d& e0_t1,
     const VectorMax3d& e1_t1,
     double& toi,
+    const double min_distance,
     const double tmax,
     const double tolerance,
     const long max_iterations,
@@ -266,11 +526,13 @@ bool point_edge_ccd(
     if (dim == 2) {
         return point_edge_ccd_2D(
             p_t0, e0_t0, e1_t0, p_t1, e0_t1, e1_t1, //
-            toi, tmax, tolerance, max_iterations, conservative_rescaling);
+            toi, min_distance, tmax, tolerance, max_iterations,
+            conservative_rescaling);
     } else {
         return point_edge_ccd_3D(
             p_t0, e0_t0, e1_t0, p_t1, e0_t1, e1_t1, //
-            toi, tmax, tolerance, max_iterations, conservative_rescaling);
+            toi, min_distance, tmax, tolerance, max_iterations,
+            conservative_rescaling);
     }
 }
 
@@ -284,6 +546,7 @@ bool edge_edge_ccd(
     const Eigen::Vector3d& eb0_t1,
     const Eigen::Vector3d& eb1_t1,
     double& toi,
+    const double min_distance,
     const double tmax,
     const double tolerance,
     const long max_iterations,
@@ -294,6 +557,23 @@ bool edge_edge_ccd(
     double initial_distance =
         sqrt(edge_edge_distance(ea0_t0, ea1_t0, eb0_t0, eb1_t0));
 
+    // Conservative bound on how far the edges can approach each other over
+    // the whole trajectory (translations removed); pairs too far apart to
+    // touch are rejected without running CCD.
+    {
+        const Eigen::Vector3d da0 = ea0_t1 - ea0_t0;
+        const Eigen::Vector3d da1 = ea1_t1 - ea1_t0;
+        const Eigen::Vector3d db0 = eb0_t1 - eb0_t0;
+        const Eigen::Vector3d db1 = eb1_t1 - eb1_t0;
+        const Eigen::Vector3d d_bar = (da0 + da1 + db0 + db1) / 4;
+        const double max_approach =
+            std::max((da0 - d_bar).norm(), (da1 - d_bar).norm())
+            + std::max((db0 - d_bar).norm(), (db1 - d_bar).norm());
+        if (initial_distance - min_distance > max_approach) {
+            return false;
+        }
+    }
+
     double adjusted_tolerance = std::min(
         INITIAL_DISTANCE_TOLERANCE_SCALE * initial_distance, tolerance);
 
@@ -311,8 +591,9 @@ bool edge_edge_ccd(
             max_iterations,               // maximum number of iterations
             output_tolerance,             // delta_actual
             no_zero_toi);
+        record_ccd_query(adjusted_tolerance, output_tolerance, is_impacting);
         if (adjusted_tolerance < output_tolerance && toi < SMALL_TOI) {
-            logger().trace(
+            IPC_LOG_TRACE(
                 "ticcd::edgeEdgeCCD exceeded iteration limit (min_dist={:g} "
                 "max_iterations={:d} input_tol={:g} output_tol={:g} toi={:g})",
                 min_distance, max_iterations, adjusted_tolerance,
@@ -327,7 +608,8 @@ bool edge_edge_ccd(
     };
 
     return ccd_strategy(
-        ccd, max_iterations, initial_distance, conservative_rescaling, toi);
+        ccd, max_iterations, min_distance, initial_distance,
+        conservative_rescaling, toi);
 }
 
 bool point_triangle_ccd(
@@ -340,6 +622,7 @@ bool point_triangle_ccd(
     const Eigen::Vector3d& t1_t1,
     const Eigen::Vector3d& t2_t1,
     double& toi,
+    const double min_distance,
     const double tmax,
     const double tolerance,
     const long max_iterations,
@@ -350,6 +633,24 @@ bool point_triangle_ccd(
     double initial_distance =
         sqrt(point_triangle_distance(p_t0, t0_t0, t1_t0, t2_t0));
 
+    // Conservative bound on how far the point and triangle can approach each
+    // other over the whole trajectory (translations removed); pairs too far
+    // apart to touch are rejected without running CCD.
+    {
+        const Eigen::Vector3d dp = p_t1 - p_t0;
+        const Eigen::Vector3d dt0 = t0_t1 - t0_t0;
+        const Eigen::Vector3d dt1 = t1_t1 - t1_t0;
+        const Eigen::Vector3d dt2 = t2_t1 - t2_t0;
+        const Eigen::Vector3d d_bar = (dp + dt0 + dt1 + dt2) / 4;
+        const double max_approach = (dp - d_bar).norm()
+            + std::max(
+                  { (dt0 - d_bar).norm(), (dt1 - d_bar).norm(),
+                    (dt2 - d_bar).norm() });
+        if (initial_distance - min_distance > max_approach) {
+            return false;
+        }
+    }
+
     double adjusted_tolerance = std::min(
         INITIAL_DISTANCE_TOLERANCE_SCALE * initial_distance, tolerance);
 
@@ -367,8 +668,9 @@ bool point_triangle_ccd(
             max_iterations,               // maximum number of iterations
             output_tolerance,             // delta_actual
             no_zero_toi);
+        record_ccd_query(adjusted_tolerance, output_tolerance, is_impacting);
         if (adjusted_tolerance < output_tolerance && toi < SMALL_TOI) {
-            logger().trace(
+            IPC_LOG_TRACE(
                 "ticcd::vertexFaceCCD exceeded iteration limit (min_dist={:g} "
                 "max_iterations={:d} input_tol={:g} output_tol={:g} toi={:g})",
                 min_distance, max_iterations, adjusted_tolerance,
@@ -383,7 +685,8 @@ bool point_triangle_ccd(
     };
 
     return ccd_strategy(
-        ccd, max_iterations, initial_distance, conservative_rescaling, toi);
+        ccd, max_iterations, min_distance, initial_distance,
+        conservative_rescaling, toi);
 }
 
 } // namespace ipc
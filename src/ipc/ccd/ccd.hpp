@@ -12,6 +12,54 @@ static constexpr long DEFAULT_CCD_MAX_ITERATIONS = 1e7;
 /// to impact.
 static constexpr double DEFAULT_CCD_CONSERVATIVE_RESCALING = 0.8;
 
+/// @brief Aggregated statistics of the Tight-Inclusion narrow-phase queries
+/// (see enable_ccd_stats()).
+///
+/// Tight-Inclusion reports the tolerance it actually reached; a query that
+/// stops at the iteration limit reports a reached tolerance above the
+/// requested one. The wrappers record both, so tolerance and max_iterations
+/// can be tuned from production distributions instead of guesswork. The
+/// counters accumulate until reset_ccd_stats(); to aggregate a single
+/// compute_collision_free_stepsize call, reset before the call and take a
+/// snapshot after it.
+/// @note Only the interval-refinement queries are counted; the closed-form
+/// point-point and conservative-advancement point-edge paths do not refine
+/// and are not recorded.
+struct CCDStats {
+    /// @brief Number of Tight-Inclusion queries run.
+    size_t num_queries = 0;
+    /// @brief Number of queries reporting an impact.
+    size_t num_impacts = 0;
+    /// @brief Queries that hit the iteration limit before reaching the
+    /// requested tolerance (the early-termination case).
+    size_t num_tolerance_unmet = 0;
+    /// @brief Queries rerun without the conservative minimum separation
+    /// because the first pass reported a small time of impact.
+    size_t num_small_toi_refinements = 0;
+    /// @brief Sum of the reached tolerances (divide by num_queries for the
+    /// mean).
+    double sum_reached_tolerance = 0;
+    /// @brief Largest reached tolerance.
+    double max_reached_tolerance = 0;
+
+    /// @brief Write the statistics to the logger at debug level.
+    void log() const;
+};
+
+/// @brief Enable or disable CCD statistics collection (off by default).
+///
+/// When enabled, the Tight-Inclusion wrappers record per-query reached
+/// tolerances and termination reasons into a process-wide accumulator
+/// queryable through ccd_stats(). The counters are atomic, so collection is
+/// safe inside the parallel narrow-phase loops.
+void enable_ccd_stats(const bool enable = true);
+
+/// @brief Reset the CCD statistics counters to zero.
+void reset_ccd_stats();
+
+/// @brief Snapshot of the CCD statistics accumulated since the last reset.
+CCDStats ccd_stats();
+
 // 2D
 
 bool point_edge_ccd_2D(
@@ -22,6 +70,7 @@ bool point_edge_ccd_2D(
     const Eigen::Vector2d& e0_t1,
     const Eigen::Vector2d& e1_t1,
     double& toi,
+    const double min_distance = 0.0,
     const double tmax = 1.0,
     const double tolerance = DEFAULT_CCD_TOLERANCE,
     const long max_iterations = DEFAULT_CCD_MAX_ITERATIONS,
@@ -35,6 +84,7 @@ bool point_point_ccd(
     const Eigen::Vector3d& p0_t1,
     const Eigen::Vector3d& p1_t1,
     double& toi,
+    const double min_distance = 0.0,
     const double tmax = 1.0,
     const double tolerance = DEFAULT_CCD_TOLERANCE,
     const long max_iterations = DEFAULT_CCD_MAX_ITERATIONS,
@@ -48,6 +98,7 @@ bool point_edge_ccd_3D(
     const Eigen::Vector3d& e0_t1,
     const Eigen::Vector3d& e1_t1,
     double& toi,
+    const double min_distance = 0.0,
     const double tmax = 1.0,
     const double tolerance = DEFAULT_CCD_TOLERANCE,
     const long max_iterations = DEFAULT_CCD_MAX_ITERATIONS,
@@ -63,6 +114,7 @@ bool point_triangle_ccd(
     const Eigen::Vector3d& t1_t1,
     const Eigen::Vector3d& t2_t1,
     double& toi,
+    const double min_distance = 0.0,
     const double tmax = 1.0,
     const double tolerance = DEFAULT_CCD_TOLERANCE,
     const long max_iterations = DEFAULT_CCD_MAX_ITERATIONS,
@@ -78,6 +130,7 @@ bool edge_edge_ccd(
     const Eigen::Vector3d& eb0_t1,
     const Eigen::Vector3d& eb1_t1,
     double& toi,
+    const double min_distance = 0.0,
     const double tmax = 1.0,
     const double tolerance = DEFAULT_CCD_TOLERANCE,
     const long max_iterations = DEFAULT_CCD_MAX_ITERATIONS,
@@ -93,6 +146,7 @@ bool point_edge_ccd(
     const VectorMax3d& e0_t1,
     const VectorMax3d& e1_t1,
     double& toi,
+    const double min_distance = 0.0,
     const double tmax = 1.0,
     const double tolerance = DEFAULT_CCD_TOLERANCE,
     const long max_iterations = DEFAULT_CCD_MAX_ITERATIONS,
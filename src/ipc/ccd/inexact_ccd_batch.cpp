@@ -0,0 +1,291 @@
+#include "inexact_ccd_batch.hpp"
+
+#include <ipc/ccd/inexact_point_edge.hpp>
+#include <ipc/distance/distance_type.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace ipc {
+
+namespace {
+
+    /// @brief Find the real roots of a₃t³ + a₂t² + a₁t + a₀ in (0, t_end].
+    ///
+    /// The roots are isolated on the monotonic intervals between the
+    /// derivative's roots and polished by bisection, so no root inside the
+    /// interval is skipped. Returns the number of roots written to roots
+    /// (ascending, at most three).
+    int cubic_roots_in_interval(
+        const double a3,
+        const double a2,
+        const double a1,
+        const double a0,
+        const double t_end,
+        double roots[3])
+    {
+        const auto f = [&](const double t) {
+            return ((a3 * t + a2) * t + a1) * t + a0;
+        };
+
+        // Breakpoints: the interval ends plus the critical points inside.
+        double ts[4] = { 0, t_end, 0, 0 };
+        int num_ts = 2;
+        if (a3 != 0) {
+            // 3a₃t² + 2a₂t + a₁ = 0 (stable quadratic formula)
+            const double delta = 4 * a2 * a2 - 12 * a3 * a1;
+            if (delta > 0) {
+                const double q = a2 >= 0 ? (-2 * a2 - std::sqrt(delta)) / 2
+                                         : (-2 * a2 + std::sqrt(delta)) / 2;
+                const double crits[2] = { q / (3 * a3), a1 / q };
+                for (const double crit : crits) {
+                    if (crit > 0 && crit < t_end) {
+                        ts[num_ts++] = crit;
+                    }
+                }
+            }
+        } else if (a2 != 0) {
+            const double crit = -a1 / (2 * a2);
+            if (crit > 0 && crit < t_end) {
+                ts[num_ts++] = crit;
+            }
+        }
+        std::sort(ts, ts + num_ts);
+
+        int num_roots = 0;
+        for (int i = 0; i + 1 < num_ts; i++) {
+            double lo = ts[i], hi = ts[i + 1];
+            double f_lo = f(lo), f_hi = f(hi);
+            if (f_hi == 0) {
+                roots[num_roots++] = hi;
+                continue;
+            }
+            if ((f_lo < 0) == (f_hi < 0)) {
+                continue; // monotonic with no sign change ⟹ no root
+            }
+            for (int iter = 0; iter < 64; iter++) {
+                const double mid = 0.5 * (lo + hi);
+                const double f_mid = f(mid);
+                if (f_mid == 0 || mid == lo || mid == hi) {
+                    lo = hi = mid;
+                    break;
+                }
+                if ((f_mid < 0) == (f_lo < 0)) {
+                    lo = mid;
+                    f_lo = f_mid;
+                } else {
+                    hi = mid;
+                }
+            }
+            roots[num_roots++] = 0.5 * (lo + hi);
+        }
+        // The breakpoints are sorted and each interval holds one root, so
+        // the roots come out ascending; t=0 roots are excluded because the
+        // first interval only reports a root strictly past its left end.
+        return num_roots;
+    }
+
+    /// @brief Is the point inside the triangle at time t (barycentric test)?
+    bool point_inside_triangle_at(
+        const double t,
+        const Eigen::Vector3d& q0,
+        const Eigen::Vector3d& qd,
+        const Eigen::Vector3d& u0,
+        const Eigen::Vector3d& ud,
+        const Eigen::Vector3d& v0,
+        const Eigen::Vector3d& vd)
+    {
+        const Eigen::Vector3d q = q0 + t * qd;
+        const Eigen::Vector3d u = u0 + t * ud;
+        const Eigen::Vector3d v = v0 + t * vd;
+
+        const double d00 = u.dot(u), d01 = u.dot(v), d11 = v.dot(v);
+        const double d20 = q.dot(u), d21 = q.dot(v);
+        const double denom = d00 * d11 - d01 * d01;
+        if (denom <= 0) {
+            return false; // degenerate triangle
+        }
+        const double beta = (d11 * d20 - d01 * d21) / denom;
+        const double gamma = (d00 * d21 - d01 * d20) / denom;
+        return beta >= 0 && gamma >= 0 && beta + gamma <= 1;
+    }
+
+} // namespace
+
+void inexact_point_edge_ccd_2D_batch(
+    const Eigen::MatrixXd& P_t0,
+    const Eigen::MatrixXd& E0_t0,
+    const Eigen::MatrixXd& E1_t0,
+    const Eigen::MatrixXd& P_t1,
+    const Eigen::MatrixXd& E0_t1,
+    const Eigen::MatrixXd& E1_t1,
+    Eigen::ArrayXd& toi,
+    const double conservative_rescaling)
+{
+    const Eigen::Index n = P_t0.rows();
+    assert(P_t0.cols() == 2);
+    assert(E0_t0.rows() == n && E1_t0.rows() == n);
+    assert(P_t1.rows() == n && E0_t1.rows() == n && E1_t1.rows() == n);
+
+    toi.setConstant(n, std::numeric_limits<double>::infinity());
+    if (n == 0) {
+        return;
+    }
+
+    const auto px = P_t0.col(0).array(), py = P_t0.col(1).array();
+    const auto e0x = E0_t0.col(0).array(), e0y = E0_t0.col(1).array();
+    const auto e1x = E1_t0.col(0).array(), e1y = E1_t0.col(1).array();
+
+    const Eigen::ArrayXd d0x = P_t1.col(0).array() - px;
+    const Eigen::ArrayXd d0y = P_t1.col(1).array() - py;
+    const Eigen::ArrayXd d1x = E0_t1.col(0).array() - e0x;
+    const Eigen::ArrayXd d1y = E0_t1.col(1).array() - e0y;
+    const Eigen::ArrayXd d2x = E1_t1.col(0).array() - e1x;
+    const Eigen::ArrayXd d2y = E1_t1.col(1).array() - e1y;
+
+    // Colinearity quadratic at² + bt + c = 0 (same expressions as the
+    // scalar kernel, evaluated across the whole batch).
+    const Eigen::ArrayXd a =
+        d0x * (d2y - d1y) + d0y * (d1x - d2x) + d2x * d1y - d2y * d1x;
+    const Eigen::ArrayXd b = px * (d2y - d1y) + d0x * (e1y - e0y)
+        + d0y * (e0x - e1x) + py * (d1x - d2x) + d1y * e1x + d2x * e0y
+        - d1x * e1y - d2y * e0x;
+    const Eigen::ArrayXd c =
+        px * (e1y - e0y) + py * (e0x - e1x) + e1x * e0y - e1y * e0x;
+
+    // Stable quadratic formula across the batch: q = -(b + sign(b)√Δ)/2,
+    // roots q/a and c/q. Negative-Δ and degenerate (a=0) lanes produce NaN
+    // or out-of-range values here and are filtered below.
+    const Eigen::ArrayXd delta = b * b - 4 * a * c;
+    const Eigen::ArrayXd q =
+        -0.5 * (b + (b < 0).select(-delta.max(0).sqrt(), delta.max(0).sqrt()));
+    const Eigen::ArrayXd r0 = (q / a).min(c / q);
+    const Eigen::ArrayXd r1 = (q / a).max(c / q);
+
+    for (Eigen::Index i = 0; i < n; i++) {
+        if (a[i] == 0) {
+            // Parallel motion: reuse the scalar kernel's special cases.
+            double toi_i;
+            if (inexact_point_edge_ccd_2D(
+                    P_t0.row(i).transpose(), E0_t0.row(i).transpose(),
+                    E1_t0.row(i).transpose(), P_t1.row(i).transpose(),
+                    E0_t1.row(i).transpose(), E1_t1.row(i).transpose(), toi_i,
+                    conservative_rescaling)) {
+                toi[i] = toi_i;
+            }
+            continue;
+        }
+        if (delta[i] < 0) {
+            continue; // no real crossing time
+        }
+
+        const double roots[2] = { delta[i] == 0 ? -b[i] / (2 * a[i]) : r0[i],
+                                  delta[i] == 0 ? -b[i] / (2 * a[i]) : r1[i] };
+        for (const double root : roots) {
+            if (!(root > 0 && root <= 1)) {
+                continue;
+            }
+            // Check the point actually crosses the edge's interior.
+            if (point_edge_distance_type(
+                    Eigen::Vector2d(px[i] + root * d0x[i], py[i] + root * d0y[i]),
+                    Eigen::Vector2d(e0x[i] + root * d1x[i], e0y[i] + root * d1y[i]),
+                    Eigen::Vector2d(e1x[i] + root * d2x[i], e1y[i] + root * d2y[i]))
+                == PointEdgeDistanceType::P_E) {
+                toi[i] = root * conservative_rescaling;
+                break;
+            }
+        }
+    }
+}
+
+void inexact_point_triangle_ccd_batch(
+    const Eigen::MatrixXd& P_t0,
+    const Eigen::MatrixXd& T0_t0,
+    const Eigen::MatrixXd& T1_t0,
+    const Eigen::MatrixXd& T2_t0,
+    const Eigen::MatrixXd& P_t1,
+    const Eigen::MatrixXd& T0_t1,
+    const Eigen::MatrixXd& T1_t1,
+    const Eigen::MatrixXd& T2_t1,
+    Eigen::ArrayXd& toi,
+    const double conservative_rescaling,
+    const double tmax)
+{
+    const Eigen::Index n = P_t0.rows();
+    assert(P_t0.cols() == 3);
+    assert(T0_t0.rows() == n && T1_t0.rows() == n && T2_t0.rows() == n);
+    assert(P_t1.rows() == n && T0_t1.rows() == n && T1_t1.rows() == n);
+    assert(T2_t1.rows() == n);
+
+    toi.setConstant(n, std::numeric_limits<double>::infinity());
+    if (n == 0) {
+        return;
+    }
+
+    // Edge and point-offset vectors at t=0 and their displacements, one
+    // array per component: u(t) = u0 + t·ud, v(t) = v0 + t·vd,
+    // q(t) = q0 + t·qd with u = t1 - t0, v = t2 - t0, and q = p - t0.
+    Eigen::ArrayXd u0[3], ud[3], v0[3], vd[3], q0[3], qd[3];
+    for (int k = 0; k < 3; k++) {
+        u0[k] = T1_t0.col(k).array() - T0_t0.col(k).array();
+        v0[k] = T2_t0.col(k).array() - T0_t0.col(k).array();
+        q0[k] = P_t0.col(k).array() - T0_t0.col(k).array();
+        ud[k] = T1_t1.col(k).array() - T0_t1.col(k).array() - u0[k];
+        vd[k] = T2_t1.col(k).array() - T0_t1.col(k).array() - v0[k];
+        qd[k] = P_t1.col(k).array() - T0_t1.col(k).array() - q0[k];
+    }
+
+    // Coplanarity cubic q(t)·(u(t)×v(t)) = a₃t³ + a₂t² + a₁t + a₀ with
+    // u×v expanded as c0 + t·c1 + t²·c2.
+    Eigen::ArrayXd c0[3], c1[3], c2[3];
+    for (int k = 0; k < 3; k++) {
+        const int j = (k + 1) % 3, l = (k + 2) % 3;
+        c0[k] = u0[j] * v0[l] - u0[l] * v0[j];
+        c1[k] = u0[j] * vd[l] - u0[l] * vd[j] + ud[j] * v0[l] - ud[l] * v0[j];
+        c2[k] = ud[j] * vd[l] - ud[l] * vd[j];
+    }
+
+    Eigen::ArrayXd a0 = Eigen::ArrayXd::Zero(n), a1 = a0, a2 = a0, a3 = a0;
+    for (int k = 0; k < 3; k++) {
+        a0 += q0[k] * c0[k];
+        a1 += q0[k] * c1[k] + qd[k] * c0[k];
+        a2 += q0[k] * c2[k] + qd[k] * c1[k];
+        a3 += qd[k] * c2[k];
+    }
+
+    // Conservative cull: over [0, tmax] the non-constant terms cannot move
+    // the cubic by more than this bound, so a larger |a₀| means no root.
+    const Eigen::ArrayXd excursion =
+        ((a3.abs() * tmax + a2.abs()) * tmax + a1.abs()) * tmax;
+    const auto may_have_root = a0.abs() <= excursion;
+
+    for (Eigen::Index i = 0; i < n; i++) {
+        if (!may_have_root[i]) {
+            continue;
+        }
+        if (a3[i] == 0 && a2[i] == 0 && a1[i] == 0 && a0[i] == 0) {
+            continue; // coplanar motion throughout; see the header note
+        }
+
+        double roots[3];
+        const int num_roots = cubic_roots_in_interval(
+            a3[i], a2[i], a1[i], a0[i], tmax, roots);
+
+        for (int r = 0; r < num_roots; r++) {
+            if (point_inside_triangle_at(
+                    roots[r],
+                    Eigen::Vector3d(q0[0][i], q0[1][i], q0[2][i]),
+                    Eigen::Vector3d(qd[0][i], qd[1][i], qd[2][i]),
+                    Eigen::Vector3d(u0[0][i], u0[1][i], u0[2][i]),
+                    Eigen::Vector3d(ud[0][i], ud[1][i], ud[2][i]),
+                    Eigen::Vector3d(v0[0][i], v0[1][i], v0[2][i]),
+                    Eigen::Vector3d(vd[0][i], vd[1][i], vd[2][i]))) {
+                toi[i] = roots[r] * conservative_rescaling;
+                break;
+            }
+        }
+    }
+}
+
+} // namespace ipc
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <ipc/ccd/ccd.hpp>
+
+#include <Eigen/Core>
+
+namespace ipc {
+
+/// @brief Batched inexact 2D point-edge CCD.
+///
+/// The batch counterpart of inexact_point_edge_ccd_2D: the quadratic
+/// crossing-time coefficients and the stable root formulas are evaluated
+/// over whole columns, so Eigen emits SIMD arithmetic across the queries
+/// instead of the per-query branchy scalar solve; only the cheap overlap
+/// verification of candidate roots (rare after the solve) and the
+/// degenerate parallel-motion lanes run per query. The candidates are in
+/// structure-of-arrays form like the batched distance kernels: row i of
+/// every argument holds the corresponding vertex of query i.
+/// @param[in] P_t0 The points at t=0 (one per row).
+/// @param[in] E0_t0 The first edge vertices at t=0 (one per row).
+/// @param[in] E1_t0 The second edge vertices at t=0 (one per row).
+/// @param[in] P_t1 The points at t=1 (one per row).
+/// @param[in] E0_t1 The first edge vertices at t=1 (one per row).
+/// @param[in] E1_t1 The second edge vertices at t=1 (one per row).
+/// @param[out] toi The conservatively rescaled time of impact of each
+/// query (infinity for queries without an impact).
+/// @param[in] conservative_rescaling Scale the times of impact to avoid
+/// stepping exactly to impact.
+void inexact_point_edge_ccd_2D_batch(
+    const Eigen::MatrixXd& P_t0,
+    const Eigen::MatrixXd& E0_t0,
+    const Eigen::MatrixXd& E1_t0,
+    const Eigen::MatrixXd& P_t1,
+    const Eigen::MatrixXd& E0_t1,
+    const Eigen::MatrixXd& E1_t1,
+    Eigen::ArrayXd& toi,
+    const double conservative_rescaling = DEFAULT_CCD_CONSERVATIVE_RESCALING);
+
+/// @brief Batched inexact point-triangle CCD (preview quality).
+///
+/// Solves the coplanarity cubic of each query: with positions linear in t,
+/// the signed volume of the point-triangle tetrahedron is cubic in t and
+/// vanishes at every crossing. The cubic's coefficients and a conservative
+/// no-root cull (|a0| larger than the largest possible excursion of the
+/// remaining terms over [0, tmax]) are evaluated over whole columns, which
+/// eliminates the distant majority of the batch with SIMD arithmetic; only
+/// the surviving queries isolate their roots on the monotonic intervals
+/// between the cubic's critical points and verify that the point crosses
+/// inside the triangle.
+///
+/// Like the scalar inexact fallback this trades certification for speed:
+/// coplanar sliding motion (an identically zero cubic) and grazing
+/// tangential contacts can be missed, and no minimum separation is
+/// supported. Use the certified CCD for production line searches.
+/// @param[in] P_t0 The points at t=0 (one per row).
+/// @param[in] T0_t0 The first triangle vertices at t=0 (one per row).
+/// @param[in] T1_t0 The second triangle vertices at t=0 (one per row).
+/// @param[in] T2_t0 The third triangle vertices at t=0 (one per row).
+/// @param[in] P_t1 The points at t=1 (one per row).
+/// @param[in] T0_t1 The first triangle vertices at t=1 (one per row).
+/// @param[in] T1_t1 The second triangle vertices at t=1 (one per row).
+/// @param[in] T2_t1 The third triangle vertices at t=1 (one per row).
+/// @param[out] toi The conservatively rescaled time of impact of each
+/// query (infinity for queries without an impact).
+/// @param[in] conservative_rescaling Scale the times of impact to avoid
+/// stepping exactly to impact.
+/// @param[in] tmax The maximum time to check.
+void inexact_point_triangle_ccd_batch(
+    const Eigen::MatrixXd& P_t0,
+    const Eigen::MatrixXd& T0_t0,
+    const Eigen::MatrixXd& T1_t0,
+    const Eigen::MatrixXd& T2_t0,
+    const Eigen::MatrixXd& P_t1,
+    const Eigen::MatrixXd& T0_t1,
+    const Eigen::MatrixXd& T1_t1,
+    const Eigen::MatrixXd& T2_t1,
+    Eigen::ArrayXd& toi,
+    const double conservative_rescaling = DEFAULT_CCD_CONSERVATIVE_RESCALING,
+    const double tmax = 1.0);
+
+} // namespace ipc
@@ -1,8 +1,11 @@
 #include "point_static_plane.hpp"
 
 #include <ipc/distance/point_plane.hpp>
+#include <ipc/utils/logger.hpp>
 
 #include <array>
+#include <cmath>
+#include <limits>
 
 namespace ipc {
 
@@ -27,7 +30,7 @@ bool point_static_plane_ccd(
         sqrt(point_plane_distance(p_t0, plane_origin, plane_normal));
 
     if (initial_distance == 0) {
-        logger().warn("Initial point-plane distance is 0, returning toi=0!");
+        IPC_LOG_WARN("Initial point-plane distance is 0, returning toi=0!");
         toi = 0;
         return true;
     }
@@ -59,7 +62,7 @@ bool point_static_plane_ccd(
         if (is_impacting) {
             toi *= conservative_rescaling;
             if (toi == 0) {
-                logger().warn(
+                IPC_LOG_WARN(
                     "Point-static plane CCD is overly conservative (toi={:g} "
                     "and trajectory_length={:g}, but initial_distance={:g})!",
                     toi, (p_t1 - p_t0).norm(), initial_distance);
@@ -70,4 +73,86 @@ bool point_static_plane_ccd(
     return is_impacting;
 }
 
+bool point_static_plane_ccd(
+    ConstMatrixXdRef P_t0,
+    ConstMatrixXdRef P_t1,
+    const VectorMax3d& plane_origin,
+    const VectorMax3d& plane_normal,
+    double& earliest_toi,
+    const double conservative_rescaling)
+{
+    static constexpr double SMALL_TOI = 1e-6;
+
+    assert(P_t1.rows() == P_t0.rows());
+    assert(P_t1.cols() == P_t0.cols());
+    assert(plane_origin.size() == P_t0.cols());
+    assert(plane_normal.size() == P_t0.cols());
+
+    // Signed plane offsets of every starting point: s = (p₀ - o)·n, so the
+    // initial distance is |s|/‖n‖ and d·‖n‖ = (1 - c)·|s| for the
+    // conservatively rescaled minimum distance d. Both tois per point are
+    // then (-s ± (1 - c)·|s|) / n·(p₁ - p₀), i.e. two matrix-vector
+    // products and componentwise divisions over the whole batch.
+    const Eigen::ArrayXd s = (P_t0 * plane_normal).array()
+        - plane_normal.dot(plane_origin);
+    const Eigen::ArrayXd den = ((P_t1 - P_t0) * plane_normal).array();
+    const Eigen::ArrayXd m = (1.0 - conservative_rescaling) * s.abs();
+    const Eigen::ArrayXd tois0 = (-s + m) / den;
+    const Eigen::ArrayXd tois1 = (-s - m) / den;
+
+    bool any_impacting = false;
+    double batch_toi = std::numeric_limits<double>::infinity();
+
+    for (long i = 0; i < s.size(); i++) {
+        if (s[i] == 0) {
+            IPC_LOG_WARN(
+                "Initial point-plane distance is 0, returning toi=0!");
+            earliest_toi = 0;
+            return true;
+        }
+
+        bool is_impacting = is_in_01(tois0[i]) || is_in_01(tois1[i]);
+        if (!is_impacting) {
+            continue;
+        }
+
+        double toi;
+        if (is_in_01(tois0[i]) && is_in_01(tois1[i])) {
+            toi = std::min(tois0[i], tois1[i]);
+        } else if (is_in_01(tois0[i])) {
+            toi = tois0[i];
+        } else {
+            toi = tois1[i];
+        }
+
+        if (toi < SMALL_TOI) {
+            // Rare: fall back to the exact root scaled conservatively,
+            // matching the per-point overload (including its warning).
+            toi = -s[i] / den[i];
+            is_impacting = is_in_01(toi);
+            if (is_impacting) {
+                toi *= conservative_rescaling;
+                if (toi == 0) {
+                    IPC_LOG_WARN(
+                        "Point-static plane CCD is overly conservative "
+                        "(toi={:g} and trajectory_length={:g}, but "
+                        "initial_distance={:g})!",
+                        toi, (P_t1.row(i) - P_t0.row(i)).norm(),
+                        std::abs(s[i]) / plane_normal.norm());
+                }
+            }
+        }
+
+        if (is_impacting) {
+            any_impacting = true;
+            batch_toi = std::min(batch_toi, toi);
+        }
+    }
+
+    if (any_impacting) {
+        earliest_toi = batch_toi;
+    }
+    return any_impacting;
+}
+
 } // namespace ipc
@@ -12,4 +12,28 @@ bool point_static_plane_ccd(
     double& toi,
     const double conservative_rescaling = DEFAULT_CCD_CONSERVATIVE_RESCALING);
 
+/// @brief Batched point-static plane CCD: N trajectories against one plane.
+///
+/// The closed-form root solve of the per-point overload reduces to array
+/// expressions over the whole batch (two matrix-vector products and
+/// componentwise divisions), so Eigen vectorizes it; only the rare points
+/// whose conservative time of impact falls below the small-toi threshold are
+/// re-solved with the exact per-point fallback. The result matches running
+/// the per-point overload on every row and taking the earliest toi.
+/// @param[in] P_t0 The starting points as rows of a matrix.
+/// @param[in] P_t1 The ending points as rows of a matrix.
+/// @param[in] plane_origin The origin of the plane.
+/// @param[in] plane_normal The normal of the plane.
+/// @param[out] earliest_toi The earliest time of impact over the batch
+///                          (only written if a point is impacting).
+/// @param[in] conservative_rescaling Conservative rescaling of the toi.
+/// @return True if any point is impacting the plane.
+bool point_static_plane_ccd(
+    ConstMatrixXdRef P_t0,
+    ConstMatrixXdRef P_t1,
+    const VectorMax3d& plane_origin,
+    const VectorMax3d& plane_normal,
+    double& earliest_toi,
+    const double conservative_rescaling = DEFAULT_CCD_CONSERVATIVE_RESCALING);
+
 } // namespace ipc
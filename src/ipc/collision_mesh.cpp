@@ -6,6 +6,13 @@
 #include <ipc/utils/local_to_global.hpp>
 #include <ipc/utils/area_gradient.hpp>
 
+#include <igl/median.h>
+
+#include <tbb/parallel_for.h>
+#include <tbb/blocked_range.h>
+
+#include <algorithm> // std::sort/unique
+
 namespace ipc {
 
 CollisionMesh::CollisionMesh(
@@ -28,29 +35,32 @@ CollisionMesh::CollisionMesh(
     const Eigen::MatrixXi& faces,
     const Eigen::SparseMatrix<double>& displacement_map)
     : m_full_vertices_at_rest(full_vertices_at_rest)
-    , m_edges(edges)
-    , m_faces(faces)
 {
+    SharedTopology& topo = *m_topology;
+    topo.edges = edges;
+    topo.faces = faces;
+
     assert(include_vertex.size() == full_vertices_at_rest.rows());
     const bool include_all_vertices = std::all_of(
         include_vertex.begin(), include_vertex.end(), [](bool b) { return b; });
 
     if (include_all_vertices) {
         // set full ↔ reduced ≡ identity
-        m_full_vertex_to_vertex.setLinSpaced(
+        topo.full_vertex_to_vertex.setLinSpaced(
             full_vertices_at_rest.rows(), 0, full_vertices_at_rest.rows() - 1);
-        m_vertex_to_full_vertex = m_full_vertex_to_vertex;
+        topo.vertex_to_full_vertex = topo.full_vertex_to_vertex;
     } else {
-        m_full_vertex_to_vertex.setConstant(full_vertices_at_rest.rows(), -1);
+        topo.full_vertex_to_vertex.setConstant(
+            full_vertices_at_rest.rows(), -1);
         std::vector<int> dynamic_vertex_to_full_vertex;
         for (size_t i = 0; i < full_vertices_at_rest.rows(); i++) {
             if (include_vertex[i]) {
-                m_full_vertex_to_vertex[i] =
+                topo.full_vertex_to_vertex[i] =
                     dynamic_vertex_to_full_vertex.size();
                 dynamic_vertex_to_full_vertex.push_back(i);
             }
         }
-        m_vertex_to_full_vertex = Eigen::Map<Eigen::VectorXi>(
+        topo.vertex_to_full_vertex = Eigen::Map<Eigen::VectorXi>(
             dynamic_vertex_to_full_vertex.data(),
             dynamic_vertex_to_full_vertex.size());
     }
@@ -63,49 +73,83 @@ CollisionMesh::CollisionMesh(
     init_selection_matrices(dim);
 
     if (displacement_map.size() == 0) {
-        m_displacement_map = m_select_vertices;
-        m_displacement_dof_map = m_select_dof;
+        // The displacement maps default to the (shared) selection matrices.
+        // The selection of every vertex is the identity, so the map can be
+        // skipped entirely.
+        m_is_identity_dof_map = include_all_vertices;
     } else {
         assert(displacement_map.rows() == num_vertices());
         assert(displacement_map.cols() == full_num_vertices());
 
-        m_displacement_map = m_select_vertices * displacement_map;
+        m_displacement_map = topo.select_vertices * displacement_map;
         m_displacement_map.makeCompressed();
 
-        m_displacement_dof_map =
-            m_select_dof * vertex_matrix_to_dof_matrix(displacement_map, dim);
+        m_displacement_dof_map = topo.select_dof
+            * vertex_matrix_to_dof_matrix(displacement_map, dim);
         m_displacement_dof_map.makeCompressed();
     }
 
     ///////////////////////////////////////////////////////////////////////////
 
     // Set vertices at rest using full → reduced map
-    m_vertices_at_rest = m_select_vertices * full_vertices_at_rest;
+    m_vertices_at_rest = topo.select_vertices * full_vertices_at_rest;
     // m_vertices_at_rest = vertices(full_vertices_at_rest);
 
-    // Map faces and edges to only included vertices
+    // Map faces and edges to only included vertices (each row is
+    // independent, so remap in parallel)
     if (!include_all_vertices) {
-        for (int i = 0; i < m_edges.rows(); i++) {
-            for (int j = 0; j < m_edges.cols(); j++) {
-                long new_id = m_full_vertex_to_vertex[m_edges(i, j)];
-                assert(new_id >= 0 && new_id < num_vertices());
-                m_edges(i, j) = new_id;
-            }
-        }
-
-        for (int i = 0; i < m_faces.rows(); i++) {
-            for (int j = 0; j < m_faces.cols(); j++) {
-                long new_id = m_full_vertex_to_vertex[m_faces(i, j)];
-                assert(new_id >= 0 && new_id < num_vertices());
-                m_faces(i, j) = new_id;
-            }
-        }
+        tbb::parallel_for(
+            tbb::blocked_range<long>(0, topo.edges.rows()),
+            [&](const tbb::blocked_range<long>& r) {
+                for (long i = r.begin(); i < r.end(); i++) {
+                    for (int j = 0; j < topo.edges.cols(); j++) {
+                        long new_id =
+                            topo.full_vertex_to_vertex[topo.edges(i, j)];
+                        assert(new_id >= 0 && new_id < num_vertices());
+                        topo.edges(i, j) = new_id;
+                    }
+                }
+            });
+
+        tbb::parallel_for(
+            tbb::blocked_range<long>(0, topo.faces.rows()),
+            [&](const tbb::blocked_range<long>& r) {
+                for (long i = r.begin(); i < r.end(); i++) {
+                    for (int j = 0; j < topo.faces.cols(); j++) {
+                        long new_id =
+                            topo.full_vertex_to_vertex[topo.faces(i, j)];
+                        assert(new_id >= 0 && new_id < num_vertices());
+                        topo.faces(i, j) = new_id;
+                    }
+                }
+            });
     } // else no need to change the edges and faces
 
-    m_faces_to_edges = construct_faces_to_edges(m_faces, m_edges);
+    topo.faces_to_edges = construct_faces_to_edges(topo.faces, topo.edges);
 
     init_adjacencies();
     init_areas();
+    init_edge_sqr_lengths();
+}
+
+CollisionMesh::CollisionMesh(
+    const CollisionMesh& prototype,
+    const Eigen::MatrixXd& full_vertices_at_rest)
+    : m_topology(prototype.m_topology)
+    , m_full_vertices_at_rest(full_vertices_at_rest)
+    , m_is_identity_dof_map(prototype.m_is_identity_dof_map)
+    , m_displacement_map(prototype.m_displacement_map)
+    , m_displacement_dof_map(prototype.m_displacement_dof_map)
+{
+    assert(full_vertices_at_rest.rows() == prototype.full_num_vertices());
+    assert(full_vertices_at_rest.cols() == prototype.dim());
+
+    m_vertices_at_rest = m_topology->select_vertices * full_vertices_at_rest;
+
+    init_areas();
+    init_edge_sqr_lengths();
+
+    can_collide = prototype.can_collide;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -114,15 +158,16 @@ void CollisionMesh::init_selection_matrices(const int dim)
 {
     std::vector<Eigen::Triplet<double>> triplets;
     triplets.reserve(num_vertices());
+    SharedTopology& topo = *m_topology;
     for (int vi = 0; vi < num_vertices(); vi++) {
-        triplets.emplace_back(vi, m_vertex_to_full_vertex[vi], 1.0);
+        triplets.emplace_back(vi, topo.vertex_to_full_vertex[vi], 1.0);
     }
 
-    m_select_vertices.resize(num_vertices(), full_num_vertices());
-    m_select_vertices.setFromTriplets(triplets.begin(), triplets.end());
-    m_select_vertices.makeCompressed();
+    topo.select_vertices.resize(num_vertices(), full_num_vertices());
+    topo.select_vertices.setFromTriplets(triplets.begin(), triplets.end());
+    topo.select_vertices.makeCompressed();
 
-    m_select_dof = vertex_matrix_to_dof_matrix(m_select_vertices, dim);
+    topo.select_dof = vertex_matrix_to_dof_matrix(topo.select_vertices, dim);
 }
 
 Eigen::SparseMatrix<double> CollisionMesh::vertex_matrix_to_dof_matrix(
@@ -149,159 +194,416 @@ Eigen::SparseMatrix<double> CollisionMesh::vertex_matrix_to_dof_matrix(
 
 void CollisionMesh::init_adjacencies()
 {
-    m_vertex_vertex_adjacencies.resize(num_vertices());
+    SharedTopology& topo = *m_topology;
+
+    topo.vertex_vertex_adjacencies.resize(num_vertices());
     // Edges includes the edges of the faces
-    for (int i = 0; i < m_edges.rows(); i++) {
-        m_vertex_vertex_adjacencies[m_edges(i, 0)].insert(m_edges(i, 1));
-        m_vertex_vertex_adjacencies[m_edges(i, 1)].insert(m_edges(i, 0));
+    for (int i = 0; i < topo.edges.rows(); i++) {
+        topo.vertex_vertex_adjacencies[topo.edges(i, 0)].insert(
+            topo.edges(i, 1));
+        topo.vertex_vertex_adjacencies[topo.edges(i, 1)].insert(
+            topo.edges(i, 0));
     }
 
-    m_edge_vertex_adjacencies.resize(m_edges.rows());
-    for (int i = 0; i < m_faces.rows(); i++) {
+    topo.edge_vertex_adjacencies.resize(topo.edges.rows());
+    for (int i = 0; i < topo.faces.rows(); i++) {
         for (int j = 0; j < 3; ++j) {
-            m_edge_vertex_adjacencies[m_faces_to_edges(i, j)].insert(
-                m_faces(i, (j + 2) % 3));
+            topo.edge_vertex_adjacencies[topo.faces_to_edges(i, j)].insert(
+                topo.faces(i, (j + 2) % 3));
         }
     }
 
-    // Is the vertex on the boundary of the triangle mesh in 3D or polyline in
-    // 2D
-    m_is_vertex_on_boundary.resize(num_vertices(), true);
-    if (dim() == 2) {
-        for (int i = 0; i < num_vertices(); i++) {
-            m_is_vertex_on_boundary[i] =
-                m_vertex_vertex_adjacencies[i].size() <= 1;
+    // Build the vertex to edge and vertex to face incidence in compressed
+    // (CSR) form: count the incident elements, prefix sum into offsets, then
+    // fill the adjacency array.
+    const auto build_csr_adjacency = [&](const Eigen::MatrixXi& elements,
+                                         Eigen::VectorXi& offsets,
+                                         Eigen::VectorXi& adjacency) {
+        offsets.setZero(num_vertices() + 1);
+        for (int i = 0; i < elements.rows(); i++) {
+            for (int j = 0; j < elements.cols(); j++) {
+                offsets[elements(i, j) + 1]++;
+            }
         }
-    } else {
-        for (int i = 0; i < m_edges.rows(); i++) {
-            // If edge is part of two triangles
-            if (m_edge_vertex_adjacencies[i].size() >= 2) {
-                for (int j = 0; j < 2; j++) {
-                    m_is_vertex_on_boundary[m_edges(i, j)] = false;
-                }
+        for (int vi = 0; vi < num_vertices(); vi++) {
+            offsets[vi + 1] += offsets[vi];
+        }
+
+        adjacency.resize(elements.rows() * elements.cols());
+        Eigen::VectorXi next_slot = offsets.head(num_vertices());
+        for (int i = 0; i < elements.rows(); i++) {
+            for (int j = 0; j < elements.cols(); j++) {
+                adjacency[next_slot[elements(i, j)]++] = i;
             }
         }
-    }
+    };
+    build_csr_adjacency(
+        topo.edges, topo.vertex_edge_adjacency_offsets,
+        topo.vertex_edge_adjacency);
+    build_csr_adjacency(
+        topo.faces, topo.vertex_face_adjacency_offsets,
+        topo.vertex_face_adjacency);
+
+    // Is the vertex on the boundary of the triangle mesh in 3D or polyline in
+    // 2D? Determined per vertex (gathering over the incident edges in 3D) so
+    // the loop parallelizes without write conflicts.
+    // (std::vector<bool> packs bits, so gather into bytes in parallel and
+    // assign serially.)
+    std::vector<char> on_boundary(num_vertices(), true);
+    tbb::parallel_for(
+        tbb::blocked_range<long>(0, long(num_vertices())),
+        [&](const tbb::blocked_range<long>& r) {
+            for (long vi = r.begin(); vi < r.end(); vi++) {
+                if (dim() == 2) {
+                    on_boundary[vi] =
+                        topo.vertex_vertex_adjacencies[vi].size() <= 1;
+                } else {
+                    // Interior vertices touch an edge shared by two triangles
+                    for (const long ei : vertex_edge_adjacencies(vi)) {
+                        if (topo.edge_vertex_adjacencies[ei].size() >= 2) {
+                            on_boundary[vi] = false;
+                            break;
+                        }
+                    }
+                }
+            }
+        });
+    topo.is_vertex_on_boundary.assign(on_boundary.begin(), on_boundary.end());
 }
 
 void CollisionMesh::init_areas()
 {
-    // m_vertices_to_edges.resize(num_vertices());
-    // for (int i = 0; i < m_edges.rows(); i++) {
-    //     for (int j = 0; j < m_edges.cols(); j++) {
-    //         m_vertices_to_edges[m_edges(i, j)].push_back(i);
-    //     }
-    // }
-    //
-    // m_vertices_to_faces.resize(num_vertices());
-    // for (int i = 0; i < m_faces.rows(); i++) {
-    //     for (int j = 0; j < m_faces.cols(); j++) {
-    //         m_vertices_to_faces[m_faces(i, j)].push_back(i);
-    //     }
-    // }
-
-    // Compute vertex areas as the sum of ½ the length of connected edges
-    Eigen::VectorXd vertex_edge_areas =
-        Eigen::VectorXd::Constant(num_vertices(), -1);
-    m_vertex_area_jacobian.resize(
-        num_vertices(), Eigen::SparseVector<double>(ndof()));
-    for (int i = 0; i < m_edges.rows(); i++) {
-        const auto& e0 = m_vertices_at_rest.row(m_edges(i, 0));
-        const auto& e1 = m_vertices_at_rest.row(m_edges(i, 1));
-        double edge_len = (e1 - e0).norm();
+    const Eigen::MatrixXi& E = m_topology->edges;
+    const Eigen::MatrixXi& F = m_topology->faces;
+    const Eigen::MatrixXi& F2E = m_topology->faces_to_edges;
+
+    // The area jacobians are only consumed by shape-derivative builds, so
+    // they are computed on first use (see prepare_area_jacobians()) rather
+    // than here with the areas.
+    m_area_jacobians_computed = false;
+    m_vertex_area_jacobian.clear();
+    m_edge_area_jacobian.clear();
+
+    // Compute the length (area in 2D) of every edge in parallel; the
+    // per-vertex sums are gathered below.
+    Eigen::VectorXd edge_lens(E.rows());
+    tbb::parallel_for(
+        tbb::blocked_range<long>(0, E.rows()),
+        [&](const tbb::blocked_range<long>& r) {
+            for (long i = r.begin(); i < r.end(); i++) {
+                const auto& e0 = m_vertices_at_rest.row(E(i, 0));
+                const auto& e1 = m_vertices_at_rest.row(E(i, 1));
+                edge_lens[i] = (e1 - e0).norm();
+            }
+        });
 
-        VectorMax6d edge_len_gradient;
-        edge_length_gradient(e0, e1, edge_len_gradient);
+    // Compute the area of every face in parallel.
+    Eigen::VectorXd face_areas(F.rows());
+    if (dim() == 3) {
+        tbb::parallel_for(
+            tbb::blocked_range<long>(0, F.rows()),
+            [&](const tbb::blocked_range<long>& r) {
+                for (long i = r.begin(); i < r.end(); i++) {
+                    const auto& f0 = m_vertices_at_rest.row(F(i, 0));
+                    const auto& f1 = m_vertices_at_rest.row(F(i, 1));
+                    const auto& f2 = m_vertices_at_rest.row(F(i, 2));
+                    face_areas[i] = cross(f1 - f0, f2 - f0).norm() / 2;
+                }
+            });
+    }
 
-        for (int j = 0; j < m_edges.cols(); j++) {
-            if (vertex_edge_areas[m_edges(i, j)] < 0) {
-                vertex_edge_areas[m_edges(i, j)] = 0;
+    // Sum the vertex areas by gathering over the incident elements, so every
+    // vertex is independent and the loop parallelizes without conflicts.
+    // Select the area based on the order face (⅓ sum of area of connected
+    // triangles), edge (½ sum of length of connected edges), codim (1).
+    m_vertex_areas.resize(num_vertices());
+    tbb::parallel_for(
+        tbb::blocked_range<long>(0, long(num_vertices())),
+        [&](const tbb::blocked_range<long>& r) {
+            for (long vi = r.begin(); vi < r.end(); vi++) {
+                const auto incident_faces = vertex_face_adjacencies(vi);
+                const auto incident_edges = vertex_edge_adjacencies(vi);
+
+                double area = 0;
+                if (dim() == 3 && incident_faces.size() > 0) {
+                    for (const long fi : incident_faces) {
+                        area += face_areas[fi] / 3;
+                    }
+                } else if (incident_edges.size() > 0) {
+                    for (const long ei : incident_edges) {
+                        area += edge_lens[ei] / 2;
+                    }
+                } else {
+                    area = 1; // codimensional vertex
+                }
+                m_vertex_areas[vi] = area;
             }
-            vertex_edge_areas[m_edges(i, j)] += edge_len / 2;
+        });
+
+    // Sum the edge areas the same way by inverting the faces-to-edges map
+    // into edge → face incidence (CSR).
+    m_edge_areas.resize(E.rows());
+    if (dim() == 3 && F.rows() > 0) {
+        Eigen::VectorXi offsets, edge_faces;
+        edge_face_incidence(offsets, edge_faces);
+
+        tbb::parallel_for(
+            tbb::blocked_range<long>(0, E.rows()),
+            [&](const tbb::blocked_range<long>& r) {
+                for (long ei = r.begin(); ei < r.end(); ei++) {
+                    double area = 0;
+                    for (int k = offsets[ei]; k < offsets[ei + 1]; k++) {
+                        area += face_areas[edge_faces[k]] / 3;
+                    }
+                    // codimensional edges have no incident faces
+                    m_edge_areas[ei] = offsets[ei + 1] > offsets[ei] ? area : 1;
+                }
+            });
+    } else {
+        m_edge_areas.setOnes(E.rows());
+    }
+}
+
+void CollisionMesh::edge_face_incidence(
+    Eigen::VectorXi& offsets, Eigen::VectorXi& edge_faces) const
+{
+    const Eigen::MatrixXi& E = m_topology->edges;
+    const Eigen::MatrixXi& F2E = m_topology->faces_to_edges;
 
-            local_gradient_to_global_gradient(
-                edge_len_gradient / 2, m_edges.row(i), dim(),
-                m_vertex_area_jacobian[m_edges(i, j)]);
+    offsets = Eigen::VectorXi::Zero(E.rows() + 1);
+    for (int i = 0; i < F2E.rows(); i++) {
+        for (int j = 0; j < F2E.cols(); j++) {
+            offsets[F2E(i, j) + 1]++;
         }
     }
+    for (int ei = 0; ei < E.rows(); ei++) {
+        offsets[ei + 1] += offsets[ei];
+    }
+
+    edge_faces.resize(F2E.size());
+    Eigen::VectorXi next_slot = offsets.head(E.rows());
+    for (int i = 0; i < F2E.rows(); i++) {
+        for (int j = 0; j < F2E.cols(); j++) {
+            edge_faces[next_slot[F2E(i, j)]++] = i;
+        }
+    }
+}
+
+void CollisionMesh::prepare_area_jacobians() const
+{
+    if (m_area_jacobians_computed) {
+        return;
+    }
+
+    const Eigen::MatrixXi& E = m_topology->edges;
+    const Eigen::MatrixXi& F = m_topology->faces;
+
+    // Recompute the per-element gradients; this mirrors init_areas() but
+    // runs only on the first shape-derivative query.
+    std::vector<VectorMax6d> edge_len_gradients(E.rows());
+    tbb::parallel_for(
+        tbb::blocked_range<long>(0, E.rows()),
+        [&](const tbb::blocked_range<long>& r) {
+            for (long i = r.begin(); i < r.end(); i++) {
+                edge_length_gradient(
+                    m_vertices_at_rest.row(E(i, 0)),
+                    m_vertices_at_rest.row(E(i, 1)), edge_len_gradients[i]);
+            }
+        });
 
-    // Compute vertex/edge areas as the sum of ⅓ the area of connected face
-    Eigen::VectorXd vertex_face_areas =
-        Eigen::VectorXd::Constant(num_vertices(), -1);
-    m_edge_areas.setConstant(m_edges.rows(), -1);
-    m_edge_area_jacobian.resize(
-        m_edges.rows(), Eigen::SparseVector<double>(ndof()));
+    std::vector<VectorMax9d> face_area_gradients(F.rows());
     if (dim() == 3) {
-        for (int i = 0; i < m_faces.rows(); i++) {
-            const auto& f0 = m_vertices_at_rest.row(m_faces(i, 0));
-            const auto& f1 = m_vertices_at_rest.row(m_faces(i, 1));
-            const auto& f2 = m_vertices_at_rest.row(m_faces(i, 2));
-            double face_area = cross(f1 - f0, f2 - f0).norm() / 2;
-
-            VectorMax9d face_area_gradient;
-            triangle_area_gradient(f0, f1, f2, face_area_gradient);
-
-            for (int j = 0; j < m_faces.cols(); ++j) {
-                if (vertex_face_areas[m_faces(i, j)] < 0) {
-                    vertex_face_areas[m_faces(i, j)] = 0;
-                    // remove the computed value from vertex_edge_areas
-                    m_vertex_area_jacobian[m_faces(i, j)].setZero();
+        tbb::parallel_for(
+            tbb::blocked_range<long>(0, F.rows()),
+            [&](const tbb::blocked_range<long>& r) {
+                for (long i = r.begin(); i < r.end(); i++) {
+                    triangle_area_gradient(
+                        m_vertices_at_rest.row(F(i, 0)),
+                        m_vertices_at_rest.row(F(i, 1)),
+                        m_vertices_at_rest.row(F(i, 2)),
+                        face_area_gradients[i]);
                 }
-                vertex_face_areas[m_faces(i, j)] += face_area / 3;
+            });
+    }
 
-                if (m_edge_areas[m_faces_to_edges(i, j)] < 0) {
-                    m_edge_areas[m_faces_to_edges(i, j)] = 0;
+    m_vertex_area_jacobian.assign(
+        num_vertices(), Eigen::SparseVector<double>(ndof()));
+    tbb::parallel_for(
+        tbb::blocked_range<long>(0, long(num_vertices())),
+        [&](const tbb::blocked_range<long>& r) {
+            for (long vi = r.begin(); vi < r.end(); vi++) {
+                const auto incident_faces = vertex_face_adjacencies(vi);
+                const auto incident_edges = vertex_edge_adjacencies(vi);
+
+                if (dim() == 3 && incident_faces.size() > 0) {
+                    for (const long fi : incident_faces) {
+                        local_gradient_to_global_gradient(
+                            face_area_gradients[fi] / 3, F.row(fi), dim(),
+                            m_vertex_area_jacobian[vi]);
+                    }
+                } else if (incident_edges.size() > 0) {
+                    for (const long ei : incident_edges) {
+                        local_gradient_to_global_gradient(
+                            edge_len_gradients[ei] / 2, E.row(ei), dim(),
+                            m_vertex_area_jacobian[vi]);
+                    }
                 }
-                m_edge_areas[m_faces_to_edges(i, j)] += face_area / 3;
-
-                // compute gradient of area
+            }
+        });
+
+    m_edge_area_jacobian.assign(
+        E.rows(), Eigen::SparseVector<double>(ndof()));
+    if (dim() == 3 && F.rows() > 0) {
+        Eigen::VectorXi offsets, edge_faces;
+        edge_face_incidence(offsets, edge_faces);
+
+        tbb::parallel_for(
+            tbb::blocked_range<long>(0, E.rows()),
+            [&](const tbb::blocked_range<long>& r) {
+                for (long ei = r.begin(); ei < r.end(); ei++) {
+                    for (int k = offsets[ei]; k < offsets[ei + 1]; k++) {
+                        const long fi = edge_faces[k];
+                        local_gradient_to_global_gradient(
+                            face_area_gradients[fi] / 3, F.row(fi), dim(),
+                            m_edge_area_jacobian[ei]);
+                    }
+                }
+            });
+    }
 
-                local_gradient_to_global_gradient(
-                    face_area_gradient / 3, m_faces.row(i), dim(),
-                    m_vertex_area_jacobian[m_faces(i, j)]);
+    m_area_jacobians_computed = true;
+}
 
-                local_gradient_to_global_gradient(
-                    face_area_gradient / 3, m_faces.row(i), dim(),
-                    m_edge_area_jacobian[m_faces_to_edges(i, j)]);
+void CollisionMesh::init_edge_sqr_lengths()
+{
+    const Eigen::MatrixXi& E = m_topology->edges;
+    m_rest_edge_sqr_lengths.resize(E.rows());
+    tbb::parallel_for(
+        tbb::blocked_range<long>(0, E.rows()),
+        [&](const tbb::blocked_range<long>& r) {
+            for (long i = r.begin(); i < r.end(); i++) {
+                m_rest_edge_sqr_lengths[i] = (m_vertices_at_rest.row(E(i, 0))
+                                              - m_vertices_at_rest.row(E(i, 1)))
+                                                 .squaredNorm();
             }
+        });
+}
+
+double CollisionMesh::rest_median_edge_length() const
+{
+    if (m_rest_median_edge_length < 0) {
+        if (m_rest_edge_sqr_lengths.size() == 0) {
+            m_rest_median_edge_length = 0;
+        } else {
+            // Take the median of the lengths (not of the squared lengths):
+            // igl::median averages the two middle elements for even counts,
+            // which does not commute with the square root.
+            double median = -1;
+            const bool success = igl::median(
+                m_rest_edge_sqr_lengths.cwiseSqrt(), median);
+            assert(success);
+            m_rest_median_edge_length = median;
         }
     }
-
-    // Select the area based on the order face, edge, codim
-    m_vertex_areas =
-        (vertex_face_areas.array() < 0)
-            .select(
-                (vertex_edge_areas.array() < 0).select(1, vertex_edge_areas),
-                vertex_face_areas);
-
-    // Select the area based on the order face, codim
-    m_edge_areas = (m_edge_areas.array() < 0).select(1, m_edge_areas);
+    return m_rest_median_edge_length;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 Eigen::MatrixXd
-CollisionMesh::vertices(const Eigen::MatrixXd& full_vertices) const
+CollisionMesh::vertices(ConstMatrixXdRef full_vertices) const
 {
     // full_U = full_V - full_V_rest
     assert(full_vertices.rows() == full_num_vertices());
     assert(full_vertices.cols() == dim());
+    if (m_is_identity_dof_map) {
+        return full_vertices;
+    }
     return displace_vertices(full_vertices - m_full_vertices_at_rest);
 }
 
 Eigen::MatrixXd CollisionMesh::displace_vertices(
-    const Eigen::MatrixXd& full_displacements) const
+    ConstMatrixXdRef full_displacements) const
 {
     // V_rest + S * T * full_U; m_displacement_map = S * T
     return m_vertices_at_rest + map_displacements(full_displacements);
 }
 
 Eigen::MatrixXd CollisionMesh::map_displacements(
-    const Eigen::MatrixXd& full_displacements) const
+    ConstMatrixXdRef full_displacements) const
 {
-    assert(m_displacement_map.cols() == full_displacements.rows());
+    assert(displacement_map().cols() == full_displacements.rows());
     assert(full_displacements.cols() == dim());
-    return m_displacement_map * full_displacements;
+    if (m_is_identity_dof_map) {
+        return full_displacements;
+    }
+    if (is_selection_dof_map()) {
+        // Pure selection: gather the included rows directly instead of
+        // multiplying by the selection matrix.
+        const Eigen::VectorXi& v2fv = m_topology->vertex_to_full_vertex;
+        Eigen::MatrixXd displacements(num_vertices(), dim());
+        for (long vi = 0; vi < displacements.rows(); vi++) {
+            displacements.row(vi) = full_displacements.row(v2fv[vi]);
+        }
+        return displacements;
+    }
+    return displacement_map() * full_displacements;
+}
+
+void CollisionMesh::update_vertices(
+    const Eigen::VectorXi& full_vertex_ids,
+    ConstMatrixXdRef new_positions,
+    Eigen::MatrixXd& full_vertices,
+    Eigen::MatrixXd& vertices,
+    std::vector<int>& changed_vertices) const
+{
+    assert(new_positions.rows() == full_vertex_ids.size());
+    assert(new_positions.cols() == dim());
+    assert(full_vertices.rows() == full_num_vertices());
+    assert(full_vertices.cols() == dim());
+    assert(vertices.rows() == num_vertices());
+
+    changed_vertices.clear();
+
+    // Local edits touch few vertices, so the loop is serial; the cost is
+    // O(edited vertices), not O(full mesh).
+    for (long k = 0; k < full_vertex_ids.size(); k++) {
+        const long fvi = full_vertex_ids[k];
+        assert(fvi >= 0 && fvi < full_num_vertices());
+
+        if (m_is_identity_dof_map) {
+            full_vertices.row(fvi) = new_positions.row(k);
+            vertices.row(fvi) = new_positions.row(k);
+            changed_vertices.push_back(fvi);
+        } else if (m_displacement_map.size() == 0) {
+            // Pure selection: a full vertex maps to at most one collision
+            // vertex, so its row is overwritten directly.
+            full_vertices.row(fvi) = new_positions.row(k);
+            const int vi = m_topology->full_vertex_to_vertex[fvi];
+            if (vi >= 0) {
+                vertices.row(vi) = new_positions.row(k);
+                changed_vertices.push_back(vi);
+            }
+        } else {
+            // General displacement map: a collision row mixes several full
+            // vertices, so the edit is applied as a delta through the
+            // column of the (column-major) map for this full vertex.
+            const VectorMax3d delta =
+                new_positions.row(k) - full_vertices.row(fvi);
+            full_vertices.row(fvi) = new_positions.row(k);
+            for (Eigen::SparseMatrix<double>::InnerIterator it(
+                     m_displacement_map, fvi);
+                 it; ++it) {
+                vertices.row(it.row()) += it.value() * delta.transpose();
+                changed_vertices.push_back(it.row());
+            }
+        }
+    }
+
+    std::sort(changed_vertices.begin(), changed_vertices.end());
+    changed_vertices.erase(
+        std::unique(changed_vertices.begin(), changed_vertices.end()),
+        changed_vertices.end());
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -310,7 +612,37 @@ Eigen::VectorXd CollisionMesh::to_full_dof(const Eigen::VectorXd& x) const
 {
     // ∇_{full} f(S * T * x_full) = Tᵀ * Sᵀ * ∇_{collision} f(S * T * x_full)
     // x = ∇_{collision} f(S * T * x_full); m_displacement_dof_map = S * T
-    return m_displacement_dof_map.transpose() * x;
+    if (m_is_identity_dof_map) {
+        return x;
+    }
+    if (is_selection_dof_map()) {
+        // Pure selection: scatter x into the included DOF slots; the
+        // excluded full DOFs receive no collision forces and stay zero.
+        const Eigen::VectorXi& v2fv = m_topology->vertex_to_full_vertex;
+        const int d = dim();
+        Eigen::VectorXd full_x = Eigen::VectorXd::Zero(full_ndof());
+        for (long vi = 0; vi < num_vertices(); vi++) {
+            full_x.segment(d * v2fv[vi], d) = x.segment(d * vi, d);
+        }
+        return full_x;
+    }
+    // Each full DOF is the dot product of a column of the map with x, so
+    // the products are computed in parallel over the columns.
+    const Eigen::SparseMatrix<double>& T = displacement_dof_map();
+    Eigen::VectorXd full_x(full_ndof());
+    tbb::parallel_for(
+        tbb::blocked_range<long>(0, T.outerSize()),
+        [&](const tbb::blocked_range<long>& r) {
+            for (long j = r.begin(); j < r.end(); j++) {
+                double value = 0;
+                for (Eigen::SparseMatrix<double>::InnerIterator it(T, j); it;
+                     ++it) {
+                    value += it.value() * x[it.row()];
+                }
+                full_x[j] = value;
+            }
+        });
+    return full_x;
 }
 
 Eigen::SparseMatrix<double>
@@ -319,7 +651,50 @@ CollisionMesh::to_full_dof(const Eigen::SparseMatrix<double>& X) const
     // ∇_{full} Tᵀ * Sᵀ * ∇_{collision} f(S * T * x_full)
     //      = Tᵀ * Sᵀ * [∇_{collision}² f(S * T * x_full)] * S * T
     // X = ∇_{collision}² f(S * T * x_full); m_displacement_dof_map = S * T
-    return m_displacement_dof_map.transpose() * X * m_displacement_dof_map;
+    if (m_is_identity_dof_map) {
+        return X;
+    }
+    if (is_selection_dof_map()) {
+        // Pure selection: Tᵀ X T only renumbers the rows and columns, and
+        // vertex_to_full_vertex is increasing, so the entries are copied
+        // into the renumbered layout in order — no products and no sorting.
+        const int d = dim();
+        const auto to_full_id = [&](const long i) -> long {
+            return d * long(m_topology->vertex_to_full_vertex[i / d]) + i % d;
+        };
+
+        using InnerIterator = Eigen::SparseMatrix<double>::InnerIterator;
+        Eigen::VectorXi col_nnz = Eigen::VectorXi::Zero(full_ndof());
+        for (long j = 0; j < X.outerSize(); j++) {
+            int nnz = 0;
+            for (InnerIterator it(X, j); it; ++it) {
+                nnz++;
+            }
+            col_nnz[to_full_id(j)] = nnz;
+        }
+
+        Eigen::SparseMatrix<double> full_X(full_ndof(), full_ndof());
+        full_X.reserve(col_nnz);
+        for (long j = 0; j < X.outerSize(); j++) {
+            const long full_j = to_full_id(j);
+            for (InnerIterator it(X, j); it; ++it) {
+                full_X.insert(to_full_id(it.row()), full_j) = it.value();
+            }
+        }
+        full_X.makeCompressed();
+        return full_X;
+    }
+    const Eigen::SparseMatrix<double>& T = displacement_dof_map();
+    return T.transpose() * X * T;
+}
+
+Eigen::SparseMatrix<double> CollisionMesh::to_full_dof(
+    const Eigen::SparseMatrix<double>& X, DofMapProductCache& cache) const
+{
+    if (m_is_identity_dof_map) {
+        return X;
+    }
+    return cache.product(displacement_dof_map(), X);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -356,22 +731,45 @@ Eigen::MatrixXi CollisionMesh::construct_faces_to_edges(
             ei);
     }
 
+    // The edge map is read-only from here on, so the per-face lookups run
+    // in parallel.
     Eigen::MatrixXi faces_to_edges(faces.rows(), faces.cols());
-    for (int fi = 0; fi < faces.rows(); fi++) {
-        for (int fj = 0; fj < faces.cols(); fj++) {
-            const int vi = faces(fi, fj);
-            const int vj = faces(fi, (fj + 1) % faces.cols());
-            std::pair<int, int> e(std::min(vi, vj), std::max(vi, vj));
-            auto search = edge_map.find(e);
-            if (search != edge_map.end()) {
-                faces_to_edges(fi, fj) = search->second;
-            } else {
-                throw std::runtime_error("Unable to find edge!");
+    tbb::parallel_for(
+        tbb::blocked_range<long>(0, faces.rows()),
+        [&](const tbb::blocked_range<long>& r) {
+            for (long fi = r.begin(); fi < r.end(); fi++) {
+                for (int fj = 0; fj < faces.cols(); fj++) {
+                    const int vi = faces(fi, fj);
+                    const int vj = faces(fi, (fj + 1) % faces.cols());
+                    std::pair<int, int> e(
+                        std::min(vi, vj), std::max(vi, vj));
+                    auto search = edge_map.find(e);
+                    if (search != edge_map.end()) {
+                        faces_to_edges(fi, fj) = search->second;
+                    } else {
+                        throw std::runtime_error("Unable to find edge!");
+                    }
+                }
             }
-        }
-    }
+        });
 
     return faces_to_edges;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+
+void CollisionMesh::set_vertex_patch_ids(
+    const Eigen::VectorXi& patch_ids,
+    const Eigen::Matrix<bool, Eigen::Dynamic, Eigen::Dynamic>&
+        can_patches_collide)
+{
+    assert(patch_ids.size() == long(num_vertices()));
+    assert(can_patches_collide.rows() == can_patches_collide.cols());
+    assert(patch_ids.size() == 0
+           || (patch_ids.minCoeff() >= 0
+               && patch_ids.maxCoeff() < can_patches_collide.rows()));
+    m_vertex_patch_ids = patch_ids;
+    m_can_patches_collide = can_patches_collide;
+}
+
 } // namespace ipc
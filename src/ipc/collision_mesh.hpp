@@ -1,14 +1,60 @@
 #pragma once
 
+#include <ipc/utils/dof_map_product_cache.hpp>
+#include <ipc/utils/eigen_ext.hpp>
 #include <ipc/utils/unordered_map_and_set.hpp>
 
 #include <Eigen/Core>
 #include <Eigen/Sparse>
 
+#include <memory>
+
 namespace ipc {
 
 class CollisionMesh {
 public:
+    /// @brief Immutable topology shared between instances of the same mesh.
+    ///
+    /// Instanced copies of identical geometry (e.g., spawned rigid bodies)
+    /// hold a shared pointer to a single SharedTopology instead of
+    /// duplicating the connectivity arrays per copy.
+    struct SharedTopology {
+        /// @brief Edges as rows of indicies into V.
+        Eigen::MatrixXi edges;
+        /// @brief Triangular faces as rows of indicies into V.
+        Eigen::MatrixXi faces;
+        /// @brief Map from F edges to rows of E.
+        Eigen::MatrixXi faces_to_edges;
+
+        /// @brief Map from full vertices to collision vertices.
+        /// @note Negative values indicate full vertex is dropped.
+        Eigen::VectorXi full_vertex_to_vertex;
+        /// @brief Map from collision vertices to full vertices.
+        Eigen::VectorXi vertex_to_full_vertex;
+
+        /// @brief Selection matrix S ∈ ℝ^{collision×full} for vertices
+        Eigen::SparseMatrix<double> select_vertices;
+        /// @brief Selection matrix S ∈ ℝ^{collision×full} for DOF
+        Eigen::SparseMatrix<double> select_dof;
+
+        /// @brief Vertices adjacent to vertices
+        std::vector<unordered_set<int>> vertex_vertex_adjacencies;
+        /// @brief Vertices adjacent to edges
+        std::vector<unordered_set<int>> edge_vertex_adjacencies;
+
+        /// @brief Offsets into vertex_edge_adjacency (CSR, num_vertices+1)
+        Eigen::VectorXi vertex_edge_adjacency_offsets;
+        /// @brief Edges incident to vertices in CSR order
+        Eigen::VectorXi vertex_edge_adjacency;
+        /// @brief Offsets into vertex_face_adjacency (CSR, num_vertices+1)
+        Eigen::VectorXi vertex_face_adjacency_offsets;
+        /// @brief Faces incident to vertices in CSR order
+        Eigen::VectorXi vertex_face_adjacency;
+
+        /// @brief Is vertex on the boundary of the triangle mesh in 3D or polyline in 2D?
+        std::vector<bool> is_vertex_on_boundary;
+    };
+
     /// @brief Construct a new Collision Mesh object.
     /// Collision Mesh objects are immutable after construction, so use the
     /// other constructors.
@@ -40,11 +86,26 @@ public:
         const Eigen::SparseMatrix<double>& displacement_map =
             Eigen::SparseMatrix<double>());
 
+    /// @brief Construct an instance of a prototype collision mesh.
+    /// The instance shares the prototype's immutable topology (edges, faces,
+    /// faces-to-edges map, adjacencies, and selection matrices), so only the
+    /// rest-position-dependent quantities (areas and their jacobians and the
+    /// edge rest lengths) are recomputed. This makes spawning many copies of
+    /// identical geometry cheap in both time and memory.
+    /// @param prototype The collision mesh whose topology to share.
+    /// @param full_vertices_at_rest The rest positions of this instance on the full mesh.
+    CollisionMesh(
+        const CollisionMesh& prototype,
+        const Eigen::MatrixXd& full_vertices_at_rest);
+
     /// @brief Destroy the Collision Mesh object
     ~CollisionMesh() { }
 
     /// @brief Get the number of vertices in the collision mesh.
-    size_t num_vertices() const { return m_vertex_to_full_vertex.size(); }
+    size_t num_vertices() const
+    {
+        return m_topology->vertex_to_full_vertex.size();
+    }
 
     /// @brief Get the number of edges in the collision mesh.
     size_t num_edges() const { return edges().rows(); }
@@ -59,7 +120,10 @@ public:
     size_t ndof() const { return num_vertices() * dim(); }
 
     /// @brief Get the number of vertices in the full mesh.
-    size_t full_num_vertices() const { return m_full_vertex_to_vertex.size(); }
+    size_t full_num_vertices() const
+    {
+        return m_topology->full_vertex_to_vertex.size();
+    }
 
     /// @brief Get the number of degrees of freedom in the full mesh.
     size_t full_ndof() const { return full_num_vertices() * dim(); }
@@ -71,13 +135,32 @@ public:
     }
 
     /// @brief Get the edges of the collision mesh.
-    const Eigen::MatrixXi& edges() const { return m_edges; }
+    const Eigen::MatrixXi& edges() const { return m_topology->edges; }
 
     /// @brief Get the faces of the collision mesh.
-    const Eigen::MatrixXi& faces() const { return m_faces; }
+    const Eigen::MatrixXi& faces() const { return m_topology->faces; }
 
     /// @brief Get the mapping from faces to edges of the collision mesh.
-    const Eigen::MatrixXi& faces_to_edges() const { return m_faces_to_edges; }
+    const Eigen::MatrixXi& faces_to_edges() const
+    {
+        return m_topology->faces_to_edges;
+    }
+
+    /// @brief Is the map from the full mesh to the collision mesh identity?
+    /// True when every vertex is included and no displacement map is given,
+    /// in which case vertices(), map_displacements(), and to_full_dof() are
+    /// pass-throughs.
+    bool is_identity_dof_map() const { return m_is_identity_dof_map; }
+
+    /// @brief Is the map from the full mesh a pure vertex-subset selection?
+    /// True when no custom displacement map was given (the identity map
+    /// included), in which case map_displacements() and to_full_dof() are
+    /// direct index gathers/scatters over vertex_to_full_vertex instead of
+    /// sparse-matrix products.
+    bool is_selection_dof_map() const
+    {
+        return m_displacement_map.size() == 0;
+    }
 
     // const std::vector<std::vector<int>>& vertices_to_edges() const
     // {
@@ -94,19 +177,40 @@ public:
     /// @brief Compute the vertex positions from the positions of the full mesh.
     /// @param full_vertices The vertex positions of the full mesh.
     /// @return The vertex positions of the collision mesh.
-    Eigen::MatrixXd vertices(const Eigen::MatrixXd& full_vertices) const;
+    Eigen::MatrixXd vertices(ConstMatrixXdRef full_vertices) const;
 
     /// @brief Compute the vertex positions from vertex displacements on the full mesh.
     /// @param full_displacements The vertex displacements on the full mesh.
     /// @return The vertex positions of the collision mesh.
     Eigen::MatrixXd
-    displace_vertices(const Eigen::MatrixXd& full_displacements) const;
+    displace_vertices(ConstMatrixXdRef full_displacements) const;
 
     /// @brief Map vertex displacements on the full mesh to vertex displacements on the collision mesh.
     /// @param full_displacements The vertex displacements on the full mesh.
     /// @return The vertex displacements on the collision mesh.
     Eigen::MatrixXd
-    map_displacements(const Eigen::MatrixXd& full_displacements) const;
+    map_displacements(ConstMatrixXdRef full_displacements) const;
+
+    /// @brief Apply a local edit to previously mapped vertex positions.
+    ///
+    /// vertices() maps the entire full mesh every call; when only a small
+    /// region moved (local relaxation passes, user dragging) this updates
+    /// just the affected rows of a vertex matrix previously computed by
+    /// vertices() and reports which collision vertices changed. Pair the
+    /// changed ids with a margin-built broad phase (see
+    /// BroadPhase::set_build_margin()) so local edits skip the full
+    /// broad-phase rebuild until a vertex leaves the margin.
+    /// @param[in] full_vertex_ids IDs (rows of the full mesh) whose positions changed.
+    /// @param[in] new_positions New positions, one row per entry of full_vertex_ids.
+    /// @param[in,out] full_vertices The full mesh positions; the listed rows are overwritten.
+    /// @param[in,out] vertices Collision vertex positions previously computed from full_vertices.
+    /// @param[out] changed_vertices Sorted, unique collision-vertex IDs whose rows changed.
+    void update_vertices(
+        const Eigen::VectorXi& full_vertex_ids,
+        ConstMatrixXdRef new_positions,
+        Eigen::MatrixXd& full_vertices,
+        Eigen::MatrixXd& vertices,
+        std::vector<int>& changed_vertices) const;
 
     /// @brief Map a vertex ID to the corresponding vertex ID in the full mesh.
     /// @param id Vertex ID in the collision mesh.
@@ -114,7 +218,7 @@ public:
     size_t to_full_vertex_id(const size_t id) const
     {
         assert(id < num_vertices());
-        return m_vertex_to_full_vertex[id];
+        return m_topology->vertex_to_full_vertex[id];
     }
 
     /// @brief Map a vector quantity on the collision mesh to the full mesh.
@@ -132,18 +236,35 @@ public:
     Eigen::SparseMatrix<double>
     to_full_dof(const Eigen::SparseMatrix<double>& X) const;
 
+    /// @brief Map a matrix quantity on the collision mesh to the full mesh
+    /// using a reusable product context.
+    ///
+    /// The context caches the symbolic triple product (whose pattern only
+    /// changes with the constraint set) and runs the numeric phase in
+    /// parallel, so repeated hessian hand-offs skip the sparse-sparse
+    /// products.
+    /// @param X Matrix quantity on the collision mesh with size equal to ndof() × ndof().
+    /// @param[in,out] cache Product context reused between calls (use one per mesh).
+    /// @return Matrix quantity on the full mesh with size equal to full_ndof() × full_ndof().
+    /// @note For selection DOF maps (is_selection_dof_map()) the plain
+    /// overload is already a direct permuted copy; the cache only pays off
+    /// for custom displacement maps.
+    Eigen::SparseMatrix<double> to_full_dof(
+        const Eigen::SparseMatrix<double>& X,
+        DofMapProductCache& cache) const;
+
     // -----------------------------------------------------------------------
 
     /// @brief Get the vertex-vertex adjacency matrix.
     const std::vector<unordered_set<int>>& vertex_vertex_adjacencies() const
     {
-        return m_vertex_vertex_adjacencies;
+        return m_topology->vertex_vertex_adjacencies;
     }
 
     /// @brief Get the edge-vertex adjacency matrix.
     const std::vector<unordered_set<int>>& edge_vertex_adjacencies() const
     {
-        return m_edge_vertex_adjacencies;
+        return m_topology->edge_vertex_adjacencies;
     }
 
     /// @brief Is a vertex on the boundary of the collision mesh?
@@ -151,7 +272,7 @@ public:
     /// @return True if the vertex is on the boundary of the collision mesh.
     bool is_vertex_on_boundary(const int vi) const
     {
-        return m_is_vertex_on_boundary[vi];
+        return m_topology->is_vertex_on_boundary[vi];
     }
 
     /// @brief Get the barycentric area of a vertex.
@@ -168,6 +289,7 @@ public:
     const Eigen::SparseVector<double>&
     vertex_area_gradient(const size_t vi) const
     {
+        prepare_area_jacobians();
         return m_vertex_area_jacobian[vi];
     }
 
@@ -184,9 +306,81 @@ public:
     /// @return Gradient of the barycentric area of edge ei wrt the rest positions of all points.
     const Eigen::SparseVector<double>& edge_area_gradient(const size_t ei) const
     {
+        prepare_area_jacobians();
         return m_edge_area_jacobian[ei];
     }
 
+    /// @brief Compute the area jacobian tables if not already computed.
+    ///
+    /// The jacobians are only consumed by shape-derivative builds, so they
+    /// are not computed with the areas; the first call fills the tables and
+    /// subsequent calls are a flag check. Call this once before querying
+    /// the area gradients from parallel code (Constraints::build does), as
+    /// the first computation is not safe to trigger concurrently.
+    void prepare_area_jacobians() const;
+
+    /// @brief Get the IDs of the edges incident to a vertex.
+    /// The incidence is stored in compressed (CSR) form, so the lookup is a
+    /// contiguous segment of the adjacency array.
+    /// @param vi Vertex ID.
+    /// @return The IDs of the edges incident to vertex vi.
+    auto vertex_edge_adjacencies(const size_t vi) const
+    {
+        const SharedTopology& topo = *m_topology;
+        return topo.vertex_edge_adjacency.segment(
+            topo.vertex_edge_adjacency_offsets[vi],
+            topo.vertex_edge_adjacency_offsets[vi + 1]
+                - topo.vertex_edge_adjacency_offsets[vi]);
+    }
+
+    /// @brief Get the IDs of the faces incident to a vertex.
+    /// The incidence is stored in compressed (CSR) form, so the lookup is a
+    /// contiguous segment of the adjacency array.
+    /// @param vi Vertex ID.
+    /// @return The IDs of the faces incident to vertex vi.
+    auto vertex_face_adjacencies(const size_t vi) const
+    {
+        const SharedTopology& topo = *m_topology;
+        return topo.vertex_face_adjacency.segment(
+            topo.vertex_face_adjacency_offsets[vi],
+            topo.vertex_face_adjacency_offsets[vi + 1]
+                - topo.vertex_face_adjacency_offsets[vi]);
+    }
+
+    /// @brief Get the edge-edge mollifier threshold (eps_x) for a pair of edges.
+    /// The threshold depends only on the rest lengths of the two edges, so it
+    /// factors into per-edge squared rest lengths which are precomputed once
+    /// at construction instead of being recomputed for every edge-edge
+    /// constraint on every build.
+    /// @param eai ID of the first edge.
+    /// @param ebi ID of the second edge.
+    /// @return Threshold for edge-edge mollification.
+    double edge_edge_mollifier_threshold(
+        const size_t eai, const size_t ebi) const
+    {
+        return 1.0e-3 * m_rest_edge_sqr_lengths[eai]
+            * m_rest_edge_sqr_lengths[ebi];
+    }
+
+    /// @brief Get the median rest length of the mesh's edges.
+    ///
+    /// Consumed by the broad phase's voxel-size heuristic in place of the
+    /// O(|E|) serial median pass otherwise repeated on every rebuild. The
+    /// median is computed lazily on the first call (from the squared rest
+    /// lengths precomputed at construction) and cached; the first call is
+    /// not safe to trigger concurrently, so make it before parallel code
+    /// (the broad-phase wiring does).
+    /// @return Median rest edge length (zero for an edgeless mesh).
+    double rest_median_edge_length() const;
+
+    /// @brief Invalidate the cached median rest edge length.
+    /// Only needed if the rest positions are rewritten in place through a
+    /// derived class; construction computes the cache inputs itself.
+    void invalidate_rest_median_edge_length()
+    {
+        m_rest_median_edge_length = -1;
+    }
+
     // -----------------------------------------------------------------------
 
     /// @brief Construct a vector of bools indicating whether each vertex is on the surface.
@@ -224,6 +418,48 @@ public:
     /// primitives.
     std::function<bool(size_t, size_t)> can_collide = default_can_collide;
 
+    /// @brief Set patch-based collision culling.
+    ///
+    /// Patches are user-defined sub-regions of the mesh (e.g., one rigid
+    /// attachment of a garment) identified by a per-vertex id. The
+    /// construct_collision_candidates() functions forward the patch-pair
+    /// mask to the broad phase, where it is consulted as an inline array
+    /// lookup before the box tests, so excluding, e.g., intra-patch
+    /// self-collision wholesale costs no callback per pair.
+    /// @note Takes precedence over can_collide during broad-phase detection.
+    /// @param patch_ids Per-vertex patch IDs (one per collision vertex).
+    /// @param can_patches_collide Symmetric mask of which patch pairs can collide.
+    void set_vertex_patch_ids(
+        const Eigen::VectorXi& patch_ids,
+        const Eigen::Matrix<bool, Eigen::Dynamic, Eigen::Dynamic>&
+            can_patches_collide);
+
+    /// @brief Remove the patch-based collision culling.
+    void clear_vertex_patch_ids()
+    {
+        m_vertex_patch_ids.resize(0);
+        m_can_patches_collide.resize(0, 0);
+    }
+
+    /// @brief Are per-vertex patch IDs set?
+    bool has_vertex_patch_ids() const
+    {
+        return m_vertex_patch_ids.size() > 0;
+    }
+
+    /// @brief Per-vertex patch IDs (empty when unset).
+    const Eigen::VectorXi& vertex_patch_ids() const
+    {
+        return m_vertex_patch_ids;
+    }
+
+    /// @brief Mask of which patch pairs can collide.
+    const Eigen::Matrix<bool, Eigen::Dynamic, Eigen::Dynamic>&
+    can_patches_collide() const
+    {
+        return m_can_patches_collide;
+    }
+
 protected:
     // -----------------------------------------------------------------------
     // Helper initialization functions
@@ -237,51 +473,56 @@ protected:
     /// @brief Initialize vertex and edge areas.
     void init_areas();
 
+    /// @brief Invert the faces-to-edges map into edge → face incidence (CSR).
+    /// @param[out] offsets Offset of each edge's face range (|E|+1).
+    /// @param[out] edge_faces Concatenated face IDs incident to each edge.
+    void edge_face_incidence(
+        Eigen::VectorXi& offsets, Eigen::VectorXi& edge_faces) const;
+
+    /// @brief Initialize the squared rest lengths of the edges.
+    void init_edge_sqr_lengths();
+
     /// @brief Convert a matrix meant for M_V * V to M_dof * x by duplicating the entries dim times.
     static Eigen::SparseMatrix<double> vertex_matrix_to_dof_matrix(
         const Eigen::SparseMatrix<double>& M_V, int dim);
 
+    /// @brief The active vertex displacement map (custom or the selection).
+    const Eigen::SparseMatrix<double>& displacement_map() const
+    {
+        return m_displacement_map.size() != 0 ? m_displacement_map
+                                              : m_topology->select_vertices;
+    }
+
+    /// @brief The active DOF displacement map (custom or the selection).
+    const Eigen::SparseMatrix<double>& displacement_dof_map() const
+    {
+        return m_displacement_dof_map.size() != 0 ? m_displacement_dof_map
+                                                  : m_topology->select_dof;
+    }
+
     // -----------------------------------------------------------------------
 
+    /// @brief The topology shared between instances of the same mesh.
+    /// @note Treated as immutable after construction.
+    std::shared_ptr<SharedTopology> m_topology =
+        std::make_shared<SharedTopology>();
+
     /// @brief The full vertex positions at rest.
     Eigen::MatrixXd m_full_vertices_at_rest;
     /// @brief The vertex positions at rest.
     Eigen::MatrixXd m_vertices_at_rest;
-    /// @brief Edges as rows of indicies into V.
-    Eigen::MatrixXi m_edges;
-    /// @brief Triangular faces as rows of indicies into V.
-    Eigen::MatrixXi m_faces;
-    /// @brief Map from F edges to rows of E.
-    Eigen::MatrixXi m_faces_to_edges;
-
-    /// @brief Map from full vertices to collision vertices.
-    /// @note Negative values indicate full vertex is dropped.
-    Eigen::VectorXi m_full_vertex_to_vertex;
-    /// @brief Map from collision vertices to full vertices.
-    Eigen::VectorXi m_vertex_to_full_vertex;
-
-    /// @brief Selection matrix S ∈ ℝ^{collision×full} for vertices
-    Eigen::SparseMatrix<double> m_select_vertices;
-    /// @brief Selection matrix S ∈ ℝ^{collision×full} for DOF
-    Eigen::SparseMatrix<double> m_select_dof;
-
-    /// @brief Mapping from full displacements to collision displacements
-    /// @note this is premultiplied by m_select_vertices
-    Eigen::SparseMatrix<double> m_displacement_map;
-    /// @brief Mapping from full displacements to collision displacements
-    /// @note this is premultiplied by m_select_dof
-    Eigen::SparseMatrix<double> m_displacement_dof_map;
 
-    /// @brief Vertices adjacent to vertices
-    std::vector<unordered_set<int>> m_vertex_vertex_adjacencies;
-    /// @brief Edges adjacent to edges
-    std::vector<unordered_set<int>> m_edge_vertex_adjacencies;
+    /// @brief Is the map from the full mesh to the collision mesh identity?
+    bool m_is_identity_dof_map = false;
 
-    // std::vector<std::vector<int>> m_vertices_to_faces;
-    // std::vector<std::vector<int>> m_vertices_to_edges;
-
-    /// @brief Is vertex on the boundary of the triangle mesh in 3D or polyline in 2D?
-    std::vector<bool> m_is_vertex_on_boundary;
+    /// @brief Custom mapping from full displacements to collision
+    /// displacements (premultiplied by the vertex selection matrix);
+    /// empty when no displacement map was given.
+    Eigen::SparseMatrix<double> m_displacement_map;
+    /// @brief Custom mapping from full displacements to collision
+    /// displacements (premultiplied by the DOF selection matrix);
+    /// empty when no displacement map was given.
+    Eigen::SparseMatrix<double> m_displacement_dof_map;
 
     /// @brief Vertex areas
     /// 2D: 1/2 sum of length of connected edges
@@ -292,10 +533,28 @@ protected:
     Eigen::VectorXd m_edge_areas;
 
     // Stored as a std::vector so it is easier to access the rows directly.
+    // Mutable because the tables are filled on first use (see
+    // prepare_area_jacobians()); shape derivatives are opt-in and most
+    // meshes never query them.
     /// @brief The rows of the Jacobian of the vertex areas vector.
-    std::vector<Eigen::SparseVector<double>> m_vertex_area_jacobian;
+    mutable std::vector<Eigen::SparseVector<double>> m_vertex_area_jacobian;
     /// @brief The rows of the Jacobian of the edge areas vector.
-    std::vector<Eigen::SparseVector<double>> m_edge_area_jacobian;
+    mutable std::vector<Eigen::SparseVector<double>> m_edge_area_jacobian;
+    /// @brief Whether the area jacobian tables have been computed.
+    mutable bool m_area_jacobians_computed = false;
+
+    /// @brief The squared rest lengths of the edges (for eps_x lookups).
+    Eigen::VectorXd m_rest_edge_sqr_lengths;
+
+    /// @brief Cached median rest edge length (negative until computed).
+    /// Mutable because it is filled on first use (see
+    /// rest_median_edge_length()).
+    mutable double m_rest_median_edge_length = -1;
+
+    /// @brief Per-vertex patch IDs (empty when no patches are set).
+    Eigen::VectorXi m_vertex_patch_ids;
+    /// @brief Symmetric mask of which patch pairs can collide.
+    Eigen::Matrix<bool, Eigen::Dynamic, Eigen::Dynamic> m_can_patches_collide;
 
 private:
     /// @brief By default all primitives can collide with all other primitives.
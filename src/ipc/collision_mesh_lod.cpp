@@ -0,0 +1,20 @@
+#include "collision_mesh_lod.hpp"
+
+namespace ipc {
+
+void CollisionMeshLOD::add_level(CollisionMesh mesh, const double max_deviation)
+{
+    assert(max_deviation >= 0);
+    // All levels map from the same full mesh, so the solver-side DOF layout
+    // is identical no matter which level is active.
+    assert(m_levels.empty() || mesh.full_ndof() == m_levels[0].mesh.full_ndof());
+    m_levels.push_back({ std::move(mesh), max_deviation });
+}
+
+void CollisionMeshLOD::set_active_level(const size_t level)
+{
+    assert(level < num_levels());
+    m_active_level = level;
+}
+
+} // namespace ipc
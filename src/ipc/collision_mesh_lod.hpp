@@ -0,0 +1,110 @@
+#pragma once
+
+#include <ipc/collision_mesh.hpp>
+
+#include <vector>
+
+namespace ipc {
+
+/// @brief A stack of collision proxies for one object at decreasing
+/// resolutions.
+///
+/// Level 0 is the full-resolution collision mesh; higher levels are decimated
+/// proxies. Every level is a regular CollisionMesh built over the same full
+/// mesh, with its prolongation baked into the level's displacement map: the
+/// proxy vertices move as a fixed linear combination (e.g., barycentric
+/// coordinates on the full surface) of the full vertices, so vertices() and
+/// to_full_dof() on the level chain gradients and hessians back to the full
+/// DOF exactly as the single-mesh path does. The broad phase,
+/// Constraints::build, and the potentials are simply run on mesh() — for a
+/// 10x-decimated background object they see 10x fewer elements with no
+/// changes of their own.
+///
+/// Switching levels between steps is a pointer swap; no per-step rebuild of
+/// maps or topology. Each level carries a precomputed deviation bound (the
+/// maximum distance from the full-resolution surface to the proxy surface),
+/// and inflate_dhat() folds it into the activation distance so a proxy run
+/// still activates every contact the full mesh would — the controlled error
+/// is in the contact forces' resolution, not in missed contacts.
+class CollisionMeshLOD {
+public:
+    /// @brief Construct an empty LOD stack; add levels with add_level().
+    CollisionMeshLOD() { }
+
+    /// @brief Append a level to the stack.
+    ///
+    /// Call in order of decreasing resolution: the first added level is
+    /// level 0 (the full-resolution collision mesh, max_deviation 0) and
+    /// becomes the active level.
+    /// @param mesh Collision mesh of the level. Its displacement map must
+    /// take full-mesh displacements (see CollisionMesh's constructors); for
+    /// a proxy this is the prolongation from the full mesh to the proxy
+    /// vertices.
+    /// @param max_deviation Upper bound on the distance from the
+    /// full-resolution surface to this level's surface (0 for level 0).
+    void add_level(CollisionMesh mesh, const double max_deviation = 0);
+
+    /// @brief Get the number of levels in the stack.
+    size_t num_levels() const { return m_levels.size(); }
+
+    /// @brief Does the stack have no levels?
+    bool empty() const { return m_levels.empty(); }
+
+    /// @brief Select the level used by mesh() and inflate_dhat().
+    ///
+    /// Safe to call between steps; constraint sets and broad phases built on
+    /// the previous level keep referencing that level's CollisionMesh, so
+    /// finish (or discard) them before switching.
+    /// @param level Level to activate (0 = full resolution).
+    void set_active_level(const size_t level);
+
+    /// @brief Get the active level (0 = full resolution).
+    size_t active_level() const { return m_active_level; }
+
+    /// @brief Get the active level's collision mesh.
+    const CollisionMesh& mesh() const { return mesh(m_active_level); }
+
+    /// @brief Get the collision mesh of a level.
+    /// @param level Level to query (0 = full resolution).
+    const CollisionMesh& mesh(const size_t level) const
+    {
+        assert(level < num_levels());
+        return m_levels[level].mesh;
+    }
+
+    /// @brief Get the deviation bound of a level.
+    /// @param level Level to query (0 = full resolution).
+    double max_deviation(const size_t level) const
+    {
+        assert(level < num_levels());
+        return m_levels[level].max_deviation;
+    }
+
+    /// @brief Inflate dhat to conservatively cover the active level's error.
+    ///
+    /// The full-resolution surfaces of two objects can each be up to the
+    /// deviation bound closer than their proxies, so running the barrier on
+    /// the proxy with dhat + 2·max_deviation activates (at least) every
+    /// contact the full mesh would within dhat.
+    /// @param dhat The activation distance of the barrier on the full mesh.
+    /// @return The activation distance to use on the active level.
+    double inflate_dhat(const double dhat) const
+    {
+        assert(!empty());
+        return dhat + 2 * m_levels[m_active_level].max_deviation;
+    }
+
+protected:
+    /// @brief A collision mesh and the deviation bound of its surface.
+    struct Level {
+        CollisionMesh mesh;
+        double max_deviation;
+    };
+
+    /// @brief The levels in order of decreasing resolution.
+    std::vector<Level> m_levels;
+    /// @brief The level returned by mesh() (0 = full resolution).
+    size_t m_active_level = 0;
+};
+
+} // namespace ipc
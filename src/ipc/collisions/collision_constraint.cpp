@@ -4,68 +4,77 @@
 
 namespace ipc {
 
+// The kernels live in collision_constraint.tpp templated on the barrier
+// function; the virtuals below compile the default barrier once.
+
 double CollisionConstraint::compute_potential(
-    const Eigen::MatrixXd& V,
+    ConstMatrixXdRef V,
     const Eigen::MatrixXi& E,
     const Eigen::MatrixXi& F,
     const double dhat) const
 {
-    const double distance = compute_distance(V, E, F); // Squared distance
-    return weight
-        * barrier(
-               distance - minimum_distance * minimum_distance,
-               2 * minimum_distance * dhat + dhat * dhat);
+    return CollisionConstraint::compute_potential(
+        V, E, F, dhat, compute_distance(V, E, F)); // Squared distance
 }
 
-VectorMax12d CollisionConstraint::compute_potential_gradient(
-    const Eigen::MatrixXd& V,
+double CollisionConstraint::compute_potential(
+    ConstMatrixXdRef V,
     const Eigen::MatrixXi& E,
     const Eigen::MatrixXi& F,
-    const double dhat) const
+    const double dhat,
+    const double distance) const
 {
-    // ∇b(d(x)) = b'(d(x)) * ∇d(x)
-    const double distance = compute_distance(V, E, F);
-    const VectorMax12d distance_grad = compute_distance_gradient(V, E, F);
-
-    const double grad_b = barrier_gradient(
-        distance - minimum_distance * minimum_distance,
-        2 * minimum_distance * dhat + dhat * dhat);
-    return weight * grad_b * distance_grad;
+    return compute_potential_T<ClampedLogBarrier>(V, E, F, dhat, distance);
 }
 
-MatrixMax12d CollisionConstraint::compute_potential_hessian(
-    const Eigen::MatrixXd& V,
+void CollisionConstraint::compute_potential_gradient(
+    ConstMatrixXdRef V,
     const Eigen::MatrixXi& E,
     const Eigen::MatrixXi& F,
     const double dhat,
-    const bool project_hessian_to_psd) const
+    VectorMax12d& grad) const
 {
-    const double dhat_squared = dhat * dhat;
-    const double min_dist_squrared = minimum_distance * minimum_distance;
-
-    // ∇²[b(d(x))] = ∇(b'(d(x)) * ∇d(x))
-    //             = b"(d(x)) * ∇d(x) * ∇d(x)ᵀ + b'(d(x)) * ∇²d(x)
-
-    const double distance = compute_distance(V, E, F);
-    const VectorMax12d distance_grad = compute_distance_gradient(V, E, F);
-    const MatrixMax12d distance_hess = compute_distance_hessian(V, E, F);
+    CollisionConstraint::compute_potential_gradient(
+        V, E, F, dhat, compute_distance(V, E, F), grad);
+}
 
-    const double grad_b = barrier_gradient(
-        distance - min_dist_squrared,
-        2 * minimum_distance * dhat + dhat_squared);
-    const double hess_b = barrier_hessian(
-        distance - min_dist_squrared,
-        2 * minimum_distance * dhat + dhat_squared);
+void CollisionConstraint::compute_potential_gradient(
+    ConstMatrixXdRef V,
+    const Eigen::MatrixXi& E,
+    const Eigen::MatrixXi& F,
+    const double dhat,
+    const double distance,
+    VectorMax12d& grad) const
+{
+    compute_potential_gradient_T<ClampedLogBarrier>(
+        V, E, F, dhat, distance, grad);
+}
 
-    // b"(x) ≥ 0 ⟹ b"(x) * ∇d(x) * ∇d(x)ᵀ is PSD
-    assert(hess_b >= 0);
-    MatrixMax12d term1 = hess_b * distance_grad * distance_grad.transpose();
-    MatrixMax12d term2 = grad_b * distance_hess;
-    if (project_hessian_to_psd) {
-        term2 = project_to_psd(term2);
-    }
+void CollisionConstraint::compute_potential_hessian(
+    ConstMatrixXdRef V,
+    const Eigen::MatrixXi& E,
+    const Eigen::MatrixXi& F,
+    const double dhat,
+    const bool project_hessian_to_psd,
+    MatrixMax12d& hess) const
+{
+    compute_potential_hessian_T<ClampedLogBarrier>(
+        V, E, F, dhat, project_hessian_to_psd, hess);
+}
 
-    return weight * (term1 + term2);
+void CollisionConstraint::compute_potential_and_derivatives(
+    ConstMatrixXdRef V,
+    const Eigen::MatrixXi& E,
+    const Eigen::MatrixXi& F,
+    const double dhat,
+    const bool project_hessian_to_psd,
+    double& potential,
+    VectorMax12d& potential_grad,
+    MatrixMax12d& potential_hess) const
+{
+    compute_potential_and_derivatives_T<ClampedLogBarrier>(
+        V, E, F, dhat, project_hessian_to_psd, potential, potential_grad,
+        potential_hess);
 }
 
 } // namespace ipc
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <ipc/utils/eigen_ext.hpp>
+#include <ipc/utils/index.hpp>
 
 #include <Eigen/Core>
 
@@ -18,46 +19,199 @@ public:
     /// @param E edge matrix of mesh
     /// @param F face matrix of mesh
     /// @return List of vertex indices
-    virtual std::array<long, 4> vertex_indices(
+    virtual std::array<index_t, 4> vertex_indices(
         const Eigen::MatrixXi& E, const Eigen::MatrixXi& F) const = 0;
 
     virtual double compute_distance(
-        const Eigen::MatrixXd& V,
+        ConstMatrixXdRef V,
         const Eigen::MatrixXi& E,
         const Eigen::MatrixXi& F) const = 0;
 
     virtual VectorMax12d compute_distance_gradient(
-        const Eigen::MatrixXd& V,
+        ConstMatrixXdRef V,
         const Eigen::MatrixXi& E,
         const Eigen::MatrixXi& F) const = 0;
 
     virtual MatrixMax12d compute_distance_hessian(
-        const Eigen::MatrixXd& V,
+        ConstMatrixXdRef V,
         const Eigen::MatrixXi& E,
         const Eigen::MatrixXi& F) const = 0;
 
     virtual double compute_potential(
-        const Eigen::MatrixXd& V,
+        ConstMatrixXdRef V,
         const Eigen::MatrixXi& E,
         const Eigen::MatrixXi& F,
         const double dhat) const;
 
-    virtual VectorMax12d compute_potential_gradient(
-        const Eigen::MatrixXd& V,
+    /// @brief Compute the potential from an already computed distance.
+    /// @param distance Squared distance of the constraint for V.
+    virtual double compute_potential(
+        ConstMatrixXdRef V,
         const Eigen::MatrixXi& E,
         const Eigen::MatrixXi& F,
-        const double dhat) const;
+        const double dhat,
+        const double distance) const;
+
+    VectorMax12d compute_potential_gradient(
+        ConstMatrixXdRef V,
+        const Eigen::MatrixXi& E,
+        const Eigen::MatrixXi& F,
+        const double dhat) const
+    {
+        VectorMax12d grad;
+        compute_potential_gradient(V, E, F, dhat, grad);
+        return grad;
+    }
+
+    /// @brief Compute the potential gradient from an already computed
+    /// distance.
+    /// @param distance Squared distance of the constraint for V.
+    VectorMax12d compute_potential_gradient(
+        ConstMatrixXdRef V,
+        const Eigen::MatrixXi& E,
+        const Eigen::MatrixXi& F,
+        const double dhat,
+        const double distance) const
+    {
+        VectorMax12d grad;
+        compute_potential_gradient(V, E, F, dhat, distance, grad);
+        return grad;
+    }
+
+    MatrixMax12d compute_potential_hessian(
+        ConstMatrixXdRef V,
+        const Eigen::MatrixXi& E,
+        const Eigen::MatrixXi& F,
+        const double dhat,
+        const bool project_hessian_to_psd) const
+    {
+        MatrixMax12d hess;
+        compute_potential_hessian(V, E, F, dhat, project_hessian_to_psd, hess);
+        return hess;
+    }
+
+    // The virtual kernels below write into caller provided storage, so the
+    // assembly loops can reuse one scratch buffer per thread instead of
+    // copy-constructing a Max-sized return value per constraint.
+
+    /// @brief In-place variant of compute_potential_gradient.
+    /// @param[out] grad Storage for the gradient (resized as needed).
+    virtual void compute_potential_gradient(
+        ConstMatrixXdRef V,
+        const Eigen::MatrixXi& E,
+        const Eigen::MatrixXi& F,
+        const double dhat,
+        VectorMax12d& grad) const;
+
+    /// @brief In-place variant of compute_potential_gradient from an already
+    /// computed distance.
+    /// @param distance Squared distance of the constraint for V.
+    /// @param[out] grad Storage for the gradient (resized as needed).
+    virtual void compute_potential_gradient(
+        ConstMatrixXdRef V,
+        const Eigen::MatrixXi& E,
+        const Eigen::MatrixXi& F,
+        const double dhat,
+        const double distance,
+        VectorMax12d& grad) const;
 
-    virtual MatrixMax12d compute_potential_hessian(
-        const Eigen::MatrixXd& V,
+    /// @brief In-place variant of compute_potential_hessian.
+    /// @param[out] hess Storage for the hessian (resized as needed).
+    virtual void compute_potential_hessian(
+        ConstMatrixXdRef V,
         const Eigen::MatrixXi& E,
         const Eigen::MatrixXi& F,
         const double dhat,
-        const bool project_hessian_to_psd) const;
+        const bool project_hessian_to_psd,
+        MatrixMax12d& hess) const;
+
+    /// @brief Compute the potential and its derivatives in a single pass.
+    ///
+    /// Shares the distance value and its derivatives between the three
+    /// quantities instead of recomputing them per quantity.
+    virtual void compute_potential_and_derivatives(
+        ConstMatrixXdRef V,
+        const Eigen::MatrixXi& E,
+        const Eigen::MatrixXi& F,
+        const double dhat,
+        const bool project_hessian_to_psd,
+        double& potential,
+        VectorMax12d& potential_grad,
+        MatrixMax12d& potential_hess) const;
+
+    // The templated kernels below are the actual implementations of the
+    // virtuals above, parameterized on the barrier function so custom
+    // barriers inline into the constraint loops (see ClampedLogBarrier in
+    // barrier/barrier.hpp for the Barrier requirements and the default).
+    // The virtuals forward to the ClampedLogBarrier instantiations. Note
+    // that the templates do not dispatch virtually: call them on the
+    // concrete constraint type (e.g. through Constraints::for_each) so
+    // derived shadows like EdgeEdgeConstraint's mollified versions are
+    // selected.
+
+    /// @brief Templated core of compute_potential.
+    /// @tparam Barrier The barrier function (see ClampedLogBarrier).
+    /// @param distance Squared distance of the constraint for V.
+    template <typename Barrier>
+    double compute_potential_T(
+        ConstMatrixXdRef V,
+        const Eigen::MatrixXi& E,
+        const Eigen::MatrixXi& F,
+        const double dhat,
+        const double distance) const;
+
+    /// @brief Templated core of compute_potential_gradient.
+    /// @tparam Barrier The barrier function (see ClampedLogBarrier).
+    /// @param distance Squared distance of the constraint for V.
+    /// @param[out] grad Storage for the gradient (resized as needed).
+    template <typename Barrier>
+    void compute_potential_gradient_T(
+        ConstMatrixXdRef V,
+        const Eigen::MatrixXi& E,
+        const Eigen::MatrixXi& F,
+        const double dhat,
+        const double distance,
+        VectorMax12d& grad) const;
+
+    /// @brief Templated core of compute_potential_hessian.
+    /// @tparam Barrier The barrier function (see ClampedLogBarrier).
+    /// @param[out] hess Storage for the hessian (resized as needed).
+    template <typename Barrier>
+    void compute_potential_hessian_T(
+        ConstMatrixXdRef V,
+        const Eigen::MatrixXi& E,
+        const Eigen::MatrixXi& F,
+        const double dhat,
+        const bool project_hessian_to_psd,
+        MatrixMax12d& hess) const;
+
+    /// @brief Templated core of compute_potential_and_derivatives.
+    /// @tparam Barrier The barrier function (see ClampedLogBarrier).
+    template <typename Barrier>
+    void compute_potential_and_derivatives_T(
+        ConstMatrixXdRef V,
+        const Eigen::MatrixXi& E,
+        const Eigen::MatrixXi& F,
+        const double dhat,
+        const bool project_hessian_to_psd,
+        double& potential,
+        VectorMax12d& potential_grad,
+        MatrixMax12d& potential_hess) const;
 
     double minimum_distance = 0;
     double weight = 1;
     Eigen::SparseVector<double> weight_gradient;
+    /// @brief Constraint-specific activation distance (-1 = use the dhat
+    /// argument of the evaluation calls). Set by Constraints::build() to the
+    /// maximum over the constraint's vertices when a per-vertex dhat is in
+    /// use (see Constraints::vertex_dhat).
+    double local_dhat = -1;
+    /// @brief Squared distance computed by Constraints::build while culling
+    /// the candidates (-1 if unset). Valid only while
+    /// Constraints::are_cached_distances_valid holds for V.
+    double cached_distance = -1;
 };
 
 } // namespace ipc
+
+#include "collision_constraint.tpp"
@@ -0,0 +1,132 @@
+#pragma once
+#include "collision_constraint.hpp"
+
+#include <ipc/barrier/barrier.hpp>
+
+namespace ipc {
+
+template <typename Barrier>
+double CollisionConstraint::compute_potential_T(
+    ConstMatrixXdRef V,
+    const Eigen::MatrixXi& E,
+    const Eigen::MatrixXi& F,
+    const double global_dhat,
+    const double distance) const
+{
+    // A per-vertex dhat stamps each constraint with its own
+    // activation distance (see Constraints::vertex_dhat).
+    const double dhat = local_dhat < 0 ? global_dhat : local_dhat;
+    assert(distance >= 0); // Squared distance
+    return weight
+        * Barrier::value(
+               distance - minimum_distance * minimum_distance,
+               2 * minimum_distance * dhat + dhat * dhat);
+}
+
+template <typename Barrier>
+void CollisionConstraint::compute_potential_gradient_T(
+    ConstMatrixXdRef V,
+    const Eigen::MatrixXi& E,
+    const Eigen::MatrixXi& F,
+    const double global_dhat,
+    const double distance,
+    VectorMax12d& grad) const
+{
+    const double dhat = local_dhat < 0 ? global_dhat : local_dhat;
+    assert(distance >= 0); // Squared distance
+
+    // ∇b(d(x)) = b'(d(x)) * ∇d(x)
+    const VectorMax12d distance_grad = compute_distance_gradient(V, E, F);
+
+    const double grad_b = Barrier::first_derivative(
+        distance - minimum_distance * minimum_distance,
+        2 * minimum_distance * dhat + dhat * dhat);
+    grad = weight * grad_b * distance_grad;
+}
+
+template <typename Barrier>
+void CollisionConstraint::compute_potential_hessian_T(
+    ConstMatrixXdRef V,
+    const Eigen::MatrixXi& E,
+    const Eigen::MatrixXi& F,
+    const double global_dhat,
+    const bool project_hessian_to_psd,
+    MatrixMax12d& hess) const
+{
+    const double dhat = local_dhat < 0 ? global_dhat : local_dhat;
+    const double dhat_squared = dhat * dhat;
+    const double min_dist_squrared = minimum_distance * minimum_distance;
+
+    // ∇²[b(d(x))] = ∇(b'(d(x)) * ∇d(x))
+    //             = b"(d(x)) * ∇d(x) * ∇d(x)ᵀ + b'(d(x)) * ∇²d(x)
+
+    const double distance = compute_distance(V, E, F);
+    const VectorMax12d distance_grad = compute_distance_gradient(V, E, F);
+    const MatrixMax12d distance_hess = compute_distance_hessian(V, E, F);
+
+    const double grad_b = Barrier::first_derivative(
+        distance - min_dist_squrared,
+        2 * minimum_distance * dhat + dhat_squared);
+    const double hess_b = Barrier::second_derivative(
+        distance - min_dist_squrared,
+        2 * minimum_distance * dhat + dhat_squared);
+
+    // b"(x) ≥ 0 ⟹ b"(x) * ∇d(x) * ∇d(x)ᵀ is PSD
+    assert(hess_b >= 0);
+    MatrixMax12d term2 = grad_b * distance_hess;
+    if (project_hessian_to_psd) {
+        term2 = project_to_psd(term2);
+    }
+
+    hess = weight
+        * (hess_b * distance_grad * distance_grad.transpose() + term2);
+}
+
+template <typename Barrier>
+void CollisionConstraint::compute_potential_and_derivatives_T(
+    ConstMatrixXdRef V,
+    const Eigen::MatrixXi& E,
+    const Eigen::MatrixXi& F,
+    const double global_dhat,
+    const bool project_hessian_to_psd,
+    double& potential,
+    VectorMax12d& potential_grad,
+    MatrixMax12d& potential_hess) const
+{
+    const double dhat = local_dhat < 0 ? global_dhat : local_dhat;
+    const double dhat_squared = dhat * dhat;
+    const double min_dist_squrared = minimum_distance * minimum_distance;
+
+    // Compute the distance and its derivatives once and share them between
+    // the potential, its gradient, and its hessian.
+    const double distance = compute_distance(V, E, F); // Squared distance
+    const VectorMax12d distance_grad = compute_distance_gradient(V, E, F);
+    const MatrixMax12d distance_hess = compute_distance_hessian(V, E, F);
+
+    const double b = Barrier::value(
+        distance - min_dist_squrared,
+        2 * minimum_distance * dhat + dhat_squared);
+    const double grad_b = Barrier::first_derivative(
+        distance - min_dist_squrared,
+        2 * minimum_distance * dhat + dhat_squared);
+    const double hess_b = Barrier::second_derivative(
+        distance - min_dist_squrared,
+        2 * minimum_distance * dhat + dhat_squared);
+
+    potential = weight * b;
+
+    // ∇b(d(x)) = b'(d(x)) * ∇d(x)
+    potential_grad = weight * grad_b * distance_grad;
+
+    // ∇²[b(d(x))] = b"(d(x)) * ∇d(x) * ∇d(x)ᵀ + b'(d(x)) * ∇²d(x)
+    // b"(x) ≥ 0 ⟹ b"(x) * ∇d(x) * ∇d(x)ᵀ is PSD
+    assert(hess_b >= 0);
+    MatrixMax12d term1 = hess_b * distance_grad * distance_grad.transpose();
+    MatrixMax12d term2 = grad_b * distance_hess;
+    if (project_hessian_to_psd) {
+        term2 = project_to_psd(term2);
+    }
+    potential_hess = weight * (term1 + term2);
+}
+
+} // namespace ipc
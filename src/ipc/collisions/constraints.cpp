@@ -1,28 +1,42 @@
 #include "constraints.hpp"
 
+#include <ipc/collisions/narrow_phase_gpu.hpp>
+#include <ipc/utils/execution_context.hpp>
+#include <ipc/utils/memory_usage.hpp>
+#include <ipc/utils/profiler.hpp>
 #include <ipc/distance/point_edge.hpp>
 #include <ipc/distance/edge_edge.hpp>
 #include <ipc/distance/edge_edge_mollifier.hpp>
 #include <ipc/distance/point_triangle.hpp>
-#include <ipc/utils/unordered_map_and_set.hpp>
 
 #include <tbb/parallel_for.h>
+#include <tbb/parallel_reduce.h>
+#include <tbb/parallel_sort.h>
 #include <tbb/blocked_range.h>
 #include <tbb/enumerable_thread_specific.h>
 
+#include <cstdint>   // uint64_t
+#include <limits>    // std::numeric_limits
 #include <stdexcept> // std::out_of_range
 
 namespace ipc {
 
 void Constraints::build(
     const CollisionMesh& mesh,
-    const Eigen::MatrixXd& V,
+    ConstMatrixXdRef V,
     const double dhat,
     const double dmin,
     const BroadPhaseMethod method)
 {
     assert(V.rows() == mesh.num_vertices());
 
+    if (vertex_dhat.size() > 0) {
+        // The per-vertex inflation radii are wired through a BroadPhase
+        // object, so route through the caller-owned-broad-phase overload.
+        build(*BroadPhase::make_broad_phase(method), mesh, V, dhat, dmin);
+        return;
+    }
+
     double inflation_radius = (dhat + dmin) / 1.99; // Conservative inflation
 
     Candidates candidates;
@@ -32,60 +46,192 @@ void Constraints::build(
     build(candidates, mesh, V, dhat, dmin);
 }
 
+void Constraints::build(
+    BroadPhase& broad_phase,
+    const CollisionMesh& mesh,
+    ConstMatrixXdRef V,
+    const double dhat,
+    const double dmin)
+{
+    assert(V.rows() == mesh.num_vertices());
+
+    const double inflation_radius =
+        set_vertex_inflation_radii(broad_phase, V, dhat, dmin);
+
+    Candidates candidates;
+    construct_collision_candidates(
+        broad_phase, mesh, V, candidates, inflation_radius);
+
+    build(candidates, mesh, V, dhat, dmin);
+}
+
+double Constraints::set_vertex_inflation_radii(
+    BroadPhase& broad_phase,
+    ConstMatrixXdRef V,
+    const double dhat,
+    const double dmin) const
+{
+    if (vertex_dhat.size() == 0) {
+        broad_phase.vertex_inflation_radii.resize(0);
+        return (dhat + dmin) / 1.99; // Conservative inflation
+    }
+
+    assert(vertex_dhat.size() == V.rows());
+    assert(vertex_dhat.minCoeff() >= 0);
+    // A pair activates at the maximum of its vertices' dhats, but each box
+    // only knows its own vertex's dhat, so each must carry enough margin on
+    // its own: 2 r_i ≥ dhat_i + dmin guarantees r_a + r_b ≥ max(dhat_a,
+    // dhat_b) + dmin for every pair, whichever side has the larger dhat.
+    broad_phase.vertex_inflation_radii =
+        (2 * vertex_dhat.array() + dmin) / 1.99;
+    return (2 * vertex_dhat.maxCoeff() + dmin) / 1.99;
+}
+
+void Constraints::update(
+    BroadPhase& broad_phase,
+    const CollisionMesh& mesh,
+    ConstMatrixXdRef V,
+    const double dhat,
+    const double dmin)
+{
+    assert(V.rows() == mesh.num_vertices());
+
+    const double inflation_radius =
+        set_vertex_inflation_radii(broad_phase, V, dhat, dmin);
+
+    // While the broad phase does not need a rebuild, every vertex has moved
+    // less than the build margin since the cached candidates were detected,
+    // so they are still a superset of all pairs within dhat and only the
+    // narrow phase has to rerun.
+    if (!m_candidates_are_cached
+        || broad_phase.needs_rebuild(V, inflation_radius)) {
+        construct_collision_candidates(
+            broad_phase, mesh, V, m_cached_candidates, inflation_radius);
+        m_candidates_are_cached = true;
+    }
+
+    build(m_cached_candidates, mesh, V, dhat, dmin);
+}
+
 void Constraints::build(
     const Candidates& candidates,
     const CollisionMesh& mesh,
-    const Eigen::MatrixXd& V,
+    ConstMatrixXdRef V,
     const double dhat,
     const double dmin)
 {
+    IPC_PROFILE_SCOPE("Constraints::build");
+
     assert(V.rows() == mesh.num_vertices());
 
+    if (candidate_budget >= 0 && candidates.size() > size_t(candidate_budget)) {
+        // Keep only the candidates with the smallest AABB gaps so the worst
+        // contacts survive the truncation; the recursive build sees a set
+        // within budget and takes the branch below.
+        Candidates kept = candidates;
+        const size_t num_dropped = kept.reduce_to_worst(
+            V, mesh.edges(), mesh.faces(), size_t(candidate_budget));
+        build(kept, mesh, V, dhat, dmin);
+        m_num_truncated_candidates = num_dropped;
+        return;
+    }
+    m_num_truncated_candidates = 0;
+
     clear();
 
-    // Cull the candidates by measuring the distance and dropping those that are
-    // greater than dhat.
-    const double offset_sqr = (dmin + dhat) * (dmin + dhat);
-    auto is_active = [&](double distance_sqr) {
+#ifdef IPC_TOOLKIT_WITH_CUDA
+    // Optionally cull the candidates on the device first: every candidate's
+    // closest-feature distance is evaluated on the GPU and only the
+    // compacted active subset comes back, so the conversion loops and the
+    // merge below touch the few percent of candidates within their
+    // activation distance. The loops reevaluate the survivors, re-deriving
+    // the exact distance types and cached distances, so the built set
+    // matches the CPU-only path.
+    Candidates gpu_active;
+    const bool gpu_culled =
+        use_gpu_narrow_phase && V.cols() == 3 && !candidates.empty();
+    if (gpu_culled) {
+        IPC_PROFILE_SCOPE("Constraints::build:gpu_narrow_phase");
+        if (m_narrow_phase_gpu == nullptr) {
+            m_narrow_phase_gpu = std::make_shared<NarrowPhaseGPU>();
+        }
+        m_narrow_phase_gpu->cull(
+            candidates, mesh, V, dhat, dmin, vertex_dhat, gpu_active);
+    }
+    const Candidates& narrow_candidates =
+        gpu_culled ? gpu_active : candidates;
+#else
+    const Candidates& narrow_candidates = candidates;
+#endif
+
+    // Cull the candidates by measuring the distance and dropping those that
+    // are greater than dhat. The squared threshold is computed per candidate
+    // inside the loops (it is uniform unless vertex_dhat is set) and the
+    // predicate is passed as a template parameter so the comparison inlines
+    // into the candidate loops.
+    auto is_active = [](double distance_sqr, double offset_sqr) {
         return distance_sqr < offset_sqr;
     };
 
-    tbb::enumerable_thread_specific<Builder> storage;
-
-    tbb::parallel_for(
-        tbb::blocked_range<size_t>(size_t(0), candidates.ev_candidates.size()),
-        [&](const tbb::blocked_range<size_t>& r) {
-            edge_vertex_candiates_to_constraints(
-                mesh, V, candidates.ev_candidates, is_active, r.begin(),
-                r.end(), storage.local());
-        });
-
-    tbb::parallel_for(
-        tbb::blocked_range<size_t>(size_t(0), candidates.ee_candidates.size()),
-        [&](const tbb::blocked_range<size_t>& r) {
-            edge_edge_candiates_to_constraints(
-                mesh, V, candidates.ee_candidates, is_active, r.begin(),
-                r.end(), storage.local());
-        });
-
-    tbb::parallel_for(
-        tbb::blocked_range<size_t>(size_t(0), candidates.fv_candidates.size()),
-        [&](const tbb::blocked_range<size_t>& r) {
-            face_vertex_candiates_to_constraints(
-                mesh, V, candidates.fv_candidates, is_active, r.begin(),
-                r.end(), storage.local());
-        });
+    if (use_convergent_formulation && compute_shape_derivatives) {
+        // The area jacobians are computed lazily and the first computation is
+        // not thread-safe, so fill the tables before the parallel loops below
+        // query them.
+        mesh.prepare_area_jacobians();
+    }
 
-    merge_thread_local_constraints(storage);
+    if (m_builder_storage == nullptr) {
+        m_builder_storage = std::make_shared<BuilderStorage>();
+    }
+    // Reuse the per-thread Builders: clear() keeps the vectors' capacities,
+    // so steady-state builds append into already-allocated storage.
+    for (Builder& builder : m_builder_storage->storage) {
+        builder.constraint_set.clear();
+    }
 
-    // This is the dhat that is used in the barrier potential (because we use
-    // squared distances).
-    const double effective_dhat = 2 * dmin * dhat + dhat * dhat;
+    execution_context().run([&] {
+        tbb::enumerable_thread_specific<Builder>& storage =
+            m_builder_storage->storage;
+
+        tbb::parallel_for(
+            tbb::blocked_range<size_t>(
+                size_t(0), narrow_candidates.ev_candidates.size()),
+            [&](const tbb::blocked_range<size_t>& r) {
+                edge_vertex_candiates_to_constraints(
+                    mesh, V, narrow_candidates.ev_candidates, is_active, dhat,
+                    dmin, r.begin(), r.end(), storage.local());
+            });
+
+        tbb::parallel_for(
+            tbb::blocked_range<size_t>(
+                size_t(0), narrow_candidates.ee_candidates.size()),
+            [&](const tbb::blocked_range<size_t>& r) {
+                edge_edge_candiates_to_constraints(
+                    mesh, V, narrow_candidates.ee_candidates, is_active, dhat,
+                    dmin, r.begin(), r.end(), storage.local());
+            });
+
+        tbb::parallel_for(
+            tbb::blocked_range<size_t>(
+                size_t(0), narrow_candidates.fv_candidates.size()),
+            [&](const tbb::blocked_range<size_t>& r) {
+                face_vertex_candiates_to_constraints(
+                    mesh, V, narrow_candidates.fv_candidates, is_active, dhat,
+                    dmin, r.begin(), r.end(), storage.local());
+            });
+
+        merge_thread_local_constraints(storage);
+    });
 
     for (size_t ci = 0; ci < size(); ci++) {
         CollisionConstraint& constraint = (*this)[ci];
         constraint.minimum_distance = dmin;
         if (use_convergent_formulation) {
+            const double c_dhat =
+                constraint.local_dhat < 0 ? dhat : constraint.local_dhat;
+            // This is the dhat that is used in the barrier potential
+            // (because we use squared distances).
+            const double effective_dhat = 2 * dmin * c_dhat + c_dhat * c_dhat;
             // Divide by dhat to equivalently use the "physical" barrier
             constraint.weight /= effective_dhat;
             if (compute_shape_derivatives) {
@@ -93,6 +239,63 @@ void Constraints::build(
             }
         }
     }
+
+    if (use_vertex_locality_ordering) {
+        sort_constraints_by_min_vertex(mesh.edges(), mesh.faces());
+    }
+
+    // The distances cached on the constraints were computed from V.
+    m_cached_distance_V = V;
+}
+
+void Constraints::sort_constraints_by_min_vertex(
+    const Eigen::MatrixXi& E, const Eigen::MatrixXi& F)
+{
+    IPC_PROFILE_SCOPE("Constraints::sort_constraints_by_min_vertex");
+
+    const auto sort_vector = [&](auto& constraints) {
+        if (constraints.size() <= 1) {
+            return;
+        }
+
+        // Decorate with (key, index) pairs so the constraints themselves are
+        // moved once; ties keep their merge order because the index breaks
+        // them, so the result is deterministic.
+        std::vector<std::pair<index_t, size_t>> order(constraints.size());
+        tbb::parallel_for(size_t(0), constraints.size(), [&](const size_t i) {
+            const std::array<index_t, 4> ids =
+                constraints[i].vertex_indices(E, F);
+            index_t key = std::numeric_limits<index_t>::max();
+            for (const index_t id : ids) {
+                if (id >= 0) {
+                    key = std::min(key, id);
+                }
+            }
+            order[i] = std::make_pair(key, i);
+        });
+        tbb::parallel_sort(order.begin(), order.end());
+
+        std::decay_t<decltype(constraints)> sorted;
+        sorted.reserve(constraints.size());
+        for (const auto& [key, i] : order) {
+            sorted.push_back(std::move(constraints[i]));
+        }
+        constraints = std::move(sorted);
+    };
+
+    execution_context().run([&] {
+        sort_vector(vv_constraints);
+        sort_vector(ev_constraints);
+        sort_vector(ee_constraints);
+        sort_vector(fv_constraints);
+        sort_vector(pv_constraints);
+    });
+}
+
+bool Constraints::are_cached_distances_valid(ConstMatrixXdRef V) const
+{
+    return m_cached_distance_V.rows() == V.rows()
+        && m_cached_distance_V.cols() == V.cols() && m_cached_distance_V == V;
 }
 
 size_t Constraints::size() const
@@ -115,6 +318,136 @@ void Constraints::clear()
     ee_constraints.clear();
     fv_constraints.clear();
     pv_constraints.clear();
+    m_cached_distance_V.resize(0, 0);
+    m_scatter_coloring.classes.clear();
+    m_scatter_coloring.valid = false;
+    for (std::vector<size_t>& bucket : m_ee_type_buckets.by_type) {
+        bucket.clear();
+    }
+    m_ee_type_buckets.V.resize(0, 0);
+}
+
+const Constraints::ScatterColoring& Constraints::scatter_coloring(
+    const Eigen::MatrixXi& E, const Eigen::MatrixXi& F) const
+{
+    if (m_scatter_coloring.valid) {
+        return m_scatter_coloring;
+    }
+
+    // Greedy first-fit coloring: each constraint takes the lowest color not
+    // already used by a constraint sharing one of its vertices. The
+    // per-vertex masks track the first 64 colors; a constraint whose
+    // vertices exhaust all of them (a vertex with >= 64 incident
+    // constraints) gets its own fresh class, which is trivially
+    // conflict-free because that color is never reused.
+    std::vector<std::vector<size_t>> colored;
+    std::vector<size_t> overflow;
+    std::vector<uint64_t> used_colors; // grown on demand
+
+    for_each(0, size(), [&](const auto& constraint, const size_t i) {
+        const std::array<index_t, 4> ids = constraint.vertex_indices(E, F);
+        const int num_vertices = constraint.num_vertices();
+
+        uint64_t used = 0;
+        for (int k = 0; k < num_vertices; k++) {
+            assert(ids[k] >= 0);
+            if (size_t(ids[k]) >= used_colors.size()) {
+                used_colors.resize(ids[k] + 1, 0);
+            }
+            used |= used_colors[ids[k]];
+        }
+
+        if (~used == 0) {
+            overflow.push_back(i);
+            return;
+        }
+
+        int color = 0;
+        while ((used >> color) & 1) {
+            color++;
+        }
+        if (size_t(color) >= colored.size()) {
+            colored.resize(color + 1);
+        }
+        colored[color].push_back(i);
+
+        const uint64_t color_bit = uint64_t(1) << color;
+        for (int k = 0; k < num_vertices; k++) {
+            used_colors[ids[k]] |= color_bit;
+        }
+    });
+
+    m_scatter_coloring.classes = std::move(colored);
+    for (const size_t i : overflow) {
+        m_scatter_coloring.classes.emplace_back(1, i);
+    }
+    m_scatter_coloring.valid = true;
+    return m_scatter_coloring;
+}
+
+const Constraints::EdgeEdgeTypeBuckets& Constraints::edge_edge_type_buckets(
+    ConstMatrixXdRef V, const Eigen::MatrixXi& E) const
+{
+    if (m_ee_type_buckets.V.rows() == V.rows()
+        && m_ee_type_buckets.V.cols() == V.cols()
+        && m_ee_type_buckets.V == V) {
+        return m_ee_type_buckets;
+    }
+
+    IPC_PROFILE_SCOPE("Constraints::edge_edge_type_buckets");
+
+    // Classify in parallel — each constraint verifies its warm-start hint
+    // before falling back to the full cascade (see edge_edge_distance_type)
+    // — then fill the buckets serially so each stays in index order.
+    std::vector<EdgeEdgeDistanceType> dtypes(ee_constraints.size());
+    execution_context().run([&] {
+        tbb::parallel_for(size_t(0), ee_constraints.size(), [&](size_t i) {
+            const EdgeEdgeConstraint& ee = ee_constraints[i];
+            dtypes[i] = edge_edge_distance_type(
+                V.row(E(ee.edge0_index, 0)), V.row(E(ee.edge0_index, 1)),
+                V.row(E(ee.edge1_index, 0)), V.row(E(ee.edge1_index, 1)),
+                ee.dtype_hint);
+            ee.dtype_hint = dtypes[i];
+        });
+    });
+
+    for (std::vector<size_t>& bucket : m_ee_type_buckets.by_type) {
+        bucket.clear();
+    }
+    for (size_t i = 0; i < ee_constraints.size(); i++) {
+        m_ee_type_buckets.by_type[size_t(dtypes[i])].push_back(i);
+    }
+    m_ee_type_buckets.V = V;
+    return m_ee_type_buckets;
+}
+
+size_t Constraints::bytes_used() const
+{
+    // The weight gradients are separate heap allocations per constraint, so
+    // the vectors' element sizes alone undercount shape-derivative builds.
+    const auto weight_gradient_bytes = [](const auto& constraints) {
+        size_t bytes = 0;
+        for (const auto& constraint : constraints) {
+            bytes += sparse_vector_bytes_used(constraint.weight_gradient);
+        }
+        return bytes;
+    };
+
+    const size_t bytes = vector_bytes_used(vv_constraints)
+        + vector_bytes_used(ev_constraints)
+        + vector_bytes_used(ee_constraints)
+        + vector_bytes_used(fv_constraints)
+        + vector_bytes_used(pv_constraints)
+        + weight_gradient_bytes(vv_constraints)
+        + weight_gradient_bytes(ev_constraints)
+        + weight_gradient_bytes(ee_constraints)
+        + weight_gradient_bytes(fv_constraints)
+        + weight_gradient_bytes(pv_constraints)
+        + m_cached_candidates.bytes_used()
+        + matrix_bytes_used(m_cached_distance_V)
+        + matrix_bytes_used(vertex_dhat);
+    m_peak_bytes_used = std::max(m_peak_bytes_used, bytes);
+    return bytes;
 }
 
 CollisionConstraint& Constraints::operator[](size_t idx)
@@ -168,91 +501,161 @@ const CollisionConstraint& Constraints::operator[](size_t idx) const
 ///////////////////////////////////////////////////////////////////////////////
 
 struct Constraints::Builder {
-    // Store the indices to VV and EV pairs to avoid duplicates.
-    unordered_map<VertexVertexConstraint, long> vv_to_index;
-    unordered_map<EdgeVertexConstraint, long> ev_to_index;
+    // Duplicate VV and EV pairs are appended as-is and merged by a
+    // sort-and-unique pass in merge_thread_local_constraints.
     Constraints constraint_set;
 };
 
+struct Constraints::BuilderStorage {
+    tbb::enumerable_thread_specific<Builder> storage;
+};
+
 namespace {
 
-    template <typename Hash>
+    /// @brief Maximum per-vertex dhat over a stencil's vertices (-1 when the
+    /// vector is unset, i.e. the uniform dhat applies; see
+    /// CollisionConstraint::local_dhat).
+    template <typename... VertexIDs>
+    double stencil_dhat(
+        const Eigen::VectorXd& vertex_dhat, const VertexIDs... vis)
+    {
+        if (vertex_dhat.size() == 0) {
+            return -1;
+        }
+        double dhat = 0;
+        ((dhat = std::max(dhat, vertex_dhat[vis])), ...);
+        return dhat;
+    }
+
     void add_vertex_vertex_constraint(
         std::vector<VertexVertexConstraint>& vv_constraints,
-        unordered_map<VertexVertexConstraint, long, Hash>& vv_to_index,
         const long v0i,
         const long v1i,
+        const double distance_sqr,
         const double weight,
-        const Eigen::SparseVector<double>& weight_gradient)
+        const Eigen::SparseVector<double>& weight_gradient,
+        const Eigen::VectorXd& vertex_dhat)
     {
-        VertexVertexConstraint vv_constraint(v0i, v1i);
-        auto found_item = vv_to_index.find(vv_constraint);
-        if (found_item != vv_to_index.end()) {
-            // Constraint already exists, so increase weight
-            vv_constraints[found_item->second].weight += weight;
-            vv_constraints[found_item->second].weight_gradient +=
-                weight_gradient;
-        } else {
-            // New constraint, so add it to the end of vv_constraints
-            vv_to_index.emplace(vv_constraint, vv_constraints.size());
-            vv_constraints.push_back(vv_constraint);
-            vv_constraints.back().weight = weight;
-            vv_constraints.back().weight_gradient = weight_gradient;
-        }
+        vv_constraints.emplace_back(v0i, v1i);
+        vv_constraints.back().cached_distance = distance_sqr;
+        vv_constraints.back().weight = weight;
+        vv_constraints.back().weight_gradient = weight_gradient;
+        // Stamp from the constraint's own vertices (not the candidate's), so
+        // duplicates collapsed by different candidates agree on the value.
+        vv_constraints.back().local_dhat = stencil_dhat(vertex_dhat, v0i, v1i);
     }
 
-    template <typename Hash>
     void add_edge_vertex_constraint(
         std::vector<EdgeVertexConstraint>& ev_constraints,
-        unordered_map<EdgeVertexConstraint, long, Hash>& ev_to_index,
+        const Eigen::MatrixXi& E,
         const long ei,
         const long vi,
+        const double distance_sqr,
         const double weight,
-        const Eigen::SparseVector<double>& weight_gradient)
+        const Eigen::SparseVector<double>& weight_gradient,
+        const Eigen::VectorXd& vertex_dhat)
+    {
+        ev_constraints.emplace_back(ei, vi);
+        ev_constraints.back().cached_distance = distance_sqr;
+        ev_constraints.back().weight = weight;
+        ev_constraints.back().weight_gradient = weight_gradient;
+        ev_constraints.back().local_dhat =
+            stencil_dhat(vertex_dhat, vi, long(E(ei, 0)), long(E(ei, 1)));
+    }
+
+    /// @brief Append the constraints of one set onto the end of another.
+    void append_constraints(Constraints& to, const Constraints& from)
+    {
+        to.vv_constraints.insert(
+            to.vv_constraints.end(), from.vv_constraints.begin(),
+            from.vv_constraints.end());
+        to.ev_constraints.insert(
+            to.ev_constraints.end(), from.ev_constraints.begin(),
+            from.ev_constraints.end());
+        to.ee_constraints.insert(
+            to.ee_constraints.end(), from.ee_constraints.begin(),
+            from.ee_constraints.end());
+        to.fv_constraints.insert(
+            to.fv_constraints.end(), from.fv_constraints.begin(),
+            from.fv_constraints.end());
+    }
+
+    /// @brief Merge duplicate constraints in place, summing their weights.
+    ///
+    /// Sorts packed 64-bit keys of the constraints in parallel and combines
+    /// runs of equal keys, which is considerably faster than hashing each
+    /// constraint into a map when there are millions of candidates.
+    /// @param constraints Constraints to deduplicate.
+    /// @param pack_key Function packing a constraint into a 64-bit key such
+    ///                 that two constraints are duplicates iff keys are equal.
+    template <typename Constraint, typename PackKey>
+    void merge_duplicate_constraints(
+        std::vector<Constraint>& constraints, const PackKey& pack_key)
     {
-        EdgeVertexConstraint ev_constraint(ei, vi);
-        auto found_item = ev_to_index.find(ev_constraint);
-        if (found_item != ev_to_index.end()) {
-            // Constraint already exists, so increase weight
-            ev_constraints[found_item->second].weight += weight;
-            ev_constraints[found_item->second].weight_gradient +=
-                weight_gradient;
-        } else {
-            // New constraint, so add it to the end of vv_constraints
-            ev_to_index.emplace(ev_constraint, ev_constraints.size());
-            ev_constraints.push_back(ev_constraint);
-            ev_constraints.back().weight = weight;
-            ev_constraints.back().weight_gradient = weight_gradient;
+        if (constraints.empty()) {
+            return;
+        }
+
+        // Sort (key, index) pairs so the first inserted duplicate comes first
+        // in each run and is the one kept, matching the map-based insertion.
+        std::vector<std::pair<uint64_t, size_t>> keys(constraints.size());
+        tbb::parallel_for(size_t(0), constraints.size(), [&](size_t i) {
+            keys[i] = std::make_pair(pack_key(constraints[i]), i);
+        });
+        tbb::parallel_sort(keys.begin(), keys.end());
+
+        std::vector<Constraint> merged;
+        merged.reserve(constraints.size());
+        for (size_t i = 0; i < keys.size(); i++) {
+            if (i == 0 || keys[i].first != keys[i - 1].first) {
+                merged.push_back(constraints[keys[i].second]);
+            } else {
+                const Constraint& duplicate = constraints[keys[i].second];
+                merged.back().weight += duplicate.weight;
+                merged.back().weight_gradient += duplicate.weight_gradient;
+            }
         }
+        constraints = std::move(merged);
     }
 
 } // namespace
 
+template <typename IsActive>
 void Constraints::edge_vertex_candiates_to_constraints(
     const CollisionMesh& mesh,
-    const Eigen::MatrixXd& V,
+    ConstMatrixXdRef V,
     const std::vector<EdgeVertexCandidate>& candidates,
-    const std::function<bool(double)>& is_active,
+    const IsActive& is_active,
+    const double dhat,
+    const double dmin,
     const size_t start_i,
     const size_t end_i,
     Builder& constraint_builder) const
 {
-    auto& [vv_to_index, ev_to_index, constraint_set] = constraint_builder;
-    auto& C_vv = constraint_set.vv_constraints;
-    auto& C_ev = constraint_set.ev_constraints;
+    auto& C_vv = constraint_builder.constraint_set.vv_constraints;
+    auto& C_ev = constraint_builder.constraint_set.ev_constraints;
     const Eigen::MatrixXi& E = mesh.edges();
 
+    const double uniform_offset_sqr = (dmin + dhat) * (dmin + dhat);
+
     for (size_t i = start_i; i < end_i; i++) {
         const auto& [ei, vi] = candidates[i];
         long e0i = E(ei, 0), e1i = E(ei, 1);
 
+        // The candidate activates at the maximum of its vertices' dhats
+        // (-1 when vertex_dhat is unset, i.e. the uniform dhat applies).
+        const double candidate_dhat = stencil_dhat(vertex_dhat, vi, e0i, e1i);
+        const double offset_sqr = candidate_dhat < 0
+            ? uniform_offset_sqr
+            : (dmin + candidate_dhat) * (dmin + candidate_dhat);
+
         PointEdgeDistanceType dtype =
             point_edge_distance_type(V.row(vi), V.row(e0i), V.row(e1i));
 
         double distance_sqr =
             point_edge_distance(V.row(vi), V.row(e0i), V.row(e1i), dtype);
 
-        if (!is_active(distance_sqr))
+        if (!is_active(distance_sqr, offset_sqr))
             continue;
 
         // ÷ 2 to handle double counting for correct integration
@@ -269,53 +672,66 @@ void Constraints::edge_vertex_candiates_to_constraints(
         switch (dtype) {
         case PointEdgeDistanceType::P_E0:
             add_vertex_vertex_constraint(
-                C_vv, vv_to_index, vi, e0i, weight, weight_gradient);
+                C_vv, vi, e0i, distance_sqr, weight, weight_gradient,
+                vertex_dhat);
             break;
 
         case PointEdgeDistanceType::P_E1:
             add_vertex_vertex_constraint(
-                C_vv, vv_to_index, vi, e1i, weight, weight_gradient);
+                C_vv, vi, e1i, distance_sqr, weight, weight_gradient,
+                vertex_dhat);
             break;
 
         case PointEdgeDistanceType::P_E:
             // ev_candidates is a set, so no duplicate EV constraints
             C_ev.emplace_back(ei, vi);
+            C_ev.back().cached_distance = distance_sqr;
             C_ev.back().weight = weight;
             C_ev.back().weight_gradient = weight_gradient;
-            ev_to_index.emplace(C_ev.back(), C_ev.size() - 1);
+            C_ev.back().local_dhat = candidate_dhat;
             break;
         }
     }
 }
 
+template <typename IsActive>
 void Constraints::edge_edge_candiates_to_constraints(
     const CollisionMesh& mesh,
-    const Eigen::MatrixXd& V,
+    ConstMatrixXdRef V,
     const std::vector<EdgeEdgeCandidate>& candidates,
-    const std::function<bool(double)>& is_active,
+    const IsActive& is_active,
+    const double dhat,
+    const double dmin,
     const size_t start_i,
     const size_t end_i,
     Builder& constraint_builder) const
 {
-    auto& [vv_to_index, ev_to_index, constraint_set] = constraint_builder;
-    auto& C_vv = constraint_set.vv_constraints;
-    auto& C_ev = constraint_set.ev_constraints;
-    auto& C_ee = constraint_set.ee_constraints;
-    const Eigen::MatrixXd& V_rest = mesh.vertices_at_rest();
+    auto& C_vv = constraint_builder.constraint_set.vv_constraints;
+    auto& C_ev = constraint_builder.constraint_set.ev_constraints;
+    auto& C_ee = constraint_builder.constraint_set.ee_constraints;
     const Eigen::MatrixXi& E = mesh.edges();
 
+    const double uniform_offset_sqr = (dmin + dhat) * (dmin + dhat);
+
     for (size_t i = start_i; i < end_i; i++) {
         const auto& [eai, ebi] = candidates[i];
         long ea0i = E(eai, 0), ea1i = E(eai, 1);
         long eb0i = E(ebi, 0), eb1i = E(ebi, 1);
 
-        EdgeEdgeDistanceType dtype = edge_edge_distance_type(
-            V.row(ea0i), V.row(ea1i), V.row(eb0i), V.row(eb1i));
-
-        double distance_sqr = edge_edge_distance(
-            V.row(ea0i), V.row(ea1i), V.row(eb0i), V.row(eb1i), dtype);
-
-        if (!is_active(distance_sqr))
+        const double candidate_dhat =
+            stencil_dhat(vertex_dhat, ea0i, ea1i, eb0i, eb1i);
+        const double offset_sqr = candidate_dhat < 0
+            ? uniform_offset_sqr
+            : (dmin + candidate_dhat) * (dmin + candidate_dhat);
+
+        // Exits early on cheap lower bounds before computing the exact
+        // distance; most candidates from the broad phase are culled here.
+        EdgeEdgeDistanceType dtype;
+        double distance_sqr;
+        if (!edge_edge_distance_is_within(
+                V.row(ea0i), V.row(ea1i), V.row(eb0i), V.row(eb1i),
+                offset_sqr, dtype, distance_sqr)
+            || !is_active(distance_sqr, offset_sqr))
             continue;
 
         // ÷ 4 to handle double counting and PT + EE for correct integration.
@@ -332,9 +748,7 @@ void Constraints::edge_edge_candiates_to_constraints(
                 : Eigen::SparseVector<double>(V.size());
         }
 
-        double eps_x = edge_edge_mollifier_threshold(
-            V_rest.row(ea0i), V_rest.row(ea1i), //
-            V_rest.row(eb0i), V_rest.row(eb1i));
+        double eps_x = mesh.edge_edge_mollifier_threshold(eai, ebi);
         double ee_cross_norm_sqr = edge_edge_cross_squarednorm(
             V.row(ea0i), V.row(ea1i), V.row(eb0i), V.row(eb1i));
         if (ee_cross_norm_sqr < eps_x) {
@@ -346,81 +760,102 @@ void Constraints::edge_edge_candiates_to_constraints(
         switch (dtype) {
         case EdgeEdgeDistanceType::EA0_EB0:
             add_vertex_vertex_constraint(
-                C_vv, vv_to_index, ea0i, eb0i, weight, weight_gradient);
+                C_vv, ea0i, eb0i, distance_sqr, weight, weight_gradient,
+                vertex_dhat);
             break;
 
         case EdgeEdgeDistanceType::EA0_EB1:
             add_vertex_vertex_constraint(
-                C_vv, vv_to_index, ea0i, eb1i, weight, weight_gradient);
+                C_vv, ea0i, eb1i, distance_sqr, weight, weight_gradient,
+                vertex_dhat);
             break;
 
         case EdgeEdgeDistanceType::EA1_EB0:
             add_vertex_vertex_constraint(
-                C_vv, vv_to_index, ea1i, eb0i, weight, weight_gradient);
+                C_vv, ea1i, eb0i, distance_sqr, weight, weight_gradient,
+                vertex_dhat);
             break;
 
         case EdgeEdgeDistanceType::EA1_EB1:
             add_vertex_vertex_constraint(
-                C_vv, vv_to_index, ea1i, eb1i, weight, weight_gradient);
+                C_vv, ea1i, eb1i, distance_sqr, weight, weight_gradient,
+                vertex_dhat);
             break;
 
         case EdgeEdgeDistanceType::EA_EB0:
             add_edge_vertex_constraint(
-                C_ev, ev_to_index, eai, eb0i, weight, weight_gradient);
+                C_ev, E, eai, eb0i, distance_sqr, weight, weight_gradient,
+                vertex_dhat);
             break;
 
         case EdgeEdgeDistanceType::EA_EB1:
             add_edge_vertex_constraint(
-                C_ev, ev_to_index, eai, eb1i, weight, weight_gradient);
+                C_ev, E, eai, eb1i, distance_sqr, weight, weight_gradient,
+                vertex_dhat);
             break;
 
         case EdgeEdgeDistanceType::EA0_EB:
             add_edge_vertex_constraint(
-                C_ev, ev_to_index, ebi, ea0i, weight, weight_gradient);
+                C_ev, E, ebi, ea0i, distance_sqr, weight, weight_gradient,
+                vertex_dhat);
             break;
 
         case EdgeEdgeDistanceType::EA1_EB:
             add_edge_vertex_constraint(
-                C_ev, ev_to_index, ebi, ea1i, weight, weight_gradient);
+                C_ev, E, ebi, ea1i, distance_sqr, weight, weight_gradient,
+                vertex_dhat);
             break;
 
         case EdgeEdgeDistanceType::EA_EB:
             C_ee.emplace_back(eai, ebi, eps_x);
+            C_ee.back().cached_distance = distance_sqr;
             C_ee.back().weight = weight;
             C_ee.back().weight_gradient = weight_gradient;
+            C_ee.back().local_dhat = candidate_dhat;
             break;
         }
     }
 }
 
+template <typename IsActive>
 void Constraints::face_vertex_candiates_to_constraints(
     const CollisionMesh& mesh,
-    const Eigen::MatrixXd& V,
+    ConstMatrixXdRef V,
     const std::vector<FaceVertexCandidate>& candidates,
-    const std::function<bool(double)>& is_active,
+    const IsActive& is_active,
+    const double dhat,
+    const double dmin,
     const size_t start_i,
     const size_t end_i,
     Builder& constraint_builder) const
 {
-    auto& [vv_to_index, ev_to_index, constraint_set] = constraint_builder;
-    auto& C_vv = constraint_set.vv_constraints;
-    auto& C_ev = constraint_set.ev_constraints;
-    auto& C_fv = constraint_set.fv_constraints;
+    auto& C_vv = constraint_builder.constraint_set.vv_constraints;
+    auto& C_ev = constraint_builder.constraint_set.ev_constraints;
+    auto& C_fv = constraint_builder.constraint_set.fv_constraints;
+    const Eigen::MatrixXi& E = mesh.edges();
     const Eigen::MatrixXi& F = mesh.faces();
     const Eigen::MatrixXi& F2E = mesh.faces_to_edges();
 
+    const double uniform_offset_sqr = (dmin + dhat) * (dmin + dhat);
+
     for (size_t i = start_i; i < end_i; i++) {
         const auto& [fi, vi] = candidates[i];
         long f0i = F(fi, 0), f1i = F(fi, 1), f2i = F(fi, 2);
 
-        // Compute distance type
-        PointTriangleDistanceType dtype = point_triangle_distance_type(
-            V.row(vi), V.row(f0i), V.row(f1i), V.row(f2i));
-
-        double distance_sqr = point_triangle_distance(
-            V.row(vi), V.row(f0i), V.row(f1i), V.row(f2i), dtype);
-
-        if (!is_active(distance_sqr))
+        const double candidate_dhat =
+            stencil_dhat(vertex_dhat, vi, f0i, f1i, f2i);
+        const double offset_sqr = candidate_dhat < 0
+            ? uniform_offset_sqr
+            : (dmin + candidate_dhat) * (dmin + candidate_dhat);
+
+        // Exits early on cheap lower bounds before computing the exact
+        // distance; most candidates from the broad phase are culled here.
+        PointTriangleDistanceType dtype;
+        double distance_sqr;
+        if (!point_triangle_distance_is_within(
+                V.row(vi), V.row(f0i), V.row(f1i), V.row(f2i), offset_sqr,
+                dtype, distance_sqr)
+            || !is_active(distance_sqr, offset_sqr))
             continue;
 
         // ÷ 4 to handle double counting and PT + EE) for correct integration
@@ -437,38 +872,46 @@ void Constraints::face_vertex_candiates_to_constraints(
         switch (dtype) {
         case PointTriangleDistanceType::P_T0:
             add_vertex_vertex_constraint(
-                C_vv, vv_to_index, vi, f0i, weight, weight_gradient);
+                C_vv, vi, f0i, distance_sqr, weight, weight_gradient,
+                vertex_dhat);
             break;
 
         case PointTriangleDistanceType::P_T1:
             add_vertex_vertex_constraint(
-                C_vv, vv_to_index, vi, f1i, weight, weight_gradient);
+                C_vv, vi, f1i, distance_sqr, weight, weight_gradient,
+                vertex_dhat);
             break;
 
         case PointTriangleDistanceType::P_T2:
             add_vertex_vertex_constraint(
-                C_vv, vv_to_index, vi, f2i, weight, weight_gradient);
+                C_vv, vi, f2i, distance_sqr, weight, weight_gradient,
+                vertex_dhat);
             break;
 
         case PointTriangleDistanceType::P_E0:
             add_edge_vertex_constraint(
-                C_ev, ev_to_index, F2E(fi, 0), vi, weight, weight_gradient);
+                C_ev, E, F2E(fi, 0), vi, distance_sqr, weight,
+                weight_gradient, vertex_dhat);
             break;
 
         case PointTriangleDistanceType::P_E1:
             add_edge_vertex_constraint(
-                C_ev, ev_to_index, F2E(fi, 1), vi, weight, weight_gradient);
+                C_ev, E, F2E(fi, 1), vi, distance_sqr, weight,
+                weight_gradient, vertex_dhat);
             break;
 
         case PointTriangleDistanceType::P_E2:
             add_edge_vertex_constraint(
-                C_ev, ev_to_index, F2E(fi, 2), vi, weight, weight_gradient);
+                C_ev, E, F2E(fi, 2), vi, distance_sqr, weight,
+                weight_gradient, vertex_dhat);
             break;
 
         case PointTriangleDistanceType::P_T:
             C_fv.emplace_back(fi, vi);
+            C_fv.back().cached_distance = distance_sqr;
             C_fv.back().weight = weight;
             C_fv.back().weight_gradient = weight_gradient;
+            C_fv.back().local_dhat = candidate_dhat;
             break;
         }
     }
@@ -477,60 +920,46 @@ void Constraints::face_vertex_candiates_to_constraints(
 void Constraints::merge_thread_local_constraints(
     const tbb::enumerable_thread_specific<Builder>& local_storage)
 {
-    unordered_map<VertexVertexConstraint, long> vv_to_index;
-    unordered_map<EdgeVertexConstraint, long> ev_to_index;
-
-    // size up the hash items
-    size_t n_vv = 0, n_ev = 0, n_ee = 0, n_fv = 0;
-    for (const auto& storage : local_storage) {
-        // This is an conservative estimate
-        n_vv += storage.constraint_set.vv_constraints.size();
-        n_ev += storage.constraint_set.ev_constraints.size();
-        n_ee += storage.constraint_set.ee_constraints.size();
-        n_fv += storage.constraint_set.fv_constraints.size();
-    }
-    vv_constraints.reserve(n_vv);
-    ev_constraints.reserve(n_ev);
-    ee_constraints.reserve(n_ee);
-    fv_constraints.reserve(n_fv);
-
-    // merge
+    // concatenate the thread-local sets with a parallel reduction tree so the
+    // merge cost no longer grows linearly with the number of threads
+    std::vector<const Builder*> builders;
+    builders.reserve(local_storage.size());
     for (const auto& storage : local_storage) {
-        const auto& local_constraints = storage.constraint_set;
-
-        if (vv_constraints.empty()) {
-            vv_to_index = storage.vv_to_index;
-            vv_constraints.insert(
-                vv_constraints.end(), local_constraints.vv_constraints.begin(),
-                local_constraints.vv_constraints.end());
-        } else {
-            for (const auto& vv : local_constraints.vv_constraints) {
-                add_vertex_vertex_constraint(
-                    vv_constraints, vv_to_index, vv.vertex0_index,
-                    vv.vertex1_index, vv.weight, vv.weight_gradient);
-            }
-        }
+        builders.push_back(&storage);
+    }
 
-        if (ev_constraints.empty()) {
-            ev_to_index = storage.ev_to_index;
-            ev_constraints.insert(
-                ev_constraints.end(), local_constraints.ev_constraints.begin(),
-                local_constraints.ev_constraints.end());
-        } else {
-            for (const auto& ev : local_constraints.ev_constraints) {
-                add_edge_vertex_constraint(
-                    ev_constraints, ev_to_index, ev.edge_index, ev.vertex_index,
-                    ev.weight, ev.weight_gradient);
+    Constraints merged = tbb::parallel_reduce(
+        tbb::blocked_range<size_t>(size_t(0), builders.size()), Constraints(),
+        [&](const tbb::blocked_range<size_t>& r, Constraints set) {
+            for (size_t i = r.begin(); i < r.end(); i++) {
+                append_constraints(set, builders[i]->constraint_set);
             }
-        }
+            return set;
+        },
+        [](Constraints set_a, const Constraints& set_b) {
+            append_constraints(set_a, set_b);
+            return set_a;
+        });
 
-        ee_constraints.insert(
-            ee_constraints.end(), local_constraints.ee_constraints.begin(),
-            local_constraints.ee_constraints.end());
-        fv_constraints.insert(
-            fv_constraints.end(), local_constraints.fv_constraints.begin(),
-            local_constraints.fv_constraints.end());
-    }
+    vv_constraints = std::move(merged.vv_constraints);
+    ev_constraints = std::move(merged.ev_constraints);
+    ee_constraints = std::move(merged.ee_constraints);
+    fv_constraints = std::move(merged.fv_constraints);
+
+    // The pairwise index comparison of the unordered_map dedup was ordered, so
+    // packing the indices in order produces the same duplicates. EE and FV
+    // pairs are already unique because the candidates are.
+    merge_duplicate_constraints(
+        vv_constraints, [](const VertexVertexConstraint& vv) {
+            assert(vv.vertex0_index >= 0 && vv.vertex1_index >= 0);
+            return (uint64_t(vv.vertex0_index) << 32)
+                | uint64_t(vv.vertex1_index);
+        });
+    merge_duplicate_constraints(
+        ev_constraints, [](const EdgeVertexConstraint& ev) {
+            assert(ev.edge_index >= 0 && ev.vertex_index >= 0);
+            return (uint64_t(ev.edge_index) << 32) | uint64_t(ev.vertex_index);
+        });
 }
 
 } // namespace ipc
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <ipc/config.hpp>
+
 #include <ipc/collision_mesh.hpp>
 #include <ipc/collisions/collision_constraint.hpp>
 #include <ipc/collisions/vertex_vertex.hpp>
@@ -8,15 +10,23 @@
 #include <ipc/collisions/face_vertex.hpp>
 #include <ipc/collisions/plane_vertex.hpp>
 #include <ipc/broad_phase/broad_phase.hpp>
+#include <ipc/utils/eigen_ext.hpp>
 
 #include <Eigen/Core>
 
 #include <tbb/enumerable_thread_specific.h>
 
+#include <algorithm> // std::min/max
+#include <array>
+#include <memory>
 #include <vector>
 
 namespace ipc {
 
+#ifdef IPC_TOOLKIT_WITH_CUDA
+class NarrowPhaseGPU;
+#endif
+
 struct Constraints {
     std::vector<VertexVertexConstraint> vv_constraints;
     std::vector<EdgeVertexConstraint> ev_constraints;
@@ -26,6 +36,117 @@ struct Constraints {
     bool use_convergent_formulation = false;
     bool compute_shape_derivatives = false;
 
+    /// @brief Maximum number of candidates build() will accept (-1 = no limit).
+    ///
+    /// When a pathological frame produces more candidates than this, the
+    /// candidates are ranked by Candidates::reduce_to_worst and only the
+    /// closest candidate_budget are kept, bounding the memory and latency of
+    /// the narrow phase. This trades exactness for predictability: contacts
+    /// beyond the budget are silently dropped, so only enable it for
+    /// interactive deployments that prefer a degraded frame over a stalled
+    /// one. The result is exact whenever the budget is not exceeded; check
+    /// num_truncated_candidates() to see if it was.
+    long candidate_budget = -1;
+
+    /// @brief Scatter gradients through the vertex-disjoint color classes of
+    /// scatter_coloring() instead of thread-local entry lists (see
+    /// compute_barrier_potential_gradient()). The coloring is computed once
+    /// per constraint set and amortized over the iterations evaluated
+    /// against it, so this pays off when the set is reused across many
+    /// gradient calls.
+    bool use_colored_gradient_scatter = false;
+
+    /// @brief Reorder each constraint vector by minimum vertex index after
+    /// build(). The thread-local builders emit the constraints in discovery
+    /// order, so consecutive constraints touch unrelated rows of the
+    /// gradient/hessian and every scatter is a random access over the whole
+    /// dof vector; sorting once per build makes the scatters of all
+    /// subsequent potential passes walk the dofs roughly in order. Pays off
+    /// when the set is evaluated more often than it is rebuilt.
+    bool use_vertex_locality_ordering = false;
+
+    /// @brief Evaluate the edge-edge constraints one closest-feature type at
+    /// a time in the gradient and hessian assemblies (see
+    /// edge_edge_type_buckets()). Each of the nine EdgeEdgeDistanceType
+    /// values runs different distance code, so iterating a mixed stream
+    /// mispredicts the dispatch on nearly every constraint; classifying once
+    /// per evaluated position set and looping over homogeneous buckets makes
+    /// the branch perfectly predicted (and warms every constraint's
+    /// dtype_hint as a side effect). The colored-scatter and deterministic
+    /// paths keep their own iteration orders and ignore the buckets.
+    bool use_edge_edge_type_bucketing = false;
+
+    /// @brief Cull the broad-phase candidates on the GPU during build().
+    ///
+    /// Evaluating every candidate's closest-feature distance just to discard
+    /// it dominates candidate-heavy builds; with this set, the distances are
+    /// evaluated on the device (see NarrowPhaseGPU) and only the compacted
+    /// active subset reaches the host conversion loops, which re-derive the
+    /// exact distance types for the survivors so the built set matches the
+    /// CPU-only path. Requires a 3D mesh; no effect in builds without CUDA
+    /// support.
+    bool use_gpu_narrow_phase = false;
+
+    /// @brief Optional per-vertex activation distances (empty when unset).
+    ///
+    /// When set (size must equal the number of collision-mesh vertices), a
+    /// pair activates at the maximum of its vertices' dhats instead of the
+    /// uniform dhat argument of build(): regions that need a tight contact
+    /// resolution can keep a large dhat while the rest of the scene uses a
+    /// small one, shrinking the constraint set and the broad-phase candidate
+    /// lists (the vertex boxes are inflated per vertex, see
+    /// BroadPhase::vertex_inflation_radii). build() stamps each constraint's
+    /// local_dhat with the maximum over its own vertices, which the
+    /// potential evaluations then use in place of their dhat argument; the
+    /// dhat passed to build() and the evaluations is ignored apart from
+    /// constraints not covered by this vector (e.g. plane-vertex
+    /// constraints added manually).
+    Eigen::VectorXd vertex_dhat;
+
+    /// @brief Constraint indices grouped into vertex-disjoint color classes.
+    struct ScatterColoring {
+        /// @brief The color classes; no two constraints within a class share
+        /// a vertex, so one class scatters into the output in parallel
+        /// without thread-local copies or a merge pass.
+        std::vector<std::vector<size_t>> classes;
+        /// @brief Whether the classes match the current constraint set.
+        bool valid = false;
+    };
+
+    /// @brief Greedily color the constraints so no two constraints of a
+    /// color share a vertex.
+    ///
+    /// The coloring is cached until the constraint set changes (build() and
+    /// clear() invalidate it). The first computation is not thread-safe;
+    /// call this before sharing the set between concurrent evaluations.
+    /// @param E Edge matrix of the mesh.
+    /// @param F Face matrix of the mesh.
+    const ScatterColoring&
+    scatter_coloring(const Eigen::MatrixXi& E, const Eigen::MatrixXi& F) const;
+
+    /// @brief Edge-edge constraint indices grouped by closest-feature type.
+    struct EdgeEdgeTypeBuckets {
+        /// @brief Indices into ee_constraints, one bucket per
+        /// EdgeEdgeDistanceType value in enumerator order.
+        std::array<std::vector<size_t>, 9> by_type;
+        /// @brief Vertices the classification was computed from.
+        Eigen::MatrixXd V;
+    };
+
+    /// @brief Bucket the edge-edge constraints by closest-feature type at V.
+    ///
+    /// Classifies every edge-edge constraint (warm-started from and updating
+    /// its dtype_hint, so subsequent evaluations at the same positions take
+    /// the cheap hint-verification path) and groups the indices by type. The
+    /// buckets are cached until the vertices change; build() and clear()
+    /// invalidate them. The first computation at a position set is not
+    /// thread-safe; call this before sharing the set between concurrent
+    /// evaluations.
+    /// @param V Vertices of the collision mesh.
+    /// @param E Edge matrix of the mesh.
+    const EdgeEdgeTypeBuckets&
+    edge_edge_type_buckets(ConstMatrixXdRef V, const Eigen::MatrixXi& E) const;
+
     /// @brief Construct a set of constraints used to compute the barrier potential.
     /// @param mesh The collision mesh.
     /// @param V Vertices of the collision mesh.
@@ -34,11 +155,27 @@ struct Constraints {
     /// @param method Broad-phase method to use.
     void build(
         const CollisionMesh& mesh,
-        const Eigen::MatrixXd& V,
+        ConstMatrixXdRef V,
         const double dhat,
         const double dmin = 0,
         const BroadPhaseMethod method = BroadPhaseMethod::HASH_GRID);
 
+    /// @brief Construct a set of constraints used to compute the barrier potential.
+    ///
+    /// Uses a caller-owned broad phase, so the structure can be kept warm and
+    /// its build shared with other queries over the time step.
+    /// @param broad_phase Broad phase to (re)build and query.
+    /// @param mesh The collision mesh.
+    /// @param V Vertices of the collision mesh.
+    /// @param dhat The activation distance of the barrier.
+    /// @param dmin Minimum distance.
+    void build(
+        BroadPhase& broad_phase,
+        const CollisionMesh& mesh,
+        ConstMatrixXdRef V,
+        const double dhat,
+        const double dmin = 0);
+
     /// @brief Construct a set of constraints used to compute the barrier potential.
     /// @param candidates Distance candidates from which the constraint set is built.
     /// @param mesh The collision mesh.
@@ -48,51 +185,185 @@ struct Constraints {
     void build(
         const Candidates& candidates,
         const CollisionMesh& mesh,
-        const Eigen::MatrixXd& V,
+        ConstMatrixXdRef V,
+        const double dhat,
+        const double dmin = 0);
+
+    /// @brief Update the constraint set after the vertices move.
+    ///
+    /// Warm-start alternative to build for the iterations of a nonlinear
+    /// solve: while no vertex has moved farther than the broad phase's build
+    /// margin since the last detection (see BroadPhase::set_build_margin),
+    /// the cached candidates are still a superset of all pairs within dhat,
+    /// so only their distances are reevaluated and the broad phase is
+    /// skipped. Otherwise this falls back to a full build and caches the
+    /// newly detected candidates.
+    /// @param broad_phase Broad phase to (re)build and query as needed.
+    /// @param mesh The collision mesh.
+    /// @param V Vertices of the collision mesh.
+    /// @param dhat The activation distance of the barrier.
+    /// @param dmin Minimum distance.
+    void update(
+        BroadPhase& broad_phase,
+        const CollisionMesh& mesh,
+        ConstMatrixXdRef V,
         const double dhat,
         const double dmin = 0);
 
+    /// @brief Check if the distances cached on the constraints during build
+    /// are still valid for V (i.e., no vertex has moved since the build).
+    /// @param V Vertices of the collision mesh.
+    bool are_cached_distances_valid(ConstMatrixXdRef V) const;
+
     size_t size() const;
 
     bool empty() const;
 
     void clear();
 
+    /// @brief Bytes of heap memory held by the constraint set.
+    ///
+    /// Counts the constraint vectors (capacity, not only the used size), the
+    /// per-constraint weight gradients, the cached candidates, and the
+    /// cached distance vertices. Updates peak_bytes_used().
+    size_t bytes_used() const;
+
+    /// @brief Largest value bytes_used() has returned on this object.
+    /// The peak persists across clear().
+    size_t peak_bytes_used() const { return m_peak_bytes_used; }
+
+    /// @brief Number of candidates dropped by the last build() because of
+    /// candidate_budget (zero when the set is exact).
+    size_t num_truncated_candidates() const
+    {
+        return m_num_truncated_candidates;
+    }
+
     CollisionConstraint& operator[](size_t idx);
     const CollisionConstraint& operator[](size_t idx) const;
 
+    /// @brief Apply a function to the constraints with indices in
+    /// [start, end) with their concrete types.
+    ///
+    /// Iterating the typed vectors directly lets the compiler inline the
+    /// per-constraint kernels instead of dispatching virtually through
+    /// operator[]; pass a generic lambda so it is instantiated per type.
+    /// @param start First constraint index (inclusive).
+    /// @param end One past the last constraint index.
+    /// @param f Callable invoked as f(constraint, i) where constraint has
+    /// its concrete type and i is the constraint's index in the set.
+    template <typename ConstraintFunc>
+    void for_each(
+        const size_t start, const size_t end, const ConstraintFunc& f) const
+    {
+        assert(start <= end && end <= size());
+        size_t offset = 0;
+        const auto loop = [&](const auto& constraints) {
+            const size_t lo = std::max(start, offset);
+            const size_t hi = std::min(end, offset + constraints.size());
+            for (size_t i = lo; i < hi; i++) {
+                f(constraints[i - offset], i);
+            }
+            offset += constraints.size();
+        };
+        loop(vv_constraints);
+        loop(ev_constraints);
+        loop(ee_constraints);
+        loop(fv_constraints);
+        loop(pv_constraints);
+    }
+
 protected:
     struct Builder;
+    struct BuilderStorage;
 
+    /// @brief Configure the broad phase's vertex inflation radii from
+    /// vertex_dhat (or clear them when it is unset).
+    /// @return The conservative scalar inflation radius to detect with.
+    double set_vertex_inflation_radii(
+        BroadPhase& broad_phase,
+        ConstMatrixXdRef V,
+        const double dhat,
+        const double dmin) const;
+
+    /// @brief Sort each constraint vector by minimum vertex index (see
+    /// use_vertex_locality_ordering).
+    /// @param E Edge matrix of the mesh.
+    /// @param F Face matrix of the mesh.
+    void sort_constraints_by_min_vertex(
+        const Eigen::MatrixXi& E, const Eigen::MatrixXi& F);
+
+    template <typename IsActive>
     void edge_vertex_candiates_to_constraints(
         const CollisionMesh& mesh,
-        const Eigen::MatrixXd& V,
+        ConstMatrixXdRef V,
         const std::vector<EdgeVertexCandidate>& candidates,
-        const std::function<bool(double)>& is_active,
+        const IsActive& is_active,
+        const double dhat,
+        const double dmin,
         const size_t start_i,
         const size_t end_i,
         Builder& constraint_builder) const;
 
+    template <typename IsActive>
     void edge_edge_candiates_to_constraints(
         const CollisionMesh& mesh,
-        const Eigen::MatrixXd& V,
+        ConstMatrixXdRef V,
         const std::vector<EdgeEdgeCandidate>& candidates,
-        const std::function<bool(double)>& is_active,
+        const IsActive& is_active,
+        const double dhat,
+        const double dmin,
         const size_t start_i,
         const size_t end_i,
         Builder& constraint_builder) const;
 
+    template <typename IsActive>
     void face_vertex_candiates_to_constraints(
         const CollisionMesh& mesh,
-        const Eigen::MatrixXd& V,
+        ConstMatrixXdRef V,
         const std::vector<FaceVertexCandidate>& candidates,
-        const std::function<bool(double)>& is_active,
+        const IsActive& is_active,
+        const double dhat,
+        const double dmin,
         const size_t start_i,
         const size_t end_i,
         Builder& constraint_builder) const;
 
     void merge_thread_local_constraints(
         const tbb::enumerable_thread_specific<Builder>& local_storage);
+
+    /// @brief Candidates cached by update() while the broad phase is reused.
+    Candidates m_cached_candidates;
+    /// @brief Whether m_cached_candidates holds the last detected candidates.
+    bool m_candidates_are_cached = false;
+    /// @brief Vertices the cached constraint distances were computed from.
+    Eigen::MatrixXd m_cached_distance_V;
+
+    /// @brief Candidates dropped by the last build() (see candidate_budget).
+    size_t m_num_truncated_candidates = 0;
+
+    /// @brief Peak of bytes_used() (see peak_bytes_used()).
+    mutable size_t m_peak_bytes_used = 0;
+
+    /// @brief Lazily computed scatter coloring (see scatter_coloring()).
+    mutable ScatterColoring m_scatter_coloring;
+
+    /// @brief Lazily computed edge-edge type buckets (see
+    /// edge_edge_type_buckets()).
+    mutable EdgeEdgeTypeBuckets m_ee_type_buckets;
+
+    /// @brief Thread-local Builders reused across build() calls so repeated
+    /// builds do not reallocate the per-thread constraint vectors. Created
+    /// lazily by build(); copies of this set share the scratch, so calling
+    /// build() concurrently on copies is not supported.
+    std::shared_ptr<BuilderStorage> m_builder_storage;
+
+#ifdef IPC_TOOLKIT_WITH_CUDA
+    /// @brief Device narrow phase reused across build() calls (see
+    /// use_gpu_narrow_phase). Created lazily; copies of this set share it,
+    /// like m_builder_storage.
+    std::shared_ptr<NarrowPhaseGPU> m_narrow_phase_gpu;
+#endif
 };
 
 } // namespace ipc
@@ -7,7 +7,7 @@
 namespace ipc {
 
 EdgeEdgeConstraint::EdgeEdgeConstraint(
-    long edge0_index, long edge1_index, double eps_x)
+    index_t edge0_index, index_t edge1_index, double eps_x)
     : EdgeEdgeCandidate(edge0_index, edge1_index)
     , eps_x(eps_x)
 {
@@ -20,20 +20,34 @@ EdgeEdgeConstraint::EdgeEdgeConstraint(
 {
 }
 
+bool EdgeEdgeConstraint::is_mollified(
+    ConstMatrixXdRef V, const Eigen::MatrixXi& E) const
+{
+    return edge_edge_cross_squarednorm(
+               V.row(E(edge0_index, 0)), V.row(E(edge0_index, 1)),
+               V.row(E(edge1_index, 0)), V.row(E(edge1_index, 1)))
+        < eps_x;
+}
+
 double EdgeEdgeConstraint::compute_distance(
-    const Eigen::MatrixXd& V,
+    ConstMatrixXdRef V,
     const Eigen::MatrixXi& E,
     const Eigen::MatrixXi& F) const
 {
     // The distance type is unknown because of mollified PP and PE
     // constraints where also added as EE constraints.
-    return edge_edge_distance(
-        V.row(E(edge0_index, 0)), V.row(E(edge0_index, 1)),
-        V.row(E(edge1_index, 0)), V.row(E(edge1_index, 1)));
+    const auto& ea0 = V.row(E(edge0_index, 0));
+    const auto& ea1 = V.row(E(edge0_index, 1));
+    const auto& eb0 = V.row(E(edge1_index, 0));
+    const auto& eb1 = V.row(E(edge1_index, 1));
+    const EdgeEdgeDistanceType dtype =
+        edge_edge_distance_type(ea0, ea1, eb0, eb1, dtype_hint);
+    dtype_hint = dtype;
+    return edge_edge_distance(ea0, ea1, eb0, eb1, dtype);
 }
 
 VectorMax12d EdgeEdgeConstraint::compute_distance_gradient(
-    const Eigen::MatrixXd& V,
+    ConstMatrixXdRef V,
     const Eigen::MatrixXi& E,
     const Eigen::MatrixXi& F) const
 {
@@ -45,7 +59,7 @@ VectorMax12d EdgeEdgeConstraint::compute_distance_gradient(
 }
 
 MatrixMax12d EdgeEdgeConstraint::compute_distance_hessian(
-    const Eigen::MatrixXd& V,
+    ConstMatrixXdRef V,
     const Eigen::MatrixXi& E,
     const Eigen::MatrixXi& F) const
 {
@@ -56,120 +70,79 @@ MatrixMax12d EdgeEdgeConstraint::compute_distance_hessian(
     return distance_hess;
 }
 
+// The mollified kernels live in edge_edge.tpp templated on the barrier
+// function; the virtuals below compile the default barrier once.
+
 double EdgeEdgeConstraint::compute_potential(
-    const Eigen::MatrixXd& V,
+    ConstMatrixXdRef V,
     const Eigen::MatrixXi& E,
     const Eigen::MatrixXi& F,
     const double dhat) const
 {
-    return edge_edge_mollifier(
-               V.row(E(edge0_index, 0)), V.row(E(edge0_index, 1)),
-               V.row(E(edge1_index, 0)), V.row(E(edge1_index, 1)), eps_x)
-        * CollisionConstraint::compute_potential(V, E, F, dhat);
+    return compute_potential_T<ClampedLogBarrier>(
+        V, E, F, dhat, compute_distance(V, E, F));
 }
 
-VectorMax12d EdgeEdgeConstraint::compute_potential_gradient(
-    const Eigen::MatrixXd& V,
+double EdgeEdgeConstraint::compute_potential(
+    ConstMatrixXdRef V,
     const Eigen::MatrixXi& E,
     const Eigen::MatrixXi& F,
-    const double dhat) const
+    const double dhat,
+    const double distance) const
 {
-    const double dhat_squared = dhat * dhat;
+    return compute_potential_T<ClampedLogBarrier>(V, E, F, dhat, distance);
+}
 
-    // ∇[m(x) * b(d(x))] = (∇m(x)) * b(d(x)) + m(x) * b'(d(x)) * ∇d(x)
-    const auto& ea0 = V.row(E(edge0_index, 0));
-    const auto& ea1 = V.row(E(edge0_index, 1));
-    const auto& eb0 = V.row(E(edge1_index, 0));
-    const auto& eb1 = V.row(E(edge1_index, 1));
+void EdgeEdgeConstraint::compute_potential_gradient(
+    ConstMatrixXdRef V,
+    const Eigen::MatrixXi& E,
+    const Eigen::MatrixXi& F,
+    const double dhat,
+    VectorMax12d& grad) const
+{
+    // compute_distance warm starts dtype_hint, so the re-classification
+    // inside the kernel only verifies the cached region.
+    compute_potential_gradient_T<ClampedLogBarrier>(
+        V, E, F, dhat, compute_distance(V, E, F), grad);
+}
 
-    // The distance type is unknown because of mollified PP and PE
-    // constraints where also added as EE constraints.
-    const EdgeEdgeDistanceType dtype =
-        edge_edge_distance_type(ea0, ea1, eb0, eb1);
-    const double distance = edge_edge_distance(ea0, ea1, eb0, eb1, dtype);
-    VectorMax12d distance_grad;
-    edge_edge_distance_gradient(ea0, ea1, eb0, eb1, dtype, distance_grad);
-
-    // m(x)
-    const double mollifier = edge_edge_mollifier(ea0, ea1, eb0, eb1, eps_x);
-    // ∇m(x)
-    VectorMax12d mollifier_grad;
-    edge_edge_mollifier_gradient(ea0, ea1, eb0, eb1, eps_x, mollifier_grad);
-
-    // b(d(x))
-    const double b = barrier(
-        distance - minimum_distance * minimum_distance,
-        2 * minimum_distance * dhat + dhat_squared);
-    // b'(d(x))
-    const double grad_b = barrier_gradient(
-        distance - minimum_distance * minimum_distance,
-        2 * minimum_distance * dhat + dhat_squared);
-
-    return weight * (mollifier_grad * b + mollifier * grad_b * distance_grad);
+void EdgeEdgeConstraint::compute_potential_gradient(
+    ConstMatrixXdRef V,
+    const Eigen::MatrixXi& E,
+    const Eigen::MatrixXi& F,
+    const double dhat,
+    const double distance,
+    VectorMax12d& grad) const
+{
+    compute_potential_gradient_T<ClampedLogBarrier>(
+        V, E, F, dhat, distance, grad);
 }
 
-MatrixMax12d EdgeEdgeConstraint::compute_potential_hessian(
-    const Eigen::MatrixXd& V,
+void EdgeEdgeConstraint::compute_potential_hessian(
+    ConstMatrixXdRef V,
     const Eigen::MatrixXi& E,
     const Eigen::MatrixXi& F,
     const double dhat,
-    const bool project_hessian_to_psd) const
+    const bool project_hessian_to_psd,
+    MatrixMax12d& hess) const
 {
-    const double dhat_squared = dhat * dhat;
-    const double min_dist_squrared = minimum_distance * minimum_distance;
-
-    // ∇²[m(x) * b(d(x))] = ∇[∇m(x) * b(d(x)) + m(x) * b'(d(x)) * ∇d(x)]
-    //                    = ∇²m(x) * b(d(x)) + b'(d(x)) * ∇d(x) * ∇m(x)ᵀ
-    //                      + ∇m(x) * b'(d(x)) * ∇d(x))ᵀ
-    //                      + m(x) * b"(d(x)) * ∇d(x) * ∇d(x)ᵀ
-    //                      + m(x) * b'(d(x)) * ∇²d(x)
-    const auto& ea0 = V.row(E(edge0_index, 0));
-    const auto& ea1 = V.row(E(edge0_index, 1));
-    const auto& eb0 = V.row(E(edge1_index, 0));
-    const auto& eb1 = V.row(E(edge1_index, 1));
+    compute_potential_hessian_T<ClampedLogBarrier>(
+        V, E, F, dhat, project_hessian_to_psd, hess);
+}
 
-    // Compute distance derivatives
-    // The distance type is unknown because of mollified PP and PE
-    // constraints where also added as EE constraints.
-    const EdgeEdgeDistanceType dtype =
-        edge_edge_distance_type(ea0, ea1, eb0, eb1);
-    const double distance = edge_edge_distance(ea0, ea1, eb0, eb1, dtype);
-    VectorMax12d distance_grad;
-    edge_edge_distance_gradient(ea0, ea1, eb0, eb1, dtype, distance_grad);
-    MatrixMax12d distance_hess;
-    edge_edge_distance_hessian(ea0, ea1, eb0, eb1, dtype, distance_hess);
-
-    // Compute mollifier derivatives
-    const double mollifier = edge_edge_mollifier(ea0, ea1, eb0, eb1, eps_x);
-    VectorMax12d mollifier_grad;
-    edge_edge_mollifier_gradient(ea0, ea1, eb0, eb1, eps_x, mollifier_grad);
-    MatrixMax12d mollifier_hess;
-    edge_edge_mollifier_hessian(ea0, ea1, eb0, eb1, eps_x, mollifier_hess);
-
-    // Compute barrier derivatives
-    const double b = barrier(
-        distance - min_dist_squrared,
-        2 * minimum_distance * dhat + dhat_squared);
-    const double grad_b = barrier_gradient(
-        distance - min_dist_squrared,
-        2 * minimum_distance * dhat + dhat_squared);
-    const double hess_b = barrier_hessian(
-        distance - min_dist_squrared,
-        2 * minimum_distance * dhat + dhat_squared);
-
-    MatrixMax12d hess = mollifier_hess * b
-        + grad_b
-            * (distance_grad * mollifier_grad.transpose()
-               + mollifier_grad * distance_grad.transpose())
-        + mollifier
-            * (hess_b * distance_grad * distance_grad.transpose()
-               + grad_b * distance_hess);
-
-    if (project_hessian_to_psd) {
-        hess = project_to_psd(hess);
-    }
-
-    return weight * hess;
+void EdgeEdgeConstraint::compute_potential_and_derivatives(
+    ConstMatrixXdRef V,
+    const Eigen::MatrixXi& E,
+    const Eigen::MatrixXi& F,
+    const double dhat,
+    const bool project_hessian_to_psd,
+    double& potential,
+    VectorMax12d& potential_grad,
+    MatrixMax12d& potential_hess) const
+{
+    compute_potential_and_derivatives_T<ClampedLogBarrier>(
+        V, E, F, dhat, project_hessian_to_psd, potential, potential_grad,
+        potential_hess);
 }
 
 } // namespace ipc
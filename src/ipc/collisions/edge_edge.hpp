@@ -2,55 +2,152 @@
 
 #include <ipc/broad_phase/collision_candidate.hpp>
 #include <ipc/collisions/collision_constraint.hpp>
+#include <ipc/distance/distance_type.hpp>
 #include <ipc/utils/eigen_ext.hpp>
 
 namespace ipc {
 
 struct EdgeEdgeConstraint : EdgeEdgeCandidate, CollisionConstraint {
-    EdgeEdgeConstraint(long edge0_index, long edge1_index, double eps_x);
+    EdgeEdgeConstraint(index_t edge0_index, index_t edge1_index, double eps_x);
     EdgeEdgeConstraint(const EdgeEdgeCandidate& candidate, double eps_x);
 
     int num_vertices() const override { return 4; };
-    std::array<long, 4> vertex_indices(
+    std::array<index_t, 4> vertex_indices(
         const Eigen::MatrixXi& E, const Eigen::MatrixXi& F) const override
     {
         return { { E(edge0_index, 0), E(edge0_index, 1), //
                    E(edge1_index, 0), E(edge1_index, 1) } };
     }
 
+    /// @brief Check if the mollifier is active (< 1) for the given positions.
+    ///
+    /// Most edge pairs are far from parallel, so the mollifier is identically
+    /// one (with vanishing derivatives) and the potential kernels skip the
+    /// product-rule terms entirely.
+    ///
+    /// @param V Vertex positions.
+    /// @param E Edge matrix of the mesh.
+    /// @return True if the edges are close enough to parallel to mollify.
+    bool is_mollified(ConstMatrixXdRef V, const Eigen::MatrixXi& E) const;
+
     double compute_distance(
-        const Eigen::MatrixXd& V,
+        ConstMatrixXdRef V,
         const Eigen::MatrixXi& E,
         const Eigen::MatrixXi& F) const override;
 
     VectorMax12d compute_distance_gradient(
-        const Eigen::MatrixXd& V,
+        ConstMatrixXdRef V,
         const Eigen::MatrixXi& E,
         const Eigen::MatrixXi& F) const override;
 
     MatrixMax12d compute_distance_hessian(
-        const Eigen::MatrixXd& V,
+        ConstMatrixXdRef V,
         const Eigen::MatrixXi& E,
         const Eigen::MatrixXi& F) const override;
 
     double compute_potential(
-        const Eigen::MatrixXd& V,
+        ConstMatrixXdRef V,
         const Eigen::MatrixXi& E,
         const Eigen::MatrixXi& F,
         const double dhat) const override;
 
-    VectorMax12d compute_potential_gradient(
-        const Eigen::MatrixXd& V,
+    double compute_potential(
+        ConstMatrixXdRef V,
         const Eigen::MatrixXi& E,
         const Eigen::MatrixXi& F,
-        const double dhat) const override;
+        const double dhat,
+        const double distance) const override;
+
+    // Bring in the by-value wrappers hidden by the in-place overrides below.
+    using CollisionConstraint::compute_potential_gradient;
+    using CollisionConstraint::compute_potential_hessian;
+
+    void compute_potential_gradient(
+        ConstMatrixXdRef V,
+        const Eigen::MatrixXi& E,
+        const Eigen::MatrixXi& F,
+        const double dhat,
+        VectorMax12d& grad) const override;
+
+    void compute_potential_gradient(
+        ConstMatrixXdRef V,
+        const Eigen::MatrixXi& E,
+        const Eigen::MatrixXi& F,
+        const double dhat,
+        const double distance,
+        VectorMax12d& grad) const override;
+
+    void compute_potential_hessian(
+        ConstMatrixXdRef V,
+        const Eigen::MatrixXi& E,
+        const Eigen::MatrixXi& F,
+        const double dhat,
+        const bool project_hessian_to_psd,
+        MatrixMax12d& hess) const override;
+
+    void compute_potential_and_derivatives(
+        ConstMatrixXdRef V,
+        const Eigen::MatrixXi& E,
+        const Eigen::MatrixXi& F,
+        const double dhat,
+        const bool project_hessian_to_psd,
+        double& potential,
+        VectorMax12d& potential_grad,
+        MatrixMax12d& potential_hess) const override;
+
+    // Mollified shadows of the templated barrier kernels (see the note in
+    // collision_constraint.hpp: the templates dispatch statically, so they
+    // must be shadowed here to pick up the mollifier product rule).
+
+    /// @brief Templated core of compute_potential (mollified).
+    /// @tparam Barrier The barrier function (see ClampedLogBarrier).
+    /// @param distance Squared distance of the constraint for V.
+    template <typename Barrier>
+    double compute_potential_T(
+        ConstMatrixXdRef V,
+        const Eigen::MatrixXi& E,
+        const Eigen::MatrixXi& F,
+        const double dhat,
+        const double distance) const;
+
+    /// @brief Templated core of compute_potential_gradient (mollified).
+    /// @tparam Barrier The barrier function (see ClampedLogBarrier).
+    /// @param distance Squared distance of the constraint for V.
+    /// @param[out] grad Storage for the gradient (resized as needed).
+    template <typename Barrier>
+    void compute_potential_gradient_T(
+        ConstMatrixXdRef V,
+        const Eigen::MatrixXi& E,
+        const Eigen::MatrixXi& F,
+        const double dhat,
+        const double distance,
+        VectorMax12d& grad) const;
 
-    MatrixMax12d compute_potential_hessian(
-        const Eigen::MatrixXd& V,
+    /// @brief Templated core of compute_potential_hessian (mollified).
+    /// @tparam Barrier The barrier function (see ClampedLogBarrier).
+    /// @param[out] hess Storage for the hessian (resized as needed).
+    template <typename Barrier>
+    void compute_potential_hessian_T(
+        ConstMatrixXdRef V,
         const Eigen::MatrixXi& E,
         const Eigen::MatrixXi& F,
         const double dhat,
-        const bool project_hessian_to_psd) const override;
+        const bool project_hessian_to_psd,
+        MatrixMax12d& hess) const;
+
+    /// @brief Templated core of compute_potential_and_derivatives
+    /// (mollified).
+    /// @tparam Barrier The barrier function (see ClampedLogBarrier).
+    template <typename Barrier>
+    void compute_potential_and_derivatives_T(
+        ConstMatrixXdRef V,
+        const Eigen::MatrixXi& E,
+        const Eigen::MatrixXi& F,
+        const double dhat,
+        const bool project_hessian_to_psd,
+        double& potential,
+        VectorMax12d& potential_grad,
+        MatrixMax12d& potential_hess) const;
 
     template <typename H>
     friend H AbslHashValue(H h, const EdgeEdgeConstraint& ee)
@@ -61,6 +158,18 @@ struct EdgeEdgeConstraint : EdgeEdgeCandidate, CollisionConstraint {
     }
 
     double eps_x;
+
+    /// @brief Cached closest-feature classification from the last evaluation.
+    ///
+    /// Used to warm start edge_edge_distance_type(): the closest feature
+    /// rarely changes between consecutive solver iterations, so the cached
+    /// region is verified first and the full classification only runs when
+    /// it fails. Updated by the potential kernels; safe because the parallel
+    /// assembly loops partition the work by constraint, so a constraint is
+    /// only ever evaluated by one thread at a time.
+    mutable EdgeEdgeDistanceType dtype_hint = EdgeEdgeDistanceType::EA_EB;
 };
 
 } // namespace ipc
+
+#include "edge_edge.tpp"
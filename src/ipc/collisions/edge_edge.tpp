@@ -0,0 +1,246 @@
+#pragma once
+#include "edge_edge.hpp"
+
+#include <ipc/barrier/barrier.hpp>
+#include <ipc/distance/edge_edge.hpp>
+#include <ipc/distance/edge_edge_mollifier.hpp>
+
+namespace ipc {
+
+template <typename Barrier>
+double EdgeEdgeConstraint::compute_potential_T(
+    ConstMatrixXdRef V,
+    const Eigen::MatrixXi& E,
+    const Eigen::MatrixXi& F,
+    const double global_dhat,
+    const double distance) const
+{
+    const double dhat = local_dhat < 0 ? global_dhat : local_dhat;
+    return edge_edge_mollifier(
+               V.row(E(edge0_index, 0)), V.row(E(edge0_index, 1)),
+               V.row(E(edge1_index, 0)), V.row(E(edge1_index, 1)), eps_x)
+        * CollisionConstraint::compute_potential_T<Barrier>(
+               V, E, F, dhat, distance);
+}
+
+template <typename Barrier>
+void EdgeEdgeConstraint::compute_potential_gradient_T(
+    ConstMatrixXdRef V,
+    const Eigen::MatrixXi& E,
+    const Eigen::MatrixXi& F,
+    const double global_dhat,
+    const double distance,
+    VectorMax12d& grad) const
+{
+    const double dhat = local_dhat < 0 ? global_dhat : local_dhat;
+    const double dhat_squared = dhat * dhat;
+
+    // ∇[m(x) * b(d(x))] = (∇m(x)) * b(d(x)) + m(x) * b'(d(x)) * ∇d(x)
+    const auto& ea0 = V.row(E(edge0_index, 0));
+    const auto& ea1 = V.row(E(edge0_index, 1));
+    const auto& eb0 = V.row(E(edge1_index, 0));
+    const auto& eb1 = V.row(E(edge1_index, 1));
+
+    // The distance value is given, but its type is unknown because of
+    // mollified PP and PE constraints where also added as EE constraints.
+    const EdgeEdgeDistanceType dtype =
+        edge_edge_distance_type(ea0, ea1, eb0, eb1, dtype_hint);
+    dtype_hint = dtype;
+    VectorMax12d distance_grad;
+    edge_edge_distance_gradient(ea0, ea1, eb0, eb1, dtype, distance_grad);
+
+    // b'(d(x))
+    const double grad_b = Barrier::first_derivative(
+        distance - minimum_distance * minimum_distance,
+        2 * minimum_distance * dhat + dhat_squared);
+
+    // Most edge pairs are far from parallel, so m(x) ≡ 1 and ∇m(x) = 0 in a
+    // neighborhood; the product rule reduces to the plain barrier chain rule.
+    if (!is_mollified(V, E)) {
+        grad = weight * grad_b * distance_grad;
+        return;
+    }
+
+    // m(x)
+    const double mollifier = edge_edge_mollifier(ea0, ea1, eb0, eb1, eps_x);
+    // ∇m(x)
+    VectorMax12d mollifier_grad;
+    edge_edge_mollifier_gradient(ea0, ea1, eb0, eb1, eps_x, mollifier_grad);
+
+    // b(d(x))
+    const double b = Barrier::value(
+        distance - minimum_distance * minimum_distance,
+        2 * minimum_distance * dhat + dhat_squared);
+
+    grad = weight * (mollifier_grad * b + mollifier * grad_b * distance_grad);
+}
+
+template <typename Barrier>
+void EdgeEdgeConstraint::compute_potential_hessian_T(
+    ConstMatrixXdRef V,
+    const Eigen::MatrixXi& E,
+    const Eigen::MatrixXi& F,
+    const double global_dhat,
+    const bool project_hessian_to_psd,
+    MatrixMax12d& hess) const
+{
+    const double dhat = local_dhat < 0 ? global_dhat : local_dhat;
+    const double dhat_squared = dhat * dhat;
+    const double min_dist_squrared = minimum_distance * minimum_distance;
+
+    // ∇²[m(x) * b(d(x))] = ∇[∇m(x) * b(d(x)) + m(x) * b'(d(x)) * ∇d(x)]
+    //                    = ∇²m(x) * b(d(x)) + b'(d(x)) * ∇d(x) * ∇m(x)ᵀ
+    //                      + ∇m(x) * b'(d(x)) * ∇d(x))ᵀ
+    //                      + m(x) * b"(d(x)) * ∇d(x) * ∇d(x)ᵀ
+    //                      + m(x) * b'(d(x)) * ∇²d(x)
+    const auto& ea0 = V.row(E(edge0_index, 0));
+    const auto& ea1 = V.row(E(edge0_index, 1));
+    const auto& eb0 = V.row(E(edge1_index, 0));
+    const auto& eb1 = V.row(E(edge1_index, 1));
+
+    // Compute distance derivatives
+    // The distance type is unknown because of mollified PP and PE
+    // constraints where also added as EE constraints.
+    const EdgeEdgeDistanceType dtype =
+        edge_edge_distance_type(ea0, ea1, eb0, eb1, dtype_hint);
+    dtype_hint = dtype;
+    const double distance = edge_edge_distance(ea0, ea1, eb0, eb1, dtype);
+    VectorMax12d distance_grad;
+    edge_edge_distance_gradient(ea0, ea1, eb0, eb1, dtype, distance_grad);
+    MatrixMax12d distance_hess;
+    edge_edge_distance_hessian(ea0, ea1, eb0, eb1, dtype, distance_hess);
+
+    // Compute barrier derivatives
+    const double grad_b = Barrier::first_derivative(
+        distance - min_dist_squrared,
+        2 * minimum_distance * dhat + dhat_squared);
+    const double hess_b = Barrier::second_derivative(
+        distance - min_dist_squrared,
+        2 * minimum_distance * dhat + dhat_squared);
+
+    if (!is_mollified(V, E)) {
+        // Most edge pairs are far from parallel, so m(x) ≡ 1 and both ∇m(x)
+        // and ∇²m(x) vanish in a neighborhood; only the plain barrier chain
+        // rule terms remain.
+        hess = hess_b * distance_grad * distance_grad.transpose()
+            + grad_b * distance_hess;
+    } else {
+        // Compute mollifier derivatives
+        const double mollifier =
+            edge_edge_mollifier(ea0, ea1, eb0, eb1, eps_x);
+        VectorMax12d mollifier_grad;
+        edge_edge_mollifier_gradient(
+            ea0, ea1, eb0, eb1, eps_x, mollifier_grad);
+        MatrixMax12d mollifier_hess;
+        edge_edge_mollifier_hessian(
+            ea0, ea1, eb0, eb1, eps_x, mollifier_hess);
+
+        const double b = Barrier::value(
+            distance - min_dist_squrared,
+            2 * minimum_distance * dhat + dhat_squared);
+
+        hess = mollifier_hess * b
+            + grad_b
+                * (distance_grad * mollifier_grad.transpose()
+                   + mollifier_grad * distance_grad.transpose())
+            + mollifier
+                * (hess_b * distance_grad * distance_grad.transpose()
+                   + grad_b * distance_hess);
+    }
+
+    if (project_hessian_to_psd) {
+        hess = project_to_psd(hess);
+    }
+
+    hess *= weight;
+}
+
+template <typename Barrier>
+void EdgeEdgeConstraint::compute_potential_and_derivatives_T(
+    ConstMatrixXdRef V,
+    const Eigen::MatrixXi& E,
+    const Eigen::MatrixXi& F,
+    const double global_dhat,
+    const bool project_hessian_to_psd,
+    double& potential,
+    VectorMax12d& potential_grad,
+    MatrixMax12d& potential_hess) const
+{
+    const double dhat = local_dhat < 0 ? global_dhat : local_dhat;
+    const double dhat_squared = dhat * dhat;
+    const double min_dist_squrared = minimum_distance * minimum_distance;
+
+    const auto& ea0 = V.row(E(edge0_index, 0));
+    const auto& ea1 = V.row(E(edge0_index, 1));
+    const auto& eb0 = V.row(E(edge1_index, 0));
+    const auto& eb1 = V.row(E(edge1_index, 1));
+
+    // Compute the distance and mollifier derivatives once and share them
+    // between the potential, its gradient, and its hessian.
+    // The distance type is unknown because of mollified PP and PE
+    // constraints where also added as EE constraints.
+    const EdgeEdgeDistanceType dtype =
+        edge_edge_distance_type(ea0, ea1, eb0, eb1, dtype_hint);
+    dtype_hint = dtype;
+    const double distance = edge_edge_distance(ea0, ea1, eb0, eb1, dtype);
+    VectorMax12d distance_grad;
+    edge_edge_distance_gradient(ea0, ea1, eb0, eb1, dtype, distance_grad);
+    MatrixMax12d distance_hess;
+    edge_edge_distance_hessian(ea0, ea1, eb0, eb1, dtype, distance_hess);
+
+    const double b = Barrier::value(
+        distance - min_dist_squrared,
+        2 * minimum_distance * dhat + dhat_squared);
+    const double grad_b = Barrier::first_derivative(
+        distance - min_dist_squrared,
+        2 * minimum_distance * dhat + dhat_squared);
+    const double hess_b = Barrier::second_derivative(
+        distance - min_dist_squrared,
+        2 * minimum_distance * dhat + dhat_squared);
+
+    MatrixMax12d hess;
+    if (!is_mollified(V, E)) {
+        // Most edge pairs are far from parallel, so m(x) ≡ 1 and both ∇m(x)
+        // and ∇²m(x) vanish in a neighborhood; only the plain barrier chain
+        // rule terms remain.
+        potential = weight * b;
+        potential_grad = weight * grad_b * distance_grad;
+        hess = hess_b * distance_grad * distance_grad.transpose()
+            + grad_b * distance_hess;
+    } else {
+        const double mollifier =
+            edge_edge_mollifier(ea0, ea1, eb0, eb1, eps_x);
+        VectorMax12d mollifier_grad;
+        edge_edge_mollifier_gradient(
+            ea0, ea1, eb0, eb1, eps_x, mollifier_grad);
+        MatrixMax12d mollifier_hess;
+        edge_edge_mollifier_hessian(
+            ea0, ea1, eb0, eb1, eps_x, mollifier_hess);
+
+        // m(x) * b(d(x))
+        potential = weight * mollifier * b;
+
+        // ∇[m(x) * b(d(x))] = (∇m(x)) * b(d(x)) + m(x) * b'(d(x)) * ∇d(x)
+        potential_grad =
+            weight * (mollifier_grad * b + mollifier * grad_b * distance_grad);
+
+        // ∇²[m(x) * b(d(x))] = ∇²m(x) * b(d(x)) + b'(d(x)) * ∇d(x) * ∇m(x)ᵀ
+        //                      + ∇m(x) * b'(d(x)) * ∇d(x))ᵀ
+        //                      + m(x) * b"(d(x)) * ∇d(x) * ∇d(x)ᵀ
+        //                      + m(x) * b'(d(x)) * ∇²d(x)
+        hess = mollifier_hess * b
+            + grad_b
+                * (distance_grad * mollifier_grad.transpose()
+                   + mollifier_grad * distance_grad.transpose())
+            + mollifier
+                * (hess_b * distance_grad * distance_grad.transpose()
+                   + grad_b * distance_hess);
+    }
+
+    if (project_hessian_to_psd) {
+        hess = project_to_psd(hess);
+    }
+    potential_hess = weight * hess;
+}
+
+} // namespace ipc
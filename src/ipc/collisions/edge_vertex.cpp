@@ -4,7 +4,8 @@
 
 namespace ipc {
 
-EdgeVertexConstraint::EdgeVertexConstraint(long edge_index, long vertex_index)
+EdgeVertexConstraint::EdgeVertexConstraint(
+    index_t edge_index, index_t vertex_index)
     : EdgeVertexCandidate(edge_index, vertex_index)
 {
 }
@@ -15,7 +16,7 @@ EdgeVertexConstraint::EdgeVertexConstraint(const EdgeVertexCandidate& candidate)
 }
 
 double EdgeVertexConstraint::compute_distance(
-    const Eigen::MatrixXd& V,
+    ConstMatrixXdRef V,
     const Eigen::MatrixXi& E,
     const Eigen::MatrixXi& F) const
 {
@@ -26,7 +27,7 @@ double EdgeVertexConstraint::compute_distance(
 }
 
 VectorMax12d EdgeVertexConstraint::compute_distance_gradient(
-    const Eigen::MatrixXd& V,
+    ConstMatrixXdRef V,
     const Eigen::MatrixXi& E,
     const Eigen::MatrixXi& F) const
 {
@@ -38,7 +39,7 @@ VectorMax12d EdgeVertexConstraint::compute_distance_gradient(
 }
 
 MatrixMax12d EdgeVertexConstraint::compute_distance_hessian(
-    const Eigen::MatrixXd& V,
+    ConstMatrixXdRef V,
     const Eigen::MatrixXi& E,
     const Eigen::MatrixXi& F) const
 {
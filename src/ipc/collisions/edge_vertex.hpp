@@ -7,28 +7,28 @@
 namespace ipc {
 
 struct EdgeVertexConstraint : EdgeVertexCandidate, CollisionConstraint {
-    EdgeVertexConstraint(long edge_index, long vertex_index);
+    EdgeVertexConstraint(index_t edge_index, index_t vertex_index);
     EdgeVertexConstraint(const EdgeVertexCandidate& candidate);
 
     int num_vertices() const override { return 3; };
-    std::array<long, 4> vertex_indices(
+    std::array<index_t, 4> vertex_indices(
         const Eigen::MatrixXi& E, const Eigen::MatrixXi& F) const override
     {
         return { { vertex_index, E(edge_index, 0), E(edge_index, 1), -1 } };
     }
 
     double compute_distance(
-        const Eigen::MatrixXd& V,
+        ConstMatrixXdRef V,
         const Eigen::MatrixXi& E,
         const Eigen::MatrixXi& F) const override;
 
     VectorMax12d compute_distance_gradient(
-        const Eigen::MatrixXd& V,
+        ConstMatrixXdRef V,
         const Eigen::MatrixXi& E,
         const Eigen::MatrixXi& F) const override;
 
     MatrixMax12d compute_distance_hessian(
-        const Eigen::MatrixXd& V,
+        ConstMatrixXdRef V,
         const Eigen::MatrixXi& E,
         const Eigen::MatrixXi& F) const override;
 
@@ -4,7 +4,8 @@
 
 namespace ipc {
 
-FaceVertexConstraint::FaceVertexConstraint(long face_index, long vertex_index)
+FaceVertexConstraint::FaceVertexConstraint(
+    index_t face_index, index_t vertex_index)
     : FaceVertexCandidate(face_index, vertex_index)
 {
 }
@@ -15,7 +16,7 @@ FaceVertexConstraint::FaceVertexConstraint(const FaceVertexCandidate& candidate)
 }
 
 double FaceVertexConstraint::compute_distance(
-    const Eigen::MatrixXd& V,
+    ConstMatrixXdRef V,
     const Eigen::MatrixXi& E,
     const Eigen::MatrixXi& F) const
 {
@@ -26,7 +27,7 @@ double FaceVertexConstraint::compute_distance(
 }
 
 VectorMax12d FaceVertexConstraint::compute_distance_gradient(
-    const Eigen::MatrixXd& V,
+    ConstMatrixXdRef V,
     const Eigen::MatrixXi& E,
     const Eigen::MatrixXi& F) const
 {
@@ -38,7 +39,7 @@ VectorMax12d FaceVertexConstraint::compute_distance_gradient(
 }
 
 MatrixMax12d FaceVertexConstraint::compute_distance_hessian(
-    const Eigen::MatrixXd& V,
+    ConstMatrixXdRef V,
     const Eigen::MatrixXi& E,
     const Eigen::MatrixXi& F) const
 {
@@ -7,11 +7,11 @@
 namespace ipc {
 
 struct FaceVertexConstraint : FaceVertexCandidate, CollisionConstraint {
-    FaceVertexConstraint(long face_index, long vertex_index);
+    FaceVertexConstraint(index_t face_index, index_t vertex_index);
     FaceVertexConstraint(const FaceVertexCandidate& candidate);
 
     int num_vertices() const override { return 4; };
-    std::array<long, 4> vertex_indices(
+    std::array<index_t, 4> vertex_indices(
         const Eigen::MatrixXi& E, const Eigen::MatrixXi& F) const override
     {
         return { { vertex_index, //
@@ -19,17 +19,17 @@ struct FaceVertexConstraint : FaceVertexCandidate, CollisionConstraint {
     }
 
     double compute_distance(
-        const Eigen::MatrixXd& V,
+        ConstMatrixXdRef V,
         const Eigen::MatrixXi& E,
         const Eigen::MatrixXi& F) const override;
 
     VectorMax12d compute_distance_gradient(
-        const Eigen::MatrixXd& V,
+        ConstMatrixXdRef V,
         const Eigen::MatrixXi& E,
         const Eigen::MatrixXi& F) const override;
 
     MatrixMax12d compute_distance_hessian(
-        const Eigen::MatrixXd& V,
+        ConstMatrixXdRef V,
         const Eigen::MatrixXi& E,
         const Eigen::MatrixXi& F) const override;
 
@@ -0,0 +1,427 @@
+#include "narrow_phase_gpu.hpp"
+
+#ifdef IPC_TOOLKIT_WITH_CUDA
+
+#include <cuda_runtime.h>
+
+#include <algorithm> // std::max, std::sort
+#include <stdexcept>
+
+namespace ipc {
+
+namespace {
+
+    constexpr int BLOCK_SIZE = 256;
+
+    // Candidate types in Candidates order.
+    constexpr int EDGE_VERTEX = 0;
+    constexpr int EDGE_EDGE = 1;
+    constexpr int FACE_VERTEX = 2;
+
+    inline int num_blocks(size_t n)
+    {
+        return int((n + BLOCK_SIZE - 1) / BLOCK_SIZE);
+    }
+
+    inline void check_cuda(cudaError_t status)
+    {
+        if (status != cudaSuccess) {
+            throw std::runtime_error(
+                std::string("NarrowPhaseGPU CUDA error: ")
+                + cudaGetErrorString(status));
+        }
+    }
+
+    template <typename T> T* device_alloc(const size_t count)
+    {
+        T* ptr = nullptr;
+        check_cuda(cudaMalloc(&ptr, count * sizeof(T)));
+        return ptr;
+    }
+
+    // ---------------------------------------------------------------------
+    // double3 helpers
+
+    __device__ inline double3 load_point(const double* V, const int vi)
+    {
+        return make_double3(V[3 * vi + 0], V[3 * vi + 1], V[3 * vi + 2]);
+    }
+
+    __device__ inline double3 sub(const double3& a, const double3& b)
+    {
+        return make_double3(a.x - b.x, a.y - b.y, a.z - b.z);
+    }
+
+    __device__ inline double dot(const double3& a, const double3& b)
+    {
+        return a.x * b.x + a.y * b.y + a.z * b.z;
+    }
+
+    __device__ inline double clamp01(const double t)
+    {
+        return fmin(fmax(t, 0.0), 1.0);
+    }
+
+    // ---------------------------------------------------------------------
+    // Closest-point classification and squared distance
+    //
+    // Each candidate's squared distance is |Σₖ wₖ xₖ|² with signed
+    // closest-point weights wₖ; the weights' clamping is the closest-feature
+    // classification, so evaluating them is the distance-type dispatch the
+    // CPU loops pay per candidate.
+
+    __device__ inline void point_edge_weights(
+        const double3& p, const double3& e0, const double3& e1, double w[4])
+    {
+        const double3 e = sub(e1, e0);
+        const double e_sqr = dot(e, e);
+        const double t =
+            e_sqr > 0 ? clamp01(dot(sub(p, e0), e) / e_sqr) : 0.0;
+        w[0] = 1;
+        w[1] = -(1 - t);
+        w[2] = -t;
+        w[3] = 0;
+    }
+
+    /// @brief Closest point on a triangle in barycentric form
+    /// [Ericson 2005].
+    __device__ inline void point_triangle_weights(
+        const double3& p,
+        const double3& a,
+        const double3& b,
+        const double3& c,
+        double w[4])
+    {
+        const double3 ab = sub(b, a), ac = sub(c, a), ap = sub(p, a);
+        const double d1 = dot(ab, ap), d2 = dot(ac, ap);
+        double u, v;
+        if (d1 <= 0 && d2 <= 0) {
+            u = v = 0; // Vertex a
+        } else {
+            const double3 bp = sub(p, b);
+            const double d3 = dot(ab, bp), d4 = dot(ac, bp);
+            const double3 cp = sub(p, c);
+            const double d5 = dot(ab, cp), d6 = dot(ac, cp);
+            const double vc = d1 * d4 - d3 * d2;
+            const double vb = d5 * d2 - d1 * d6;
+            const double va = d3 * d6 - d5 * d4;
+            if (d3 >= 0 && d4 <= d3) {
+                u = 1, v = 0; // Vertex b
+            } else if (d6 >= 0 && d5 <= d6) {
+                u = 0, v = 1; // Vertex c
+            } else if (vc <= 0 && d1 >= 0 && d3 <= 0) {
+                u = d1 / (d1 - d3), v = 0; // Edge ab
+            } else if (vb <= 0 && d2 >= 0 && d6 <= 0) {
+                u = 0, v = d2 / (d2 - d6); // Edge ac
+            } else if (va <= 0 && (d4 - d3) >= 0 && (d5 - d6) >= 0) {
+                u = (d4 - d3) / ((d4 - d3) + (d5 - d6)); // Edge bc
+                v = 1 - u;
+            } else {
+                const double denom = 1.0 / (va + vb + vc); // Interior
+                u = vb * denom, v = vc * denom;
+            }
+        }
+        w[0] = 1;
+        w[1] = -(1 - u - v);
+        w[2] = -u;
+        w[3] = -v;
+    }
+
+    /// @brief Closest points of two segments in parametric form
+    /// [Ericson 2005].
+    __device__ inline void edge_edge_weights(
+        const double3& ea0,
+        const double3& ea1,
+        const double3& eb0,
+        const double3& eb1,
+        double w[4])
+    {
+        const double3 u = sub(ea1, ea0), v = sub(eb1, eb0);
+        const double3 r = sub(ea0, eb0);
+        const double a = dot(u, u), e = dot(v, v), f = dot(v, r);
+        double s, t;
+        if (a <= 0 && e <= 0) {
+            s = t = 0;
+        } else if (a <= 0) {
+            s = 0, t = clamp01(f / e);
+        } else {
+            const double c = dot(u, r);
+            if (e <= 0) {
+                t = 0, s = clamp01(-c / a);
+            } else {
+                const double b = dot(u, v);
+                const double denom = a * e - b * b;
+                s = denom > 0 ? clamp01((b * f - c * e) / denom) : 0.0;
+                t = (b * s + f) / e;
+                if (t < 0) {
+                    t = 0, s = clamp01(-c / a);
+                } else if (t > 1) {
+                    t = 1, s = clamp01((b - c) / a);
+                }
+            }
+        }
+        w[0] = 1 - s;
+        w[1] = s;
+        w[2] = -(1 - t);
+        w[3] = -t;
+    }
+
+    __device__ inline double candidate_distance(
+        const double* V, const int type, const int* vertex_ids)
+    {
+        double w[4];
+        const double3 x0 = load_point(V, vertex_ids[0]);
+        const double3 x1 = load_point(V, vertex_ids[1]);
+        switch (type) {
+        case EDGE_VERTEX:
+            point_edge_weights(x0, x1, load_point(V, vertex_ids[2]), w);
+            break;
+        case EDGE_EDGE:
+            edge_edge_weights(
+                x0, x1, load_point(V, vertex_ids[2]),
+                load_point(V, vertex_ids[3]), w);
+            break;
+        default: // FACE_VERTEX
+            point_triangle_weights(
+                x0, x1, load_point(V, vertex_ids[2]),
+                load_point(V, vertex_ids[3]), w);
+            break;
+        }
+        double3 diff = make_double3(0, 0, 0);
+        for (int k = 0; k < 4; k++) {
+            if (w[k] != 0) {
+                const double3 xk = load_point(V, vertex_ids[k]);
+                diff.x += w[k] * xk.x;
+                diff.y += w[k] * xk.y;
+                diff.z += w[k] * xk.z;
+            }
+        }
+        return dot(diff, diff);
+    }
+
+    /// @brief Evaluate one candidate type's distances and append the active
+    /// candidates' indices (unordered; the host sorts).
+    __global__ void cull_kernel(
+        const int num_candidates,
+        const int type,
+        const int* __restrict__ ids,
+        const double* __restrict__ V,
+        const double* __restrict__ vertex_dhat,
+        const double dhat,
+        const double dmin,
+        int* active_count,
+        int* __restrict__ active_indices)
+    {
+        const int i = blockIdx.x * blockDim.x + threadIdx.x;
+        if (i >= num_candidates) {
+            return;
+        }
+        const int* vertex_ids = ids + 4 * i;
+
+        // The candidate activates at the maximum of its vertices' dhats
+        // when vertex_dhat is set (see Constraints::vertex_dhat).
+        double candidate_dhat = dhat;
+        if (vertex_dhat != nullptr) {
+            candidate_dhat = 0;
+            const int num_stencil = type == EDGE_VERTEX ? 3 : 4;
+            for (int k = 0; k < num_stencil; k++) {
+                candidate_dhat =
+                    fmax(candidate_dhat, vertex_dhat[vertex_ids[k]]);
+            }
+        }
+        const double offset = dmin + candidate_dhat;
+
+        if (candidate_distance(V, type, vertex_ids) < offset * offset) {
+            const int slot = atomicAdd(active_count, 1);
+            active_indices[slot] = i;
+        }
+    }
+
+} // namespace
+
+void NarrowPhaseGPU::cull(
+    const Candidates& candidates,
+    const CollisionMesh& mesh,
+    ConstMatrixXdRef V,
+    const double dhat,
+    const double dmin,
+    const Eigen::VectorXd& vertex_dhat,
+    Candidates& active)
+{
+    if (V.cols() != 3) {
+        throw std::runtime_error("NarrowPhaseGPU requires a 3D mesh!");
+    }
+    assert(vertex_dhat.size() == 0 || vertex_dhat.size() == V.rows());
+
+    active.clear();
+    if (candidates.empty()) {
+        return;
+    }
+
+    const Eigen::MatrixXi& E = mesh.edges();
+    const Eigen::MatrixXi& F = mesh.faces();
+
+    const size_t max_candidates = std::max(
+        candidates.ev_candidates.size(),
+        std::max(
+            candidates.ee_candidates.size(),
+            candidates.fv_candidates.size()));
+    reserve_candidates(max_candidates);
+    upload_vertices(V, vertex_dhat);
+
+    std::vector<int> active_indices;
+
+    if (!candidates.ev_candidates.empty()) {
+        m_host_ids.resize(4 * candidates.ev_candidates.size());
+        for (size_t i = 0; i < candidates.ev_candidates.size(); i++) {
+            const auto& [ei, vi] = candidates.ev_candidates[i];
+            m_host_ids[4 * i + 0] = int(vi);
+            m_host_ids[4 * i + 1] = int(E(ei, 0));
+            m_host_ids[4 * i + 2] = int(E(ei, 1));
+            m_host_ids[4 * i + 3] = -1;
+        }
+        const size_t num_active = cull_type(
+            EDGE_VERTEX, candidates.ev_candidates.size(), dhat, dmin,
+            active_indices);
+        active.ev_candidates.reserve(num_active);
+        for (const int i : active_indices) {
+            active.ev_candidates.push_back(candidates.ev_candidates[i]);
+        }
+    }
+
+    if (!candidates.ee_candidates.empty()) {
+        m_host_ids.resize(4 * candidates.ee_candidates.size());
+        for (size_t i = 0; i < candidates.ee_candidates.size(); i++) {
+            const auto& [eai, ebi] = candidates.ee_candidates[i];
+            m_host_ids[4 * i + 0] = int(E(eai, 0));
+            m_host_ids[4 * i + 1] = int(E(eai, 1));
+            m_host_ids[4 * i + 2] = int(E(ebi, 0));
+            m_host_ids[4 * i + 3] = int(E(ebi, 1));
+        }
+        const size_t num_active = cull_type(
+            EDGE_EDGE, candidates.ee_candidates.size(), dhat, dmin,
+            active_indices);
+        active.ee_candidates.reserve(num_active);
+        for (const int i : active_indices) {
+            active.ee_candidates.push_back(candidates.ee_candidates[i]);
+        }
+    }
+
+    if (!candidates.fv_candidates.empty()) {
+        m_host_ids.resize(4 * candidates.fv_candidates.size());
+        for (size_t i = 0; i < candidates.fv_candidates.size(); i++) {
+            const auto& [fi, vi] = candidates.fv_candidates[i];
+            m_host_ids[4 * i + 0] = int(vi);
+            m_host_ids[4 * i + 1] = int(F(fi, 0));
+            m_host_ids[4 * i + 2] = int(F(fi, 1));
+            m_host_ids[4 * i + 3] = int(F(fi, 2));
+        }
+        const size_t num_active = cull_type(
+            FACE_VERTEX, candidates.fv_candidates.size(), dhat, dmin,
+            active_indices);
+        active.fv_candidates.reserve(num_active);
+        for (const int i : active_indices) {
+            active.fv_candidates.push_back(candidates.fv_candidates[i]);
+        }
+    }
+}
+
+size_t NarrowPhaseGPU::cull_type(
+    const int type,
+    const size_t num_candidates,
+    const double dhat,
+    const double dmin,
+    std::vector<int>& active_indices)
+{
+    check_cuda(cudaMemcpy(
+        d_ids, m_host_ids.data(), m_host_ids.size() * sizeof(int),
+        cudaMemcpyHostToDevice));
+    check_cuda(cudaMemset(d_active_count, 0, sizeof(int)));
+
+    cull_kernel<<<num_blocks(num_candidates), BLOCK_SIZE>>>(
+        int(num_candidates), type, d_ids, d_positions,
+        m_has_vertex_dhat ? d_vertex_dhat : nullptr, dhat, dmin,
+        d_active_count, d_active_indices);
+    check_cuda(cudaGetLastError());
+
+    int num_active = 0;
+    check_cuda(cudaMemcpy(
+        &num_active, d_active_count, sizeof(int), cudaMemcpyDeviceToHost));
+
+    active_indices.resize(num_active);
+    if (num_active > 0) {
+        check_cuda(cudaMemcpy(
+            active_indices.data(), d_active_indices,
+            num_active * sizeof(int), cudaMemcpyDeviceToHost));
+        // The atomic append is unordered; sort so the active subset keeps
+        // the input candidate order.
+        std::sort(active_indices.begin(), active_indices.end());
+    }
+    return size_t(num_active);
+}
+
+void NarrowPhaseGPU::reserve_candidates(const size_t count)
+{
+    if (count <= m_candidates_capacity) {
+        return;
+    }
+    cudaFree(d_ids);
+    cudaFree(d_active_indices);
+    d_ids = device_alloc<int>(4 * count);
+    d_active_indices = device_alloc<int>(count);
+    if (d_active_count == nullptr) {
+        d_active_count = device_alloc<int>(1);
+    }
+    m_candidates_capacity = count;
+}
+
+void NarrowPhaseGPU::upload_vertices(
+    ConstMatrixXdRef V, const Eigen::VectorXd& vertex_dhat)
+{
+    const bool has_vertex_dhat = vertex_dhat.size() > 0;
+    if (V.rows() > m_vertices_capacity
+        || (has_vertex_dhat && !m_has_vertex_dhat)) {
+        cudaFree(d_positions);
+        cudaFree(d_vertex_dhat);
+        d_vertex_dhat = nullptr;
+        d_positions = device_alloc<double>(3 * V.rows());
+        if (has_vertex_dhat) {
+            d_vertex_dhat = device_alloc<double>(V.rows());
+        }
+        m_vertices_capacity = V.rows();
+    }
+    m_has_vertex_dhat = has_vertex_dhat;
+
+    const Eigen::Matrix<double, Eigen::Dynamic, 3, Eigen::RowMajor> V_rm = V;
+    check_cuda(cudaMemcpy(
+        d_positions, V_rm.data(), 3 * V.rows() * sizeof(double),
+        cudaMemcpyHostToDevice));
+    if (has_vertex_dhat) {
+        check_cuda(cudaMemcpy(
+            d_vertex_dhat, vertex_dhat.data(),
+            vertex_dhat.size() * sizeof(double), cudaMemcpyHostToDevice));
+    }
+}
+
+NarrowPhaseGPU::~NarrowPhaseGPU() { clear(); }
+
+void NarrowPhaseGPU::clear()
+{
+    cudaFree(d_ids);
+    cudaFree(d_active_indices);
+    cudaFree(d_active_count);
+    cudaFree(d_positions);
+    cudaFree(d_vertex_dhat);
+    d_ids = nullptr;
+    d_active_indices = nullptr;
+    d_active_count = nullptr;
+    d_positions = nullptr;
+    d_vertex_dhat = nullptr;
+    m_candidates_capacity = 0;
+    m_vertices_capacity = 0;
+    m_has_vertex_dhat = false;
+}
+
+} // namespace ipc
+
+#endif
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <ipc/config.hpp>
+
+#ifdef IPC_TOOLKIT_WITH_CUDA
+
+#include <ipc/broad_phase/collision_candidate.hpp>
+#include <ipc/collision_mesh.hpp>
+#include <ipc/utils/eigen_ext.hpp>
+
+#include <vector>
+
+namespace ipc {
+
+/// @brief Device-side candidate culling for constraint-set construction.
+///
+/// Even with the broad phase paid, the dominant cost of Constraints::build
+/// on candidate-heavy frames is evaluating every candidate's closest-feature
+/// distance just to discard it: at millions of candidates only a few percent
+/// are within their activation distance. This class uploads the packed
+/// candidate stencils and positions, classifies each candidate's closest
+/// feature and evaluates its squared distance on the device, and downloads
+/// only the compacted active subset, so the host-side constraint
+/// construction, dedup, and merge run over the survivors alone.
+///
+/// The activation test matches the CPU loops: a candidate is active when its
+/// squared distance is below (dmin + dhat)², with dhat replaced by the
+/// maximum of the stencil's per-vertex dhats when vertex_dhat is set. The
+/// distance types implied by the device classification are not returned;
+/// the host loops re-derive them for the survivors while stamping the
+/// constraints, which keeps the built set identical to the CPU-only path.
+///
+/// The device buffers grow to the high-water candidate count and stay
+/// resident, so steady-state culls only upload and launch.
+///
+/// @note 3D meshes only.
+class NarrowPhaseGPU {
+public:
+    NarrowPhaseGPU() { }
+    ~NarrowPhaseGPU();
+
+    // Owns device memory.
+    NarrowPhaseGPU(const NarrowPhaseGPU&) = delete;
+    NarrowPhaseGPU& operator=(const NarrowPhaseGPU&) = delete;
+
+    /// @brief Cull the candidates to those within their activation distance.
+    /// @param[in] candidates Broad-phase candidates to evaluate.
+    /// @param[in] mesh The collision mesh.
+    /// @param[in] V Vertices of the collision mesh.
+    /// @param[in] dhat The activation distance of the barrier.
+    /// @param[in] dmin Minimum distance.
+    /// @param[in] vertex_dhat Optional per-vertex dhat (empty for uniform;
+    /// see Constraints::vertex_dhat).
+    /// @param[out] active The active subset of the candidates, in the input
+    /// order.
+    void cull(
+        const Candidates& candidates,
+        const CollisionMesh& mesh,
+        ConstMatrixXdRef V,
+        const double dhat,
+        const double dmin,
+        const Eigen::VectorXd& vertex_dhat,
+        Candidates& active);
+
+    /// @brief Free all device memory.
+    void clear();
+
+protected:
+    /// @brief Grow the per-candidate buffers to hold count candidates.
+    void reserve_candidates(const size_t count);
+
+    /// @brief Upload the positions (and per-vertex dhats, if set).
+    void upload_vertices(ConstMatrixXdRef V, const Eigen::VectorXd& vertex_dhat);
+
+    /// @brief Launch the cull kernel over one candidate type and download
+    /// the sorted indices of the active candidates.
+    /// @returns The number of active candidates.
+    size_t cull_type(
+        const int type,
+        const size_t num_candidates,
+        const double dhat,
+        const double dmin,
+        std::vector<int>& active_indices);
+
+    size_t m_candidates_capacity = 0;
+    long m_vertices_capacity = 0;
+    bool m_has_vertex_dhat = false;
+
+    // Host staging for the packed stencils (4 vertex ids per candidate).
+    std::vector<int> m_host_ids;
+
+    int* d_ids = nullptr; ///< @brief 4 vertex ids per candidate.
+    int* d_active_indices = nullptr; ///< @brief Compacted active candidates.
+    int* d_active_count = nullptr;
+    double* d_positions = nullptr; ///< @brief Row-major |V|x3 positions.
+    double* d_vertex_dhat = nullptr; ///< @brief Per-vertex dhat (optional).
+};
+
+} // namespace ipc
+
+#endif
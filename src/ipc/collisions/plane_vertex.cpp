@@ -1,5 +1,6 @@
 #include "plane_vertex.hpp"
 
+#include <ipc/barrier/barrier.hpp>
 #include <ipc/distance/point_plane.hpp>
 
 namespace ipc {
@@ -7,7 +8,7 @@ namespace ipc {
 PlaneVertexConstraint::PlaneVertexConstraint(
     const VectorMax3d& plane_origin,
     const VectorMax3d& plane_normal,
-    const long vertex_index)
+    const index_t vertex_index)
     : plane_origin(plane_origin)
     , plane_normal(plane_normal)
     , vertex_index(vertex_index)
@@ -15,7 +16,7 @@ PlaneVertexConstraint::PlaneVertexConstraint(
 }
 
 double PlaneVertexConstraint::compute_distance(
-    const Eigen::MatrixXd& V,
+    ConstMatrixXdRef V,
     const Eigen::MatrixXi& E,
     const Eigen::MatrixXi& F) const
 {
@@ -24,7 +25,7 @@ double PlaneVertexConstraint::compute_distance(
 }
 
 VectorMax12d PlaneVertexConstraint::compute_distance_gradient(
-    const Eigen::MatrixXd& V,
+    ConstMatrixXdRef V,
     const Eigen::MatrixXi& E,
     const Eigen::MatrixXi& F) const
 {
@@ -36,7 +37,7 @@ VectorMax12d PlaneVertexConstraint::compute_distance_gradient(
 }
 
 MatrixMax12d PlaneVertexConstraint::compute_distance_hessian(
-    const Eigen::MatrixXd& V,
+    ConstMatrixXdRef V,
     const Eigen::MatrixXi& E,
     const Eigen::MatrixXi& F) const
 {
@@ -47,4 +48,106 @@ MatrixMax12d PlaneVertexConstraint::compute_distance_hessian(
     return distance_hess;
 }
 
+namespace {
+
+    /// One past the last constraint sharing constraints[start]'s plane.
+    size_t end_of_plane_run(
+        const std::vector<PlaneVertexConstraint>& constraints,
+        const size_t start)
+    {
+        const auto same = [](const VectorMax3d& a, const VectorMax3d& b) {
+            return a.size() == b.size() && (a.array() == b.array()).all();
+        };
+        const PlaneVertexConstraint& first = constraints[start];
+        size_t end = start + 1;
+        while (end < constraints.size()
+               && same(constraints[end].plane_origin, first.plane_origin)
+               && same(constraints[end].plane_normal, first.plane_normal)) {
+            end++;
+        }
+        return end;
+    }
+
+    /// Gather the constrained vertices' positions as rows of P.
+    void gather_positions(
+        const std::vector<PlaneVertexConstraint>& constraints,
+        const size_t start,
+        const size_t end,
+        ConstMatrixXdRef V,
+        Eigen::MatrixXd& P)
+    {
+        P.resize(end - start, V.cols());
+        for (size_t i = start; i < end; i++) {
+            P.row(i - start) = V.row(constraints[i].vertex_index);
+        }
+    }
+
+} // namespace
+
+double compute_plane_vertex_potentials(
+    const std::vector<PlaneVertexConstraint>& constraints,
+    ConstMatrixXdRef V,
+    const double dhat)
+{
+    double potential = 0;
+
+    Eigen::MatrixXd P;
+    for (size_t start = 0; start < constraints.size();) {
+        const size_t end = end_of_plane_run(constraints, start);
+        const PlaneVertexConstraint& plane = constraints[start];
+
+        gather_positions(constraints, start, end, V, P);
+        const Eigen::VectorXd distances =
+            point_plane_distances(P, plane.plane_origin, plane.plane_normal);
+
+        for (size_t i = start; i < end; i++) {
+            const PlaneVertexConstraint& constraint = constraints[i];
+            const double dmin = constraint.minimum_distance;
+            potential += constraint.weight
+                * barrier(
+                         distances[i - start] - dmin * dmin,
+                         2 * dmin * dhat + dhat * dhat);
+        }
+
+        start = end;
+    }
+
+    return potential;
+}
+
+void compute_plane_vertex_potential_gradients(
+    const std::vector<PlaneVertexConstraint>& constraints,
+    ConstMatrixXdRef V,
+    const double dhat,
+    Eigen::VectorXd& grad)
+{
+    assert(grad.size() == V.size());
+    const int dim = V.cols();
+
+    Eigen::MatrixXd P, distance_grads;
+    for (size_t start = 0; start < constraints.size();) {
+        const size_t end = end_of_plane_run(constraints, start);
+        const PlaneVertexConstraint& plane = constraints[start];
+
+        gather_positions(constraints, start, end, V, P);
+        const Eigen::VectorXd distances =
+            point_plane_distances(P, plane.plane_origin, plane.plane_normal);
+        point_plane_distance_gradients(
+            P, plane.plane_origin, plane.plane_normal, distance_grads);
+
+        for (size_t i = start; i < end; i++) {
+            const PlaneVertexConstraint& constraint = constraints[i];
+            const double dmin = constraint.minimum_distance;
+            const double grad_b = barrier_gradient(
+                distances[i - start] - dmin * dmin,
+                2 * dmin * dhat + dhat * dhat);
+            grad.segment(dim * constraint.vertex_index, dim) +=
+                (constraint.weight * grad_b)
+                * distance_grads.row(i - start).transpose();
+        }
+
+        start = end;
+    }
+}
+
 } // namespace ipc
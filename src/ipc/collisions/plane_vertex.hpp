@@ -9,33 +9,61 @@ struct PlaneVertexConstraint : CollisionConstraint {
     PlaneVertexConstraint(
         const VectorMax3d& plane_origin,
         const VectorMax3d& plane_normal,
-        const long vertex_index);
+        const index_t vertex_index);
 
     int num_vertices() const override { return 1; };
-    std::array<long, 4> vertex_indices(
+    std::array<index_t, 4> vertex_indices(
         const Eigen::MatrixXi& E, const Eigen::MatrixXi& F) const override
     {
         return { { vertex_index, -1, -1, -1 } };
     }
 
     double compute_distance(
-        const Eigen::MatrixXd& V,
+        ConstMatrixXdRef V,
         const Eigen::MatrixXi& E,
         const Eigen::MatrixXi& F) const override;
 
     VectorMax12d compute_distance_gradient(
-        const Eigen::MatrixXd& V,
+        ConstMatrixXdRef V,
         const Eigen::MatrixXi& E,
         const Eigen::MatrixXi& F) const override;
 
     MatrixMax12d compute_distance_hessian(
-        const Eigen::MatrixXd& V,
+        ConstMatrixXdRef V,
         const Eigen::MatrixXi& E,
         const Eigen::MatrixXi& F) const override;
 
     VectorMax3d plane_origin;
     VectorMax3d plane_normal;
-    long vertex_index;
+    index_t vertex_index;
 };
 
+/// @brief Compute the barrier potential of plane-vertex constraints in batches.
+///
+/// Groups consecutive constraints that share a plane and evaluates each
+/// group's distances with the batched point-plane kernel (one dense product
+/// against the normal) instead of one virtual call and dot product per
+/// vertex. Matches the sum of the per-constraint compute_potential() calls;
+/// intended for granular scenes with millions of vertices on a few planes.
+/// @param constraints The plane-vertex constraints (e.g., pv_constraints).
+/// @param V Vertices of the collision mesh.
+/// @param dhat The activation distance of the barrier.
+/// @return The sum of the potential over the constraints.
+double compute_plane_vertex_potentials(
+    const std::vector<PlaneVertexConstraint>& constraints,
+    ConstMatrixXdRef V,
+    const double dhat);
+
+/// @brief Accumulate the barrier potential gradient of plane-vertex
+/// constraints in batches (see compute_plane_vertex_potentials()).
+/// @param[in] constraints The plane-vertex constraints.
+/// @param[in] V Vertices of the collision mesh.
+/// @param[in] dhat The activation distance of the barrier.
+/// @param[in,out] grad Gradient of size V.size() the result is added to.
+void compute_plane_vertex_potential_gradients(
+    const std::vector<PlaneVertexConstraint>& constraints,
+    ConstMatrixXdRef V,
+    const double dhat,
+    Eigen::VectorXd& grad);
+
 } // namespace ipc
@@ -5,7 +5,7 @@
 namespace ipc {
 
 VertexVertexConstraint::VertexVertexConstraint(
-    long vertex0_index, long vertex1_index)
+    index_t vertex0_index, index_t vertex1_index)
     : VertexVertexCandidate(vertex0_index, vertex1_index)
 {
 }
@@ -17,7 +17,7 @@ VertexVertexConstraint::VertexVertexConstraint(
 }
 
 double VertexVertexConstraint::compute_distance(
-    const Eigen::MatrixXd& V,
+    ConstMatrixXdRef V,
     const Eigen::MatrixXi& E,
     const Eigen::MatrixXi& F) const
 {
@@ -25,7 +25,7 @@ double VertexVertexConstraint::compute_distance(
 }
 
 VectorMax12d VertexVertexConstraint::compute_distance_gradient(
-    const Eigen::MatrixXd& V,
+    ConstMatrixXdRef V,
     const Eigen::MatrixXi& E,
     const Eigen::MatrixXi& F) const
 {
@@ -36,7 +36,7 @@ VectorMax12d VertexVertexConstraint::compute_distance_gradient(
 }
 
 MatrixMax12d VertexVertexConstraint::compute_distance_hessian(
-    const Eigen::MatrixXd& V,
+    ConstMatrixXdRef V,
     const Eigen::MatrixXi& E,
     const Eigen::MatrixXi& F) const
 {
@@ -10,7 +10,13 @@
 
 #define IPC_TOOLKIT_WITH_CORRECT_CCD
 /* #undef IPC_TOOLKIT_WITH_RATIONAL_INTERSECTION */
-#define IPC_TOOLKIT_WITH_CUDA
+/* #undef IPC_TOOLKIT_WITH_CUDA */
+/* #undef IPC_TOOLKIT_WITH_PROFILER */
+/* #undef IPC_TOOLKIT_WITH_32BIT_INDICES */
+
+// Lowest log level compiled into the library (matches spdlog's
+// SPDLOG_LEVEL_* values); see the IPC_LOG_* macros in utils/logger.hpp.
+#define IPC_TOOLKIT_LOG_ACTIVE_LEVEL 0
 
 #define IPC_TOOLKIT_USE_ROBIN_MAP
 #define IPC_TOOLKIT_USE_ABSL_HASH
@@ -0,0 +1,343 @@
+#include "distance_batch.hpp"
+
+#include <ipc/distance/edge_edge.hpp>
+#include <ipc/distance/point_triangle.hpp>
+
+#include <array>
+
+namespace ipc {
+
+namespace {
+
+    /// @brief Gather the given rows of a matrix into a compact matrix.
+    Eigen::MatrixXd
+    gather_rows(const Eigen::MatrixXd& M, const std::vector<long>& rows)
+    {
+        Eigen::MatrixXd G(rows.size(), M.cols());
+        for (size_t i = 0; i < rows.size(); i++) {
+            G.row(i) = M.row(rows[i]);
+        }
+        return G;
+    }
+
+    /// @brief Scatter compact per-group distances back to candidate order.
+    void scatter_distances(
+        const Eigen::VectorXd& group_distances,
+        const std::vector<long>& rows,
+        Eigen::VectorXd& distances)
+    {
+        for (size_t i = 0; i < rows.size(); i++) {
+            distances[rows[i]] = group_distances[i];
+        }
+    }
+
+    /// @brief Row-wise cross product of two n×3 matrices.
+    Eigen::MatrixXd
+    rowwise_cross(const Eigen::MatrixXd& A, const Eigen::MatrixXd& B)
+    {
+        Eigen::MatrixXd C(A.rows(), 3);
+        C.col(0) = A.col(1).array() * B.col(2).array()
+            - A.col(2).array() * B.col(1).array();
+        C.col(1) = A.col(2).array() * B.col(0).array()
+            - A.col(0).array() * B.col(2).array();
+        C.col(2) = A.col(0).array() * B.col(1).array()
+            - A.col(1).array() * B.col(0).array();
+        return C;
+    }
+
+    /// @brief Batched point_point_distance.
+    Eigen::VectorXd point_point_distances(
+        const Eigen::MatrixXd& P0, const Eigen::MatrixXd& P1)
+    {
+        return (P0 - P1).rowwise().squaredNorm();
+    }
+
+    /// @brief Batched point_line_distance (3D).
+    Eigen::VectorXd point_line_distances(
+        const Eigen::MatrixXd& P,
+        const Eigen::MatrixXd& E0,
+        const Eigen::MatrixXd& E1)
+    {
+        return rowwise_cross(E0 - P, E1 - P).rowwise().squaredNorm().array()
+            / (E1 - E0).rowwise().squaredNorm().array();
+    }
+
+    /// @brief Batched point_plane_distance.
+    Eigen::VectorXd point_plane_distances(
+        const Eigen::MatrixXd& P,
+        const Eigen::MatrixXd& T0,
+        const Eigen::MatrixXd& T1,
+        const Eigen::MatrixXd& T2)
+    {
+        const Eigen::MatrixXd normals = rowwise_cross(T1 - T0, T2 - T0);
+        const Eigen::ArrayXd point_to_plane =
+            ((P - T0).array() * normals.array()).rowwise().sum();
+        return point_to_plane.square()
+            / normals.rowwise().squaredNorm().array();
+    }
+
+    /// @brief Batched line_line_distance.
+    Eigen::VectorXd line_line_distances(
+        const Eigen::MatrixXd& EA0,
+        const Eigen::MatrixXd& EA1,
+        const Eigen::MatrixXd& EB0,
+        const Eigen::MatrixXd& EB1)
+    {
+        const Eigen::MatrixXd normals = rowwise_cross(EA1 - EA0, EB1 - EB0);
+        const Eigen::ArrayXd line_to_line =
+            ((EB0 - EA0).array() * normals.array()).rowwise().sum();
+        return line_to_line.square()
+            / normals.rowwise().squaredNorm().array();
+    }
+
+} // namespace
+
+std::vector<PointTriangleDistanceType> point_triangle_distance_types(
+    const Eigen::MatrixXd& P,
+    const Eigen::MatrixXd& T0,
+    const Eigen::MatrixXd& T1,
+    const Eigen::MatrixXd& T2)
+{
+    assert(P.cols() == 3);
+    assert(T0.rows() == P.rows() && T0.cols() == 3);
+    assert(T1.rows() == P.rows() && T1.cols() == 3);
+    assert(T2.rows() == P.rows() && T2.cols() == 3);
+
+    const Eigen::MatrixXd normals = rowwise_cross(T1 - T0, T2 - T0);
+
+    // For each triangle edge, solve the same 2×2 system as the per-query
+    // classifier (Cramer's rule instead of LDLT) for the barycentric
+    // parameters along the edge (alpha) and away from it (beta).
+    Eigen::ArrayXXd alpha(P.rows(), 3), beta(P.rows(), 3);
+    const std::array<const Eigen::MatrixXd*, 3> origins = { { &T0, &T1,
+                                                              &T2 } };
+    const std::array<const Eigen::MatrixXd*, 3> tips = { { &T1, &T2, &T0 } };
+    for (int k = 0; k < 3; k++) {
+        const Eigen::MatrixXd d = *tips[k] - *origins[k];
+        const Eigen::MatrixXd b = rowwise_cross(d, normals);
+        const Eigen::MatrixXd p_minus_o = P - *origins[k];
+
+        const Eigen::ArrayXd m00 = d.rowwise().squaredNorm();
+        const Eigen::ArrayXd m01 =
+            (d.array() * b.array()).rowwise().sum();
+        const Eigen::ArrayXd m11 = b.rowwise().squaredNorm();
+        const Eigen::ArrayXd r0 =
+            (d.array() * p_minus_o.array()).rowwise().sum();
+        const Eigen::ArrayXd r1 =
+            (b.array() * p_minus_o.array()).rowwise().sum();
+
+        const Eigen::ArrayXd det = m00 * m11 - m01.square();
+        alpha.col(k) = (r0 * m11 - r1 * m01) / det;
+        beta.col(k) = (r1 * m00 - r0 * m01) / det;
+    }
+
+    // The per-query cascade in priority order, evaluated per lane with
+    // arithmetic selects instead of branches.
+    const auto closest_to_edge = [&](int k) {
+        return alpha.col(k) > 0.0 && alpha.col(k) < 1.0
+            && beta.col(k) >= 0.0;
+    };
+    const auto closest_to_vertex = [&](int k) {
+        return alpha.col(k) <= 0.0 && alpha.col((k + 2) % 3) >= 1.0;
+    };
+
+    const Eigen::ArrayXi types = closest_to_edge(0).select(
+        int(PointTriangleDistanceType::P_E0),
+        closest_to_edge(1).select(
+            int(PointTriangleDistanceType::P_E1),
+            closest_to_edge(2).select(
+                int(PointTriangleDistanceType::P_E2),
+                closest_to_vertex(0).select(
+                    int(PointTriangleDistanceType::P_T0),
+                    closest_to_vertex(1).select(
+                        int(PointTriangleDistanceType::P_T1),
+                        closest_to_vertex(2).select(
+                            int(PointTriangleDistanceType::P_T2),
+                            Eigen::ArrayXi::Constant(
+                                P.rows(),
+                                int(PointTriangleDistanceType::P_T))))))));
+
+    std::vector<PointTriangleDistanceType> dtypes(P.rows());
+    for (long i = 0; i < P.rows(); i++) {
+        dtypes[i] = PointTriangleDistanceType(types[i]);
+    }
+    return dtypes;
+}
+
+Eigen::VectorXd point_triangle_distances(
+    const Eigen::MatrixXd& P,
+    const Eigen::MatrixXd& T0,
+    const Eigen::MatrixXd& T1,
+    const Eigen::MatrixXd& T2)
+{
+    return point_triangle_distances(
+        P, T0, T1, T2, point_triangle_distance_types(P, T0, T1, T2));
+}
+
+Eigen::VectorXd point_triangle_distances(
+    const Eigen::MatrixXd& P,
+    const Eigen::MatrixXd& T0,
+    const Eigen::MatrixXd& T1,
+    const Eigen::MatrixXd& T2,
+    const std::vector<PointTriangleDistanceType>& dtypes)
+{
+    assert(P.cols() == 3);
+    assert(T0.rows() == P.rows() && T0.cols() == 3);
+    assert(T1.rows() == P.rows() && T1.cols() == 3);
+    assert(T2.rows() == P.rows() && T2.cols() == 3);
+    assert(long(dtypes.size()) == P.rows());
+
+    // Group the candidates by distance type so each group runs through a
+    // single vectorized kernel.
+    std::array<std::vector<long>, 7> groups;
+    for (long i = 0; i < P.rows(); i++) {
+        groups[int(dtypes[i])].push_back(i);
+    }
+
+    Eigen::VectorXd distances(P.rows());
+    for (int type = 0; type < int(groups.size()); type++) {
+        const std::vector<long>& rows = groups[type];
+        if (rows.empty()) {
+            continue;
+        }
+
+        const Eigen::MatrixXd p = gather_rows(P, rows);
+        const Eigen::MatrixXd t0 = gather_rows(T0, rows);
+        const Eigen::MatrixXd t1 = gather_rows(T1, rows);
+        const Eigen::MatrixXd t2 = gather_rows(T2, rows);
+
+        Eigen::VectorXd group_distances;
+        switch (PointTriangleDistanceType(type)) {
+        case PointTriangleDistanceType::P_T0:
+            group_distances = point_point_distances(p, t0);
+            break;
+
+        case PointTriangleDistanceType::P_T1:
+            group_distances = point_point_distances(p, t1);
+            break;
+
+        case PointTriangleDistanceType::P_T2:
+            group_distances = point_point_distances(p, t2);
+            break;
+
+        case PointTriangleDistanceType::P_E0:
+            group_distances = point_line_distances(p, t0, t1);
+            break;
+
+        case PointTriangleDistanceType::P_E1:
+            group_distances = point_line_distances(p, t1, t2);
+            break;
+
+        case PointTriangleDistanceType::P_E2:
+            group_distances = point_line_distances(p, t2, t0);
+            break;
+
+        case PointTriangleDistanceType::P_T:
+            group_distances = point_plane_distances(p, t0, t1, t2);
+            break;
+
+        default:
+            throw std::invalid_argument(
+                "Invalid distance type for point-triangle distance!");
+        }
+
+        scatter_distances(group_distances, rows, distances);
+    }
+
+    return distances;
+}
+
+Eigen::VectorXd edge_edge_distances(
+    const Eigen::MatrixXd& EA0,
+    const Eigen::MatrixXd& EA1,
+    const Eigen::MatrixXd& EB0,
+    const Eigen::MatrixXd& EB1)
+{
+    std::vector<EdgeEdgeDistanceType> dtypes(EA0.rows());
+    for (long i = 0; i < EA0.rows(); i++) {
+        dtypes[i] = edge_edge_distance_type(
+            EA0.row(i), EA1.row(i), EB0.row(i), EB1.row(i));
+    }
+    return edge_edge_distances(EA0, EA1, EB0, EB1, dtypes);
+}
+
+Eigen::VectorXd edge_edge_distances(
+    const Eigen::MatrixXd& EA0,
+    const Eigen::MatrixXd& EA1,
+    const Eigen::MatrixXd& EB0,
+    const Eigen::MatrixXd& EB1,
+    const std::vector<EdgeEdgeDistanceType>& dtypes)
+{
+    assert(EA0.cols() == 3);
+    assert(EA1.rows() == EA0.rows() && EA1.cols() == 3);
+    assert(EB0.rows() == EA0.rows() && EB0.cols() == 3);
+    assert(EB1.rows() == EA0.rows() && EB1.cols() == 3);
+    assert(long(dtypes.size()) == EA0.rows());
+
+    std::array<std::vector<long>, 9> groups;
+    for (long i = 0; i < EA0.rows(); i++) {
+        groups[int(dtypes[i])].push_back(i);
+    }
+
+    Eigen::VectorXd distances(EA0.rows());
+    for (int type = 0; type < int(groups.size()); type++) {
+        const std::vector<long>& rows = groups[type];
+        if (rows.empty()) {
+            continue;
+        }
+
+        const Eigen::MatrixXd ea0 = gather_rows(EA0, rows);
+        const Eigen::MatrixXd ea1 = gather_rows(EA1, rows);
+        const Eigen::MatrixXd eb0 = gather_rows(EB0, rows);
+        const Eigen::MatrixXd eb1 = gather_rows(EB1, rows);
+
+        Eigen::VectorXd group_distances;
+        switch (EdgeEdgeDistanceType(type)) {
+        case EdgeEdgeDistanceType::EA0_EB0:
+            group_distances = point_point_distances(ea0, eb0);
+            break;
+
+        case EdgeEdgeDistanceType::EA0_EB1:
+            group_distances = point_point_distances(ea0, eb1);
+            break;
+
+        case EdgeEdgeDistanceType::EA1_EB0:
+            group_distances = point_point_distances(ea1, eb0);
+            break;
+
+        case EdgeEdgeDistanceType::EA1_EB1:
+            group_distances = point_point_distances(ea1, eb1);
+            break;
+
+        case EdgeEdgeDistanceType::EA_EB0:
+            group_distances = point_line_distances(eb0, ea0, ea1);
+            break;
+
+        case EdgeEdgeDistanceType::EA_EB1:
+            group_distances = point_line_distances(eb1, ea0, ea1);
+            break;
+
+        case EdgeEdgeDistanceType::EA0_EB:
+            group_distances = point_line_distances(ea0, eb0, eb1);
+            break;
+
+        case EdgeEdgeDistanceType::EA1_EB:
+            group_distances = point_line_distances(ea1, eb0, eb1);
+            break;
+
+        case EdgeEdgeDistanceType::EA_EB:
+            group_distances = line_line_distances(ea0, ea1, eb0, eb1);
+            break;
+
+        default:
+            throw std::invalid_argument(
+                "Invalid distance type for edge-edge distance!");
+        }
+
+        scatter_distances(group_distances, rows, distances);
+    }
+
+    return distances;
+}
+
+} // namespace ipc
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <ipc/distance/distance_type.hpp>
+
+#include <Eigen/Core>
+
+#include <vector>
+
+namespace ipc {
+
+/// @brief Classify a batch of point-triangle pairs by distance type.
+///
+/// All barycentric region predicates are evaluated arithmetically over
+/// whole columns and combined with per-lane selects, so the classification
+/// is branchless and vectorizes over the batch instead of walking the
+/// per-query cascade of mispredicting branches.
+/// @param P The points (one per row).
+/// @param T0 The first vertices of the triangles (one per row).
+/// @param T1 The second vertices of the triangles (one per row).
+/// @param T2 The third vertices of the triangles (one per row).
+/// @return The distance type of each point-triangle pair.
+std::vector<PointTriangleDistanceType> point_triangle_distance_types(
+    const Eigen::MatrixXd& P,
+    const Eigen::MatrixXd& T0,
+    const Eigen::MatrixXd& T1,
+    const Eigen::MatrixXd& T2);
+
+/// @brief Compute the distances between a batch of point-triangle pairs.
+///
+/// The candidates are stored in structure-of-arrays form: row i of every
+/// argument holds the corresponding vertex of candidate i. Candidates are
+/// grouped by distance type and each homogeneous group is evaluated with a
+/// vectorized kernel, so Eigen can emit SIMD arithmetic over whole columns
+/// instead of one three-vector at a time.
+/// @note The distances are actually squared distances.
+/// @param P The points (one per row).
+/// @param T0 The first vertices of the triangles (one per row).
+/// @param T1 The second vertices of the triangles (one per row).
+/// @param T2 The third vertices of the triangles (one per row).
+/// @return The distances between the points and triangles.
+Eigen::VectorXd point_triangle_distances(
+    const Eigen::MatrixXd& P,
+    const Eigen::MatrixXd& T0,
+    const Eigen::MatrixXd& T1,
+    const Eigen::MatrixXd& T2);
+
+/// @brief Compute the distances between a batch of point-triangle pairs.
+/// @note The distances are actually squared distances.
+/// @param P The points (one per row).
+/// @param T0 The first vertices of the triangles (one per row).
+/// @param T1 The second vertices of the triangles (one per row).
+/// @param T2 The third vertices of the triangles (one per row).
+/// @param dtypes The point-triangle distance type of each candidate.
+/// @return The distances between the points and triangles.
+Eigen::VectorXd point_triangle_distances(
+    const Eigen::MatrixXd& P,
+    const Eigen::MatrixXd& T0,
+    const Eigen::MatrixXd& T1,
+    const Eigen::MatrixXd& T2,
+    const std::vector<PointTriangleDistanceType>& dtypes);
+
+/// @brief Compute the distances between a batch of edge-edge pairs.
+///
+/// See point_triangle_distances for the structure-of-arrays layout.
+/// @note The distances are actually squared distances.
+/// @param EA0 The first vertices of the first edges (one per row).
+/// @param EA1 The second vertices of the first edges (one per row).
+/// @param EB0 The first vertices of the second edges (one per row).
+/// @param EB1 The second vertices of the second edges (one per row).
+/// @return The distances between the edge pairs.
+Eigen::VectorXd edge_edge_distances(
+    const Eigen::MatrixXd& EA0,
+    const Eigen::MatrixXd& EA1,
+    const Eigen::MatrixXd& EB0,
+    const Eigen::MatrixXd& EB1);
+
+/// @brief Compute the distances between a batch of edge-edge pairs.
+/// @note The distances are actually squared distances.
+/// @param EA0 The first vertices of the first edges (one per row).
+/// @param EA1 The second vertices of the first edges (one per row).
+/// @param EB0 The first vertices of the second edges (one per row).
+/// @param EB1 The second vertices of the second edges (one per row).
+/// @param dtypes The edge-edge distance type of each candidate.
+/// @return The distances between the edge pairs.
+Eigen::VectorXd edge_edge_distances(
+    const Eigen::MatrixXd& EA0,
+    const Eigen::MatrixXd& EA1,
+    const Eigen::MatrixXd& EB0,
+    const Eigen::MatrixXd& EB1,
+    const std::vector<EdgeEdgeDistanceType>& dtypes);
+
+} // namespace ipc
@@ -0,0 +1,109 @@
+#include "distance_type.hpp"
+
+namespace ipc {
+
+// Explicit instantiations matching the extern template declarations in
+// distance_type.hpp.
+
+template PointEdgeDistanceType
+point_edge_distance_type<Eigen::Vector2f, Eigen::Vector2f, Eigen::Vector2f>(
+    const Eigen::MatrixBase<Eigen::Vector2f>&,
+    const Eigen::MatrixBase<Eigen::Vector2f>&,
+    const Eigen::MatrixBase<Eigen::Vector2f>&);
+template PointEdgeDistanceType
+point_edge_distance_type<Eigen::Vector3f, Eigen::Vector3f, Eigen::Vector3f>(
+    const Eigen::MatrixBase<Eigen::Vector3f>&,
+    const Eigen::MatrixBase<Eigen::Vector3f>&,
+    const Eigen::MatrixBase<Eigen::Vector3f>&);
+template PointEdgeDistanceType
+point_edge_distance_type<Eigen::Vector2d, Eigen::Vector2d, Eigen::Vector2d>(
+    const Eigen::MatrixBase<Eigen::Vector2d>&,
+    const Eigen::MatrixBase<Eigen::Vector2d>&,
+    const Eigen::MatrixBase<Eigen::Vector2d>&);
+template PointEdgeDistanceType
+point_edge_distance_type<Eigen::Vector3d, Eigen::Vector3d, Eigen::Vector3d>(
+    const Eigen::MatrixBase<Eigen::Vector3d>&,
+    const Eigen::MatrixBase<Eigen::Vector3d>&,
+    const Eigen::MatrixBase<Eigen::Vector3d>&);
+
+template PointTriangleDistanceType point_triangle_distance_type<
+    Eigen::Vector3f,
+    Eigen::Vector3f,
+    Eigen::Vector3f,
+    Eigen::Vector3f>(
+    const Eigen::MatrixBase<Eigen::Vector3f>&,
+    const Eigen::MatrixBase<Eigen::Vector3f>&,
+    const Eigen::MatrixBase<Eigen::Vector3f>&,
+    const Eigen::MatrixBase<Eigen::Vector3f>&);
+template PointTriangleDistanceType point_triangle_distance_type<
+    Eigen::Vector3d,
+    Eigen::Vector3d,
+    Eigen::Vector3d,
+    Eigen::Vector3d>(
+    const Eigen::MatrixBase<Eigen::Vector3d>&,
+    const Eigen::MatrixBase<Eigen::Vector3d>&,
+    const Eigen::MatrixBase<Eigen::Vector3d>&,
+    const Eigen::MatrixBase<Eigen::Vector3d>&);
+
+template EdgeEdgeDistanceType edge_edge_distance_type<
+    Eigen::Vector3f,
+    Eigen::Vector3f,
+    Eigen::Vector3f,
+    Eigen::Vector3f>(
+    const Eigen::MatrixBase<Eigen::Vector3f>&,
+    const Eigen::MatrixBase<Eigen::Vector3f>&,
+    const Eigen::MatrixBase<Eigen::Vector3f>&,
+    const Eigen::MatrixBase<Eigen::Vector3f>&);
+template EdgeEdgeDistanceType edge_edge_distance_type<
+    Eigen::Vector3d,
+    Eigen::Vector3d,
+    Eigen::Vector3d,
+    Eigen::Vector3d>(
+    const Eigen::MatrixBase<Eigen::Vector3d>&,
+    const Eigen::MatrixBase<Eigen::Vector3d>&,
+    const Eigen::MatrixBase<Eigen::Vector3d>&,
+    const Eigen::MatrixBase<Eigen::Vector3d>&);
+
+template PointTriangleDistanceType point_triangle_distance_type<
+    Eigen::Vector3f,
+    Eigen::Vector3f,
+    Eigen::Vector3f,
+    Eigen::Vector3f>(
+    const Eigen::MatrixBase<Eigen::Vector3f>&,
+    const Eigen::MatrixBase<Eigen::Vector3f>&,
+    const Eigen::MatrixBase<Eigen::Vector3f>&,
+    const Eigen::MatrixBase<Eigen::Vector3f>&,
+    const PointTriangleDistanceType);
+template PointTriangleDistanceType point_triangle_distance_type<
+    Eigen::Vector3d,
+    Eigen::Vector3d,
+    Eigen::Vector3d,
+    Eigen::Vector3d>(
+    const Eigen::MatrixBase<Eigen::Vector3d>&,
+    const Eigen::MatrixBase<Eigen::Vector3d>&,
+    const Eigen::MatrixBase<Eigen::Vector3d>&,
+    const Eigen::MatrixBase<Eigen::Vector3d>&,
+    const PointTriangleDistanceType);
+
+template EdgeEdgeDistanceType edge_edge_distance_type<
+    Eigen::Vector3f,
+    Eigen::Vector3f,
+    Eigen::Vector3f,
+    Eigen::Vector3f>(
+    const Eigen::MatrixBase<Eigen::Vector3f>&,
+    const Eigen::MatrixBase<Eigen::Vector3f>&,
+    const Eigen::MatrixBase<Eigen::Vector3f>&,
+    const Eigen::MatrixBase<Eigen::Vector3f>&,
+    const EdgeEdgeDistanceType);
+template EdgeEdgeDistanceType edge_edge_distance_type<
+    Eigen::Vector3d,
+    Eigen::Vector3d,
+    Eigen::Vector3d,
+    Eigen::Vector3d>(
+    const Eigen::MatrixBase<Eigen::Vector3d>&,
+    const Eigen::MatrixBase<Eigen::Vector3d>&,
+    const Eigen::MatrixBase<Eigen::Vector3d>&,
+    const Eigen::MatrixBase<Eigen::Vector3d>&,
+    const EdgeEdgeDistanceType);
+
+} // namespace ipc
@@ -84,6 +84,166 @@ EdgeEdgeDistanceType edge_edge_distance_type(
     const Eigen::MatrixBase<DerivedEB0>& eb0,
     const Eigen::MatrixBase<DerivedEB1>& eb1);
 
+/// @brief Determine the closest pair between a point and triangle with a hint.
+///
+/// The closest feature rarely changes between consecutive solver iterations,
+/// so the hinted region's optimality conditions are verified first (a handful
+/// of dot products) and the full classification cascade only runs when the
+/// hint is no longer valid.
+///
+/// @param p The point.
+/// @param t0 The first vertex of the triangle.
+/// @param t1 The second vertex of the triangle.
+/// @param t2 The third vertex of the triangle.
+/// @param hint The distance type from a previous classification.
+/// @return The distance type of the point-triangle pair.
+template <
+    typename DerivedP,
+    typename DerivedT0,
+    typename DerivedT1,
+    typename DerivedT2>
+PointTriangleDistanceType point_triangle_distance_type(
+    const Eigen::MatrixBase<DerivedP>& p,
+    const Eigen::MatrixBase<DerivedT0>& t0,
+    const Eigen::MatrixBase<DerivedT1>& t1,
+    const Eigen::MatrixBase<DerivedT2>& t2,
+    const PointTriangleDistanceType hint);
+
+/// @brief Determine the closest pair between two edges with a hint.
+///
+/// The closest feature rarely changes between consecutive solver iterations,
+/// so the hinted region's optimality conditions are verified first (a handful
+/// of dot products) and the full classification cascade only runs when the
+/// hint is no longer valid.
+///
+/// @param ea0 The first vertex of the first edge.
+/// @param ea1 The second vertex of the first edge.
+/// @param eb0 The first vertex of the second edge.
+/// @param eb1 The second vertex of the second edge.
+/// @param hint The distance type from a previous classification.
+/// @return The distance type of the edge-edge pair.
+template <
+    typename DerivedEA0,
+    typename DerivedEA1,
+    typename DerivedEB0,
+    typename DerivedEB1>
+EdgeEdgeDistanceType edge_edge_distance_type(
+    const Eigen::MatrixBase<DerivedEA0>& ea0,
+    const Eigen::MatrixBase<DerivedEA1>& ea1,
+    const Eigen::MatrixBase<DerivedEB0>& eb0,
+    const Eigen::MatrixBase<DerivedEB1>& eb1,
+    const EdgeEdgeDistanceType hint);
+
 } // namespace ipc
 
 #include <ipc/distance/distance_type.tpp>
+
+namespace ipc {
+
+// The classifiers are instantiated for the common concrete vector types in
+// both precisions (see distance_type.cpp), so translation units working with
+// float-mirrored positions link against shared instantiations instead of
+// re-instantiating the templates.
+
+extern template PointEdgeDistanceType
+point_edge_distance_type<Eigen::Vector2f, Eigen::Vector2f, Eigen::Vector2f>(
+    const Eigen::MatrixBase<Eigen::Vector2f>&,
+    const Eigen::MatrixBase<Eigen::Vector2f>&,
+    const Eigen::MatrixBase<Eigen::Vector2f>&);
+extern template PointEdgeDistanceType
+point_edge_distance_type<Eigen::Vector3f, Eigen::Vector3f, Eigen::Vector3f>(
+    const Eigen::MatrixBase<Eigen::Vector3f>&,
+    const Eigen::MatrixBase<Eigen::Vector3f>&,
+    const Eigen::MatrixBase<Eigen::Vector3f>&);
+extern template PointEdgeDistanceType
+point_edge_distance_type<Eigen::Vector2d, Eigen::Vector2d, Eigen::Vector2d>(
+    const Eigen::MatrixBase<Eigen::Vector2d>&,
+    const Eigen::MatrixBase<Eigen::Vector2d>&,
+    const Eigen::MatrixBase<Eigen::Vector2d>&);
+extern template PointEdgeDistanceType
+point_edge_distance_type<Eigen::Vector3d, Eigen::Vector3d, Eigen::Vector3d>(
+    const Eigen::MatrixBase<Eigen::Vector3d>&,
+    const Eigen::MatrixBase<Eigen::Vector3d>&,
+    const Eigen::MatrixBase<Eigen::Vector3d>&);
+
+extern template PointTriangleDistanceType point_triangle_distance_type<
+    Eigen::Vector3f,
+    Eigen::Vector3f,
+    Eigen::Vector3f,
+    Eigen::Vector3f>(
+    const Eigen::MatrixBase<Eigen::Vector3f>&,
+    const Eigen::MatrixBase<Eigen::Vector3f>&,
+    const Eigen::MatrixBase<Eigen::Vector3f>&,
+    const Eigen::MatrixBase<Eigen::Vector3f>&);
+extern template PointTriangleDistanceType point_triangle_distance_type<
+    Eigen::Vector3d,
+    Eigen::Vector3d,
+    Eigen::Vector3d,
+    Eigen::Vector3d>(
+    const Eigen::MatrixBase<Eigen::Vector3d>&,
+    const Eigen::MatrixBase<Eigen::Vector3d>&,
+    const Eigen::MatrixBase<Eigen::Vector3d>&,
+    const Eigen::MatrixBase<Eigen::Vector3d>&);
+
+extern template EdgeEdgeDistanceType edge_edge_distance_type<
+    Eigen::Vector3f,
+    Eigen::Vector3f,
+    Eigen::Vector3f,
+    Eigen::Vector3f>(
+    const Eigen::MatrixBase<Eigen::Vector3f>&,
+    const Eigen::MatrixBase<Eigen::Vector3f>&,
+    const Eigen::MatrixBase<Eigen::Vector3f>&,
+    const Eigen::MatrixBase<Eigen::Vector3f>&);
+extern template EdgeEdgeDistanceType edge_edge_distance_type<
+    Eigen::Vector3d,
+    Eigen::Vector3d,
+    Eigen::Vector3d,
+    Eigen::Vector3d>(
+    const Eigen::MatrixBase<Eigen::Vector3d>&,
+    const Eigen::MatrixBase<Eigen::Vector3d>&,
+    const Eigen::MatrixBase<Eigen::Vector3d>&,
+    const Eigen::MatrixBase<Eigen::Vector3d>&);
+
+extern template PointTriangleDistanceType point_triangle_distance_type<
+    Eigen::Vector3f,
+    Eigen::Vector3f,
+    Eigen::Vector3f,
+    Eigen::Vector3f>(
+    const Eigen::MatrixBase<Eigen::Vector3f>&,
+    const Eigen::MatrixBase<Eigen::Vector3f>&,
+    const Eigen::MatrixBase<Eigen::Vector3f>&,
+    const Eigen::MatrixBase<Eigen::Vector3f>&,
+    const PointTriangleDistanceType);
+extern template PointTriangleDistanceType point_triangle_distance_type<
+    Eigen::Vector3d,
+    Eigen::Vector3d,
+    Eigen::Vector3d,
+    Eigen::Vector3d>(
+    const Eigen::MatrixBase<Eigen::Vector3d>&,
+    const Eigen::MatrixBase<Eigen::Vector3d>&,
+    const Eigen::MatrixBase<Eigen::Vector3d>&,
+    const Eigen::MatrixBase<Eigen::Vector3d>&,
+    const PointTriangleDistanceType);
+
+extern template EdgeEdgeDistanceType edge_edge_distance_type<
+    Eigen::Vector3f,
+    Eigen::Vector3f,
+    Eigen::Vector3f,
+    Eigen::Vector3f>(
+    const Eigen::MatrixBase<Eigen::Vector3f>&,
+    const Eigen::MatrixBase<Eigen::Vector3f>&,
+    const Eigen::MatrixBase<Eigen::Vector3f>&,
+    const Eigen::MatrixBase<Eigen::Vector3f>&,
+    const EdgeEdgeDistanceType);
+extern template EdgeEdgeDistanceType edge_edge_distance_type<
+    Eigen::Vector3d,
+    Eigen::Vector3d,
+    Eigen::Vector3d,
+    Eigen::Vector3d>(
+    const Eigen::MatrixBase<Eigen::Vector3d>&,
+    const Eigen::MatrixBase<Eigen::Vector3d>&,
+    const Eigen::MatrixBase<Eigen::Vector3d>&,
+    const Eigen::MatrixBase<Eigen::Vector3d>&,
+    const EdgeEdgeDistanceType);
+
+} // namespace ipc
@@ -7,6 +7,8 @@
 
 #include <Eigen/Geometry>
 
+#include <type_traits>
+
 namespace ipc {
 
 template <typename DerivedP, typename DerivedE0, typename DerivedE1>
@@ -144,9 +146,16 @@ EdgeEdgeDistanceType edge_edge_distance_type(
         tD = c;
         defaultCase = EdgeEdgeDistanceType::EA1_EB;
     } else {
+        // The nearly-parallel threshold is loosened in single precision,
+        // where the cross product carries proportionally more rounding
+        // error.
+        typedef typename DerivedEA0::Scalar Scalar;
+        constexpr double PARALLEL_THRESHOLD =
+            std::is_same<Scalar, float>::value ? 1.0e-10 : 1.0e-20;
+
         tN = (a * e - b * d);
         if (tN > 0.0 && tN < tD
-            && (cross(u, v).squaredNorm() < 1.0e-20 * a * c)) {
+            && (cross(u, v).squaredNorm() < PARALLEL_THRESHOLD * a * c)) {
             // avoid nearly parallel EE
             if (sN < D / 2) {
                 tN = e;
@@ -184,4 +193,152 @@ EdgeEdgeDistanceType edge_edge_distance_type(
     return defaultCase;
 }
 
+template <
+    typename DerivedP,
+    typename DerivedT0,
+    typename DerivedT1,
+    typename DerivedT2>
+PointTriangleDistanceType point_triangle_distance_type(
+    const Eigen::MatrixBase<DerivedP>& p,
+    const Eigen::MatrixBase<DerivedT0>& t0,
+    const Eigen::MatrixBase<DerivedT1>& t1,
+    const Eigen::MatrixBase<DerivedT2>& t2,
+    const PointTriangleDistanceType hint)
+{
+    typedef typename DerivedP::Scalar T;
+
+    assert(p.size() == 3);
+    assert(t0.size() == 3);
+    assert(t1.size() == 3);
+    assert(t2.size() == 3);
+
+    // Verify the optimality conditions of the hinted Voronoi region (see
+    // Ericson "Real-Time Collision Detection" §5.1.5). On the boundary
+    // between two regions both classifications yield the same distance, so
+    // accepting the hint with non-strict inequalities is safe.
+    const Vector3<T> ab = t1 - t0, ac = t2 - t0;
+    const Vector3<T> ap = p - t0, bp = p - t1, cp = p - t2;
+    const T d1 = ab.dot(ap), d2 = ac.dot(ap);
+    const T d3 = ab.dot(bp), d4 = ac.dot(bp);
+    const T d5 = ab.dot(cp), d6 = ac.dot(cp);
+
+    bool hint_is_valid;
+    switch (hint) {
+    case PointTriangleDistanceType::P_T0:
+        hint_is_valid = d1 <= 0 && d2 <= 0;
+        break;
+    case PointTriangleDistanceType::P_T1:
+        hint_is_valid = d3 >= 0 && d4 <= d3;
+        break;
+    case PointTriangleDistanceType::P_T2:
+        hint_is_valid = d6 >= 0 && d5 <= d6;
+        break;
+    case PointTriangleDistanceType::P_E0:
+        hint_is_valid = d1 * d4 - d3 * d2 <= 0 && d1 >= 0 && d3 <= 0;
+        break;
+    case PointTriangleDistanceType::P_E1:
+        hint_is_valid = d3 * d6 - d5 * d4 <= 0 && d4 >= d3 && d5 >= d6;
+        break;
+    case PointTriangleDistanceType::P_E2:
+        hint_is_valid = d5 * d2 - d1 * d6 <= 0 && d2 >= 0 && d6 <= 0;
+        break;
+    case PointTriangleDistanceType::P_T:
+        hint_is_valid = d3 * d6 - d5 * d4 >= 0 && d5 * d2 - d1 * d6 >= 0
+            && d1 * d4 - d3 * d2 >= 0;
+        break;
+    default:
+        hint_is_valid = false;
+        break;
+    }
+
+    return hint_is_valid ? hint : point_triangle_distance_type(p, t0, t1, t2);
+}
+
+template <
+    typename DerivedEA0,
+    typename DerivedEA1,
+    typename DerivedEB0,
+    typename DerivedEB1>
+EdgeEdgeDistanceType edge_edge_distance_type(
+    const Eigen::MatrixBase<DerivedEA0>& ea0,
+    const Eigen::MatrixBase<DerivedEA1>& ea1,
+    const Eigen::MatrixBase<DerivedEB0>& eb0,
+    const Eigen::MatrixBase<DerivedEB1>& eb1,
+    const EdgeEdgeDistanceType hint)
+{
+    typedef typename DerivedEA0::Scalar Scalar;
+    constexpr double PARALLEL_THRESHOLD =
+        std::is_same<Scalar, float>::value ? 1.0e-10 : 1.0e-20;
+
+    assert(ea0.size() == 3);
+    assert(ea1.size() == 3);
+    assert(eb0.size() == 3);
+    assert(eb1.size() == 3);
+
+    const auto u = ea1 - ea0;
+    const auto v = eb1 - eb0;
+    const auto w = ea0 - eb0;
+
+    const auto a = u.squaredNorm();
+    const auto b = u.dot(v);
+    const auto c = v.squaredNorm();
+    const auto d = u.dot(w);
+    const auto e = v.dot(w);
+
+    // Verify the KKT conditions of the hinted region for the distance
+    // minimized over the edge parameters (s, t) ∈ [0, 1]²:
+    //     ∂f/∂s ∝ a s − b t + d and ∂f/∂t ∝ c t − b s − e.
+    // The conditions are written division-free by scaling with a ≥ 0 and
+    // c ≥ 0. On the boundary between two regions both classifications yield
+    // the same distance, so accepting with non-strict inequalities is safe.
+    bool hint_is_valid;
+    switch (hint) {
+    case EdgeEdgeDistanceType::EA0_EB0:
+        hint_is_valid = d >= 0 && e <= 0;
+        break;
+    case EdgeEdgeDistanceType::EA0_EB1:
+        hint_is_valid = d >= b && e >= c;
+        break;
+    case EdgeEdgeDistanceType::EA1_EB0:
+        hint_is_valid = a + d <= 0 && b + e <= 0;
+        break;
+    case EdgeEdgeDistanceType::EA1_EB1:
+        hint_is_valid = a - b + d <= 0 && c - b - e <= 0;
+        break;
+    case EdgeEdgeDistanceType::EA_EB0:
+        // s* = −d/a ∈ [0, 1] and ∂f/∂t at (s*, 0) is nonnegative
+        hint_is_valid = -d >= 0 && -d <= a && b * d - a * e >= 0;
+        break;
+    case EdgeEdgeDistanceType::EA_EB1:
+        // s* = (b − d)/a ∈ [0, 1] and ∂f/∂t at (s*, 1) is nonpositive
+        hint_is_valid =
+            b - d >= 0 && b - d <= a && a * (c - e) - b * (b - d) <= 0;
+        break;
+    case EdgeEdgeDistanceType::EA0_EB:
+        // t* = e/c ∈ [0, 1] and ∂f/∂s at (0, t*) is nonnegative
+        hint_is_valid = e >= 0 && e <= c && c * d - b * e >= 0;
+        break;
+    case EdgeEdgeDistanceType::EA1_EB:
+        // t* = (e + b)/c ∈ [0, 1] and ∂f/∂s at (1, t*) is nonpositive
+        hint_is_valid =
+            e + b >= 0 && e + b <= c && c * (a + d) - b * (e + b) <= 0;
+        break;
+    case EdgeEdgeDistanceType::EA_EB: {
+        // Interior optimum; defer nearly parallel edges to the full
+        // classification, which reroutes them to an edge-vertex region.
+        const auto D = a * c - b * b;
+        const auto sN = b * e - c * d;
+        const auto tN = a * e - b * d;
+        hint_is_valid = sN >= 0 && sN <= D && tN >= 0 && tN <= D
+            && cross(u, v).squaredNorm() >= PARALLEL_THRESHOLD * a * c;
+        break;
+    }
+    default:
+        hint_is_valid = false;
+        break;
+    }
+
+    return hint_is_valid ? hint : edge_edge_distance_type(ea0, ea1, eb0, eb1);
+}
+
 } // namespace ipc
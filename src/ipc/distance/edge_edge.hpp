@@ -5,6 +5,7 @@
 #include <ipc/distance/point_line.hpp>
 #include <ipc/distance/line_line.hpp>
 
+#include <algorithm> // std::min/max
 #include <stdexcept> // std::invalid_argument
 
 namespace ipc {
@@ -124,6 +125,95 @@ void edge_edge_distance_gradient(
         ea0, ea1, eb0, eb1, edge_edge_distance_type(ea0, ea1, eb0, eb1), grad);
 }
 
+/// @brief Determine if the edge-edge distance is within a threshold.
+///
+/// Cheap lower bounds on the distance (the distance between the edges'
+/// bounding boxes and between their supporting lines) are tested first, so
+/// most queries exit before classifying the closest pair or computing the
+/// exact distance.
+/// @note The threshold is compared against the squared distance.
+/// @param ea0 The first vertex of the first edge.
+/// @param ea1 The second vertex of the first edge.
+/// @param eb0 The first vertex of the second edge.
+/// @param eb1 The second vertex of the second edge.
+/// @param threshold_sqr The squared distance threshold.
+/// @param[out] dtype The distance type of the edge-edge pair.
+/// @param[out] distance_sqr The squared distance between the edges.
+/// @note The outputs are only written when every cheap lower bound is
+/// within the threshold.
+/// @return True if the squared distance is less than the threshold.
+template <
+    typename DerivedEA0,
+    typename DerivedEA1,
+    typename DerivedEB0,
+    typename DerivedEB1>
+bool edge_edge_distance_is_within(
+    const Eigen::MatrixBase<DerivedEA0>& ea0,
+    const Eigen::MatrixBase<DerivedEA1>& ea1,
+    const Eigen::MatrixBase<DerivedEB0>& eb0,
+    const Eigen::MatrixBase<DerivedEB1>& eb1,
+    const double threshold_sqr,
+    EdgeEdgeDistanceType& dtype,
+    double& distance_sqr)
+{
+    assert(ea0.size() == 3);
+    assert(ea1.size() == 3);
+    assert(eb0.size() == 3);
+    assert(eb1.size() == 3);
+
+    // Distance between the edges' axis-aligned bounding boxes is a lower
+    // bound.
+    double bbox_distance_sqr = 0;
+    for (int d = 0; d < 3; d++) {
+        const double a_lo = std::min(ea0[d], ea1[d]);
+        const double a_hi = std::max(ea0[d], ea1[d]);
+        const double b_lo = std::min(eb0[d], eb1[d]);
+        const double b_hi = std::max(eb0[d], eb1[d]);
+        const double gap = std::max({ a_lo - b_hi, b_lo - a_hi, 0.0 });
+        bbox_distance_sqr += gap * gap;
+    }
+    if (bbox_distance_sqr >= threshold_sqr) {
+        return false;
+    }
+
+    // Distance between the edges' supporting lines is a lower bound (it
+    // degenerates towards zero for near-parallel edges, which never
+    // rejects).
+    if (line_line_distance(ea0, ea1, eb0, eb1) >= threshold_sqr) {
+        return false;
+    }
+
+    dtype = edge_edge_distance_type(ea0, ea1, eb0, eb1);
+    distance_sqr = edge_edge_distance(ea0, ea1, eb0, eb1, dtype);
+    return distance_sqr < threshold_sqr;
+}
+
+/// @brief Determine if the edge-edge distance is within a threshold.
+/// @note The threshold is compared against the squared distance.
+/// @param ea0 The first vertex of the first edge.
+/// @param ea1 The second vertex of the first edge.
+/// @param eb0 The first vertex of the second edge.
+/// @param eb1 The second vertex of the second edge.
+/// @param threshold_sqr The squared distance threshold.
+/// @return True if the squared distance is less than the threshold.
+template <
+    typename DerivedEA0,
+    typename DerivedEA1,
+    typename DerivedEB0,
+    typename DerivedEB1>
+bool edge_edge_distance_is_within(
+    const Eigen::MatrixBase<DerivedEA0>& ea0,
+    const Eigen::MatrixBase<DerivedEA1>& ea1,
+    const Eigen::MatrixBase<DerivedEB0>& eb0,
+    const Eigen::MatrixBase<DerivedEB1>& eb1,
+    const double threshold_sqr)
+{
+    EdgeEdgeDistanceType dtype;
+    double distance_sqr;
+    return edge_edge_distance_is_within(
+        ea0, ea1, eb0, eb1, threshold_sqr, dtype, distance_sqr);
+}
+
 /// @brief Compute the gradient of the distance between a two lines segments.
 /// @note The distance is actually squared distance.
 /// @param[in] ea0 The first vertex of the first edge.
@@ -1,6 +1,28 @@
 #include "point_plane.hpp"
 
 namespace ipc {
+
+Eigen::VectorXd point_plane_distances(
+    ConstMatrixXdRef P, const VectorMax3d& origin, const VectorMax3d& normal)
+{
+    assert(P.cols() == origin.size() && P.cols() == normal.size());
+    // s_i = (p_i - o)·n ⟹ d_i = s_i² / ‖n‖²
+    const Eigen::VectorXd s = (P.rowwise() - origin.transpose()) * normal;
+    return s.array().square().matrix() / normal.squaredNorm();
+}
+
+void point_plane_distance_gradients(
+    ConstMatrixXdRef P,
+    const VectorMax3d& origin,
+    const VectorMax3d& normal,
+    Eigen::MatrixXd& grads)
+{
+    assert(P.cols() == origin.size() && P.cols() == normal.size());
+    // ∇d_i = 2 s_i n / ‖n‖² (one outer product for the whole batch)
+    const Eigen::VectorXd s = (P.rowwise() - origin.transpose()) * normal;
+    grads = (2.0 / normal.squaredNorm()) * s * normal.transpose();
+}
+
 namespace autogen {
 
     // This function was generated by the Symbolic Math Toolbox version 8.3.
@@ -192,4 +192,34 @@ void point_plane_distance_hessian(
         t2[1], t2[2], hess.data());
 }
 
+/// @brief Compute the distances between a batch of points and one plane.
+/// @note The distances are actually squared distances.
+///
+/// The batch reduces to one dense matrix-vector product against the normal,
+/// so it vectorizes where the per-point overload cannot; use it when many
+/// vertices share a plane (e.g., granular material on the ground).
+/// @param P The points as rows of a matrix.
+/// @param origin The origin of the plane.
+/// @param normal The normal of the plane.
+/// @return The distance of each point to the plane (size P.rows()).
+Eigen::VectorXd point_plane_distances(
+    ConstMatrixXdRef P, const VectorMax3d& origin, const VectorMax3d& normal);
+
+/// @brief Compute the distance gradients between a batch of points and one plane.
+/// @note The distances are actually squared distances.
+///
+/// Row i of grads is the gradient of the i-th point's distance wrt that
+/// point (an outer product of the per-point plane offsets with the normal).
+/// The hessian is the same 2nnᵀ/‖n‖² for every point; use the per-point
+/// point_plane_distance_hessian() once per plane.
+/// @param[in] P The points as rows of a matrix.
+/// @param[in] origin The origin of the plane.
+/// @param[in] normal The normal of the plane.
+/// @param[out] grads The gradient of each point's distance (P.rows() × dim).
+void point_plane_distance_gradients(
+    ConstMatrixXdRef P,
+    const VectorMax3d& origin,
+    const VectorMax3d& normal,
+    Eigen::MatrixXd& grads);
+
 } // namespace ipc
@@ -5,6 +5,7 @@
 #include <ipc/distance/point_plane.hpp>
 #include <ipc/distance/point_point.hpp>
 
+#include <algorithm> // std::min/max
 #include <stdexcept> // std::invalid_argument
 
 namespace ipc {
@@ -118,6 +119,91 @@ void point_triangle_distance_gradient(
         p, t0, t1, t2, point_triangle_distance_type(p, t0, t1, t2), grad);
 }
 
+/// @brief Determine if the point-triangle distance is within a threshold.
+///
+/// Cheap lower bounds on the distance (the distance to the triangle's
+/// bounding box and to its supporting plane) are tested first, so most
+/// queries exit before classifying the closest pair or computing the exact
+/// distance.
+/// @note The threshold is compared against the squared distance.
+/// @param p The point.
+/// @param t0 The first vertex of the triangle.
+/// @param t1 The second vertex of the triangle.
+/// @param t2 The third vertex of the triangle.
+/// @param threshold_sqr The squared distance threshold.
+/// @param[out] dtype The distance type of the point-triangle pair.
+/// @param[out] distance_sqr The squared distance between the point and
+/// triangle.
+/// @note The outputs are only written when every cheap lower bound is
+/// within the threshold.
+/// @return True if the squared distance is less than the threshold.
+template <
+    typename DerivedP,
+    typename DerivedT0,
+    typename DerivedT1,
+    typename DerivedT2>
+bool point_triangle_distance_is_within(
+    const Eigen::MatrixBase<DerivedP>& p,
+    const Eigen::MatrixBase<DerivedT0>& t0,
+    const Eigen::MatrixBase<DerivedT1>& t1,
+    const Eigen::MatrixBase<DerivedT2>& t2,
+    const double threshold_sqr,
+    PointTriangleDistanceType& dtype,
+    double& distance_sqr)
+{
+    assert(p.size() == 3);
+    assert(t0.size() == 3);
+    assert(t1.size() == 3);
+    assert(t2.size() == 3);
+
+    // Distance to the triangle's axis-aligned bounding box is a lower bound.
+    double bbox_distance_sqr = 0;
+    for (int d = 0; d < 3; d++) {
+        const double lo = std::min({ t0[d], t1[d], t2[d] });
+        const double hi = std::max({ t0[d], t1[d], t2[d] });
+        const double gap = std::max({ lo - p[d], p[d] - hi, 0.0 });
+        bbox_distance_sqr += gap * gap;
+    }
+    if (bbox_distance_sqr >= threshold_sqr) {
+        return false;
+    }
+
+    // Distance to the triangle's supporting plane is a lower bound.
+    if (point_plane_distance(p, t0, t1, t2) >= threshold_sqr) {
+        return false;
+    }
+
+    dtype = point_triangle_distance_type(p, t0, t1, t2);
+    distance_sqr = point_triangle_distance(p, t0, t1, t2, dtype);
+    return distance_sqr < threshold_sqr;
+}
+
+/// @brief Determine if the point-triangle distance is within a threshold.
+/// @note The threshold is compared against the squared distance.
+/// @param p The point.
+/// @param t0 The first vertex of the triangle.
+/// @param t1 The second vertex of the triangle.
+/// @param t2 The third vertex of the triangle.
+/// @param threshold_sqr The squared distance threshold.
+/// @return True if the squared distance is less than the threshold.
+template <
+    typename DerivedP,
+    typename DerivedT0,
+    typename DerivedT1,
+    typename DerivedT2>
+bool point_triangle_distance_is_within(
+    const Eigen::MatrixBase<DerivedP>& p,
+    const Eigen::MatrixBase<DerivedT0>& t0,
+    const Eigen::MatrixBase<DerivedT1>& t1,
+    const Eigen::MatrixBase<DerivedT2>& t2,
+    const double threshold_sqr)
+{
+    PointTriangleDistanceType dtype;
+    double distance_sqr;
+    return point_triangle_distance_is_within(
+        p, t0, t1, t2, threshold_sqr, dtype, distance_sqr);
+}
+
 /// @brief Compute the gradient of the distance between a points and a triangle.
 /// @note The distance is actually squared distance.
 /// @param[in] p The point.
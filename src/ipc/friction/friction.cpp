@@ -1,5 +1,8 @@
 #include "friction.hpp"
 
+#include <ipc/utils/execution_context.hpp>
+#include <ipc/utils/ordered_reduction.hpp>
+#include <ipc/utils/profiler.hpp>
 #include <ipc/barrier/barrier.hpp>
 #include <ipc/distance/edge_edge.hpp>
 #include <ipc/distance/edge_edge_mollifier.hpp>
@@ -11,6 +14,7 @@
 #include <ipc/friction/tangent_basis.hpp>
 #include <ipc/utils/eigen_ext.hpp>
 #include <ipc/utils/local_to_global.hpp>
+#include <ipc/utils/merge_thread_local_vectors.hpp>
 
 #include <ipc/config.hpp>
 
@@ -22,7 +26,7 @@ namespace ipc {
 
 void construct_friction_constraint_set(
     const CollisionMesh& mesh,
-    const Eigen::MatrixXd& V,
+    ConstMatrixXdRef V,
     const Constraints& contact_constraint_set,
     double dhat,
     double barrier_stiffness,
@@ -37,7 +41,7 @@ void construct_friction_constraint_set(
 
 void construct_friction_constraint_set(
     const CollisionMesh& mesh,
-    const Eigen::MatrixXd& V,
+    ConstMatrixXdRef V,
     const Constraints& contact_constraint_set,
     double dhat,
     double barrier_stiffness,
@@ -55,7 +59,7 @@ void construct_friction_constraint_set(
 
 void construct_friction_constraint_set(
     const CollisionMesh& mesh,
-    const Eigen::MatrixXd& V,
+    ConstMatrixXdRef V,
     const Constraints& contact_constraint_set,
     double dhat,
     double barrier_stiffness,
@@ -63,6 +67,8 @@ void construct_friction_constraint_set(
     const std::function<double(double, double)>& blend_mu,
     FrictionConstraints& friction_constraint_set)
 {
+    IPC_PROFILE_SCOPE("construct_friction_constraint_set");
+
     assert(mus.size() == V.rows());
 
     const Eigen::MatrixXi& E = mesh.edges();
@@ -70,57 +76,280 @@ void construct_friction_constraint_set(
 
     friction_constraint_set.clear();
 
-    const auto& [C_vv, C_ev, C_ee, C_fv, _, __, ___] = contact_constraint_set;
-    auto& [FC_vv, FC_ev, FC_ee, FC_fv] = friction_constraint_set;
+    const std::vector<VertexVertexConstraint>& C_vv =
+        contact_constraint_set.vv_constraints;
+    const std::vector<EdgeVertexConstraint>& C_ev =
+        contact_constraint_set.ev_constraints;
+    const std::vector<EdgeEdgeConstraint>& C_ee =
+        contact_constraint_set.ee_constraints;
+    const std::vector<FaceVertexConstraint>& C_fv =
+        contact_constraint_set.fv_constraints;
+    auto& FC_vv = friction_constraint_set.vv_constraints;
+    auto& FC_ev = friction_constraint_set.ev_constraints;
+    auto& FC_ee = friction_constraint_set.ee_constraints;
+    auto& FC_fv = friction_constraint_set.fv_constraints;
+
+    // Each constraint's construction computes its tangent basis, closest
+    // point, and normal force magnitude, so build into per-thread vectors
+    // and merge afterwards like Constraints::build does.
+    execution_context().run([&] {
+        tbb::enumerable_thread_specific<FrictionConstraints> storage;
+
+        tbb::parallel_for(
+            tbb::blocked_range<size_t>(size_t(0), C_vv.size()),
+            [&](const tbb::blocked_range<size_t>& r) {
+                auto& local_FC_vv = storage.local().vv_constraints;
+                for (size_t i = r.begin(); i < r.end(); i++) {
+                    local_FC_vv.emplace_back(
+                        C_vv[i], V, E, F,
+                        C_vv[i].local_dhat < 0 ? dhat : C_vv[i].local_dhat,
+                        barrier_stiffness);
+                    const auto& [v0i, v1i, _, __] =
+                        local_FC_vv.back().vertex_indices(E, F);
+
+                    local_FC_vv.back().mu = blend_mu(mus(v0i), mus(v1i));
+                }
+            });
+
+        tbb::parallel_for(
+            tbb::blocked_range<size_t>(size_t(0), C_ev.size()),
+            [&](const tbb::blocked_range<size_t>& r) {
+                auto& local_FC_ev = storage.local().ev_constraints;
+                for (size_t i = r.begin(); i < r.end(); i++) {
+                    local_FC_ev.emplace_back(
+                        C_ev[i], V, E, F,
+                        C_ev[i].local_dhat < 0 ? dhat : C_ev[i].local_dhat,
+                        barrier_stiffness);
+                    const auto& [vi, e0i, e1i, _] =
+                        local_FC_ev.back().vertex_indices(E, F);
+
+                    const double edge_mu = (mus(e1i) - mus(e0i))
+                            * local_FC_ev.back().closest_point[0]
+                        + mus(e0i);
+                    local_FC_ev.back().mu = blend_mu(edge_mu, mus(vi));
+                }
+            });
+
+        tbb::parallel_for(
+            tbb::blocked_range<size_t>(size_t(0), C_ee.size()),
+            [&](const tbb::blocked_range<size_t>& r) {
+                auto& local_FC_ee = storage.local().ee_constraints;
+                for (size_t i = r.begin(); i < r.end(); i++) {
+                    const auto& [ea0i, ea1i, eb0i, eb1i] =
+                        C_ee[i].vertex_indices(E, F);
+                    const Eigen::Vector3d ea0 = V.row(ea0i), ea1 = V.row(ea1i),
+                                          eb0 = V.row(eb0i), eb1 = V.row(eb1i);
+
+                    // Skip EE constraints that are close to parallel
+                    if (edge_edge_cross_squarednorm(ea0, ea1, eb0, eb1)
+                        < C_ee[i].eps_x) {
+                        continue;
+                    }
+
+                    local_FC_ee.emplace_back(
+                        C_ee[i], V, E, F,
+                        C_ee[i].local_dhat < 0 ? dhat : C_ee[i].local_dhat,
+                        barrier_stiffness);
+
+                    const double ea_mu = (mus(ea1i) - mus(ea0i))
+                            * local_FC_ee.back().closest_point[0]
+                        + mus(ea0i);
+                    const double eb_mu = (mus(eb1i) - mus(eb0i))
+                            * local_FC_ee.back().closest_point[1]
+                        + mus(eb0i);
+                    local_FC_ee.back().mu = blend_mu(ea_mu, eb_mu);
+                }
+            });
+
+        tbb::parallel_for(
+            tbb::blocked_range<size_t>(size_t(0), C_fv.size()),
+            [&](const tbb::blocked_range<size_t>& r) {
+                auto& local_FC_fv = storage.local().fv_constraints;
+                for (size_t i = r.begin(); i < r.end(); i++) {
+                    local_FC_fv.emplace_back(
+                        C_fv[i], V, E, F,
+                        C_fv[i].local_dhat < 0 ? dhat : C_fv[i].local_dhat,
+                        barrier_stiffness);
+                    const auto& [vi, f0i, f1i, f2i] =
+                        local_FC_fv.back().vertex_indices(E, F);
+
+                    const double face_mu = mus(f0i)
+                        + local_FC_fv.back().closest_point[0]
+                            * (mus(f1i) - mus(f0i))
+                        + local_FC_fv.back().closest_point[1]
+                            * (mus(f2i) - mus(f0i));
+                    local_FC_fv.back().mu = blend_mu(face_mu, mus(vi));
+                }
+            });
+
+        // Merge the thread-local constraints (serially).
+        size_t num_vv = 0, num_ev = 0, num_ee = 0, num_fv = 0;
+        for (const auto& local_constraints : storage) {
+            num_vv += local_constraints.vv_constraints.size();
+            num_ev += local_constraints.ev_constraints.size();
+            num_ee += local_constraints.ee_constraints.size();
+            num_fv += local_constraints.fv_constraints.size();
+        }
+        FC_vv.reserve(num_vv);
+        FC_ev.reserve(num_ev);
+        FC_ee.reserve(num_ee);
+        FC_fv.reserve(num_fv);
+        for (const auto& local_constraints : storage) {
+            FC_vv.insert(
+                FC_vv.end(), local_constraints.vv_constraints.begin(),
+                local_constraints.vv_constraints.end());
+            FC_ev.insert(
+                FC_ev.end(), local_constraints.ev_constraints.begin(),
+                local_constraints.ev_constraints.end());
+            FC_ee.insert(
+                FC_ee.end(), local_constraints.ee_constraints.begin(),
+                local_constraints.ee_constraints.end());
+            FC_fv.insert(
+                FC_fv.end(), local_constraints.fv_constraints.begin(),
+                local_constraints.fv_constraints.end());
+        }
+    });
 
-    FC_vv.reserve(C_vv.size());
-    for (const auto& c_vv : C_vv) {
-        FC_vv.emplace_back(c_vv, V, E, F, dhat, barrier_stiffness);
-        const auto& [v0i, v1i, _, __] = FC_vv.back().vertex_indices(E, F);
+    // Record the positions the tangent bases were computed from (used by
+    // update_friction_constraint_set).
+    friction_constraint_set.m_V = V;
+}
 
-        FC_vv.back().mu = blend_mu(mus(v0i), mus(v1i));
-    }
+bool update_friction_constraint_set(
+    const CollisionMesh& mesh,
+    ConstMatrixXdRef V,
+    const Constraints& contact_constraint_set,
+    double dhat,
+    double barrier_stiffness,
+    FrictionConstraints& friction_constraint_set,
+    double rebuild_tolerance)
+{
+    assert(rebuild_tolerance >= 0);
 
-    FC_ev.reserve(C_ev.size());
-    for (const auto& c_ev : C_ev) {
-        FC_ev.emplace_back(c_ev, V, E, F, dhat, barrier_stiffness);
-        const auto& [vi, e0i, e1i, _] = FC_ev.back().vertex_indices(E, F);
+    ConstMatrixXdRef V_built = friction_constraint_set.m_V;
+    if (V_built.rows() != V.rows() || V_built.cols() != V.cols()
+        || (V.size() != 0
+            && (V - V_built).cwiseAbs().maxCoeff() > rebuild_tolerance)) {
+        return false; // never built or the vertices moved too far
+    }
 
-        const double edge_mu =
-            (mus(e1i) - mus(e0i)) * FC_ev.back().closest_point[0] + mus(e0i);
-        FC_ev.back().mu = blend_mu(edge_mu, mus(vi));
+    const std::vector<VertexVertexConstraint>& C_vv =
+        contact_constraint_set.vv_constraints;
+    const std::vector<EdgeVertexConstraint>& C_ev =
+        contact_constraint_set.ev_constraints;
+    const std::vector<EdgeEdgeConstraint>& C_ee =
+        contact_constraint_set.ee_constraints;
+    const std::vector<FaceVertexConstraint>& C_fv =
+        contact_constraint_set.fv_constraints;
+    auto& FC_vv = friction_constraint_set.vv_constraints;
+    auto& FC_ev = friction_constraint_set.ev_constraints;
+    auto& FC_ee = friction_constraint_set.ee_constraints;
+    auto& FC_fv = friction_constraint_set.fv_constraints;
+
+    // Check the constraint topology is unchanged before touching the set.
+    if (FC_vv.size() != C_vv.size() || FC_ev.size() != C_ev.size()
+        || FC_fv.size() != C_fv.size() || FC_ee.size() > C_ee.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < C_vv.size(); i++) {
+        if (FC_vv[i].vertex0_index != C_vv[i].vertex0_index
+            || FC_vv[i].vertex1_index != C_vv[i].vertex1_index) {
+            return false;
+        }
+    }
+    for (size_t i = 0; i < C_ev.size(); i++) {
+        if (FC_ev[i].edge_index != C_ev[i].edge_index
+            || FC_ev[i].vertex_index != C_ev[i].vertex_index) {
+            return false;
+        }
+    }
+    for (size_t i = 0; i < C_fv.size(); i++) {
+        if (FC_fv[i].face_index != C_fv[i].face_index
+            || FC_fv[i].vertex_index != C_fv[i].vertex_index) {
+            return false;
+        }
+    }
+    // The friction set skips near-parallel edge-edge constraints, so it must
+    // be an in-order subset of the contact set's edge-edge constraints.
+    std::vector<size_t> ee_map(FC_ee.size());
+    {
+        size_t j = 0;
+        for (size_t i = 0; i < C_ee.size() && j < FC_ee.size(); i++) {
+            if (FC_ee[j].edge0_index == C_ee[i].edge0_index
+                && FC_ee[j].edge1_index == C_ee[i].edge1_index) {
+                ee_map[j++] = i;
+            }
+        }
+        if (j != FC_ee.size()) {
+            return false;
+        }
     }
 
-    FC_ee.reserve(C_ee.size());
-    for (const auto& c_ee : C_ee) {
-        const auto& [ea0i, ea1i, eb0i, eb1i] = c_ee.vertex_indices(E, F);
-        const Eigen::Vector3d ea0 = V.row(ea0i), ea1 = V.row(ea1i),
-                              eb0 = V.row(eb0i), eb1 = V.row(eb1i);
+    const Eigen::MatrixXi& E = mesh.edges();
+    const Eigen::MatrixXi& F = mesh.faces();
 
-        // Skip EE constraints that are close to parallel
-        if (edge_edge_cross_squarednorm(ea0, ea1, eb0, eb1) < c_ee.eps_x) {
-            continue;
+    // Refresh only the normal force magnitudes; the tangent bases, closest
+    // points, and friction coefficients stay within tolerance. The distances
+    // are gathered into one array per constraint type, so the barrier
+    // derivatives are evaluated in a single batched sweep (see
+    // normal_force_magnitude.hpp). Mixed minimum or activation distances
+    // fall back to the per-constraint path.
+    const auto update_normal_forces = [&](auto& FCs, const auto& get_contact) {
+        if (FCs.empty()) {
+            return;
         }
 
-        FC_ee.emplace_back(c_ee, V, E, F, dhat, barrier_stiffness);
-
-        double ea_mu =
-            (mus(ea1i) - mus(ea0i)) * FC_ee.back().closest_point[0] + mus(ea0i);
-        double eb_mu =
-            (mus(eb1i) - mus(eb0i)) * FC_ee.back().closest_point[1] + mus(eb0i);
-        FC_ee.back().mu = blend_mu(ea_mu, eb_mu);
-    }
+        const auto resolved_dhat = [&](size_t i) {
+            const double local_dhat = get_contact(i).local_dhat;
+            return local_dhat < 0 ? dhat : local_dhat;
+        };
+
+        const double dmin = get_contact(size_t(0)).minimum_distance;
+        const double first_dhat = resolved_dhat(size_t(0));
+        bool uniform = true;
+        for (size_t i = 1; i < FCs.size() && uniform; i++) {
+            uniform = get_contact(i).minimum_distance == dmin
+                && resolved_dhat(i) == first_dhat;
+        }
+        if (!uniform) {
+            tbb::parallel_for(size_t(0), FCs.size(), [&](size_t i) {
+                FCs[i].update_normal_force_magnitude(
+                    V, E, F, resolved_dhat(i), barrier_stiffness,
+                    get_contact(i).minimum_distance);
+            });
+            return;
+        }
 
-    FC_fv.reserve(C_fv.size());
-    for (const auto& c_fv : C_fv) {
-        FC_fv.emplace_back(c_fv, V, E, F, dhat, barrier_stiffness);
-        const auto& [vi, f0i, f1i, f2i] = FC_fv.back().vertex_indices(E, F);
+        Eigen::ArrayXd distances_squared(FCs.size());
+        tbb::parallel_for(size_t(0), FCs.size(), [&](size_t i) {
+            const FrictionConstraint& fc = FCs[i];
+            distances_squared[i] = fc.compute_distance(V, E, F);
+        });
 
-        double face_mu = mus(f0i)
-            + FC_fv.back().closest_point[0] * (mus(f1i) - mus(f0i))
-            + FC_fv.back().closest_point[1] * (mus(f2i) - mus(f0i));
-        FC_fv.back().mu = blend_mu(face_mu, mus(vi));
-    }
+        const Eigen::ArrayXd magnitudes = compute_normal_force_magnitude(
+            distances_squared, first_dhat, barrier_stiffness, dmin);
+        for (size_t i = 0; i < FCs.size(); i++) {
+            FCs[i].normal_force_magnitude = magnitudes[i];
+        }
+    };
+
+    execution_context().run([&] {
+        update_normal_forces(
+            FC_vv,
+            [&](size_t i) -> const CollisionConstraint& { return C_vv[i]; });
+        update_normal_forces(
+            FC_ev,
+            [&](size_t i) -> const CollisionConstraint& { return C_ev[i]; });
+        update_normal_forces(
+            FC_ee, [&](size_t i) -> const CollisionConstraint& {
+                return C_ee[ee_map[i]];
+            });
+        update_normal_forces(
+            FC_fv,
+            [&](size_t i) -> const CollisionConstraint& { return C_fv[i]; });
+    });
+
+    return true;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -129,10 +358,57 @@ void construct_friction_constraint_set(
 //
 ///////////////////////////////////////////////////////////////////////////////
 
+double compute_friction_potential(
+    const CollisionMesh& mesh,
+    ConstMatrixXdRef V0,
+    ConstMatrixXdRef V1,
+    const FrictionConstraints& friction_constraint_set,
+    const FrictionConstraintsSoA& soa,
+    double epsv_times_h)
+{
+    if (friction_constraint_set.empty()) {
+        return 0;
+    }
+    assert(epsv_times_h > 0);
+    assert(soa.coeffs.size() == long(friction_constraint_set.size()));
+
+    const Eigen::MatrixXi& E = mesh.edges();
+    const Eigen::MatrixXi& F = mesh.faces();
+
+    const Eigen::MatrixXd U = V1 - V0; // absolute linear dislacement
+    const int dim = soa.dim;
+
+    return execution_context().run([&]() -> double {
+        // Gather the tangential displacement norms so the mollifier runs over
+        // the whole set in one batch.
+        Eigen::ArrayXd u_norms(friction_constraint_set.size());
+
+        tbb::parallel_for(
+            tbb::blocked_range<size_t>(
+                size_t(0), friction_constraint_set.size()),
+            [&](const tbb::blocked_range<size_t>& r) {
+                for (size_t i = r.begin(); i < r.end(); i++) {
+                    const VectorMax3d rel_u =
+                        friction_constraint_set[i]
+                            .compute_relative_displacement(U, E, F);
+                    u_norms[i] =
+                        (soa.tangent_bases.middleRows(long(dim * i), dim)
+                             .transpose()
+                         * rel_u)
+                            .norm();
+                }
+            },
+            execution_context().affinity_partitioner(
+                ExecutionContext::AffinitySite::FRICTION_POTENTIAL));
+
+        return (soa.coeffs * f0_SF(u_norms, epsv_times_h)).sum();
+    });
+}
+
 Eigen::VectorXd compute_friction_potential_gradient(
     const CollisionMesh& mesh,
-    const Eigen::MatrixXd& V0,
-    const Eigen::MatrixXd& V1,
+    ConstMatrixXdRef V0,
+    ConstMatrixXdRef V1,
     const FrictionConstraints& friction_constraint_set,
     double epsv_times_h)
 {
@@ -147,41 +423,89 @@ Eigen::VectorXd compute_friction_potential_gradient(
     auto U = V1 - V0; // absolute linear dislacement of each point
     int dim = U.cols();
 
-    tbb::enumerable_thread_specific<Eigen::VectorXd> storage(
-        Eigen::VectorXd::Zero(U.size()));
-
-    tbb::parallel_for(
-        tbb::blocked_range<size_t>(size_t(0), friction_constraint_set.size()),
-        [&](const tbb::blocked_range<size_t>& r) {
-            auto& local_grad = storage.local();
-            for (size_t i = r.begin(); i < r.end(); i++) {
-                local_gradient_to_global_gradient(
-                    friction_constraint_set[i].compute_potential_gradient(
-                        U, E, F, epsv_times_h),
-                    friction_constraint_set[i].vertex_indices(E, F), dim,
-                    local_grad);
+    // Accumulate sparse (index, value) entries per thread instead of a dense
+    // |V|-sized vector per thread (see local_gradient_to_global_gradient).
+    return execution_context().run([&]() -> Eigen::VectorXd {
+        if (execution_context().deterministic()) {
+            // Bitwise-reproducible assembly: each fixed-size block fills its
+            // own entry slot, and the entries scatter into grad serially in
+            // block order, so the accumulation order is fixed across runs
+            // and thread counts (see ordered_reduction.hpp for the cost).
+            const size_t num_blocks =
+                num_deterministic_blocks(friction_constraint_set.size());
+            std::vector<std::vector<std::pair<long, double>>> block_entries(
+                num_blocks);
+
+            tbb::parallel_for(size_t(0), num_blocks, [&](const size_t b) {
+                const size_t begin = b * DETERMINISTIC_BLOCK_SIZE;
+                const size_t end = std::min(
+                    begin + DETERMINISTIC_BLOCK_SIZE,
+                    friction_constraint_set.size());
+                for (size_t i = begin; i < end; i++) {
+                    local_gradient_to_global_gradient(
+                        friction_constraint_set[i].compute_potential_gradient(
+                            U, E, F, epsv_times_h),
+                        friction_constraint_set[i].vertex_indices(E, F), dim,
+                        block_entries[b]);
+                }
+            });
+
+            Eigen::VectorXd grad = Eigen::VectorXd::Zero(U.size());
+            for (const auto& entries : block_entries) {
+                for (const auto& [index, value] : entries) {
+                    grad[index] += value;
+                }
             }
-        });
+            return grad;
+        }
 
-    Eigen::VectorXd grad = Eigen::VectorXd::Zero(U.size());
-    for (const auto& local_grad : storage) {
-        grad += local_grad;
-    }
-    return grad;
+        tbb::enumerable_thread_specific<std::vector<std::pair<long, double>>>
+            storage;
+
+        tbb::parallel_for(
+            tbb::blocked_range<size_t>(
+                size_t(0), friction_constraint_set.size()),
+            [&](const tbb::blocked_range<size_t>& r) {
+                auto& local_grad_entries = storage.local();
+                for (size_t i = r.begin(); i < r.end(); i++) {
+                    local_gradient_to_global_gradient(
+                        friction_constraint_set[i].compute_potential_gradient(
+                            U, E, F, epsv_times_h),
+                        friction_constraint_set[i].vertex_indices(E, F), dim,
+                        local_grad_entries);
+                }
+            },
+            execution_context().affinity_partitioner(
+                ExecutionContext::AffinitySite::FRICTION_GRADIENT));
+
+        Eigen::VectorXd grad = Eigen::VectorXd::Zero(U.size());
+        for (const auto& local_grad_entries : storage) {
+            for (const auto& [index, value] : local_grad_entries) {
+                grad[index] += value;
+            }
+        }
+        return grad;
+    });
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
-Eigen::SparseMatrix<double> compute_friction_potential_hessian(
+namespace {
+
+// The local kernels stay in double; Scalar only controls the assembled
+// triplets and matrix (float halves the assembly memory traffic for solvers
+// that tolerate single-precision hessians).
+template <typename Scalar>
+Eigen::SparseMatrix<Scalar> compute_friction_potential_hessian_impl(
     const CollisionMesh& mesh,
-    const Eigen::MatrixXd& V0,
-    const Eigen::MatrixXd& V1,
+    ConstMatrixXdRef V0,
+    ConstMatrixXdRef V1,
     const FrictionConstraints& friction_constraint_set,
     double epsv_times_h,
     bool project_hessian_to_psd)
 {
     if (friction_constraint_set.empty()) {
-        return Eigen::SparseMatrix<double>(V0.size(), V0.size());
+        return Eigen::SparseMatrix<Scalar>(V0.size(), V0.size());
     }
     assert(epsv_times_h > 0);
 
@@ -191,7 +515,7 @@ Eigen::SparseMatrix<double> compute_friction_potential_hessian(
     auto U = V1 - V0; // absolute linear dislacement of each point
     int dim = U.cols();
 
-    tbb::enumerable_thread_specific<std::vector<Eigen::Triplet<double>>>
+    tbb::enumerable_thread_specific<std::vector<Eigen::Triplet<Scalar>>>
         storage;
     tbb::parallel_for(
         tbb::blocked_range<size_t>(size_t(0), friction_constraint_set.size()),
@@ -205,25 +529,171 @@ Eigen::SparseMatrix<double> compute_friction_potential_hessian(
                     friction_constraint_set[i].vertex_indices(E, F), dim,
                     local_hess_triplets);
             }
-        });
+        },
+        execution_context().affinity_partitioner(
+            ExecutionContext::AffinitySite::FRICTION_HESSIAN));
+
+    // Concatenate the per-thread triplets and compress them once in
+    // parallel instead of building and adding one sparse matrix per thread.
+    std::vector<Eigen::Triplet<Scalar>> triplets;
+    merge_thread_local_vectors(storage, triplets);
+    return sparse_from_triplets<Scalar>(U.size(), U.size(), triplets);
+}
+
+} // namespace
+
+Eigen::SparseMatrix<double> compute_friction_potential_hessian(
+    const CollisionMesh& mesh,
+    ConstMatrixXdRef V0,
+    ConstMatrixXdRef V1,
+    const FrictionConstraints& friction_constraint_set,
+    double epsv_times_h,
+    bool project_hessian_to_psd)
+{
+    return execution_context().run([&] {
+        return compute_friction_potential_hessian_impl<double>(
+            mesh, V0, V1, friction_constraint_set, epsv_times_h,
+            project_hessian_to_psd);
+    });
+}
+
+Eigen::SparseMatrix<double> compute_friction_potential_hessian(
+    const CollisionMesh& mesh,
+    ConstMatrixXdRef V0,
+    ConstMatrixXdRef V1,
+    const FrictionConstraints& friction_constraint_set,
+    double epsv_times_h,
+    HessianAssemblyCache& cache,
+    bool project_hessian_to_psd)
+{
+    if (friction_constraint_set.empty()) {
+        return Eigen::SparseMatrix<double>(V0.size(), V0.size());
+    }
+    assert(epsv_times_h > 0);
+
+    const Eigen::MatrixXi& E = mesh.edges();
+    const Eigen::MatrixXi& F = mesh.faces();
+
+    auto U = V1 - V0; // absolute linear dislacement of each point
+    int dim = U.cols();
+
+    return execution_context().run([&] {
+        std::vector<MatrixMax12d> local_hessians(
+            friction_constraint_set.size());
+        std::vector<std::array<index_t, 4>> vertex_ids(
+            friction_constraint_set.size());
+
+        tbb::parallel_for(
+            tbb::blocked_range<size_t>(
+                size_t(0), friction_constraint_set.size()),
+            [&](const tbb::blocked_range<size_t>& r) {
+                for (size_t i = r.begin(); i < r.end(); i++) {
+                    local_hessians[i] =
+                        friction_constraint_set[i].compute_potential_hessian(
+                            U, E, F, epsv_times_h, project_hessian_to_psd);
+                    vertex_ids[i] =
+                        friction_constraint_set[i].vertex_indices(E, F);
+                }
+            });
+
+        return cache.assemble(local_hessians, vertex_ids, dim, U.size());
+    });
+}
+
+void compute_friction_potential_gradient_and_hessian(
+    const CollisionMesh& mesh,
+    ConstMatrixXdRef V0,
+    ConstMatrixXdRef V1,
+    const FrictionConstraints& friction_constraint_set,
+    double epsv_times_h,
+    Eigen::VectorXd& grad,
+    Eigen::SparseMatrix<double>& hess,
+    bool project_hessian_to_psd,
+    Workspace* const workspace)
+{
+    grad = Eigen::VectorXd::Zero(V0.size());
+    hess = Eigen::SparseMatrix<double>(V0.size(), V0.size());
 
-    Eigen::SparseMatrix<double> hess(U.size(), U.size());
-    for (const auto& local_hess_triplets : storage) {
-        Eigen::SparseMatrix<double> local_hess(U.size(), U.size());
-        local_hess.setFromTriplets(
-            local_hess_triplets.begin(), local_hess_triplets.end());
-        hess += local_hess;
+    if (friction_constraint_set.empty()) {
+        return;
     }
-    return hess;
+    assert(epsv_times_h > 0);
+
+    const Eigen::MatrixXi& E = mesh.edges();
+    const Eigen::MatrixXi& F = mesh.faces();
+
+    auto U = V1 - V0; // absolute linear dislacement of each point
+    int dim = U.cols();
+
+    execution_context().run([&] {
+        Workspace fallback_workspace;
+        Workspace::ThreadLocalBuffers& storage =
+            (workspace != nullptr ? *workspace : fallback_workspace)
+                .arena(Workspace::Site::FRICTION_DERIVATIVES);
+
+        tbb::parallel_for(
+            tbb::blocked_range<size_t>(
+                size_t(0), friction_constraint_set.size()),
+            [&](const tbb::blocked_range<size_t>& r) {
+                Workspace::LocalBuffers& local_storage = storage.local();
+
+                for (size_t i = r.begin(); i < r.end(); i++) {
+                    VectorMax12d local_grad;
+                    MatrixMax12d local_hess;
+                    friction_constraint_set[i]
+                        .compute_potential_gradient_and_hessian(
+                            U, E, F, epsv_times_h, project_hessian_to_psd,
+                            local_grad, local_hess);
+
+                    const std::array<index_t, 4> ids =
+                        friction_constraint_set[i].vertex_indices(E, F);
+                    local_gradient_to_global_gradient(
+                        local_grad, ids, dim, local_storage.grad_entries);
+                    local_hessian_to_global_triplets(
+                        local_hess, ids, dim, local_storage.hess_triplets);
+                }
+            },
+            execution_context().affinity_partitioner(
+                ExecutionContext::AffinitySite::
+                    FRICTION_POTENTIAL_AND_DERIVATIVES));
+
+        for (const Workspace::LocalBuffers& local_storage : storage) {
+            for (const auto& [index, value] : local_storage.grad_entries) {
+                grad[index] += value;
+            }
+
+            Eigen::SparseMatrix<double> local_hess(V0.size(), V0.size());
+            local_hess.setFromTriplets(
+                local_storage.hess_triplets.begin(),
+                local_storage.hess_triplets.end());
+            hess += local_hess;
+        }
+    });
+}
+
+void compute_friction_potential_hessian(
+    const CollisionMesh& mesh,
+    ConstMatrixXdRef V0,
+    ConstMatrixXdRef V1,
+    const FrictionConstraints& friction_constraint_set,
+    double epsv_times_h,
+    Eigen::SparseMatrix<float>& hess,
+    bool project_hessian_to_psd)
+{
+    hess = execution_context().run([&] {
+        return compute_friction_potential_hessian_impl<float>(
+            mesh, V0, V1, friction_constraint_set, epsv_times_h,
+            project_hessian_to_psd);
+    });
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
 Eigen::VectorXd compute_friction_force(
     const CollisionMesh& mesh,
-    const Eigen::MatrixXd& X,
-    const Eigen::MatrixXd& Ut,
-    const Eigen::MatrixXd& U,
+    ConstMatrixXdRef X,
+    ConstMatrixXdRef Ut,
+    ConstMatrixXdRef U,
     const FrictionConstraints& friction_constraint_set,
     const double dhat,
     const double barrier_stiffness,
@@ -240,37 +710,102 @@ Eigen::VectorXd compute_friction_force(
     const Eigen::MatrixXi& E = mesh.edges();
     const Eigen::MatrixXi& F = mesh.faces();
 
-    tbb::enumerable_thread_specific<Eigen::VectorXd> storage(
-        Eigen::VectorXd::Zero(U.size()));
+    // Accumulate sparse (index, value) entries per thread instead of a dense
+    // |V|-sized vector per thread (see local_gradient_to_global_gradient).
+    return execution_context().run([&]() -> Eigen::VectorXd {
+        tbb::enumerable_thread_specific<std::vector<std::pair<long, double>>>
+            storage;
+
+        tbb::parallel_for(
+            tbb::blocked_range<size_t>(
+                size_t(0), friction_constraint_set.size()),
+            [&](const tbb::blocked_range<size_t>& r) {
+                auto& local_force_entries = storage.local();
+                for (size_t i = r.begin(); i < r.end(); i++) {
+                    local_gradient_to_global_gradient(
+                        friction_constraint_set[i].compute_force(
+                            X, Ut, U, E, F, dhat, barrier_stiffness,
+                            epsv_times_h, dmin, no_mu),
+                        friction_constraint_set[i].vertex_indices(E, F), dim,
+                        local_force_entries);
+                }
+            },
+            execution_context().affinity_partitioner(
+                ExecutionContext::AffinitySite::FRICTION_FORCE));
+
+        Eigen::VectorXd force = Eigen::VectorXd::Zero(U.size());
+        for (const auto& local_force_entries : storage) {
+            for (const auto& [index, value] : local_force_entries) {
+                force[index] += value;
+            }
+        }
+        return force;
+    });
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+// ∇ₓ w(x) terms of the X jacobian: the per-constraint forces are computed in
+// parallel; the sparse outer products are accumulated serially.
+void add_weight_gradient_terms(
+    const CollisionMesh& mesh,
+    ConstMatrixXdRef X,
+    ConstMatrixXdRef Ut,
+    ConstMatrixXdRef U,
+    const FrictionConstraints& friction_constraint_set,
+    const double dhat,
+    const double barrier_stiffness,
+    const double epsv_times_h,
+    const double dmin,
+    Eigen::SparseMatrix<double>& jacobian)
+{
+    const int dim = U.cols();
+    const Eigen::MatrixXi& E = mesh.edges();
+    const Eigen::MatrixXi& F = mesh.faces();
+
+    std::vector<VectorMax12d> local_forces(friction_constraint_set.size());
 
     tbb::parallel_for(
         tbb::blocked_range<size_t>(size_t(0), friction_constraint_set.size()),
         [&](const tbb::blocked_range<size_t>& r) {
-            auto& local_force = storage.local();
             for (size_t i = r.begin(); i < r.end(); i++) {
-                local_gradient_to_global_gradient(
-                    friction_constraint_set[i].compute_force(
-                        X, Ut, U, E, F, dhat, barrier_stiffness, epsv_times_h,
-                        dmin, no_mu),
-                    friction_constraint_set[i].vertex_indices(E, F), dim,
-                    local_force);
+                const FrictionConstraint& constraint =
+                    friction_constraint_set[i];
+                if (constraint.weight_gradient.size() != X.size()) {
+                    throw std::runtime_error(
+                        "Shape derivative is not computed for friction "
+                        "constraint!");
+                }
+
+                local_forces[i] = constraint.compute_force(
+                    X, Ut, U, E, F, dhat, barrier_stiffness, epsv_times_h,
+                    dmin);
+                assert(constraint.weight != 0);
+                local_forces[i].array() /= constraint.weight;
             }
         });
 
-    Eigen::VectorXd force = Eigen::VectorXd::Zero(U.size());
-    for (const auto& local_force : storage) {
-        force += local_force;
+    for (size_t i = 0; i < friction_constraint_set.size(); i++) {
+        const FrictionConstraint& constraint = friction_constraint_set[i];
+
+        Eigen::SparseVector<double> force(X.size());
+        force.reserve(local_forces[i].size());
+        local_gradient_to_global_gradient(
+            local_forces[i], constraint.vertex_indices(E, F), dim, force);
+
+        jacobian += force * constraint.weight_gradient.transpose();
     }
-    return force;
 }
 
-///////////////////////////////////////////////////////////////////////////////
+} // namespace
 
 Eigen::SparseMatrix<double> compute_friction_force_jacobian(
     const CollisionMesh& mesh,
-    const Eigen::MatrixXd& X,
-    const Eigen::MatrixXd& Ut,
-    const Eigen::MatrixXd& U,
+    ConstMatrixXdRef X,
+    ConstMatrixXdRef Ut,
+    ConstMatrixXdRef U,
     const FrictionConstraints& friction_constraint_set,
     const double dhat,
     const double barrier_stiffness,
@@ -287,57 +822,96 @@ Eigen::SparseMatrix<double> compute_friction_force_jacobian(
     const Eigen::MatrixXi& E = mesh.edges();
     const Eigen::MatrixXi& F = mesh.faces();
 
-    tbb::enumerable_thread_specific<std::vector<Eigen::Triplet<double>>>
-        storage;
-
-    tbb::parallel_for(
-        tbb::blocked_range<size_t>(size_t(0), friction_constraint_set.size()),
-        [&](const tbb::blocked_range<size_t>& r) {
-            auto& local_jac_triplets = storage.local();
+    return execution_context().run([&]() -> Eigen::SparseMatrix<double> {
+        tbb::enumerable_thread_specific<std::vector<Eigen::Triplet<double>>>
+            storage;
+
+        tbb::parallel_for(
+            tbb::blocked_range<size_t>(
+                size_t(0), friction_constraint_set.size()),
+            [&](const tbb::blocked_range<size_t>& r) {
+                auto& local_jac_triplets = storage.local();
+
+                for (size_t i = r.begin(); i < r.end(); i++) {
+                    local_hessian_to_global_triplets(
+                        friction_constraint_set[i].compute_force_jacobian(
+                            X, Ut, U, E, F, dhat, barrier_stiffness,
+                            epsv_times_h, wrt, dmin),
+                        friction_constraint_set[i].vertex_indices(E, F), dim,
+                        local_jac_triplets);
+                }
+            });
+
+        std::vector<Eigen::Triplet<double>> triplets;
+        merge_thread_local_vectors(storage, triplets);
+        Eigen::SparseMatrix<double> jacobian =
+            sparse_from_triplets(U.size(), U.size(), triplets);
+
+        // if wrt == X then compute ∇ₓ w(x)
+        if (wrt == FrictionConstraint::DiffWRT::X) {
+            add_weight_gradient_terms(
+                mesh, X, Ut, U, friction_constraint_set, dhat,
+                barrier_stiffness, epsv_times_h, dmin, jacobian);
+        }
 
-            for (size_t i = r.begin(); i < r.end(); i++) {
-                local_hessian_to_global_triplets(
-                    friction_constraint_set[i].compute_force_jacobian(
-                        X, Ut, U, E, F, dhat, barrier_stiffness, epsv_times_h,
-                        wrt, dmin),
-                    friction_constraint_set[i].vertex_indices(E, F), dim,
-                    local_jac_triplets);
-            }
-        });
+        return jacobian;
+    });
+}
 
-    Eigen::SparseMatrix<double> jacobian(U.size(), U.size());
-    for (const auto& local_jac_triplets : storage) {
-        Eigen::SparseMatrix<double> local_jacobian(U.size(), U.size());
-        local_jacobian.setFromTriplets(
-            local_jac_triplets.begin(), local_jac_triplets.end());
-        jacobian += local_jacobian;
+Eigen::SparseMatrix<double> compute_friction_force_jacobian(
+    const CollisionMesh& mesh,
+    ConstMatrixXdRef X,
+    ConstMatrixXdRef Ut,
+    ConstMatrixXdRef U,
+    const FrictionConstraints& friction_constraint_set,
+    const double dhat,
+    const double barrier_stiffness,
+    const double epsv_times_h,
+    const FrictionConstraint::DiffWRT wrt,
+    HessianAssemblyCache& cache,
+    const double dmin)
+{
+    if (friction_constraint_set.empty()) {
+        return Eigen::SparseMatrix<double>(U.size(), U.size());
     }
+    assert(epsv_times_h > 0);
 
-    // if wrt == X then compute ∇ₓ w(x)
-    if (wrt == FrictionConstraint::DiffWRT::X) {
-        for (int i = 0; i < friction_constraint_set.size(); i++) {
-            const FrictionConstraint& constraint = friction_constraint_set[i];
-            assert(constraint.weight_gradient.size() == X.size());
-            if (constraint.weight_gradient.size() != X.size()) {
-                throw std::runtime_error(
-                    "Shape derivative is not computed for friction constraint!");
-            }
-
-            VectorMax12d local_force = constraint.compute_force(
-                X, Ut, U, E, F, dhat, barrier_stiffness, epsv_times_h, dmin);
-            assert(constraint.weight != 0);
-            local_force.array() /= constraint.weight;
-
-            Eigen::SparseVector<double> force(X.size());
-            force.reserve(local_force.size());
-            local_gradient_to_global_gradient(
-                local_force, constraint.vertex_indices(E, F), dim, force);
+    int dim = U.cols();
+    const Eigen::MatrixXi& E = mesh.edges();
+    const Eigen::MatrixXi& F = mesh.faces();
 
-            jacobian += force * constraint.weight_gradient.transpose();
+    return execution_context().run([&]() -> Eigen::SparseMatrix<double> {
+        std::vector<MatrixMax12d> local_jacobians(
+            friction_constraint_set.size());
+        std::vector<std::array<index_t, 4>> vertex_ids(
+            friction_constraint_set.size());
+
+        tbb::parallel_for(
+            tbb::blocked_range<size_t>(
+                size_t(0), friction_constraint_set.size()),
+            [&](const tbb::blocked_range<size_t>& r) {
+                for (size_t i = r.begin(); i < r.end(); i++) {
+                    local_jacobians[i] =
+                        friction_constraint_set[i].compute_force_jacobian(
+                            X, Ut, U, E, F, dhat, barrier_stiffness,
+                            epsv_times_h, wrt, dmin);
+                    vertex_ids[i] =
+                        friction_constraint_set[i].vertex_indices(E, F);
+                }
+            });
+
+        Eigen::SparseMatrix<double> jacobian =
+            cache.assemble(local_jacobians, vertex_ids, dim, U.size());
+
+        // if wrt == X then compute ∇ₓ w(x)
+        if (wrt == FrictionConstraint::DiffWRT::X) {
+            add_weight_gradient_terms(
+                mesh, X, Ut, U, friction_constraint_set, dhat,
+                barrier_stiffness, epsv_times_h, dmin, jacobian);
         }
-    }
 
-    return jacobian;
+        return jacobian;
+    });
 }
 
 } // namespace ipc
@@ -5,6 +5,9 @@
 #include <ipc/friction/friction_constraint.hpp>
 #include <ipc/utils/eigen_ext.hpp>
 
+#include <ipc/utils/hessian_assembly_cache.hpp>
+#include <ipc/utils/workspace.hpp>
+
 #include <Eigen/Core>
 #include <Eigen/Sparse>
 
@@ -12,7 +15,7 @@ namespace ipc {
 
 void construct_friction_constraint_set(
     const CollisionMesh& mesh,
-    const Eigen::MatrixXd& V,
+    ConstMatrixXdRef V,
     const Constraints& contact_constraint_set,
     double dhat,
     double barrier_stiffness,
@@ -22,7 +25,7 @@ void construct_friction_constraint_set(
 
 void construct_friction_constraint_set(
     const CollisionMesh& mesh,
-    const Eigen::MatrixXd& V,
+    ConstMatrixXdRef V,
     const Constraints& contact_constraint_set,
     double dhat,
     double barrier_stiffness,
@@ -31,7 +34,7 @@ void construct_friction_constraint_set(
 
 void construct_friction_constraint_set(
     const CollisionMesh& mesh,
-    const Eigen::MatrixXd& V,
+    ConstMatrixXdRef V,
     const Constraints& contact_constraint_set,
     double dhat,
     double barrier_stiffness,
@@ -39,6 +42,36 @@ void construct_friction_constraint_set(
     const std::function<double(double, double)>& blend_mu,
     FrictionConstraints& friction_constraint_set);
 
+/// @brief Refresh a built friction constraint set in place if possible.
+///
+/// With friction lagging the contact set is often identical between outer
+/// iterations, so rebuilding the friction set recomputes every tangent
+/// basis and closest point for nothing. If the constraint topology matches
+/// the contact set and no vertex has moved more than rebuild_tolerance
+/// since the set was built, only the normal force magnitudes are
+/// recomputed; the tangent bases, closest points, and friction
+/// coefficients are kept.
+/// @param[in] mesh The collision mesh.
+/// @param[in] V Vertices of the collision mesh.
+/// @param[in] contact_constraint_set The set of contact constraints.
+/// @param[in] dhat The activation distance of the barrier.
+/// @param[in] barrier_stiffness The stiffness of the barrier.
+/// @param[in,out] friction_constraint_set The friction constraint set to
+/// refresh (built by construct_friction_constraint_set).
+/// @param[in] rebuild_tolerance Maximum vertex movement (per coordinate)
+/// for which the cached bases are considered valid.
+/// @returns True if the set was refreshed in place; false if the topology
+/// changed or the vertices moved too far, in which case the set is left
+/// untouched and construct_friction_constraint_set should be called.
+bool update_friction_constraint_set(
+    const CollisionMesh& mesh,
+    ConstMatrixXdRef V,
+    const Constraints& contact_constraint_set,
+    double dhat,
+    double barrier_stiffness,
+    FrictionConstraints& friction_constraint_set,
+    double rebuild_tolerance);
+
 /// @brief Compute the friction potential between two positions.
 /// @param[in] mesh The collision mesh.
 /// @param[in] V0 Vertex positions at start of time-step (rowwise)
@@ -48,11 +81,31 @@ void construct_friction_constraint_set(
 template <typename T>
 T compute_friction_potential(
     const CollisionMesh& mesh,
-    const Eigen::MatrixXd& V0,
+    ConstMatrixXdRef V0,
     const Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>& V1,
     const FrictionConstraints& friction_constraint_set,
     double epsv_times_h);
 
+/// @brief Compute the friction potential using a structure-of-arrays mirror.
+///
+/// The tangential displacement norms are gathered into one array and the
+/// smooth friction mollifier is evaluated in a single batch (see the array
+/// overload of f0_SF), with the per-constraint coefficients and tangent
+/// bases read contiguously from the mirror.
+/// @param[in] mesh The collision mesh.
+/// @param[in] V0 Vertex positions at start of time-step (rowwise)
+/// @param[in] V1 Current vertex positions (rowwise)
+/// @param[in] friction_constraint_set The set of friction constraints.
+/// @param[in] soa Structure-of-arrays mirror of friction_constraint_set.
+/// @param[in] epsv_times_h Tolerance for the transition between static and dynamic friction.
+double compute_friction_potential(
+    const CollisionMesh& mesh,
+    ConstMatrixXdRef V0,
+    ConstMatrixXdRef V1,
+    const FrictionConstraints& friction_constraint_set,
+    const FrictionConstraintsSoA& soa,
+    double epsv_times_h);
+
 /// @brief Compute the gradient of the friction potential wrt V1.
 /// @param[in] mesh The collision mesh.
 /// @param[in] V0 Vertex positions at start of time-step (rowwise)
@@ -61,8 +114,8 @@ T compute_friction_potential(
 /// @param[in] epsv_times_h Tolerance for the transition between static and dynamic friction.
 Eigen::VectorXd compute_friction_potential_gradient(
     const CollisionMesh& mesh,
-    const Eigen::MatrixXd& V0,
-    const Eigen::MatrixXd& V1,
+    ConstMatrixXdRef V0,
+    ConstMatrixXdRef V1,
     const FrictionConstraints& friction_constraint_set,
     double epsv_times_h);
 
@@ -74,17 +127,85 @@ Eigen::VectorXd compute_friction_potential_gradient(
 /// @param[in] epsv_times_h Tolerance for the transition between static and dynamic friction.
 Eigen::SparseMatrix<double> compute_friction_potential_hessian(
     const CollisionMesh& mesh,
-    const Eigen::MatrixXd& V0,
-    const Eigen::MatrixXd& V1,
+    ConstMatrixXdRef V0,
+    ConstMatrixXdRef V1,
+    const FrictionConstraints& friction_constraint_set,
+    double epsv_times_h,
+    bool project_hessian_to_psd = true);
+
+/// @brief Compute the friction hessian using a reusable assembly context.
+///
+/// The context caches the compressed sparsity pattern, which only changes
+/// when the friction constraint set changes — with the constraints lagged
+/// over a nonlinear solve, that is many hessians at a time — so repeated
+/// calls skip the triplet construction and scatter the local hessians
+/// directly into the cached layout.
+/// @param[in] mesh The collision mesh.
+/// @param[in] V0 Vertex positions at start of time-step (rowwise)
+/// @param[in] V1 Current vertex positions (rowwise)
+/// @param[in] friction_constraint_set The set of friction constraints.
+/// @param[in] epsv_times_h Tolerance for the transition between static and dynamic friction.
+/// @param[in,out] cache Assembly context reused between calls.
+Eigen::SparseMatrix<double> compute_friction_potential_hessian(
+    const CollisionMesh& mesh,
+    ConstMatrixXdRef V0,
+    ConstMatrixXdRef V1,
     const FrictionConstraints& friction_constraint_set,
     double epsv_times_h,
+    HessianAssemblyCache& cache,
+    bool project_hessian_to_psd = true);
+
+/// @brief Compute the friction potential gradient and hessian in one pass.
+///
+/// The per-constraint tangential displacements, relative displacement
+/// matrices, and mollifier evaluations are shared between the two
+/// derivatives, instead of being recomputed by separate gradient and
+/// hessian calls.
+/// @param[in] mesh The collision mesh.
+/// @param[in] V0 Vertex positions at start of time-step (rowwise)
+/// @param[in] V1 Current vertex positions (rowwise)
+/// @param[in] friction_constraint_set The set of friction constraints.
+/// @param[in] epsv_times_h Tolerance for the transition between static and dynamic friction.
+/// @param[out] grad Gradient of the friction potential.
+/// @param[out] hess Hessian of the friction potential.
+/// @param[in,out] workspace Optional persistent scratch buffers; keeps the
+///                          assembly allocation-free across repeated calls.
+void compute_friction_potential_gradient_and_hessian(
+    const CollisionMesh& mesh,
+    ConstMatrixXdRef V0,
+    ConstMatrixXdRef V1,
+    const FrictionConstraints& friction_constraint_set,
+    double epsv_times_h,
+    Eigen::VectorXd& grad,
+    Eigen::SparseMatrix<double>& hess,
+    bool project_hessian_to_psd = true,
+    Workspace* const workspace = nullptr);
+
+/// @brief Compute the friction potential hessian in single precision.
+///
+/// The local kernels are still evaluated in double; only the assembled
+/// triplets and matrix are float, for solvers that tolerate
+/// single-precision hessians (e.g. with iterative refinement).
+/// @param[in] mesh The collision mesh.
+/// @param[in] V0 Vertex positions at start of time-step (rowwise)
+/// @param[in] V1 Current vertex positions (rowwise)
+/// @param[in] friction_constraint_set The set of friction constraints.
+/// @param[in] epsv_times_h Tolerance for the transition between static and dynamic friction.
+/// @param[out] hess The single-precision friction potential hessian.
+void compute_friction_potential_hessian(
+    const CollisionMesh& mesh,
+    ConstMatrixXdRef V0,
+    ConstMatrixXdRef V1,
+    const FrictionConstraints& friction_constraint_set,
+    double epsv_times_h,
+    Eigen::SparseMatrix<float>& hess,
     bool project_hessian_to_psd = true);
 
 Eigen::VectorXd compute_friction_force(
     const CollisionMesh& mesh,
-    const Eigen::MatrixXd& X,
-    const Eigen::MatrixXd& Ut,
-    const Eigen::MatrixXd& U,
+    ConstMatrixXdRef X,
+    ConstMatrixXdRef Ut,
+    ConstMatrixXdRef U,
     const FrictionConstraints& friction_constraint_set,
     const double dhat,
     const double barrier_stiffness,
@@ -94,8 +215,8 @@ Eigen::VectorXd compute_friction_force(
 
 inline Eigen::VectorXd compute_friction_force(
     const CollisionMesh& mesh,
-    const Eigen::MatrixXd& X,
-    const Eigen::MatrixXd& U,
+    ConstMatrixXdRef X,
+    ConstMatrixXdRef U,
     const FrictionConstraints& friction_constraint_set,
     const double dhat,
     const double barrier_stiffness,
@@ -111,20 +232,42 @@ inline Eigen::VectorXd compute_friction_force(
 
 Eigen::SparseMatrix<double> compute_friction_force_jacobian(
     const CollisionMesh& mesh,
-    const Eigen::MatrixXd& X,
-    const Eigen::MatrixXd& Ut,
-    const Eigen::MatrixXd& U,
+    ConstMatrixXdRef X,
+    ConstMatrixXdRef Ut,
+    ConstMatrixXdRef U,
+    const FrictionConstraints& friction_constraint_set,
+    const double dhat,
+    const double barrier_stiffness,
+    const double epsv_times_h,
+    const FrictionConstraint::DiffWRT wrt,
+    const double dmin = 0);
+
+/// @brief Compute the friction force jacobian using a reusable assembly
+/// context.
+///
+/// The context caches the compressed sparsity pattern, which only changes
+/// when the friction constraint set changes, so repeated calls (e.g. the
+/// backward passes of a differentiable simulation) skip the triplet
+/// assembly and scatter the local jacobians directly into the cached
+/// layout.
+/// @param[in,out] cache Assembly context reused between calls.
+Eigen::SparseMatrix<double> compute_friction_force_jacobian(
+    const CollisionMesh& mesh,
+    ConstMatrixXdRef X,
+    ConstMatrixXdRef Ut,
+    ConstMatrixXdRef U,
     const FrictionConstraints& friction_constraint_set,
     const double dhat,
     const double barrier_stiffness,
     const double epsv_times_h,
     const FrictionConstraint::DiffWRT wrt,
+    HessianAssemblyCache& cache,
     const double dmin = 0);
 
 inline Eigen::SparseMatrix<double> compute_friction_force_jacobian(
     const CollisionMesh& mesh,
-    const Eigen::MatrixXd& X,
-    const Eigen::MatrixXd& U,
+    ConstMatrixXdRef X,
+    ConstMatrixXdRef U,
     const FrictionConstraints& friction_constraint_set,
     const double dhat,
     const double barrier_stiffness,
@@ -9,13 +9,15 @@
 #include <ipc/distance/point_triangle.hpp>
 
 #include <ipc/config.hpp>
+#include <ipc/utils/memory_usage.hpp>
 
+#include <algorithm> // std::max
 #include <stdexcept> // std::out_of_range
 
 namespace ipc {
 
 void FrictionConstraint::init(
-    const Eigen::MatrixXd& V,
+    ConstMatrixXdRef V,
     const Eigen::MatrixXi& E,
     const Eigen::MatrixXi& F,
     const double dhat,
@@ -31,7 +33,7 @@ void FrictionConstraint::init(
 }
 
 VectorMax12d FrictionConstraint::compute_potential_gradient(
-    const Eigen::MatrixXd& U,
+    ConstMatrixXdRef U,
     const Eigen::MatrixXi& E,
     const Eigen::MatrixXi& F,
     double epsv_times_h) const
@@ -57,7 +59,7 @@ VectorMax12d FrictionConstraint::compute_potential_gradient(
 }
 
 MatrixMax12d FrictionConstraint::compute_potential_hessian(
-    const Eigen::MatrixXd& U,
+    ConstMatrixXdRef U,
     const Eigen::MatrixXi& E,
     const Eigen::MatrixXi& F,
     const double epsv_times_h,
@@ -127,10 +129,79 @@ MatrixMax12d FrictionConstraint::compute_potential_hessian(
     return hess;
 }
 
+void FrictionConstraint::compute_potential_gradient_and_hessian(
+    ConstMatrixXdRef U,
+    const Eigen::MatrixXi& E,
+    const Eigen::MatrixXi& F,
+    const double epsv_times_h,
+    const bool project_hessian_to_psd,
+    VectorMax12d& grad,
+    MatrixMax12d& hess) const
+{
+    assert(epsv_times_h > 0);
+
+    // Terms shared between the gradient and the hessian (see
+    // compute_potential_gradient and compute_potential_hessian for the
+    // derivations).
+
+    // Compute u = PᵀΓ(x - xᵗ)
+    const VectorMax2d u =
+        tangent_basis.transpose() * relative_displacement(select_dofs(U, E, F));
+
+    // Compute T = ΓᵀP
+    const MatrixMax<double, 12, 2> T =
+        relative_displacement_matrix().transpose() * tangent_basis;
+
+    // Compute ‖u‖
+    const double norm_u = u.norm();
+
+    // Compute f₁(‖u‖)/‖u‖
+    const double f1_over_norm_u = f1_SF_over_x(norm_u, epsv_times_h);
+
+    // Compute μ N(xᵗ)
+    const double scale = weight * mu * normal_force_magnitude;
+
+    // μ N(xᵗ) f₁(‖u‖)/‖u‖ T(xᵗ) u ∈ ℝⁿ
+    grad = scale * f1_over_norm_u * (T * u);
+
+    if (norm_u >= epsv_times_h) {
+        // f₁(‖u‖) = 1 ⟹ f₁'(‖u‖) = 0
+        //  ⟹ ∇²D(x) = μ N T [f₁(‖u‖)/‖u‖ (I - uuᵀ/‖u‖²)] Tᵀ
+        if (dim() == 2) {
+            // I - uuᵀ/‖u‖² = 1 - u²/u² = 0 ⟹ ∇²D(x) = 0
+            int n = T.rows(); // num vars
+            hess.setZero(n, n);
+        } else {
+            assert(dim() == 3);
+            // I - uuᵀ/‖u‖² = ūūᵀ / ‖u‖² (where ū⋅u = 0)
+            Eigen::Vector2d u_perp(-u[1], u[0]);
+            hess = // grouped to reduce number of operations
+                (T * ((scale * f1_over_norm_u / (norm_u * norm_u)) * u_perp))
+                * (u_perp.transpose() * T.transpose());
+        }
+    } else if (norm_u == 0) {
+        // lim_{‖u‖→0} ∇²D = μ N T [f₁(‖u‖)/‖u‖ I] Tᵀ
+        hess = scale * f1_over_norm_u * T * T.transpose();
+    } else {
+        // ∇²D(x) = μ N T [f₂(‖u‖) uuᵀ + f₁(‖u‖)/‖u‖ I] Tᵀ
+        //  ⟹ only need to project the inner 2x2 matrix to SPD
+        const double f2 = df1_x_minus_f1_over_x3(norm_u, epsv_times_h);
+
+        MatrixMax2d inner_hess = f2 * u * u.transpose();
+        inner_hess.diagonal().array() += f1_over_norm_u;
+        inner_hess *= scale;
+        if (project_hessian_to_psd) {
+            inner_hess = project_to_psd(inner_hess);
+        }
+
+        hess = T * inner_hess * T.transpose();
+    }
+}
+
 VectorMax12d FrictionConstraint::compute_force(
     const Eigen::MatrixXd& X,
-    const Eigen::MatrixXd& Ut,
-    const Eigen::MatrixXd& U,
+    ConstMatrixXdRef Ut,
+    ConstMatrixXdRef U,
     const Eigen::MatrixXi& E,
     const Eigen::MatrixXi& F,
     const double dhat,
@@ -193,8 +264,8 @@ VectorMax12d FrictionConstraint::compute_force(
 
 MatrixMax12d FrictionConstraint::compute_force_jacobian(
     const Eigen::MatrixXd& X,
-    const Eigen::MatrixXd& Ut,
-    const Eigen::MatrixXd& U,
+    ConstMatrixXdRef Ut,
+    ConstMatrixXdRef U,
     const Eigen::MatrixXi& E,
     const Eigen::MatrixXi& F,
     const double dhat,
@@ -404,7 +475,7 @@ VectorMax12d FrictionConstraint::compute_normal_force_magnitude_gradient(
 ///////////////////////////////////////////////////////////////////////////////
 
 VertexVertexFrictionConstraint::VertexVertexFrictionConstraint(
-    long vertex0_index, long vertex1_index)
+    index_t vertex0_index, index_t vertex1_index)
     : VertexVertexCandidate(vertex0_index, vertex1_index)
 {
 }
@@ -486,7 +557,7 @@ VertexVertexFrictionConstraint::relative_displacement_matrix_jacobian(
 ///////////////////////////////////////////////////////////////////////////////
 
 EdgeVertexFrictionConstraint::EdgeVertexFrictionConstraint(
-    long edge_index, long vertex_index)
+    index_t edge_index, index_t vertex_index)
     : EdgeVertexCandidate(edge_index, vertex_index)
 {
 }
@@ -582,7 +653,7 @@ EdgeVertexFrictionConstraint::relative_displacement_matrix_jacobian(
 ///////////////////////////////////////////////////////////////////////////////
 
 EdgeEdgeFrictionConstraint::EdgeEdgeFrictionConstraint(
-    long edge0_index, long edge1_index)
+    index_t edge0_index, index_t edge1_index)
     : EdgeEdgeCandidate(edge0_index, edge1_index)
 {
 }
@@ -680,7 +751,7 @@ EdgeEdgeFrictionConstraint::relative_displacement_matrix_jacobian(
 ///////////////////////////////////////////////////////////////////////////////
 
 FaceVertexFrictionConstraint::FaceVertexFrictionConstraint(
-    long face_index, long vertex_index)
+    index_t face_index, index_t vertex_index)
     : FaceVertexCandidate(face_index, vertex_index)
 {
 }
@@ -796,6 +867,30 @@ void FrictionConstraints::clear()
     fv_constraints.clear();
 }
 
+size_t FrictionConstraints::bytes_used() const
+{
+    // As in Constraints::bytes_used(), the weight gradients are separate
+    // heap allocations per constraint.
+    const auto weight_gradient_bytes = [](const auto& constraints) {
+        size_t bytes = 0;
+        for (const auto& constraint : constraints) {
+            bytes += sparse_vector_bytes_used(constraint.weight_gradient);
+        }
+        return bytes;
+    };
+
+    const size_t bytes = vector_bytes_used(vv_constraints)
+        + vector_bytes_used(ev_constraints)
+        + vector_bytes_used(ee_constraints)
+        + vector_bytes_used(fv_constraints)
+        + weight_gradient_bytes(vv_constraints)
+        + weight_gradient_bytes(ev_constraints)
+        + weight_gradient_bytes(ee_constraints)
+        + weight_gradient_bytes(fv_constraints) + matrix_bytes_used(m_V);
+    m_peak_bytes_used = std::max(m_peak_bytes_used, bytes);
+    return bytes;
+}
+
 FrictionConstraint& FrictionConstraints::operator[](size_t idx)
 {
     if (idx < vv_constraints.size()) {
@@ -836,4 +931,28 @@ const FrictionConstraint& FrictionConstraints::operator[](size_t idx) const
     throw std::out_of_range("Friction constraint index is out of range!");
 }
 
+///////////////////////////////////////////////////////////////////////////////
+
+FrictionConstraintsSoA::FrictionConstraintsSoA(
+    const FrictionConstraints& friction_constraint_set)
+{
+    const size_t num_constraints = friction_constraint_set.size();
+
+    coeffs.resize(num_constraints);
+    if (num_constraints == 0) {
+        return;
+    }
+
+    dim = friction_constraint_set[0].tangent_basis.rows();
+    tangent_bases.resize(dim * num_constraints, 2);
+
+    for (size_t i = 0; i < num_constraints; i++) {
+        const FrictionConstraint& constraint = friction_constraint_set[i];
+        coeffs[i] = constraint.weight * constraint.mu
+            * constraint.normal_force_magnitude;
+        assert(constraint.tangent_basis.rows() == dim);
+        tangent_bases.middleRows(dim * i, dim) = constraint.tangent_basis;
+    }
+}
+
 } // namespace ipc
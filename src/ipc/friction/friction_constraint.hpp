@@ -7,6 +7,8 @@
 
 #include <ipc/config.hpp>
 
+#include <functional>
+
 namespace ipc {
 
 struct FrictionConstraint {
@@ -29,25 +31,47 @@ struct FrictionConstraint {
     virtual ~FrictionConstraint() { }
 
     virtual int num_vertices() const = 0;
-    virtual std::array<long, 4> vertex_indices(
+    virtual std::array<index_t, 4> vertex_indices(
         const Eigen::MatrixXi& E, const Eigen::MatrixXi& F) const = 0;
 
     virtual VectorMax12d compute_potential_gradient(
-        const Eigen::MatrixXd& U,
+        ConstMatrixXdRef U,
         const Eigen::MatrixXi& E,
         const Eigen::MatrixXi& F,
         const double epsv_times_h) const;
 
     virtual MatrixMax12d compute_potential_hessian(
-        const Eigen::MatrixXd& U,
+        ConstMatrixXdRef U,
         const Eigen::MatrixXi& E,
         const Eigen::MatrixXi& F,
         const double epsv_times_h,
         const bool project_hessian_to_psd) const;
 
+    /// @brief Compute the potential gradient and hessian in one pass.
+    ///
+    /// The tangential displacement, relative displacement matrix, and
+    /// mollifier evaluations are shared between the two derivatives instead
+    /// of being recomputed by separate calls.
+    /// @param[in] U Displacements of the vertices.
+    /// @param[in] E Edges of the collision mesh.
+    /// @param[in] F Faces of the collision mesh.
+    /// @param[in] epsv_times_h Tolerance for the transition between static
+    /// and dynamic friction.
+    /// @param[in] project_hessian_to_psd Project the hessian to PSD.
+    /// @param[out] grad Gradient of the potential.
+    /// @param[out] hess Hessian of the potential.
+    virtual void compute_potential_gradient_and_hessian(
+        ConstMatrixXdRef U,
+        const Eigen::MatrixXi& E,
+        const Eigen::MatrixXi& F,
+        const double epsv_times_h,
+        const bool project_hessian_to_psd,
+        VectorMax12d& grad,
+        MatrixMax12d& hess) const;
+
     virtual VectorMax12d compute_force(
         const Eigen::MatrixXd& X,
-        const Eigen::MatrixXd& U,
+        ConstMatrixXdRef U,
         const Eigen::MatrixXi& E,
         const Eigen::MatrixXi& F,
         const double dhat,
@@ -63,8 +87,8 @@ struct FrictionConstraint {
 
     virtual VectorMax12d compute_force(
         const Eigen::MatrixXd& X,
-        const Eigen::MatrixXd& Ut,
-        const Eigen::MatrixXd& U,
+        ConstMatrixXdRef Ut,
+        ConstMatrixXdRef U,
         const Eigen::MatrixXi& E,
         const Eigen::MatrixXi& F,
         const double dhat,
@@ -73,11 +97,48 @@ struct FrictionConstraint {
         const double dmin = 0,
         const bool no_mu = false) const; //< whether to not multiply by mu
 
+    /// @brief Recompute the cached normal force magnitude for new positions.
+    ///
+    /// The tangent basis and closest point are left untouched (see
+    /// update_friction_constraint_set).
+    void update_normal_force_magnitude(
+        ConstMatrixXdRef V,
+        const Eigen::MatrixXi& E,
+        const Eigen::MatrixXi& F,
+        const double dhat,
+        const double barrier_stiffness,
+        const double dmin = 0)
+    {
+        normal_force_magnitude = compute_normal_force_magnitude(
+            select_dofs(V, E, F), dhat, barrier_stiffness, dmin);
+    }
+
+    /// @brief Compute the squared contact distance at the given positions.
+    ///
+    /// Used to gather the distances of a whole friction set for the batched
+    /// normal force update (see update_friction_constraint_set).
+    double compute_distance(
+        ConstMatrixXdRef V,
+        const Eigen::MatrixXi& E,
+        const Eigen::MatrixXi& F) const
+    {
+        return compute_distance(select_dofs(V, E, F));
+    }
+
+    /// @brief Compute the relative displacement of the contact point(s).
+    VectorMax3d compute_relative_displacement(
+        ConstMatrixXdRef U,
+        const Eigen::MatrixXi& E,
+        const Eigen::MatrixXi& F) const
+    {
+        return relative_displacement(select_dofs(U, E, F));
+    }
+
     enum class DiffWRT { X, Ut, U };
 
     virtual MatrixMax12d compute_force_jacobian(
         const Eigen::MatrixXd& X,
-        const Eigen::MatrixXd& U,
+        ConstMatrixXdRef U,
         const Eigen::MatrixXi& E,
         const Eigen::MatrixXi& F,
         const double dhat,
@@ -93,8 +154,8 @@ struct FrictionConstraint {
 
     virtual MatrixMax12d compute_force_jacobian(
         const Eigen::MatrixXd& X,
-        const Eigen::MatrixXd& Ut,
-        const Eigen::MatrixXd& U,
+        ConstMatrixXdRef Ut,
+        ConstMatrixXdRef U,
         const Eigen::MatrixXi& E,
         const Eigen::MatrixXi& F,
         const double dhat,
@@ -108,21 +169,21 @@ protected:
     int ndof() const { return dim() * num_vertices(); };
 
     void init(
-        const Eigen::MatrixXd& V,
+        ConstMatrixXdRef V,
         const Eigen::MatrixXi& E,
         const Eigen::MatrixXi& F,
         const double dhat,
         const double barrier_stiffness,
         const double dmin);
 
-    template <typename T>
+    template <typename DerivedX, typename T = typename DerivedX::Scalar>
     VectorMax12<T> select_dofs(
-        const MatrixX<T>& X,
+        const Eigen::MatrixBase<DerivedX>& X,
         const Eigen::MatrixXi& E,
         const Eigen::MatrixXi& F) const
     {
         VectorMax12<T> x(ndof());
-        const std::array<long, 4> idx = vertex_indices(E, F);
+        const std::array<index_t, 4> idx = vertex_indices(E, F);
         for (int i = 0; i < num_vertices(); i++) {
             x.segment(i * dim(), dim()) = X.row(idx[i]);
         }
@@ -185,12 +246,13 @@ protected:
 
 struct VertexVertexFrictionConstraint : VertexVertexCandidate,
                                         FrictionConstraint {
-    VertexVertexFrictionConstraint(long vertex0_index, long vertex1_index);
+    VertexVertexFrictionConstraint(
+        index_t vertex0_index, index_t vertex1_index);
     VertexVertexFrictionConstraint(const VertexVertexCandidate& candidate);
     VertexVertexFrictionConstraint(const VertexVertexConstraint& constraint);
     VertexVertexFrictionConstraint(
         const VertexVertexConstraint& constraint,
-        const Eigen::MatrixXd& V,
+        ConstMatrixXdRef V,
         const Eigen::MatrixXi& E,
         const Eigen::MatrixXi& F,
         const double dhat,
@@ -202,7 +264,7 @@ struct VertexVertexFrictionConstraint : VertexVertexCandidate,
     }
 
     int num_vertices() const override { return 2; }
-    std::array<long, 4> vertex_indices(
+    std::array<index_t, 4> vertex_indices(
         const Eigen::MatrixXi& E, const Eigen::MatrixXi& F) const override
     {
         return { { vertex0_index, vertex1_index, -1, -1 } };
@@ -260,12 +322,12 @@ private:
 ///////////////////////////////////////////////////////////////////////////////
 
 struct EdgeVertexFrictionConstraint : EdgeVertexCandidate, FrictionConstraint {
-    EdgeVertexFrictionConstraint(long edge_index, long vertex_index);
+    EdgeVertexFrictionConstraint(index_t edge_index, index_t vertex_index);
     EdgeVertexFrictionConstraint(const EdgeVertexCandidate& constraint);
     EdgeVertexFrictionConstraint(const EdgeVertexConstraint& constraint);
     EdgeVertexFrictionConstraint(
         const EdgeVertexConstraint& constraint,
-        const Eigen::MatrixXd& V,
+        ConstMatrixXdRef V,
         const Eigen::MatrixXi& E,
         const Eigen::MatrixXi& F,
         const double dhat,
@@ -277,7 +339,7 @@ struct EdgeVertexFrictionConstraint : EdgeVertexCandidate, FrictionConstraint {
     }
 
     int num_vertices() const override { return 3; }
-    std::array<long, 4> vertex_indices(
+    std::array<index_t, 4> vertex_indices(
         const Eigen::MatrixXi& E, const Eigen::MatrixXi& F) const override
     {
         return { { vertex_index, E(edge_index, 0), E(edge_index, 1), -1 } };
@@ -337,12 +399,12 @@ private:
 ///////////////////////////////////////////////////////////////////////////////
 
 struct EdgeEdgeFrictionConstraint : EdgeEdgeCandidate, FrictionConstraint {
-    EdgeEdgeFrictionConstraint(long edge0_index, long edge1_index);
+    EdgeEdgeFrictionConstraint(index_t edge0_index, index_t edge1_index);
     EdgeEdgeFrictionConstraint(const EdgeEdgeCandidate& constraint);
     EdgeEdgeFrictionConstraint(const EdgeEdgeConstraint& constraint);
     EdgeEdgeFrictionConstraint(
         const EdgeEdgeConstraint& constraint,
-        const Eigen::MatrixXd& V,
+        ConstMatrixXdRef V,
         const Eigen::MatrixXi& E,
         const Eigen::MatrixXi& F,
         const double dhat,
@@ -354,7 +416,7 @@ struct EdgeEdgeFrictionConstraint : EdgeEdgeCandidate, FrictionConstraint {
     }
 
     int num_vertices() const override { return 4; }
-    std::array<long, 4> vertex_indices(
+    std::array<index_t, 4> vertex_indices(
         const Eigen::MatrixXi& E, const Eigen::MatrixXi& F) const override
     {
         return { { E(edge0_index, 0), E(edge0_index, 1), //
@@ -415,12 +477,12 @@ private:
 ///////////////////////////////////////////////////////////////////////////////
 
 struct FaceVertexFrictionConstraint : FaceVertexCandidate, FrictionConstraint {
-    FaceVertexFrictionConstraint(long face_index, long vertex_index);
+    FaceVertexFrictionConstraint(index_t face_index, index_t vertex_index);
     FaceVertexFrictionConstraint(const FaceVertexCandidate& constraint);
     FaceVertexFrictionConstraint(const FaceVertexConstraint& constraint);
     FaceVertexFrictionConstraint(
         const FaceVertexConstraint& constraint,
-        const Eigen::MatrixXd& V,
+        ConstMatrixXdRef V,
         const Eigen::MatrixXi& E,
         const Eigen::MatrixXi& F,
         const double dhat,
@@ -432,7 +494,7 @@ struct FaceVertexFrictionConstraint : FaceVertexCandidate, FrictionConstraint {
     }
 
     int num_vertices() const override { return 4; }
-    std::array<long, 4> vertex_indices(
+    std::array<index_t, 4> vertex_indices(
         const Eigen::MatrixXi& E, const Eigen::MatrixXi& F) const override
     {
         return { { vertex_index, //
@@ -504,8 +566,78 @@ struct FrictionConstraints {
 
     void clear();
 
+    /// @brief Bytes of heap memory held by the friction constraint set.
+    ///
+    /// Counts the constraint vectors (capacity, not only the used size), the
+    /// per-constraint weight gradients, and the stored build positions.
+    /// Updates peak_bytes_used().
+    size_t bytes_used() const;
+
+    /// @brief Largest value bytes_used() has returned on this object.
+    /// The peak persists across clear().
+    size_t peak_bytes_used() const { return m_peak_bytes_used; }
+
     FrictionConstraint& operator[](size_t idx);
     const FrictionConstraint& operator[](size_t idx) const;
+
+    /// @brief Vertices the set was last fully built from (empty if the set
+    /// was never built by construct_friction_constraint_set).
+    const Eigen::MatrixXd& built_from_positions() const { return m_V; }
+
+protected:
+    /// @brief Vertices the set was last fully built from.
+    /// Used by update_friction_constraint_set to measure how far the
+    /// vertices have moved since the tangent bases were computed.
+    Eigen::MatrixXd m_V;
+
+    /// @brief Peak of bytes_used() (see peak_bytes_used()).
+    mutable size_t m_peak_bytes_used = 0;
+
+    friend void construct_friction_constraint_set(
+        const CollisionMesh& mesh,
+        ConstMatrixXdRef V,
+        const Constraints& contact_constraint_set,
+        double dhat,
+        double barrier_stiffness,
+        const Eigen::VectorXd& mus,
+        const std::function<double(double, double)>& blend_mu,
+        FrictionConstraints& friction_constraint_set);
+
+    friend bool update_friction_constraint_set(
+        const CollisionMesh& mesh,
+        ConstMatrixXdRef V,
+        const Constraints& contact_constraint_set,
+        double dhat,
+        double barrier_stiffness,
+        FrictionConstraints& friction_constraint_set,
+        double rebuild_tolerance);
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+/// @brief Structure-of-arrays mirror of a FrictionConstraints set.
+///
+/// The per-constraint coefficients and tangent bases are packed into
+/// contiguous arrays, so batched evaluations (see the
+/// compute_friction_potential overload taking this mirror) get contiguous
+/// loads and SIMD across constraints instead of pointer-chasing the AoS
+/// vectors. Build it once per friction set; it stays valid as long as the
+/// set it mirrors is unchanged.
+struct FrictionConstraintsSoA {
+    FrictionConstraintsSoA() = default;
+
+    explicit FrictionConstraintsSoA(
+        const FrictionConstraints& friction_constraint_set);
+
+    /// @brief coeffs[i] = weight · mu · normal_force_magnitude of
+    /// constraint i.
+    Eigen::ArrayXd coeffs;
+
+    /// @brief Tangent bases stacked vertically (dim rows per constraint).
+    Eigen::Matrix<double, Eigen::Dynamic, 2> tangent_bases;
+
+    /// @brief Rows of each tangent basis (2 or 3).
+    int dim = 0;
 };
 
 } // namespace ipc
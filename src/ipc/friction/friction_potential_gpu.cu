@@ -0,0 +1,566 @@
+#include "friction_potential_gpu.hpp"
+
+#ifdef IPC_TOOLKIT_WITH_CUDA
+
+#include <cuda_runtime.h>
+
+#include <algorithm> // std::lower_bound, std::sort, std::unique
+#include <cmath>
+#include <stdexcept>
+
+namespace ipc {
+
+namespace {
+
+    constexpr int BLOCK_SIZE = 256;
+
+    inline int num_blocks(size_t n)
+    {
+        return int((n + BLOCK_SIZE - 1) / BLOCK_SIZE);
+    }
+
+    inline void check_cuda(cudaError_t status)
+    {
+        if (status != cudaSuccess) {
+            throw std::runtime_error(
+                std::string("FrictionPotentialGPU CUDA error: ")
+                + cudaGetErrorString(status));
+        }
+    }
+
+    template <typename T> T* device_alloc(const size_t count)
+    {
+        T* ptr = nullptr;
+        check_cuda(cudaMalloc(&ptr, count * sizeof(T)));
+        return ptr;
+    }
+
+    template <typename T>
+    void device_upload(T* d_ptr, const std::vector<T>& values)
+    {
+        check_cuda(cudaMemcpy(
+            d_ptr, values.data(), values.size() * sizeof(T),
+            cudaMemcpyHostToDevice));
+    }
+
+    // ---------------------------------------------------------------------
+    // Smooth friction mollifier (matches smooth_friction_mollifier.tpp)
+
+    __device__ inline double f0_SF_d(const double x, const double epsv_times_h)
+    {
+        if (fabs(x) >= epsv_times_h) {
+            return x;
+        }
+        return x * x * (-x / (3 * epsv_times_h) + 1) / epsv_times_h
+            + epsv_times_h / 3;
+    }
+
+    __device__ inline double
+    f1_SF_over_x_d(const double x, const double epsv_times_h)
+    {
+        if (fabs(x) >= epsv_times_h) {
+            return 1 / x;
+        }
+        return (-x / epsv_times_h + 2) / epsv_times_h;
+    }
+
+    __device__ inline double
+    df1_x_minus_f1_over_x3_d(const double x, const double epsv_times_h)
+    {
+        if (fabs(x) >= epsv_times_h) {
+            return -1 / (x * x * x);
+        }
+        return -1 / (x * epsv_times_h * epsv_times_h);
+    }
+
+    // ---------------------------------------------------------------------
+    // Tangential displacement
+    //
+    // With the closest point lagged, the relative displacement of constraint
+    // i is Σₖ γₖ uₖ with signed weights γₖ (the diagonals of the
+    // relative-displacement matrix Γ; see relative_displacement.hpp), so
+    // the tangential displacement is u = Pᵀ Σₖ γₖ uₖ with the lagged 3x2
+    // tangent basis P, and T = ΓᵀP has the 3x2 block γₖ P at vertex k.
+
+    __device__ inline void compute_tangential_displacement(
+        const double* U,
+        const int* ids,
+        const double* gammas,
+        const double* P, // row-major 3x2
+        double u[2])
+    {
+        double rel[3] = { 0, 0, 0 };
+        for (int k = 0; k < 4; k++) {
+            if (ids[k] >= 0 && gammas[k] != 0) {
+                rel[0] += gammas[k] * U[3 * ids[k] + 0];
+                rel[1] += gammas[k] * U[3 * ids[k] + 1];
+                rel[2] += gammas[k] * U[3 * ids[k] + 2];
+            }
+        }
+        u[0] = P[0] * rel[0] + P[2] * rel[1] + P[4] * rel[2];
+        u[1] = P[1] * rel[0] + P[3] * rel[1] + P[5] * rel[2];
+    }
+
+    /// @brief Project a symmetric 2x2 matrix to PSD (closed-form
+    /// eigendecomposition; matches project_to_psd for the 2x2 case).
+    __device__ inline void project_2x2_to_psd(double M[3]) // {a, b, c}
+    {
+        const double mean = (M[0] + M[2]) / 2;
+        const double radius =
+            sqrt((M[0] - M[2]) * (M[0] - M[2]) / 4 + M[1] * M[1]);
+        const double lambda_min = mean - radius;
+        if (lambda_min >= 0) {
+            return; // already PSD
+        }
+        const double lambda_max = mean + radius;
+        if (lambda_max <= 0) {
+            M[0] = M[1] = M[2] = 0;
+            return;
+        }
+        // Keep λ₊ v₊v₊ᵀ with v₊ the eigenvector of λ₊.
+        double vx, vy;
+        if (M[1] != 0) {
+            vx = lambda_max - M[2], vy = M[1];
+        } else { // diagonal matrix
+            vx = M[0] >= M[2] ? 1 : 0, vy = M[0] >= M[2] ? 0 : 1;
+        }
+        const double scale = lambda_max / (vx * vx + vy * vy);
+        M[0] = scale * vx * vx;
+        M[1] = scale * vx * vy;
+        M[2] = scale * vy * vy;
+    }
+
+    // ---------------------------------------------------------------------
+    // Kernels
+
+    __global__ void potential_kernel(
+        const size_t num_constraints,
+        const double* U,
+        const int* vertex_ids,
+        const double* gammas,
+        const double* coeffs,
+        const double* bases,
+        const double epsv_times_h,
+        double* potential)
+    {
+        __shared__ double partial[BLOCK_SIZE];
+
+        const size_t ci = blockIdx.x * blockDim.x + threadIdx.x;
+        double value = 0;
+        if (ci < num_constraints) {
+            double u[2];
+            compute_tangential_displacement(
+                U, vertex_ids + 4 * ci, gammas + 4 * ci, bases + 6 * ci, u);
+            value = coeffs[ci]
+                * f0_SF_d(sqrt(u[0] * u[0] + u[1] * u[1]), epsv_times_h);
+        }
+
+        partial[threadIdx.x] = value;
+        __syncthreads();
+        for (int stride = BLOCK_SIZE / 2; stride > 0; stride /= 2) {
+            if (threadIdx.x < stride) {
+                partial[threadIdx.x] += partial[threadIdx.x + stride];
+            }
+            __syncthreads();
+        }
+        if (threadIdx.x == 0) {
+            atomicAdd(potential, partial[0]);
+        }
+    }
+
+    __global__ void gradient_kernel(
+        const size_t num_constraints,
+        const double* U,
+        const int* vertex_ids,
+        const double* gammas,
+        const double* coeffs,
+        const double* bases,
+        const double epsv_times_h,
+        double* gradient)
+    {
+        const size_t ci = blockIdx.x * blockDim.x + threadIdx.x;
+        if (ci >= num_constraints) {
+            return;
+        }
+        const int* ids = vertex_ids + 4 * ci;
+        const double* gamma = gammas + 4 * ci;
+        const double* P = bases + 6 * ci;
+
+        double u[2];
+        compute_tangential_displacement(U, ids, gamma, P, u);
+
+        // μ N f₁(‖u‖)/‖u‖ T u with T = ΓᵀP ⟹ the gradient at vertex k is
+        // μ N f₁(‖u‖)/‖u‖ γₖ (P u).
+        const double scale = coeffs[ci]
+            * f1_SF_over_x_d(sqrt(u[0] * u[0] + u[1] * u[1]), epsv_times_h);
+        const double Pu[3] = {
+            P[0] * u[0] + P[1] * u[1],
+            P[2] * u[0] + P[3] * u[1],
+            P[4] * u[0] + P[5] * u[1],
+        };
+
+        for (int k = 0; k < 4; k++) {
+            if (ids[k] < 0 || gamma[k] == 0) {
+                continue;
+            }
+            atomicAdd(&gradient[3 * ids[k] + 0], scale * gamma[k] * Pu[0]);
+            atomicAdd(&gradient[3 * ids[k] + 1], scale * gamma[k] * Pu[1]);
+            atomicAdd(&gradient[3 * ids[k] + 2], scale * gamma[k] * Pu[2]);
+        }
+    }
+
+    __global__ void hessian_kernel(
+        const size_t num_constraints,
+        const double* U,
+        const int* vertex_ids,
+        const double* gammas,
+        const double* coeffs,
+        const double* bases,
+        const int* block_slots,
+        const double epsv_times_h,
+        const bool project_hessian_to_psd,
+        double* values)
+    {
+        const size_t ci = blockIdx.x * blockDim.x + threadIdx.x;
+        if (ci >= num_constraints) {
+            return;
+        }
+        const int* ids = vertex_ids + 4 * ci;
+        const double* gamma = gammas + 4 * ci;
+        const double* P = bases + 6 * ci;
+        const int* slots = block_slots + 16 * ci;
+
+        double u[2];
+        compute_tangential_displacement(U, ids, gamma, P, u);
+        const double norm_u = sqrt(u[0] * u[0] + u[1] * u[1]);
+        const double f1_over_norm_u = f1_SF_over_x_d(norm_u, epsv_times_h);
+        const double scale = coeffs[ci];
+
+        // Inner 2x2 hessian M so ∇²D = T M Tᵀ (symmetric {a, b; b, c});
+        // the three branches match FrictionConstraint::
+        // compute_potential_hessian.
+        double M[3];
+        if (norm_u >= epsv_times_h) {
+            // μ N f₁(‖u‖)/‖u‖ (I - uuᵀ/‖u‖²) = μ N f₁/‖u‖³ ūūᵀ (ū ⊥ u);
+            // PSD by construction.
+            const double s =
+                scale * f1_over_norm_u / (norm_u * norm_u);
+            M[0] = s * u[1] * u[1];
+            M[1] = -s * u[0] * u[1];
+            M[2] = s * u[0] * u[0];
+        } else if (norm_u == 0) {
+            // lim_{‖u‖→0} = μ N f₁(‖u‖)/‖u‖ I; PSD by construction.
+            M[0] = M[2] = scale * f1_over_norm_u;
+            M[1] = 0;
+        } else {
+            const double f2 =
+                df1_x_minus_f1_over_x3_d(norm_u, epsv_times_h);
+            M[0] = scale * (f2 * u[0] * u[0] + f1_over_norm_u);
+            M[1] = scale * f2 * u[0] * u[1];
+            M[2] = scale * (f2 * u[1] * u[1] + f1_over_norm_u);
+            if (project_hessian_to_psd) {
+                project_2x2_to_psd(M);
+            }
+        }
+
+        // B = P M Pᵀ (3x3); the block at (a, b) is γₐγ_b B.
+        double PM[6]; // row-major 3x2
+        for (int r = 0; r < 3; r++) {
+            PM[2 * r + 0] = P[2 * r + 0] * M[0] + P[2 * r + 1] * M[1];
+            PM[2 * r + 1] = P[2 * r + 0] * M[1] + P[2 * r + 1] * M[2];
+        }
+        double B[9];
+        for (int r = 0; r < 3; r++) {
+            for (int c = 0; c < 3; c++) {
+                B[3 * r + c] =
+                    PM[2 * r + 0] * P[2 * c + 0] + PM[2 * r + 1] * P[2 * c + 1];
+            }
+        }
+
+        for (int a = 0; a < 4; a++) {
+            if (ids[a] < 0 || gamma[a] == 0) {
+                continue;
+            }
+            for (int b = 0; b < 4; b++) {
+                if (ids[b] < 0 || gamma[b] == 0) {
+                    continue;
+                }
+                const int slot = slots[4 * a + b];
+                const double gab = gamma[a] * gamma[b];
+                for (int e = 0; e < 9; e++) {
+                    atomicAdd(&values[9 * slot + e], gab * B[e]);
+                }
+            }
+        }
+    }
+
+} // namespace
+
+FrictionPotentialGPU::~FrictionPotentialGPU() { clear(); }
+
+void FrictionPotentialGPU::clear()
+{
+    cudaFree(d_vertex_ids);
+    cudaFree(d_gammas);
+    cudaFree(d_coeffs);
+    cudaFree(d_bases);
+    cudaFree(d_block_slots);
+    if (m_owns_displacements) {
+        cudaFree(d_displacements);
+    }
+    cudaFree(d_gradient);
+    cudaFree(d_hessian_values);
+    cudaFree(d_potential);
+    d_vertex_ids = d_block_slots = nullptr;
+    d_gammas = d_coeffs = d_bases = nullptr;
+    d_displacements = d_gradient = d_hessian_values = d_potential = nullptr;
+    m_owns_displacements = false;
+    m_num_constraints = 0;
+    m_num_vertices = 0;
+    m_block_row_offsets.clear();
+    m_block_cols.clear();
+}
+
+void FrictionPotentialGPU::set_constraints(
+    const CollisionMesh& mesh,
+    const FrictionConstraints& friction_constraint_set)
+{
+    if (mesh.dim() != 3) {
+        throw std::runtime_error("FrictionPotentialGPU requires a 3D mesh!");
+    }
+
+    clear();
+
+    const Eigen::MatrixXi& E = mesh.edges();
+    const Eigen::MatrixXi& F = mesh.faces();
+
+    m_num_constraints = friction_constraint_set.size();
+    m_num_vertices = mesh.num_vertices();
+
+    // Flatten the friction set in operator[] order (vv, ev, ee, fv). Each
+    // constraint reduces to its stencil, the signed relative-displacement
+    // weights γ of its lagged closest point, the lagged tangent basis, and
+    // the coefficient weight · mu · N.
+    std::vector<int> vertex_ids(4 * m_num_constraints, -1);
+    std::vector<double> gammas(4 * m_num_constraints, 0);
+    std::vector<double> coeffs(m_num_constraints);
+    std::vector<double> bases(6 * m_num_constraints, 0);
+
+    size_t ci = 0;
+    const auto flatten = [&](const FrictionConstraint& constraint,
+                             const VectorMax6d& gamma) {
+        const std::array<index_t, 4> ids = constraint.vertex_indices(E, F);
+        for (int k = 0; k < gamma.size(); k++) {
+            vertex_ids[4 * ci + k] = int(ids[k]);
+            gammas[4 * ci + k] = gamma[k];
+        }
+        coeffs[ci] = constraint.weight * constraint.mu
+            * constraint.normal_force_magnitude;
+        for (int r = 0; r < 3; r++) {
+            for (int c = 0; c < 2; c++) {
+                bases[6 * ci + 2 * r + c] = constraint.tangent_basis(r, c);
+            }
+        }
+        ci++;
+    };
+    for (const auto& constraint : friction_constraint_set.vv_constraints) {
+        flatten(constraint, Eigen::Vector2d(1, -1));
+    }
+    for (const auto& constraint : friction_constraint_set.ev_constraints) {
+        const double alpha = constraint.closest_point[0];
+        flatten(constraint, Eigen::Vector3d(1, alpha - 1, -alpha));
+    }
+    for (const auto& constraint : friction_constraint_set.ee_constraints) {
+        const VectorMax2d& beta = constraint.closest_point;
+        flatten(
+            constraint,
+            Eigen::Vector4d(1 - beta[0], beta[0], beta[1] - 1, -beta[1]));
+    }
+    for (const auto& constraint : friction_constraint_set.fv_constraints) {
+        const VectorMax2d& beta = constraint.closest_point;
+        flatten(
+            constraint,
+            Eigen::Vector4d(1, beta[0] + beta[1] - 1, -beta[0], -beta[1]));
+    }
+    assert(ci == m_num_constraints);
+
+    // Build the BSR pattern: one 3x3 block per vertex pair of any stencil.
+    std::vector<long> block_keys;
+    block_keys.reserve(16 * m_num_constraints);
+    for (size_t i = 0; i < m_num_constraints; i++) {
+        for (int a = 0; a < 4; a++) {
+            const int via = vertex_ids[4 * i + a];
+            if (via < 0) {
+                continue;
+            }
+            for (int b = 0; b < 4; b++) {
+                const int vib = vertex_ids[4 * i + b];
+                if (vib >= 0) {
+                    block_keys.push_back(long(via) * m_num_vertices + vib);
+                }
+            }
+        }
+    }
+    std::sort(block_keys.begin(), block_keys.end());
+    block_keys.erase(
+        std::unique(block_keys.begin(), block_keys.end()), block_keys.end());
+
+    m_block_row_offsets.assign(m_num_vertices + 1, 0);
+    m_block_cols.resize(block_keys.size());
+    for (size_t k = 0; k < block_keys.size(); k++) {
+        m_block_row_offsets[block_keys[k] / m_num_vertices + 1]++;
+        m_block_cols[k] = int(block_keys[k] % m_num_vertices);
+    }
+    for (long vi = 0; vi < m_num_vertices; vi++) {
+        m_block_row_offsets[vi + 1] += m_block_row_offsets[vi];
+    }
+
+    // Per-constraint scatter slots into the block list.
+    std::vector<int> block_slots(16 * m_num_constraints, -1);
+    for (size_t i = 0; i < m_num_constraints; i++) {
+        for (int a = 0; a < 4; a++) {
+            const int via = vertex_ids[4 * i + a];
+            if (via < 0) {
+                continue;
+            }
+            for (int b = 0; b < 4; b++) {
+                const int vib = vertex_ids[4 * i + b];
+                if (vib < 0) {
+                    continue;
+                }
+                const long key = long(via) * m_num_vertices + vib;
+                block_slots[16 * i + 4 * a + b] = int(
+                    std::lower_bound(block_keys.begin(), block_keys.end(), key)
+                    - block_keys.begin());
+            }
+        }
+    }
+
+    d_vertex_ids = device_alloc<int>(vertex_ids.size());
+    d_gammas = device_alloc<double>(gammas.size());
+    d_coeffs = device_alloc<double>(coeffs.size());
+    d_bases = device_alloc<double>(bases.size());
+    d_block_slots = device_alloc<int>(block_slots.size());
+    device_upload(d_vertex_ids, vertex_ids);
+    device_upload(d_gammas, gammas);
+    device_upload(d_coeffs, coeffs);
+    device_upload(d_bases, bases);
+    device_upload(d_block_slots, block_slots);
+
+    d_displacements = device_alloc<double>(3 * m_num_vertices);
+    m_owns_displacements = true;
+    d_gradient = device_alloc<double>(3 * m_num_vertices);
+    d_hessian_values = device_alloc<double>(9 * m_block_cols.size());
+    d_potential = device_alloc<double>(1);
+}
+
+void FrictionPotentialGPU::update_displacements(ConstMatrixXdRef U)
+{
+    assert(U.rows() == m_num_vertices && U.cols() == 3);
+    if (!m_owns_displacements) {
+        d_displacements = device_alloc<double>(3 * m_num_vertices);
+        m_owns_displacements = true;
+    }
+    const Eigen::Matrix<double, Eigen::Dynamic, 3, Eigen::RowMajor> U_rm = U;
+    check_cuda(cudaMemcpy(
+        d_displacements, U_rm.data(), 3 * m_num_vertices * sizeof(double),
+        cudaMemcpyHostToDevice));
+}
+
+void FrictionPotentialGPU::use_device_displacements(
+    const double* d_U, const long num_vertices)
+{
+    assert(num_vertices == m_num_vertices);
+    if (m_owns_displacements) {
+        cudaFree(d_displacements);
+        m_owns_displacements = false;
+    }
+    d_displacements = const_cast<double*>(d_U);
+}
+
+double FrictionPotentialGPU::compute_potential(const double epsv_times_h)
+{
+    assert(epsv_times_h > 0);
+    if (m_num_constraints == 0) {
+        return 0;
+    }
+    check_cuda(cudaMemset(d_potential, 0, sizeof(double)));
+
+    potential_kernel<<<num_blocks(m_num_constraints), BLOCK_SIZE>>>(
+        m_num_constraints, d_displacements, d_vertex_ids, d_gammas, d_coeffs,
+        d_bases, epsv_times_h, d_potential);
+    check_cuda(cudaGetLastError());
+
+    double result;
+    check_cuda(cudaMemcpy(
+        &result, d_potential, sizeof(double), cudaMemcpyDeviceToHost));
+    return result;
+}
+
+void FrictionPotentialGPU::compute_gradient(const double epsv_times_h)
+{
+    assert(epsv_times_h > 0);
+    check_cuda(cudaMemset(d_gradient, 0, 3 * m_num_vertices * sizeof(double)));
+    if (m_num_constraints == 0) {
+        return;
+    }
+    gradient_kernel<<<num_blocks(m_num_constraints), BLOCK_SIZE>>>(
+        m_num_constraints, d_displacements, d_vertex_ids, d_gammas, d_coeffs,
+        d_bases, epsv_times_h, d_gradient);
+    check_cuda(cudaGetLastError());
+}
+
+Eigen::VectorXd FrictionPotentialGPU::gradient() const
+{
+    Eigen::VectorXd grad(3 * m_num_vertices);
+    check_cuda(cudaMemcpy(
+        grad.data(), d_gradient, 3 * m_num_vertices * sizeof(double),
+        cudaMemcpyDeviceToHost));
+    return grad;
+}
+
+void FrictionPotentialGPU::compute_hessian(
+    const double epsv_times_h, const bool project_hessian_to_psd)
+{
+    assert(epsv_times_h > 0);
+    check_cuda(cudaMemset(
+        d_hessian_values, 0, 9 * m_block_cols.size() * sizeof(double)));
+    if (m_num_constraints == 0) {
+        return;
+    }
+    hessian_kernel<<<num_blocks(m_num_constraints), BLOCK_SIZE>>>(
+        m_num_constraints, d_displacements, d_vertex_ids, d_gammas, d_coeffs,
+        d_bases, d_block_slots, epsv_times_h, project_hessian_to_psd,
+        d_hessian_values);
+    check_cuda(cudaGetLastError());
+}
+
+Eigen::SparseMatrix<double> FrictionPotentialGPU::hessian() const
+{
+    std::vector<double> values(9 * m_block_cols.size());
+    check_cuda(cudaMemcpy(
+        values.data(), d_hessian_values, values.size() * sizeof(double),
+        cudaMemcpyDeviceToHost));
+
+    std::vector<Eigen::Triplet<double>> triplets;
+    triplets.reserve(values.size());
+    for (long vi = 0; vi < m_num_vertices; vi++) {
+        for (int k = m_block_row_offsets[vi]; k < m_block_row_offsets[vi + 1];
+             k++) {
+            const int vj = m_block_cols[k];
+            for (int r = 0; r < 3; r++) {
+                for (int c = 0; c < 3; c++) {
+                    triplets.emplace_back(
+                        3 * vi + r, 3 * vj + c, values[9 * k + 3 * r + c]);
+                }
+            }
+        }
+    }
+    Eigen::SparseMatrix<double> hess(3 * m_num_vertices, 3 * m_num_vertices);
+    hess.setFromTriplets(triplets.begin(), triplets.end());
+    return hess;
+}
+
+} // namespace ipc
+
+#endif
@@ -0,0 +1,151 @@
+#pragma once
+
+#include <ipc/config.hpp>
+
+#ifdef IPC_TOOLKIT_WITH_CUDA
+
+#include <ipc/collision_mesh.hpp>
+#include <ipc/friction/friction_constraint.hpp>
+#include <ipc/utils/eigen_ext.hpp>
+
+#include <Eigen/Sparse>
+
+#include <vector>
+
+namespace ipc {
+
+/// @brief Device-resident friction potential, gradient, and hessian.
+///
+/// Friction evaluation is per-constraint independent arithmetic on small
+/// dense blocks, and because the tangent bases, closest points, and normal
+/// force magnitudes are lagged, each constraint reduces to four signed
+/// relative-displacement weights, a 3x2 tangent basis, and one coefficient
+/// (weight · mu · N) that are all constant across the iterations of a lagged
+/// solve. This class uploads those once per friction set
+/// (set_constraints()), takes the displacements per iteration
+/// (update_displacements()), and evaluates the potential as a reduced
+/// scalar, the gradient into a device vector, and the hessian into device
+/// block-sparse-row (BSR) 3x3 blocks whose sparsity is precomputed on the
+/// host when the set changes, so the results can feed a device linear
+/// solver without a per-iteration host round trip.
+///
+/// All three evaluations match the CPU compute_friction_potential_* entry
+/// points exactly (including the PSD projection of the inner 2x2 hessian),
+/// because the lagged terms they share are bitwise the uploaded ones.
+///
+/// @note 3D meshes only (mirrors BarrierPotentialGPU).
+class FrictionPotentialGPU {
+public:
+    FrictionPotentialGPU() { }
+    ~FrictionPotentialGPU();
+
+    // Owns device memory.
+    FrictionPotentialGPU(const FrictionPotentialGPU&) = delete;
+    FrictionPotentialGPU& operator=(const FrictionPotentialGPU&) = delete;
+
+    /// @brief Upload the friction set and build the hessian sparsity.
+    ///
+    /// Call when the friction constraint set is (re)built (typically once
+    /// per lagged iteration); the relative-displacement weights, tangent
+    /// bases, coefficients, and the BSR pattern stay resident across the
+    /// iterations of the solve.
+    /// @param mesh The collision mesh.
+    /// @param friction_constraint_set The friction constraint set to upload.
+    void set_constraints(
+        const CollisionMesh& mesh,
+        const FrictionConstraints& friction_constraint_set);
+
+    /// @brief Upload new displacements U = V1 - V0 (call once per iteration).
+    /// @param U Displacements of the collision mesh vertices.
+    void update_displacements(ConstMatrixXdRef U);
+
+    /// @brief Convenience overload computing U = V1 - V0 on the host.
+    void update_vertices(ConstMatrixXdRef V0, ConstMatrixXdRef V1)
+    {
+        update_displacements(V1 - V0);
+    }
+
+    /// @brief Displacements already resident on the device (row-major |V|x3).
+    ///
+    /// Alternative to update_displacements() for solvers that keep the
+    /// positions on the GPU: the buffer is used in place and must stay valid
+    /// until the next update_displacements()/use_device_displacements()
+    /// call.
+    void use_device_displacements(const double* d_U, const long num_vertices);
+
+    /// @brief Compute the friction potential on the device.
+    /// @param epsv_times_h Tolerance for the transition between static and
+    /// dynamic friction.
+    /// @return The sum of the potential over all constraints.
+    double compute_potential(const double epsv_times_h);
+
+    /// @brief Compute the gradient into the device buffer.
+    /// @see device_gradient(), gradient()
+    void compute_gradient(const double epsv_times_h);
+
+    /// @brief Device gradient of the last compute_gradient() (size 3|V|).
+    const double* device_gradient() const { return d_gradient; }
+
+    /// @brief Download the gradient of the last compute_gradient().
+    Eigen::VectorXd gradient() const;
+
+    /// @brief Compute the hessian blocks into the device buffer.
+    /// @see device_hessian_values(), hessian()
+    void compute_hessian(
+        const double epsv_times_h, const bool project_hessian_to_psd = true);
+
+    /// @brief BSR row offsets of the hessian (size num_vertices + 1).
+    const std::vector<int>& hessian_block_row_offsets() const
+    {
+        return m_block_row_offsets;
+    }
+
+    /// @brief BSR block column indices of the hessian.
+    const std::vector<int>& hessian_block_cols() const
+    {
+        return m_block_cols;
+    }
+
+    /// @brief Device hessian of the last compute_hessian() (one row-major
+    /// 3x3 block of 9 doubles per entry of hessian_block_cols()).
+    const double* device_hessian_values() const { return d_hessian_values; }
+
+    /// @brief Download the hessian of the last compute_hessian().
+    Eigen::SparseMatrix<double> hessian() const;
+
+    /// @brief Number of uploaded constraints.
+    size_t num_constraints() const { return m_num_constraints; }
+
+    /// @brief Number of 3x3 blocks in the hessian pattern.
+    size_t num_hessian_blocks() const { return m_block_cols.size(); }
+
+    /// @brief Free all device memory.
+    void clear();
+
+protected:
+    size_t m_num_constraints = 0;
+    long m_num_vertices = 0;
+
+    // Host copy of the BSR pattern (also uploaded for the scatter slots).
+    std::vector<int> m_block_row_offsets;
+    std::vector<int> m_block_cols;
+
+    // Device-resident friction set (see set_constraints()).
+    int* d_vertex_ids = nullptr; ///< @brief 4 vertex ids per constraint.
+    double* d_gammas = nullptr; ///< @brief 4 signed weights per constraint.
+    double* d_coeffs = nullptr; ///< @brief weight · mu · N per constraint.
+    double* d_bases = nullptr; ///< @brief Row-major 3x2 basis per constraint.
+    int* d_block_slots = nullptr; ///< @brief 16 hessian slots per constraint.
+
+    // Displacements and outputs.
+    double* d_displacements = nullptr; ///< @brief Row-major |V|x3.
+    bool m_owns_displacements = false; ///< @brief False after
+                                       ///< use_device_displacements.
+    double* d_gradient = nullptr; ///< @brief Gradient (size 3|V|).
+    double* d_hessian_values = nullptr; ///< @brief 9 doubles per block.
+    double* d_potential = nullptr; ///< @brief Reduced potential.
+};
+
+} // namespace ipc
+
+#endif
@@ -34,4 +34,33 @@ VectorMax12d compute_normal_force_magnitude_gradient(
         * distance_squared_gradient;
 }
 
+Eigen::ArrayXd compute_normal_force_magnitude(
+    const Eigen::ArrayXd& distances_squared,
+    double dhat,
+    double barrier_stiffness,
+    double dmin)
+{
+    const Eigen::ArrayXd grad_b = barrier_gradient(
+        distances_squared - dmin * dmin, 2 * dmin * dhat + dhat * dhat);
+    return -barrier_stiffness * 2 * grad_b * distances_squared.sqrt();
+}
+
+Eigen::ArrayXd compute_normal_force_magnitude_gradient_coeffs(
+    const Eigen::ArrayXd& distances_squared,
+    double dhat,
+    double barrier_stiffness,
+    double dmin)
+{
+    const Eigen::ArrayXd args_d = distances_squared - dmin * dmin;
+    const double arg_dhat = 2 * dmin * dhat + dhat * dhat;
+    const Eigen::ArrayXd distances = distances_squared.sqrt();
+    assert((distances > 0).all());
+
+    // See compute_normal_force_magnitude_gradient:
+    // ∇ₓ -κ b'(d²(x)) 2 d(x) = -κ (b"(d²(x)) 2 d(x) + b'(d²(x))/d(x)) ∇ₓd²(x)
+    return -barrier_stiffness
+        * (barrier_hessian(args_d, arg_dhat) * 2 * distances
+           + barrier_gradient(args_d, arg_dhat) / distances);
+}
+
 } // namespace ipc
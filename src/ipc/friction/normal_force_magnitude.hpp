@@ -17,4 +17,37 @@ VectorMax12d compute_normal_force_magnitude_gradient(
     double barrier_stiffness,
     double dmin = 0);
 
+/// @brief Batched version of compute_normal_force_magnitude.
+///
+/// Evaluating the whole friction set's distances in one sweep shares the
+/// batched barrier kernels (see barrier.hpp) instead of a scalar log per
+/// constraint. All constraints must share the same minimum distance.
+/// @param distances_squared The squared distances of the constraints.
+/// @param dhat Barrier activation distance.
+/// @param barrier_stiffness Stiffness of the barrier.
+/// @param dmin Minimum distance offset shared by the constraints.
+/// @return The normal force magnitude of each constraint.
+Eigen::ArrayXd compute_normal_force_magnitude(
+    const Eigen::ArrayXd& distances_squared,
+    double dhat,
+    double barrier_stiffness,
+    double dmin = 0);
+
+/// @brief Batched scalar coefficients of the normal force magnitude gradient.
+///
+/// The gradient of constraint i's normal force magnitude is
+/// coeffs[i] · ∇ₓd²ᵢ(x), so the force jacobian path only needs one batched
+/// sweep for the barrier derivatives and a per-constraint scale of the
+/// distance gradients.
+/// @param distances_squared The squared distances of the constraints.
+/// @param dhat Barrier activation distance.
+/// @param barrier_stiffness Stiffness of the barrier.
+/// @param dmin Minimum distance offset shared by the constraints.
+/// @return The scalar gradient coefficient of each constraint.
+Eigen::ArrayXd compute_normal_force_magnitude_gradient_coeffs(
+    const Eigen::ArrayXd& distances_squared,
+    double dhat,
+    double barrier_stiffness,
+    double dmin = 0);
+
 } // namespace ipc
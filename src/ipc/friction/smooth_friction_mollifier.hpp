@@ -1,5 +1,7 @@
 #pragma once
 
+#include <Eigen/Core>
+
 namespace ipc {
 
 // C1 clamping
@@ -13,6 +15,22 @@ inline T f1_SF_over_x(const T& x, const double epsv_times_h);
 template <typename T>
 inline T df1_x_minus_f1_over_x3(const T& x, const double epsv_times_h);
 
+/// @brief Batched f0_SF evaluated for every entry of x at once.
+///
+/// Written branch-free so the whole array is processed with Eigen's packet
+/// math (vectorized under IPC_TOOLKIT_WITH_SIMD).
+inline Eigen::ArrayXd
+f0_SF(const Eigen::ArrayXd& x, const double epsv_times_h);
+
+/// @brief Batched f1_SF_over_x evaluated for every entry of x at once.
+inline Eigen::ArrayXd
+f1_SF_over_x(const Eigen::ArrayXd& x, const double epsv_times_h);
+
+/// @brief Batched df1_x_minus_f1_over_x3 evaluated for every entry of x at
+/// once.
+inline Eigen::ArrayXd
+df1_x_minus_f1_over_x3(const Eigen::ArrayXd& x, const double epsv_times_h);
+
 } // namespace ipc
 
 #include "smooth_friction_mollifier.tpp"
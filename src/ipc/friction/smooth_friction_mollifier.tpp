@@ -34,4 +34,34 @@ inline T df1_x_minus_f1_over_x3(const T& x, const double epsv_times_h)
     return -1 / (x * epsv_times_h * epsv_times_h);
 }
 
+inline Eigen::ArrayXd f0_SF(const Eigen::ArrayXd& x, const double epsv_times_h)
+{
+    assert(epsv_times_h > 0);
+    // Both branches are evaluated for the whole array; select() keeps the
+    // per-entry result the scalar version would have produced.
+    return (x.abs() >= epsv_times_h)
+        .select(
+            x,
+            x.square() * (-x / (3 * epsv_times_h) + 1) / epsv_times_h
+                + epsv_times_h / 3);
+}
+
+inline Eigen::ArrayXd
+f1_SF_over_x(const Eigen::ArrayXd& x, const double epsv_times_h)
+{
+    assert(epsv_times_h > 0);
+    return (x.abs() >= epsv_times_h)
+        .select(x.inverse(), (-x / epsv_times_h + 2) / epsv_times_h);
+}
+
+inline Eigen::ArrayXd
+df1_x_minus_f1_over_x3(const Eigen::ArrayXd& x, const double epsv_times_h)
+{
+    assert(epsv_times_h > 0);
+    return (x.abs() >= epsv_times_h)
+        .select(
+            -x.cube().inverse(),
+            -(x * epsv_times_h * epsv_times_h).inverse());
+}
+
 } // namespace ipc
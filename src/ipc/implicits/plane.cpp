@@ -9,8 +9,19 @@
 
 namespace ipc {
 
+void PlaneSet::update(
+    const Eigen::MatrixXd& plane_origins, const Eigen::MatrixXd& plane_normals)
+{
+    assert(plane_origins.rows() == plane_normals.rows());
+    assert(plane_origins.cols() == plane_normals.cols());
+    origins = plane_origins;
+    normals = plane_normals;
+    offsets = (origins.array() * normals.array()).rowwise().sum();
+    normal_sqr_norms = normals.rowwise().squaredNorm();
+}
+
 void construct_point_plane_constraint_set(
-    const Eigen::MatrixXd& V,
+    ConstMatrixXdRef V,
     const Eigen::MatrixXd& plane_origins,
     const Eigen::MatrixXd& plane_normals,
     const double dhat,
@@ -49,11 +60,63 @@ void construct_point_plane_constraint_set(
     }
 }
 
+void construct_point_plane_constraint_set(
+    ConstMatrixXdRef V,
+    const PlaneSet& planes,
+    const double dhat,
+    std::vector<PlaneVertexConstraint>& pv_constraints,
+    const double dmin,
+    const std::function<bool(size_t, size_t)>& can_collide)
+{
+    pv_constraints.clear();
+
+    const size_t n_planes = planes.size();
+
+    // distance_sqr - dmin² < 2·dmin·dhat + dhat²
+    //     ⟺ distance_sqr < (dhat + dmin)²
+    const double activation_sqr = (dhat + dmin) * (dhat + dmin);
+
+    // Bin the points against each plane's activation slab: the signed
+    // projections of every point onto one plane are a single matrix-vector
+    // product, and the per-plane hit lists are independent so the planes are
+    // processed in parallel.
+    std::vector<std::vector<long>> hits(n_planes);
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(0, n_planes),
+        [&](const tbb::blocked_range<size_t>& r) {
+            for (size_t pi = r.begin(); pi < r.end(); pi++) {
+                const Eigen::ArrayXd signed_dists =
+                    (V * planes.normals.row(pi).transpose()).array()
+                    - planes.offsets[pi];
+                // The distance kernel divides by ‖n‖², so scale the slab
+                // width instead of normalizing every projection.
+                const double slab_sqr =
+                    activation_sqr * planes.normal_sqr_norms[pi];
+                for (long vi = 0; vi < V.rows(); vi++) {
+                    if (signed_dists[vi] * signed_dists[vi] < slab_sqr
+                        && can_collide(vi, pi)) {
+                        hits[pi].push_back(vi);
+                    }
+                }
+            }
+        });
+
+    // Emit the constraints grouped by plane (deterministic regardless of the
+    // parallel schedule).
+    for (size_t pi = 0; pi < n_planes; pi++) {
+        for (const long vi : hits[pi]) {
+            pv_constraints.emplace_back(
+                planes.origins.row(pi), planes.normals.row(pi), vi);
+            pv_constraints.back().minimum_distance = dmin;
+        }
+    }
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 bool is_step_point_plane_collision_free(
-    const Eigen::MatrixXd& V0,
-    const Eigen::MatrixXd& V1,
+    ConstMatrixXdRef V0,
+    ConstMatrixXdRef V1,
     const Eigen::MatrixXd& plane_origins,
     const Eigen::MatrixXd& plane_normals,
     const std::function<bool(size_t, size_t)>& can_collide)
@@ -87,8 +150,8 @@ bool is_step_point_plane_collision_free(
 ///////////////////////////////////////////////////////////////////////////////
 
 double compute_point_plane_collision_free_stepsize(
-    const Eigen::MatrixXd& V0,
-    const Eigen::MatrixXd& V1,
+    ConstMatrixXdRef V0,
+    ConstMatrixXdRef V1,
     const Eigen::MatrixXd& plane_origins,
     const Eigen::MatrixXd& plane_normals,
     const std::function<bool(size_t, size_t)>& can_collide)
@@ -99,30 +162,38 @@ double compute_point_plane_collision_free_stepsize(
 
     tbb::enumerable_thread_specific<double> storage(1);
 
+    // One batched CCD call per plane: the closed-form solve over all of a
+    // plane's vertices is a pair of matrix-vector products, so the per-plane
+    // grain amortizes far better than per vertex-plane pair.
     tbb::parallel_for(
-        tbb::blocked_range<size_t>(0, V0.rows()),
+        tbb::blocked_range<size_t>(0, n_planes),
         [&](tbb::blocked_range<size_t> r) {
             double& earliest_toi = storage.local();
 
-            for (size_t vi = r.begin(); vi < r.end(); vi++) {
-                for (size_t pi = 0; pi < n_planes; pi++) {
-                    if (!can_collide(vi, pi)) {
-                        continue;
+            Eigen::MatrixXd P0, P1;
+            for (size_t pi = r.begin(); pi < r.end(); pi++) {
+                // Gather the vertices allowed to collide with this plane.
+                long n_points = 0;
+                P0.resize(V0.rows(), V0.cols());
+                P1.resize(V1.rows(), V1.cols());
+                for (long vi = 0; vi < V0.rows(); vi++) {
+                    if (can_collide(vi, pi)) {
+                        P0.row(n_points) = V0.row(vi);
+                        P1.row(n_points) = V1.row(vi);
+                        n_points++;
                     }
+                }
+                if (n_points == 0) {
+                    continue;
+                }
 
-                    const auto& plane_origin = plane_origins.row(pi);
-                    const auto& plane_normal = plane_normals.row(pi);
-
-                    double toi;
-                    bool are_colliding = point_static_plane_ccd(
-                        V0.row(vi), V1.row(vi), plane_origin, plane_normal,
-                        toi);
+                double toi;
+                bool are_colliding = point_static_plane_ccd(
+                    P0.topRows(n_points), P1.topRows(n_points),
+                    plane_origins.row(pi), plane_normals.row(pi), toi);
 
-                    if (are_colliding) {
-                        if (toi < earliest_toi) {
-                            earliest_toi = toi;
-                        }
-                    }
+                if (are_colliding && toi < earliest_toi) {
+                    earliest_toi = toi;
                 }
             }
         });
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <ipc/collisions/plane_vertex.hpp>
+#include <ipc/utils/eigen_ext.hpp>
 
 #include <Eigen/Core>
 
@@ -8,6 +9,43 @@
 
 namespace ipc {
 
+/// @brief Precomputed structure-of-arrays set of implicit planes.
+///
+/// Stores the plane origins and normals contiguously together with the
+/// per-plane offsets (n⋅o) and squared normal lengths, so the signed
+/// projections of all points onto one plane reduce to a single
+/// matrix-vector product. Call update() when the planes move to reuse the
+/// storage.
+struct PlaneSet {
+    PlaneSet() { }
+
+    PlaneSet(
+        const Eigen::MatrixXd& plane_origins,
+        const Eigen::MatrixXd& plane_normals)
+    {
+        update(plane_origins, plane_normals);
+    }
+
+    /// @brief Set (or reset) the planes, reusing the allocated storage.
+    /// @param[in] plane_origins  Plane origins as rows of a matrix.
+    /// @param[in] plane_normals  Plane normals as rows of a matrix.
+    void update(
+        const Eigen::MatrixXd& plane_origins,
+        const Eigen::MatrixXd& plane_normals);
+
+    /// @brief Get the number of planes in the set.
+    size_t size() const { return origins.rows(); }
+
+    /// @brief Plane origins as rows of a matrix.
+    Eigen::MatrixXd origins;
+    /// @brief Plane normals (not necessarily unit) as rows of a matrix.
+    Eigen::MatrixXd normals;
+    /// @brief Per-plane offsets n⋅o.
+    Eigen::VectorXd offsets;
+    /// @brief Per-plane squared normal lengths ‖n‖².
+    Eigen::VectorXd normal_sqr_norms;
+};
+
 /// @brief Construct a set of point-plane distance constraints used to compute
 /// the barrier potential.
 ///
@@ -24,7 +62,7 @@ namespace ipc {
 ///     number in plane_origins) then returns true if the vertex can collide
 ///     with the plane. By default all points can collide with all planes.
 void construct_point_plane_constraint_set(
-    const Eigen::MatrixXd& V,
+    ConstMatrixXdRef V,
     const Eigen::MatrixXd& plane_origins,
     const Eigen::MatrixXd& plane_normals,
     const double dhat,
@@ -33,6 +71,34 @@ void construct_point_plane_constraint_set(
     const std::function<bool(size_t, size_t)>& can_collide =
         [](size_t, size_t) { return true; });
 
+/// @brief Construct a set of point-plane distance constraints from a
+/// precomputed plane set.
+///
+/// Bins the points against each plane's activation slab using one
+/// matrix-vector product per plane and processes the planes in parallel, so
+/// scenes with many half-space obstacles avoid the serial point × plane
+/// loop. The constraints are emitted grouped by plane.
+///
+/// @note The given pv_constraints will be cleared.
+///
+/// @param[in]  V  Vertex positions as rows of a matrix.
+/// @param[in]  planes  The precomputed set of planes.
+/// @param[in]  dhat  The activation distance of the barrier.
+/// @param[out] pv_constraints  The constructed set of constraints.
+/// @param[in]  dmin  Minimum distance.
+/// @param[in] can_collide
+///     A function that takes a vertex ID (row numbers in V) and a plane ID (row
+///     number in planes) then returns true if the vertex can collide with the
+///     plane. By default all points can collide with all planes.
+void construct_point_plane_constraint_set(
+    ConstMatrixXdRef V,
+    const PlaneSet& planes,
+    const double dhat,
+    std::vector<PlaneVertexConstraint>& pv_constraints,
+    const double dmin = 0,
+    const std::function<bool(size_t, size_t)>& can_collide =
+        [](size_t, size_t) { return true; });
+
 ///////////////////////////////////////////////////////////////////////////////
 // Collision detection
 
@@ -50,8 +116,8 @@ void construct_point_plane_constraint_set(
 ///     with the plane. By default all points can collide with all planes.
 /// @returns True if <b>any</b> collisions occur.
 bool is_step_point_plane_collision_free(
-    const Eigen::MatrixXd& V0,
-    const Eigen::MatrixXd& V1,
+    ConstMatrixXdRef V0,
+    ConstMatrixXdRef V1,
     const Eigen::MatrixXd& plane_origins,
     const Eigen::MatrixXd& plane_normals,
     const std::function<bool(size_t, size_t)>& can_collide =
@@ -73,8 +139,8 @@ bool is_step_point_plane_collision_free(
 ///     with the plane. By default all points can collide with all planes.
 /// @returns A step-size \f$\in [0, 1]\f$ that is collision free.
 double compute_point_plane_collision_free_stepsize(
-    const Eigen::MatrixXd& V0,
-    const Eigen::MatrixXd& V1,
+    ConstMatrixXdRef V0,
+    ConstMatrixXdRef V1,
     const Eigen::MatrixXd& plane_origins,
     const Eigen::MatrixXd& plane_normals,
     const std::function<bool(size_t, size_t)>& can_collide =
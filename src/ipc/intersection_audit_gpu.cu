@@ -0,0 +1,328 @@
+#include "intersection_audit_gpu.hpp"
+
+#ifdef IPC_TOOLKIT_WITH_CUDA
+
+#include <ipc/utils/intersection.hpp>
+
+#include <cuda_runtime.h>
+
+#include <stdexcept>
+
+namespace ipc {
+
+namespace {
+
+    constexpr int BLOCK_SIZE = 256;
+
+    // Per-candidate verdicts of the filtered device test.
+    constexpr unsigned char SEPARATE = 0;
+    constexpr unsigned char INTERSECTING = 1;
+    constexpr unsigned char UNCERTAIN = 2;
+
+    inline int num_blocks(size_t n)
+    {
+        return int((n + BLOCK_SIZE - 1) / BLOCK_SIZE);
+    }
+
+    inline void check_cuda(cudaError_t status)
+    {
+        if (status != cudaSuccess) {
+            throw std::runtime_error(
+                std::string("IntersectionAuditGPU CUDA error: ")
+                + cudaGetErrorString(status));
+        }
+    }
+
+    // ---------------------------------------------------------------------
+    // double3 helpers
+
+    __device__ inline double3 load_point(const double* V, const int vi)
+    {
+        return make_double3(V[3 * vi + 0], V[3 * vi + 1], V[3 * vi + 2]);
+    }
+
+    __device__ inline double3 sub(const double3& a, const double3& b)
+    {
+        return make_double3(a.x - b.x, a.y - b.y, a.z - b.z);
+    }
+
+    // ---------------------------------------------------------------------
+    // Filtered orientation predicate
+
+    /// Sign of det[b-a; c-a; d-a] with a conservative forward-error filter:
+    /// returns 0 when the determinant's magnitude is below the rounding
+    /// error bound of its floating-point evaluation, so a nonzero result is
+    /// certified. (The bound 2^-48 on the permanent of the absolute terms is
+    /// loose compared to the classical Shewchuk constant, erring towards
+    /// UNCERTAIN.)
+    __device__ inline int orient3d_filtered(
+        const double3& a, const double3& b, const double3& c, const double3& d)
+    {
+        const double3 u = sub(b, a);
+        const double3 v = sub(c, a);
+        const double3 w = sub(d, a);
+
+        const double det = u.x * (v.y * w.z - v.z * w.y)
+            - u.y * (v.x * w.z - v.z * w.x) + u.z * (v.x * w.y - v.y * w.x);
+
+        const double perm =
+            fabs(u.x) * (fabs(v.y * w.z) + fabs(v.z * w.y))
+            + fabs(u.y) * (fabs(v.x * w.z) + fabs(v.z * w.x))
+            + fabs(u.z) * (fabs(v.x * w.y) + fabs(v.y * w.x));
+
+        const double eps = 3.6e-15; // ~16u with u = 2^-53
+
+        if (fabs(det) <= eps * perm) {
+            return 0;
+        }
+        return det > 0 ? 1 : -1;
+    }
+
+    /// Filtered segment (p, q) vs. triangle (a, b, c) test via the five
+    /// orientation signs; any uncertified sign makes the verdict UNCERTAIN.
+    __device__ inline unsigned char segment_triangle_verdict(
+        const double3& p,
+        const double3& q,
+        const double3& a,
+        const double3& b,
+        const double3& c)
+    {
+        const int sp = orient3d_filtered(p, a, b, c);
+        const int sq = orient3d_filtered(q, a, b, c);
+
+        if (sp != 0 && sp == sq) {
+            return SEPARATE; // both endpoints strictly on one side
+        }
+        if (sp == 0 || sq == 0) {
+            return UNCERTAIN; // endpoint on (or near) the support plane
+        }
+
+        const int s0 = orient3d_filtered(p, q, a, b);
+        const int s1 = orient3d_filtered(p, q, b, c);
+        const int s2 = orient3d_filtered(p, q, c, a);
+        if (s0 == 0 || s1 == 0 || s2 == 0) {
+            return UNCERTAIN; // segment through (or near) a triangle edge
+        }
+        return (s0 == s1 && s1 == s2) ? INTERSECTING : SEPARATE;
+    }
+
+    __global__ void audit_kernel(
+        const double* V,
+        const int* E,
+        const int* F,
+        const int* candidate_ids,
+        const int num_candidates,
+        unsigned char* verdicts)
+    {
+        const int i = blockIdx.x * blockDim.x + threadIdx.x;
+        if (i >= num_candidates) {
+            return;
+        }
+
+        const int ei = candidate_ids[2 * i + 0];
+        const int fi = candidate_ids[2 * i + 1];
+
+        verdicts[i] = segment_triangle_verdict(
+            load_point(V, E[2 * ei + 0]), load_point(V, E[2 * ei + 1]),
+            load_point(V, F[3 * fi + 0]), load_point(V, F[3 * fi + 1]),
+            load_point(V, F[3 * fi + 2]));
+    }
+
+} // namespace
+
+IntersectionAuditGPU::~IntersectionAuditGPU() { clear(); }
+
+void IntersectionAuditGPU::reserve_device(
+    void** d_ptr, size_t& capacity, const size_t count)
+{
+    if (count <= capacity) {
+        return;
+    }
+    if (*d_ptr != nullptr) {
+        cudaFree(*d_ptr);
+        *d_ptr = nullptr;
+    }
+    check_cuda(cudaMalloc(d_ptr, count));
+    capacity = count;
+}
+
+void IntersectionAuditGPU::begin_audit(
+    const CollisionMesh& mesh,
+    ConstMatrixXdRef V,
+    const std::vector<EdgeFaceCandidate>& candidates)
+{
+    if (m_running) {
+        throw std::runtime_error(
+            "IntersectionAuditGPU: begin_audit() called while an audit "
+            "is in flight; call result() first.");
+    }
+    if (V.cols() != 3) {
+        throw std::runtime_error(
+            "IntersectionAuditGPU only supports 3D meshes!");
+    }
+    assert(V.rows() == mesh.num_vertices());
+
+    const Eigen::MatrixXi& E = mesh.edges();
+    const Eigen::MatrixXi& F = mesh.faces();
+    m_num_candidates = candidates.size();
+
+    // Flatten into the member buffers: they must outlive the async uploads
+    // (and the exact fallback in result() reads them back).
+    m_positions.resize(3 * V.rows());
+    for (long vi = 0; vi < V.rows(); vi++) {
+        m_positions[3 * vi + 0] = V(vi, 0);
+        m_positions[3 * vi + 1] = V(vi, 1);
+        m_positions[3 * vi + 2] = V(vi, 2);
+    }
+    m_edges.resize(2 * E.rows());
+    for (long ei = 0; ei < E.rows(); ei++) {
+        m_edges[2 * ei + 0] = E(ei, 0);
+        m_edges[2 * ei + 1] = E(ei, 1);
+    }
+    m_faces.resize(3 * F.rows());
+    for (long fi = 0; fi < F.rows(); fi++) {
+        m_faces[3 * fi + 0] = F(fi, 0);
+        m_faces[3 * fi + 1] = F(fi, 1);
+        m_faces[3 * fi + 2] = F(fi, 2);
+    }
+    m_candidate_ids.resize(2 * m_num_candidates);
+    for (size_t i = 0; i < m_num_candidates; i++) {
+        m_candidate_ids[2 * i + 0] = int(candidates[i].edge_index);
+        m_candidate_ids[2 * i + 1] = int(candidates[i].face_index);
+    }
+
+    m_running = true; // the kernel launch below may be skipped, not result()
+    if (m_num_candidates == 0) {
+        m_verdicts.clear();
+        return;
+    }
+
+    if (m_stream == nullptr) {
+        cudaStream_t stream;
+        check_cuda(cudaStreamCreate(&stream));
+        m_stream = stream;
+    }
+    const cudaStream_t stream = static_cast<cudaStream_t>(m_stream);
+
+    reserve_device(
+        (void**)&d_positions, m_positions_capacity,
+        m_positions.size() * sizeof(double));
+    reserve_device(
+        (void**)&d_edges, m_edges_capacity, m_edges.size() * sizeof(int));
+    reserve_device(
+        (void**)&d_faces, m_faces_capacity, m_faces.size() * sizeof(int));
+    reserve_device(
+        (void**)&d_candidate_ids, m_candidates_capacity,
+        m_candidate_ids.size() * sizeof(int));
+    reserve_device(
+        (void**)&d_verdicts, m_verdicts_capacity,
+        m_num_candidates * sizeof(unsigned char));
+
+    check_cuda(cudaMemcpyAsync(
+        d_positions, m_positions.data(), m_positions.size() * sizeof(double),
+        cudaMemcpyHostToDevice, stream));
+    check_cuda(cudaMemcpyAsync(
+        d_edges, m_edges.data(), m_edges.size() * sizeof(int),
+        cudaMemcpyHostToDevice, stream));
+    check_cuda(cudaMemcpyAsync(
+        d_faces, m_faces.data(), m_faces.size() * sizeof(int),
+        cudaMemcpyHostToDevice, stream));
+    check_cuda(cudaMemcpyAsync(
+        d_candidate_ids, m_candidate_ids.data(),
+        m_candidate_ids.size() * sizeof(int), cudaMemcpyHostToDevice, stream));
+
+    audit_kernel<<<num_blocks(m_num_candidates), BLOCK_SIZE, 0, stream>>>(
+        d_positions, d_edges, d_faces, d_candidate_ids, int(m_num_candidates),
+        d_verdicts);
+    check_cuda(cudaGetLastError());
+
+    m_verdicts.resize(m_num_candidates);
+    check_cuda(cudaMemcpyAsync(
+        m_verdicts.data(), d_verdicts,
+        m_num_candidates * sizeof(unsigned char), cudaMemcpyDeviceToHost,
+        stream));
+}
+
+void IntersectionAuditGPU::begin_audit(
+    BroadPhase& broad_phase, const CollisionMesh& mesh, ConstMatrixXdRef V)
+{
+    std::vector<EdgeFaceCandidate> candidates;
+    broad_phase.detect_edge_face_candidates(candidates);
+    begin_audit(mesh, V, candidates);
+}
+
+bool IntersectionAuditGPU::result()
+{
+    if (!m_running) {
+        throw std::runtime_error(
+            "IntersectionAuditGPU: result() called without begin_audit()!");
+    }
+    m_running = false;
+
+    if (m_num_candidates == 0) {
+        return false;
+    }
+
+    check_cuda(cudaStreamSynchronize(static_cast<cudaStream_t>(m_stream)));
+
+    bool any_uncertain = false;
+    for (const unsigned char verdict : m_verdicts) {
+        if (verdict == INTERSECTING) {
+            return true;
+        }
+        any_uncertain |= verdict == UNCERTAIN;
+    }
+    if (!any_uncertain) {
+        return false;
+    }
+
+    // Resolve the uncertified candidates with the exact CPU predicate.
+    const auto point = [&](const int vi) {
+        return Eigen::Vector3d(
+            m_positions[3 * vi + 0], m_positions[3 * vi + 1],
+            m_positions[3 * vi + 2]);
+    };
+    for (size_t i = 0; i < m_num_candidates; i++) {
+        if (m_verdicts[i] != UNCERTAIN) {
+            continue;
+        }
+        const int ei = m_candidate_ids[2 * i + 0];
+        const int fi = m_candidate_ids[2 * i + 1];
+        if (is_edge_intersecting_triangle(
+                point(m_edges[2 * ei + 0]), point(m_edges[2 * ei + 1]),
+                point(m_faces[3 * fi + 0]), point(m_faces[3 * fi + 1]),
+                point(m_faces[3 * fi + 2]))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void IntersectionAuditGPU::clear()
+{
+    if (m_running) {
+        cudaStreamSynchronize(static_cast<cudaStream_t>(m_stream));
+        m_running = false;
+    }
+    if (m_stream != nullptr) {
+        cudaStreamDestroy(static_cast<cudaStream_t>(m_stream));
+        m_stream = nullptr;
+    }
+    const auto free_buffer = [](auto*& d_ptr, size_t& capacity) {
+        if (d_ptr != nullptr) {
+            cudaFree(d_ptr);
+            d_ptr = nullptr;
+        }
+        capacity = 0;
+    };
+    free_buffer(d_positions, m_positions_capacity);
+    free_buffer(d_edges, m_edges_capacity);
+    free_buffer(d_faces, m_faces_capacity);
+    free_buffer(d_candidate_ids, m_candidates_capacity);
+    free_buffer(d_verdicts, m_verdicts_capacity);
+    m_num_candidates = 0;
+}
+
+} // namespace ipc
+
+#endif
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <ipc/config.hpp>
+
+#ifdef IPC_TOOLKIT_WITH_CUDA
+
+#include <ipc/collision_mesh.hpp>
+#include <ipc/broad_phase/broad_phase.hpp>
+#include <ipc/utils/eigen_ext.hpp>
+
+#include <vector>
+
+namespace ipc {
+
+/// @brief Asynchronous device-side intersection audit.
+///
+/// The post-step has_intersections() audit runs one exact segment-triangle
+/// test per edge-face candidate on the CPU, which on big meshes takes longer
+/// than the step it is auditing. The candidates are independent, so this
+/// class runs them on the GPU instead, and it does so on its own stream:
+/// begin_audit() uploads the positions and candidates and returns
+/// immediately, so the host can overlap the audit with the next step's setup
+/// and only block in result().
+///
+/// The device test is a filtered form of the exact predicate: each
+/// orientation determinant carries a conservative error bound, and
+/// candidates whose signs cannot be certified (near-degenerate or coplanar
+/// configurations) are re-tested in result() with the exact CPU
+/// is_edge_intersecting_triangle(), so the verdict matches the CPU audit.
+///
+/// @note 3D meshes only; use the CPU has_intersections() in 2D.
+class IntersectionAuditGPU {
+public:
+    IntersectionAuditGPU() { }
+    ~IntersectionAuditGPU();
+
+    // Owns device memory and a stream.
+    IntersectionAuditGPU(const IntersectionAuditGPU&) = delete;
+    IntersectionAuditGPU& operator=(const IntersectionAuditGPU&) = delete;
+
+    /// @brief Start the audit of the given edge-face candidates.
+    ///
+    /// Uploads the positions, topology, and candidates and launches the
+    /// filtered tests asynchronously; the inputs are copied, so the caller
+    /// may overwrite its matrices as soon as this returns.
+    /// @warning The object must not be reused or destroyed until result()
+    /// has been called.
+    /// @param mesh The collision mesh.
+    /// @param V Vertices of the collision mesh.
+    /// @param candidates Edge-face candidates from the broad phase.
+    void begin_audit(
+        const CollisionMesh& mesh,
+        ConstMatrixXdRef V,
+        const std::vector<EdgeFaceCandidate>& candidates);
+
+    /// @brief Start the audit using candidates from an existing broad phase.
+    ///
+    /// Detects the edge-face candidates on the host (the broad phase must be
+    /// built for V) and then launches as the candidate overload does.
+    /// @param broad_phase Broad phase built for the vertices V.
+    /// @param mesh The collision mesh.
+    /// @param V Vertices of the collision mesh.
+    void begin_audit(
+        BroadPhase& broad_phase,
+        const CollisionMesh& mesh,
+        ConstMatrixXdRef V);
+
+    /// @brief Wait for the audit and return whether the mesh intersects.
+    ///
+    /// Blocks until the device tests finish, then resolves any candidates
+    /// the filtered predicate could not certify with the exact CPU test.
+    /// @return A boolean for if the mesh has intersections.
+    bool result();
+
+    /// @brief Is an audit in flight (begin_audit() called without result())?
+    bool is_running() const { return m_running; }
+
+    /// @brief Free all device memory and the stream.
+    void clear();
+
+protected:
+    /// @brief Grow a device buffer to hold count elements (no-op if large
+    /// enough).
+    void reserve_device(void** d_ptr, size_t& capacity, const size_t count);
+
+    bool m_running = false;
+    size_t m_num_candidates = 0;
+
+    // Host copies kept alive for the async uploads and the exact fallback.
+    std::vector<double> m_positions; ///< @brief Row-major |V|x3 positions.
+    std::vector<int> m_edges; ///< @brief Row-major |E|x2 vertex ids.
+    std::vector<int> m_faces; ///< @brief Row-major |F|x3 vertex ids.
+    std::vector<int> m_candidate_ids; ///< @brief (edge, face) id pairs.
+    std::vector<unsigned char> m_verdicts; ///< @brief Downloaded verdicts.
+
+    // Device buffers (capacities so repeated audits do not reallocate).
+    double* d_positions = nullptr;
+    size_t m_positions_capacity = 0;
+    int* d_edges = nullptr;
+    size_t m_edges_capacity = 0;
+    int* d_faces = nullptr;
+    size_t m_faces_capacity = 0;
+    int* d_candidate_ids = nullptr;
+    size_t m_candidates_capacity = 0;
+    unsigned char* d_verdicts = nullptr;
+    size_t m_verdicts_capacity = 0;
+
+    /// @brief The stream the audit runs on (created on first begin_audit()).
+    void* m_stream = nullptr;
+};
+
+} // namespace ipc
+
+#endif
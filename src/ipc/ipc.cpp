@@ -1,10 +1,16 @@
 #include "ipc.hpp"
 
+#include <ipc/barrier/barrier.hpp>
 #include <ipc/ccd/ccd.hpp>
 #include <ipc/broad_phase/hash_grid.hpp>
+#include <ipc/distance/edge_edge_mollifier.hpp>
 #include <ipc/utils/local_to_global.hpp>
 #include <ipc/utils/intersection.hpp>
 #include <ipc/utils/world_bbox_diagonal_length.hpp>
+#include <ipc/utils/execution_context.hpp>
+#include <ipc/utils/merge_thread_local_vectors.hpp>
+#include <ipc/utils/ordered_reduction.hpp>
+#include <ipc/utils/profiler.hpp>
 
 #include <ipc/config.hpp>
 
@@ -15,92 +21,644 @@
 #include <igl/predicates/segment_segment_intersect.h>
 
 #include <tbb/parallel_for.h>
+#include <tbb/parallel_sort.h>
+#include <tbb/task_group.h>
 #include <tbb/blocked_range.h>
 #include <tbb/enumerable_thread_specific.h>
-#include <mutex>
+#include <atomic>
 
 #include <algorithm> // std::min/max
+#include <array>
+#include <chrono>
+#include <cmath> // std::isfinite
 
 namespace ipc {
 
 double compute_barrier_potential(
     const CollisionMesh& mesh,
-    const Eigen::MatrixXd& V,
+    ConstMatrixXdRef V,
     const Constraints& constraint_set,
     const double dhat)
 {
+    double minimum_distance;
+    return compute_barrier_potential(
+        mesh, V, constraint_set, dhat, minimum_distance);
+}
+
+double compute_barrier_potential(
+    const CollisionMesh& mesh,
+    ConstMatrixXdRef V,
+    const Constraints& constraint_set,
+    const double dhat,
+    double& minimum_distance)
+{
+    IPC_PROFILE_SCOPE("compute_barrier_potential");
+
     assert(V.rows() == mesh.num_vertices());
 
+    minimum_distance = std::numeric_limits<double>::infinity();
+
     if (constraint_set.empty()) {
         return 0;
     }
 
-    const Eigen::MatrixXi& E = mesh.edges();
-    const Eigen::MatrixXi& F = mesh.faces();
+    return execution_context().run([&]() -> double {
+        const Eigen::MatrixXi& E = mesh.edges();
+        const Eigen::MatrixXi& F = mesh.faces();
+
+        // Reuse the distances computed while culling the candidates in build()
+        // if no vertex has moved since then.
+        const bool use_cached_distances =
+            constraint_set.are_cached_distances_valid(V);
+
+        // When every constraint has a cached distance, evaluate the barriers in
+        // one batch so the logs vectorize (see the array overload of barrier).
+        // Only mollified edge-edge constraints need per-constraint geometry.
+        if (use_cached_distances && constraint_set.pv_constraints.empty()) {
+            const size_t num_constraints = constraint_set.size();
+            const double dmin = constraint_set[0].minimum_distance;
+            const double local_dhat = constraint_set[0].local_dhat;
+
+            Eigen::ArrayXd distances(num_constraints);
+            Eigen::ArrayXd coeffs(num_constraints);
+
+            bool batchable = true;
+            for (size_t i = 0; i < num_constraints; i++) {
+                const CollisionConstraint& constraint = constraint_set[i];
+                if (constraint.cached_distance < 0
+                    || constraint.minimum_distance != dmin
+                    || constraint.local_dhat != local_dhat) {
+                    batchable = false;
+                    break;
+                }
+                distances[i] = constraint.cached_distance - dmin * dmin;
+                coeffs[i] = constraint.weight;
+            }
 
-    tbb::enumerable_thread_specific<double> storage(0);
+            if (batchable) {
+                minimum_distance = (distances + dmin * dmin).minCoeff();
+
+                const std::vector<EdgeEdgeConstraint>& ee_constraints =
+                    constraint_set.ee_constraints;
+                const size_t ee_offset = constraint_set.vv_constraints.size()
+                    + constraint_set.ev_constraints.size();
+                tbb::parallel_for(
+                    size_t(0), ee_constraints.size(), [&](size_t i) {
+                        const EdgeEdgeConstraint& ee = ee_constraints[i];
+                        coeffs[ee_offset + i] *= edge_edge_mollifier(
+                            V.row(E(ee.edge0_index, 0)),
+                            V.row(E(ee.edge0_index, 1)),
+                            V.row(E(ee.edge1_index, 0)),
+                            V.row(E(ee.edge1_index, 1)), ee.eps_x);
+                    });
+
+                const double batch_dhat = local_dhat < 0 ? dhat : local_dhat;
+                return (coeffs
+                        * barrier(
+                            distances,
+                            2 * dmin * batch_dhat + batch_dhat * batch_dhat))
+                    .sum();
+            }
+        }
 
-    tbb::parallel_for(
-        tbb::blocked_range<size_t>(size_t(0), constraint_set.size()),
-        [&](const tbb::blocked_range<size_t>& r) {
-            auto& local_potential = storage.local();
-            for (size_t i = r.begin(); i < r.end(); i++) {
-                // Quadrature weight is premultiplied by compute_potential
-                local_potential +=
-                    constraint_set[i].compute_potential(V, E, F, dhat);
+        if (execution_context().deterministic()) {
+            // Bitwise-reproducible reduction: fixed-size blocks are summed in
+            // index order and combined by an ordered pairwise tree, so the
+            // total does not depend on the thread count or schedule. Costs
+            // one partial per block plus the serial combine (a few percent).
+            const size_t num_blocks =
+                num_deterministic_blocks(constraint_set.size());
+            std::vector<double> block_potentials(num_blocks, 0.0);
+            std::vector<double> block_min_dists(
+                num_blocks, std::numeric_limits<double>::infinity());
+
+            tbb::parallel_for(size_t(0), num_blocks, [&](const size_t b) {
+                const size_t begin = b * DETERMINISTIC_BLOCK_SIZE;
+                const size_t end = std::min(
+                    begin + DETERMINISTIC_BLOCK_SIZE, constraint_set.size());
+                constraint_set.for_each(
+                    begin, end,
+                    [&](const auto& constraint, const size_t /*i*/) {
+                        const double distance = use_cached_distances
+                                && constraint.cached_distance >= 0
+                            ? constraint.cached_distance
+                            : constraint.compute_distance(V, E, F);
+                        block_potentials[b] += constraint.compute_potential(
+                            V, E, F, dhat, distance);
+                        block_min_dists[b] =
+                            std::min(block_min_dists[b], distance);
+                    });
+            });
+
+            for (const double block_min_dist : block_min_dists) {
+                minimum_distance = std::min(minimum_distance, block_min_dist);
             }
+            return ordered_pairwise_sum(block_potentials);
+        }
+
+        // Thread-local running (potential, minimum distance) pair: the
+        // distance is already in hand for the barrier, so tracking the
+        // minimum here saves a separate compute_minimum_distance pass.
+        tbb::enumerable_thread_specific<std::pair<double, double>> storage(
+            std::make_pair(0.0, std::numeric_limits<double>::infinity()));
+
+        tbb::parallel_for(
+            tbb::blocked_range<size_t>(size_t(0), constraint_set.size()),
+            [&](const tbb::blocked_range<size_t>& r) {
+                auto& [local_potential, local_min_dist] = storage.local();
+                constraint_set.for_each(
+                    r.begin(), r.end(),
+                    [&](const auto& constraint, const size_t /*i*/) {
+                        const double distance = use_cached_distances
+                                && constraint.cached_distance >= 0
+                            ? constraint.cached_distance
+                            : constraint.compute_distance(V, E, F);
+                        // Quadrature weight is premultiplied by
+                        // compute_potential
+                        local_potential += constraint.compute_potential(
+                            V, E, F, dhat, distance);
+                        local_min_dist = std::min(local_min_dist, distance);
+                    });
+            },
+            execution_context().affinity_partitioner(
+                ExecutionContext::AffinitySite::BARRIER_POTENTIAL));
+
+        double potential = 0;
+        for (const auto& [local_potential, local_min_dist] : storage) {
+            potential += local_potential;
+            minimum_distance = std::min(minimum_distance, local_min_dist);
+        }
+        return potential;
+    });
+}
+
+namespace {
+
+// Assembly loops specialized on the mesh dimension (selected once at the
+// entry points below) so the scatter index arithmetic runs on compile-time
+// sizes (see local_to_global.hpp). The per-constraint kernels stay virtual
+// and Max-sized because the stencil size varies per constraint type.
+
+template <int dim>
+Eigen::VectorXd compute_barrier_potential_gradient_impl(
+    ConstMatrixXdRef V,
+    const Eigen::MatrixXi& E,
+    const Eigen::MatrixXi& F,
+    const Constraints& constraint_set,
+    const double dhat,
+    const bool use_cached_distances,
+    const Constraints::ScatterColoring* const coloring,
+    const Constraints::EdgeEdgeTypeBuckets* const ee_buckets)
+{
+    // local_grad is caller provided scratch reused across the constraints of
+    // a range, so each evaluation writes in place instead of returning a
+    // Max-sized value.
+    const auto compute_local_gradient =
+        [&](const auto& constraint, VectorMax12d& local_grad,
+            std::vector<std::pair<long, double>>& entries) {
+            if (use_cached_distances && constraint.cached_distance >= 0) {
+                constraint.compute_potential_gradient(
+                    V, E, F, dhat, constraint.cached_distance, local_grad);
+            } else {
+                constraint.compute_potential_gradient(
+                    V, E, F, dhat, local_grad);
+            }
+            local_gradient_to_global_gradient<dim>(
+                local_grad, constraint.vertex_indices(E, F), entries);
+        };
+
+    if (coloring != nullptr) {
+        // No two constraints of a class share a vertex, so each class
+        // scatters directly into grad in parallel without thread-local
+        // copies or a merge pass. Each gradient entry also receives its
+        // contributions in class order regardless of the thread count, so
+        // this path is bitwise-reproducible on its own.
+        Eigen::VectorXd grad = Eigen::VectorXd::Zero(V.size());
+        for (const std::vector<size_t>& color_class : coloring->classes) {
+            tbb::parallel_for(
+                tbb::blocked_range<size_t>(size_t(0), color_class.size()),
+                [&](const tbb::blocked_range<size_t>& r) {
+                    VectorMax12d local_grad;
+                    for (size_t k = r.begin(); k < r.end(); k++) {
+                        const CollisionConstraint& constraint =
+                            constraint_set[color_class[k]];
+                        if (use_cached_distances
+                            && constraint.cached_distance >= 0) {
+                            constraint.compute_potential_gradient(
+                                V, E, F, dhat, constraint.cached_distance,
+                                local_grad);
+                        } else {
+                            constraint.compute_potential_gradient(
+                                V, E, F, dhat, local_grad);
+                        }
+                        local_gradient_to_global_gradient(
+                            local_grad, constraint.vertex_indices(E, F), dim,
+                            grad);
+                    }
+                });
+        }
+        return grad;
+    }
+
+    if (execution_context().deterministic()) {
+        // Bitwise-reproducible assembly: each fixed-size block fills its own
+        // entry slot, and the entries scatter into grad serially in block
+        // order, so the accumulation order is fixed across runs and thread
+        // counts (see ordered_reduction.hpp for the cost).
+        const size_t num_blocks =
+            num_deterministic_blocks(constraint_set.size());
+        std::vector<std::vector<std::pair<long, double>>> block_entries(
+            num_blocks);
+
+        tbb::parallel_for(size_t(0), num_blocks, [&](const size_t b) {
+            const size_t begin = b * DETERMINISTIC_BLOCK_SIZE;
+            const size_t end = std::min(
+                begin + DETERMINISTIC_BLOCK_SIZE, constraint_set.size());
+            VectorMax12d local_grad;
+            constraint_set.for_each(
+                begin, end, [&](const auto& constraint, const size_t /*i*/) {
+                    compute_local_gradient(
+                        constraint, local_grad, block_entries[b]);
+                });
         });
 
-    double potential = 0;
-    for (const auto& local_potential : storage) {
-        potential += local_potential;
+        Eigen::VectorXd grad = Eigen::VectorXd::Zero(V.size());
+        for (const auto& entries : block_entries) {
+            for (const auto& [index, value] : entries) {
+                grad[index] += value;
+            }
+        }
+        return grad;
+    }
+
+    // Accumulate sparse (index, value) entries per thread instead of a dense
+    // |V|-sized vector per thread (see local_gradient_to_global_gradient).
+    tbb::enumerable_thread_specific<std::vector<std::pair<long, double>>>
+        storage;
+
+    if (ee_buckets != nullptr) {
+        // Split the iteration around the edge-edge range and evaluate that
+        // range one closest-feature bucket at a time, so the 9-way dispatch
+        // inside the distance gradient takes the same branch for a whole
+        // loop. The thread-local entries make the accumulation order
+        // irrelevant, so the split changes nothing but the branch behavior.
+        // The bucket shapes change per iteration, so these loops use the
+        // default partitioner instead of the gradient affinity site.
+        const size_t ee_start = constraint_set.vv_constraints.size()
+            + constraint_set.ev_constraints.size();
+        const size_t ee_end = ee_start + constraint_set.ee_constraints.size();
+
+        const auto mixed_range = [&](const size_t begin, const size_t end) {
+            tbb::parallel_for(
+                tbb::blocked_range<size_t>(begin, end),
+                [&](const tbb::blocked_range<size_t>& r) {
+                    auto& local_grad_entries = storage.local();
+                    VectorMax12d local_grad;
+                    constraint_set.for_each(
+                        r.begin(), r.end(),
+                        [&](const auto& constraint, const size_t /*i*/) {
+                            compute_local_gradient(
+                                constraint, local_grad, local_grad_entries);
+                        });
+                });
+        };
+
+        mixed_range(0, ee_start);
+        for (const std::vector<size_t>& bucket : ee_buckets->by_type) {
+            tbb::parallel_for(
+                tbb::blocked_range<size_t>(size_t(0), bucket.size()),
+                [&](const tbb::blocked_range<size_t>& r) {
+                    auto& local_grad_entries = storage.local();
+                    VectorMax12d local_grad;
+                    for (size_t k = r.begin(); k < r.end(); k++) {
+                        compute_local_gradient(
+                            constraint_set.ee_constraints[bucket[k]],
+                            local_grad, local_grad_entries);
+                    }
+                });
+        }
+        mixed_range(ee_end, constraint_set.size());
+    } else {
+        tbb::parallel_for(
+            tbb::blocked_range<size_t>(size_t(0), constraint_set.size()),
+            [&](const tbb::blocked_range<size_t>& r) {
+                auto& local_grad_entries = storage.local();
+                VectorMax12d local_grad;
+                constraint_set.for_each(
+                    r.begin(), r.end(),
+                    [&](const auto& constraint, const size_t /*i*/) {
+                        compute_local_gradient(
+                            constraint, local_grad, local_grad_entries);
+                    });
+            },
+            execution_context().affinity_partitioner(
+                ExecutionContext::AffinitySite::BARRIER_GRADIENT));
+    }
+
+    Eigen::VectorXd grad = Eigen::VectorXd::Zero(V.size());
+    for (const auto& local_grad_entries : storage) {
+        for (const auto& [index, value] : local_grad_entries) {
+            grad[index] += value;
+        }
+    }
+    return grad;
+}
+
+// The local kernels stay in double; Scalar only controls the assembled
+// triplets and matrix (float halves the assembly memory traffic for solvers
+// that tolerate single-precision hessians).
+template <int dim, typename Scalar>
+Eigen::SparseMatrix<Scalar> compute_barrier_potential_hessian_impl(
+    ConstMatrixXdRef V,
+    const Eigen::MatrixXi& E,
+    const Eigen::MatrixXi& F,
+    const Constraints& constraint_set,
+    const double dhat,
+    const bool project_hessian_to_psd,
+    const Constraints::EdgeEdgeTypeBuckets* const ee_buckets,
+    const bool upper_triangular = false)
+{
+    // Each constraint writes a statically known (dim * n_verts)^2 block of
+    // entries and the typed vectors are concatenated in a fixed order, so a
+    // constraint's triplet offset is a closed-form prefix sum over the
+    // per-type counts. The storage is presized exactly and every range
+    // writes directly at its offset: no push_back growth (which reallocates
+    // and copies multi-GB buffers on large frames), no per-thread vectors,
+    // and no merge pass. In upper-triangular mode a constraint's count is
+    // n * (n + 1) / 2 instead of n^2, still a function of its type alone,
+    // so the same prefix-sum scheme applies.
+    const auto entries_per = [&](const size_t n_verts) {
+        const size_t n = size_t(dim) * n_verts;
+        return upper_triangular ? n * (n + 1) / 2 : n * n;
+    };
+    const auto scatter = [&](const MatrixMax12d& local_hess, const auto& ids,
+                             std::vector<Eigen::Triplet<Scalar>>& out,
+                             const size_t offset) {
+        if (upper_triangular) {
+            local_hessian_to_global_upper_triplets<dim>(
+                local_hess, ids, out, offset);
+        } else {
+            local_hessian_to_global_triplets<dim>(
+                local_hess, ids, out, offset);
+        }
+    };
+    const std::array<std::pair<size_t, size_t>, 5> type_blocks = { {
+        { constraint_set.vv_constraints.size(), entries_per(2) },
+        { constraint_set.ev_constraints.size(), entries_per(3) },
+        { constraint_set.ee_constraints.size(), entries_per(4) },
+        { constraint_set.fv_constraints.size(), entries_per(4) },
+        { constraint_set.pv_constraints.size(), entries_per(1) },
+    } };
+    const auto triplet_offset = [&](size_t i) {
+        size_t offset = 0;
+        for (const auto& [count, entries] : type_blocks) {
+            if (i < count) {
+                return offset + i * entries;
+            }
+            offset += count * entries;
+            i -= count;
+        }
+        return offset;
+    };
+
+    std::vector<Eigen::Triplet<Scalar>> triplets(
+        triplet_offset(constraint_set.size()));
+
+    if (ee_buckets != nullptr) {
+        // Evaluate the edge-edge range one closest-feature bucket at a time
+        // (see Constraints::use_edge_edge_type_bucketing). Every constraint
+        // owns a fixed triplet slot, so visiting the edge-edge constraints
+        // out of index order writes the same triplets to the same positions.
+        // The bucket shapes change per iteration, so these loops use the
+        // default partitioner instead of the hessian affinity site.
+        const size_t ee_start = constraint_set.vv_constraints.size()
+            + constraint_set.ev_constraints.size();
+        const size_t ee_end = ee_start + constraint_set.ee_constraints.size();
+        const size_t ee_offset = triplet_offset(ee_start);
+        const size_t ee_entries = entries_per(4);
+
+        const auto mixed_range = [&](const size_t begin, const size_t end) {
+            tbb::parallel_for(
+                tbb::blocked_range<size_t>(begin, end),
+                [&](const tbb::blocked_range<size_t>& r) {
+                    size_t offset = triplet_offset(r.begin());
+                    MatrixMax12d local_hess;
+
+                    constraint_set.for_each(
+                        r.begin(), r.end(),
+                        [&](const auto& constraint, const size_t /*i*/) {
+                            constraint.compute_potential_hessian(
+                                V, E, F, dhat, project_hessian_to_psd,
+                                local_hess);
+                            scatter(
+                                local_hess, constraint.vertex_indices(E, F),
+                                triplets, offset);
+                            offset += entries_per(local_hess.rows() / dim);
+                        });
+                    assert(offset == triplet_offset(r.end()));
+                });
+        };
+
+        mixed_range(0, ee_start);
+        for (const std::vector<size_t>& bucket : ee_buckets->by_type) {
+            tbb::parallel_for(
+                tbb::blocked_range<size_t>(size_t(0), bucket.size()),
+                [&](const tbb::blocked_range<size_t>& r) {
+                    MatrixMax12d local_hess;
+                    for (size_t k = r.begin(); k < r.end(); k++) {
+                        const EdgeEdgeConstraint& constraint =
+                            constraint_set.ee_constraints[bucket[k]];
+                        constraint.compute_potential_hessian(
+                            V, E, F, dhat, project_hessian_to_psd, local_hess);
+                        scatter(
+                            local_hess, constraint.vertex_indices(E, F),
+                            triplets, ee_offset + bucket[k] * ee_entries);
+                    }
+                });
+        }
+        mixed_range(ee_end, constraint_set.size());
+    } else {
+        tbb::parallel_for(
+            tbb::blocked_range<size_t>(size_t(0), constraint_set.size()),
+            [&](const tbb::blocked_range<size_t>& r) {
+                size_t offset = triplet_offset(r.begin());
+                MatrixMax12d local_hess;
+
+                constraint_set.for_each(
+                    r.begin(), r.end(),
+                    [&](const auto& constraint, const size_t /*i*/) {
+                        constraint.compute_potential_hessian(
+                            V, E, F, dhat, project_hessian_to_psd, local_hess);
+                        scatter(
+                            local_hess, constraint.vertex_indices(E, F),
+                            triplets, offset);
+                        offset += entries_per(local_hess.rows() / dim);
+                    });
+                assert(offset == triplet_offset(r.end()));
+            },
+            execution_context().affinity_partitioner(
+                ExecutionContext::AffinitySite::BARRIER_HESSIAN));
     }
-    return potential;
+
+    return sparse_from_triplets<Scalar>(V.size(), V.size(), triplets);
 }
 
+} // namespace
+
 Eigen::VectorXd compute_barrier_potential_gradient(
     const CollisionMesh& mesh,
-    const Eigen::MatrixXd& V,
+    ConstMatrixXdRef V,
     const Constraints& constraint_set,
     const double dhat)
 {
+    IPC_PROFILE_SCOPE("compute_barrier_potential_gradient");
+
     assert(V.rows() == mesh.num_vertices());
 
     if (constraint_set.empty()) {
         return Eigen::VectorXd::Zero(V.size());
     }
 
-    const Eigen::MatrixXi& E = mesh.edges();
-    const Eigen::MatrixXi& F = mesh.faces();
+    // Reuse the distances computed while culling the candidates in build()
+    // if no vertex has moved since then.
+    const bool use_cached_distances =
+        constraint_set.are_cached_distances_valid(V);
+
+    // The coloring is computed on first use and cached until the constraint
+    // set changes, so its cost amortizes over the iterations evaluated
+    // against the set.
+    const Constraints::ScatterColoring* const coloring =
+        constraint_set.use_colored_gradient_scatter
+        ? &constraint_set.scatter_coloring(mesh.edges(), mesh.faces())
+        : nullptr;
+
+    // The buckets are cached per position set, so their cost is shared with
+    // the hessian assembled at the same V.
+    const Constraints::EdgeEdgeTypeBuckets* const ee_buckets =
+        constraint_set.use_edge_edge_type_bucketing
+            && !constraint_set.ee_constraints.empty()
+        ? &constraint_set.edge_edge_type_buckets(V, mesh.edges())
+        : nullptr;
+
+    assert(V.cols() == 2 || V.cols() == 3);
+    return execution_context().run([&] {
+        return V.cols() == 2
+            ? compute_barrier_potential_gradient_impl<2>(
+                V, mesh.edges(), mesh.faces(), constraint_set, dhat,
+                use_cached_distances, coloring, ee_buckets)
+            : compute_barrier_potential_gradient_impl<3>(
+                V, mesh.edges(), mesh.faces(), constraint_set, dhat,
+                use_cached_distances, coloring, ee_buckets);
+    });
+}
 
-    int dim = V.cols();
+Eigen::SparseMatrix<double> compute_barrier_potential_hessian(
+    const CollisionMesh& mesh,
+    ConstMatrixXdRef V,
+    const Constraints& constraint_set,
+    const double dhat,
+    const bool project_hessian_to_psd)
+{
+    IPC_PROFILE_SCOPE("compute_barrier_potential_hessian");
 
-    tbb::enumerable_thread_specific<Eigen::VectorXd> storage(
-        Eigen::VectorXd::Zero(V.size()));
+    assert(V.rows() == mesh.num_vertices());
 
-    tbb::parallel_for(
-        tbb::blocked_range<size_t>(size_t(0), constraint_set.size()),
-        [&](const tbb::blocked_range<size_t>& r) {
-            auto& local_grad = storage.local();
-            for (size_t i = r.begin(); i < r.end(); i++) {
-                local_gradient_to_global_gradient(
-                    constraint_set[i].compute_potential_gradient(V, E, F, dhat),
-                    constraint_set[i].vertex_indices(E, F), dim, local_grad);
-            }
-        });
+    if (constraint_set.empty()) {
+        return Eigen::SparseMatrix<double>(V.size(), V.size());
+    }
 
-    Eigen::VectorXd grad = Eigen::VectorXd::Zero(V.size());
-    for (const auto& local_grad : storage) {
-        grad += local_grad;
+    const Constraints::EdgeEdgeTypeBuckets* const ee_buckets =
+        constraint_set.use_edge_edge_type_bucketing
+            && !constraint_set.ee_constraints.empty()
+        ? &constraint_set.edge_edge_type_buckets(V, mesh.edges())
+        : nullptr;
+
+    assert(V.cols() == 2 || V.cols() == 3);
+    return execution_context().run([&] {
+        return V.cols() == 2
+            ? compute_barrier_potential_hessian_impl<2, double>(
+                V, mesh.edges(), mesh.faces(), constraint_set, dhat,
+                project_hessian_to_psd, ee_buckets)
+            : compute_barrier_potential_hessian_impl<3, double>(
+                V, mesh.edges(), mesh.faces(), constraint_set, dhat,
+                project_hessian_to_psd, ee_buckets);
+    });
+}
+
+void compute_barrier_potential_hessian(
+    const CollisionMesh& mesh,
+    ConstMatrixXdRef V,
+    const Constraints& constraint_set,
+    const double dhat,
+    Eigen::SparseMatrix<float>& hess,
+    const bool project_hessian_to_psd)
+{
+    assert(V.rows() == mesh.num_vertices());
+
+    if (constraint_set.empty()) {
+        hess = Eigen::SparseMatrix<float>(V.size(), V.size());
+        return;
     }
-    return grad;
+
+    const Constraints::EdgeEdgeTypeBuckets* const ee_buckets =
+        constraint_set.use_edge_edge_type_bucketing
+            && !constraint_set.ee_constraints.empty()
+        ? &constraint_set.edge_edge_type_buckets(V, mesh.edges())
+        : nullptr;
+
+    assert(V.cols() == 2 || V.cols() == 3);
+    hess = execution_context().run([&] {
+        return V.cols() == 2
+            ? compute_barrier_potential_hessian_impl<2, float>(
+                V, mesh.edges(), mesh.faces(), constraint_set, dhat,
+                project_hessian_to_psd, ee_buckets)
+            : compute_barrier_potential_hessian_impl<3, float>(
+                V, mesh.edges(), mesh.faces(), constraint_set, dhat,
+                project_hessian_to_psd, ee_buckets);
+    });
+}
+
+Eigen::SparseMatrix<double> compute_barrier_potential_hessian_upper(
+    const CollisionMesh& mesh,
+    ConstMatrixXdRef V,
+    const Constraints& constraint_set,
+    const double dhat,
+    const bool project_hessian_to_psd)
+{
+    IPC_PROFILE_SCOPE("compute_barrier_potential_hessian_upper");
+
+    assert(V.rows() == mesh.num_vertices());
+
+    if (constraint_set.empty()) {
+        return Eigen::SparseMatrix<double>(V.size(), V.size());
+    }
+
+    const Constraints::EdgeEdgeTypeBuckets* const ee_buckets =
+        constraint_set.use_edge_edge_type_bucketing
+            && !constraint_set.ee_constraints.empty()
+        ? &constraint_set.edge_edge_type_buckets(V, mesh.edges())
+        : nullptr;
+
+    assert(V.cols() == 2 || V.cols() == 3);
+    return execution_context().run([&] {
+        return V.cols() == 2
+            ? compute_barrier_potential_hessian_impl<2, double>(
+                V, mesh.edges(), mesh.faces(), constraint_set, dhat,
+                project_hessian_to_psd, ee_buckets,
+                /*upper_triangular=*/true)
+            : compute_barrier_potential_hessian_impl<3, double>(
+                V, mesh.edges(), mesh.faces(), constraint_set, dhat,
+                project_hessian_to_psd, ee_buckets,
+                /*upper_triangular=*/true);
+    });
 }
 
 Eigen::SparseMatrix<double> compute_barrier_potential_hessian(
     const CollisionMesh& mesh,
-    const Eigen::MatrixXd& V,
+    ConstMatrixXdRef V,
     const Constraints& constraint_set,
     const double dhat,
+    HessianAssemblyCache& cache,
     const bool project_hessian_to_psd)
 {
     assert(V.rows() == mesh.num_vertices());
@@ -114,36 +672,288 @@ Eigen::SparseMatrix<double> compute_barrier_potential_hessian(
 
     const int dim = V.cols();
 
-    tbb::enumerable_thread_specific<std::vector<Eigen::Triplet<double>>>
-        storage;
+    return execution_context().run([&] {
+        std::vector<MatrixMax12d> local_hessians(constraint_set.size());
+        std::vector<std::array<index_t, 4>> vertex_ids(constraint_set.size());
+
+        tbb::parallel_for(
+            tbb::blocked_range<size_t>(size_t(0), constraint_set.size()),
+            [&](const tbb::blocked_range<size_t>& r) {
+                constraint_set.for_each(
+                    r.begin(), r.end(),
+                    [&](const auto& constraint, const size_t i) {
+                        constraint.compute_potential_hessian(
+                            V, E, F, dhat, project_hessian_to_psd,
+                            local_hessians[i]);
+                        vertex_ids[i] = constraint.vertex_indices(E, F);
+                    });
+            },
+            execution_context().affinity_partitioner(
+                ExecutionContext::AffinitySite::BARRIER_HESSIAN));
+
+        return cache.assemble(local_hessians, vertex_ids, dim, V.size());
+    });
+}
 
+bool update_barrier_potential_hessian_pattern(
+    const CollisionMesh& mesh,
+    const Constraints& constraint_set,
+    HessianAssemblyCache& cache)
+{
+    const Eigen::MatrixXi& E = mesh.edges();
+    const Eigen::MatrixXi& F = mesh.faces();
+
+    std::vector<std::array<index_t, 4>> vertex_ids(constraint_set.size());
     tbb::parallel_for(
         tbb::blocked_range<size_t>(size_t(0), constraint_set.size()),
         [&](const tbb::blocked_range<size_t>& r) {
-            auto& local_hess_triplets = storage.local();
-
-            for (size_t i = r.begin(); i < r.end(); i++) {
-                local_hessian_to_global_triplets(
-                    constraint_set[i].compute_potential_hessian(
-                        V, E, F, dhat, project_hessian_to_psd),
-                    constraint_set[i].vertex_indices(E, F), dim,
-                    local_hess_triplets);
+            constraint_set.for_each(
+                r.begin(), r.end(),
+                [&](const auto& constraint, const size_t i) {
+                    vertex_ids[i] = constraint.vertex_indices(E, F);
+                });
+        },
+        execution_context().affinity_partitioner(
+            ExecutionContext::AffinitySite::BARRIER_HESSIAN));
+
+    return cache.update_pattern(vertex_ids, mesh.dim(), mesh.ndof());
+}
+
+void compute_barrier_potential_hessian(
+    const CollisionMesh& mesh,
+    ConstMatrixXdRef V,
+    const Constraints& constraint_set,
+    const double dhat,
+    HessianAssemblyCache& cache,
+    double* values,
+    const bool project_hessian_to_psd)
+{
+    assert(V.rows() == mesh.num_vertices());
+
+    const Eigen::MatrixXi& E = mesh.edges();
+    const Eigen::MatrixXi& F = mesh.faces();
+
+    const int dim = V.cols();
+
+    execution_context().run([&] {
+        std::vector<MatrixMax12d> local_hessians(constraint_set.size());
+        std::vector<std::array<index_t, 4>> vertex_ids(constraint_set.size());
+
+        tbb::parallel_for(
+            tbb::blocked_range<size_t>(size_t(0), constraint_set.size()),
+            [&](const tbb::blocked_range<size_t>& r) {
+                constraint_set.for_each(
+                    r.begin(), r.end(),
+                    [&](const auto& constraint, const size_t i) {
+                        constraint.compute_potential_hessian(
+                            V, E, F, dhat, project_hessian_to_psd,
+                            local_hessians[i]);
+                        vertex_ids[i] = constraint.vertex_indices(E, F);
+                    });
+            },
+            execution_context().affinity_partitioner(
+                ExecutionContext::AffinitySite::BARRIER_HESSIAN));
+
+        // Writing values for an unagreed pattern could overrun the caller's
+        // buffers, so a stale pattern is an error rather than a rebuild.
+        if (cache.update_pattern(vertex_ids, dim, V.size())) {
+            throw std::runtime_error(
+                "The cached hessian pattern does not match the constraint "
+                "set; call update_barrier_potential_hessian_pattern() and "
+                "resize the CSR buffers before assembling values!");
+        }
+
+        cache.assemble_values(local_hessians, values);
+    });
+}
+
+BlockSparseMatrix compute_barrier_potential_block_hessian(
+    const CollisionMesh& mesh,
+    ConstMatrixXdRef V,
+    const Constraints& constraint_set,
+    const double dhat,
+    const bool project_hessian_to_psd)
+{
+    assert(V.rows() == mesh.num_vertices());
+
+    const Eigen::MatrixXi& E = mesh.edges();
+    const Eigen::MatrixXi& F = mesh.faces();
+
+    const int dim = V.cols();
+
+    return execution_context().run([&]() -> BlockSparseMatrix {
+        tbb::enumerable_thread_specific<std::vector<BlockTriplet>> storage;
+
+        tbb::parallel_for(
+            tbb::blocked_range<size_t>(size_t(0), constraint_set.size()),
+            [&](const tbb::blocked_range<size_t>& r) {
+                auto& local_block_triplets = storage.local();
+                MatrixMax12d local_hess;
+
+                constraint_set.for_each(
+                    r.begin(), r.end(),
+                    [&](const auto& constraint, const size_t /*i*/) {
+                        constraint.compute_potential_hessian(
+                            V, E, F, dhat, project_hessian_to_psd,
+                            local_hess);
+                        local_hessian_to_global_block_triplets(
+                            local_hess, constraint.vertex_indices(E, F), dim,
+                            local_block_triplets);
+                    });
+            },
+            execution_context().affinity_partitioner(
+                ExecutionContext::AffinitySite::BARRIER_HESSIAN));
+
+        BlockTriplets block_triplets;
+        merge_thread_local_vectors(storage, block_triplets);
+
+        BlockSparseMatrix hess;
+        hess.set_from_block_triplets(
+            block_triplets, V.rows(), V.rows(), dim);
+        return hess;
+    });
+}
+
+double compute_barrier_potential_and_derivatives(
+    const CollisionMesh& mesh,
+    ConstMatrixXdRef V,
+    const Constraints& constraint_set,
+    const double dhat,
+    Eigen::VectorXd& grad,
+    Eigen::SparseMatrix<double>& hess,
+    const bool project_hessian_to_psd,
+    Workspace* const workspace)
+{
+    assert(V.rows() == mesh.num_vertices());
+
+    grad = Eigen::VectorXd::Zero(V.size());
+    hess = Eigen::SparseMatrix<double>(V.size(), V.size());
+
+    if (constraint_set.empty()) {
+        return 0;
+    }
+
+    const Eigen::MatrixXi& E = mesh.edges();
+    const Eigen::MatrixXi& F = mesh.faces();
+
+    const int dim = V.cols();
+
+    return execution_context().run([&]() -> double {
+        // Scratch buffers live in the caller's workspace when one is given,
+        // so their capacity persists across steps; the fallback matches the
+        // old per-call allocation behavior.
+        Workspace fallback_workspace;
+        Workspace::ThreadLocalBuffers& storage =
+            (workspace != nullptr ? *workspace : fallback_workspace)
+                .arena(Workspace::Site::BARRIER_DERIVATIVES);
+
+        tbb::parallel_for(
+            tbb::blocked_range<size_t>(size_t(0), constraint_set.size()),
+            [&](const tbb::blocked_range<size_t>& r) {
+                Workspace::LocalBuffers& local_storage = storage.local();
+                VectorMax12d local_grad;
+                MatrixMax12d local_hess;
+
+                constraint_set.for_each(
+                    r.begin(), r.end(),
+                    [&](const auto& constraint, const size_t /*i*/) {
+                        double potential;
+                        constraint.compute_potential_and_derivatives(
+                            V, E, F, dhat, project_hessian_to_psd, potential,
+                            local_grad, local_hess);
+
+                        local_storage.potential += potential;
+
+                        const std::array<index_t, 4> ids =
+                            constraint.vertex_indices(E, F);
+                        local_gradient_to_global_gradient(
+                            local_grad, ids, dim, local_storage.grad_entries);
+                        local_hessian_to_global_triplets(
+                            local_hess, ids, dim, local_storage.hess_triplets);
+                    });
+            },
+            execution_context().affinity_partitioner(
+                ExecutionContext::AffinitySite::
+                    BARRIER_POTENTIAL_AND_DERIVATIVES));
+
+        double potential = 0;
+        for (const Workspace::LocalBuffers& local_storage : storage) {
+            potential += local_storage.potential;
+            for (const auto& [index, value] : local_storage.grad_entries) {
+                grad[index] += value;
             }
-        });
 
-    Eigen::SparseMatrix<double> hess(V.size(), V.size());
-    for (const auto& local_hess_triplets : storage) {
-        Eigen::SparseMatrix<double> local_hess(V.size(), V.size());
-        local_hess.setFromTriplets(
-            local_hess_triplets.begin(), local_hess_triplets.end());
-        hess += local_hess;
+            Eigen::SparseMatrix<double> local_hess(V.size(), V.size());
+            local_hess.setFromTriplets(
+                local_storage.hess_triplets.begin(),
+                local_storage.hess_triplets.end());
+            hess += local_hess;
+        }
+        return potential;
+    });
+}
+
+IterationDerivatives compute_iteration_derivatives(
+    const CollisionMesh& mesh,
+    ConstMatrixXdRef V,
+    const Constraints& constraint_set,
+    const double dhat,
+    ConstMatrixXdRef friction_V0,
+    const FrictionConstraints& friction_constraint_set,
+    const double epsv_times_h,
+    const bool project_hessian_to_psd,
+    Workspace* const workspace)
+{
+    assert(V.rows() == mesh.num_vertices());
+
+    IterationDerivatives result;
+
+    if (friction_constraint_set.empty()) {
+        result.barrier_potential = compute_barrier_potential_and_derivatives(
+            mesh, V, constraint_set, dhat, result.barrier_gradient,
+            result.barrier_hessian, project_hessian_to_psd, workspace);
+        return result;
     }
-    return hess;
+
+    // Submit the two fused evaluations as concurrent tasks and wait for
+    // both: the tail of one phase (a few threads finishing off imbalanced
+    // constraint ranges while the rest idle at the phase's sync) is filled
+    // with the other phase's work instead of draining the workers between
+    // sequential calls.
+    tbb::task_group tasks;
+    tasks.run([&] {
+        result.barrier_potential = compute_barrier_potential_and_derivatives(
+            mesh, V, constraint_set, dhat, result.barrier_gradient,
+            result.barrier_hessian, project_hessian_to_psd, workspace);
+    });
+    tasks.run([&] {
+        compute_friction_potential_gradient_and_hessian(
+            mesh, friction_V0, V, friction_constraint_set, epsv_times_h,
+            result.friction_gradient, result.friction_hessian,
+            project_hessian_to_psd, workspace);
+    });
+    tasks.wait();
+
+    return result;
+}
+
+IterationDerivatives compute_iteration_derivatives(
+    const CollisionMesh& mesh,
+    ConstMatrixXdRef V,
+    const Constraints& constraint_set,
+    const double dhat,
+    const bool project_hessian_to_psd,
+    Workspace* const workspace)
+{
+    return compute_iteration_derivatives(
+        mesh, V, constraint_set, dhat, /*friction_V0=*/V,
+        /*friction_constraint_set=*/FrictionConstraints(),
+        /*epsv_times_h=*/0, project_hessian_to_psd, workspace);
 }
 
 Eigen::SparseMatrix<double> compute_barrier_shape_derivative(
     const CollisionMesh& mesh,
-    const Eigen::MatrixXd& V,
+    ConstMatrixXdRef V,
     const Constraints& constraint_set,
     const double dhat)
 {
@@ -155,65 +965,318 @@ Eigen::SparseMatrix<double> compute_barrier_shape_derivative(
 
     const int dim = V.cols();
 
-    tbb::enumerable_thread_specific<std::vector<Eigen::Triplet<double>>>
-        storage;
+    return execution_context().run([&]() -> Eigen::SparseMatrix<double> {
+        tbb::enumerable_thread_specific<std::vector<Eigen::Triplet<double>>>
+            storage;
+
+        tbb::parallel_for(
+            tbb::blocked_range<size_t>(size_t(0), constraint_set.size()),
+            [&](const tbb::blocked_range<size_t>& r) {
+                auto& local_triplets = storage.local();
+                VectorMax12d local_barrier_grad;
+
+                // for (size_t ci = 0; ci < constraint_set.size(); ci++) {
+                for (size_t ci = r.begin(); ci < r.end(); ci++) {
+
+                    const CollisionConstraint& constraint = constraint_set[ci];
+                    const Eigen::SparseVector<double>& weight_gradient =
+                        constraint.weight_gradient;
+                    if (weight_gradient.size() != V.size()) {
+                        throw std::runtime_error(
+                            "Shape derivative is not computed for "
+                            "contact constraint!");
+                    }
+
+                    constraint.compute_potential_gradient(
+                        V, E, F, dhat, local_barrier_grad);
+                    assert(constraint.weight != 0);
+                    local_barrier_grad.array() /= constraint.weight;
+
+                    const std::array<index_t, 4> ids =
+                        constraint.vertex_indices(E, F);
+                    assert(local_barrier_grad.size() % dim == 0);
+                    const int n_verts = local_barrier_grad.size() / dim;
+                    assert(ids.size() >= n_verts); // Can be extra ids
+
+                    for (int i = 0; i < n_verts; i++) {
+                        for (int d = 0; d < dim; d++) {
+                            using Itr =
+                                Eigen::SparseVector<double>::InnerIterator;
+                            for (Itr j(weight_gradient); j; ++j) {
+                                local_triplets.emplace_back(
+                                    ids[i] * dim + d, j.index(),
+                                    local_barrier_grad[dim * i + d]
+                                        * j.value());
+                            }
+                        }
+                    }
+                }
+            },
+            execution_context().affinity_partitioner(
+                ExecutionContext::AffinitySite::SHAPE_DERIVATIVE));
+
+        // Compress the triplets once instead of building and adding one
+        // sparse matrix per thread.
+        std::vector<Eigen::Triplet<double>> triplets;
+        merge_thread_local_vectors(storage, triplets);
+
+        shape_derivative +=
+            sparse_from_triplets(V.size(), V.size(), triplets);
+
+        return shape_derivative;
+    });
+}
+
+Eigen::SparseMatrix<double> compute_barrier_shape_derivative(
+    const CollisionMesh& mesh,
+    ConstMatrixXdRef V,
+    const Constraints& constraint_set,
+    const double dhat,
+    ShapeDerivativeAssemblyCache& cache)
+{
+    assert(V.rows() == mesh.num_vertices());
+
+    if (constraint_set.empty()) {
+        return Eigen::SparseMatrix<double>(V.size(), V.size());
+    }
+
+    const Eigen::MatrixXi& E = mesh.edges();
+    const Eigen::MatrixXi& F = mesh.faces();
+
+    const int dim = V.cols();
+
+    return execution_context().run([&]() -> Eigen::SparseMatrix<double> {
+        std::vector<MatrixMax12d> local_hessians(constraint_set.size());
+        std::vector<VectorMax12d> local_gradients(constraint_set.size());
+        std::vector<const Eigen::SparseVector<double>*> weight_gradients(
+            constraint_set.size());
+        std::vector<std::array<index_t, 4>> vertex_ids(constraint_set.size());
+
+        tbb::parallel_for(
+            tbb::blocked_range<size_t>(size_t(0), constraint_set.size()),
+            [&](const tbb::blocked_range<size_t>& r) {
+                for (size_t ci = r.begin(); ci < r.end(); ci++) {
+                    const CollisionConstraint& constraint = constraint_set[ci];
+                    if (constraint.weight_gradient.size() != V.size()) {
+                        throw std::runtime_error(
+                            "Shape derivative is not computed for "
+                            "contact constraint!");
+                    }
+                    weight_gradients[ci] = &constraint.weight_gradient;
+
+                    constraint.compute_potential_hessian(
+                        V, E, F, dhat, /*project_hessian_to_psd=*/false,
+                        local_hessians[ci]);
+
+                    constraint.compute_potential_gradient(
+                        V, E, F, dhat, local_gradients[ci]);
+                    assert(constraint.weight != 0);
+                    local_gradients[ci].array() /= constraint.weight;
+
+                    vertex_ids[ci] = constraint.vertex_indices(E, F);
+                }
+            },
+            execution_context().affinity_partitioner(
+                ExecutionContext::AffinitySite::SHAPE_DERIVATIVE));
+
+        return cache.assemble(
+            local_hessians, local_gradients, weight_gradients, vertex_ids,
+            dim, V.size());
+    });
+}
+
+namespace {
+
+// One parallel pass producing every per-constraint term the fused
+// hessian + shape-derivative entry points need. The shape derivative needs
+// the unprojected hessian, so it is computed once and a copy is projected
+// for the dof hessian rather than running the kernel twice.
+void compute_hessian_and_shape_derivative_locals(
+    ConstMatrixXdRef V,
+    const Eigen::MatrixXi& E,
+    const Eigen::MatrixXi& F,
+    const Constraints& constraint_set,
+    const double dhat,
+    const bool project_hessian_to_psd,
+    std::vector<MatrixMax12d>& local_hessians,
+    std::vector<MatrixMax12d>& projected_hessians,
+    std::vector<VectorMax12d>& local_gradients,
+    std::vector<const Eigen::SparseVector<double>*>& weight_gradients,
+    std::vector<std::array<index_t, 4>>& vertex_ids)
+{
+    local_hessians.resize(constraint_set.size());
+    projected_hessians.resize(
+        project_hessian_to_psd ? constraint_set.size() : 0);
+    local_gradients.resize(constraint_set.size());
+    weight_gradients.resize(constraint_set.size());
+    vertex_ids.resize(constraint_set.size());
 
     tbb::parallel_for(
         tbb::blocked_range<size_t>(size_t(0), constraint_set.size()),
         [&](const tbb::blocked_range<size_t>& r) {
-            auto& local_triplets = storage.local();
-
-            // for (size_t ci = 0; ci < constraint_set.size(); ci++) {
             for (size_t ci = r.begin(); ci < r.end(); ci++) {
-
                 const CollisionConstraint& constraint = constraint_set[ci];
-                const Eigen::SparseVector<double>& weight_gradient =
-                    constraint.weight_gradient;
-                if (weight_gradient.size() != V.size()) {
+                if (constraint.weight_gradient.size() != V.size()) {
                     throw std::runtime_error(
-                        "Shape derivative is not computed for contact constraint!");
+                        "Shape derivative is not computed for "
+                        "contact constraint!");
+                }
+                weight_gradients[ci] = &constraint.weight_gradient;
+
+                constraint.compute_potential_hessian(
+                    V, E, F, dhat, /*project_hessian_to_psd=*/false,
+                    local_hessians[ci]);
+                if (project_hessian_to_psd) {
+                    projected_hessians[ci] =
+                        project_to_psd(local_hessians[ci]);
                 }
 
-                VectorMax12d local_barrier_grad =
-                    constraint.compute_potential_gradient(V, E, F, dhat);
+                constraint.compute_potential_gradient(
+                    V, E, F, dhat, local_gradients[ci]);
                 assert(constraint.weight != 0);
-                local_barrier_grad.array() /= constraint.weight;
-
-                const std::array<long, 4> ids = constraint.vertex_indices(E, F);
-                assert(local_barrier_grad.size() % dim == 0);
-                const int n_verts = local_barrier_grad.size() / dim;
-                assert(ids.size() >= n_verts); // Can be extra ids
-
-                for (int i = 0; i < n_verts; i++) {
-                    for (int d = 0; d < dim; d++) {
-                        using Itr = Eigen::SparseVector<double>::InnerIterator;
-                        for (Itr j(weight_gradient); j; ++j) {
-                            local_triplets.emplace_back(
-                                ids[i] * dim + d, j.index(),
-                                local_barrier_grad[dim * i + d] * j.value());
-                        }
-                    }
+                local_gradients[ci].array() /= constraint.weight;
+
+                vertex_ids[ci] = constraint.vertex_indices(E, F);
+            }
+        },
+        execution_context().affinity_partitioner(
+            ExecutionContext::AffinitySite::SHAPE_DERIVATIVE));
+}
+
+} // namespace
+
+void compute_barrier_potential_hessian_and_shape_derivative(
+    const CollisionMesh& mesh,
+    ConstMatrixXdRef V,
+    const Constraints& constraint_set,
+    const double dhat,
+    Eigen::SparseMatrix<double>& hess,
+    Eigen::SparseMatrix<double>& shape_derivative,
+    const bool project_hessian_to_psd)
+{
+    assert(V.rows() == mesh.num_vertices());
+
+    hess = Eigen::SparseMatrix<double>(V.size(), V.size());
+    shape_derivative = Eigen::SparseMatrix<double>(V.size(), V.size());
+
+    if (constraint_set.empty()) {
+        return;
+    }
+
+    const Eigen::MatrixXi& E = mesh.edges();
+    const Eigen::MatrixXi& F = mesh.faces();
+
+    const int dim = V.cols();
+
+    execution_context().run([&]() {
+        std::vector<MatrixMax12d> local_hessians, projected_hessians;
+        std::vector<VectorMax12d> local_gradients;
+        std::vector<const Eigen::SparseVector<double>*> weight_gradients;
+        std::vector<std::array<index_t, 4>> vertex_ids;
+        compute_hessian_and_shape_derivative_locals(
+            V, E, F, constraint_set, dhat, project_hessian_to_psd,
+            local_hessians, projected_hessians, local_gradients,
+            weight_gradients, vertex_ids);
+
+        std::vector<Eigen::Triplet<double>> hess_triplets;
+        std::vector<Eigen::Triplet<double>> shape_derivative_triplets;
+        for (size_t ci = 0; ci < constraint_set.size(); ci++) {
+            local_hessian_to_global_triplets(
+                project_hessian_to_psd ? projected_hessians[ci]
+                                       : local_hessians[ci],
+                vertex_ids[ci], dim, hess_triplets);
+            local_hessian_to_global_triplets(
+                local_hessians[ci], vertex_ids[ci], dim,
+                shape_derivative_triplets);
+
+            const VectorMax12d& local_gradient = local_gradients[ci];
+            for (long g = 0; g < local_gradient.size(); g++) {
+                const long row = vertex_ids[ci][g / dim] * dim + g % dim;
+                using Itr = Eigen::SparseVector<double>::InnerIterator;
+                for (Itr j(*weight_gradients[ci]); j; ++j) {
+                    shape_derivative_triplets.emplace_back(
+                        row, j.index(), local_gradient[g] * j.value());
                 }
             }
-        });
+        }
+
+        hess = sparse_from_triplets(V.size(), V.size(), hess_triplets);
+        shape_derivative = sparse_from_triplets(
+            V.size(), V.size(), shape_derivative_triplets);
+    });
+}
+
+void compute_barrier_potential_hessian_and_shape_derivative(
+    const CollisionMesh& mesh,
+    ConstMatrixXdRef V,
+    const Constraints& constraint_set,
+    const double dhat,
+    HessianAssemblyCache& hessian_cache,
+    ShapeDerivativeAssemblyCache& shape_derivative_cache,
+    Eigen::SparseMatrix<double>& hess,
+    Eigen::SparseMatrix<double>& shape_derivative,
+    const bool project_hessian_to_psd)
+{
+    assert(V.rows() == mesh.num_vertices());
+
+    if (constraint_set.empty()) {
+        hess = Eigen::SparseMatrix<double>(V.size(), V.size());
+        shape_derivative = Eigen::SparseMatrix<double>(V.size(), V.size());
+        return;
+    }
+
+    const Eigen::MatrixXi& E = mesh.edges();
+    const Eigen::MatrixXi& F = mesh.faces();
+
+    const int dim = V.cols();
+
+    execution_context().run([&]() {
+        std::vector<MatrixMax12d> local_hessians, projected_hessians;
+        std::vector<VectorMax12d> local_gradients;
+        std::vector<const Eigen::SparseVector<double>*> weight_gradients;
+        std::vector<std::array<index_t, 4>> vertex_ids;
+        compute_hessian_and_shape_derivative_locals(
+            V, E, F, constraint_set, dhat, project_hessian_to_psd,
+            local_hessians, projected_hessians, local_gradients,
+            weight_gradients, vertex_ids);
+
+        hess = hessian_cache.assemble(
+            project_hessian_to_psd ? projected_hessians : local_hessians,
+            vertex_ids, dim, V.size());
+        shape_derivative = shape_derivative_cache.assemble(
+            local_hessians, local_gradients, weight_gradients, vertex_ids,
+            dim, V.size());
+    });
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool is_step_collision_free(
+    const CollisionMesh& mesh,
+    ConstMatrixXdRef V0,
+    ConstMatrixXdRef V1,
+    const BroadPhaseMethod method,
+    const double tolerance,
+    const long max_iterations)
+{
+    assert(V0.rows() == mesh.num_vertices());
+    assert(V1.rows() == mesh.num_vertices());
 
-    for (const auto& local_triplets : storage) {
-        Eigen::SparseMatrix<double> local_shape_derivative(V.size(), V.size());
-        local_shape_derivative.setFromTriplets(
-            local_triplets.begin(), local_triplets.end());
-        shape_derivative += local_shape_derivative;
-    }
+    // Broad phase
+    Candidates candidates;
+    construct_collision_candidates(
+        mesh, V0, V1, candidates, /*inflation_radius=*/0, method);
 
-    return shape_derivative;
+    // Narrow phase
+    return is_step_collision_free(
+        candidates, mesh, V0, V1, tolerance, max_iterations);
 }
 
-///////////////////////////////////////////////////////////////////////////////
-
 bool is_step_collision_free(
+    BroadPhase& broad_phase,
     const CollisionMesh& mesh,
-    const Eigen::MatrixXd& V0,
-    const Eigen::MatrixXd& V1,
-    const BroadPhaseMethod method,
+    ConstMatrixXdRef V0,
+    ConstMatrixXdRef V1,
     const double tolerance,
     const long max_iterations)
 {
@@ -223,7 +1286,7 @@ bool is_step_collision_free(
     // Broad phase
     Candidates candidates;
     construct_collision_candidates(
-        mesh, V0, V1, candidates, /*inflation_radius=*/0, method);
+        broad_phase, mesh, V0, V1, candidates, /*inflation_radius=*/0);
 
     // Narrow phase
     return is_step_collision_free(
@@ -233,8 +1296,8 @@ bool is_step_collision_free(
 bool is_step_collision_free(
     const Candidates& candidates,
     const CollisionMesh& mesh,
-    const Eigen::MatrixXd& V0,
-    const Eigen::MatrixXd& V1,
+    ConstMatrixXdRef V0,
+    ConstMatrixXdRef V1,
     const double tolerance,
     const long max_iterations)
 {
@@ -244,30 +1307,108 @@ bool is_step_collision_free(
     const Eigen::MatrixXi& E = mesh.edges();
     const Eigen::MatrixXi& F = mesh.faces();
 
-    // Narrow phase
-    for (size_t i = 0; i < candidates.size(); i++) {
-        double toi;
-        bool is_collision = candidates[i].ccd(
-            V0, V1, E, F, toi, /*tmax=*/1.0, tolerance, max_iterations);
+    // Narrow phase. Only the first collision matters, so the parallel loop
+    // cancels early through a shared found-flag: blocks bail out before
+    // starting and after every query once any thread reports a hit, so a
+    // first-candidate collision returns without draining the candidate set.
+    std::atomic<bool> found_collision(false);
+    execution_context().run([&]() {
+        tbb::parallel_for(
+            tbb::blocked_range<size_t>(size_t(0), candidates.size()),
+            [&](const tbb::blocked_range<size_t>& r) {
+                if (found_collision.load(std::memory_order_relaxed)) {
+                    return;
+                }
+                for (size_t i = r.begin(); i < r.end(); i++) {
+                    double toi;
+                    if (candidates[i].ccd(
+                            V0, V1, E, F, toi, /*min_distance=*/0,
+                            /*tmax=*/1.0, tolerance, max_iterations)) {
+                        found_collision.store(
+                            true, std::memory_order_relaxed);
+                        return;
+                    }
+                    if (found_collision.load(std::memory_order_relaxed)) {
+                        return;
+                    }
+                }
+            });
+    });
+
+    return !found_collision;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+/// Shared expiry state of a CCDBudget; one instance is shared by the
+/// concurrent narrow-phase branches so the deadline and the query count
+/// are global to the compute_collision_free_stepsize call.
+struct CCDBudgetState {
+    explicit CCDBudgetState(const CCDBudget& budget)
+        : deadline(
+            std::isfinite(budget.max_seconds)
+                ? std::chrono::steady_clock::now()
+                    + std::chrono::duration_cast<
+                          std::chrono::steady_clock::duration>(
+                          std::chrono::duration<double>(budget.max_seconds))
+                : std::chrono::steady_clock::time_point::max())
+        , remaining_queries(
+              budget.max_queries < 0 ? std::numeric_limits<long>::max()
+                                     : budget.max_queries)
+    {
+    }
 
-        if (is_collision) {
+    /// @brief Charge one narrow-phase query against the budget.
+    /// @returns False once the budget has expired.
+    bool charge_query()
+    {
+        if (expired.load(std::memory_order_relaxed)) {
+            return false;
+        }
+        if (remaining_queries.fetch_sub(1, std::memory_order_relaxed) <= 0
+            || std::chrono::steady_clock::now() >= deadline) {
+            expired.store(true, std::memory_order_relaxed);
             return false;
         }
+        return true;
     }
 
-    return true;
-}
+    const std::chrono::steady_clock::time_point deadline;
+    std::atomic<long> remaining_queries;
+    std::atomic<bool> expired = false;
+};
 
-///////////////////////////////////////////////////////////////////////////////
+// Defined below, after the public stepsize overloads that call it.
+void ccd_narrow_phase(
+    const Candidates& candidates,
+    const CollisionMesh& mesh,
+    ConstMatrixXdRef V0,
+    ConstMatrixXdRef V1,
+    const double min_distance,
+    const double tolerance,
+    const long max_iterations,
+    const bool adaptive_tolerance,
+    std::atomic<double>& earliest_toi,
+    CCDBudgetState* const budget_state = nullptr,
+    const SceneBounds* const scene_bounds = nullptr);
+
+} // namespace
 
 double compute_collision_free_stepsize(
     const CollisionMesh& mesh,
-    const Eigen::MatrixXd& V0,
-    const Eigen::MatrixXd& V1,
+    ConstMatrixXdRef V0,
+    ConstMatrixXdRef V1,
+    const double min_distance,
     const BroadPhaseMethod method,
     const double tolerance,
-    const long max_iterations)
+    const long max_iterations,
+    const bool adaptive_tolerance,
+    CCDBudget* const budget)
 {
+    IPC_PROFILE_SCOPE("compute_collision_free_stepsize");
+
     assert(V0.rows() == mesh.num_vertices());
     assert(V1.rows() == mesh.num_vertices());
     const Eigen::MatrixXi& E = mesh.edges();
@@ -275,7 +1416,6 @@ double compute_collision_free_stepsize(
 
     if (method == BroadPhaseMethod::SWEEP_AND_TINIEST_QUEUE_GPU) {
 #ifdef IPC_TOOLKIT_WITH_CUDA
-        double min_distance = 0; // TODO
         const double step_size = ccd::gpu::compute_toi_strategy(
             V0, V1, E, F, max_iterations, min_distance, tolerance);
         if (step_size < 1.0) {
@@ -288,65 +1428,764 @@ double compute_collision_free_stepsize(
 #endif
     }
 
-    // Broad phase
-    Candidates candidates;
-    construct_collision_candidates(
-        mesh, V0, V1, candidates, /*inflation_radius=*/0, method);
-
-    // Narrow phase
-    double step_size = compute_collision_free_stepsize(
-        candidates, mesh, V0, V1, tolerance, max_iterations);
-
+    // Delegates to the pipelined overload, which overlaps the broad-phase
+    // candidate detection with the narrow-phase CCD.
+    std::unique_ptr<BroadPhase> broad_phase =
+        BroadPhase::make_broad_phase(method);
+    const double step_size = compute_collision_free_stepsize(
+        *broad_phase, mesh, V0, V1, min_distance, tolerance, max_iterations,
+        adaptive_tolerance, budget);
+    broad_phase->clear();
     return step_size;
 }
 
 double compute_collision_free_stepsize(
-    const Candidates& candidates,
+    BroadPhase& broad_phase,
     const CollisionMesh& mesh,
-    const Eigen::MatrixXd& V0,
-    const Eigen::MatrixXd& V1,
+    ConstMatrixXdRef V0,
+    ConstMatrixXdRef V1,
+    const double min_distance,
     const double tolerance,
-    const long max_iterations)
+    const long max_iterations,
+    const bool adaptive_tolerance,
+    CCDBudget* const budget)
 {
     assert(V0.rows() == mesh.num_vertices());
     assert(V1.rows() == mesh.num_vertices());
+
+    // The budget covers the whole call: the state is shared across the
+    // concurrent narrow-phase branches below.
+    std::unique_ptr<CCDBudgetState> budget_state =
+        budget == nullptr ? nullptr
+                          : std::make_unique<CCDBudgetState>(*budget);
+
+    const double step_size = execution_context().run([&]() -> double {
+        broad_phase.can_vertices_collide = mesh.can_collide;
+        broad_phase.edge_length_median_hint = mesh.rest_median_edge_length();
+        broad_phase.build(
+            V0, V1, mesh.edges(), mesh.faces(),
+            /*inflation_radius=*/min_distance / 1.99);
+        // NOTE: Do not clear the broad phase so the caller can reuse it.
+
+        // Scene bounds shared by the narrow-phase branches, so the full
+        // V0 reduction behind the adaptive tolerance floor runs once per
+        // call instead of once per candidate class.
+        SceneBounds scene_bounds;
+        if (adaptive_tolerance) {
+            scene_bounds.ensure(V0);
+        }
+
+        if (V0.cols() == 2) {
+            // Only one candidate class in 2D, so there is nothing to overlap.
+            Candidates candidates;
+            broad_phase.detect_collision_candidates(2, candidates);
+            std::atomic<double> earliest_toi(1);
+            ccd_narrow_phase(
+                candidates, mesh, V0, V1, min_distance, tolerance,
+                max_iterations, adaptive_tolerance, earliest_toi,
+                budget_state.get(), &scene_bounds);
+            return earliest_toi;
+        }
+
+        // Overlap the remaining broad-phase detection with the narrow phase:
+        // CCD over one candidate class starts as soon as its detection
+        // finishes, while the other class is still being detected, hiding
+        // most of the detection latency behind the (far larger) CCD work.
+        // The branches share earliest_toi so tmax pruning crosses classes.
+        std::atomic<double> earliest_toi(1);
+        Candidates ee_candidates, fv_candidates;
+
+        tbb::task_group tasks;
+        tasks.run([&] {
+            broad_phase.detect_edge_edge_candidates(
+                ee_candidates.ee_candidates);
+            ccd_narrow_phase(
+                ee_candidates, mesh, V0, V1, min_distance, tolerance,
+                max_iterations, adaptive_tolerance, earliest_toi,
+                budget_state.get(), &scene_bounds);
+        });
+        tasks.run([&] {
+            broad_phase.detect_face_vertex_candidates(
+                fv_candidates.fv_candidates);
+            ccd_narrow_phase(
+                fv_candidates, mesh, V0, V1, min_distance, tolerance,
+                max_iterations, adaptive_tolerance, earliest_toi,
+                budget_state.get(), &scene_bounds);
+        });
+        tasks.wait();
+
+        assert(earliest_toi >= 0 && earliest_toi <= 1.0);
+        return earliest_toi;
+    });
+
+    if (budget != nullptr) {
+        budget->expired =
+            budget_state->expired.load(std::memory_order_relaxed);
+    }
+    return step_size;
+}
+
+namespace {
+
+/// Order the candidates by a cheap proxy (largest relative displacement of
+/// the involved vertices first) so a candidate with a small toi is likely
+/// processed early; after that, tmax turns most of the remaining candidates
+/// into trivial rejections. When adaptive_tolerance is set, also computes a
+/// per-candidate tolerance scaled to each candidate's own length scale.
+void order_candidates_for_ccd(
+    const Candidates& candidates,
+    const CollisionMesh& mesh,
+    ConstMatrixXdRef V0,
+    ConstMatrixXdRef V1,
+    const double tolerance,
+    const bool adaptive_tolerance,
+    std::vector<std::pair<double, size_t>>& order,
+    std::vector<double>& tolerances,
+    const SceneBounds* const scene_bounds = nullptr)
+{
     const Eigen::MatrixXi& E = mesh.edges();
     const Eigen::MatrixXi& F = mesh.faces();
 
+    const Eigen::VectorXd vertex_disp_sqr =
+        (V1 - V0).rowwise().squaredNorm();
+
+    const size_t num_ev = candidates.ev_candidates.size();
+    const size_t num_ee = candidates.ee_candidates.size();
+
+    // Floor of the per-candidate length scale used to adapt the tolerance;
+    // without it, small slow-moving pairs would be refined far beyond what
+    // the certified bound requires.
+    const double min_tolerance_scale = adaptive_tolerance
+        ? 1e-3
+            * (scene_bounds != nullptr && scene_bounds->valid()
+                   ? scene_bounds->diagonal_length()
+                   : world_bbox_diagonal_length(V0))
+        : 0;
+    tolerances.clear();
+    if (adaptive_tolerance) {
+        tolerances.resize(candidates.size());
+    }
+
+    order.resize(candidates.size());
+    tbb::parallel_for(size_t(0), candidates.size(), [&](size_t i) {
+        std::array<index_t, 4> ids;
+        int n;
+        if (i < num_ev) {
+            const EdgeVertexCandidate& ev = candidates.ev_candidates[i];
+            ids = { { ev.vertex_index, E(ev.edge_index, 0),
+                      E(ev.edge_index, 1) } };
+            n = 3;
+        } else if (i - num_ev < num_ee) {
+            const EdgeEdgeCandidate& ee =
+                candidates.ee_candidates[i - num_ev];
+            ids = { { E(ee.edge0_index, 0), E(ee.edge0_index, 1),
+                      E(ee.edge1_index, 0), E(ee.edge1_index, 1) } };
+            n = 4;
+        } else {
+            const FaceVertexCandidate& fv =
+                candidates.fv_candidates[i - num_ev - num_ee];
+            ids = { { fv.vertex_index, F(fv.face_index, 0),
+                      F(fv.face_index, 1), F(fv.face_index, 2) } };
+            n = 4;
+        }
+
+        double proxy = vertex_disp_sqr(ids[0]);
+        for (int k = 1; k < n; k++) {
+            proxy = std::max(proxy, vertex_disp_sqr(ids[k]));
+        }
+        // Negate so sorting ascending puts the largest displacement first.
+        order[i] = std::make_pair(-proxy, i);
+
+        if (adaptive_tolerance) {
+            // Scale the tolerance by the candidate's own length scale (its
+            // bounding box diagonal plus how far it moves). Tight-Inclusion
+            // stays conservative for any tolerance, so this only trades
+            // unneeded refinement for iterations.
+            Eigen::Vector3d lo = Eigen::Vector3d::Zero();
+            Eigen::Vector3d hi = Eigen::Vector3d::Zero();
+            for (int d = 0; d < V0.cols(); d++) {
+                lo(d) = hi(d) = V0(ids[0], d);
+                for (int k = 1; k < n; k++) {
+                    lo(d) = std::min(lo(d), V0(ids[k], d));
+                    hi(d) = std::max(hi(d), V0(ids[k], d));
+                }
+            }
+            const double scale = (hi - lo).norm() + std::sqrt(proxy);
+            tolerances[i] =
+                tolerance * std::max(scale, min_tolerance_scale);
+        }
+    });
+    tbb::parallel_sort(order.begin(), order.end());
+}
+
+/// Run the i-th packed query through the matching narrow-phase kernel,
+/// reading the eight endpoints from the candidate's contiguous record
+/// instead of gathering scattered rows of the vertex matrices.
+bool ccd_from_packed(
+    const PackedCCDQueries& queries,
+    const size_t i,
+    double& toi,
+    const double min_distance,
+    const double tmax,
+    const double tolerance,
+    const long max_iterations)
+{
+    const double* q = queries.query(i);
+    // Slots 0..3 are the vertices at t=0, slots 4..7 the same vertices at
+    // t=1, in kernel argument order.
+    const auto vert3 = [q](const int k) {
+        return Eigen::Vector3d(q[3 * k], q[3 * k + 1], q[3 * k + 2]);
+    };
+
+    if (i < queries.num_ev) {
+        if (queries.dim == 2) {
+            const auto vert2 = [q](const int k) {
+                return Eigen::Vector2d(q[3 * k], q[3 * k + 1]);
+            };
+            return point_edge_ccd_2D(
+                vert2(0), vert2(1), vert2(2), vert2(4), vert2(5), vert2(6),
+                toi, min_distance, tmax, tolerance, max_iterations);
+        }
+        return point_edge_ccd_3D(
+            vert3(0), vert3(1), vert3(2), vert3(4), vert3(5), vert3(6), toi,
+            min_distance, tmax, tolerance, max_iterations);
+    }
+    if (i < queries.num_ev + queries.num_ee) {
+        return edge_edge_ccd(
+            vert3(0), vert3(1), vert3(2), vert3(3), vert3(4), vert3(5),
+            vert3(6), vert3(7), toi, min_distance, tmax, tolerance,
+            max_iterations);
+    }
+    return point_triangle_ccd(
+        vert3(0), vert3(1), vert3(2), vert3(3), vert3(4), vert3(5), vert3(6),
+        vert3(7), toi, min_distance, tmax, tolerance, max_iterations);
+}
+
+/// Narrow-phase CCD over a candidate set, folding each hit into a shared
+/// earliest toi. The atomic is shared so concurrent callers (see the
+/// pipelined compute_collision_free_stepsize overloads) prune against each
+/// other's tmax.
+void ccd_narrow_phase(
+    const Candidates& candidates,
+    const CollisionMesh& mesh,
+    ConstMatrixXdRef V0,
+    ConstMatrixXdRef V1,
+    const double min_distance,
+    const double tolerance,
+    const long max_iterations,
+    const bool adaptive_tolerance,
+    std::atomic<double>& earliest_toi,
+    CCDBudgetState* const budget_state,
+    const SceneBounds* const scene_bounds)
+{
     if (candidates.empty()) {
-        return 1; // No possible collisions, so can take full step.
+        return;
     }
 
-    double earliest_toi = 1;
-    std::mutex earliest_toi_mutex;
+    std::vector<std::pair<double, size_t>> order;
+    std::vector<double> tolerances;
+    order_candidates_for_ccd(
+        candidates, mesh, V0, V1, tolerance, adaptive_tolerance, order,
+        tolerances, scene_bounds);
+
+    // Pre-gather stage: pack every candidate's (t0, t1) coordinates into
+    // one contiguous record, so both the conservative screening below and
+    // the Tight-Inclusion calls stream packed records instead of gathering
+    // eight scattered rows of V0/V1 per query.
+    CandidatesSoA candidates_soa;
+    candidates_soa.build(candidates);
+    PackedCCDQueries packed_queries;
+    packed_queries.build(candidates_soa, mesh, V0, V1);
+
+    // Batched conservative screening: compute a lower bound on every
+    // candidate's toi up front; once earliest_toi shrinks, candidates whose
+    // bound is not smaller are rejected without a Tight-Inclusion call.
+    std::vector<double> toi_lower_bounds;
+    ccd_toi_lower_bounds(packed_queries, toi_lower_bounds, min_distance);
+
+    // Narrow-phase costs are wildly heterogeneous and the candidates are
+    // ordered most-expensive first, so the default partitioner's large
+    // initial chunks hand one thread the whole expensive head and leave the
+    // rest idle (long-tail stragglers). Slice the range into many more
+    // chunks than threads so the cost clusters spread across workers.
+    const size_t num_chunks = std::min<size_t>(
+        16 * tbb::this_task_arena::max_concurrency(), candidates.size());
+    const size_t grain =
+        std::max(size_t(1), candidates.size() / num_chunks);
 
     tbb::parallel_for(
-        tbb::blocked_range<size_t>(0, candidates.size()),
+        tbb::blocked_range<size_t>(0, candidates.size(), grain),
         [&](tbb::blocked_range<size_t> r) {
-            for (size_t i = r.begin(); i < r.end(); i++) {
-                // Use the mutex to read as well in case writing double takes
-                // more than one clock cycle.
-                double tmax;
-                {
-                    std::scoped_lock<std::mutex> lock(earliest_toi_mutex);
-                    tmax = earliest_toi;
+            for (size_t j = r.begin(); j < r.end(); j++) {
+                const size_t i = order[j].second;
+                // A stale tmax only makes the narrow phase do extra
+                // work; it cannot change the minimum.
+                const double tmax =
+                    earliest_toi.load(std::memory_order_relaxed);
+
+                if (toi_lower_bounds[i] >= tmax) {
+                    continue; // Cannot produce an earlier toi.
                 }
 
-                double toi = std::numeric_limits<double>::infinity(); // output
-                bool are_colliding = candidates[i].ccd(
-                    V0, V1, E, F, toi, tmax, tolerance, max_iterations);
+                if (budget_state != nullptr
+                    && !budget_state->charge_query()) {
+                    // Budget expired: fall back to the certified
+                    // conservative bound. The bound certifies the candidate
+                    // root free on [0, bound), so a rescaled bound is a safe
+                    // (if suboptimal) step; the rescaling mirrors
+                    // DEFAULT_CCD_CONSERVATIVE_RESCALING to avoid stepping
+                    // exactly to the certificate's edge.
+                    const double safe_toi =
+                        DEFAULT_CCD_CONSERVATIVE_RESCALING
+                        * toi_lower_bounds[i];
+                    double current =
+                        earliest_toi.load(std::memory_order_relaxed);
+                    while (safe_toi < current
+                           && !earliest_toi.compare_exchange_weak(
+                               current, safe_toi,
+                               std::memory_order_relaxed)) {
+                    }
+                    continue;
+                }
+
+                // output of the ccd call
+                double toi = std::numeric_limits<double>::infinity();
+                bool are_colliding = ccd_from_packed(
+                    packed_queries, i, toi, min_distance, tmax,
+                    adaptive_tolerance ? tolerances[i] : tolerance,
+                    max_iterations);
 
                 if (are_colliding) {
-                    std::scoped_lock<std::mutex> lock(earliest_toi_mutex);
-                    if (toi < earliest_toi) {
-                        earliest_toi = toi;
+                    // Compare-exchange min of earliest_toi and toi.
+                    double current =
+                        earliest_toi.load(std::memory_order_relaxed);
+                    while (toi < current
+                           && !earliest_toi.compare_exchange_weak(
+                               current, toi, std::memory_order_relaxed)) {
                     }
                 }
             }
-        });
+        },
+        tbb::simple_partitioner());
+}
+
+} // namespace
+
+double compute_collision_free_stepsize(
+    const Candidates& candidates,
+    const CollisionMesh& mesh,
+    ConstMatrixXdRef V0,
+    ConstMatrixXdRef V1,
+    const double min_distance,
+    const double tolerance,
+    const long max_iterations,
+    const bool adaptive_tolerance,
+    CCDBudget* const budget)
+{
+    assert(V0.rows() == mesh.num_vertices());
+    assert(V1.rows() == mesh.num_vertices());
+
+    if (candidates.empty()) {
+        if (budget != nullptr) {
+            budget->expired = false;
+        }
+        return 1; // No possible collisions, so can take full step.
+    }
+
+    std::unique_ptr<CCDBudgetState> budget_state =
+        budget == nullptr ? nullptr
+                          : std::make_unique<CCDBudgetState>(*budget);
+
+    const double step_size = execution_context().run([&]() -> double {
+        std::atomic<double> earliest_toi(1);
+        ccd_narrow_phase(
+            candidates, mesh, V0, V1, min_distance, tolerance, max_iterations,
+            adaptive_tolerance, earliest_toi, budget_state.get());
+        assert(earliest_toi >= 0 && earliest_toi <= 1.0);
+        return earliest_toi;
+    });
+
+    if (budget != nullptr) {
+        budget->expired =
+            budget_state->expired.load(std::memory_order_relaxed);
+    }
+    return step_size;
+}
+
+void CCDContext::build(
+    const CollisionMesh& mesh,
+    ConstMatrixXdRef V0,
+    ConstMatrixXdRef V1,
+    const double min_distance,
+    const BroadPhaseMethod method,
+    const double tolerance,
+    const long max_iterations,
+    const bool adaptive_tolerance)
+{
+    IPC_PROFILE_SCOPE("CCDContext::build");
+
+    assert(V0.rows() == mesh.num_vertices());
+    assert(V1.rows() == mesh.num_vertices());
+
+    m_V0 = V0;
+    m_V1 = V1;
+    m_min_distance = min_distance;
+    m_tolerance = tolerance;
+    m_max_iterations = max_iterations;
+    m_adaptive_tolerance = adaptive_tolerance;
+
+    m_candidates.clear();
+    construct_collision_candidates(
+        mesh, m_V0, m_V1, m_candidates,
+        /*inflation_radius=*/min_distance / 1.99, method);
+
+    // The scene bounds (feeding the adaptive tolerance floor) are fixed for
+    // the direction, so they are computed once here and reused by every
+    // trial step.
+    m_scene_bounds.invalidate();
+    if (adaptive_tolerance) {
+        m_scene_bounds.ensure(m_V0);
+    }
+
+    execution_context().run([&]() {
+        order_candidates_for_ccd(
+            m_candidates, mesh, m_V0, m_V1, tolerance, adaptive_tolerance,
+            m_order, m_tolerances, &m_scene_bounds);
+
+        // Pack the query coordinates once per direction; the records stay
+        // valid for every trial step because the endpoints are fixed.
+        CandidatesSoA candidates_soa;
+        candidates_soa.build(m_candidates);
+        m_packed_queries.build(candidates_soa, mesh, m_V0, m_V1);
+
+        // Seed the certified root-free times with the batched conservative
+        // lower bounds; queries only ever grow these certificates.
+        ccd_toi_lower_bounds(m_packed_queries, m_safe_toi, min_distance);
+    });
+
+    m_toi.assign(
+        m_candidates.size(), std::numeric_limits<double>::infinity());
+}
 
-    assert(earliest_toi >= 0 && earliest_toi <= 1.0);
-    return earliest_toi;
+double CCDContext::compute_collision_free_stepsize(
+    const CollisionMesh& mesh, const double step_scale)
+{
+    IPC_PROFILE_SCOPE("CCDContext::compute_collision_free_stepsize");
+
+    assert(step_scale > 0 && step_scale <= 1);
+    assert(m_V0.rows() == mesh.num_vertices());
+
+    if (m_candidates.empty()) {
+        return 1; // No possible collisions, so can take full step.
+    }
+
+    return execution_context().run([&]() -> double {
+        // Earliest toi in the full direction's parameterization. Anything
+        // at or past step_scale cannot shorten this trial step, so the
+        // trial's scale doubles as the initial tmax.
+        std::atomic<double> earliest_toi(step_scale);
+
+        tbb::parallel_for(
+            tbb::blocked_range<size_t>(0, m_candidates.size()),
+            [&](tbb::blocked_range<size_t> r) {
+                for (size_t j = r.begin(); j < r.end(); j++) {
+                    const size_t i = m_order[j].second;
+                    // A stale tmax only makes the narrow phase do extra
+                    // work; it cannot change the minimum.
+                    const double tmax =
+                        earliest_toi.load(std::memory_order_relaxed);
+
+                    double toi = m_toi[i];
+                    if (!std::isfinite(toi)) {
+                        if (m_safe_toi[i] >= tmax) {
+                            continue; // Certified root free before tmax.
+                        }
+
+                        // The cached certificate does not cover this trial,
+                        // so the query has to be re-run. Each index appears
+                        // once in m_order, so the cache slots are written
+                        // without contention.
+                        const bool are_colliding = ccd_from_packed(
+                            m_packed_queries, i, toi, m_min_distance, tmax,
+                            m_adaptive_tolerance ? m_tolerances[i]
+                                                 : m_tolerance,
+                            m_max_iterations);
+                        if (!are_colliding) {
+                            m_safe_toi[i] = std::max(m_safe_toi[i], tmax);
+                            continue;
+                        }
+                        // The root is in the full direction's time scale, so
+                        // it rescales to any later trial without a re-run.
+                        m_toi[i] = toi;
+                    } else if (toi >= tmax) {
+                        continue;
+                    }
+
+                    // Compare-exchange min of earliest_toi and toi.
+                    double current =
+                        earliest_toi.load(std::memory_order_relaxed);
+                    while (toi < current
+                           && !earliest_toi.compare_exchange_weak(
+                               current, toi, std::memory_order_relaxed)) {
+                    }
+                }
+            });
+
+        // Map the earliest toi back onto the trial's parameterization.
+        return std::min(1.0, earliest_toi.load() / step_scale);
+    });
+}
+
+double compute_collision_free_stepsize_gpu(
+    const Candidates& candidates,
+    const CollisionMesh& mesh,
+    ConstMatrixXdRef V0,
+    ConstMatrixXdRef V1,
+    const double min_distance,
+    const double tolerance,
+    const long max_iterations)
+{
+#ifdef IPC_TOOLKIT_WITH_CUDA
+    assert(V0.rows() == mesh.num_vertices());
+    assert(V1.rows() == mesh.num_vertices());
+    const Eigen::MatrixXi& E = mesh.edges();
+    const Eigen::MatrixXi& F = mesh.faces();
+
+    if (candidates.empty()) {
+        return 1; // No possible collisions, so can take full step.
+    }
+
+    // The GPU narrow phase runs its own sweep over the boxes it is given, so
+    // restrict the mesh to the primitives referenced by the candidate set:
+    // the sweep then only processes pairs the caller's broad phase already
+    // deemed close, while every candidate pair is retained.
+    std::vector<bool> vertex_used(V0.rows(), false);
+    std::vector<bool> edge_used(E.rows(), false);
+    std::vector<bool> face_used(F.rows(), false);
+    for (const EdgeVertexCandidate& ev : candidates.ev_candidates) {
+        vertex_used[ev.vertex_index] = true;
+        edge_used[ev.edge_index] = true;
+    }
+    for (const EdgeEdgeCandidate& ee : candidates.ee_candidates) {
+        edge_used[ee.edge0_index] = true;
+        edge_used[ee.edge1_index] = true;
+    }
+    for (const FaceVertexCandidate& fv : candidates.fv_candidates) {
+        vertex_used[fv.vertex_index] = true;
+        face_used[fv.face_index] = true;
+    }
+    for (long e = 0; e < E.rows(); e++) {
+        if (edge_used[e]) {
+            vertex_used[E(e, 0)] = vertex_used[E(e, 1)] = true;
+        }
+    }
+    for (long f = 0; f < F.rows(); f++) {
+        if (face_used[f]) {
+            vertex_used[F(f, 0)] = true;
+            vertex_used[F(f, 1)] = true;
+            vertex_used[F(f, 2)] = true;
+        }
+    }
+
+    std::vector<long> vertex_map(V0.rows(), -1);
+    long num_used_vertices = 0;
+    for (long v = 0; v < V0.rows(); v++) {
+        if (vertex_used[v]) {
+            vertex_map[v] = num_used_vertices++;
+        }
+    }
+
+    Eigen::MatrixXd V0_sub(num_used_vertices, V0.cols());
+    Eigen::MatrixXd V1_sub(num_used_vertices, V1.cols());
+    for (long v = 0; v < V0.rows(); v++) {
+        if (vertex_used[v]) {
+            V0_sub.row(vertex_map[v]) = V0.row(v);
+            V1_sub.row(vertex_map[v]) = V1.row(v);
+        }
+    }
+
+    const long num_used_edges =
+        std::count(edge_used.begin(), edge_used.end(), true);
+    Eigen::MatrixXi E_sub(num_used_edges, E.cols());
+    for (long e = 0, se = 0; e < E.rows(); e++) {
+        if (edge_used[e]) {
+            E_sub(se, 0) = vertex_map[E(e, 0)];
+            E_sub(se, 1) = vertex_map[E(e, 1)];
+            se++;
+        }
+    }
+
+    const long num_used_faces =
+        std::count(face_used.begin(), face_used.end(), true);
+    Eigen::MatrixXi F_sub(num_used_faces, F.cols());
+    for (long f = 0, sf = 0; f < F.rows(); f++) {
+        if (face_used[f]) {
+            F_sub(sf, 0) = vertex_map[F(f, 0)];
+            F_sub(sf, 1) = vertex_map[F(f, 1)];
+            F_sub(sf, 2) = vertex_map[F(f, 2)];
+            sf++;
+        }
+    }
+
+    const double step_size = ccd::gpu::compute_toi_strategy(
+        V0_sub, V1_sub, E_sub, F_sub, max_iterations, min_distance, tolerance);
+    if (step_size < 1.0) {
+        return 0.8 * step_size;
+    }
+    return 1.0;
+#else
+    throw std::runtime_error(
+        "GPU batch CCD is disabled because CUDA is disabled!");
+#endif
+}
+
+void PackedCCDQueries::build(
+    const CandidatesSoA& candidates,
+    const CollisionMesh& mesh,
+    ConstMatrixXdRef V0,
+    ConstMatrixXdRef V1)
+{
+    const Eigen::MatrixXi& E = mesh.edges();
+    const Eigen::MatrixXi& F = mesh.faces();
+
+    num_ev = candidates.ev_edges.size();
+    num_ee = candidates.ee_edges0.size();
+    num_fv = candidates.fv_faces.size();
+    dim = V0.cols();
+
+    // Zero-fill so the padding coordinates of the records are defined.
+    data.assign(size() * QUERY_STRIDE, 0.0);
+
+    // One O(n) transpose per build so the per-candidate packing below reads
+    // contiguous per-axis arrays instead of gathering through the matrices'
+    // run-time strides.
+    m_positions_t0.update(V0);
+    m_positions_t1.update(V1);
+
+    const auto pack = [&](double* q, const int slot, const long vi) {
+        for (int d = 0; d < dim; d++) {
+            q[3 * slot + d] = m_positions_t0(vi, d);
+            q[3 * (QUERY_VERTICES + slot) + d] = m_positions_t1(vi, d);
+        }
+    };
+
+    tbb::parallel_for(size_t(0), num_ev, [&](size_t i) {
+        double* q = data.data() + i * QUERY_STRIDE;
+        pack(q, 0, candidates.ev_vertices[i]);
+        pack(q, 1, E(candidates.ev_edges[i], 0));
+        pack(q, 2, E(candidates.ev_edges[i], 1));
+    });
+
+    tbb::parallel_for(size_t(0), num_ee, [&](size_t i) {
+        double* q = data.data() + (num_ev + i) * QUERY_STRIDE;
+        pack(q, 0, E(candidates.ee_edges0[i], 0));
+        pack(q, 1, E(candidates.ee_edges0[i], 1));
+        pack(q, 2, E(candidates.ee_edges1[i], 0));
+        pack(q, 3, E(candidates.ee_edges1[i], 1));
+    });
+
+    tbb::parallel_for(size_t(0), num_fv, [&](size_t i) {
+        double* q = data.data() + (num_ev + num_ee + i) * QUERY_STRIDE;
+        pack(q, 0, candidates.fv_vertices[i]);
+        pack(q, 1, F(candidates.fv_faces[i], 0));
+        pack(q, 2, F(candidates.fv_faces[i], 1));
+        pack(q, 3, F(candidates.fv_faces[i], 2));
+    });
+}
+
+void PackedCCDQueries::clear()
+{
+    num_ev = num_ee = num_fv = 0;
+    data.clear();
+}
+
+void ccd_toi_lower_bounds(
+    const CandidatesSoA& candidates,
+    const CollisionMesh& mesh,
+    ConstMatrixXdRef V0,
+    ConstMatrixXdRef V1,
+    std::vector<double>& toi_lower_bounds,
+    const double min_distance)
+{
+    PackedCCDQueries queries;
+    queries.build(candidates, mesh, V0, V1);
+    ccd_toi_lower_bounds(queries, toi_lower_bounds, min_distance);
+}
+
+void ccd_toi_lower_bounds(
+    const PackedCCDQueries& queries,
+    std::vector<double>& toi_lower_bounds,
+    const double min_distance)
+{
+    const int dim = queries.dim;
+    toi_lower_bounds.resize(queries.size());
+
+    // The distance between the two primitives starts at least at the largest
+    // axis-aligned gap between their vertex bounds and can shrink no faster
+    // than the sum of the two sides' largest displacements, so the minimum
+    // separation used by the narrow phase (a conservative_rescaling fraction
+    // of the initial distance) cannot be reached before
+    // conservative_rescaling * gap / closing speed. Each record holds side
+    // A's slots first, so the sides are the slot ranges [0, na) and
+    // [na, na + nb).
+    const auto toi_lower_bound = [&](const double* q, const int na,
+                                     const int nb) {
+        constexpr int T1 = 3 * PackedCCDQueries::QUERY_VERTICES;
+
+        const auto max_disp = [&](const int begin, const int n) {
+            double max_d = 0;
+            for (int k = begin; k < begin + n; k++) {
+                double d_sqr = 0;
+                for (int d = 0; d < dim; d++) {
+                    const double delta = q[T1 + 3 * k + d] - q[3 * k + d];
+                    d_sqr += delta * delta;
+                }
+                max_d = std::max(max_d, d_sqr);
+            }
+            return std::sqrt(max_d);
+        };
+
+        double gap = 0;
+        for (int d = 0; d < dim; d++) {
+            double lo_a = q[d], hi_a = lo_a;
+            for (int k = 1; k < na; k++) {
+                lo_a = std::min(lo_a, q[3 * k + d]);
+                hi_a = std::max(hi_a, q[3 * k + d]);
+            }
+            double lo_b = q[3 * na + d], hi_b = lo_b;
+            for (int k = na + 1; k < na + nb; k++) {
+                lo_b = std::min(lo_b, q[3 * k + d]);
+                hi_b = std::max(hi_b, q[3 * k + d]);
+            }
+            gap = std::max({ gap, lo_b - hi_a, lo_a - hi_b });
+        }
+
+        // Only the part of the gap above the minimum separation must be
+        // closed before the narrow phase can report an impact.
+        gap = std::max(gap - min_distance, 0.0);
+
+        const double closing_speed = max_disp(0, na) + max_disp(na, nb);
+        if (closing_speed == 0) {
+            // No relative motion: the pair can never produce an earlier toi
+            // unless the primitives already overlap along every axis.
+            return gap > 0 ? std::numeric_limits<double>::infinity() : 0.0;
+        }
+        return DEFAULT_CCD_CONSERVATIVE_RESCALING * gap / closing_speed;
+    };
+
+    tbb::parallel_for(size_t(0), queries.num_ev, [&](size_t i) {
+        toi_lower_bounds[i] = toi_lower_bound(queries.query(i), 1, 2);
+    });
+
+    tbb::parallel_for(size_t(0), queries.num_ee, [&](size_t i) {
+        toi_lower_bounds[queries.num_ev + i] =
+            toi_lower_bound(queries.query(queries.num_ev + i), 2, 2);
+    });
+
+    tbb::parallel_for(size_t(0), queries.num_fv, [&](size_t i) {
+        const size_t j = queries.num_ev + queries.num_ee + i;
+        toi_lower_bounds[j] = toi_lower_bound(queries.query(j), 1, 3);
+    });
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -354,11 +2193,26 @@ double compute_collision_free_stepsize(
 // NOTE: Actually distance squared
 double compute_minimum_distance(
     const CollisionMesh& mesh,
-    const Eigen::MatrixXd& V,
+    ConstMatrixXdRef V,
     const Constraints& constraint_set)
+{
+    std::vector<std::pair<size_t, double>> closest_pairs;
+    return compute_minimum_distance(
+        mesh, V, constraint_set, /*k=*/0, closest_pairs);
+}
+
+// NOTE: Actually distance squared
+double compute_minimum_distance(
+    const CollisionMesh& mesh,
+    ConstMatrixXdRef V,
+    const Constraints& constraint_set,
+    const int k,
+    std::vector<std::pair<size_t, double>>& closest_pairs)
 {
     assert(V.rows() == mesh.num_vertices());
 
+    closest_pairs.clear();
+
     if (constraint_set.empty()) {
         return std::numeric_limits<double>::infinity();
     }
@@ -366,88 +2220,182 @@ double compute_minimum_distance(
     const Eigen::MatrixXi& E = mesh.edges();
     const Eigen::MatrixXi& F = mesh.faces();
 
-    tbb::enumerable_thread_specific<double> storage(
-        std::numeric_limits<double>::infinity());
-
-    // Do a single block range over all constraint vectors
-    tbb::parallel_for(
-        tbb::blocked_range<size_t>(0, constraint_set.size()),
-        [&](tbb::blocked_range<size_t> r) {
-            double& local_min_dist = storage.local();
-
-            for (size_t i = r.begin(); i < r.end(); i++) {
-                const double dist = constraint_set[i].compute_distance(V, E, F);
+    // Per-thread reduction state: the running minimum and, if requested, a
+    // max-heap of the k closest pairs seen so far (the k-th closest on top,
+    // so it is evicted first).
+    struct LocalReduction {
+        double min_dist = std::numeric_limits<double>::infinity();
+        std::vector<std::pair<double, size_t>> heap;
+    };
+
+    return execution_context().run([&]() -> double {
+        tbb::enumerable_thread_specific<LocalReduction> storage;
+
+        // Do a single block range over all constraint vectors
+        tbb::parallel_for(
+            tbb::blocked_range<size_t>(0, constraint_set.size()),
+            [&](tbb::blocked_range<size_t> r) {
+                LocalReduction& local = storage.local();
+
+                for (size_t i = r.begin(); i < r.end(); i++) {
+                    const double dist =
+                        constraint_set[i].compute_distance(V, E, F);
+
+                    if (dist < local.min_dist) {
+                        local.min_dist = dist;
+                    }
 
-                if (dist < local_min_dist) {
-                    local_min_dist = dist;
+                    if (k > 0
+                        && (local.heap.size() < size_t(k)
+                            || dist < local.heap.front().first)) {
+                        if (local.heap.size() == size_t(k)) {
+                            std::pop_heap(
+                                local.heap.begin(), local.heap.end());
+                            local.heap.pop_back();
+                        }
+                        local.heap.emplace_back(dist, i);
+                        std::push_heap(local.heap.begin(), local.heap.end());
+                    }
                 }
+            });
+
+        double min_dist = std::numeric_limits<double>::infinity();
+        std::vector<std::pair<double, size_t>> merged;
+        for (const LocalReduction& local : storage) {
+            min_dist = std::min(min_dist, local.min_dist);
+            merged.insert(
+                merged.end(), local.heap.begin(), local.heap.end());
+        }
+
+        if (k > 0) {
+            // Sorting by (distance, index) makes the report deterministic
+            // regardless of how TBB split the range.
+            std::sort(merged.begin(), merged.end());
+            if (merged.size() > size_t(k)) {
+                merged.resize(k);
             }
-        });
+            closest_pairs.reserve(merged.size());
+            for (const auto& [dist, i] : merged) {
+                closest_pairs.emplace_back(i, dist);
+            }
+        }
 
-    double min_dist = std::numeric_limits<double>::infinity();
-    for (const auto& local_min_dist : storage) {
-        min_dist = std::min(min_dist, local_min_dist);
-    }
-    return min_dist;
+        return min_dist;
+    });
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
 bool has_intersections(
     const CollisionMesh& mesh,
-    const Eigen::MatrixXd& V,
-    const BroadPhaseMethod method)
+    ConstMatrixXdRef V,
+    const BroadPhaseMethod method,
+    SceneBounds* const scene_bounds)
 {
     assert(V.rows() == mesh.num_vertices());
-    const Eigen::MatrixXi& E = mesh.edges();
-    const Eigen::MatrixXi& F = mesh.faces();
 
-    const double conservative_inflation_radius =
-        1e-6 * world_bbox_diagonal_length(V);
+    const double conservative_inflation_radius = 1e-6
+        * (scene_bounds != nullptr
+               ? scene_bounds->ensure(V).diagonal_length()
+               : world_bbox_diagonal_length(V));
 
-    // TODO: Expose the broad-phase method
     std::unique_ptr<BroadPhase> broad_phase =
         BroadPhase::make_broad_phase(method);
     broad_phase->can_vertices_collide = mesh.can_collide;
+    broad_phase->edge_length_median_hint = mesh.rest_median_edge_length();
 
-    broad_phase->build(V, E, F, conservative_inflation_radius);
+    broad_phase->build(
+        V, mesh.edges(), mesh.faces(), conservative_inflation_radius);
 
-    if (V.cols() == 2) { // Need to check segment-segment intersections in 2D
-        std::vector<EdgeEdgeCandidate> ee_candidates;
+    const bool is_intersecting = has_intersections(*broad_phase, mesh, V);
 
-        broad_phase->detect_edge_edge_candidates(ee_candidates);
-        broad_phase->clear();
+    broad_phase->clear();
 
-        // narrow-phase using igl
-        igl::predicates::exactinit();
-        for (const EdgeEdgeCandidate& ee_candidate : ee_candidates) {
-            if (igl::predicates::segment_segment_intersect(
-                    V.row(E(ee_candidate.edge0_index, 0)).head<2>(),
-                    V.row(E(ee_candidate.edge0_index, 1)).head<2>(),
-                    V.row(E(ee_candidate.edge1_index, 0)).head<2>(),
-                    V.row(E(ee_candidate.edge1_index, 1)).head<2>())) {
-                return true;
-            }
-        }
-    } else { // Need to check segment-triangle intersections in 3D
-        assert(V.cols() == 3);
-
-        std::vector<EdgeFaceCandidate> ef_candidates;
-        broad_phase->detect_edge_face_candidates(ef_candidates);
-        broad_phase->clear();
-
-        for (const EdgeFaceCandidate& ef_candidate : ef_candidates) {
-            if (is_edge_intersecting_triangle(
-                    V.row(E(ef_candidate.edge_index, 0)),
-                    V.row(E(ef_candidate.edge_index, 1)),
-                    V.row(F(ef_candidate.face_index, 0)),
-                    V.row(F(ef_candidate.face_index, 1)),
-                    V.row(F(ef_candidate.face_index, 2)))) {
-                return true;
-            }
+    return is_intersecting;
+}
+
+bool has_intersections(
+    BroadPhase& broad_phase,
+    const CollisionMesh& mesh,
+    ConstMatrixXdRef V)
+{
+    assert(V.rows() == mesh.num_vertices());
+    const Eigen::MatrixXi& E = mesh.edges();
+    const Eigen::MatrixXi& F = mesh.faces();
+
+    return execution_context().run([&]() -> bool {
+        // The candidates are independent, so the narrow phase runs in parallel
+        // with a shared flag for early exit.
+        std::atomic<bool> is_intersecting(false);
+
+        // Need to check segment-segment intersections in 2D
+        if (V.cols() == 2) {
+            std::vector<EdgeEdgeCandidate> ee_candidates;
+            broad_phase.detect_edge_edge_candidates(ee_candidates);
+
+            // narrow-phase using igl
+            igl::predicates::exactinit();
+            tbb::parallel_for(
+                tbb::blocked_range<size_t>(0, ee_candidates.size()),
+                [&](const tbb::blocked_range<size_t>& r) {
+                    for (size_t i = r.begin(); i < r.end(); i++) {
+                        if (is_intersecting.load(std::memory_order_relaxed)) {
+                            return;
+                        }
+                        const EdgeEdgeCandidate& ee_candidate =
+                            ee_candidates[i];
+                        if (igl::predicates::segment_segment_intersect(
+                                V.row(E(ee_candidate.edge0_index, 0)).head<2>(),
+                                V.row(E(ee_candidate.edge0_index, 1)).head<2>(),
+                                V.row(E(ee_candidate.edge1_index, 0)).head<2>(),
+                                V.row(E(ee_candidate.edge1_index, 1))
+                                    .head<2>())) {
+                            is_intersecting = true;
+                            return;
+                        }
+                    }
+                });
+        } else { // Need to check segment-triangle intersections in 3D
+            assert(V.cols() == 3);
+
+            std::vector<EdgeFaceCandidate> ef_candidates;
+            broad_phase.detect_edge_face_candidates(ef_candidates);
+
+            // Process the candidates in batches so the orientation
+            // determinants vectorize across a batch; the early exit is
+            // checked once per batch instead of once per candidate.
+            constexpr size_t BATCH_SIZE = 1024;
+            tbb::parallel_for(
+                tbb::blocked_range<size_t>(
+                    0, ef_candidates.size(), BATCH_SIZE),
+                [&](const tbb::blocked_range<size_t>& r) {
+                    if (is_intersecting.load(std::memory_order_relaxed)) {
+                        return;
+                    }
+
+                    const Eigen::Index m = Eigen::Index(r.end() - r.begin());
+                    Eigen::MatrixXd e0(m, 3), e1(m, 3);
+                    Eigen::MatrixXd t0(m, 3), t1(m, 3), t2(m, 3);
+                    for (Eigen::Index k = 0; k < m; k++) {
+                        const EdgeFaceCandidate& ef_candidate =
+                            ef_candidates[r.begin() + k];
+                        e0.row(k) = V.row(E(ef_candidate.edge_index, 0));
+                        e1.row(k) = V.row(E(ef_candidate.edge_index, 1));
+                        t0.row(k) = V.row(F(ef_candidate.face_index, 0));
+                        t1.row(k) = V.row(F(ef_candidate.face_index, 1));
+                        t2.row(k) = V.row(F(ef_candidate.face_index, 2));
+                    }
+
+                    ArrayXb batch_is_intersecting;
+                    are_edges_intersecting_triangles(
+                        e0, e1, t0, t1, t2, batch_is_intersecting);
+                    if (batch_is_intersecting.any()) {
+                        is_intersecting = true;
+                    }
+                });
         }
-    }
 
-    return false;
+        return is_intersecting;
+    });
 }
 } // namespace ipc
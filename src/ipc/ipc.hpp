@@ -5,10 +5,19 @@
 #include <ipc/friction/friction.hpp>
 #include <ipc/broad_phase/broad_phase.hpp>
 #include <ipc/collision_mesh.hpp>
+#include <ipc/utils/eigen_ext.hpp>
+#include <ipc/utils/block_sparse_matrix.hpp>
+#include <ipc/utils/hessian_assembly_cache.hpp>
+#include <ipc/utils/scene_bounds.hpp>
+#include <ipc/utils/shape_derivative_assembly_cache.hpp>
+#include <ipc/utils/positions_soa.hpp>
+#include <ipc/utils/workspace.hpp>
 
 #include <Eigen/Core>
 #include <Eigen/Sparse>
 
+#include <limits>
+
 /// Incremental Potential Contact functions
 namespace ipc {
 
@@ -20,11 +29,34 @@ namespace ipc {
 /// @returns The sum of all barrier potentials (not scaled by the barrier stiffness).
 double compute_barrier_potential(
     const CollisionMesh& mesh,
-    const Eigen::MatrixXd& V,
+    ConstMatrixXdRef V,
     const Constraints& constraint_set,
     const double dhat);
 
+/// @brief Compute the barrier potential and the minimum distance in one pass
+/// over the constraint set.
+///
+/// The potential evaluation has every constraint distance in hand, so
+/// tracking the running minimum here saves the extra constraint-set
+/// traversal of compute_minimum_distance (e.g. per stiffness update).
+/// @param[in] mesh The collision mesh.
+/// @param[in] V Vertices of the collision mesh.
+/// @param[in] constraint_set The set of constraints.
+/// @param[in] dhat The activation distance of the barrier.
+/// @param[out] minimum_distance The minimum distance (squared) between any two elements.
+/// @returns The sum of all barrier potentials (not scaled by the barrier stiffness).
+double compute_barrier_potential(
+    const CollisionMesh& mesh,
+    ConstMatrixXdRef V,
+    const Constraints& constraint_set,
+    const double dhat,
+    double& minimum_distance);
+
 /// @brief Compute the gradient of the barrier potential.
+///
+/// The gradient is in collision-mesh DOFs; callers that need full-mesh
+/// DOFs apply CollisionMesh::to_full_dof(), and callers owning their own
+/// reduction maps can consume it directly.
 /// @param[in] mesh The collision mesh.
 /// @param[in] V Vertices of the collision mesh.
 /// @param[in] constraint_set The set of constraints.
@@ -32,24 +64,306 @@ double compute_barrier_potential(
 /// @returns The gradient of all barrier potentials (not scaled by the barrier stiffness). This will have a size of |V|.
 Eigen::VectorXd compute_barrier_potential_gradient(
     const CollisionMesh& mesh,
-    const Eigen::MatrixXd& V,
+    ConstMatrixXdRef V,
     const Constraints& constraint_set,
     const double dhat);
 
 /// @brief Compute the hessian of the barrier potential.
+///
+/// Like the gradient, the hessian is in collision-mesh DOFs; mapping to
+/// the full mesh is the caller's opt-in via CollisionMesh::to_full_dof()
+/// (with a DofMapProductCache when handing off one hessian per iteration).
+/// @param[in] mesh The collision mesh.
+/// @param[in] V Vertices of the collision mesh.
+/// @param[in] constraint_set The set of constraints.
+/// @param[in] dhat The activation distance of the barrier.
+/// @param[in] project_hessian_to_psd Make sure the hessian is positive semi-definite.
+/// @returns The hessian of all barrier potentials (not scaled by the barrier stiffness). This will have a size of |V|x|V|.
+Eigen::SparseMatrix<double> compute_barrier_potential_hessian(
+    const CollisionMesh& mesh,
+    ConstMatrixXdRef V,
+    const Constraints& constraint_set,
+    const double dhat,
+    const bool project_hessian_to_psd = true);
+
+// The templated overloads below evaluate the potential with a custom
+// barrier function (see ClampedLogBarrier in barrier/barrier.hpp for the
+// requirements): the barrier inlines into the constraint loops with no
+// indirection, so experimental variants pay no dispatch cost. They keep the
+// straightforward parallel assembly; the non-template entry points above
+// remain the tuned default-barrier paths (cached-distance batching,
+// deterministic reductions, caller-owned assembly).
+
+/// @brief Compute the barrier potential with a custom barrier function.
+/// @tparam Barrier The barrier function (see ClampedLogBarrier).
+/// @param[in] mesh The collision mesh.
+/// @param[in] V Vertices of the collision mesh.
+/// @param[in] constraint_set The set of constraints.
+/// @param[in] dhat The activation distance of the barrier.
+/// @returns The sum of all barrier potentials (not scaled by the barrier stiffness).
+template <typename Barrier>
+double compute_barrier_potential(
+    const CollisionMesh& mesh,
+    ConstMatrixXdRef V,
+    const Constraints& constraint_set,
+    const double dhat);
+
+/// @brief Compute the barrier potential gradient with a custom barrier
+/// function.
+/// @tparam Barrier The barrier function (see ClampedLogBarrier).
+/// @param[in] mesh The collision mesh.
+/// @param[in] V Vertices of the collision mesh.
+/// @param[in] constraint_set The set of constraints.
+/// @param[in] dhat The activation distance of the barrier.
+/// @returns The gradient of all barrier potentials (not scaled by the barrier stiffness). This will have a size of |V|.
+template <typename Barrier>
+Eigen::VectorXd compute_barrier_potential_gradient(
+    const CollisionMesh& mesh,
+    ConstMatrixXdRef V,
+    const Constraints& constraint_set,
+    const double dhat);
+
+/// @brief Compute the barrier potential hessian with a custom barrier
+/// function.
+/// @tparam Barrier The barrier function (see ClampedLogBarrier).
+/// @param[in] mesh The collision mesh.
+/// @param[in] V Vertices of the collision mesh.
+/// @param[in] constraint_set The set of constraints.
+/// @param[in] dhat The activation distance of the barrier.
+/// @param[in] project_hessian_to_psd Make sure the hessian is positive semi-definite.
+/// @returns The hessian of all barrier potentials (not scaled by the barrier stiffness). This will have a size of |V|x|V|.
+template <typename Barrier>
+Eigen::SparseMatrix<double> compute_barrier_potential_hessian(
+    const CollisionMesh& mesh,
+    ConstMatrixXdRef V,
+    const Constraints& constraint_set,
+    const double dhat,
+    const bool project_hessian_to_psd = true);
+
+/// @brief Compute the hessian of the barrier potential in single precision.
+///
+/// The local kernels and distances are still evaluated in double; only the
+/// assembled triplets and matrix are float, halving the assembly memory
+/// traffic for solvers that tolerate single-precision hessians (e.g. with
+/// iterative refinement).
 /// @param[in] mesh The collision mesh.
 /// @param[in] V Vertices of the collision mesh.
 /// @param[in] constraint_set The set of constraints.
 /// @param[in] dhat The activation distance of the barrier.
+/// @param[out] hess The single-precision hessian of all barrier potentials.
+/// @param[in] project_hessian_to_psd Make sure the hessian is positive semi-definite.
+void compute_barrier_potential_hessian(
+    const CollisionMesh& mesh,
+    ConstMatrixXdRef V,
+    const Constraints& constraint_set,
+    const double dhat,
+    Eigen::SparseMatrix<float>& hess,
+    const bool project_hessian_to_psd = true);
+
+/// @brief Compute only the upper triangle of the barrier potential hessian.
+///
+/// The local constraint hessians are symmetric, so the lower-triangle
+/// entries of the assembled matrix carry no information; emitting only the
+/// column >= row entries halves the triplet volume, the sort/merge cost of
+/// the assembly, and the memory traffic of every evaluation. The returned
+/// matrix stores only the upper triangle: hand it to solvers as a
+/// selfadjoint view (e.g. hess.selfadjointView<Eigen::Upper>() for CG or
+/// Eigen's CHOLMOD/simplicial factorizations with the Upper template
+/// argument), or reinterpret its compressed-column arrays as the lower
+/// triangle's compressed-row layout for row-major solver interfaces.
+/// @param[in] mesh The collision mesh.
+/// @param[in] V Vertices of the collision mesh.
+/// @param[in] constraint_set The set of constraints.
+/// @param[in] dhat The activation distance of the barrier.
+/// @param[in] project_hessian_to_psd Make sure the hessian is positive semi-definite.
+/// @returns The upper triangle of the hessian of all barrier potentials (not scaled by the barrier stiffness). This will have a size of |V|x|V|.
+Eigen::SparseMatrix<double> compute_barrier_potential_hessian_upper(
+    const CollisionMesh& mesh,
+    ConstMatrixXdRef V,
+    const Constraints& constraint_set,
+    const double dhat,
+    const bool project_hessian_to_psd = true);
+
+/// @brief Compute the hessian of the barrier potential using a reusable
+/// assembly context.
+///
+/// The context caches the compressed sparsity pattern, which only changes
+/// when the constraint set changes, so repeated calls (e.g., one per Newton
+/// iteration) skip the triplet assembly and scatter the local blocks
+/// directly into the cached layout.
+/// @param[in] mesh The collision mesh.
+/// @param[in] V Vertices of the collision mesh.
+/// @param[in] constraint_set The set of constraints.
+/// @param[in] dhat The activation distance of the barrier.
+/// @param[in,out] cache Assembly context reused between calls.
 /// @param[in] project_hessian_to_psd Make sure the hessian is positive semi-definite.
 /// @returns The hessian of all barrier potentials (not scaled by the barrier stiffness). This will have a size of |V|x|V|.
 Eigen::SparseMatrix<double> compute_barrier_potential_hessian(
     const CollisionMesh& mesh,
-    const Eigen::MatrixXd& V,
+    ConstMatrixXdRef V,
+    const Constraints& constraint_set,
+    const double dhat,
+    HessianAssemblyCache& cache,
+    const bool project_hessian_to_psd = true);
+
+/// @brief Agree on the hessian's sparsity pattern for a constraint set.
+///
+/// Updates the cache's pattern for the current constraint set so a caller
+/// owning its CSR storage can size and wire its buffers (see
+/// HessianAssemblyCache::num_non_zeros() and export_pattern()) before
+/// assembling values into them.
+/// @param[in] mesh The collision mesh.
+/// @param[in] constraint_set The set of constraints.
+/// @param[in,out] cache Assembly context reused between calls.
+/// @returns True if the pattern changed since the previous call.
+bool update_barrier_potential_hessian_pattern(
+    const CollisionMesh& mesh,
+    const Constraints& constraint_set,
+    HessianAssemblyCache& cache);
+
+/// @brief Compute the hessian of the barrier potential directly into
+/// caller-owned CSR value storage.
+///
+/// Writes the values in the layout of the cache's pattern, giving a
+/// zero-copy hand-off to solvers and preconditioners with their own CSR
+/// arrays (the hessian is symmetric, so its compressed-column layout is
+/// also its compressed-row layout). The pattern must have been agreed on
+/// through update_barrier_potential_hessian_pattern() for the same
+/// constraint set; assembling against a stale pattern throws instead of
+/// writing past the caller's buffers.
+/// @param[in] mesh The collision mesh.
+/// @param[in] V Vertices of the collision mesh.
+/// @param[in] constraint_set The set of constraints.
+/// @param[in] dhat The activation distance of the barrier.
+/// @param[in,out] cache Assembly context holding the agreed pattern.
+/// @param[out] values Value of each stored entry (size
+/// cache.num_non_zeros()).
+/// @param[in] project_hessian_to_psd Make sure the hessian is positive semi-definite.
+void compute_barrier_potential_hessian(
+    const CollisionMesh& mesh,
+    ConstMatrixXdRef V,
+    const Constraints& constraint_set,
+    const double dhat,
+    HessianAssemblyCache& cache,
+    double* values,
+    const bool project_hessian_to_psd = true);
+
+/// @brief Compute the hessian of the barrier potential in block compressed
+/// row (BSR) form.
+///
+/// The blocks are the dim x dim per-vertex-pair blocks of the hessian, so
+/// block-aware consumers (e.g. block preconditioners) can use the structure
+/// directly instead of re-detecting it in the scalar matrix.
+/// @param[in] mesh The collision mesh.
+/// @param[in] V Vertices of the collision mesh.
+/// @param[in] constraint_set The set of constraints.
+/// @param[in] dhat The activation distance of the barrier.
+/// @param[in] project_hessian_to_psd Make sure the hessian is positive semi-definite.
+/// @returns The hessian of all barrier potentials (not scaled by the barrier stiffness) with |V| x |V| blocks of size dim x dim.
+BlockSparseMatrix compute_barrier_potential_block_hessian(
+    const CollisionMesh& mesh,
+    ConstMatrixXdRef V,
     const Constraints& constraint_set,
     const double dhat,
     const bool project_hessian_to_psd = true);
 
+/// @brief Compute the barrier potential, its gradient, and its hessian in
+/// one pass over the constraint set.
+///
+/// Each constraint's distance value and distance derivatives are computed
+/// once and shared between the three quantities, roughly halving the cost
+/// of evaluating them separately (e.g., once per Newton iteration).
+/// @param[in] mesh The collision mesh.
+/// @param[in] V Vertices of the collision mesh.
+/// @param[in] constraint_set The set of constraints.
+/// @param[in] dhat The activation distance of the barrier.
+/// @param[out] grad The gradient of all barrier potentials. This will have a size of |V|.
+/// @param[out] hess The hessian of all barrier potentials. This will have a size of |V|x|V|.
+/// @param[in] project_hessian_to_psd Make sure the hessian is positive semi-definite.
+/// @param[in,out] workspace Optional persistent scratch arenas; pass one
+///     kept alive across steps to make this pass allocation-free at steady
+///     state (see Workspace).
+/// @returns The sum of all barrier potentials (not scaled by the barrier stiffness).
+double compute_barrier_potential_and_derivatives(
+    const CollisionMesh& mesh,
+    ConstMatrixXdRef V,
+    const Constraints& constraint_set,
+    const double dhat,
+    Eigen::VectorXd& grad,
+    Eigen::SparseMatrix<double>& hess,
+    const bool project_hessian_to_psd = true,
+    Workspace* const workspace = nullptr);
+
+/// @brief One Newton iteration's collision derivatives (see
+/// compute_iteration_derivatives()).
+struct IterationDerivatives {
+    /// @brief The sum of all barrier potentials (not scaled by the barrier
+    /// stiffness).
+    double barrier_potential = 0;
+    /// @brief The gradient of the barrier potential (size |V|).
+    Eigen::VectorXd barrier_gradient;
+    /// @brief The hessian of the barrier potential (size |V| x |V|).
+    Eigen::SparseMatrix<double> barrier_hessian;
+    /// @brief The gradient of the friction potential (empty without
+    /// friction).
+    Eigen::VectorXd friction_gradient;
+    /// @brief The hessian of the friction potential (empty without
+    /// friction).
+    Eigen::SparseMatrix<double> friction_hessian;
+};
+
+/// @brief Compute a whole Newton iteration's collision derivatives as one
+/// submit-and-wait task graph.
+///
+/// The barrier and friction computations are independent, but calling them
+/// sequentially drains and refills the worker threads once per phase (each
+/// call is its own parallel region with its own final sync). This entry
+/// point submits the fused barrier evaluation (potential, gradient, and
+/// hessian in one pass) and the fused friction evaluation as concurrent
+/// tasks in a single region and waits for both, so the load imbalance at
+/// the tail of one phase is filled with the other phase's work. The fused
+/// passes stay fused: splitting the gradient and hessian of one potential
+/// into separate tasks would recompute their shared per-constraint
+/// distances, costing more than the saved synchronization.
+/// @param[in] mesh The collision mesh.
+/// @param[in] V Vertices of the collision mesh.
+/// @param[in] constraint_set The set of constraints.
+/// @param[in] dhat The activation distance of the barrier.
+/// @param[in] friction_V0 Vertex positions the friction constraints are lagged at (rowwise).
+/// @param[in] friction_constraint_set The set of friction constraints (may be empty).
+/// @param[in] epsv_times_h Tolerance for the transition between static and dynamic friction.
+/// @param[in] project_hessian_to_psd Make sure the hessians are positive semi-definite.
+/// @param[in,out] workspace Optional persistent scratch arenas shared by
+///     both passes (they acquire distinct arenas); pass one kept alive
+///     across steps to make the assembly allocation-free at steady state.
+/// @returns The barrier potential and the barrier and friction derivatives.
+IterationDerivatives compute_iteration_derivatives(
+    const CollisionMesh& mesh,
+    ConstMatrixXdRef V,
+    const Constraints& constraint_set,
+    const double dhat,
+    ConstMatrixXdRef friction_V0,
+    const FrictionConstraints& friction_constraint_set,
+    const double epsv_times_h,
+    const bool project_hessian_to_psd = true,
+    Workspace* const workspace = nullptr);
+
+/// @brief Frictionless overload of compute_iteration_derivatives().
+/// @param[in] mesh The collision mesh.
+/// @param[in] V Vertices of the collision mesh.
+/// @param[in] constraint_set The set of constraints.
+/// @param[in] dhat The activation distance of the barrier.
+/// @param[in] project_hessian_to_psd Make sure the hessian is positive semi-definite.
+/// @param[in,out] workspace Optional persistent scratch arenas (see above).
+/// @returns The barrier potential and derivatives.
+IterationDerivatives compute_iteration_derivatives(
+    const CollisionMesh& mesh,
+    ConstMatrixXdRef V,
+    const Constraints& constraint_set,
+    const double dhat,
+    const bool project_hessian_to_psd = true,
+    Workspace* const workspace = nullptr);
+
 /// @brief Compute the barrier shape derivative.
 /// @param[in] mesh The collision mesh.
 /// @param[in] V Vertices of the collision mesh.
@@ -58,10 +372,82 @@ Eigen::SparseMatrix<double> compute_barrier_potential_hessian(
 /// @returns The derivative of the force with respect to X, the rest positions.
 Eigen::SparseMatrix<double> compute_barrier_shape_derivative(
     const CollisionMesh& mesh,
-    const Eigen::MatrixXd& V,
+    ConstMatrixXdRef V,
     const Constraints& constraint_set,
     const double dhat);
 
+/// @brief Compute the barrier shape derivative using a cached pattern.
+///
+/// The context caches the compressed sparsity pattern, which only changes
+/// when the constraint set changes, so repeated calls (e.g., one per design
+/// optimization iteration) skip the triplet assembly and sparse additions
+/// and scatter both terms directly into the cached layout.
+/// @param[in] mesh The collision mesh.
+/// @param[in] V Vertices of the collision mesh.
+/// @param[in] constraint_set The set of constraints.
+/// @param[in] dhat The activation distance of the barrier.
+/// @param[in,out] cache Assembly context reused between calls.
+/// @returns The derivative of the force with respect to X, the rest positions.
+Eigen::SparseMatrix<double> compute_barrier_shape_derivative(
+    const CollisionMesh& mesh,
+    ConstMatrixXdRef V,
+    const Constraints& constraint_set,
+    const double dhat,
+    ShapeDerivativeAssemblyCache& cache);
+
+/// @brief Compute the barrier hessian and shape derivative in one pass.
+///
+/// Both outputs share the per-constraint barrier hessians, so evaluating
+/// them together runs the hessian kernels once instead of twice for
+/// back-to-back calls on the same constraint set and positions. The shape
+/// derivative always uses the unprojected hessians; when
+/// project_hessian_to_psd is set only the dof hessian is projected.
+/// @param[in] mesh The collision mesh.
+/// @param[in] V Vertices of the collision mesh.
+/// @param[in] constraint_set The set of constraints.
+/// @param[in] dhat The activation distance of the barrier.
+/// @param[out] hess The hessian of all barrier potentials.
+/// @param[out] shape_derivative The derivative of the force with respect to
+/// X, the rest positions.
+/// @param[in] project_hessian_to_psd Make sure hess is positive semi-definite.
+void compute_barrier_potential_hessian_and_shape_derivative(
+    const CollisionMesh& mesh,
+    ConstMatrixXdRef V,
+    const Constraints& constraint_set,
+    const double dhat,
+    Eigen::SparseMatrix<double>& hess,
+    Eigen::SparseMatrix<double>& shape_derivative,
+    const bool project_hessian_to_psd = true);
+
+/// @brief Compute the barrier hessian and shape derivative in one pass
+/// using cached assembly patterns.
+///
+/// Combines the shared-kernel evaluation above with the cached-pattern
+/// scatters of both assembly contexts, so repeated optimization iterations
+/// with an unchanged constraint set skip every triplet build.
+/// @param[in] mesh The collision mesh.
+/// @param[in] V Vertices of the collision mesh.
+/// @param[in] constraint_set The set of constraints.
+/// @param[in] dhat The activation distance of the barrier.
+/// @param[in,out] hessian_cache Hessian assembly context reused between
+/// calls.
+/// @param[in,out] shape_derivative_cache Shape derivative assembly context
+/// reused between calls.
+/// @param[out] hess The hessian of all barrier potentials.
+/// @param[out] shape_derivative The derivative of the force with respect to
+/// X, the rest positions.
+/// @param[in] project_hessian_to_psd Make sure hess is positive semi-definite.
+void compute_barrier_potential_hessian_and_shape_derivative(
+    const CollisionMesh& mesh,
+    ConstMatrixXdRef V,
+    const Constraints& constraint_set,
+    const double dhat,
+    HessianAssemblyCache& hessian_cache,
+    ShapeDerivativeAssemblyCache& shape_derivative_cache,
+    Eigen::SparseMatrix<double>& hess,
+    Eigen::SparseMatrix<double>& shape_derivative,
+    const bool project_hessian_to_psd = true);
+
 ///////////////////////////////////////////////////////////////////////////////
 // Collision detection
 
@@ -73,12 +459,28 @@ Eigen::SparseMatrix<double> compute_barrier_shape_derivative(
 /// @returns True if <b>any</b> collisions occur.
 bool is_step_collision_free(
     const CollisionMesh& mesh,
-    const Eigen::MatrixXd& V0,
-    const Eigen::MatrixXd& V1,
+    ConstMatrixXdRef V0,
+    ConstMatrixXdRef V1,
     const BroadPhaseMethod method = BroadPhaseMethod::HASH_GRID,
     const double tolerance = 1e-6,
     const long max_iterations = 1e7);
 
+/// @brief Determine if the step is collision free using a caller-owned broad
+/// phase.
+/// @note Assumes the trajectory is linear.
+/// @param[in,out] broad_phase Broad phase to (re)build and query.
+/// @param[in] mesh The collision mesh.
+/// @param[in] V0 Surface vertex positions at start as rows of a matrix.
+/// @param[in] V1 Surface vertex positions at end as rows of a matrix.
+/// @returns True if <b>any</b> collisions occur.
+bool is_step_collision_free(
+    BroadPhase& broad_phase,
+    const CollisionMesh& mesh,
+    ConstMatrixXdRef V0,
+    ConstMatrixXdRef V1,
+    const double tolerance = 1e-6,
+    const long max_iterations = 1e7);
+
 /// @brief Determine if the step is collision free from a set of candidates.
 /// @note Assumes the trajectory is linear.
 /// @param[in] candidates Set of candidates to check for collisions.
@@ -89,24 +491,72 @@ bool is_step_collision_free(
 bool is_step_collision_free(
     const Candidates& candidates,
     const CollisionMesh& mesh,
-    const Eigen::MatrixXd& V0,
-    const Eigen::MatrixXd& V1,
+    ConstMatrixXdRef V0,
+    ConstMatrixXdRef V1,
     const double tolerance = 1e-6,
     const long max_iterations = 1e7);
 
+/// @brief Optional time/iteration budget for deadline-bounded CCD.
+///
+/// Tight-Inclusion occasionally hits hard queries that take an order of
+/// magnitude longer than the median, which blows the frame budget of
+/// interactive callers. When a budget is passed to
+/// compute_collision_free_stepsize, the narrow phase stops charging new
+/// queries once the budget expires and instead folds each remaining
+/// candidate's certified conservative time-of-impact lower bound (see
+/// ccd_toi_lower_bounds) into the step size. The returned step is smaller
+/// than the full-tolerance answer but remains certified collision free —
+/// step optimality is traded for bounded latency.
+struct CCDBudget {
+    /// @brief Wall-clock budget in seconds (infinity = unlimited).
+    double max_seconds = std::numeric_limits<double>::infinity();
+    /// @brief Maximum number of narrow-phase queries (-1 = unlimited).
+    long max_queries = -1;
+    /// @brief [out] Set when the budget expired and the conservative
+    /// fallback produced the step size.
+    bool expired = false;
+};
+
 /// @brief Computes a maximal step size that is collision free.
 /// @note Assumes the trajectory is linear.
 /// @param[in] mesh The collision mesh.
 /// @param[in] V0 Vertex positions at start as rows of a matrix. Assumes V0 is intersection free.
 /// @param[in] V1 Surface vertex positions at end as rows of a matrix.
+/// @param[in] min_distance The minimum distance allowable between any two elements.
+/// @param[in,out] budget Optional deadline budget (see CCDBudget); ignored
+///     by the SWEEP_AND_TINIEST_QUEUE_GPU method.
 /// @returns A step-size \f$\in [0, 1]\f$ that is collision free. A value of 1.0 if a full step and 0.0 is no step.
 double compute_collision_free_stepsize(
     const CollisionMesh& mesh,
-    const Eigen::MatrixXd& V0,
-    const Eigen::MatrixXd& V1,
+    ConstMatrixXdRef V0,
+    ConstMatrixXdRef V1,
+    const double min_distance = 0.0,
     const BroadPhaseMethod method = BroadPhaseMethod::HASH_GRID,
     const double tolerance = 1e-6,
-    const long max_iterations = 1e7);
+    const long max_iterations = 1e7,
+    const bool adaptive_tolerance = false,
+    CCDBudget* const budget = nullptr);
+
+/// @brief Computes a maximal step size that is collision free using a
+/// caller-owned broad phase.
+/// @note Assumes the trajectory is linear.
+/// @param[in,out] broad_phase Broad phase to (re)build and query.
+/// @param[in] mesh The collision mesh.
+/// @param[in] V0 Vertex positions at start as rows of a matrix. Assumes V0 is intersection free.
+/// @param[in] V1 Surface vertex positions at end as rows of a matrix.
+/// @param[in] min_distance The minimum distance allowable between any two elements.
+/// @param[in,out] budget Optional deadline budget (see CCDBudget).
+/// @returns A step-size \f$\in [0, 1]\f$ that is collision free. A value of 1.0 if a full step and 0.0 is no step.
+double compute_collision_free_stepsize(
+    BroadPhase& broad_phase,
+    const CollisionMesh& mesh,
+    ConstMatrixXdRef V0,
+    ConstMatrixXdRef V1,
+    const double min_distance = 0.0,
+    const double tolerance = 1e-6,
+    const long max_iterations = 1e7,
+    const bool adaptive_tolerance = false,
+    CCDBudget* const budget = nullptr);
 
 /// @brief Computes a maximal step size that is collision free using a set of collision candidates.
 /// @note Assumes the trajectory is linear.
@@ -114,15 +564,224 @@ double compute_collision_free_stepsize(
 /// @param[in] mesh The collision mesh.
 /// @param[in] V0 Vertex positions at start as rows of a matrix. Assumes V0 is intersection free.
 /// @param[in] V1 Surface vertex positions at end as rows of a matrix.
+/// @param[in] min_distance The minimum distance allowable between any two elements.
+/// @param[in,out] budget Optional deadline budget (see CCDBudget).
 /// @returns A step-size \f$\in [0, 1]\f$ that is collision free. A value of 1.0 if a full step and 0.0 is no step.
 double compute_collision_free_stepsize(
     const Candidates& candidates,
     const CollisionMesh& mesh,
-    const Eigen::MatrixXd& V0,
-    const Eigen::MatrixXd& V1,
+    ConstMatrixXdRef V0,
+    ConstMatrixXdRef V1,
+    const double min_distance = 0.0,
+    const double tolerance = 1e-6,
+    const long max_iterations = 1e7,
+    const bool adaptive_tolerance = false,
+    CCDBudget* const budget = nullptr);
+
+/// @brief Computes a maximal collision-free step size on the GPU from a set
+/// of collision candidates.
+///
+/// The GPU narrow phase cannot consume explicit candidate pairs, so the mesh
+/// is restricted to the primitives referenced by the candidate set before the
+/// batch is dispatched. The result is conservative: every candidate pair is
+/// retained, and any extra pair found among the retained primitives can only
+/// shrink the returned step size.
+/// @note Assumes the trajectory is linear.
+/// @param[in] candidates Set of candidates to check for collisions.
+/// @param[in] mesh The collision mesh.
+/// @param[in] V0 Vertex positions at start as rows of a matrix. Assumes V0 is intersection free.
+/// @param[in] V1 Surface vertex positions at end as rows of a matrix.
+/// @param[in] min_distance The minimum distance allowable between any two elements.
+/// @returns A step-size \f$\in [0, 1]\f$ that is collision free. A value of 1.0 if a full step and 0.0 is no step.
+double compute_collision_free_stepsize_gpu(
+    const Candidates& candidates,
+    const CollisionMesh& mesh,
+    ConstMatrixXdRef V0,
+    ConstMatrixXdRef V1,
+    const double min_distance = 0.0,
     const double tolerance = 1e-6,
     const long max_iterations = 1e7);
 
+/// @brief Packed per-candidate CCD query coordinate records.
+///
+/// Each narrow-phase query reads up to eight vertex positions scattered
+/// across the two large vertex matrices; gathering them per call dominates
+/// the memory profile of narrow-phase CCD. This buffer gathers every
+/// candidate's start and end coordinates once into contiguous fixed-size
+/// records (four vertex slots × three coordinates × two endpoints = 192
+/// bytes, i.e. three cache lines per query), which then feed both the
+/// conservative time-of-impact screening and the CCD kernels with
+/// streaming loads. The buffer keeps its capacity across build() calls, so
+/// one instance can be reused every step without reallocating.
+struct PackedCCDQueries {
+    /// @brief Padded number of vertex slots per query record.
+    static constexpr int QUERY_VERTICES = 4;
+    /// @brief Doubles per query record (a t0 block then a t1 block of
+    /// QUERY_VERTICES three-coordinate slots).
+    static constexpr int QUERY_STRIDE = 2 * QUERY_VERTICES * 3;
+
+    /// @brief Gather the candidates' vertex coordinates into packed records.
+    ///
+    /// Records are ordered as in Candidates::operator[] (edge-vertex, then
+    /// edge-edge, then face-vertex) and hold the vertices in kernel argument
+    /// order; unused coordinates (the third in 2D and the fourth slot of
+    /// three-vertex queries) are zero.
+    /// @param[in] candidates SoA copy of the collision candidates.
+    /// @param[in] mesh The collision mesh.
+    /// @param[in] V0 Vertex positions at start as rows of a matrix.
+    /// @param[in] V1 Vertex positions at end as rows of a matrix.
+    void build(
+        const CandidatesSoA& candidates,
+        const CollisionMesh& mesh,
+        ConstMatrixXdRef V0,
+        ConstMatrixXdRef V1);
+
+    /// @brief Pointer to the i-th query's record.
+    const double* query(const size_t i) const
+    {
+        return data.data() + i * QUERY_STRIDE;
+    }
+
+    size_t size() const { return num_ev + num_ee + num_fv; }
+
+    bool empty() const { return size() == 0; }
+
+    /// @brief Remove all records, but keep the allocated capacity.
+    void clear();
+
+    size_t num_ev = 0; ///< @brief Number of edge-vertex records.
+    size_t num_ee = 0; ///< @brief Number of edge-edge records.
+    size_t num_fv = 0; ///< @brief Number of face-vertex records.
+
+    /// @brief Dimension of the packed positions (2 or 3).
+    int dim = 3;
+
+    /// @brief The packed records (size() * QUERY_STRIDE doubles). The
+    /// record stride is a multiple of the cache-line size, so records never
+    /// share a line.
+    std::vector<double, Eigen::aligned_allocator<double>> data;
+
+protected:
+    /// @brief SoA mirrors of V0 and V1, refreshed by build() so the packing
+    /// loops read contiguous per-axis arrays instead of gathering through
+    /// the matrices' run-time strides. Kept as members so their capacity
+    /// survives across builds.
+    PositionsSoA m_positions_t0;
+    PositionsSoA m_positions_t1;
+};
+
+/// @brief Compute conservative lower bounds on the time of impact of a batch
+/// of collision candidates.
+///
+/// The candidate indices are streamed in structure-of-arrays layout and one
+/// bound per candidate is written to a flat result array, so the loops are
+/// branch-light and unit-stride and the compiler can evaluate several queries
+/// per vector instruction. A candidate whose bound is at least the current
+/// earliest time of impact cannot change the step size and can be rejected
+/// without running narrow-phase CCD.
+/// @param[in] candidates SoA copy of the collision candidates.
+/// @param[in] mesh The collision mesh.
+/// @param[in] V0 Vertex positions at start as rows of a matrix.
+/// @param[in] V1 Surface vertex positions at end as rows of a matrix.
+/// @param[out] toi_lower_bounds One lower bound per candidate, ordered as in
+///     Candidates::operator[].
+/// @param[in] min_distance The minimum distance allowable between any two elements.
+void ccd_toi_lower_bounds(
+    const CandidatesSoA& candidates,
+    const CollisionMesh& mesh,
+    ConstMatrixXdRef V0,
+    ConstMatrixXdRef V1,
+    std::vector<double>& toi_lower_bounds,
+    const double min_distance = 0.0);
+
+/// @brief Compute conservative lower bounds on the time of impact from
+/// packed query records.
+///
+/// Same certified bound as the index-based overload, but every load comes
+/// from the candidate's own pre-gathered record instead of scattered rows
+/// of the vertex matrices.
+/// @param[in] queries Packed per-candidate coordinate records.
+/// @param[out] toi_lower_bounds One lower bound per candidate, ordered as
+/// the records.
+/// @param[in] min_distance The minimum distance allowable between any two elements.
+void ccd_toi_lower_bounds(
+    const PackedCCDQueries& queries,
+    std::vector<double>& toi_lower_bounds,
+    const double min_distance = 0.0);
+
+/// @brief Reusable CCD context for a backtracking line search.
+///
+/// A backtracking line search evaluates scaled versions of a single search
+/// direction: every trial end position is \f$V_0 + \alpha (V_1 - V_0)\f$
+/// for some \f$\alpha \in (0, 1]\f$. Because each scaled sweep is
+/// contained in the full sweep, the candidate set built for \f$(V_0,
+/// V_1)\f$ is valid for every trial step, and a per-candidate time of
+/// impact computed once rescales by \f$1/\alpha\f$ instead of requiring a
+/// fresh narrow-phase query. build() runs the broad phase once per search
+/// direction; compute_collision_free_stepsize() then reuses exact cached
+/// times of impact, skips candidates certified root free past the current
+/// earliest time, and re-runs only the queries invalidated by the step
+/// scaling.
+class CCDContext {
+public:
+    /// @brief Build the candidate set for a new search direction.
+    /// @note Assumes the trajectory is linear.
+    /// @param[in] mesh The collision mesh.
+    /// @param[in] V0 Vertex positions at start as rows of a matrix. Assumes V0 is intersection free.
+    /// @param[in] V1 Surface vertex positions at the full step's end.
+    /// @param[in] min_distance The minimum distance allowable between any two elements.
+    /// @param[in] method Broad phase method to use.
+    void build(
+        const CollisionMesh& mesh,
+        ConstMatrixXdRef V0,
+        ConstMatrixXdRef V1,
+        const double min_distance = 0.0,
+        const BroadPhaseMethod method = BroadPhaseMethod::HASH_GRID,
+        const double tolerance = 1e-6,
+        const long max_iterations = 1e7,
+        const bool adaptive_tolerance = false);
+
+    /// @brief Computes a maximal collision-free step size for a trial step.
+    ///
+    /// The trial step sweeps from \f$V_0\f$ to \f$V_0 + \alpha (V_1 -
+    /// V_0)\f$ where \f$\alpha\f$ is step_scale and \f$(V_0, V_1)\f$
+    /// is the direction passed to build().
+    /// @param[in] mesh The collision mesh passed to build().
+    /// @param[in] step_scale Fraction \f$\alpha \in (0, 1]\f$ of the full direction swept by this trial step.
+    /// @returns A step-size \f$\in [0, 1]\f$ of the <em>trial</em> step that is collision free.
+    double compute_collision_free_stepsize(
+        const CollisionMesh& mesh, const double step_scale = 1.0);
+
+    /// @brief The collision candidates built for the current direction.
+    const Candidates& candidates() const { return m_candidates; }
+
+protected:
+    /// @brief Endpoints of the current search direction.
+    Eigen::MatrixXd m_V0, m_V1;
+    double m_min_distance = 0;
+    double m_tolerance = 1e-6;
+    long m_max_iterations = long(1e7);
+    bool m_adaptive_tolerance = false;
+
+    /// @brief Candidates for the full sweep (a superset of every trial's).
+    Candidates m_candidates;
+    /// @brief Packed query coordinates; valid for every trial because the
+    /// direction's endpoints are fixed until the next build().
+    PackedCCDQueries m_packed_queries;
+    /// @brief Candidate order by displacement proxy (largest first).
+    std::vector<std::pair<double, size_t>> m_order;
+    /// @brief Per-candidate tolerances (empty unless adaptive).
+    std::vector<double> m_tolerances;
+    /// @brief Scene bounds of the direction's start positions, computed
+    /// once per build() for the adaptive tolerance floor.
+    SceneBounds m_scene_bounds;
+    /// @brief Exact per-candidate toi; infinity until a root is found.
+    std::vector<double> m_toi;
+    /// @brief Certified root-free time per candidate: no candidate has a
+    /// root in [0, m_safe_toi[i]). Grows as queries run with larger tmax.
+    std::vector<double> m_safe_toi;
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 // Utilities
 
@@ -132,16 +791,57 @@ double compute_collision_free_stepsize(
 /// @returns The minimum distance between any non-adjacent elements.
 double compute_minimum_distance(
     const CollisionMesh& mesh,
-    const Eigen::MatrixXd& V,
+    ConstMatrixXdRef V,
     const Constraints& constraint_set);
 
+/// @brief Computes the minimum distance and the k closest constraint pairs.
+///
+/// Useful for tuning dhat and diagnosing near misses: the top-k heap is
+/// maintained per thread on the same pass as the minimum reduction, so this
+/// costs no extra distance evaluations over compute_minimum_distance.
+/// @param[in] mesh The collision mesh.
+/// @param[in] V Vertices of the collision mesh.
+/// @param[in] constraint_set The set of constraints to measure.
+/// @param[in] k Number of closest pairs to report.
+/// @param[out] closest_pairs Up to k (constraint index, squared distance)
+///     pairs sorted by increasing distance. Indices are into constraint_set.
+/// @returns The minimum distance between any non-adjacent elements.
+double compute_minimum_distance(
+    const CollisionMesh& mesh,
+    ConstMatrixXdRef V,
+    const Constraints& constraint_set,
+    const int k,
+    std::vector<std::pair<size_t, double>>& closest_pairs);
+
 /// @brief Determine if the mesh has self intersections.
 /// @param[in] mesh The collision mesh.
 /// @param[in] V Vertices of the collision mesh.
+/// @param[in] method Broad phase method to use.
+/// @param[in,out] scene_bounds Optional per-step scene-bounds cache used to
+///     size the conservative inflation radius; pass the step's shared cache
+///     to avoid re-reducing V when another consumer already has.
 /// @return A boolean for if the mesh has intersections.
 bool has_intersections(
     const CollisionMesh& mesh,
-    const Eigen::MatrixXd& V,
-    const BroadPhaseMethod method = BroadPhaseMethod::HASH_GRID);
+    ConstMatrixXdRef V,
+    const BroadPhaseMethod method = BroadPhaseMethod::HASH_GRID,
+    SceneBounds* const scene_bounds = nullptr);
+
+/// @brief Determine if the mesh has self intersections using an existing
+/// broad phase.
+///
+/// Reuses a broad phase already built for the same vertex positions (e.g., by
+/// this step's collision detection) instead of constructing one from scratch,
+/// and runs the narrow-phase intersection tests in parallel.
+/// @param[in] broad_phase Broad phase built for the vertices V.
+/// @param[in] mesh The collision mesh.
+/// @param[in] V Vertices of the collision mesh.
+/// @return A boolean for if the mesh has intersections.
+bool has_intersections(
+    BroadPhase& broad_phase,
+    const CollisionMesh& mesh,
+    ConstMatrixXdRef V);
 
 } // namespace ipc
+
+#include "ipc.tpp"
@@ -0,0 +1,165 @@
+#pragma once
+#include "ipc.hpp"
+
+#include <ipc/barrier/barrier.hpp>
+#include <ipc/utils/execution_context.hpp>
+#include <ipc/utils/local_to_global.hpp>
+
+#include <tbb/parallel_for.h>
+#include <tbb/blocked_range.h>
+#include <tbb/enumerable_thread_specific.h>
+
+namespace ipc {
+
+// The loops below iterate through Constraints::for_each, so the constraints
+// have their concrete types and the templated _T kernels (including the
+// mollified EdgeEdgeConstraint shadows) resolve statically — the Barrier
+// inlines into the loop bodies with no virtual dispatch.
+
+template <typename Barrier>
+double compute_barrier_potential(
+    const CollisionMesh& mesh,
+    ConstMatrixXdRef V,
+    const Constraints& constraint_set,
+    const double dhat)
+{
+    assert(V.rows() == mesh.num_vertices());
+
+    if (constraint_set.empty()) {
+        return 0;
+    }
+
+    const Eigen::MatrixXi& E = mesh.edges();
+    const Eigen::MatrixXi& F = mesh.faces();
+
+    return execution_context().run([&]() -> double {
+        tbb::enumerable_thread_specific<double> storage(0.0);
+
+        tbb::parallel_for(
+            tbb::blocked_range<size_t>(size_t(0), constraint_set.size()),
+            [&](const tbb::blocked_range<size_t>& r) {
+                double& local_potential = storage.local();
+                constraint_set.for_each(
+                    r.begin(), r.end(),
+                    [&](const auto& constraint, const size_t /*i*/) {
+                        // Quadrature weight is premultiplied by
+                        // compute_potential_T
+                        local_potential +=
+                            constraint.template compute_potential_T<Barrier>(
+                                V, E, F, dhat,
+                                constraint.compute_distance(V, E, F));
+                    });
+            });
+
+        double potential = 0;
+        for (const double local_potential : storage) {
+            potential += local_potential;
+        }
+        return potential;
+    });
+}
+
+template <typename Barrier>
+Eigen::VectorXd compute_barrier_potential_gradient(
+    const CollisionMesh& mesh,
+    ConstMatrixXdRef V,
+    const Constraints& constraint_set,
+    const double dhat)
+{
+    assert(V.rows() == mesh.num_vertices());
+
+    if (constraint_set.empty()) {
+        return Eigen::VectorXd::Zero(V.size());
+    }
+
+    const Eigen::MatrixXi& E = mesh.edges();
+    const Eigen::MatrixXi& F = mesh.faces();
+    const int dim = V.cols();
+
+    // Accumulate sparse (index, value) entries per thread instead of a dense
+    // |V|-sized vector per thread (see local_gradient_to_global_gradient).
+    return execution_context().run([&]() -> Eigen::VectorXd {
+        tbb::enumerable_thread_specific<std::vector<std::pair<long, double>>>
+            storage;
+
+        tbb::parallel_for(
+            tbb::blocked_range<size_t>(size_t(0), constraint_set.size()),
+            [&](const tbb::blocked_range<size_t>& r) {
+                auto& local_grad_entries = storage.local();
+                VectorMax12d local_grad;
+                constraint_set.for_each(
+                    r.begin(), r.end(),
+                    [&](const auto& constraint, const size_t /*i*/) {
+                        constraint
+                            .template compute_potential_gradient_T<Barrier>(
+                                V, E, F, dhat,
+                                constraint.compute_distance(V, E, F),
+                                local_grad);
+                        local_gradient_to_global_gradient(
+                            local_grad, constraint.vertex_indices(E, F), dim,
+                            local_grad_entries);
+                    });
+            });
+
+        Eigen::VectorXd grad = Eigen::VectorXd::Zero(V.size());
+        for (const auto& local_grad_entries : storage) {
+            for (const auto& [index, value] : local_grad_entries) {
+                grad[index] += value;
+            }
+        }
+        return grad;
+    });
+}
+
+template <typename Barrier>
+Eigen::SparseMatrix<double> compute_barrier_potential_hessian(
+    const CollisionMesh& mesh,
+    ConstMatrixXdRef V,
+    const Constraints& constraint_set,
+    const double dhat,
+    const bool project_hessian_to_psd)
+{
+    assert(V.rows() == mesh.num_vertices());
+
+    if (constraint_set.empty()) {
+        return Eigen::SparseMatrix<double>(V.size(), V.size());
+    }
+
+    const Eigen::MatrixXi& E = mesh.edges();
+    const Eigen::MatrixXi& F = mesh.faces();
+    const int dim = V.cols();
+
+    return execution_context().run([&]() -> Eigen::SparseMatrix<double> {
+        tbb::enumerable_thread_specific<std::vector<Eigen::Triplet<double>>>
+            storage;
+
+        tbb::parallel_for(
+            tbb::blocked_range<size_t>(size_t(0), constraint_set.size()),
+            [&](const tbb::blocked_range<size_t>& r) {
+                auto& local_hess_triplets = storage.local();
+                MatrixMax12d local_hess;
+                constraint_set.for_each(
+                    r.begin(), r.end(),
+                    [&](const auto& constraint, const size_t /*i*/) {
+                        constraint
+                            .template compute_potential_hessian_T<Barrier>(
+                                V, E, F, dhat, project_hessian_to_psd,
+                                local_hess);
+                        local_hessian_to_global_triplets(
+                            local_hess, constraint.vertex_indices(E, F), dim,
+                            local_hess_triplets);
+                    });
+            });
+
+        Eigen::SparseMatrix<double> hess(V.size(), V.size());
+        for (const auto& local_hess_triplets : storage) {
+            Eigen::SparseMatrix<double> local_hess(V.size(), V.size());
+            local_hess.setFromTriplets(
+                local_hess_triplets.begin(), local_hess_triplets.end());
+            hess += local_hess;
+        }
+        return hess;
+    });
+}
+
+} // namespace ipc
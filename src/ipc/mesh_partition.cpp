@@ -0,0 +1,211 @@
+#include "mesh_partition.hpp"
+
+#include <ipc/collision_mesh.hpp>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+#include <cstdint>
+
+namespace ipc {
+
+namespace {
+
+    /// @brief Does the box of the rows of V0 and V1 indexed by element
+    /// intersect the box [lo - halo, hi + halo]?
+    template <typename DerivedElement>
+    bool element_intersects_domain(
+        ConstMatrixXdRef V0,
+        ConstMatrixXdRef V1,
+        const Eigen::MatrixBase<DerivedElement>& element,
+        const ArrayMax3d& lo,
+        const ArrayMax3d& hi,
+        const double halo)
+    {
+        ArrayMax3d box_min = V0.row(element[0]).array().transpose();
+        ArrayMax3d box_max = box_min;
+        for (int i = 0; i < element.size(); i++) {
+            box_min = box_min.min(V0.row(element[i]).array().transpose());
+            box_max = box_max.max(V0.row(element[i]).array().transpose());
+            box_min = box_min.min(V1.row(element[i]).array().transpose());
+            box_max = box_max.max(V1.row(element[i]).array().transpose());
+        }
+        return (box_min <= hi + halo).all() && (box_max >= lo - halo).all();
+    }
+
+    /// @brief Is the center of the element's box in [lo, hi) per axis?
+    template <typename DerivedElement>
+    bool element_is_owned(
+        ConstMatrixXdRef V0,
+        ConstMatrixXdRef V1,
+        const Eigen::MatrixBase<DerivedElement>& element,
+        const ArrayMax3d& lo,
+        const ArrayMax3d& hi)
+    {
+        ArrayMax3d box_min = V0.row(element[0]).array().transpose();
+        ArrayMax3d box_max = box_min;
+        for (int i = 0; i < element.size(); i++) {
+            box_min = box_min.min(V0.row(element[i]).array().transpose());
+            box_max = box_max.max(V0.row(element[i]).array().transpose());
+            box_min = box_min.min(V1.row(element[i]).array().transpose());
+            box_max = box_max.max(V1.row(element[i]).array().transpose());
+        }
+        const ArrayMax3d center = 0.5 * (box_min + box_max);
+        return (lo <= center).all() && (center < hi).all();
+    }
+
+} // namespace
+
+Eigen::MatrixXd MeshPartition::vertices(ConstMatrixXdRef V_full) const
+{
+    Eigen::MatrixXd V(vertex_map.size(), V_full.cols());
+    for (size_t i = 0; i < vertex_map.size(); i++) {
+        V.row(i) = V_full.row(vertex_map[i]);
+    }
+    return V;
+}
+
+MeshPartition build_mesh_partition(
+    ConstMatrixXdRef V,
+    const Eigen::MatrixXi& E,
+    const Eigen::MatrixXi& F,
+    const ArrayMax3d& domain_min,
+    const ArrayMax3d& domain_max,
+    const double halo_radius)
+{
+    return build_mesh_partition(
+        V, V, E, F, domain_min, domain_max, halo_radius);
+}
+
+MeshPartition build_mesh_partition(
+    ConstMatrixXdRef V0,
+    ConstMatrixXdRef V1,
+    const Eigen::MatrixXi& E,
+    const Eigen::MatrixXi& F,
+    const ArrayMax3d& domain_min,
+    const ArrayMax3d& domain_max,
+    const double halo_radius)
+{
+    assert(V0.rows() == V1.rows() && V0.cols() == V1.cols());
+    assert(domain_min.size() == V0.cols());
+    assert(domain_max.size() == V0.cols());
+    assert(halo_radius >= 0);
+
+    MeshPartition partition;
+    partition.domain_min = domain_min;
+    partition.domain_max = domain_max;
+    partition.halo_radius = halo_radius;
+
+    // Inclusion flags over the full mesh (uint8_t, not vector<bool>, so the
+    // parallel writes below do not race on shared words).
+    std::vector<std::uint8_t> include_vertex(V0.rows(), false);
+    std::vector<std::uint8_t> include_edge(E.rows(), false);
+    std::vector<std::uint8_t> include_face(F.rows(), false);
+
+    tbb::parallel_for(
+        tbb::blocked_range<long>(0, E.rows()),
+        [&](const tbb::blocked_range<long>& range) {
+            for (long e = range.begin(); e < range.end(); e++) {
+                include_edge[e] = element_intersects_domain(
+                    V0, V1, E.row(e), domain_min, domain_max, halo_radius);
+            }
+        });
+
+    tbb::parallel_for(
+        tbb::blocked_range<long>(0, F.rows()),
+        [&](const tbb::blocked_range<long>& range) {
+            for (long f = range.begin(); f < range.end(); f++) {
+                include_face[f] = element_intersects_domain(
+                    V0, V1, F.row(f), domain_min, domain_max, halo_radius);
+            }
+        });
+
+    if (F.rows() > 0) {
+        // CollisionMesh requires every edge of every face (its faces-to-edges
+        // map throws otherwise), and a face can intersect the inflated domain
+        // while one of its edges does not, so force-include them.
+        const Eigen::MatrixXi faces_to_edges =
+            CollisionMesh::construct_faces_to_edges(F, E);
+        for (long f = 0; f < F.rows(); f++) {
+            if (include_face[f]) {
+                for (int i = 0; i < faces_to_edges.cols(); i++) {
+                    include_edge[faces_to_edges(f, i)] = true;
+                }
+            }
+        }
+    }
+
+    // Include the endpoints of every included element, plus the codimensional
+    // vertices (vertices on no edge) that intersect the inflated domain.
+    std::vector<std::uint8_t> vertex_on_edge(V0.rows(), false);
+    for (long e = 0; e < E.rows(); e++) {
+        for (int i = 0; i < E.cols(); i++) {
+            vertex_on_edge[E(e, i)] = true;
+            include_vertex[E(e, i)] |= include_edge[e];
+        }
+    }
+    for (long f = 0; f < F.rows(); f++) {
+        for (int i = 0; i < F.cols(); i++) {
+            include_vertex[F(f, i)] |= include_face[f];
+        }
+    }
+    tbb::parallel_for(
+        tbb::blocked_range<long>(0, V0.rows()),
+        [&](const tbb::blocked_range<long>& range) {
+            for (long v = range.begin(); v < range.end(); v++) {
+                if (!vertex_on_edge[v]) {
+                    include_vertex[v] |= element_intersects_domain(
+                        V0, V1, Eigen::Matrix<long, 1, 1>(v), domain_min,
+                        domain_max, halo_radius);
+                }
+            }
+        });
+
+    // Compact the included elements, recording local→global maps, a
+    // global→local vertex reindexing, and per-element ownership (center of
+    // the element's box in the half-open domain, which is unique across
+    // domain boxes that tile space).
+    std::vector<index_t> vertex_global_to_local(V0.rows(), index_t(-1));
+    for (long v = 0; v < V0.rows(); v++) {
+        if (include_vertex[v]) {
+            vertex_global_to_local[v] = index_t(partition.vertex_map.size());
+            partition.vertex_map.push_back(index_t(v));
+            partition.is_vertex_owned.push_back(element_is_owned(
+                V0, V1, Eigen::Matrix<long, 1, 1>(v), domain_min, domain_max));
+        }
+    }
+
+    for (long e = 0; e < E.rows(); e++) {
+        if (include_edge[e]) {
+            partition.edge_map.push_back(index_t(e));
+            partition.is_edge_owned.push_back(element_is_owned(
+                V0, V1, E.row(e), domain_min, domain_max));
+        }
+    }
+    partition.edges.resize(partition.edge_map.size(), E.cols());
+    for (size_t e = 0; e < partition.edge_map.size(); e++) {
+        for (int i = 0; i < E.cols(); i++) {
+            partition.edges(e, i) =
+                vertex_global_to_local[E(partition.edge_map[e], i)];
+        }
+    }
+
+    for (long f = 0; f < F.rows(); f++) {
+        if (include_face[f]) {
+            partition.face_map.push_back(index_t(f));
+            partition.is_face_owned.push_back(element_is_owned(
+                V0, V1, F.row(f), domain_min, domain_max));
+        }
+    }
+    partition.faces.resize(partition.face_map.size(), F.cols());
+    for (size_t f = 0; f < partition.face_map.size(); f++) {
+        for (int i = 0; i < F.cols(); i++) {
+            partition.faces(f, i) =
+                vertex_global_to_local[F(partition.face_map[f], i)];
+        }
+    }
+
+    return partition;
+}
+
+} // namespace ipc
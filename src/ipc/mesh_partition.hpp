@@ -0,0 +1,105 @@
+#pragma once
+
+#include <ipc/utils/eigen_ext.hpp>
+#include <ipc/utils/index.hpp>
+
+#include <Eigen/Core>
+
+#include <vector>
+
+namespace ipc {
+
+/// @brief A spatial partition of a collision mesh for distributed detection.
+///
+/// Each rank of a domain-decomposed solver builds one partition from the
+/// axis-aligned box of the elements it owns: the partition contains every
+/// element whose box intersects the domain inflated by the halo radius, so
+/// detection on the partition sees all pairs an owned element can form. The
+/// toolkit stays transport agnostic — the caller exchanges boundary vertex
+/// positions and reduces results (e.g. MPI_Allreduce with MPI_MIN of the
+/// per-rank compute_collision_free_stepsize) itself.
+///
+/// Counting rules for globally consistent results:
+/// - The earliest time of impact is idempotent under duplication, so ranks
+///   simply take the minimum of their partition step sizes.
+/// - Potentials and their derivatives must count each constraint exactly
+///   once: sum only the constraints whose first primitive is owned (see
+///   is_vertex_owned / is_edge_owned / is_face_owned). Element ownership is
+///   unique across ranks when the domain boxes tile space, because an
+///   element is owned iff the center of its box lies in [min, max).
+///
+/// The halo radius must cover everything that can interact across a domain
+/// boundary: at least dhat plus the broad-phase inflation radius, plus the
+/// largest per-step displacement when the partition is reused for CCD.
+struct MeshPartition {
+    /// @brief Partition-local to global vertex indices.
+    std::vector<index_t> vertex_map;
+    /// @brief Partition-local to global edge indices.
+    std::vector<index_t> edge_map;
+    /// @brief Partition-local to global face indices.
+    std::vector<index_t> face_map;
+
+    /// @brief Edges of the partition indexed into partition-local vertices.
+    Eigen::MatrixXi edges;
+    /// @brief Faces of the partition indexed into partition-local vertices.
+    Eigen::MatrixXi faces;
+
+    /// @brief Per partition-local element: is this rank the unique owner?
+    std::vector<bool> is_vertex_owned;
+    std::vector<bool> is_edge_owned;
+    std::vector<bool> is_face_owned;
+
+    /// @brief The owned (uninflated) domain box.
+    ArrayMax3d domain_min, domain_max;
+    /// @brief Inflation of the domain used to select halo elements.
+    double halo_radius = 0;
+
+    /// @brief Gather this partition's vertex rows from the full mesh.
+    /// @param[in] V_full Vertices of the full collision mesh.
+    /// @return The partition-local vertex positions (#vertex_map × dim).
+    Eigen::MatrixXd vertices(ConstMatrixXdRef V_full) const;
+
+    /// @brief Does this partition own a point (min ≤ p < max per axis)?
+    bool owns_point(const VectorMax3d& p) const
+    {
+        return (domain_min <= p.array()).all()
+            && (p.array() < domain_max).all();
+    }
+};
+
+/// @brief Build the partition of a mesh for one domain box.
+///
+/// An element is included if its axis-aligned box (over V, or over the
+/// motion V0 → V1 in the CCD overload) intersects the domain inflated by
+/// halo_radius; the edges of every included face are always included so the
+/// partition is a valid CollisionMesh. Use domain boxes that tile space
+/// (half-open ownership, so ±infinity bounds are fine on outer boxes).
+/// @param[in] V Vertices of the full collision mesh.
+/// @param[in] E Edges of the full collision mesh.
+/// @param[in] F Faces of the full collision mesh.
+/// @param[in] domain_min Minimum corner of the owned domain box.
+/// @param[in] domain_max Maximum corner of the owned domain box.
+/// @param[in] halo_radius Inflation of the domain for halo selection.
+/// @return The partition (local mesh, global maps, and ownership flags).
+MeshPartition build_mesh_partition(
+    ConstMatrixXdRef V,
+    const Eigen::MatrixXi& E,
+    const Eigen::MatrixXi& F,
+    const ArrayMax3d& domain_min,
+    const ArrayMax3d& domain_max,
+    const double halo_radius);
+
+/// @brief Build the partition of a moving mesh for one domain box.
+///
+/// Elements are selected by the box of their motion from V0 to V1, so the
+/// partition is valid for CCD over the whole step.
+MeshPartition build_mesh_partition(
+    ConstMatrixXdRef V0,
+    ConstMatrixXdRef V1,
+    const Eigen::MatrixXi& E,
+    const Eigen::MatrixXi& F,
+    const ArrayMax3d& domain_min,
+    const ArrayMax3d& domain_max,
+    const double halo_radius);
+
+} // namespace ipc
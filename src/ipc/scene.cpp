@@ -0,0 +1,118 @@
+#include "scene.hpp"
+
+#include <ipc/friction/friction.hpp>
+
+namespace ipc {
+
+Scene::Scene(
+    const CollisionMesh& mesh,
+    const double dhat,
+    const BroadPhaseMethod method,
+    const double min_distance)
+    : m_mesh(mesh) // copied so the scene never outlives its mesh
+    , m_dhat(dhat)
+    , m_min_distance(min_distance)
+    , m_method(method)
+    , m_broad_phase(BroadPhase::make_broad_phase(method))
+{
+}
+
+void Scene::build_constraints(ConstMatrixXdRef V)
+{
+    m_constraints.build(*m_broad_phase, m_mesh, V, m_dhat, m_min_distance);
+    m_scene_bounds.invalidate();
+}
+
+void Scene::update_constraints(ConstMatrixXdRef V)
+{
+    m_constraints.update(*m_broad_phase, m_mesh, V, m_dhat, m_min_distance);
+    m_scene_bounds.invalidate();
+}
+
+double Scene::compute_barrier_potential(ConstMatrixXdRef V) const
+{
+    return ipc::compute_barrier_potential(m_mesh, V, m_constraints, m_dhat);
+}
+
+Eigen::VectorXd
+Scene::compute_barrier_potential_gradient(ConstMatrixXdRef V) const
+{
+    return ipc::compute_barrier_potential_gradient(
+        m_mesh, V, m_constraints, m_dhat);
+}
+
+Eigen::SparseMatrix<double> Scene::compute_barrier_potential_hessian(
+    ConstMatrixXdRef V, const bool project_hessian_to_psd) const
+{
+    return ipc::compute_barrier_potential_hessian(
+        m_mesh, V, m_constraints, m_dhat, project_hessian_to_psd);
+}
+
+IterationDerivatives Scene::compute_iteration_derivatives(
+    ConstMatrixXdRef V, const bool project_hessian_to_psd)
+{
+    if (m_friction_constraints.empty()) {
+        return ipc::compute_iteration_derivatives(
+            m_mesh, V, m_constraints, m_dhat, project_hessian_to_psd,
+            &m_workspace);
+    }
+    return ipc::compute_iteration_derivatives(
+        m_mesh, V, m_constraints, m_dhat, m_friction_V0,
+        m_friction_constraints, m_epsv_times_h, project_hessian_to_psd,
+        &m_workspace);
+}
+
+void Scene::build_friction_constraints(
+    ConstMatrixXdRef V,
+    const double barrier_stiffness,
+    const Eigen::VectorXd& mus,
+    const double epsv_times_h)
+{
+    // Refresh in place when the contact topology is unchanged and the
+    // vertices barely moved; rebuild from scratch otherwise.
+    if (m_friction_constraints.empty() || friction_rebuild_tolerance < 0
+        || !update_friction_constraint_set(
+            m_mesh, V, m_constraints, m_dhat, barrier_stiffness,
+            m_friction_constraints, friction_rebuild_tolerance)) {
+        construct_friction_constraint_set(
+            m_mesh, V, m_constraints, m_dhat, barrier_stiffness, mus,
+            m_friction_constraints);
+    }
+    m_friction_soa = FrictionConstraintsSoA(m_friction_constraints);
+    m_friction_V0 = V;
+    m_epsv_times_h = epsv_times_h;
+}
+
+double Scene::compute_friction_potential(ConstMatrixXdRef V) const
+{
+    if (m_friction_constraints.empty()) {
+        return 0;
+    }
+    return ipc::compute_friction_potential(
+        m_mesh, m_friction_V0, V, m_friction_constraints, m_friction_soa,
+        m_epsv_times_h);
+}
+
+double Scene::compute_collision_free_stepsize(
+    ConstMatrixXdRef V0, ConstMatrixXdRef V1, CCDBudget* const budget)
+{
+    if (m_ccd_broad_phase == nullptr) {
+        m_ccd_broad_phase = BroadPhase::make_broad_phase(m_method);
+    }
+    return ipc::compute_collision_free_stepsize(
+        *m_ccd_broad_phase, m_mesh, V0, V1, m_min_distance,
+        /*tolerance=*/1e-6, /*max_iterations=*/long(1e7),
+        /*adaptive_tolerance=*/false, budget);
+}
+
+double Scene::compute_minimum_distance(ConstMatrixXdRef V) const
+{
+    return ipc::compute_minimum_distance(m_mesh, V, m_constraints);
+}
+
+bool Scene::has_intersections(ConstMatrixXdRef V)
+{
+    return ipc::has_intersections(m_mesh, V, m_method, &m_scene_bounds);
+}
+
+} // namespace ipc
@@ -0,0 +1,208 @@
+#pragma once
+
+#include <ipc/ipc.hpp>
+#include <ipc/collision_mesh.hpp>
+#include <ipc/collisions/constraints.hpp>
+#include <ipc/friction/friction_constraint.hpp>
+#include <ipc/broad_phase/broad_phase.hpp>
+#include <ipc/utils/eigen_ext.hpp>
+#include <ipc/utils/scene_bounds.hpp>
+#include <ipc/utils/workspace.hpp>
+
+#include <Eigen/Core>
+#include <Eigen/Sparse>
+
+#include <memory>
+
+namespace ipc {
+
+/// @brief Stateful home for one scene's cross-step caches.
+///
+/// The free functions in ipc.hpp are stateless, so everything the toolkit
+/// can keep warm across steps — the broad phase and its build margin, the
+/// constraint builders and cached distances, the friction set, the assembly
+/// workspace, the scene bounds — must be owned and threaded through by the
+/// caller. A Scene owns those pieces and mirrors the free functions with
+/// step-scoped methods that route every cache automatically, so the caching
+/// features compose without the caller holding a dozen objects. The free
+/// functions remain the primitive API; a Scene only wires them together.
+///
+/// A typical implicit time step:
+/// @code
+/// ipc::Scene scene(mesh, dhat);
+/// // per step:
+/// scene.build_constraints(V0);
+/// scene.build_friction_constraints(V0, barrier_stiffness, mus, epsv_h);
+/// // per Newton iteration:
+/// auto derivatives = scene.compute_iteration_derivatives(V);
+/// double alpha = scene.compute_collision_free_stepsize(V, V_target);
+/// @endcode
+class Scene {
+public:
+    /// @brief Construct a scene.
+    /// @param mesh The collision mesh (copied, so the scene owns it).
+    /// @param dhat The activation distance of the barrier.
+    /// @param method Broad phase method (AUTO re-tunes it from timings).
+    /// @param min_distance The minimum distance allowable between any two
+    /// elements.
+    Scene(
+        const CollisionMesh& mesh,
+        const double dhat,
+        const BroadPhaseMethod method = BroadPhaseMethod::HASH_GRID,
+        const double min_distance = 0);
+
+    /// @brief Build the constraint set for the step's positions.
+    ///
+    /// Reuses the scene's warm broad phase (and its build margin, when one
+    /// is set) and the constraint set's persistent builders.
+    /// @param V Vertices of the collision mesh.
+    void build_constraints(ConstMatrixXdRef V);
+
+    /// @brief Warm-start update of the constraint set after the vertices
+    /// move (see Constraints::update()).
+    /// @param V Vertices of the collision mesh.
+    void update_constraints(ConstMatrixXdRef V);
+
+    /// @brief Compute the barrier potential for the built constraint set.
+    /// @param V Vertices of the collision mesh.
+    /// @returns The sum of all barrier potentials.
+    double compute_barrier_potential(ConstMatrixXdRef V) const;
+
+    /// @brief Compute the gradient of the barrier potential.
+    /// @param V Vertices of the collision mesh.
+    /// @returns The gradient of all barrier potentials (size |V|).
+    Eigen::VectorXd compute_barrier_potential_gradient(ConstMatrixXdRef V) const;
+
+    /// @brief Compute the hessian of the barrier potential.
+    /// @param V Vertices of the collision mesh.
+    /// @param project_hessian_to_psd Make sure the hessian is positive
+    /// semi-definite.
+    /// @returns The hessian of all barrier potentials (size |V| x |V|).
+    Eigen::SparseMatrix<double> compute_barrier_potential_hessian(
+        ConstMatrixXdRef V, const bool project_hessian_to_psd = true) const;
+
+    /// @brief Compute a Newton iteration's collision derivatives.
+    ///
+    /// Routes the scene's persistent workspace through
+    /// ipc::compute_iteration_derivatives(), so the fused barrier and
+    /// friction passes assemble without reallocating at steady state. The
+    /// friction terms are included whenever a friction set is built.
+    /// @param V Vertices of the collision mesh.
+    /// @param project_hessian_to_psd Make sure the hessians are positive
+    /// semi-definite.
+    /// @returns The barrier potential and the barrier and friction
+    /// derivatives.
+    IterationDerivatives compute_iteration_derivatives(
+        ConstMatrixXdRef V, const bool project_hessian_to_psd = true);
+
+    /// @brief Build the friction constraint set from the built contact set.
+    ///
+    /// Refreshes the existing set in place when the contact topology is
+    /// unchanged and the vertices barely moved (see
+    /// update_friction_constraint_set()); the positions are remembered as
+    /// the lagged friction positions.
+    /// @param V Vertices the friction constraints are lagged at.
+    /// @param barrier_stiffness The stiffness of the barrier.
+    /// @param mus Per-vertex coefficients of friction.
+    /// @param epsv_times_h Tolerance for the transition between static and
+    /// dynamic friction.
+    void build_friction_constraints(
+        ConstMatrixXdRef V,
+        const double barrier_stiffness,
+        const Eigen::VectorXd& mus,
+        const double epsv_times_h);
+
+    /// @brief Compute the friction potential against the lagged positions.
+    /// @param V Current vertices of the collision mesh.
+    /// @returns The sum of all friction potentials.
+    double compute_friction_potential(ConstMatrixXdRef V) const;
+
+    /// @brief Compute a maximal collision-free step size from V0 to V1.
+    ///
+    /// Uses a dedicated warm broad phase for the swept volume, so the
+    /// discrete structure built by build_constraints() stays valid.
+    /// @param V0 Vertex positions at start (assumed intersection free).
+    /// @param V1 Vertex positions at the full step's end.
+    /// @param budget Optional deadline budget (see CCDBudget).
+    /// @returns A step size in [0, 1] that is collision free.
+    double compute_collision_free_stepsize(
+        ConstMatrixXdRef V0,
+        ConstMatrixXdRef V1,
+        CCDBudget* const budget = nullptr);
+
+    /// @brief Compute the minimum distance of the built constraint set.
+    /// @param V Vertices of the collision mesh.
+    /// @returns The minimum distance between any non-adjacent elements.
+    double compute_minimum_distance(ConstMatrixXdRef V) const;
+
+    /// @brief Determine if the mesh has self intersections at V.
+    ///
+    /// Shares the scene-bounds cache with the other per-step consumers.
+    /// @param V Vertices of the collision mesh.
+    /// @return A boolean for if the mesh has intersections.
+    bool has_intersections(ConstMatrixXdRef V);
+
+    /// @brief The scene's collision mesh.
+    const CollisionMesh& mesh() const { return m_mesh; }
+
+    /// @brief The persistent broad phase (e.g., to set a build margin or
+    /// active zones before the first build).
+    BroadPhase& broad_phase() { return *m_broad_phase; }
+    const BroadPhase& broad_phase() const { return *m_broad_phase; }
+
+    /// @brief The constraint set (e.g., to configure
+    /// use_convergent_formulation or vertex_dhat before building).
+    Constraints& constraint_set() { return m_constraints; }
+    const Constraints& constraint_set() const { return m_constraints; }
+
+    /// @brief The friction constraint set.
+    const FrictionConstraints& friction_constraint_set() const
+    {
+        return m_friction_constraints;
+    }
+
+    /// @brief Maximum vertex movement (per coordinate) for which
+    /// build_friction_constraints() refreshes the set in place instead of
+    /// rebuilding it (see update_friction_constraint_set()). A refresh
+    /// keeps the tangent bases, closest points, and friction coefficients
+    /// of the original build; set to a negative value to always rebuild.
+    double friction_rebuild_tolerance = 1e-9;
+
+    /// @brief The activation distance of the barrier.
+    double dhat() const { return m_dhat; }
+
+    /// @brief The minimum distance allowable between any two elements.
+    double min_distance() const { return m_min_distance; }
+
+protected:
+    /// @brief The scene's collision mesh (owned).
+    CollisionMesh m_mesh;
+    double m_dhat;
+    double m_min_distance;
+    BroadPhaseMethod m_method;
+
+    /// @brief Broad phase kept warm across steps for the discrete builds.
+    std::unique_ptr<BroadPhase> m_broad_phase;
+    /// @brief Separate broad phase for the CCD sweeps, so a step-size query
+    /// does not clobber the discrete structure (lazily created).
+    std::unique_ptr<BroadPhase> m_ccd_broad_phase;
+
+    /// @brief The contact constraint set (builders stay warm across steps).
+    Constraints m_constraints;
+
+    /// @brief The friction constraint set and the positions it lags at.
+    FrictionConstraints m_friction_constraints;
+    /// @brief SoA mirror of the friction set, rebuilt with it (see
+    /// FrictionConstraintsSoA).
+    FrictionConstraintsSoA m_friction_soa;
+    Eigen::MatrixXd m_friction_V0;
+    double m_epsv_times_h = 0;
+
+    /// @brief Persistent scratch so repeated assemblies do not reallocate.
+    Workspace m_workspace;
+
+    /// @brief Per-step scene bounds shared by the bound-consuming queries.
+    SceneBounds m_scene_bounds;
+};
+
+} // namespace ipc
@@ -0,0 +1,141 @@
+#include "scene_batch.hpp"
+
+#include <ipc/utils/execution_context.hpp>
+#include <ipc/utils/local_to_global.hpp>
+#include <ipc/utils/profiler.hpp>
+
+#include <tbb/parallel_for.h>
+
+#include <algorithm>
+#include <limits>
+
+namespace ipc {
+
+size_t SceneBatch::add_scene(
+    const CollisionMesh& mesh, const BroadPhaseMethod method)
+{
+    Scene scene;
+    scene.mesh = &mesh;
+    scene.broad_phase = BroadPhase::make_broad_phase(method);
+    m_scenes.push_back(std::move(scene));
+    return m_scenes.size() - 1;
+}
+
+void SceneBatch::build_constraints(
+    const std::vector<Eigen::MatrixXd>& positions,
+    const double dhat,
+    const double dmin)
+{
+    IPC_PROFILE_SCOPE("SceneBatch::build_constraints");
+
+    assert(positions.size() == m_scenes.size());
+
+    // One task per scene: the nested parallel loops of Constraints::build
+    // mostly run inline while every thread has a scene of its own, and
+    // spread out when the scene counts or sizes are uneven.
+    execution_context().run([&] {
+        tbb::parallel_for(size_t(0), m_scenes.size(), [&](const size_t s) {
+            Scene& scene = m_scenes[s];
+            scene.constraint_set.build(
+                *scene.broad_phase, *scene.mesh, positions[s], dhat, dmin);
+        });
+    });
+}
+
+void SceneBatch::compute_barrier_potentials(
+    const std::vector<Eigen::MatrixXd>& positions,
+    const double dhat,
+    Eigen::VectorXd& potentials,
+    Eigen::VectorXd* const minimum_distances) const
+{
+    IPC_PROFILE_SCOPE("SceneBatch::compute_barrier_potentials");
+
+    assert(positions.size() == m_scenes.size());
+
+    potentials.setZero(m_scenes.size());
+    if (minimum_distances != nullptr) {
+        minimum_distances->setConstant(
+            m_scenes.size(), std::numeric_limits<double>::infinity());
+    }
+
+    execution_context().run([&] {
+        tbb::parallel_for(size_t(0), m_scenes.size(), [&](const size_t s) {
+            const Scene& scene = m_scenes[s];
+            const Constraints& constraint_set = scene.constraint_set;
+            const Eigen::MatrixXd& V = positions[s];
+            const Eigen::MatrixXi& E = scene.mesh->edges();
+            const Eigen::MatrixXi& F = scene.mesh->faces();
+
+            const bool use_cached_distances =
+                constraint_set.are_cached_distances_valid(V);
+
+            double potential = 0;
+            double min_dist = std::numeric_limits<double>::infinity();
+            constraint_set.for_each(
+                0, constraint_set.size(),
+                [&](const auto& constraint, const size_t /*i*/) {
+                    const double distance = use_cached_distances
+                            && constraint.cached_distance >= 0
+                        ? constraint.cached_distance
+                        : constraint.compute_distance(V, E, F);
+                    potential +=
+                        constraint.compute_potential(V, E, F, dhat, distance);
+                    min_dist = std::min(min_dist, distance);
+                });
+
+            potentials[s] = potential;
+            if (minimum_distances != nullptr) {
+                (*minimum_distances)[s] = min_dist;
+            }
+        });
+    });
+}
+
+void SceneBatch::compute_barrier_potential_gradients(
+    const std::vector<Eigen::MatrixXd>& positions,
+    const double dhat,
+    std::vector<Eigen::VectorXd>& gradients) const
+{
+    IPC_PROFILE_SCOPE("SceneBatch::compute_barrier_potential_gradients");
+
+    assert(positions.size() == m_scenes.size());
+
+    gradients.resize(m_scenes.size());
+
+    execution_context().run([&] {
+        tbb::parallel_for(size_t(0), m_scenes.size(), [&](const size_t s) {
+            const Scene& scene = m_scenes[s];
+            const Constraints& constraint_set = scene.constraint_set;
+            const Eigen::MatrixXd& V = positions[s];
+            const Eigen::MatrixXi& E = scene.mesh->edges();
+            const Eigen::MatrixXi& F = scene.mesh->faces();
+            const int dim = V.cols();
+
+            const bool use_cached_distances =
+                constraint_set.are_cached_distances_valid(V);
+
+            Eigen::VectorXd& grad = gradients[s];
+            grad.setZero(V.size());
+
+            VectorMax12d local_grad;
+            constraint_set.for_each(
+                0, constraint_set.size(),
+                [&](const auto& constraint, const size_t /*i*/) {
+                    if (use_cached_distances
+                        && constraint.cached_distance >= 0) {
+                        constraint.compute_potential_gradient(
+                            V, E, F, dhat, constraint.cached_distance,
+                            local_grad);
+                    } else {
+                        constraint.compute_potential_gradient(
+                            V, E, F, dhat, local_grad);
+                    }
+                    local_gradient_to_global_gradient(
+                        local_grad, constraint.vertex_indices(E, F), dim,
+                        grad);
+                });
+        });
+    });
+}
+
+} // namespace ipc
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <ipc/collision_mesh.hpp>
+#include <ipc/collisions/constraints.hpp>
+#include <ipc/broad_phase/broad_phase.hpp>
+#include <ipc/utils/eigen_ext.hpp>
+
+#include <Eigen/Core>
+
+#include <memory>
+#include <vector>
+
+namespace ipc {
+
+/// @brief A batch of independent scenes evaluated in one parallel region.
+///
+/// Throughput-oriented workloads (e.g. reinforcement-learning training)
+/// step hundreds of small simulations at once. Calling the per-scene entry
+/// points in a loop pays one parallel-region setup per scene and leaves
+/// most cores idle, because a small scene has too little work to spread.
+/// A SceneBatch holds one (mesh, broad phase, constraint set) triple per
+/// scene and processes all scenes in a single region with one task per
+/// scene, so the scheduling overhead is paid once and the scheduler
+/// balances whole scenes across the machine.
+///
+/// Within the batch-wide region each scene is evaluated serially: the
+/// global entry points (compute_barrier_potential() and friends) keep
+/// per-loop affinity partitioners that must not run concurrently with
+/// themselves, and a small scene gains nothing from nested parallelism
+/// anyway. The per-scene broad phases and constraint builders stay warm
+/// across steps, so steady-state batches build into already-allocated
+/// storage.
+///
+/// The meshes are referenced, not copied, and must outlive the batch.
+class SceneBatch {
+public:
+    /// @brief Add a scene to the batch.
+    /// @param mesh The scene's collision mesh (must outlive the batch).
+    /// @param method Broad-phase method used for the scene.
+    /// @return The scene's index in the batch.
+    size_t add_scene(
+        const CollisionMesh& mesh,
+        const BroadPhaseMethod method = BroadPhaseMethod::HASH_GRID);
+
+    /// @brief Number of scenes in the batch.
+    size_t num_scenes() const { return m_scenes.size(); }
+
+    /// @brief The constraint set of one scene (e.g. to configure
+    /// use_convergent_formulation or vertex_dhat before building).
+    Constraints& constraint_set(const size_t scene_i)
+    {
+        return m_scenes[scene_i].constraint_set;
+    }
+    const Constraints& constraint_set(const size_t scene_i) const
+    {
+        return m_scenes[scene_i].constraint_set;
+    }
+
+    /// @brief The broad phase of one scene (e.g. to set a build margin or
+    /// collision groups).
+    BroadPhase& broad_phase(const size_t scene_i)
+    {
+        return *m_scenes[scene_i].broad_phase;
+    }
+
+    /// @brief Build every scene's constraint set from its positions.
+    /// @param positions Per-scene vertex positions (one matrix per scene).
+    /// @param dhat The activation distance of the barrier.
+    /// @param dmin Minimum distance.
+    void build_constraints(
+        const std::vector<Eigen::MatrixXd>& positions,
+        const double dhat,
+        const double dmin = 0);
+
+    /// @brief Compute every scene's barrier potential.
+    ///
+    /// Reuses the distances cached by build_constraints() when the scene's
+    /// positions have not changed since the build.
+    /// @param[in] positions Per-scene vertex positions.
+    /// @param[in] dhat The activation distance of the barrier.
+    /// @param[out] potentials The per-scene potentials (resized to
+    /// num_scenes()).
+    /// @param[out] minimum_distances If given, the per-scene minimum
+    /// squared distances (infinity for scenes without constraints).
+    void compute_barrier_potentials(
+        const std::vector<Eigen::MatrixXd>& positions,
+        const double dhat,
+        Eigen::VectorXd& potentials,
+        Eigen::VectorXd* const minimum_distances = nullptr) const;
+
+    /// @brief Compute every scene's barrier potential gradient.
+    /// @param[in] positions Per-scene vertex positions.
+    /// @param[in] dhat The activation distance of the barrier.
+    /// @param[out] gradients The per-scene flattened gradients (resized to
+    /// num_scenes(); gradient i has positions[i].size() entries).
+    void compute_barrier_potential_gradients(
+        const std::vector<Eigen::MatrixXd>& positions,
+        const double dhat,
+        std::vector<Eigen::VectorXd>& gradients) const;
+
+protected:
+    struct Scene {
+        /// @brief The scene's collision mesh (non-owning).
+        const CollisionMesh* mesh;
+        /// @brief Broad phase kept warm across the batch's steps.
+        std::unique_ptr<BroadPhase> broad_phase;
+        /// @brief The scene's constraint set.
+        Constraints constraint_set;
+    };
+
+    std::vector<Scene> m_scenes;
+};
+
+} // namespace ipc
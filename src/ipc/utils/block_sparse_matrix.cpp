@@ -0,0 +1,87 @@
+#include "block_sparse_matrix.hpp"
+
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_sort.h>
+
+#include <cassert>
+#include <cstdint> // uint64_t
+
+namespace ipc {
+
+void BlockSparseMatrix::set_from_block_triplets(
+    const BlockTriplets& triplets,
+    const long num_block_rows,
+    const long num_block_cols,
+    const int block_size)
+{
+    assert(num_block_rows >= 0 && num_block_cols >= 0 && block_size > 0);
+
+    m_block_size = block_size;
+    m_num_block_cols = num_block_cols;
+
+    // Sort packed (row, col) keys so duplicate blocks form runs and the rows
+    // come out in compressed order (cf. merge_duplicate_constraints).
+    std::vector<std::pair<uint64_t, size_t>> keys(triplets.size());
+    tbb::parallel_for(size_t(0), triplets.size(), [&](size_t i) {
+        assert(triplets[i].row >= 0 && triplets[i].row < num_block_rows);
+        assert(triplets[i].col >= 0 && triplets[i].col < num_block_cols);
+        assert(triplets[i].block.rows() == block_size);
+        assert(triplets[i].block.cols() == block_size);
+        keys[i] = std::make_pair(
+            (uint64_t(triplets[i].row) << 32) | uint64_t(triplets[i].col), i);
+    });
+    tbb::parallel_sort(keys.begin(), keys.end());
+
+    m_outer.assign(num_block_rows + 1, 0);
+    m_inner.clear();
+    m_values.clear();
+
+    const int block_entries = block_size * block_size;
+    for (size_t i = 0; i < keys.size(); i++) {
+        const BlockTriplet& triplet = triplets[keys[i].second];
+        if (i == 0 || keys[i].first != keys[i - 1].first) {
+            m_outer[triplet.row + 1]++;
+            m_inner.push_back(int(triplet.col));
+            m_values.resize(m_values.size() + block_entries);
+        }
+        // Accumulate the block (row-major within the block).
+        double* values = &m_values[m_values.size() - block_entries];
+        for (int k = 0; k < block_size; k++) {
+            for (int l = 0; l < block_size; l++) {
+                values[block_size * k + l] += triplet.block(k, l);
+            }
+        }
+    }
+
+    // Prefix sum the per-row block counts into row pointers.
+    for (long i = 0; i < num_block_rows; i++) {
+        m_outer[i + 1] += m_outer[i];
+    }
+}
+
+Eigen::SparseMatrix<double> BlockSparseMatrix::to_sparse_matrix() const
+{
+    std::vector<Eigen::Triplet<double>> triplets;
+    triplets.reserve(num_blocks() * m_block_size * m_block_size);
+
+    for (long i = 0; i < num_block_rows(); i++) {
+        for (int b = m_outer[i]; b < m_outer[i + 1]; b++) {
+            const long j = m_inner[b];
+            const auto& block_b = block(b);
+            for (int k = 0; k < m_block_size; k++) {
+                for (int l = 0; l < m_block_size; l++) {
+                    triplets.emplace_back(
+                        m_block_size * i + k, m_block_size * j + l,
+                        block_b(k, l));
+                }
+            }
+        }
+    }
+
+    Eigen::SparseMatrix<double> A(
+        m_block_size * num_block_rows(), m_block_size * num_block_cols());
+    A.setFromTriplets(triplets.begin(), triplets.end());
+    return A;
+}
+
+} // namespace ipc
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <ipc/utils/eigen_ext.hpp>
+#include <ipc/utils/hugepage_allocator.hpp>
+
+#include <Eigen/Core>
+#include <Eigen/Sparse>
+
+#include <vector>
+
+namespace ipc {
+
+/// @brief A dense dim x dim block of a block sparse matrix together with its
+/// block row and column.
+struct BlockTriplet {
+    BlockTriplet() { }
+
+    BlockTriplet(const long row, const long col, const MatrixMax3d& block)
+        : row(row)
+        , col(col)
+        , block(block)
+    {
+    }
+
+    long row = -1; ///< Block row index.
+    long col = -1; ///< Block column index.
+    MatrixMax3d block; ///< Dense block values.
+};
+
+/// @brief Merged block triplet array, backed by transparent hugepages once
+/// it is large enough to pay for them (see hugepage_allocator); assembly
+/// walks it several times and its size scales with the hessian.
+using BlockTriplets =
+    std::vector<BlockTriplet, hugepage_allocator<BlockTriplet>>;
+
+/// @brief A sparse matrix of dense dim x dim blocks in block compressed row
+/// (BSR) storage.
+///
+/// Block-aware consumers (e.g. preconditioners built on the per-vertex dim x
+/// dim structure of a hessian) can use the blocks directly instead of
+/// re-detecting them in a scalar Eigen::SparseMatrix every iteration.
+class BlockSparseMatrix {
+public:
+    BlockSparseMatrix() { }
+
+    /// @brief Build the matrix from block triplets, summing duplicate blocks.
+    /// @param[in] triplets Blocks to assemble (in any order).
+    /// @param[in] num_block_rows Number of block rows.
+    /// @param[in] num_block_cols Number of block columns.
+    /// @param[in] block_size Rows (= columns) of each block.
+    void set_from_block_triplets(
+        const BlockTriplets& triplets,
+        const long num_block_rows,
+        const long num_block_cols,
+        const int block_size);
+
+    /// @brief Rows (= columns) of each block.
+    int block_size() const { return m_block_size; }
+
+    long num_block_rows() const { return long(m_outer.size()) - 1; }
+    long num_block_cols() const { return m_num_block_cols; }
+
+    /// @brief Number of stored (nonzero) blocks.
+    size_t num_blocks() const { return m_inner.size(); }
+
+    /// @brief Block row pointers (size num_block_rows() + 1).
+    const std::vector<int>& outer_index() const { return m_outer; }
+
+    /// @brief Block column index of each stored block.
+    const std::vector<int>& inner_index() const { return m_inner; }
+
+    /// @brief Stored block values (block_size² entries per block, row-major
+    /// within each block).
+    const std::vector<double>& values() const { return m_values; }
+
+    /// @brief Map of the b-th stored block.
+    Eigen::Map<const Eigen::Matrix<
+        double,
+        Eigen::Dynamic,
+        Eigen::Dynamic,
+        Eigen::RowMajor>>
+    block(const size_t b) const
+    {
+        assert(b < num_blocks());
+        return Eigen::Map<const Eigen::Matrix<
+            double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>>(
+            m_values.data() + b * m_block_size * m_block_size, m_block_size,
+            m_block_size);
+    }
+
+    /// @brief Expand the blocks into a scalar sparse matrix.
+    Eigen::SparseMatrix<double> to_sparse_matrix() const;
+
+protected:
+    /// @brief Rows (= columns) of each block.
+    int m_block_size = 0;
+    /// @brief Number of block columns.
+    long m_num_block_cols = 0;
+    /// @brief Block row pointers.
+    std::vector<int> m_outer = { 0 };
+    /// @brief Block column index of each stored block.
+    std::vector<int> m_inner;
+    /// @brief Stored block values (row-major within each block).
+    std::vector<double> m_values;
+};
+
+} // namespace ipc
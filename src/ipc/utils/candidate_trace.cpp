@@ -0,0 +1,247 @@
+#include "candidate_trace.hpp"
+
+#include <cstdint>
+#include <cstring> // std::memcmp
+#include <stdexcept>
+#include <vector>
+
+namespace ipc {
+
+namespace {
+
+    // Format tag (bumped when the layout changes).
+    constexpr char TRACE_MAGIC[8] = { 'I', 'P', 'C', 'T',
+                                      'R', 'C', 'E', '1' };
+
+    template <typename T> void write_pod(std::ostream& out, const T& value)
+    {
+        out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template <typename T> bool try_read_pod(std::istream& in, T& value)
+    {
+        in.read(reinterpret_cast<char*>(&value), sizeof(T));
+        return bool(in);
+    }
+
+    template <typename T> T read_pod(std::istream& in)
+    {
+        T value;
+        if (!try_read_pod(in, value)) {
+            throw std::runtime_error(
+                "Unexpected end of candidate trace data!");
+        }
+        return value;
+    }
+
+    /// Bulk write of a column-major double matrix (dimensions written by
+    /// the caller).
+    void write_doubles(std::ostream& out, ConstMatrixXdRef M)
+    {
+        // ConstMatrixXdRef may reference a row-major or strided block, so
+        // stage a contiguous column-major copy before the bulk write.
+        const Eigen::MatrixXd staged = M;
+        out.write(
+            reinterpret_cast<const char*>(staged.data()),
+            staged.size() * sizeof(double));
+    }
+
+    void read_doubles(
+        std::istream& in, Eigen::MatrixXd& M, const long rows,
+        const long cols)
+    {
+        M.resize(rows, cols);
+        in.read(
+            reinterpret_cast<char*>(M.data()), M.size() * sizeof(double));
+        if (!in) {
+            throw std::runtime_error(
+                "Unexpected end of candidate trace data!");
+        }
+    }
+
+    void write_indices(std::ostream& out, const std::vector<int64_t>& ids)
+    {
+        out.write(
+            reinterpret_cast<const char*>(ids.data()),
+            ids.size() * sizeof(int64_t));
+    }
+
+    std::vector<int64_t> read_indices(std::istream& in, const size_t count)
+    {
+        std::vector<int64_t> ids(count);
+        in.read(
+            reinterpret_cast<char*>(ids.data()),
+            ids.size() * sizeof(int64_t));
+        if (!in) {
+            throw std::runtime_error(
+                "Unexpected end of candidate trace data!");
+        }
+        return ids;
+    }
+
+    void write_int_matrix(std::ostream& out, const Eigen::MatrixXi& M)
+    {
+        write_pod<uint64_t>(out, M.rows());
+        write_pod<uint64_t>(out, M.cols());
+        std::vector<int64_t> staged(M.size());
+        for (long i = 0; i < M.size(); i++) {
+            staged[i] = M.data()[i]; // Column-major.
+        }
+        write_indices(out, staged);
+    }
+
+    Eigen::MatrixXi read_int_matrix(std::istream& in)
+    {
+        const uint64_t rows = read_pod<uint64_t>(in);
+        const uint64_t cols = read_pod<uint64_t>(in);
+        const std::vector<int64_t> staged = read_indices(in, rows * cols);
+        Eigen::MatrixXi M(rows, cols);
+        for (long i = 0; i < M.size(); i++) {
+            M.data()[i] = int(staged[i]); // Column-major.
+        }
+        return M;
+    }
+
+} // namespace
+
+CandidateTraceWriter::CandidateTraceWriter(
+    const std::string& filename, const CollisionMesh& mesh)
+    : m_out(filename, std::ios::binary | std::ios::trunc)
+{
+    if (!m_out) {
+        throw std::runtime_error(
+            "Unable to open candidate trace file for writing: " + filename
+            + "!");
+    }
+
+    m_out.write(TRACE_MAGIC, sizeof(TRACE_MAGIC));
+    write_pod<uint64_t>(m_out, mesh.num_vertices());
+    write_pod<uint64_t>(m_out, mesh.dim());
+    write_doubles(m_out, mesh.vertices_at_rest());
+    write_int_matrix(m_out, mesh.edges());
+    write_int_matrix(m_out, mesh.faces());
+    m_out.flush();
+
+    if (!m_out) {
+        throw std::runtime_error(
+            "Failed to write the candidate trace header!");
+    }
+}
+
+void CandidateTraceWriter::write_step(
+    ConstMatrixXdRef V0,
+    ConstMatrixXdRef V1,
+    const double dhat,
+    const Candidates& candidates)
+{
+    assert(V0.rows() == V1.rows() && V0.cols() == V1.cols());
+
+    write_pod<uint64_t>(m_out, V0.rows());
+    write_pod<uint64_t>(m_out, V0.cols());
+    write_pod<double>(m_out, dhat);
+    write_doubles(m_out, V0);
+    write_doubles(m_out, V1);
+
+    std::vector<int64_t> ids;
+    ids.reserve(2 * candidates.size());
+
+    write_pod<uint64_t>(m_out, candidates.ev_candidates.size());
+    for (const auto& ev : candidates.ev_candidates) {
+        ids.push_back(ev.edge_index);
+        ids.push_back(ev.vertex_index);
+    }
+    write_indices(m_out, ids);
+
+    ids.clear();
+    write_pod<uint64_t>(m_out, candidates.ee_candidates.size());
+    for (const auto& ee : candidates.ee_candidates) {
+        ids.push_back(ee.edge0_index);
+        ids.push_back(ee.edge1_index);
+    }
+    write_indices(m_out, ids);
+
+    ids.clear();
+    write_pod<uint64_t>(m_out, candidates.fv_candidates.size());
+    for (const auto& fv : candidates.fv_candidates) {
+        ids.push_back(fv.face_index);
+        ids.push_back(fv.vertex_index);
+    }
+    write_indices(m_out, ids);
+
+    // Flush per record so a trace from a crashed run is readable up to the
+    // last complete step.
+    m_out.flush();
+
+    if (!m_out) {
+        throw std::runtime_error("Failed to write the candidate trace!");
+    }
+}
+
+CandidateTraceReader::CandidateTraceReader(const std::string& filename)
+    : m_in(filename, std::ios::binary)
+{
+    if (!m_in) {
+        throw std::runtime_error(
+            "Unable to open candidate trace file for reading: " + filename
+            + "!");
+    }
+
+    char magic[8];
+    m_in.read(magic, sizeof(magic));
+    if (!m_in || std::memcmp(magic, TRACE_MAGIC, sizeof(magic)) != 0) {
+        throw std::runtime_error(
+            "File does not contain a candidate trace: " + filename + "!");
+    }
+
+    const uint64_t num_vertices = read_pod<uint64_t>(m_in);
+    const uint64_t dim = read_pod<uint64_t>(m_in);
+    read_doubles(m_in, m_vertices_at_rest, num_vertices, dim);
+    m_edges = read_int_matrix(m_in);
+    m_faces = read_int_matrix(m_in);
+}
+
+bool CandidateTraceReader::read_step(
+    Eigen::MatrixXd& V0,
+    Eigen::MatrixXd& V1,
+    double& dhat,
+    Candidates& candidates)
+{
+    uint64_t num_vertices;
+    if (!try_read_pod(m_in, num_vertices)) {
+        return false; // End of the trace.
+    }
+    const uint64_t dim = read_pod<uint64_t>(m_in);
+    dhat = read_pod<double>(m_in);
+    read_doubles(m_in, V0, num_vertices, dim);
+    read_doubles(m_in, V1, num_vertices, dim);
+
+    candidates.clear();
+
+    uint64_t n = read_pod<uint64_t>(m_in);
+    std::vector<int64_t> ids = read_indices(m_in, 2 * n);
+    candidates.ev_candidates.reserve(n);
+    for (uint64_t i = 0; i < n; i++) {
+        candidates.ev_candidates.emplace_back(
+            index_t(ids[2 * i]), index_t(ids[2 * i + 1]));
+    }
+
+    n = read_pod<uint64_t>(m_in);
+    ids = read_indices(m_in, 2 * n);
+    candidates.ee_candidates.reserve(n);
+    for (uint64_t i = 0; i < n; i++) {
+        candidates.ee_candidates.emplace_back(
+            index_t(ids[2 * i]), index_t(ids[2 * i + 1]));
+    }
+
+    n = read_pod<uint64_t>(m_in);
+    ids = read_indices(m_in, 2 * n);
+    candidates.fv_candidates.reserve(n);
+    for (uint64_t i = 0; i < n; i++) {
+        candidates.fv_candidates.emplace_back(
+            index_t(ids[2 * i]), index_t(ids[2 * i + 1]));
+    }
+
+    return true;
+}
+
+} // namespace ipc
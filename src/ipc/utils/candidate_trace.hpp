@@ -0,0 +1,92 @@
+#pragma once
+
+#include <ipc/broad_phase/collision_candidate.hpp>
+#include <ipc/collision_mesh.hpp>
+#include <ipc/utils/eigen_ext.hpp>
+
+#include <fstream>
+#include <string>
+
+namespace ipc {
+
+/// @brief Opt-in recorder of the per-step collision candidate streams.
+///
+/// Reproducing a production performance problem needs the exact candidate
+/// streams, not just the meshes. The writer captures the collision mesh
+/// topology once, then appends one record per step with the step's
+/// endpoints, dhat, and candidates, so an offline run can replay the steps
+/// through Constraints::build and compute_collision_free_stepsize (see
+/// CandidateTraceReader and the replayer in the tests tree).
+///
+/// The format is compact and memory-map friendly: fixed-width
+/// little-endian fields (64-bit counts and indices, 64-bit doubles) and
+/// bulk column-major arrays, written append-only and flushed after every
+/// record so a trace from a crashed run is readable up to the last
+/// complete step.
+class CandidateTraceWriter {
+public:
+    /// @brief Open a trace file and write the mesh header.
+    /// @param filename Path of the trace file (truncated if it exists).
+    /// @param mesh The collision mesh every recorded step uses.
+    /// @throws std::runtime_error If the file cannot be opened.
+    CandidateTraceWriter(
+        const std::string& filename, const CollisionMesh& mesh);
+
+    /// @brief Append one step's candidate stream to the trace.
+    /// @param V0 Surface vertex positions at the start of the step.
+    /// @param V1 Surface vertex positions at the end of the step.
+    /// @param dhat The activation distance used to build the candidates.
+    /// @param candidates The candidates detected for this step.
+    /// @throws std::runtime_error If the write fails.
+    void write_step(
+        ConstMatrixXdRef V0,
+        ConstMatrixXdRef V1,
+        const double dhat,
+        const Candidates& candidates);
+
+protected:
+    std::ofstream m_out;
+};
+
+/// @brief Reader of traces recorded by CandidateTraceWriter.
+class CandidateTraceReader {
+public:
+    /// @brief Open a trace file and read the mesh header.
+    /// @param filename Path of the trace file.
+    /// @throws std::runtime_error If the file cannot be opened or does not
+    /// contain a candidate trace.
+    CandidateTraceReader(const std::string& filename);
+
+    /// @brief Read the next recorded step.
+    /// @param[out] V0 Surface vertex positions at the start of the step.
+    /// @param[out] V1 Surface vertex positions at the end of the step.
+    /// @param[out] dhat The activation distance recorded for the step.
+    /// @param[out] candidates The candidates recorded for the step.
+    /// @returns False when the trace has no more complete steps.
+    /// @throws std::runtime_error If a record is malformed.
+    bool read_step(
+        Eigen::MatrixXd& V0,
+        Eigen::MatrixXd& V1,
+        double& dhat,
+        Candidates& candidates);
+
+    /// @brief Rest positions of the recorded collision mesh.
+    const Eigen::MatrixXd& vertices_at_rest() const
+    {
+        return m_vertices_at_rest;
+    }
+
+    /// @brief Edges of the recorded collision mesh.
+    const Eigen::MatrixXi& edges() const { return m_edges; }
+
+    /// @brief Faces of the recorded collision mesh.
+    const Eigen::MatrixXi& faces() const { return m_faces; }
+
+protected:
+    std::ifstream m_in;
+    Eigen::MatrixXd m_vertices_at_rest;
+    Eigen::MatrixXi m_edges;
+    Eigen::MatrixXi m_faces;
+};
+
+} // namespace ipc
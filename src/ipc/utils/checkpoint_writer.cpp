@@ -0,0 +1,135 @@
+#include "checkpoint_writer.hpp"
+
+#include <ipc/utils/logger.hpp>
+#include <ipc/utils/serialization.hpp>
+
+#include <cassert>
+#include <fstream>
+#include <stdexcept>
+
+namespace ipc {
+
+CheckpointWriter::CheckpointWriter()
+{
+    m_worker = std::thread([this]() { worker_loop(); });
+}
+
+CheckpointWriter::~CheckpointWriter()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_condition.notify_all();
+    m_worker.join();
+
+    if (m_error != nullptr) {
+        // A failure nobody flushed for; do not throw from a destructor.
+        try {
+            std::rethrow_exception(m_error);
+        } catch (const std::exception& e) {
+            logger().error("Unreported checkpoint write failure: {}", e.what());
+        }
+    }
+}
+
+void CheckpointWriter::submit(
+    const std::string& path,
+    ConstMatrixXdRef vertices,
+    const Constraints& constraint_set,
+    const FrictionConstraints& friction_constraint_set)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        int slot;
+        if (m_pending >= 0) {
+            // The worker is behind; keep the newest snapshot instead of
+            // blocking the simulation thread.
+            slot = m_pending;
+            m_num_dropped++;
+            logger().debug(
+                "Checkpoint writer is behind; replacing the pending "
+                "snapshot ({} dropped so far)",
+                m_num_dropped);
+        } else {
+            slot = (m_writing == 0) ? 1 : 0;
+        }
+
+        Snapshot& snapshot = m_buffers[slot];
+        snapshot.path = path;
+        snapshot.vertices = vertices;
+        snapshot.constraint_set = constraint_set;
+        snapshot.friction_constraint_set = friction_constraint_set;
+        m_pending = slot;
+    }
+    m_condition.notify_all();
+}
+
+void CheckpointWriter::flush()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_condition.wait(lock, [this]() {
+        return m_pending < 0 && m_writing < 0;
+    });
+    if (m_error != nullptr) {
+        std::exception_ptr error = nullptr;
+        std::swap(error, m_error);
+        std::rethrow_exception(error);
+    }
+}
+
+size_t CheckpointWriter::num_written() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_num_written;
+}
+
+size_t CheckpointWriter::num_dropped() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_num_dropped;
+}
+
+void CheckpointWriter::worker_loop()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true) {
+        m_condition.wait(
+            lock, [this]() { return m_pending >= 0 || m_stop; });
+        if (m_pending < 0) {
+            assert(m_stop);
+            return; // Drained; only stop after the last pending write.
+        }
+
+        m_writing = m_pending;
+        m_pending = -1;
+        const Snapshot& snapshot = m_buffers[m_writing];
+
+        lock.unlock(); // Serialize without blocking submit().
+        std::exception_ptr error = nullptr;
+        try {
+            std::ofstream out(snapshot.path, std::ios::binary);
+            if (!out) {
+                throw std::runtime_error(
+                    "Unable to open checkpoint file: " + snapshot.path);
+            }
+            save_checkpoint(
+                out, snapshot.vertices, snapshot.constraint_set,
+                snapshot.friction_constraint_set);
+        } catch (...) {
+            error = std::current_exception();
+        }
+        lock.lock();
+
+        m_writing = -1;
+        if (error == nullptr) {
+            m_num_written++;
+        } else if (m_error == nullptr) {
+            m_error = error; // Keep the first failure for flush().
+        }
+        m_condition.notify_all(); // Wake any flush().
+    }
+}
+
+} // namespace ipc
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <ipc/collisions/constraints.hpp>
+#include <ipc/friction/friction_constraint.hpp>
+#include <ipc/utils/eigen_ext.hpp>
+
+#include <array>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace ipc {
+
+/// @brief Asynchronous checkpoint pipeline.
+///
+/// Serializing a checkpoint synchronously (see save_checkpoint) stalls the
+/// simulation thread for the full encode-and-write time. A CheckpointWriter
+/// moves that work to a background thread: submit() copies the positions and
+/// constraint sets into one of two internal snapshot buffers and returns,
+/// while the worker thread serializes the other buffer to disk. The double
+/// buffering means the snapshot storage is allocated once and reused, so at
+/// a steady cadence a submit() costs the simulation thread only the copies.
+///
+/// If the worker is still writing when the next snapshot arrives, the
+/// pending (not yet written) snapshot is replaced rather than queued: the
+/// newest checkpoint is the one worth keeping, and the simulation thread
+/// never blocks on the disk. Replaced snapshots are counted in
+/// num_dropped().
+///
+/// The snapshots are private copies, so the caller may keep mutating its
+/// sets the moment submit() returns. Background write failures are reported
+/// by the next flush(); the destructor flushes, logs any unreported
+/// failure, and joins the worker.
+class CheckpointWriter {
+public:
+    CheckpointWriter();
+    ~CheckpointWriter();
+
+    // The worker thread holds pointers into this object.
+    CheckpointWriter(const CheckpointWriter&) = delete;
+    CheckpointWriter& operator=(const CheckpointWriter&) = delete;
+
+    /// @brief Snapshot the state and queue it for a background write.
+    ///
+    /// Returns as soon as the state is copied into an internal buffer; the
+    /// serialization and file write happen on the worker thread.
+    /// @param[in] path Filename to write the checkpoint to.
+    /// @param[in] vertices Vertex positions at the checkpointed step.
+    /// @param[in] constraint_set The set of constraints to checkpoint.
+    /// @param[in] friction_constraint_set The set of friction constraints
+    /// to checkpoint (may be empty).
+    void submit(
+        const std::string& path,
+        ConstMatrixXdRef vertices,
+        const Constraints& constraint_set,
+        const FrictionConstraints& friction_constraint_set =
+            FrictionConstraints());
+
+    /// @brief Block until every submitted snapshot has been written.
+    /// @throws std::runtime_error If a background write failed since the
+    /// last flush() (the first failure is rethrown).
+    void flush();
+
+    /// @brief The number of checkpoints written to disk so far.
+    size_t num_written() const;
+
+    /// @brief The number of snapshots replaced before they were written.
+    size_t num_dropped() const;
+
+protected:
+    /// @brief One buffered checkpoint; the storage is reused across
+    /// snapshots of the same scene so steady-state submits do not allocate.
+    struct Snapshot {
+        std::string path;
+        Eigen::MatrixXd vertices;
+        Constraints constraint_set;
+        FrictionConstraints friction_constraint_set;
+    };
+
+    /// @brief The worker thread's loop: drain pending snapshots until
+    /// stopped.
+    void worker_loop();
+
+    /// @brief Double buffer: submit() fills whichever slot the worker is
+    /// not writing.
+    std::array<Snapshot, 2> m_buffers;
+    /// @brief Index of the snapshot waiting to be written (-1 = none).
+    int m_pending = -1;
+    /// @brief Index of the snapshot the worker is writing (-1 = none).
+    int m_writing = -1;
+    bool m_stop = false;
+    size_t m_num_written = 0;
+    size_t m_num_dropped = 0;
+    /// @brief First unreported background failure (rethrown by flush()).
+    std::exception_ptr m_error;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::thread m_worker;
+};
+
+} // namespace ipc
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+#include <cassert>
+#include <vector>
+
+namespace ipc {
+
+/// @brief Append candidates with two-pass counting instead of push_back
+/// growth.
+///
+/// Emitting multi-hundred-MB candidate arrays through growing vectors
+/// repeatedly reallocates and copies them. This helper splits emission into
+/// a cheap counting pre-pass and a scatter: each slot (e.g. a hash bucket
+/// or a queried element) reports an upper bound on its emissions, an
+/// exclusive prefix sum turns the bounds into private scratch ranges, the
+/// slots then emit in parallel into their ranges, and one final parallel
+/// copy compacts the survivors into the output — a single scratch
+/// allocation and a single output resize in place of growth-copy traffic.
+///
+/// @tparam Candidate Emitted type; must be constructible from (0, 0).
+/// @param[in] num_slots Number of independently emitting slots.
+/// @param[in] count_upper_bound Callback (slot) returning an upper bound on
+///     the number of candidates emit() writes for that slot.
+/// @param[in] emit Callback (slot, Candidate* out) writing the slot's
+///     candidates to out and returning how many it wrote (at most the
+///     slot's bound).
+/// @param[out] candidates Output vector the candidates are appended to.
+template <typename Candidate, typename CountFunc, typename EmitFunc>
+void counting_scatter_append(
+    const long num_slots,
+    const CountFunc& count_upper_bound,
+    const EmitFunc& emit,
+    std::vector<Candidate>& candidates)
+{
+    // 1. Per-slot upper bounds and their exclusive prefix sum give every
+    // slot a private scratch range.
+    std::vector<long> scratch_offsets(num_slots + 1, 0);
+    tbb::parallel_for(
+        tbb::blocked_range<long>(0l, num_slots),
+        [&](const tbb::blocked_range<long>& r) {
+            for (long i = r.begin(); i < r.end(); i++) {
+                scratch_offsets[i + 1] = count_upper_bound(i);
+            }
+        });
+    for (long i = 0; i < num_slots; i++) {
+        scratch_offsets[i + 1] += scratch_offsets[i];
+    }
+    if (scratch_offsets[num_slots] == 0) {
+        return;
+    }
+
+    // 2. Scatter: every slot writes into its own range, so no
+    // synchronization is needed. The bounds may overestimate (e.g. they
+    // skip expensive filters), so the actual counts are kept for the
+    // compaction.
+    std::vector<Candidate> scratch(
+        scratch_offsets[num_slots], Candidate(0, 0));
+    std::vector<long> counts(num_slots);
+    tbb::parallel_for(
+        tbb::blocked_range<long>(0l, num_slots),
+        [&](const tbb::blocked_range<long>& r) {
+            for (long i = r.begin(); i < r.end(); i++) {
+                counts[i] = emit(i, scratch.data() + scratch_offsets[i]);
+                assert(
+                    counts[i]
+                    <= scratch_offsets[i + 1] - scratch_offsets[i]);
+            }
+        });
+
+    // 3. Compact the survivors into the output with one parallel copy.
+    std::vector<long> out_offsets(num_slots + 1, 0);
+    for (long i = 0; i < num_slots; i++) {
+        out_offsets[i + 1] = out_offsets[i] + counts[i];
+    }
+    const size_t base = candidates.size();
+    candidates.resize(base + out_offsets[num_slots]);
+    tbb::parallel_for(
+        tbb::blocked_range<long>(0l, num_slots),
+        [&](const tbb::blocked_range<long>& r) {
+            for (long i = r.begin(); i < r.end(); i++) {
+                std::copy(
+                    scratch.begin() + scratch_offsets[i],
+                    scratch.begin() + scratch_offsets[i] + counts[i],
+                    candidates.begin() + base + out_offsets[i]);
+            }
+        });
+}
+
+} // namespace ipc
@@ -0,0 +1,112 @@
+#include "dof_map_product_cache.hpp"
+
+#include <tbb/parallel_for.h>
+#include <tbb/blocked_range.h>
+
+#include <algorithm>
+#include <map>
+
+namespace ipc {
+
+Eigen::SparseMatrix<double> DofMapProductCache::product(
+    const Eigen::SparseMatrix<double>& D, const Eigen::SparseMatrix<double>& X)
+{
+    assert(D.rows() == X.rows() && X.rows() == X.cols());
+
+    if (!X.isCompressed()) {
+        Eigen::SparseMatrix<double> X_compressed = X;
+        X_compressed.makeCompressed();
+        return product(D, X_compressed);
+    }
+
+    if (!pattern_matches(X)) {
+        build_symbolic_product(D, X);
+    }
+
+    // Numeric phase: every result entry is an independent sum over its
+    // cached terms.
+    Eigen::SparseMatrix<double> result = m_pattern;
+    double* values = result.valuePtr();
+    const double* X_values = X.valuePtr();
+    tbb::parallel_for(
+        tbb::blocked_range<long>(0, result.nonZeros()),
+        [&](const tbb::blocked_range<long>& r) {
+            for (long k = r.begin(); k < r.end(); k++) {
+                double value = 0;
+                for (long t = m_term_offsets[k]; t < m_term_offsets[k + 1];
+                     t++) {
+                    value += m_terms[t].second * X_values[m_terms[t].first];
+                }
+                values[k] = value;
+            }
+        });
+
+    return result;
+}
+
+void DofMapProductCache::build_symbolic_product(
+    const Eigen::SparseMatrix<double>& D, const Eigen::SparseMatrix<double>& X)
+{
+    assert(X.isCompressed());
+
+    // Column i of Dᵀ holds the entries (r, D(i, r)) of row i of D.
+    Eigen::SparseMatrix<double> DT = D.transpose();
+    DT.makeCompressed();
+
+    // (Dᵀ X D)(r, c) = Σᵢⱼ D(i, r) X(i, j) D(j, c), so every entry X(i, j)
+    // contributes D(i, r)·D(j, c) for each pair of entries in rows i and j
+    // of D. Group the contributions by result entry.
+    std::map<std::pair<long, long>, std::vector<std::pair<int, double>>>
+        entries;
+    int t = 0;
+    for (int o = 0; o < X.outerSize(); o++) {
+        for (Eigen::SparseMatrix<double>::InnerIterator it(X, o); it;
+             ++it, ++t) {
+            const long i = it.row(), j = it.col();
+            for (Eigen::SparseMatrix<double>::InnerIterator Di(DT, i); Di;
+                 ++Di) {
+                for (Eigen::SparseMatrix<double>::InnerIterator Dj(DT, j); Dj;
+                     ++Dj) {
+                    entries[{ Di.row(), Dj.row() }].emplace_back(
+                        t, Di.value() * Dj.value());
+                }
+            }
+        }
+    }
+
+    std::vector<Eigen::Triplet<double>> triplets;
+    triplets.reserve(entries.size());
+    for (const auto& [rc, terms] : entries) {
+        triplets.emplace_back(rc.first, rc.second, 1.0);
+    }
+    m_pattern.resize(D.cols(), D.cols());
+    m_pattern.setFromTriplets(triplets.begin(), triplets.end());
+    m_pattern.makeCompressed();
+
+    // Flatten the per-entry term lists in the pattern's storage order.
+    m_term_offsets.assign(1, 0);
+    m_term_offsets.reserve(m_pattern.nonZeros() + 1);
+    m_terms.clear();
+    for (int o = 0; o < m_pattern.outerSize(); o++) {
+        for (Eigen::SparseMatrix<double>::InnerIterator it(m_pattern, o); it;
+             ++it) {
+            const auto& terms = entries.at({ it.row(), it.col() });
+            m_terms.insert(m_terms.end(), terms.begin(), terms.end());
+            m_term_offsets.push_back(long(m_terms.size()));
+        }
+    }
+
+    m_X_outer.assign(X.outerIndexPtr(), X.outerIndexPtr() + X.outerSize() + 1);
+    m_X_inner.assign(X.innerIndexPtr(), X.innerIndexPtr() + X.nonZeros());
+}
+
+bool DofMapProductCache::pattern_matches(
+    const Eigen::SparseMatrix<double>& X) const
+{
+    return long(m_X_outer.size()) == X.outerSize() + 1
+        && long(m_X_inner.size()) == X.nonZeros()
+        && std::equal(m_X_outer.begin(), m_X_outer.end(), X.outerIndexPtr())
+        && std::equal(m_X_inner.begin(), m_X_inner.end(), X.innerIndexPtr());
+}
+
+} // namespace ipc
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <Eigen/Core>
+#include <Eigen/Sparse>
+
+#include <utility>
+#include <vector>
+
+namespace ipc {
+
+/// @brief Reusable context for the sparse triple product Dᵀ X D.
+///
+/// The DOF map D is fixed for the lifetime of a CollisionMesh and the
+/// pattern of X (a constraint hessian) changes only when the constraint set
+/// changes, so the symbolic phase — the pattern of the product and the
+/// list of (entry of X, coefficient) terms contributing to every result
+/// entry — is computed once. Subsequent products with the same pattern run
+/// only the numeric phase, which is a parallel sum per result entry.
+class DofMapProductCache {
+public:
+    DofMapProductCache() { }
+
+    /// @brief Compute Dᵀ X D.
+    ///
+    /// Rebuilds the cached symbolic product if the pattern of X changed
+    /// since the previous call.
+    /// @warning The cache assumes D is the same matrix on every call; use
+    /// one cache per mesh.
+    /// @param[in] D The DOF map (maps full DOF to collision DOF).
+    /// @param[in] X The matrix to sandwich (compressed).
+    /// @returns The product Dᵀ X D.
+    Eigen::SparseMatrix<double> product(
+        const Eigen::SparseMatrix<double>& D,
+        const Eigen::SparseMatrix<double>& X);
+
+protected:
+    /// @brief Build the product pattern and the per-entry term lists.
+    void build_symbolic_product(
+        const Eigen::SparseMatrix<double>& D,
+        const Eigen::SparseMatrix<double>& X);
+
+    /// @brief Does the pattern of X match the cached pattern?
+    bool pattern_matches(const Eigen::SparseMatrix<double>& X) const;
+
+    /// @brief Compressed pattern of Dᵀ X D (values are scratch).
+    Eigen::SparseMatrix<double> m_pattern;
+    /// @brief Outer index array of the X pattern the cache was built for.
+    std::vector<int> m_X_outer;
+    /// @brief Inner index array of the X pattern the cache was built for.
+    std::vector<int> m_X_inner;
+    /// @brief Offsets of each result entry's terms into m_terms.
+    std::vector<long> m_term_offsets;
+    /// @brief Terms (index into X's value array, D(i,r)·D(j,c)) summed per
+    /// result entry.
+    std::vector<std::pair<int, double>> m_terms;
+};
+
+} // namespace ipc
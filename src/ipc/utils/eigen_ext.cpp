@@ -0,0 +1,140 @@
+#include "eigen_ext.hpp"
+
+#include <ipc/utils/execution_context.hpp>
+#include <ipc/utils/profiler.hpp>
+
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_sort.h>
+#include <tbb/blocked_range.h>
+
+#include <algorithm> // std::min
+
+namespace ipc {
+
+// Explicit instantiations of the concrete double projection cases declared
+// extern in eigen_ext.hpp, so the eigensolver-heavy templates are compiled
+// here once instead of in every TU that projects a local hessian.
+template MatrixMax2d project_to_pd(const MatrixMax2d& A, double eps);
+template MatrixMax12d project_to_pd(const MatrixMax12d& A, double eps);
+template MatrixMax2d project_to_psd(const MatrixMax2d& A);
+template MatrixMax12d project_to_psd(const MatrixMax12d& A);
+
+template <typename Scalar>
+Eigen::SparseMatrix<Scalar> sparse_from_triplets(
+    const Eigen::Index rows,
+    const Eigen::Index cols,
+    std::vector<Eigen::Triplet<Scalar>>& triplets)
+{
+    using StorageIndex = typename Eigen::SparseMatrix<Scalar>::StorageIndex;
+    using Triplet = Eigen::Triplet<Scalar>;
+
+    if (triplets.empty()) {
+        return Eigen::SparseMatrix<Scalar>(rows, cols);
+    }
+
+    IPC_PROFILE_SCOPE("sparse_from_triplets");
+
+    const auto compare = [](const Triplet& a, const Triplet& b) {
+        return a.col() != b.col() ? (a.col() < b.col()) : (a.row() < b.row());
+    };
+    const auto same_entry = [](const Triplet& a, const Triplet& b) {
+        return a.col() == b.col() && a.row() == b.row();
+    };
+
+    return execution_context().run([&] {
+        // Sort into compressed-column order (Eigen's storage order).
+        tbb::parallel_sort(triplets.begin(), triplets.end(), compare);
+
+        const size_t n = triplets.size();
+
+        // Segmented reduce of the duplicates: chop the sorted triplets into
+        // chunks whose starts are aligned to entry boundaries, count each
+        // chunk's unique entries, prefix-sum the counts, and let each chunk
+        // write its summed entries at its own offset.
+        constexpr size_t CHUNK_SIZE = size_t(1) << 20;
+        const size_t num_chunks = (n + CHUNK_SIZE - 1) / CHUNK_SIZE;
+
+        std::vector<size_t> starts(num_chunks + 1, n);
+        starts[0] = 0;
+        for (size_t c = 1; c < num_chunks; c++) {
+            size_t s = std::min(c * CHUNK_SIZE, n);
+            // A run of duplicates may span the nominal boundary; advance to
+            // its end so no entry is split between two chunks (runs longer
+            // than a chunk leave the following chunks empty, which is fine).
+            while (s < n && same_entry(triplets[s - 1], triplets[s])) {
+                s++;
+            }
+            starts[c] = s;
+        }
+
+        std::vector<size_t> offsets(num_chunks + 1, 0);
+        tbb::parallel_for(size_t(0), num_chunks, [&](const size_t c) {
+            size_t count = 0;
+            for (size_t i = starts[c]; i < starts[c + 1]; i++) {
+                if (i == starts[c]
+                    || !same_entry(triplets[i - 1], triplets[i])) {
+                    count++;
+                }
+            }
+            offsets[c + 1] = count;
+        });
+        for (size_t c = 0; c < num_chunks; c++) {
+            offsets[c + 1] += offsets[c];
+        }
+        const size_t nnz = offsets[num_chunks];
+
+        std::vector<StorageIndex> inner(nnz);
+        std::vector<StorageIndex> entry_cols(nnz);
+        std::vector<Scalar> values(nnz);
+        tbb::parallel_for(size_t(0), num_chunks, [&](const size_t c) {
+            size_t out = offsets[c];
+            for (size_t i = starts[c]; i < starts[c + 1]; i++) {
+                if (i == starts[c]
+                    || !same_entry(triplets[i - 1], triplets[i])) {
+                    inner[out] = StorageIndex(triplets[i].row());
+                    entry_cols[out] = StorageIndex(triplets[i].col());
+                    values[out] = triplets[i].value();
+                    out++;
+                } else {
+                    values[out - 1] += triplets[i].value();
+                }
+            }
+            assert(out == offsets[c + 1]);
+        });
+
+        // Column starts: each entry that opens a new column writes the
+        // offsets of every column since the previous entry's (the writes
+        // are disjoint, so the loop parallelizes over the entries).
+        std::vector<StorageIndex> outer(cols + 1, 0);
+        tbb::parallel_for(
+            tbb::blocked_range<size_t>(0, nnz),
+            [&](const tbb::blocked_range<size_t>& r) {
+                for (size_t i = r.begin(); i < r.end(); i++) {
+                    const StorageIndex col = entry_cols[i];
+                    const StorageIndex prev =
+                        i == 0 ? StorageIndex(-1) : entry_cols[i - 1];
+                    for (StorageIndex j = prev + 1; j <= col; j++) {
+                        outer[j] = StorageIndex(i);
+                    }
+                }
+            });
+        for (Eigen::Index j = entry_cols[nnz - 1] + 1; j <= cols; j++) {
+            outer[j] = StorageIndex(nnz);
+        }
+
+        return Eigen::SparseMatrix<Scalar>(
+            Eigen::Map<const Eigen::SparseMatrix<Scalar>>(
+                rows, cols, nnz, outer.data(), inner.data(), values.data()));
+    });
+}
+
+template Eigen::SparseMatrix<double> sparse_from_triplets(
+    const Eigen::Index rows,
+    const Eigen::Index cols,
+    std::vector<Eigen::Triplet<double>>& triplets);
+template Eigen::SparseMatrix<float> sparse_from_triplets(
+    const Eigen::Index rows,
+    const Eigen::Index cols,
+    std::vector<Eigen::Triplet<float>>& triplets);
+
+} // namespace ipc
@@ -3,6 +3,8 @@
 #include <Eigen/Core>
 #include <Eigen/SparseCore>
 
+#include <vector>
+
 namespace ipc {
 
 // Boolean scalar
@@ -11,6 +13,60 @@ typedef Eigen::Matrix<bool, Eigen::Dynamic, 1> VectorXb;
 typedef Eigen::Matrix<bool, 3, 1> Vector3b;
 typedef Eigen::Matrix<bool, Eigen::Dynamic, Eigen::Dynamic> MatrixXb;
 
+/// @brief Read-only view of a dense double matrix with runtime strides.
+///
+/// Binds an Eigen::MatrixXd (or a block or map of one) without copying and,
+/// through the Python bindings, a NumPy array of either storage order, so
+/// the hot entry points can be called from Python without a per-call copy
+/// of the vertex matrix. Row-major (interleaved) vertex storage binds
+/// copy-free through map_row_major() below.
+using ConstMatrixXdRef = const Eigen::Ref<
+    const Eigen::MatrixXd,
+    0,
+    Eigen::Stride<Eigen::Dynamic, Eigen::Dynamic>>&;
+
+/// @brief A dense double matrix stored row-major (interleaved xyzxyz…).
+using RowMajorMatrixXd =
+    Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+
+/// @brief View row-major interleaved data as a ConstMatrixXdRef without a
+/// copy or transpose.
+///
+/// Eigen::Ref requires the bound expression's storage order to match even
+/// with fully dynamic strides, so passing a row-major matrix to a
+/// ConstMatrixXdRef parameter silently copies it. This map swaps the
+/// strides instead (inner stride = cols, outer stride = 1), which is
+/// column-major-typed and therefore binds to every ConstMatrixXdRef entry
+/// point directly; per-vertex V.row(i) reads through it are unit stride.
+/// @param data Pointer to rows*cols doubles laid out row by row.
+/// @param rows Number of rows (vertices).
+/// @param cols Number of columns (the dimension).
+/// @return A read-only column-major-typed view of the row-major data.
+inline Eigen::
+    Map<const Eigen::MatrixXd, 0, Eigen::Stride<Eigen::Dynamic, Eigen::Dynamic>>
+    map_row_major(
+        const double* data, const Eigen::Index rows, const Eigen::Index cols)
+{
+    return Eigen::Map<
+        const Eigen::MatrixXd, 0,
+        Eigen::Stride<Eigen::Dynamic, Eigen::Dynamic>>(
+        data, rows, cols,
+        Eigen::Stride<Eigen::Dynamic, Eigen::Dynamic>(
+            /*outer=*/1, /*inner=*/cols));
+}
+
+/// @brief View a row-major matrix as a ConstMatrixXdRef without a copy
+/// (see the pointer overload).
+/// @param V The row-major matrix (e.g., vertex positions from an engine
+///          that stores them interleaved).
+/// @return A read-only column-major-typed view of V.
+inline Eigen::
+    Map<const Eigen::MatrixXd, 0, Eigen::Stride<Eigen::Dynamic, Eigen::Dynamic>>
+    map_row_major(const RowMajorMatrixXd& V)
+{
+    return map_row_major(V.data(), V.rows(), V.cols());
+}
+
 template <typename T, int dim, int max_dim = dim>
 using Vector = Eigen::Matrix<T, dim, 1, Eigen::ColMajor, max_dim, 1>;
 template <typename T, int dim, int max_dim = dim>
@@ -139,6 +195,16 @@ project_to_psd(
     const Eigen::Matrix<_Scalar, _Rows, _Cols, _Options, _MaxRows, _MaxCols>&
         A);
 
+// The projections instantiate a self-adjoint eigensolver (and an LDLT) per
+// matrix type, which is expensive to compile and shows up in every TU that
+// projects a local hessian. The concrete double cases used throughout the
+// library are compiled once in eigen_ext.cpp; other sizes and autodiff
+// scalar types still instantiate inline.
+extern template MatrixMax2d project_to_pd(const MatrixMax2d& A, double eps);
+extern template MatrixMax12d project_to_pd(const MatrixMax12d& A, double eps);
+extern template MatrixMax2d project_to_psd(const MatrixMax2d& A);
+extern template MatrixMax12d project_to_psd(const MatrixMax12d& A);
+
 /// Cross product for dynamically sized matrices.
 template <
     typename DerivedA,
@@ -150,6 +216,35 @@ template <
 Result cross(
     const Eigen::MatrixBase<DerivedA>& a, const Eigen::MatrixBase<DerivedB>& b);
 
+/// @brief Build a compressed sparse matrix from triplets in parallel.
+///
+/// Eigen's setFromTriplets is single-threaded, and on a cold hessian
+/// assembly (before any pattern cache exists) it is the dominant cost of
+/// the whole evaluation. This sorts the triplets into compressed-column
+/// order with a parallel sort, sums duplicates with a parallel segmented
+/// reduce, and writes the compressed arrays directly, so the construction
+/// scales with cores. The result is identical to setFromTriplets (duplicate
+/// entries summed, matrix compressed).
+/// @note The triplet vector is sorted in place.
+/// @param rows Number of rows of the matrix.
+/// @param cols Number of columns of the matrix.
+/// @param[in,out] triplets The entries (duplicates allowed); sorted in place.
+/// @return The compressed rows × cols matrix.
+template <typename Scalar>
+Eigen::SparseMatrix<Scalar> sparse_from_triplets(
+    const Eigen::Index rows,
+    const Eigen::Index cols,
+    std::vector<Eigen::Triplet<Scalar>>& triplets);
+
+extern template Eigen::SparseMatrix<double> sparse_from_triplets(
+    const Eigen::Index rows,
+    const Eigen::Index cols,
+    std::vector<Eigen::Triplet<double>>& triplets);
+extern template Eigen::SparseMatrix<float> sparse_from_triplets(
+    const Eigen::Index rows,
+    const Eigen::Index cols,
+    std::vector<Eigen::Triplet<float>>& triplets);
+
 /// Eigen IO Format to format vectors like vertex rows in an OBJ file.
 static const Eigen::IOFormat OBJ_VERTEX_FORMAT = Eigen::IOFormat(
     Eigen::FullPrecision, Eigen::DontAlignCols, " ", "", "v ", "\n", "", "");
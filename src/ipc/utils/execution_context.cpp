@@ -0,0 +1,91 @@
+#include "execution_context.hpp"
+
+namespace ipc {
+
+ExecutionContext& ExecutionContext::instance()
+{
+    static ExecutionContext context;
+    return context;
+}
+
+void ExecutionContext::set_max_concurrency(const int max_concurrency)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_max_concurrency = max_concurrency;
+    rebuild_arena();
+}
+
+int ExecutionContext::max_concurrency() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_max_concurrency;
+}
+
+void ExecutionContext::set_numa_node(const int numa_node)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_numa_node = numa_node;
+    rebuild_arena();
+}
+
+int ExecutionContext::numa_node() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_numa_node;
+}
+
+void ExecutionContext::set_deterministic(const bool deterministic)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_deterministic = deterministic;
+}
+
+bool ExecutionContext::deterministic() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_deterministic;
+}
+
+void ExecutionContext::rebuild_arena()
+{
+    if (m_max_concurrency == AUTOMATIC_CONCURRENCY
+        && m_numa_node == ANY_NUMA_NODE) {
+        m_arena = nullptr; // Back to the implicit global arena.
+        return;
+    }
+
+    tbb::task_arena::constraints constraints;
+    constraints.set_numa_id(m_numa_node);
+    if (m_max_concurrency != AUTOMATIC_CONCURRENCY) {
+        constraints.set_max_concurrency(m_max_concurrency);
+    }
+
+    m_arena = std::make_shared<tbb::task_arena>(constraints);
+    m_arena->initialize();
+}
+
+namespace {
+    /// The calling thread's innermost override (see ScopedExecutionContext).
+    thread_local ExecutionContext* tls_context_override = nullptr;
+} // namespace
+
+ScopedExecutionContext::ScopedExecutionContext(ExecutionContext& context)
+    : m_previous(tls_context_override)
+{
+    tls_context_override = &context;
+}
+
+ScopedExecutionContext::~ScopedExecutionContext()
+{
+    tls_context_override = m_previous;
+}
+
+ExecutionContext& execution_context()
+{
+    if (tls_context_override != nullptr) {
+        return *tls_context_override;
+    }
+    return ExecutionContext::instance();
+}
+
+} // namespace ipc
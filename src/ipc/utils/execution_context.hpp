@@ -0,0 +1,184 @@
+#pragma once
+
+#include <tbb/partitioner.h>
+#include <tbb/task_arena.h>
+
+#include <array>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+namespace ipc {
+
+/// @brief Execution context the toolkit's parallel regions run inside.
+///
+/// By default the toolkit's tbb::parallel_for calls run in the implicit
+/// global TBB arena and use every available core, which oversubscribes hosts
+/// that run their own job system next to the toolkit. Configuring this
+/// context (see execution_context()) moves all of the toolkit's parallel
+/// work into a dedicated tbb::task_arena with a bounded concurrency and,
+/// optionally, an affinity to one NUMA node, without touching the host's
+/// global TBB settings. While unconfigured, run() invokes the work directly
+/// and adds no overhead.
+class ExecutionContext {
+public:
+    /// @brief Get the toolkit-wide execution context.
+    static ExecutionContext& instance();
+
+    /// @brief Bound the number of threads the toolkit's parallel work uses.
+    /// @param max_concurrency Maximum number of threads, or
+    /// AUTOMATIC_CONCURRENCY to return to the implicit global arena.
+    void set_max_concurrency(const int max_concurrency);
+
+    /// @brief The configured concurrency bound (AUTOMATIC_CONCURRENCY if
+    /// unconfigured).
+    int max_concurrency() const;
+
+    /// @brief Pin the toolkit's parallel work to one NUMA node.
+    /// @note Honored on a best-effort basis: oneTBB falls back to no
+    /// affinity when its binding support (hwloc) is unavailable at runtime.
+    /// @param numa_node NUMA node id (see tbb::info::numa_nodes()), or
+    /// ANY_NUMA_NODE to remove the affinity.
+    void set_numa_node(const int numa_node);
+
+    /// @brief The configured NUMA node (ANY_NUMA_NODE if unconfigured).
+    int numa_node() const;
+
+    /// @brief Opt in to bitwise-reproducible parallel reductions.
+    ///
+    /// By default the reductions over the constraint sets (e.g. in
+    /// compute_barrier_potential) accumulate into thread-local partials that
+    /// merge in whatever order the scheduler produced them, so reruns of
+    /// identical inputs differ in the last bits. In deterministic mode the
+    /// work is split into fixed-size blocks that are summed in index order
+    /// and combined by an ordered pairwise tree (see ordered_reduction.hpp),
+    /// which makes the result independent of the thread count and schedule
+    /// at the cost of a few percent over the thread-local reduction.
+    void set_deterministic(const bool deterministic);
+
+    /// @brief Whether deterministic reductions are enabled (off by default).
+    bool deterministic() const;
+
+    /// @brief Run a callable inside the configured arena.
+    ///
+    /// All TBB parallel constructs invoked by f (including nested ones) use
+    /// the arena's threads. If the context is unconfigured, f is invoked
+    /// directly in the caller's arena.
+    /// @param f Callable with no arguments.
+    /// @return The value returned by f.
+    template <typename F> auto run(F&& f) -> decltype(f())
+    {
+        // Copy the handle so a concurrent reconfiguration cannot destroy the
+        // arena out from under the call.
+        std::shared_ptr<tbb::task_arena> arena;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            arena = m_arena;
+        }
+        if (arena == nullptr) {
+            return f();
+        }
+        return arena->execute(std::forward<F>(f));
+    }
+
+    /// @brief Identifies a per-step loop that keeps affinity state.
+    ///
+    /// One slot per loop that sweeps the same constraint arrays every step.
+    /// Alternative code paths over the same data (e.g. the triplet, cached
+    /// CSR, and block hessian assemblies) share a slot.
+    enum class AffinitySite : size_t {
+        BARRIER_POTENTIAL = 0,
+        BARRIER_GRADIENT,
+        BARRIER_HESSIAN,
+        BARRIER_POTENTIAL_AND_DERIVATIVES,
+        SHAPE_DERIVATIVE,
+        FRICTION_POTENTIAL,
+        FRICTION_GRADIENT,
+        FRICTION_HESSIAN,
+        FRICTION_POTENTIAL_AND_DERIVATIVES,
+        FRICTION_FORCE,
+        _COUNT
+    };
+
+    /// @brief Persistent affinity partitioner for a repeated per-step loop.
+    ///
+    /// tbb::affinity_partitioner records which thread ran which chunk and
+    /// replays the mapping on the next call, keeping each chunk in the
+    /// caches (and on the NUMA node) that already hold its data. The replay
+    /// only helps if the instance persists across steps, so one is kept per
+    /// loop site. The partitioners are per calling thread: a partitioner
+    /// must not be used by two loops concurrently, and threads that each
+    /// drive their own scene call the same entry points at the same time,
+    /// so each thread replays its own mapping (which is also the correct
+    /// one, since each scene sweeps its own constraint arrays).
+    static tbb::affinity_partitioner& affinity_partitioner(
+        const AffinitySite site)
+    {
+        static thread_local std::array<
+            tbb::affinity_partitioner, size_t(AffinitySite::_COUNT)>
+            partitioners;
+        return partitioners[size_t(site)];
+    }
+
+    /// @brief Sentinel for set_max_concurrency(): no explicit bound.
+    static constexpr int AUTOMATIC_CONCURRENCY = -1;
+    /// @brief Sentinel for set_numa_node(): no NUMA affinity.
+    static constexpr int ANY_NUMA_NODE = tbb::task_arena::automatic;
+
+    /// @brief Construct an independent context (see ScopedExecutionContext).
+    ///
+    /// Most callers use the process-wide instance through
+    /// execution_context(); independent instances back per-scene arenas.
+    ExecutionContext() { }
+
+protected:
+    /// @brief Recreate m_arena from the current settings (call under lock).
+    void rebuild_arena();
+
+    /// @brief Guards the settings and the arena handle.
+    mutable std::mutex m_mutex;
+    int m_max_concurrency = AUTOMATIC_CONCURRENCY;
+    int m_numa_node = ANY_NUMA_NODE;
+    bool m_deterministic = false;
+    /// @brief The arena parallel work runs in (nullptr if unconfigured).
+    std::shared_ptr<tbb::task_arena> m_arena;
+};
+
+/// @brief Scoped per-thread execution context override.
+///
+/// While an instance is alive, execution_context() on the constructing
+/// thread returns the given context instead of the process-wide one.
+/// A worker thread that packs one scene into the process can thereby give
+/// its scene a dedicated arena with a bounded concurrency (and optionally
+/// a NUMA node), so the scenes' parallel regions are isolated from each
+/// other and from the host's settings:
+/// @code
+/// // On each worker thread:
+/// ipc::ExecutionContext context;
+/// context.set_max_concurrency(threads_per_scene);
+/// ipc::ScopedExecutionContext scope(context);
+/// // ... step this worker's scene ...
+/// @endcode
+/// Overrides nest (the previous override is restored on destruction), and
+/// the context must outlive the scope. Other threads are unaffected.
+class ScopedExecutionContext {
+public:
+    explicit ScopedExecutionContext(ExecutionContext& context);
+    ~ScopedExecutionContext();
+
+    ScopedExecutionContext(const ScopedExecutionContext&) = delete;
+    ScopedExecutionContext& operator=(const ScopedExecutionContext&) = delete;
+
+protected:
+    /// @brief The override this scope replaced (restored on destruction).
+    ExecutionContext* m_previous;
+};
+
+/// @brief Retrieves the current thread's execution context.
+///
+/// Returns the innermost live ScopedExecutionContext override of the
+/// calling thread, or the process-wide context when there is none.
+/// @return A reference to the execution context object.
+ExecutionContext& execution_context();
+
+} // namespace ipc
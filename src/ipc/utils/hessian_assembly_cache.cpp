@@ -0,0 +1,149 @@
+#include "hessian_assembly_cache.hpp"
+
+#include <tbb/parallel_for.h>
+
+#include <algorithm> // std::fill, std::lower_bound
+#include <cassert>
+
+namespace ipc {
+
+namespace {
+    int num_block_vertices(const std::array<index_t, 4>& ids)
+    {
+        int n_verts = 0;
+        while (n_verts < 4 && ids[n_verts] >= 0) {
+            n_verts++;
+        }
+        return n_verts;
+    }
+} // namespace
+
+void HessianAssemblyCache::build_pattern(
+    const std::vector<std::array<index_t, 4>>& vertex_ids,
+    const int dim,
+    const long n)
+{
+    m_vertex_ids = vertex_ids;
+    m_dim = dim;
+
+    // One-time triplet pass to build the compressed pattern.
+    size_t num_entries = 0;
+    for (const std::array<index_t, 4>& ids : vertex_ids) {
+        const size_t loc = num_block_vertices(ids) * dim;
+        num_entries += loc * loc;
+    }
+
+    std::vector<Eigen::Triplet<double>> triplets;
+    triplets.reserve(num_entries);
+    for (const std::array<index_t, 4>& ids : vertex_ids) {
+        const int n_verts = num_block_vertices(ids);
+        for (int i = 0; i < n_verts; i++) {
+            for (int j = 0; j < n_verts; j++) {
+                for (int k = 0; k < dim; k++) {
+                    for (int l = 0; l < dim; l++) {
+                        triplets.emplace_back(
+                            dim * ids[i] + k, dim * ids[j] + l, 0.0);
+                    }
+                }
+            }
+        }
+    }
+
+    // The pattern triplets are as numerous as the hessian's, so compress
+    // them with the parallel builder; the pattern build is exactly the cold
+    // start the cache exists to amortize.
+    m_pattern = sparse_from_triplets(n, n, triplets);
+
+    // Locate every local block entry in the compressed value array so
+    // assembly can scatter without searching.
+    const auto* outer = m_pattern.outerIndexPtr();
+    const auto* inner = m_pattern.innerIndexPtr();
+
+    m_value_offsets.resize(vertex_ids.size());
+    tbb::parallel_for(size_t(0), vertex_ids.size(), [&](size_t c) {
+        const std::array<index_t, 4>& ids = vertex_ids[c];
+        const int n_verts = num_block_vertices(ids);
+
+        std::vector<int>& offsets = m_value_offsets[c];
+        offsets.clear();
+        offsets.reserve(size_t(n_verts * dim) * size_t(n_verts * dim));
+
+        // Local column-major order; assemble() scatters in the same order.
+        for (int j = 0; j < n_verts; j++) {
+            for (int l = 0; l < dim; l++) {
+                const long col = dim * ids[j] + l;
+                const auto* begin = inner + outer[col];
+                const auto* end = inner + outer[col + 1];
+                for (int i = 0; i < n_verts; i++) {
+                    for (int k = 0; k < dim; k++) {
+                        const long row = dim * ids[i] + k;
+                        const auto* it = std::lower_bound(begin, end, row);
+                        assert(it != end && *it == row);
+                        offsets.push_back(int(it - inner));
+                    }
+                }
+            }
+        }
+    });
+}
+
+bool HessianAssemblyCache::update_pattern(
+    const std::vector<std::array<index_t, 4>>& vertex_ids,
+    const int dim,
+    const long n)
+{
+    if (m_dim == dim && m_pattern.rows() == n && m_vertex_ids == vertex_ids) {
+        return false;
+    }
+    build_pattern(vertex_ids, dim, n);
+    return true;
+}
+
+void HessianAssemblyCache::export_pattern(
+    int* row_offsets, int* column_indices) const
+{
+    std::copy(
+        m_pattern.outerIndexPtr(),
+        m_pattern.outerIndexPtr() + m_pattern.outerSize() + 1, row_offsets);
+    std::copy(
+        m_pattern.innerIndexPtr(),
+        m_pattern.innerIndexPtr() + m_pattern.nonZeros(), column_indices);
+}
+
+void HessianAssemblyCache::assemble_values(
+    const std::vector<MatrixMax12d>& local_hessians,
+    double* values) const
+{
+    assert(local_hessians.size() == m_value_offsets.size());
+
+    std::fill(values, values + m_pattern.nonZeros(), 0.0);
+
+    for (size_t c = 0; c < local_hessians.size(); c++) {
+        const MatrixMax12d& local_hessian = local_hessians[c];
+        const std::vector<int>& offsets = m_value_offsets[c];
+        assert(size_t(local_hessian.size()) == offsets.size());
+
+        // Same local column-major order as the cached offsets.
+        const double* local_values = local_hessian.data();
+        for (size_t e = 0; e < offsets.size(); e++) {
+            values[offsets[e]] += local_values[e];
+        }
+    }
+}
+
+Eigen::SparseMatrix<double> HessianAssemblyCache::assemble(
+    const std::vector<MatrixMax12d>& local_hessians,
+    const std::vector<std::array<index_t, 4>>& vertex_ids,
+    const int dim,
+    const long n)
+{
+    assert(local_hessians.size() == vertex_ids.size());
+
+    update_pattern(vertex_ids, dim, n);
+
+    Eigen::SparseMatrix<double> hess = m_pattern;
+    assemble_values(local_hessians, hess.valuePtr());
+    return hess;
+}
+
+} // namespace ipc
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <ipc/utils/eigen_ext.hpp>
+#include <ipc/utils/index.hpp>
+
+#include <Eigen/Core>
+#include <Eigen/Sparse>
+
+#include <array>
+#include <vector>
+
+namespace ipc {
+
+/// @brief Reusable assembly context for constraint hessians.
+///
+/// The sparsity pattern of a constraint hessian changes only when the
+/// constraint set changes, not when the vertex positions move, so the
+/// compressed pattern and the offset of every local block entry into the
+/// value array are computed once. Subsequent assemblies with the same layout
+/// zero the cached values and scatter the dense local blocks directly into
+/// valuePtr(), avoiding a setFromTriplets per call.
+class HessianAssemblyCache {
+public:
+    HessianAssemblyCache() { }
+
+    /// @brief Assemble the global hessian from dense local blocks.
+    ///
+    /// Rebuilds the cached pattern if the layout (vertex indices, dimension,
+    /// or matrix size) changed since the previous call.
+    /// @param[in] local_hessians One dense block per constraint.
+    /// @param[in] vertex_ids Vertex indices of each block (unused slots -1).
+    /// @param[in] dim Spatial dimension (matrix rows per vertex).
+    /// @param[in] n Size of the (square) global matrix.
+    /// @returns The assembled global hessian.
+    Eigen::SparseMatrix<double> assemble(
+        const std::vector<MatrixMax12d>& local_hessians,
+        const std::vector<std::array<index_t, 4>>& vertex_ids,
+        const int dim,
+        const long n);
+
+    /// @brief Rebuild the cached pattern if the layout changed.
+    /// @param[in] vertex_ids Vertex indices of each block (unused slots -1).
+    /// @param[in] dim Spatial dimension (matrix rows per vertex).
+    /// @param[in] n Size of the (square) global matrix.
+    /// @returns True if the pattern was rebuilt; the caller must then
+    /// re-export it and resize any value buffers to num_non_zeros().
+    bool update_pattern(
+        const std::vector<std::array<index_t, 4>>& vertex_ids,
+        const int dim,
+        const long n);
+
+    /// @brief Number of stored entries in the cached pattern.
+    long num_non_zeros() const { return m_pattern.nonZeros(); }
+
+    /// @brief Copy the cached pattern into caller-owned CSR arrays.
+    ///
+    /// The hessian is symmetric, so its compressed-column pattern is also
+    /// its compressed-row pattern; the exported arrays can be read as row
+    /// pointers and column indices (or vice versa).
+    /// @param[out] row_offsets Per-row value starts (size n + 1).
+    /// @param[out] column_indices Column index of each value (size
+    /// num_non_zeros()).
+    void export_pattern(int* row_offsets, int* column_indices) const;
+
+    /// @brief Assemble the values into a caller-owned array.
+    ///
+    /// The values are written in the layout of the cached pattern (see
+    /// export_pattern()), giving a zero-copy hand-off to solvers with their
+    /// own CSR storage. The pattern must be current, i.e., update_pattern()
+    /// must have been called with the layout the blocks were computed for.
+    /// @param[in] local_hessians One dense block per constraint.
+    /// @param[out] values Value of each stored entry (size num_non_zeros());
+    /// overwritten, not accumulated into.
+    void assemble_values(
+        const std::vector<MatrixMax12d>& local_hessians,
+        double* values) const;
+
+protected:
+    /// @brief Build the compressed pattern and the value offsets.
+    void build_pattern(
+        const std::vector<std::array<index_t, 4>>& vertex_ids,
+        const int dim,
+        const long n);
+
+    /// @brief Compressed pattern of the hessian (values are scratch).
+    Eigen::SparseMatrix<double> m_pattern;
+    /// @brief Vertex indices the pattern was built for.
+    std::vector<std::array<index_t, 4>> m_vertex_ids;
+    /// @brief Per-constraint offsets of the local block entries (in local
+    /// column-major order) into the pattern's value array.
+    std::vector<std::vector<int>> m_value_offsets;
+    /// @brief Spatial dimension the pattern was built for.
+    int m_dim = 0;
+};
+
+} // namespace ipc
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <ipc/config.hpp>
+
+#include <cstdint>
+
+namespace ipc {
+
+/// @brief Index type of mesh elements in candidates, constraints, and hash
+/// items.
+///
+/// Defaults to long. Configuring with IPC_TOOLKIT_WITH_32BIT_INDICES shrinks
+/// it to 32 bits, halving the memory bandwidth of the broad- to narrow-phase
+/// hand-off; the mesh (and the hash grid's cell count) must then stay below
+/// 2^31 elements.
+#ifdef IPC_TOOLKIT_WITH_32BIT_INDICES
+using index_t = std::int32_t;
+#else
+using index_t = long;
+#endif
+
+} // namespace ipc
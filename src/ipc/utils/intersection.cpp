@@ -10,8 +10,59 @@
 
 #include <Eigen/Geometry>
 
+#include <limits>
+#include <vector>
+
 namespace ipc {
 
+namespace {
+    /// @brief Filtered signs of a batch of orient3d determinants.
+    ///
+    /// Computes the determinants det(a-d, b-d, c-d) for all rows at once and
+    /// compares each against Shewchuk's semi-static error bound for this
+    /// expression (o3derrboundA in the reference predicates): a determinant
+    /// farther from zero than the bound has a trustworthy sign. Returns +1 or
+    /// -1 for certain signs and 0 for determinants inside the bound, whose
+    /// sign (including an exact zero) must be decided by the exact predicate.
+    Eigen::ArrayXi filtered_orient3d_signs(
+        ConstMatrixXdRef a,
+        ConstMatrixXdRef b,
+        ConstMatrixXdRef c,
+        ConstMatrixXdRef d)
+    {
+        // Shewchuk's epsilon is half the IEEE machine epsilon.
+        constexpr double eps = std::numeric_limits<double>::epsilon() / 2;
+        constexpr double o3d_err_bound = (7 + 56 * eps) * eps;
+
+        const Eigen::ArrayXd adx = a.col(0).array() - d.col(0).array();
+        const Eigen::ArrayXd ady = a.col(1).array() - d.col(1).array();
+        const Eigen::ArrayXd adz = a.col(2).array() - d.col(2).array();
+        const Eigen::ArrayXd bdx = b.col(0).array() - d.col(0).array();
+        const Eigen::ArrayXd bdy = b.col(1).array() - d.col(1).array();
+        const Eigen::ArrayXd bdz = b.col(2).array() - d.col(2).array();
+        const Eigen::ArrayXd cdx = c.col(0).array() - d.col(0).array();
+        const Eigen::ArrayXd cdy = c.col(1).array() - d.col(1).array();
+        const Eigen::ArrayXd cdz = c.col(2).array() - d.col(2).array();
+
+        const Eigen::ArrayXd bdycdz = bdy * cdz, bdzcdy = bdz * cdy;
+        const Eigen::ArrayXd cdyadz = cdy * adz, cdzady = cdz * ady;
+        const Eigen::ArrayXd adybdz = ady * bdz, adzbdy = adz * bdy;
+
+        const Eigen::ArrayXd det = adx * (bdycdz - bdzcdy)
+            + bdx * (cdyadz - cdzady) + cdx * (adybdz - adzbdy);
+        const Eigen::ArrayXd err = o3d_err_bound
+            * (adx.abs() * (bdycdz.abs() + bdzcdy.abs())
+               + bdx.abs() * (cdyadz.abs() + cdzady.abs())
+               + cdx.abs() * (adybdz.abs() + adzbdy.abs()));
+
+        Eigen::ArrayXi signs(det.size());
+        for (Eigen::Index i = 0; i < det.size(); i++) {
+            signs[i] = det[i] > err[i] ? 1 : (det[i] < -err[i] ? -1 : 0);
+        }
+        return signs;
+    }
+} // namespace
+
 #ifdef IPC_TOOLKIT_WITH_RATIONAL_INTERSECTION
 bool is_edge_intersecting_triangle_rational(
     const Eigen::Vector3d& e0_float,
@@ -20,6 +71,11 @@ bool is_edge_intersecting_triangle_rational(
     const Eigen::Vector3d& t1_float,
     const Eigen::Vector3d& t2_float)
 {
+    // Pool the mpq allocations of this query: every temporary below comes
+    // from the thread's arena and is reclaimed wholesale when the scope
+    // (declared before all Rationals, so destroyed after them) ends.
+    const RationalPoolScope pool_scope;
+
     Vector3<Rational> e0, e1, t0, t1, t2;
 
     for (int d = 0; d < 3; ++d) {
@@ -101,17 +157,40 @@ bool is_edge_intersecting_triangle(
     const Eigen::Vector3d& t1,
     const Eigen::Vector3d& t2)
 {
+    using Orientation = igl::predicates::Orientation;
+
     igl::predicates::exactinit();
-    const auto ori1 = igl::predicates::orient3d(t0, t1, t2, e0);
-    const auto ori2 = igl::predicates::orient3d(t0, t1, t2, e1);
+    const Orientation ori1 = igl::predicates::orient3d(t0, t1, t2, e0);
+    const Orientation ori2 = igl::predicates::orient3d(t0, t1, t2, e1);
 
-    if (ori1 != igl::predicates::Orientation::COPLANAR
-        && ori2 != igl::predicates::Orientation::COPLANAR && ori1 == ori2) {
+    if (ori1 != Orientation::COPLANAR && ori2 != Orientation::COPLANAR
+        && ori1 == ori2) {
         // edge is completly on one side of the plane that triangle is in
         return false;
     }
 
-#ifdef IPC_TOOLKIT_USE_RATIONAL_INTERSECTION
+    if (ori1 != Orientation::COPLANAR || ori2 != Orientation::COPLANAR) {
+        // The edge meets the supporting plane of the triangle at a single
+        // point, so it intersects the triangle iff the line through the edge
+        // passes inside the triangle: the orientations of the edge against
+        // the triangle's sides must not have mixed strict signs. The
+        // orientation predicates are adaptively filtered (fast double
+        // evaluation with an exact fallback only when the result is within
+        // the rounding-error bound), so the common cases never pay for exact
+        // arithmetic.
+        const Orientation s1 = igl::predicates::orient3d(e0, e1, t0, t1);
+        const Orientation s2 = igl::predicates::orient3d(e0, e1, t1, t2);
+        const Orientation s3 = igl::predicates::orient3d(e0, e1, t2, t0);
+        const bool has_positive = s1 == Orientation::POSITIVE
+            || s2 == Orientation::POSITIVE || s3 == Orientation::POSITIVE;
+        const bool has_negative = s1 == Orientation::NEGATIVE
+            || s2 == Orientation::NEGATIVE || s3 == Orientation::NEGATIVE;
+        return !(has_positive && has_negative);
+    }
+
+    // Degenerate case: the edge lies inside the supporting plane of the
+    // triangle, which the filtered predicates above cannot decide.
+#ifdef IPC_TOOLKIT_WITH_RATIONAL_INTERSECTION
     return is_edge_intersecting_triangle_rational(e0, e1, t0, t1, t2);
 #else
     Eigen::Matrix3d M;
@@ -124,4 +203,80 @@ bool is_edge_intersecting_triangle(
 #endif
 }
 
+void are_edges_intersecting_triangles(
+    ConstMatrixXdRef e0,
+    ConstMatrixXdRef e1,
+    ConstMatrixXdRef t0,
+    ConstMatrixXdRef t1,
+    ConstMatrixXdRef t2,
+    ArrayXb& is_intersecting)
+{
+    const Eigen::Index n = e0.rows();
+    assert(e1.rows() == n && t0.rows() == n && t1.rows() == n);
+    assert(t2.rows() == n && e0.cols() == 3);
+
+    is_intersecting.setConstant(n, false);
+    if (n == 0) {
+        return;
+    }
+
+    // Plane-side orientations of both endpoints: tests whose endpoints are
+    // certainly on the same strict side are finished, tests with an
+    // uncertain orientation go to the exact fallback, and the rest cross the
+    // supporting plane and continue to the edge-side tests.
+    const Eigen::ArrayXi ori1 = filtered_orient3d_signs(t0, t1, t2, e0);
+    const Eigen::ArrayXi ori2 = filtered_orient3d_signs(t0, t1, t2, e1);
+
+    std::vector<Eigen::Index> crossing, uncertain;
+    for (Eigen::Index i = 0; i < n; i++) {
+        if (ori1[i] == 0 || ori2[i] == 0) {
+            uncertain.push_back(i);
+        } else if (ori1[i] != ori2[i]) {
+            crossing.push_back(i);
+        } // else: same strict side — not intersecting
+    }
+
+    if (!crossing.empty()) {
+        // Gather the plane-crossing tests into a compact batch for the
+        // edge-side orientations.
+        const Eigen::Index m = Eigen::Index(crossing.size());
+        Eigen::MatrixXd ce0(m, 3), ce1(m, 3), ct0(m, 3), ct1(m, 3), ct2(m, 3);
+        for (Eigen::Index k = 0; k < m; k++) {
+            const Eigen::Index i = crossing[k];
+            ce0.row(k) = e0.row(i);
+            ce1.row(k) = e1.row(i);
+            ct0.row(k) = t0.row(i);
+            ct1.row(k) = t1.row(i);
+            ct2.row(k) = t2.row(i);
+        }
+
+        const Eigen::ArrayXi s1 = filtered_orient3d_signs(ce0, ce1, ct0, ct1);
+        const Eigen::ArrayXi s2 = filtered_orient3d_signs(ce0, ce1, ct1, ct2);
+        const Eigen::ArrayXi s3 = filtered_orient3d_signs(ce0, ce1, ct2, ct0);
+
+        for (Eigen::Index k = 0; k < m; k++) {
+            if (s1[k] == 0 || s2[k] == 0 || s3[k] == 0) {
+                uncertain.push_back(crossing[k]);
+            } else {
+                // Same mixed strict sign rule as the scalar predicate; an
+                // exact zero sign is impossible here because zeros are never
+                // outside the error bound.
+                const bool has_positive =
+                    s1[k] > 0 || s2[k] > 0 || s3[k] > 0;
+                const bool has_negative =
+                    s1[k] < 0 || s2[k] < 0 || s3[k] < 0;
+                is_intersecting[crossing[k]] = !(has_positive && has_negative);
+            }
+        }
+    }
+
+    // Defer every test the filter could not decide to the exact predicate.
+    for (const Eigen::Index i : uncertain) {
+        is_intersecting[i] = is_edge_intersecting_triangle(
+            e0.row(i).transpose(), e1.row(i).transpose(),
+            t0.row(i).transpose(), t1.row(i).transpose(),
+            t2.row(i).transpose());
+    }
+}
+
 } // namespace ipc
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <ipc/utils/eigen_ext.hpp>
+
 #include <Eigen/Core>
 
 namespace ipc {
@@ -11,4 +13,25 @@ bool is_edge_intersecting_triangle(
     const Eigen::Vector3d& t1,
     const Eigen::Vector3d& t2);
 
+/// @brief Batched version of is_edge_intersecting_triangle.
+///
+/// Evaluates the orientation determinants of all tests at once with Eigen
+/// array arithmetic over structure-of-arrays coordinate columns, so the
+/// compiler vectorizes across the batch. Each determinant carries Shewchuk's
+/// semi-static error bound; tests whose determinants fall inside the bound
+/// (near-degenerate or coplanar configurations) are deferred to the exact
+/// scalar predicate, so the verdicts are identical to calling
+/// is_edge_intersecting_triangle per test.
+///
+/// @param[in] e0,e1 Segment endpoints, one row (x, y, z) per test.
+/// @param[in] t0,t1,t2 Triangle vertices, one row per test.
+/// @param[out] is_intersecting Resized to one verdict per test.
+void are_edges_intersecting_triangles(
+    ConstMatrixXdRef e0,
+    ConstMatrixXdRef e1,
+    ConstMatrixXdRef t0,
+    ConstMatrixXdRef t1,
+    ConstMatrixXdRef t2,
+    ArrayXb& is_intersecting);
+
 } // namespace ipc
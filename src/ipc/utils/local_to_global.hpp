@@ -1,8 +1,11 @@
 #pragma once
 
+#include <ipc/utils/block_sparse_matrix.hpp>
+
 #include <Eigen/Core>
 #include <Eigen/Sparse>
 
+#include <utility> // std::pair
 #include <vector>
 
 namespace ipc {
@@ -42,12 +45,59 @@ void local_gradient_to_global_gradient(
     }
 }
 
-template <typename Derived, typename IDContainer>
+/// @brief Scatter a local gradient into (index, value) entries.
+///
+/// Thread-local entry lists stay proportional to the work done by the
+/// thread, unlike a dense per-thread gradient whose allocation and final
+/// reduction are O(|V|) per thread regardless of the constraint count.
+template <typename DerivedLocalGrad, typename IDContainer>
+void local_gradient_to_global_gradient(
+    const Eigen::MatrixBase<DerivedLocalGrad>& local_grad,
+    const IDContainer& ids,
+    int dim,
+    std::vector<std::pair<long, double>>& grad_entries)
+{
+    assert(local_grad.size() % dim == 0);
+    const int n_verts = local_grad.size() / dim;
+    assert(ids.size() >= n_verts); // Can be extra ids
+    for (int i = 0; i < n_verts; i++) {
+        for (int d = 0; d < dim; d++) {
+            grad_entries.emplace_back(
+                dim * ids[i] + d, local_grad(dim * i + d));
+        }
+    }
+}
+
+/// @brief Compile-time dimension version of
+/// local_gradient_to_global_gradient.
+///
+/// With dim fixed at compile time the per-vertex inner loop unrolls and the
+/// index arithmetic constant-folds; call as
+/// local_gradient_to_global_gradient<2>(...) or <3>(...).
+template <int dim, typename DerivedLocalGrad, typename IDContainer>
+void local_gradient_to_global_gradient(
+    const Eigen::MatrixBase<DerivedLocalGrad>& local_grad,
+    const IDContainer& ids,
+    std::vector<std::pair<long, double>>& grad_entries)
+{
+    static_assert(dim == 2 || dim == 3, "dim must be 2 or 3");
+    assert(local_grad.size() % dim == 0);
+    const int n_verts = local_grad.size() / dim;
+    assert(ids.size() >= n_verts); // Can be extra ids
+    for (int i = 0; i < n_verts; i++) {
+        for (int d = 0; d < dim; d++) {
+            grad_entries.emplace_back(
+                dim * ids[i] + d, local_grad(dim * i + d));
+        }
+    }
+}
+
+template <typename Derived, typename IDContainer, typename Scalar>
 void local_hessian_to_global_triplets(
     const Eigen::MatrixBase<Derived>& local_hessian,
     const IDContainer& ids,
     int dim,
-    std::vector<Eigen::Triplet<double>>& triplets)
+    std::vector<Eigen::Triplet<Scalar>>& triplets)
 {
     assert(local_hessian.rows() == local_hessian.cols());
     assert(local_hessian.rows() % dim == 0);
@@ -59,11 +109,135 @@ void local_hessian_to_global_triplets(
                 for (int l = 0; l < dim; l++) {
                     triplets.emplace_back(
                         dim * ids[i] + k, dim * ids[j] + l,
-                        local_hessian(dim * i + k, dim * j + l));
+                        Scalar(local_hessian(dim * i + k, dim * j + l)));
                 }
             }
         }
     }
 }
 
+/// @brief Compile-time dimension version of local_hessian_to_global_triplets.
+template <int dim, typename Derived, typename IDContainer, typename Scalar>
+void local_hessian_to_global_triplets(
+    const Eigen::MatrixBase<Derived>& local_hessian,
+    const IDContainer& ids,
+    std::vector<Eigen::Triplet<Scalar>>& triplets)
+{
+    static_assert(dim == 2 || dim == 3, "dim must be 2 or 3");
+    assert(local_hessian.rows() == local_hessian.cols());
+    assert(local_hessian.rows() % dim == 0);
+    const int n_verts = local_hessian.rows() / dim;
+    assert(ids.size() >= n_verts); // Can be extra ids
+    for (int i = 0; i < n_verts; i++) {
+        for (int j = 0; j < n_verts; j++) {
+            for (int k = 0; k < dim; k++) {
+                for (int l = 0; l < dim; l++) {
+                    triplets.emplace_back(
+                        dim * ids[i] + k, dim * ids[j] + l,
+                        Scalar(local_hessian(dim * i + k, dim * j + l)));
+                }
+            }
+        }
+    }
+}
+
+/// @brief Write a local hessian's global triplets at a fixed offset.
+///
+/// Direct indexed writes into exactly presized storage: a constraint writes
+/// (dim * n_verts)^2 entries, so callers can compute offsets by prefix sum
+/// over the constraint counts and skip the push_back growth entirely (see
+/// compute_barrier_potential_hessian).
+template <int dim, typename Derived, typename IDContainer, typename Scalar>
+void local_hessian_to_global_triplets(
+    const Eigen::MatrixBase<Derived>& local_hessian,
+    const IDContainer& ids,
+    std::vector<Eigen::Triplet<Scalar>>& triplets,
+    const size_t offset)
+{
+    static_assert(dim == 2 || dim == 3, "dim must be 2 or 3");
+    assert(local_hessian.rows() == local_hessian.cols());
+    assert(local_hessian.rows() % dim == 0);
+    const int n_verts = local_hessian.rows() / dim;
+    assert(ids.size() >= n_verts); // Can be extra ids
+    assert(offset + size_t(local_hessian.size()) <= triplets.size());
+    size_t t = offset;
+    for (int i = 0; i < n_verts; i++) {
+        for (int j = 0; j < n_verts; j++) {
+            for (int k = 0; k < dim; k++) {
+                for (int l = 0; l < dim; l++) {
+                    triplets[t++] = Eigen::Triplet<Scalar>(
+                        dim * ids[i] + k, dim * ids[j] + l,
+                        Scalar(local_hessian(dim * i + k, dim * j + l)));
+                }
+            }
+        }
+    }
+}
+
+/// @brief Write only the upper triangle (column >= row) of a local
+/// hessian's global triplets at a fixed offset.
+///
+/// The local hessians are symmetric, so every lower-triangle entry is
+/// redundant with the transposed block emitted by the vertex pair in the
+/// opposite order; skipping them halves the triplet volume and the
+/// sort/merge cost of the assembly. A constraint writes exactly
+/// n * (n + 1) / 2 entries for n = dim * n_verts, so the prefix-sum offset
+/// scheme of the full version applies unchanged.
+template <int dim, typename Derived, typename IDContainer, typename Scalar>
+void local_hessian_to_global_upper_triplets(
+    const Eigen::MatrixBase<Derived>& local_hessian,
+    const IDContainer& ids,
+    std::vector<Eigen::Triplet<Scalar>>& triplets,
+    const size_t offset)
+{
+    static_assert(dim == 2 || dim == 3, "dim must be 2 or 3");
+    assert(local_hessian.rows() == local_hessian.cols());
+    assert(local_hessian.rows() % dim == 0);
+    const int n_verts = local_hessian.rows() / dim;
+    assert(ids.size() >= n_verts); // Can be extra ids
+    size_t t = offset;
+    for (int i = 0; i < n_verts; i++) {
+        for (int j = 0; j < n_verts; j++) {
+            if (i != j && ids[j] <= ids[i]) {
+                assert(ids[j] < ids[i]); // Stencil vertices are distinct
+                continue; // Lower block; the (j, i) pair emits its mirror
+            }
+            for (int k = 0; k < dim; k++) {
+                // Diagonal blocks keep only their own upper triangle.
+                for (int l = (i == j) ? k : 0; l < dim; l++) {
+                    triplets[t++] = Eigen::Triplet<Scalar>(
+                        dim * ids[i] + k, dim * ids[j] + l,
+                        Scalar(local_hessian(dim * i + k, dim * j + l)));
+                }
+            }
+        }
+    }
+    assert(
+        t - offset
+        == size_t(local_hessian.rows())
+            * (size_t(local_hessian.rows()) + 1) / 2);
+}
+
+/// @brief Scatter a local hessian into dim x dim block triplets for
+/// assembling a BlockSparseMatrix.
+template <typename Derived, typename IDContainer>
+void local_hessian_to_global_block_triplets(
+    const Eigen::MatrixBase<Derived>& local_hessian,
+    const IDContainer& ids,
+    int dim,
+    std::vector<BlockTriplet>& block_triplets)
+{
+    assert(local_hessian.rows() == local_hessian.cols());
+    assert(local_hessian.rows() % dim == 0);
+    const int n_verts = local_hessian.rows() / dim;
+    assert(ids.size() >= n_verts); // Can be extra ids
+    for (int i = 0; i < n_verts; i++) {
+        for (int j = 0; j < n_verts; j++) {
+            block_triplets.emplace_back(
+                ids[i], ids[j],
+                local_hessian.block(dim * i, dim * j, dim, dim));
+        }
+    }
+}
+
 } // namespace ipc
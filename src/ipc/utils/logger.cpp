@@ -1,14 +1,19 @@
 #include "logger.hpp"
 
+#include <spdlog/async.h>
 #include <spdlog/sinks/stdout_color_sinks.h>
 
+#include <mutex>
 #include <sstream>
 
 namespace ipc {
 
 namespace {
 
-    // Custom logger instance defined by the user, if any
+    // Custom logger instance defined by the user, if any. Guarded by a
+    // mutex so set_logger() is safe against concurrent logging threads.
+    std::mutex shared_logger_mutex;
+
     std::shared_ptr<spdlog::logger>& get_shared_logger()
     {
         static std::shared_ptr<spdlog::logger> logger;
@@ -20,14 +25,32 @@ namespace {
 // Retrieve current logger
 spdlog::logger& logger()
 {
-    if (get_shared_logger()) {
-        return *get_shared_logger();
+    // Pin the current logger in a thread-local handle so a concurrent
+    // set_logger() cannot destroy it while the calling thread still holds
+    // the returned reference (the pin lives until this thread's next call).
+    static thread_local std::shared_ptr<spdlog::logger> pinned;
+    {
+        std::lock_guard<std::mutex> lock(shared_logger_mutex);
+        pinned = get_shared_logger();
+    }
+    if (pinned) {
+        return *pinned;
     } else {
-        // When using factory methods provided by spdlog (_st and _mt
-        // functions), names must be unique, since the logger is registered
-        // globally. Otherwise, you will need to create the logger manually. See
-        // https://github.com/gabime/spdlog/wiki/2.-Creating-loggers
-        static auto default_logger = spdlog::stdout_color_mt("ipctk");
+        // Asynchronous default logger: messages are formatted and written
+        // by a dedicated worker behind a bounded queue, so a burst of
+        // warnings from the parallel hot loops never stalls the simulation
+        // threads; on overrun the oldest queued messages are dropped
+        // instead of blocking the producer. The thread pool is private to
+        // the library so it cannot clobber an application's global spdlog
+        // pool, and the logger is created manually so the name need not be
+        // unique in spdlog's global registry.
+        static auto thread_pool =
+            std::make_shared<spdlog::details::thread_pool>(
+                /*q_max_items=*/8192, /*threads_n=*/1);
+        static auto default_logger = std::make_shared<spdlog::async_logger>(
+            "ipctk",
+            std::make_shared<spdlog::sinks::stdout_color_sink_mt>(),
+            thread_pool, spdlog::async_overflow_policy::overrun_oldest);
         return *default_logger;
     }
 }
@@ -35,6 +58,7 @@ spdlog::logger& logger()
 // Use a custom logger
 void set_logger(std::shared_ptr<spdlog::logger> x)
 {
+    std::lock_guard<std::mutex> lock(shared_logger_mutex);
     get_shared_logger() = std::move(x);
 }
 
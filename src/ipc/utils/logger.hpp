@@ -1,5 +1,7 @@
 #pragma once
 
+#include <ipc/config.hpp>
+
 // clang-format off
 #include <spdlog/fmt/bundled/ranges.h>
 #include <spdlog/fmt/ostr.h>
@@ -9,12 +11,66 @@
 namespace ipc {
 
 /// Retrieves the current logger.
+///
+/// Safe to call from any thread: the default logger writes through a
+/// thread-safe sink, and the returned reference stays valid on the calling
+/// thread until its next logger() call even if set_logger() runs
+/// concurrently.
 /// @return A const reference to the logger object.
 spdlog::logger& logger();
 
-/// Setup a logger object. Calling this function with other function is not
-/// thread-safe.
+/// Setup a logger object.
+///
+/// Safe to call concurrently with logging threads; pass a logger with a
+/// thread-safe (_mt) sink if multiple threads log. Passing nullptr restores
+/// the default logger.
 /// @param[in] logger New logger object to be used.
 void set_logger(std::shared_ptr<spdlog::logger> logger);
 
 } // namespace ipc
+
+// Compile-time floor of the log calls compiled into the library (values
+// match spdlog's SPDLOG_LEVEL_*). The IPC_LOG_* macros below expand to
+// nothing for levels under the floor, so hot paths do not even pay the
+// runtime level check; the logger's runtime level still filters the levels
+// that remain. Configure through the IPC_TOOLKIT_LOG_ACTIVE_LEVEL CMake
+// cache variable.
+#ifndef IPC_TOOLKIT_LOG_ACTIVE_LEVEL
+#define IPC_TOOLKIT_LOG_ACTIVE_LEVEL SPDLOG_LEVEL_TRACE
+#endif
+
+#if IPC_TOOLKIT_LOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_TRACE
+#define IPC_LOG_TRACE(...) ipc::logger().trace(__VA_ARGS__)
+#else
+#define IPC_LOG_TRACE(...) (void)0
+#endif
+
+#if IPC_TOOLKIT_LOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_DEBUG
+#define IPC_LOG_DEBUG(...) ipc::logger().debug(__VA_ARGS__)
+#else
+#define IPC_LOG_DEBUG(...) (void)0
+#endif
+
+#if IPC_TOOLKIT_LOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_INFO
+#define IPC_LOG_INFO(...) ipc::logger().info(__VA_ARGS__)
+#else
+#define IPC_LOG_INFO(...) (void)0
+#endif
+
+#if IPC_TOOLKIT_LOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_WARN
+#define IPC_LOG_WARN(...) ipc::logger().warn(__VA_ARGS__)
+#else
+#define IPC_LOG_WARN(...) (void)0
+#endif
+
+#if IPC_TOOLKIT_LOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_ERROR
+#define IPC_LOG_ERROR(...) ipc::logger().error(__VA_ARGS__)
+#else
+#define IPC_LOG_ERROR(...) (void)0
+#endif
+
+#if IPC_TOOLKIT_LOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_CRITICAL
+#define IPC_LOG_CRITICAL(...) ipc::logger().critical(__VA_ARGS__)
+#else
+#define IPC_LOG_CRITICAL(...) (void)0
+#endif
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <Eigen/Core>
+#include <Eigen/Sparse>
+
+#include <vector>
+
+namespace ipc {
+
+/// @brief Bytes of heap memory held by a std::vector.
+/// Counts the allocated capacity, not only the used size.
+template <typename T, typename Allocator>
+size_t vector_bytes_used(const std::vector<T, Allocator>& v)
+{
+    return v.capacity() * sizeof(T);
+}
+
+/// @brief Bytes of heap memory held by a dense Eigen matrix or vector.
+template <typename Derived>
+size_t matrix_bytes_used(const Eigen::PlainObjectBase<Derived>& M)
+{
+    return M.size() * sizeof(typename Derived::Scalar);
+}
+
+/// @brief Bytes of heap memory held by a sparse vector.
+inline size_t sparse_vector_bytes_used(const Eigen::SparseVector<double>& v)
+{
+    return v.nonZeros()
+        * (sizeof(double)
+           + sizeof(Eigen::SparseVector<double>::StorageIndex));
+}
+
+} // namespace ipc
@@ -1,25 +1,55 @@
 #pragma once
 
+#include <tbb/blocked_range.h>
 #include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
+
+#include <algorithm> // std::copy
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace ipc {
 
-template <typename T>
+template <typename T, typename LocalAllocator, typename Allocator>
 void merge_thread_local_vectors(
-    const tbb::enumerable_thread_specific<std::vector<T>>& vectors,
-    std::vector<T>& out)
+    const tbb::enumerable_thread_specific<std::vector<T, LocalAllocator>>&
+        vectors,
+    std::vector<T, Allocator>& out)
 {
-    // size up the hash items
+    // size up the output and record where each thread-local chunk lands
     size_t size = out.size();
+    std::vector<std::pair<const std::vector<T, LocalAllocator>*, size_t>>
+        chunks;
     for (const auto& vector : vectors) {
+        chunks.emplace_back(&vector, size);
         size += vector.size();
     }
-    // serial merge!
-    out.reserve(size);
-    for (const auto& vector : vectors) {
-        out.insert(out.end(), vector.begin(), vector.end());
+
+    if constexpr (std::is_default_constructible_v<T>) {
+        // Parallel merge: threads copy whole chunks into disjoint ranges of
+        // out. With a default-initializing allocator (see
+        // default_init_allocator) the resize does not write the new
+        // elements, so on NUMA machines their pages land on the sockets of
+        // the copying threads rather than all on the resizing one.
+        out.resize(size);
+        tbb::parallel_for(
+            tbb::blocked_range<size_t>(0, chunks.size()),
+            [&](const tbb::blocked_range<size_t>& r) {
+                for (size_t i = r.begin(); i < r.end(); i++) {
+                    std::copy(
+                        chunks[i].first->begin(), chunks[i].first->end(),
+                        out.begin() + chunks[i].second);
+                }
+            },
+            tbb::static_partitioner());
+    } else {
+        // serial merge!
+        out.reserve(size);
+        for (const auto& chunk : chunks) {
+            out.insert(out.end(), chunk.first->begin(), chunk.first->end());
+        }
     }
 }
 
-} // namespace ipc
\ No newline at end of file
+} // namespace ipc
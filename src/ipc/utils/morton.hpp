@@ -0,0 +1,52 @@
+#pragma once
+
+#include <ipc/utils/eigen_ext.hpp>
+
+#include <algorithm> // std::min/max
+#include <cstdint>
+
+namespace ipc {
+
+/// @brief Expand a 10-bit integer into 30 bits by inserting 2 zeros after
+/// each bit.
+inline uint32_t expand_bits_3d(uint32_t v)
+{
+    v = (v * 0x00010001u) & 0xFF0000FFu;
+    v = (v * 0x00000101u) & 0x0F00F00Fu;
+    v = (v * 0x00000011u) & 0xC30C30C3u;
+    v = (v * 0x00000005u) & 0x49249249u;
+    return v;
+}
+
+/// @brief Expand a 16-bit integer into 32 bits by inserting a zero after each
+/// bit.
+inline uint32_t expand_bits_2d(uint32_t v)
+{
+    v = (v | (v << 8)) & 0x00FF00FFu;
+    v = (v | (v << 4)) & 0x0F0F0F0Fu;
+    v = (v | (v << 2)) & 0x33333333u;
+    v = (v | (v << 1)) & 0x55555555u;
+    return v;
+}
+
+/// @brief Compute the Morton code of a point p normalized to the unit box.
+inline uint32_t morton_code(const ArrayMax3d& p)
+{
+    if (p.size() == 2) {
+        const uint32_t x =
+            uint32_t(std::min(std::max(p.x() * 65536.0, 0.0), 65535.0));
+        const uint32_t y =
+            uint32_t(std::min(std::max(p.y() * 65536.0, 0.0), 65535.0));
+        return (expand_bits_2d(y) << 1) | expand_bits_2d(x);
+    }
+    const uint32_t x =
+        uint32_t(std::min(std::max(p.x() * 1024.0, 0.0), 1023.0));
+    const uint32_t y =
+        uint32_t(std::min(std::max(p.y() * 1024.0, 0.0), 1023.0));
+    const uint32_t z =
+        uint32_t(std::min(std::max(p.z() * 1024.0, 0.0), 1023.0));
+    return (expand_bits_3d(x) << 2) | (expand_bits_3d(y) << 1)
+        | expand_bits_3d(z);
+}
+
+} // namespace ipc
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace ipc {
+
+/// @brief Allocator adaptor that default-initializes instead of
+/// value-initializing new elements.
+///
+/// For trivially default-constructible element types, growing a vector with
+/// this allocator does not write the new elements, so the pages backing them
+/// are first touched by whichever thread writes them first. Linux places
+/// each page on the NUMA node of its first toucher, so filling the buffer
+/// with a parallel loop spreads it across the sockets that will later
+/// stream it, instead of leaving every page on the socket that called
+/// resize. Explicit placement policies (e.g. interleaving via libnuma) are
+/// left to the embedding application.
+template <typename T, typename A = std::allocator<T>>
+struct default_init_allocator : public A {
+    using A::A;
+
+    template <typename U> struct rebind {
+        using other = default_init_allocator<
+            U,
+            typename std::allocator_traits<A>::template rebind_alloc<U>>;
+    };
+
+    template <typename U>
+    void construct(U* ptr) noexcept(
+        std::is_nothrow_default_constructible<U>::value)
+    {
+        ::new (static_cast<void*>(ptr)) U;
+    }
+
+    template <typename U, typename... Args>
+    void construct(U* ptr, Args&&... args)
+    {
+        std::allocator_traits<A>::construct(
+            static_cast<A&>(*this), ptr, std::forward<Args>(args)...);
+    }
+};
+
+} // namespace ipc
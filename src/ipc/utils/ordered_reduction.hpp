@@ -0,0 +1,46 @@
+#pragma once
+
+#include <algorithm> // std::min
+#include <cstddef>
+#include <vector>
+
+namespace ipc {
+
+/// @brief Number of elements each block covers in a deterministic reduction
+/// (see ExecutionContext::set_deterministic).
+///
+/// Fixed independently of the thread count so the blocking — and with it the
+/// floating-point result — does not change across machines or schedules.
+/// Small enough to expose parallelism on the test meshes, large enough that
+/// the per-block bookkeeping stays negligible.
+constexpr size_t DETERMINISTIC_BLOCK_SIZE = 256;
+
+/// @brief Number of fixed-size blocks covering n elements.
+inline size_t num_deterministic_blocks(const size_t n)
+{
+    return (n + DETERMINISTIC_BLOCK_SIZE - 1) / DETERMINISTIC_BLOCK_SIZE;
+}
+
+/// @brief Sum block partials by combining adjacent pairs until one remains.
+///
+/// The combination tree depends only on values.size(), so together with the
+/// fixed blocking the total is bitwise-identical across runs and thread
+/// counts (and more accurate than a left-to-right sum of the same partials).
+/// Overwrites values in the process.
+inline double ordered_pairwise_sum(std::vector<double>& values)
+{
+    if (values.empty()) {
+        return 0;
+    }
+    for (size_t n = values.size(); n > 1; n = (n + 1) / 2) {
+        for (size_t i = 0; i < n / 2; i++) {
+            values[i] = values[2 * i] + values[2 * i + 1];
+        }
+        if (n % 2 == 1) {
+            values[n / 2] = values[n - 1];
+        }
+    }
+    return values[0];
+}
+
+} // namespace ipc
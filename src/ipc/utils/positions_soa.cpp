@@ -0,0 +1,47 @@
+#include "positions_soa.hpp"
+
+namespace ipc {
+
+void PositionsSoA::update(ConstMatrixXdRef V)
+{
+    m_num_vertices = V.rows();
+    m_dim = V.cols();
+    assert(m_dim == 2 || m_dim == 3);
+
+    // Pad to a multiple of four entries so vectorized consumers can read
+    // whole lanes past the end; the padding is zero.
+    const size_t padded_size = (m_num_vertices + 3) / 4 * 4;
+
+    for (int d = 0; d < m_dim; d++) {
+        m_axes[d].assign(padded_size, 0.0);
+        Eigen::VectorXd::Map(m_axes[d].data(), m_num_vertices) = V.col(d);
+    }
+    for (int d = m_dim; d < 3; d++) {
+        m_axes[d].clear();
+    }
+}
+
+void PositionsSoA::gather(
+    const std::vector<index_t>& ids, Eigen::MatrixXd& out) const
+{
+    out.resize(ids.size(), m_dim);
+    for (int d = 0; d < m_dim; d++) {
+        const double* const axis_d = m_axes[d].data();
+        double* const out_d = out.col(d).data();
+        for (size_t i = 0; i < ids.size(); i++) {
+            assert(ids[i] >= 0 && size_t(ids[i]) < m_num_vertices);
+            out_d[i] = axis_d[ids[i]];
+        }
+    }
+}
+
+void PositionsSoA::clear()
+{
+    m_num_vertices = 0;
+    m_dim = 0;
+    for (auto& axis : m_axes) {
+        axis.clear();
+    }
+}
+
+} // namespace ipc
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <ipc/utils/eigen_ext.hpp>
+#include <ipc/utils/index.hpp>
+
+#include <Eigen/Core>
+
+#include <array>
+#include <vector>
+
+namespace ipc {
+
+/// @brief Aligned structure-of-arrays mirror of a vertex position matrix.
+///
+/// The per-candidate kernels gather vertex rows out of a ConstMatrixXdRef,
+/// whose outer stride is only known at run time, so every coordinate access
+/// pays the stride arithmetic and the compiler cannot assume contiguity. The
+/// mirror copies each coordinate into its own padded, vector-aligned array
+/// once per position update (an O(n) transpose), after which every inner
+/// loop that reads positions indexes plain contiguous arrays: packing and
+/// batch-gather stages become unit-stride loads the compiler can vectorize.
+class PositionsSoA {
+public:
+    /// @brief Refresh the mirror from V. Call once per position update.
+    /// @param V Vertex positions (rowwise).
+    void update(ConstMatrixXdRef V);
+
+    /// @brief Number of mirrored vertices.
+    size_t num_vertices() const { return m_num_vertices; }
+
+    /// @brief Dimension of the mirrored positions (2 or 3).
+    int dim() const { return m_dim; }
+
+    /// @brief Pointer to the contiguous coordinate array of one axis.
+    /// The array is padded to a multiple of four entries (the padding is
+    /// zero) and aligned for vector loads.
+    const double* axis(const int d) const
+    {
+        assert(d >= 0 && d < m_dim);
+        return m_axes[d].data();
+    }
+
+    /// @brief Coordinate d of vertex vi.
+    double operator()(const index_t vi, const int d) const
+    {
+        assert(vi >= 0 && size_t(vi) < m_num_vertices);
+        return m_axes[d][vi];
+    }
+
+    /// @brief Gather vertex rows into a compact batch matrix.
+    ///
+    /// Fills the structure-of-arrays inputs of the batched distance kernels
+    /// (see distance_batch.hpp): the output is written one column at a time
+    /// (unit stride, as the batch matrices are column-major) while reading
+    /// from the contiguous per-axis arrays.
+    /// @param[in] ids The vertex indices to gather.
+    /// @param[out] out The gathered positions (ids.size() × dim()).
+    void gather(const std::vector<index_t>& ids, Eigen::MatrixXd& out) const;
+
+    /// @brief Remove the mirrored positions, but keep the capacity.
+    void clear();
+
+protected:
+    size_t m_num_vertices = 0;
+    int m_dim = 0;
+    /// @brief One padded coordinate array per axis (unused axes stay empty).
+    std::array<std::vector<double, Eigen::aligned_allocator<double>>, 3>
+        m_axes;
+};
+
+} // namespace ipc
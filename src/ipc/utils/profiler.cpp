@@ -0,0 +1,52 @@
+#include "profiler.hpp"
+
+#ifdef IPC_TOOLKIT_WITH_PROFILER
+
+#include <ipc/utils/logger.hpp>
+
+#include <sstream>
+
+namespace ipc {
+
+Profiler& Profiler::instance()
+{
+    static Profiler profiler;
+    return profiler;
+}
+
+void Profiler::add(const std::string& phase, const double seconds)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::pair<double, long>& entry = m_phases[phase];
+    entry.first += seconds;
+    entry.second++;
+}
+
+void Profiler::clear()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_phases.clear();
+}
+
+std::string Profiler::json() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    std::stringstream ss;
+    ss << "{";
+    bool first = true;
+    for (const auto& [phase, totals] : m_phases) {
+        ss << (first ? "" : ",") << "\"" << phase
+           << "\":{\"total_s\":" << totals.first
+           << ",\"count\":" << totals.second << "}";
+        first = false;
+    }
+    ss << "}";
+    return ss.str();
+}
+
+void Profiler::log() const { logger().info("profiler: {}", json()); }
+
+} // namespace ipc
+
+#endif
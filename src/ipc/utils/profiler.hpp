@@ -0,0 +1,87 @@
+#pragma once
+
+#include <ipc/config.hpp>
+
+#ifdef IPC_TOOLKIT_WITH_PROFILER
+
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+
+namespace ipc {
+
+/// @brief Aggregated timings of the profiled phases of the library.
+///
+/// Scoped timers (see IPC_PROFILE_SCOPE) add their elapsed time to a named
+/// phase; the per-phase totals and counts accumulate until clear() is called
+/// (e.g., at the start of every simulation step) and can be dumped as JSON.
+/// Only compiled when IPC_TOOLKIT_WITH_PROFILER is enabled; the timing
+/// macros expand to nothing otherwise.
+class Profiler {
+public:
+    /// @brief Get the global profiler.
+    static Profiler& instance();
+
+    /// @brief Record one execution of a phase.
+    /// @param[in] phase Name of the phase.
+    /// @param[in] seconds Elapsed time of the execution in seconds.
+    void add(const std::string& phase, const double seconds);
+
+    /// @brief Clear the aggregated totals (e.g., at the start of a step).
+    void clear();
+
+    /// @brief Format the per-phase totals (seconds) and counts as JSON.
+    std::string json() const;
+
+    /// @brief Write the JSON dump of the per-phase totals to the logger.
+    void log() const;
+
+protected:
+    Profiler() { }
+
+    /// @brief Guards m_phases (phases can finish on worker threads).
+    mutable std::mutex m_mutex;
+    /// @brief Phase → (total seconds, number of executions).
+    /// @note Ordered so the JSON output is deterministic.
+    std::map<std::string, std::pair<double, long>> m_phases;
+};
+
+/// @brief RAII timer that adds its elapsed lifetime to a profiler phase.
+class ScopedProfiler {
+public:
+    ScopedProfiler(const std::string& phase)
+        : m_phase(phase)
+        , m_start(std::chrono::steady_clock::now())
+    {
+    }
+
+    ~ScopedProfiler()
+    {
+        Profiler::instance().add(
+            m_phase,
+            std::chrono::duration<double>(
+                std::chrono::steady_clock::now() - m_start)
+                .count());
+    }
+
+    ScopedProfiler(const ScopedProfiler&) = delete;
+    ScopedProfiler& operator=(const ScopedProfiler&) = delete;
+
+protected:
+    const std::string m_phase;
+    const std::chrono::steady_clock::time_point m_start;
+};
+
+} // namespace ipc
+
+/// @brief Time the enclosing scope as the given profiler phase.
+#define IPC_PROFILE_SCOPE(phase)                                               \
+    const ipc::ScopedProfiler ipc_profiler_scope_(phase)
+
+#else
+
+#define IPC_PROFILE_SCOPE(phase)
+
+#endif
@@ -0,0 +1,131 @@
+#include "rational.hpp"
+
+#ifdef IPC_TOOLKIT_WITH_RATIONAL_INTERSECTION
+
+#include <algorithm> // std::max
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+namespace ipc {
+
+namespace {
+
+    /// Bump arena backing the mpq limb allocations of one scope. Chunks are
+    /// retained across scopes, so steady-state queries never call malloc.
+    struct RationalArena {
+        static constexpr size_t CHUNK_SIZE = size_t(1) << 16; // 64 KiB
+
+        struct Chunk {
+            char* data;
+            size_t capacity;
+        };
+
+        std::vector<Chunk> chunks;
+        size_t chunk_index = 0; ///< Chunk currently being bumped.
+        size_t offset = 0; ///< Bump offset within that chunk.
+        int depth = 0; ///< Nested scope count.
+
+        void* allocate(size_t bytes)
+        {
+            bytes = (bytes + 15) & ~size_t(15); // keep limb alignment
+            while (chunk_index < chunks.size()
+                   && offset + bytes > chunks[chunk_index].capacity) {
+                chunk_index++;
+                offset = 0;
+            }
+            if (chunk_index == chunks.size()) {
+                const size_t capacity = std::max(bytes, CHUNK_SIZE);
+                chunks.push_back(
+                    { static_cast<char*>(std::malloc(capacity)), capacity });
+            }
+            void* ptr = chunks[chunk_index].data + offset;
+            offset += bytes;
+            return ptr;
+        }
+
+        bool owns(const void* ptr) const
+        {
+            for (const Chunk& chunk : chunks) {
+                if (ptr >= chunk.data && ptr < chunk.data + chunk.capacity) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        /// Reclaim everything allocated since the outermost scope began.
+        void release()
+        {
+            chunk_index = 0;
+            offset = 0;
+        }
+
+        ~RationalArena()
+        {
+            for (Chunk& chunk : chunks) {
+                std::free(chunk.data);
+            }
+        }
+    };
+
+    thread_local RationalArena t_arena;
+
+    // GMP's memory functions are process-global, so they are replaced once
+    // with routers that fall through to the previous functions (malloc and
+    // friends by default) on threads without an active scope.
+
+    void* (*prev_alloc)(size_t) = nullptr;
+    void* (*prev_realloc)(void*, size_t, size_t) = nullptr;
+    void (*prev_free)(void*, size_t) = nullptr;
+
+    void* pool_alloc(size_t bytes)
+    {
+        return t_arena.depth > 0 ? t_arena.allocate(bytes) : prev_alloc(bytes);
+    }
+
+    void* pool_realloc(void* ptr, size_t old_bytes, size_t new_bytes)
+    {
+        if (t_arena.owns(ptr)) {
+            if (new_bytes <= old_bytes) {
+                return ptr; // shrinking in the arena is free
+            }
+            void* out = pool_alloc(new_bytes);
+            std::memcpy(out, ptr, old_bytes);
+            return out; // the old block is reclaimed with the scope
+        }
+        return prev_realloc(ptr, old_bytes, new_bytes);
+    }
+
+    void pool_free(void* ptr, size_t bytes)
+    {
+        // Arena blocks are reclaimed wholesale when the scope ends.
+        if (!t_arena.owns(ptr)) {
+            prev_free(ptr, bytes);
+        }
+    }
+
+    std::once_flag memory_functions_installed;
+
+} // namespace
+
+RationalPoolScope::RationalPoolScope()
+{
+    std::call_once(memory_functions_installed, []() {
+        mp_get_memory_functions(&prev_alloc, &prev_realloc, &prev_free);
+        mp_set_memory_functions(pool_alloc, pool_realloc, pool_free);
+    });
+    t_arena.depth++;
+}
+
+RationalPoolScope::~RationalPoolScope()
+{
+    if (--t_arena.depth == 0) {
+        t_arena.release();
+    }
+}
+
+} // namespace ipc
+
+#endif
@@ -79,6 +79,37 @@ public:
         return r_out;
     }
 
+    // In-place compound operators: unlike the binary operators these neither
+    // construct a temporary nor allocate a fresh mpq, so prefer them in
+    // accumulation loops.
+
+    Rational& operator+=(const Rational& y)
+    {
+        mpq_add(value, value, y.value);
+        return *this;
+    }
+
+    Rational& operator-=(const Rational& y)
+    {
+        mpq_sub(value, value, y.value);
+        return *this;
+    }
+
+    Rational& operator*=(const Rational& y)
+    {
+        mpq_mul(value, value, y.value);
+        return *this;
+    }
+
+    Rational& operator/=(const Rational& y)
+    {
+        mpq_div(value, value, y.value);
+        return *this;
+    }
+
+    /// @brief Negate the value in place.
+    void negate() { mpq_neg(value, value); }
+
     Rational& operator=(const Rational& x)
     {
         if (this == &x)
@@ -133,6 +164,27 @@ public:
     }
 };
 
+/// @brief Pool the GMP limb allocations of one exact query.
+///
+/// Every Rational operation allocates (and frees) mpq limb storage through
+/// malloc, which dominates the rational intersection path. While a scope is
+/// alive, GMP allocations on the constructing thread come from a per-thread
+/// bump arena and frees are no-ops; when the outermost scope ends, the arena
+/// is released wholesale (the memory is retained for the thread's next
+/// scope, so steady-state queries never touch malloc). Scopes nest, and
+/// threads without an active scope keep allocating through malloc as before.
+///
+/// @warning Every Rational created inside the scope must be destroyed before
+/// the scope ends and must stay on the thread that created it.
+class RationalPoolScope {
+public:
+    RationalPoolScope();
+    ~RationalPoolScope();
+
+    RationalPoolScope(const RationalPoolScope&) = delete;
+    RationalPoolScope& operator=(const RationalPoolScope&) = delete;
+};
+
 } // namespace ipc
 
 #endif
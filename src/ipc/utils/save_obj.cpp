@@ -2,12 +2,16 @@
 
 #include <ipc/utils/eigen_ext.hpp>
 
+#include <cstdint>
+#include <cstring> // std::memcmp
+#include <stdexcept>
+
 namespace ipc {
 
 template <>
 void save_obj(
     std::ofstream& out,
-    const Eigen::MatrixXd& V,
+    ConstMatrixXdRef V,
     const Eigen::MatrixXi& E,
     const Eigen::MatrixXi& F,
     const std::vector<EdgeVertexCandidate>& ev_candidates,
@@ -27,7 +31,7 @@ void save_obj(
 template <>
 void save_obj(
     std::ofstream& out,
-    const Eigen::MatrixXd& V,
+    ConstMatrixXdRef V,
     const Eigen::MatrixXi& E,
     const Eigen::MatrixXi& F,
     const std::vector<EdgeEdgeCandidate>& ee_candidates,
@@ -49,7 +53,7 @@ void save_obj(
 template <>
 void save_obj(
     std::ofstream& out,
-    const Eigen::MatrixXd& V,
+    ConstMatrixXdRef V,
     const Eigen::MatrixXi& E,
     const Eigen::MatrixXi& F,
     const std::vector<FaceVertexCandidate>& fv_candidates,
@@ -70,7 +74,7 @@ void save_obj(
 template <>
 void save_obj(
     std::ofstream& out,
-    const Eigen::MatrixXd& V,
+    ConstMatrixXdRef V,
     const Eigen::MatrixXi& E,
     const Eigen::MatrixXi& F,
     const std::vector<EdgeFaceCandidate>& ef_candidates,
@@ -90,4 +94,159 @@ void save_obj(
     }
 }
 
+namespace {
+
+    // Format tag (bumped when the layout changes).
+    constexpr char MESH_DUMP_MAGIC[8] = { 'I', 'P', 'C', 'M',
+                                          'E', 'S', 'H', '1' };
+
+    template <typename T> void append_pod(std::vector<char>& buf, const T& v)
+    {
+        const char* bytes = reinterpret_cast<const char*>(&v);
+        buf.insert(buf.end(), bytes, bytes + sizeof(T));
+    }
+
+    template <typename Scalar>
+    void append_matrix(
+        std::vector<char>& buf,
+        const Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic>& M)
+    {
+        append_pod<int64_t>(buf, M.rows());
+        append_pod<int64_t>(buf, M.cols());
+        const char* bytes = reinterpret_cast<const char*>(M.data());
+        buf.insert(buf.end(), bytes, bytes + sizeof(Scalar) * M.size());
+    }
+
+    template <typename T>
+    T consume_pod(const std::vector<char>& buf, size_t& offset)
+    {
+        if (offset + sizeof(T) > buf.size()) {
+            throw std::runtime_error("Truncated mesh dump!");
+        }
+        T value;
+        std::memcpy(&value, buf.data() + offset, sizeof(T));
+        offset += sizeof(T);
+        return value;
+    }
+
+    template <typename Scalar>
+    Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic>
+    consume_matrix(const std::vector<char>& buf, size_t& offset)
+    {
+        const int64_t rows = consume_pod<int64_t>(buf, offset);
+        const int64_t cols = consume_pod<int64_t>(buf, offset);
+        if (rows < 0 || cols < 0
+            || offset + sizeof(Scalar) * rows * cols > buf.size()) {
+            throw std::runtime_error("Truncated mesh dump!");
+        }
+        Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic> M(rows, cols);
+        std::memcpy(M.data(), buf.data() + offset, sizeof(Scalar) * M.size());
+        offset += sizeof(Scalar) * M.size();
+        return M;
+    }
+
+    bool write_mesh_dump(
+        const std::string& filename,
+        const Eigen::MatrixXd& V,
+        const Eigen::MatrixXi& E,
+        const Eigen::MatrixXi& F)
+    {
+        std::vector<char> buf;
+        buf.reserve(
+            sizeof(MESH_DUMP_MAGIC) + 6 * sizeof(int64_t)
+            + sizeof(double) * V.size() + sizeof(int) * (E.size() + F.size()));
+
+        buf.insert(
+            buf.end(), MESH_DUMP_MAGIC,
+            MESH_DUMP_MAGIC + sizeof(MESH_DUMP_MAGIC));
+        append_matrix<double>(buf, V);
+        append_matrix<int>(buf, E);
+        append_matrix<int>(buf, F);
+
+        std::ofstream out(filename, std::ios::binary);
+        if (!out.is_open()) {
+            return false;
+        }
+        out.write(buf.data(), buf.size());
+        return bool(out);
+    }
+
+} // namespace
+
+bool save_mesh_dump(
+    const std::string& filename,
+    ConstMatrixXdRef V,
+    const Eigen::MatrixXi& E,
+    const Eigen::MatrixXi& F)
+{
+    return write_mesh_dump(filename, V, E, F);
+}
+
+std::future<bool> save_mesh_dump_async(
+    const std::string& filename,
+    ConstMatrixXdRef V,
+    const Eigen::MatrixXi& E,
+    const Eigen::MatrixXi& F)
+{
+    // Copy the mesh before returning so the caller can keep mutating it.
+    return std::async(
+        std::launch::async,
+        [filename, V = Eigen::MatrixXd(V), E, F]() {
+            return write_mesh_dump(filename, V, E, F);
+        });
+}
+
+bool convert_mesh_dump_to_obj(
+    const std::string& dump_filename, const std::string& obj_filename)
+{
+    std::ifstream in(dump_filename, std::ios::binary | std::ios::ate);
+    if (!in.is_open()) {
+        return false;
+    }
+    std::vector<char> buf(size_t(in.tellg()));
+    in.seekg(0);
+    in.read(buf.data(), buf.size());
+    if (!in) {
+        throw std::runtime_error("Truncated mesh dump!");
+    }
+
+    if (buf.size() < sizeof(MESH_DUMP_MAGIC)
+        || std::memcmp(buf.data(), MESH_DUMP_MAGIC, sizeof(MESH_DUMP_MAGIC))
+            != 0) {
+        throw std::runtime_error("Invalid mesh dump header!");
+    }
+    size_t offset = sizeof(MESH_DUMP_MAGIC);
+
+    const Eigen::MatrixXd V = consume_matrix<double>(buf, offset);
+    const Eigen::MatrixXi E = consume_matrix<int>(buf, offset);
+    const Eigen::MatrixXi F = consume_matrix<int>(buf, offset);
+
+    // The OBJ text is assembled in memory and written with one call, like
+    // the dump itself.
+    fmt::memory_buffer obj;
+    obj.reserve(32 * V.size() + 16 * (E.size() + F.size()));
+    for (long i = 0; i < V.rows(); i++) {
+        fmt::format_to(
+            std::back_inserter(obj), "v {:.17g} {:.17g} {:.17g}\n", V(i, 0),
+            V(i, 1), V.cols() == 3 ? V(i, 2) : 0.0);
+    }
+    for (long i = 0; i < E.rows(); i++) {
+        fmt::format_to(
+            std::back_inserter(obj), "l {:d} {:d}\n", E(i, 0) + 1,
+            E(i, 1) + 1);
+    }
+    for (long i = 0; i < F.rows(); i++) {
+        fmt::format_to(
+            std::back_inserter(obj), "f {:d} {:d} {:d}\n", F(i, 0) + 1,
+            F(i, 1) + 1, F(i, 2) + 1);
+    }
+
+    std::ofstream out(obj_filename);
+    if (!out.is_open()) {
+        return false;
+    }
+    out.write(obj.data(), obj.size());
+    return bool(out);
+}
+
 } // namespace ipc
\ No newline at end of file
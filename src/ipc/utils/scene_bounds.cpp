@@ -0,0 +1,67 @@
+#include "scene_bounds.hpp"
+
+#include <tbb/parallel_reduce.h>
+#include <tbb/blocked_range.h>
+
+#include <limits>
+
+namespace ipc {
+
+namespace {
+
+    /// Parallel colwise min/max reduction over the rows of V.
+    std::pair<ArrayMax3d, ArrayMax3d> colwise_min_max(ConstMatrixXdRef V)
+    {
+        const int dim = V.cols();
+
+        std::pair<ArrayMax3d, ArrayMax3d> identity;
+        identity.first.setConstant(
+            dim, std::numeric_limits<double>::infinity());
+        identity.second.setConstant(
+            dim, -std::numeric_limits<double>::infinity());
+
+        return tbb::parallel_reduce(
+            tbb::blocked_range<Eigen::Index>(0, V.rows()), identity,
+            [&](const tbb::blocked_range<Eigen::Index>& r,
+                std::pair<ArrayMax3d, ArrayMax3d> bounds) {
+                const auto& block =
+                    V.middleRows(r.begin(), r.end() - r.begin());
+                const ArrayMax3d block_min =
+                    block.colwise().minCoeff().array();
+                const ArrayMax3d block_max =
+                    block.colwise().maxCoeff().array();
+                bounds.first = bounds.first.min(block_min);
+                bounds.second = bounds.second.max(block_max);
+                return bounds;
+            },
+            [](const std::pair<ArrayMax3d, ArrayMax3d>& a,
+               const std::pair<ArrayMax3d, ArrayMax3d>& b) {
+                return std::make_pair(
+                    a.first.min(b.first).eval(), a.second.max(b.second).eval());
+            });
+    }
+
+} // namespace
+
+const SceneBounds& SceneBounds::ensure(ConstMatrixXdRef V)
+{
+    if (!m_valid) {
+        std::tie(m_min, m_max) = colwise_min_max(V);
+        m_valid = true;
+    }
+    return *this;
+}
+
+const SceneBounds& SceneBounds::ensure(ConstMatrixXdRef V0, ConstMatrixXdRef V1)
+{
+    if (!m_valid) {
+        const auto [min0, max0] = colwise_min_max(V0);
+        const auto [min1, max1] = colwise_min_max(V1);
+        m_min = min0.min(min1);
+        m_max = max0.max(max1);
+        m_valid = true;
+    }
+    return *this;
+}
+
+} // namespace ipc
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <ipc/utils/eigen_ext.hpp>
+
+#include <Eigen/Core>
+
+#include <cassert>
+
+namespace ipc {
+
+/// @brief Per-step cache of the scene's axis-aligned bounding box.
+///
+/// Several call sites (adaptive-stiffness initialization, the CCD
+/// tolerance floor, the intersection test's inflation radius) each reduce
+/// the full vertex matrix to the same colwise min/max per step. One
+/// SceneBounds is computed once per position update (in parallel), shared
+/// by every consumer, and invalidated when the positions change.
+class SceneBounds {
+public:
+    /// @brief Compute the bounds of V if invalidated; no-op when valid.
+    /// @param[in] V Vertex positions as rows of a matrix.
+    /// @return This object, for chaining (e.g.,
+    ///     <tt>bounds.ensure(V).diagonal_length()</tt>).
+    const SceneBounds& ensure(ConstMatrixXdRef V);
+
+    /// @brief Compute the bounds of the sweep from V0 to V1 if invalidated.
+    /// @param[in] V0 Starting vertex positions as rows of a matrix.
+    /// @param[in] V1 Ending vertex positions as rows of a matrix.
+    /// @return This object, for chaining.
+    const SceneBounds& ensure(ConstMatrixXdRef V0, ConstMatrixXdRef V1);
+
+    /// @brief Mark the bounds stale; call when the vertex positions change.
+    void invalidate() { m_valid = false; }
+
+    /// @brief Have the bounds been computed since the last invalidation?
+    bool valid() const { return m_valid; }
+
+    /// @brief The componentwise minimum corner of the bounding box.
+    const ArrayMax3d& min() const
+    {
+        assert(m_valid);
+        return m_min;
+    }
+
+    /// @brief The componentwise maximum corner of the bounding box.
+    const ArrayMax3d& max() const
+    {
+        assert(m_valid);
+        return m_max;
+    }
+
+    /// @brief Length of the diagonal of the bounding box.
+    double diagonal_length() const
+    {
+        assert(m_valid);
+        return (m_max - m_min).matrix().norm();
+    }
+
+protected:
+    ArrayMax3d m_min, m_max;
+    bool m_valid = false;
+};
+
+} // namespace ipc
@@ -0,0 +1,362 @@
+#include "serialization.hpp"
+
+#include <cstdint>
+#include <cstring> // std::memcmp
+#include <stdexcept>
+
+namespace ipc {
+
+namespace {
+
+    // Format tags (bumped when the layout changes).
+    constexpr char CONSTRAINTS_MAGIC[8] = { 'I', 'P', 'C', 'C',
+                                            'S', 'E', 'T', '1' };
+    constexpr char FRICTION_MAGIC[8] = { 'I', 'P', 'C', 'F',
+                                         'S', 'E', 'T', '1' };
+    constexpr char CHECKPOINT_MAGIC[8] = { 'I', 'P', 'C', 'C',
+                                           'K', 'P', 'T', '1' };
+
+    template <typename T> void write_pod(std::ostream& out, const T& value)
+    {
+        out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template <typename T> T read_pod(std::istream& in)
+    {
+        T value;
+        in.read(reinterpret_cast<char*>(&value), sizeof(T));
+        if (!in) {
+            throw std::runtime_error(
+                "Unexpected end of serialized constraint data!");
+        }
+        return value;
+    }
+
+    template <typename Derived>
+    void write_matrix(std::ostream& out, const Eigen::MatrixBase<Derived>& M)
+    {
+        write_pod<int64_t>(out, M.rows());
+        write_pod<int64_t>(out, M.cols());
+        for (long j = 0; j < M.cols(); j++) {
+            for (long i = 0; i < M.rows(); i++) {
+                write_pod<double>(out, M(i, j));
+            }
+        }
+    }
+
+    template <typename Matrix> Matrix read_matrix(std::istream& in)
+    {
+        const int64_t rows = read_pod<int64_t>(in);
+        const int64_t cols = read_pod<int64_t>(in);
+        Matrix M(rows, cols);
+        for (long j = 0; j < M.cols(); j++) {
+            for (long i = 0; i < M.rows(); i++) {
+                M(i, j) = read_pod<double>(in);
+            }
+        }
+        return M;
+    }
+
+    void write_sparse_vector(
+        std::ostream& out, const Eigen::SparseVector<double>& v)
+    {
+        write_pod<int64_t>(out, v.size());
+        write_pod<int64_t>(out, v.nonZeros());
+        for (Eigen::SparseVector<double>::InnerIterator it(v); it; ++it) {
+            write_pod<int64_t>(out, it.index());
+            write_pod<double>(out, it.value());
+        }
+    }
+
+    Eigen::SparseVector<double> read_sparse_vector(std::istream& in)
+    {
+        Eigen::SparseVector<double> v(read_pod<int64_t>(in));
+        const int64_t num_nonzeros = read_pod<int64_t>(in);
+        v.reserve(num_nonzeros);
+        for (int64_t i = 0; i < num_nonzeros; i++) {
+            const int64_t index = read_pod<int64_t>(in);
+            v.insert(index) = read_pod<double>(in);
+        }
+        return v;
+    }
+
+    void write_magic(std::ostream& out, const char (&magic)[8])
+    {
+        out.write(magic, sizeof(magic));
+    }
+
+    void read_magic(std::istream& in, const char (&magic)[8])
+    {
+        char buffer[8];
+        in.read(buffer, sizeof(buffer));
+        if (!in || std::memcmp(buffer, magic, sizeof(buffer)) != 0) {
+            throw std::runtime_error(
+                "Stream does not contain a serialized constraint set!");
+        }
+    }
+
+    // ------------------------------------------------------------------------
+    // Fields shared by every CollisionConstraint
+
+    void write_base(std::ostream& out, const CollisionConstraint& constraint)
+    {
+        write_pod<double>(out, constraint.minimum_distance);
+        write_pod<double>(out, constraint.weight);
+        write_sparse_vector(out, constraint.weight_gradient);
+        write_pod<double>(out, constraint.cached_distance);
+    }
+
+    void read_base(std::istream& in, CollisionConstraint& constraint)
+    {
+        constraint.minimum_distance = read_pod<double>(in);
+        constraint.weight = read_pod<double>(in);
+        constraint.weight_gradient = read_sparse_vector(in);
+        constraint.cached_distance = read_pod<double>(in);
+    }
+
+    // ------------------------------------------------------------------------
+    // Fields shared by every FrictionConstraint
+
+    void write_base(std::ostream& out, const FrictionConstraint& constraint)
+    {
+        write_pod<double>(out, constraint.normal_force_magnitude);
+        write_pod<double>(out, constraint.mu);
+        write_pod<double>(out, constraint.weight);
+        write_sparse_vector(out, constraint.weight_gradient);
+        write_matrix(out, constraint.closest_point);
+        write_matrix(out, constraint.tangent_basis);
+    }
+
+    void read_base(std::istream& in, FrictionConstraint& constraint)
+    {
+        constraint.normal_force_magnitude = read_pod<double>(in);
+        constraint.mu = read_pod<double>(in);
+        constraint.weight = read_pod<double>(in);
+        constraint.weight_gradient = read_sparse_vector(in);
+        constraint.closest_point = read_matrix<VectorMax2d>(in);
+        constraint.tangent_basis = read_matrix<MatrixMax<double, 3, 2>>(in);
+    }
+
+} // namespace
+
+void save_constraints(std::ostream& out, const Constraints& constraint_set)
+{
+    write_magic(out, CONSTRAINTS_MAGIC);
+
+    write_pod<uint64_t>(out, constraint_set.vv_constraints.size());
+    for (const auto& vv : constraint_set.vv_constraints) {
+        write_pod<int64_t>(out, vv.vertex0_index);
+        write_pod<int64_t>(out, vv.vertex1_index);
+        write_base(out, vv);
+    }
+
+    write_pod<uint64_t>(out, constraint_set.ev_constraints.size());
+    for (const auto& ev : constraint_set.ev_constraints) {
+        write_pod<int64_t>(out, ev.edge_index);
+        write_pod<int64_t>(out, ev.vertex_index);
+        write_base(out, ev);
+    }
+
+    write_pod<uint64_t>(out, constraint_set.ee_constraints.size());
+    for (const auto& ee : constraint_set.ee_constraints) {
+        write_pod<int64_t>(out, ee.edge0_index);
+        write_pod<int64_t>(out, ee.edge1_index);
+        write_pod<double>(out, ee.eps_x);
+        write_base(out, ee);
+    }
+
+    write_pod<uint64_t>(out, constraint_set.fv_constraints.size());
+    for (const auto& fv : constraint_set.fv_constraints) {
+        write_pod<int64_t>(out, fv.face_index);
+        write_pod<int64_t>(out, fv.vertex_index);
+        write_base(out, fv);
+    }
+
+    write_pod<uint64_t>(out, constraint_set.pv_constraints.size());
+    for (const auto& pv : constraint_set.pv_constraints) {
+        write_matrix(out, pv.plane_origin);
+        write_matrix(out, pv.plane_normal);
+        write_pod<int64_t>(out, pv.vertex_index);
+        write_base(out, pv);
+    }
+
+    if (!out) {
+        throw std::runtime_error("Failed to write the constraint set!");
+    }
+}
+
+void load_constraints(std::istream& in, Constraints& constraint_set)
+{
+    read_magic(in, CONSTRAINTS_MAGIC);
+
+    constraint_set.clear();
+
+    uint64_t n = read_pod<uint64_t>(in);
+    constraint_set.vv_constraints.reserve(n);
+    for (uint64_t i = 0; i < n; i++) {
+        const long vertex0_index = read_pod<int64_t>(in);
+        const long vertex1_index = read_pod<int64_t>(in);
+        auto& vv = constraint_set.vv_constraints.emplace_back(
+            vertex0_index, vertex1_index);
+        read_base(in, vv);
+    }
+
+    n = read_pod<uint64_t>(in);
+    constraint_set.ev_constraints.reserve(n);
+    for (uint64_t i = 0; i < n; i++) {
+        const long edge_index = read_pod<int64_t>(in);
+        const long vertex_index = read_pod<int64_t>(in);
+        auto& ev = constraint_set.ev_constraints.emplace_back(
+            edge_index, vertex_index);
+        read_base(in, ev);
+    }
+
+    n = read_pod<uint64_t>(in);
+    constraint_set.ee_constraints.reserve(n);
+    for (uint64_t i = 0; i < n; i++) {
+        const long edge0_index = read_pod<int64_t>(in);
+        const long edge1_index = read_pod<int64_t>(in);
+        const double eps_x = read_pod<double>(in);
+        auto& ee = constraint_set.ee_constraints.emplace_back(
+            edge0_index, edge1_index, eps_x);
+        read_base(in, ee);
+    }
+
+    n = read_pod<uint64_t>(in);
+    constraint_set.fv_constraints.reserve(n);
+    for (uint64_t i = 0; i < n; i++) {
+        const long face_index = read_pod<int64_t>(in);
+        const long vertex_index = read_pod<int64_t>(in);
+        auto& fv = constraint_set.fv_constraints.emplace_back(
+            face_index, vertex_index);
+        read_base(in, fv);
+    }
+
+    n = read_pod<uint64_t>(in);
+    constraint_set.pv_constraints.reserve(n);
+    for (uint64_t i = 0; i < n; i++) {
+        const VectorMax3d plane_origin = read_matrix<VectorMax3d>(in);
+        const VectorMax3d plane_normal = read_matrix<VectorMax3d>(in);
+        const long vertex_index = read_pod<int64_t>(in);
+        auto& pv = constraint_set.pv_constraints.emplace_back(
+            plane_origin, plane_normal, vertex_index);
+        read_base(in, pv);
+    }
+}
+
+void save_friction_constraints(
+    std::ostream& out, const FrictionConstraints& friction_constraint_set)
+{
+    write_magic(out, FRICTION_MAGIC);
+
+    write_pod<uint64_t>(out, friction_constraint_set.vv_constraints.size());
+    for (const auto& vv : friction_constraint_set.vv_constraints) {
+        write_pod<int64_t>(out, vv.vertex0_index);
+        write_pod<int64_t>(out, vv.vertex1_index);
+        write_base(out, vv);
+    }
+
+    write_pod<uint64_t>(out, friction_constraint_set.ev_constraints.size());
+    for (const auto& ev : friction_constraint_set.ev_constraints) {
+        write_pod<int64_t>(out, ev.edge_index);
+        write_pod<int64_t>(out, ev.vertex_index);
+        write_base(out, ev);
+    }
+
+    write_pod<uint64_t>(out, friction_constraint_set.ee_constraints.size());
+    for (const auto& ee : friction_constraint_set.ee_constraints) {
+        write_pod<int64_t>(out, ee.edge0_index);
+        write_pod<int64_t>(out, ee.edge1_index);
+        write_base(out, ee);
+    }
+
+    write_pod<uint64_t>(out, friction_constraint_set.fv_constraints.size());
+    for (const auto& fv : friction_constraint_set.fv_constraints) {
+        write_pod<int64_t>(out, fv.face_index);
+        write_pod<int64_t>(out, fv.vertex_index);
+        write_base(out, fv);
+    }
+
+    if (!out) {
+        throw std::runtime_error(
+            "Failed to write the friction constraint set!");
+    }
+}
+
+void load_friction_constraints(
+    std::istream& in, FrictionConstraints& friction_constraint_set)
+{
+    read_magic(in, FRICTION_MAGIC);
+
+    friction_constraint_set.clear();
+
+    uint64_t n = read_pod<uint64_t>(in);
+    friction_constraint_set.vv_constraints.reserve(n);
+    for (uint64_t i = 0; i < n; i++) {
+        const long vertex0_index = read_pod<int64_t>(in);
+        const long vertex1_index = read_pod<int64_t>(in);
+        auto& vv = friction_constraint_set.vv_constraints.emplace_back(
+            vertex0_index, vertex1_index);
+        read_base(in, vv);
+    }
+
+    n = read_pod<uint64_t>(in);
+    friction_constraint_set.ev_constraints.reserve(n);
+    for (uint64_t i = 0; i < n; i++) {
+        const long edge_index = read_pod<int64_t>(in);
+        const long vertex_index = read_pod<int64_t>(in);
+        auto& ev = friction_constraint_set.ev_constraints.emplace_back(
+            edge_index, vertex_index);
+        read_base(in, ev);
+    }
+
+    n = read_pod<uint64_t>(in);
+    friction_constraint_set.ee_constraints.reserve(n);
+    for (uint64_t i = 0; i < n; i++) {
+        const long edge0_index = read_pod<int64_t>(in);
+        const long edge1_index = read_pod<int64_t>(in);
+        auto& ee = friction_constraint_set.ee_constraints.emplace_back(
+            edge0_index, edge1_index);
+        read_base(in, ee);
+    }
+
+    n = read_pod<uint64_t>(in);
+    friction_constraint_set.fv_constraints.reserve(n);
+    for (uint64_t i = 0; i < n; i++) {
+        const long face_index = read_pod<int64_t>(in);
+        const long vertex_index = read_pod<int64_t>(in);
+        auto& fv = friction_constraint_set.fv_constraints.emplace_back(
+            face_index, vertex_index);
+        read_base(in, fv);
+    }
+}
+
+void save_checkpoint(
+    std::ostream& out,
+    ConstMatrixXdRef vertices,
+    const Constraints& constraint_set,
+    const FrictionConstraints& friction_constraint_set)
+{
+    write_magic(out, CHECKPOINT_MAGIC);
+    write_matrix(out, vertices);
+    save_constraints(out, constraint_set);
+    save_friction_constraints(out, friction_constraint_set);
+
+    if (!out) {
+        throw std::runtime_error("Failed to write the checkpoint!");
+    }
+}
+
+void load_checkpoint(
+    std::istream& in,
+    Eigen::MatrixXd& vertices,
+    Constraints& constraint_set,
+    FrictionConstraints& friction_constraint_set)
+{
+    read_magic(in, CHECKPOINT_MAGIC);
+    vertices = read_matrix<Eigen::MatrixXd>(in);
+    load_constraints(in, constraint_set);
+    load_friction_constraints(in, friction_constraint_set);
+}
+
+} // namespace ipc
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <ipc/collisions/constraints.hpp>
+#include <ipc/friction/friction_constraint.hpp>
+
+#include <iostream>
+
+namespace ipc {
+
+/// @brief Write a built constraint set in a compact binary format.
+///
+/// Everything needed to evaluate the potentials is written (indices,
+/// weights, weight gradients, mollifier thresholds, and cached distances),
+/// so a checkpointed simulation can restart without rebuilding the set.
+/// @param[in,out] out Stream to write to (opened in binary mode).
+/// @param[in] constraint_set The set of constraints to write.
+void save_constraints(std::ostream& out, const Constraints& constraint_set);
+
+/// @brief Read a constraint set written by save_constraints.
+///
+/// The internal caches used by Constraints::build and
+/// are_cached_distances_valid are not persisted, so the first evaluation
+/// after loading recomputes distances as if the set had just been built.
+/// @param[in,out] in Stream to read from (opened in binary mode).
+/// @param[out] constraint_set The set of constraints to populate.
+/// @throws std::runtime_error If the stream does not contain a constraint
+/// set or ends prematurely.
+void load_constraints(std::istream& in, Constraints& constraint_set);
+
+/// @brief Write a built friction constraint set in a compact binary format.
+///
+/// The precomputed tangent bases, closest points, and normal force
+/// magnitudes are included, so restart skips
+/// construct_friction_constraint_set entirely.
+/// @param[in,out] out Stream to write to (opened in binary mode).
+/// @param[in] friction_constraint_set The set of friction constraints to
+/// write.
+void save_friction_constraints(
+    std::ostream& out, const FrictionConstraints& friction_constraint_set);
+
+/// @brief Read a friction constraint set written by
+/// save_friction_constraints.
+/// @param[in,out] in Stream to read from (opened in binary mode).
+/// @param[out] friction_constraint_set The set of friction constraints to
+/// populate.
+/// @throws std::runtime_error If the stream does not contain a friction
+/// constraint set or ends prematurely.
+void load_friction_constraints(
+    std::istream& in, FrictionConstraints& friction_constraint_set);
+
+/// @brief Write a full checkpoint: positions plus both constraint sets.
+///
+/// The constraint sets are embedded in the save_constraints /
+/// save_friction_constraints formats, so a checkpoint restores everything
+/// needed to resume stepping without rebuilding either set.
+/// @param[in,out] out Stream to write to (opened in binary mode).
+/// @param[in] vertices Vertex positions at the checkpointed step.
+/// @param[in] constraint_set The set of constraints to write.
+/// @param[in] friction_constraint_set The set of friction constraints to
+/// write (may be empty).
+void save_checkpoint(
+    std::ostream& out,
+    ConstMatrixXdRef vertices,
+    const Constraints& constraint_set,
+    const FrictionConstraints& friction_constraint_set);
+
+/// @brief Read a checkpoint written by save_checkpoint.
+/// @param[in,out] in Stream to read from (opened in binary mode).
+/// @param[out] vertices Vertex positions at the checkpointed step.
+/// @param[out] constraint_set The set of constraints to populate.
+/// @param[out] friction_constraint_set The set of friction constraints to
+/// populate.
+/// @throws std::runtime_error If the stream does not contain a checkpoint
+/// or ends prematurely.
+void load_checkpoint(
+    std::istream& in,
+    Eigen::MatrixXd& vertices,
+    Constraints& constraint_set,
+    FrictionConstraints& friction_constraint_set);
+
+} // namespace ipc
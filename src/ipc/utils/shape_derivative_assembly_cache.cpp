@@ -0,0 +1,203 @@
+#include "shape_derivative_assembly_cache.hpp"
+
+#include <tbb/parallel_for.h>
+
+#include <algorithm> // std::lower_bound
+#include <cassert>
+
+namespace ipc {
+
+namespace {
+    int num_block_vertices(const std::array<index_t, 4>& ids)
+    {
+        int n_verts = 0;
+        while (n_verts < 4 && ids[n_verts] >= 0) {
+            n_verts++;
+        }
+        return n_verts;
+    }
+
+    bool same_nonzero_indices(
+        const Eigen::SparseVector<double>& weight_gradient,
+        const std::vector<int>& indices)
+    {
+        size_t k = 0;
+        for (Eigen::SparseVector<double>::InnerIterator it(weight_gradient);
+             it; ++it, ++k) {
+            if (k == indices.size() || it.index() != indices[k]) {
+                return false;
+            }
+        }
+        return k == indices.size();
+    }
+} // namespace
+
+void ShapeDerivativeAssemblyCache::build_pattern(
+    const std::vector<std::array<index_t, 4>>& vertex_ids,
+    const std::vector<const Eigen::SparseVector<double>*>& weight_gradients,
+    const int dim,
+    const long n)
+{
+    assert(vertex_ids.size() == weight_gradients.size());
+
+    m_vertex_ids = vertex_ids;
+    m_dim = dim;
+
+    m_weight_gradient_indices.resize(vertex_ids.size());
+    for (size_t c = 0; c < vertex_ids.size(); c++) {
+        std::vector<int>& indices = m_weight_gradient_indices[c];
+        indices.clear();
+        for (Eigen::SparseVector<double>::InnerIterator it(
+                 *weight_gradients[c]);
+             it; ++it) {
+            indices.push_back(it.index());
+        }
+    }
+
+    // One-time triplet pass to build the compressed pattern.
+    size_t num_entries = 0;
+    for (size_t c = 0; c < vertex_ids.size(); c++) {
+        const size_t loc = num_block_vertices(vertex_ids[c]) * dim;
+        num_entries += loc * (loc + m_weight_gradient_indices[c].size());
+    }
+
+    std::vector<Eigen::Triplet<double>> triplets;
+    triplets.reserve(num_entries);
+    for (size_t c = 0; c < vertex_ids.size(); c++) {
+        const std::array<index_t, 4>& ids = vertex_ids[c];
+        const int n_verts = num_block_vertices(ids);
+        for (int i = 0; i < n_verts; i++) {
+            for (int k = 0; k < dim; k++) {
+                const long row = dim * ids[i] + k;
+                for (int j = 0; j < n_verts; j++) {
+                    for (int l = 0; l < dim; l++) {
+                        triplets.emplace_back(row, dim * ids[j] + l, 0.0);
+                    }
+                }
+                for (const int col : m_weight_gradient_indices[c]) {
+                    triplets.emplace_back(row, col, 0.0);
+                }
+            }
+        }
+    }
+
+    m_pattern.resize(n, n);
+    m_pattern.setFromTriplets(triplets.begin(), triplets.end());
+    m_pattern.makeCompressed();
+
+    // Locate every entry in the compressed value array so assembly can
+    // scatter without searching.
+    const auto* outer = m_pattern.outerIndexPtr();
+    const auto* inner = m_pattern.innerIndexPtr();
+
+    const auto offset_of = [&](const long row, const long col) {
+        const auto* begin = inner + outer[col];
+        const auto* end = inner + outer[col + 1];
+        const auto* it = std::lower_bound(begin, end, row);
+        assert(it != end && *it == row);
+        return int(it - inner);
+    };
+
+    m_hessian_offsets.resize(vertex_ids.size());
+    m_outer_product_offsets.resize(vertex_ids.size());
+    tbb::parallel_for(size_t(0), vertex_ids.size(), [&](size_t c) {
+        const std::array<index_t, 4>& ids = vertex_ids[c];
+        const int n_verts = num_block_vertices(ids);
+
+        // Local column-major order; assemble() scatters in the same order.
+        std::vector<int>& hessian_offsets = m_hessian_offsets[c];
+        hessian_offsets.clear();
+        hessian_offsets.reserve(size_t(n_verts * dim) * size_t(n_verts * dim));
+        for (int j = 0; j < n_verts; j++) {
+            for (int l = 0; l < dim; l++) {
+                for (int i = 0; i < n_verts; i++) {
+                    for (int k = 0; k < dim; k++) {
+                        hessian_offsets.push_back(
+                            offset_of(dim * ids[i] + k, dim * ids[j] + l));
+                    }
+                }
+            }
+        }
+
+        // Weight gradient nonzero major, gradient entry minor.
+        const std::vector<int>& indices = m_weight_gradient_indices[c];
+        std::vector<int>& outer_product_offsets = m_outer_product_offsets[c];
+        outer_product_offsets.clear();
+        outer_product_offsets.reserve(indices.size() * size_t(n_verts * dim));
+        for (const int col : indices) {
+            for (int i = 0; i < n_verts; i++) {
+                for (int k = 0; k < dim; k++) {
+                    outer_product_offsets.push_back(
+                        offset_of(dim * ids[i] + k, col));
+                }
+            }
+        }
+    });
+}
+
+bool ShapeDerivativeAssemblyCache::update_pattern(
+    const std::vector<std::array<index_t, 4>>& vertex_ids,
+    const std::vector<const Eigen::SparseVector<double>*>& weight_gradients,
+    const int dim,
+    const long n)
+{
+    if (m_dim == dim && m_pattern.rows() == n && m_vertex_ids == vertex_ids
+        && m_weight_gradient_indices.size() == weight_gradients.size()) {
+        bool same = true;
+        for (size_t c = 0; same && c < weight_gradients.size(); c++) {
+            same = same_nonzero_indices(
+                *weight_gradients[c], m_weight_gradient_indices[c]);
+        }
+        if (same) {
+            return false;
+        }
+    }
+    build_pattern(vertex_ids, weight_gradients, dim, n);
+    return true;
+}
+
+Eigen::SparseMatrix<double> ShapeDerivativeAssemblyCache::assemble(
+    const std::vector<MatrixMax12d>& local_hessians,
+    const std::vector<VectorMax12d>& local_gradients,
+    const std::vector<const Eigen::SparseVector<double>*>& weight_gradients,
+    const std::vector<std::array<index_t, 4>>& vertex_ids,
+    const int dim,
+    const long n)
+{
+    assert(local_hessians.size() == vertex_ids.size());
+    assert(local_gradients.size() == vertex_ids.size());
+    assert(weight_gradients.size() == vertex_ids.size());
+
+    update_pattern(vertex_ids, weight_gradients, dim, n);
+
+    Eigen::SparseMatrix<double> shape_derivative = m_pattern;
+    double* values = shape_derivative.valuePtr();
+    std::fill(values, values + shape_derivative.nonZeros(), 0.0);
+
+    for (size_t c = 0; c < vertex_ids.size(); c++) {
+        // Same local column-major order as the cached offsets.
+        const std::vector<int>& hessian_offsets = m_hessian_offsets[c];
+        assert(size_t(local_hessians[c].size()) == hessian_offsets.size());
+        const double* local_values = local_hessians[c].data();
+        for (size_t e = 0; e < hessian_offsets.size(); e++) {
+            values[hessian_offsets[e]] += local_values[e];
+        }
+
+        // Same weight gradient nonzero major order as the cached offsets.
+        const VectorMax12d& local_gradient = local_gradients[c];
+        const std::vector<int>& offsets = m_outer_product_offsets[c];
+        size_t e = 0;
+        for (Eigen::SparseVector<double>::InnerIterator it(
+                 *weight_gradients[c]);
+             it; ++it) {
+            for (long g = 0; g < local_gradient.size(); g++, e++) {
+                values[offsets[e]] += local_gradient[g] * it.value();
+            }
+        }
+        assert(e == offsets.size());
+    }
+
+    return shape_derivative;
+}
+
+} // namespace ipc
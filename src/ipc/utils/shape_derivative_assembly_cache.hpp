@@ -0,0 +1,88 @@
+#pragma once
+
+#include <ipc/utils/eigen_ext.hpp>
+#include <ipc/utils/index.hpp>
+
+#include <Eigen/Core>
+#include <Eigen/Sparse>
+
+#include <array>
+#include <vector>
+
+namespace ipc {
+
+/// @brief Reusable assembly context for barrier shape derivatives.
+///
+/// The shape derivative is the sum of the barrier hessian and, per
+/// constraint, the outer product of the (unweighted) barrier gradient with
+/// the constraint's weight gradient. Both terms have a sparsity pattern that
+/// is fixed by the constraint set — the hessian blocks by the vertex indices
+/// and the outer products by the weight gradients' nonzeros — so the
+/// compressed pattern and the offset of every entry into the value array are
+/// computed once. Subsequent assemblies with the same layout zero the cached
+/// values and scatter both terms directly into valuePtr(), avoiding the
+/// setFromTriplets and sparse additions per call.
+class ShapeDerivativeAssemblyCache {
+public:
+    ShapeDerivativeAssemblyCache() { }
+
+    /// @brief Assemble the shape derivative from per-constraint terms.
+    ///
+    /// Rebuilds the cached pattern if the layout (vertex indices, weight
+    /// gradient nonzeros, dimension, or matrix size) changed since the
+    /// previous call.
+    /// @param[in] local_hessians One dense hessian block per constraint.
+    /// @param[in] local_gradients One barrier gradient per constraint,
+    /// divided by the constraint's weight.
+    /// @param[in] weight_gradients The constraints' weight gradients.
+    /// @param[in] vertex_ids Vertex indices of each block (unused slots -1).
+    /// @param[in] dim Spatial dimension (matrix rows per vertex).
+    /// @param[in] n Size of the (square) global matrix.
+    /// @returns The assembled shape derivative.
+    Eigen::SparseMatrix<double> assemble(
+        const std::vector<MatrixMax12d>& local_hessians,
+        const std::vector<VectorMax12d>& local_gradients,
+        const std::vector<const Eigen::SparseVector<double>*>&
+            weight_gradients,
+        const std::vector<std::array<index_t, 4>>& vertex_ids,
+        const int dim,
+        const long n);
+
+    /// @brief Rebuild the cached pattern if the layout changed.
+    /// @returns True if the pattern was rebuilt.
+    bool update_pattern(
+        const std::vector<std::array<index_t, 4>>& vertex_ids,
+        const std::vector<const Eigen::SparseVector<double>*>&
+            weight_gradients,
+        const int dim,
+        const long n);
+
+    /// @brief Number of stored entries in the cached pattern.
+    long num_non_zeros() const { return m_pattern.nonZeros(); }
+
+protected:
+    /// @brief Build the compressed pattern and the value offsets.
+    void build_pattern(
+        const std::vector<std::array<index_t, 4>>& vertex_ids,
+        const std::vector<const Eigen::SparseVector<double>*>&
+            weight_gradients,
+        const int dim,
+        const long n);
+
+    /// @brief Compressed pattern of the derivative (values are scratch).
+    Eigen::SparseMatrix<double> m_pattern;
+    /// @brief Vertex indices the pattern was built for.
+    std::vector<std::array<index_t, 4>> m_vertex_ids;
+    /// @brief Weight gradient nonzero indices the pattern was built for.
+    std::vector<std::vector<int>> m_weight_gradient_indices;
+    /// @brief Per-constraint offsets of the hessian block entries (in local
+    /// column-major order) into the pattern's value array.
+    std::vector<std::vector<int>> m_hessian_offsets;
+    /// @brief Per-constraint offsets of the outer product entries (weight
+    /// gradient nonzero major, gradient entry minor) into the value array.
+    std::vector<std::vector<int>> m_outer_product_offsets;
+    /// @brief Spatial dimension the pattern was built for.
+    int m_dim = 0;
+};
+
+} // namespace ipc
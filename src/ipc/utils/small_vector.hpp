@@ -0,0 +1,64 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+namespace ipc {
+
+/// @brief Dynamic array with inline storage for its first N elements.
+///
+/// Lists that usually stay small (e.g., the ids a broad-phase query gathers
+/// per box) pay a heap allocation and a pointer indirection per list when
+/// held in a std::vector. A SmallVector keeps up to N elements inline and
+/// only spills to a heap buffer beyond that, so the common case allocates
+/// nothing. Only the operations the broad phase needs are provided.
+template <typename T, std::size_t N> class SmallVector {
+public:
+    SmallVector() { }
+
+    void push_back(const T& value)
+    {
+        if (m_size < N) {
+            m_inline[m_size++] = value;
+        } else {
+            if (m_size == N) {
+                // Spill: move the inline elements to the heap buffer so the
+                // elements stay contiguous.
+                m_heap.reserve(2 * N);
+                m_heap.assign(m_inline.begin(), m_inline.end());
+            }
+            m_heap.push_back(value);
+            m_size++;
+        }
+    }
+
+    /// @brief Remove all elements (keeps any spilled heap capacity).
+    void clear()
+    {
+        m_size = 0;
+        m_heap.clear();
+    }
+
+    std::size_t size() const { return m_size; }
+
+    bool empty() const { return m_size == 0; }
+
+    T* begin() { return m_size > N ? m_heap.data() : m_inline.data(); }
+    T* end() { return begin() + m_size; }
+    const T* begin() const
+    {
+        return m_size > N ? m_heap.data() : m_inline.data();
+    }
+    const T* end() const { return begin() + m_size; }
+
+    T& operator[](const std::size_t i) { return begin()[i]; }
+    const T& operator[](const std::size_t i) const { return begin()[i]; }
+
+protected:
+    std::array<T, N> m_inline; ///< @brief Inline storage (first N elements).
+    std::vector<T> m_heap;     ///< @brief Spill buffer once N is exceeded.
+    std::size_t m_size = 0;    ///< @brief Number of elements.
+};
+
+} // namespace ipc
@@ -0,0 +1,54 @@
+#include "workspace.hpp"
+
+#include <cassert>
+
+namespace ipc {
+
+#ifndef NDEBUG
+namespace {
+    /// Summed grad-entry and hess-triplet capacities over an arena's slots.
+    std::pair<size_t, size_t>
+    summed_capacities(const Workspace::ThreadLocalBuffers& arena)
+    {
+        std::pair<size_t, size_t> sums(0, 0);
+        for (const Workspace::LocalBuffers& buffers : arena) {
+            sums.first += buffers.grad_entries.capacity();
+            sums.second += buffers.hess_triplets.capacity();
+        }
+        return sums;
+    }
+} // namespace
+#endif
+
+Workspace::ThreadLocalBuffers& Workspace::arena(const Site site)
+{
+    assert(site < Site::NUM_SITES);
+    ThreadLocalBuffers& arena = m_arenas[size_t(site)];
+
+#ifndef NDEBUG
+    if (m_expect_warm) {
+        // Growth after warm-up means the pass still allocates at steady
+        // state (e.g., the constraint count outgrew the warmed capacities).
+        const auto sums = summed_capacities(arena);
+        assert(sums.first <= m_warm_capacities[size_t(site)].first);
+        assert(sums.second <= m_warm_capacities[size_t(site)].second);
+    }
+#endif
+
+    for (LocalBuffers& buffers : arena) {
+        buffers.reset();
+    }
+    return arena;
+}
+
+void Workspace::expect_warm()
+{
+#ifndef NDEBUG
+    for (size_t i = 0; i < m_arenas.size(); i++) {
+        m_warm_capacities[i] = summed_capacities(m_arenas[i]);
+    }
+    m_expect_warm = true;
+#endif
+}
+
+} // namespace ipc
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <Eigen/Core>
+#include <Eigen/Sparse>
+
+#include <tbb/enumerable_thread_specific.h>
+
+#include <array>
+#include <utility>
+#include <vector>
+
+namespace ipc {
+
+/// @brief Persistent per-thread scratch arenas for the hot assembly passes.
+///
+/// The potential evaluations otherwise construct fresh thread-local
+/// gradient-entry and hessian-triplet vectors on every call, so a
+/// steady-state step reallocates buffers proportional to the constraint
+/// count each iteration. A Workspace owns one arena per pass; acquiring an
+/// arena resets its buffers (contents cleared, capacity kept), so repeated
+/// steps run allocation-free in these passes once the capacities have grown
+/// to the steady-state size. Keep one Workspace alive across steps (e.g.,
+/// as a solver member) and pass it to the evaluation calls that accept one.
+/// Passes that run concurrently (see compute_iteration_derivatives())
+/// acquire distinct arenas, so sharing one Workspace between them is safe;
+/// do not share one Workspace between concurrent calls to the same pass.
+class Workspace {
+public:
+    /// @brief Per-thread scratch buffers for one assembly pass.
+    struct LocalBuffers {
+        /// @brief Accumulated potential (used by the fused passes).
+        double potential = 0;
+        /// @brief Global gradient entries as (index, value) pairs.
+        std::vector<std::pair<long, double>> grad_entries;
+        /// @brief Global hessian triplets.
+        std::vector<Eigen::Triplet<double>> hess_triplets;
+
+        /// @brief Clear the contents but keep the allocated capacity.
+        void reset()
+        {
+            potential = 0;
+            grad_entries.clear();
+            hess_triplets.clear();
+        }
+    };
+
+    using ThreadLocalBuffers = tbb::enumerable_thread_specific<LocalBuffers>;
+
+    /// @brief Arenas, one per pass that may run concurrently.
+    enum class Site {
+        BARRIER_DERIVATIVES = 0,
+        FRICTION_DERIVATIVES,
+        NUM_SITES,
+    };
+
+    /// @brief Acquire the arena for a pass.
+    /// Every thread's buffers are reset (capacity kept) before the arena is
+    /// returned. In debug builds, asserts that no buffer has grown since
+    /// expect_warm() was called.
+    ThreadLocalBuffers& arena(const Site site);
+
+    /// @brief Snapshot the current capacities as the warmed-up state.
+    /// Call after a representative step; from then on, debug builds assert
+    /// on arena acquisition if any buffer grew, catching steps that still
+    /// allocate in these passes after warm-up. No effect in release builds.
+    void expect_warm();
+
+protected:
+    std::array<ThreadLocalBuffers, size_t(Site::NUM_SITES)> m_arenas;
+
+#ifndef NDEBUG
+    /// @brief Summed buffer capacities per arena at expect_warm() (empty
+    /// until then).
+    std::array<std::pair<size_t, size_t>, size_t(Site::NUM_SITES)>
+        m_warm_capacities;
+    bool m_expect_warm = false;
+#endif
+};
+
+} // namespace ipc
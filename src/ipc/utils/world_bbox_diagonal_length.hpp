@@ -1,12 +1,24 @@
 #pragma once
 
+#include <ipc/utils/eigen_ext.hpp>
+#include <ipc/utils/scene_bounds.hpp>
+
 #include <Eigen/Core>
 
 namespace ipc {
 
-inline double world_bbox_diagonal_length(const Eigen::MatrixXd& V)
+inline double world_bbox_diagonal_length(ConstMatrixXdRef V)
 {
     return (V.colwise().maxCoeff() - V.colwise().minCoeff()).norm();
 }
 
+/// @brief world_bbox_diagonal_length() through a per-step cache.
+/// Reduces V only when the cache is invalidated (see SceneBounds);
+/// repeated consumers of the same positions share one reduction.
+inline double
+world_bbox_diagonal_length(ConstMatrixXdRef V, SceneBounds& bounds)
+{
+    return bounds.ensure(V).diagonal_length();
+}
+
 } // namespace ipc
@@ -3,6 +3,7 @@
 
 #include <finitediff.hpp>
 
+#include <ipc/barrier/adaptive_stiffness.hpp>
 #include <ipc/barrier/barrier.hpp>
 
 namespace {
@@ -95,6 +96,36 @@ TEST_CASE("Test barrier derivatives", "[barrier]")
     CHECK(fd::compare_gradient(fgrad, grad));
 }
 
+TEST_CASE("Batched barrier matches the scalar barrier", "[barrier]")
+{
+    double dhat = GENERATE(range(-5, 2));
+    dhat = pow(10, dhat);
+
+    // Include the out-of-range branches (d ≤ 0 and d ≥ d̂).
+    Eigen::ArrayXd d(6);
+    d << -dhat, 0.0, 0.1 * dhat, 0.5 * dhat, 0.9 * dhat, 2 * dhat;
+
+    const Eigen::ArrayXd b = ipc::barrier(d, dhat);
+    const Eigen::ArrayXd grad_b = ipc::barrier_gradient(d, dhat);
+    const Eigen::ArrayXd hess_b = ipc::barrier_hessian(d, dhat);
+
+    for (long i = 0; i < d.size(); i++) {
+        CAPTURE(dhat, d[i]);
+        const double expected_b = ipc::barrier(d[i], dhat);
+        if (std::isinf(expected_b)) {
+            CHECK(std::isinf(b[i]));
+        } else {
+            CHECK(b[i] == Approx(expected_b).margin(1e-15));
+        }
+        CHECK(
+            grad_b[i]
+            == Approx(ipc::barrier_gradient(d[i], dhat)).margin(1e-15));
+        CHECK(
+            hess_b[i]
+            == Approx(ipc::barrier_hessian(d[i], dhat)).margin(1e-15));
+    }
+}
+
 TEST_CASE("Test physical barrier", "[barrier]")
 {
     double dhat = GENERATE(range(-5, 2));
@@ -117,4 +148,30 @@ TEST_CASE("Test physical barrier", "[barrier]")
     double b_new_hessian = physical_barrier_hessian(d, dhat);
 
     CHECK(b_original_hessian == Approx(b_new_hessian));
-}
\ No newline at end of file
+}
+TEST_CASE("Initial barrier stiffness", "[barrier][adaptive_stiffness]")
+{
+    const int n = GENERATE(1, 100, 10'000);
+    CAPTURE(n);
+
+    Eigen::VectorXd grad_energy = Eigen::VectorXd::Random(n);
+    Eigen::VectorXd grad_barrier = Eigen::VectorXd::Random(n);
+    if (GENERATE(true, false)) {
+        grad_barrier.setZero(); // κ falls back to 1
+    }
+
+    const double bbox_diagonal = 2.5, dhat = 1e-3, average_mass = 3.1;
+
+    double max_kappa, max_kappa_from_products;
+    const double kappa = ipc::initial_barrier_stiffness(
+        bbox_diagonal, dhat, average_mass, grad_energy, grad_barrier,
+        max_kappa);
+
+    // The blocked parallel reduction matches the direct gradient products.
+    const double kappa_from_products = ipc::initial_barrier_stiffness(
+        bbox_diagonal, dhat, average_mass, grad_energy.dot(grad_barrier),
+        grad_barrier.squaredNorm(), max_kappa_from_products);
+
+    CHECK(kappa == Approx(kappa_from_products));
+    CHECK(max_kappa == Approx(max_kappa_from_products));
+}
@@ -0,0 +1,160 @@
+#include <catch2/catch.hpp>
+
+#include <Eigen/Core>
+
+#include <ipc/ipc.hpp>
+#include <ipc/barrier/barrier.hpp>
+#include <ipc/distance/distance_type.hpp>
+#include <ipc/distance/edge_edge.hpp>
+#include <ipc/distance/edge_edge_mollifier.hpp>
+#include <ipc/distance/point_triangle.hpp>
+
+#include <fmt/format.h>
+
+#include <array>
+#include <cmath>
+#include <vector>
+
+#include "test_utils.hpp"
+
+using namespace ipc;
+
+// Microbenchmarks for the scalar kernel layer. The inputs are recorded from
+// the broad-phase candidates of a near-contact scene, so the distance and
+// closest-feature branch distributions match what the assembly loops feed
+// these kernels; each BENCHMARK sweeps the full recorded batch, so divide the
+// reported time by the printed batch size for ns/op.
+TEST_CASE("Benchmark scalar kernels", "[!benchmark][kernels]")
+{
+    const double dhat = 1e-1;
+
+    Eigen::MatrixXd V;
+    Eigen::MatrixXi E, F;
+    REQUIRE(load_mesh("two-cubes-close.obj", V, E, F));
+
+    CollisionMesh mesh = CollisionMesh::build_from_full_mesh(V, E, F);
+    V = mesh.vertices(V);
+
+    Candidates candidates;
+    construct_collision_candidates(
+        mesh, V, candidates, /*inflation_radius=*/dhat,
+        BroadPhaseMethod::HASH_GRID);
+
+    // Record the kernel inputs up front so the benchmarks measure the
+    // kernels, not the candidate indexing.
+    std::vector<std::array<Eigen::Vector3d, 4>> pt_inputs;
+    pt_inputs.reserve(candidates.fv_candidates.size());
+    for (const FaceVertexCandidate& fv : candidates.fv_candidates) {
+        pt_inputs.push_back(
+            { { V.row(fv.vertex_index), V.row(mesh.faces()(fv.face_index, 0)),
+                V.row(mesh.faces()(fv.face_index, 1)),
+                V.row(mesh.faces()(fv.face_index, 2)) } });
+    }
+
+    std::vector<std::array<Eigen::Vector3d, 4>> ee_inputs;
+    std::vector<double> ee_eps_x;
+    ee_inputs.reserve(candidates.ee_candidates.size());
+    ee_eps_x.reserve(candidates.ee_candidates.size());
+    const Eigen::MatrixXd& rest_V = mesh.vertices_at_rest();
+    for (const EdgeEdgeCandidate& ee : candidates.ee_candidates) {
+        const Eigen::MatrixXi& edges = mesh.edges();
+        ee_inputs.push_back(
+            { { V.row(edges(ee.edge0_index, 0)),
+                V.row(edges(ee.edge0_index, 1)),
+                V.row(edges(ee.edge1_index, 0)),
+                V.row(edges(ee.edge1_index, 1)) } });
+        ee_eps_x.push_back(edge_edge_mollifier_threshold(
+            rest_V.row(edges(ee.edge0_index, 0)),
+            rest_V.row(edges(ee.edge0_index, 1)),
+            rest_V.row(edges(ee.edge1_index, 0)),
+            rest_V.row(edges(ee.edge1_index, 1))));
+    }
+
+    // Recorded squared distances drive the barrier kernels with the scene's
+    // distance distribution (including inactive pairs culled by the branch).
+    std::vector<double> distances;
+    distances.reserve(pt_inputs.size() + ee_inputs.size());
+    for (const auto& [p, t0, t1, t2] : pt_inputs) {
+        distances.push_back(point_triangle_distance(p, t0, t1, t2));
+    }
+    for (const auto& [ea0, ea1, eb0, eb1] : ee_inputs) {
+        distances.push_back(edge_edge_distance(ea0, ea1, eb0, eb1));
+    }
+    const double dhat_sqr = dhat * dhat;
+
+    REQUIRE(!pt_inputs.empty());
+    REQUIRE(!ee_inputs.empty());
+    fmt::print(
+        "kernel batch sizes: point-triangle: {}; edge-edge: {}; "
+        "barrier distances: {}\n",
+        pt_inputs.size(), ee_inputs.size(), distances.size());
+
+    double unused = 0;
+
+    BENCHMARK("barrier")
+    {
+        double sum = 0;
+        for (const double d : distances) {
+            sum += barrier(d, dhat_sqr);
+        }
+        return unused += sum;
+    };
+
+    BENCHMARK("barrier_gradient")
+    {
+        double sum = 0;
+        for (const double d : distances) {
+            sum += barrier_gradient(d, dhat_sqr);
+        }
+        return unused += sum;
+    };
+
+    BENCHMARK("barrier_hessian")
+    {
+        double sum = 0;
+        for (const double d : distances) {
+            sum += barrier_hessian(d, dhat_sqr);
+        }
+        return unused += sum;
+    };
+
+    BENCHMARK("point_triangle_distance_type")
+    {
+        int sum = 0;
+        for (const auto& [p, t0, t1, t2] : pt_inputs) {
+            sum += static_cast<int>(point_triangle_distance_type(p, t0, t1, t2));
+        }
+        return unused += sum;
+    };
+
+    BENCHMARK("point_triangle_distance")
+    {
+        double sum = 0;
+        for (const auto& [p, t0, t1, t2] : pt_inputs) {
+            sum += point_triangle_distance(p, t0, t1, t2);
+        }
+        return unused += sum;
+    };
+
+    BENCHMARK("edge_edge_distance_type")
+    {
+        int sum = 0;
+        for (const auto& [ea0, ea1, eb0, eb1] : ee_inputs) {
+            sum += static_cast<int>(
+                edge_edge_distance_type(ea0, ea1, eb0, eb1));
+        }
+        return unused += sum;
+    };
+
+    BENCHMARK("edge_edge_mollifier")
+    {
+        double sum = 0;
+        for (size_t i = 0; i < ee_inputs.size(); i++) {
+            const auto& [ea0, ea1, eb0, eb1] = ee_inputs[i];
+            sum += edge_edge_mollifier(ea0, ea1, eb0, eb1, ee_eps_x[i]);
+        }
+        return unused += sum;
+    };
+
+    CHECK(std::isfinite(unused)); // keep the kernel results observable
+}
@@ -0,0 +1,217 @@
+// Macro benchmark replaying the per-step collision pipeline
+// (construct_collision_candidates → Constraints::build → barrier potential,
+// gradient, and hessian → compute_collision_free_stepsize) on the test
+// meshes, over the CPU broad-phase methods and several thread counts. Emits
+// one JSON array of records on stdout so runs can be diffed by scripts:
+//
+//   ipc_toolkit_benchmarks [num_repetitions] > timings.json
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <Eigen/Core>
+
+#include <igl/IO>
+#include <igl/Timer.h>
+#include <igl/edges.h>
+
+#include <tbb/global_control.h>
+#include <tbb/info.h>
+
+#include <nlohmann/json.hpp>
+
+#include <ipc/ipc.hpp>
+#include <ipc/collision_mesh.hpp>
+#include <ipc/collisions/constraints.hpp>
+
+using namespace ipc;
+
+static const std::string TEST_DATA_DIR(TEST_DATA_DIR_CSTR);
+
+struct BenchmarkCase {
+    std::string mesh_name; ///< Mesh file in the test data directory.
+    double dhat; ///< Barrier activation distance.
+};
+
+static std::string method_name(const BroadPhaseMethod method)
+{
+    switch (method) {
+    case BroadPhaseMethod::BRUTE_FORCE:
+        return "brute_force";
+    case BroadPhaseMethod::HASH_GRID:
+        return "hash_grid";
+    case BroadPhaseMethod::SPATIAL_HASH:
+        return "spatial_hash";
+    case BroadPhaseMethod::BVH:
+        return "bvh";
+    case BroadPhaseMethod::SWEEP_AND_TINIEST_QUEUE:
+        return "sweep_and_tiniest_queue";
+    case BroadPhaseMethod::TWO_LEVEL_SPATIAL_HASH:
+        return "two_level_spatial_hash";
+    default:
+        return "unknown";
+    }
+}
+
+/// Run the full pipeline once and add the phase times (seconds) to a record.
+static void run_step(
+    const CollisionMesh& mesh,
+    const Eigen::MatrixXd& V0,
+    const Eigen::MatrixXd& V1,
+    const double dhat,
+    const BroadPhaseMethod method,
+    nlohmann::json& record)
+{
+    igl::Timer timer;
+
+    timer.start();
+    Candidates candidates;
+    construct_collision_candidates(mesh, V0, candidates, dhat / 2, method);
+    timer.stop();
+    record["candidates_s"] = record["candidates_s"].get<double>()
+        + timer.getElapsedTimeInSec();
+    record["num_candidates"] = candidates.size();
+
+    timer.start();
+    Constraints constraint_set;
+    constraint_set.build(candidates, mesh, V0, dhat);
+    timer.stop();
+    record["build_s"] =
+        record["build_s"].get<double>() + timer.getElapsedTimeInSec();
+    record["num_constraints"] = constraint_set.size();
+
+    timer.start();
+    const double potential =
+        compute_barrier_potential(mesh, V0, constraint_set, dhat);
+    timer.stop();
+    record["potential_s"] =
+        record["potential_s"].get<double>() + timer.getElapsedTimeInSec();
+
+    timer.start();
+    const Eigen::VectorXd grad =
+        compute_barrier_potential_gradient(mesh, V0, constraint_set, dhat);
+    timer.stop();
+    record["gradient_s"] =
+        record["gradient_s"].get<double>() + timer.getElapsedTimeInSec();
+
+    timer.start();
+    const Eigen::SparseMatrix<double> hess =
+        compute_barrier_potential_hessian(mesh, V0, constraint_set, dhat);
+    timer.stop();
+    record["hessian_s"] =
+        record["hessian_s"].get<double>() + timer.getElapsedTimeInSec();
+
+    timer.start();
+    const double alpha = compute_collision_free_stepsize(
+        mesh, V0, V1, /*min_distance=*/0, method);
+    timer.stop();
+    record["stepsize_s"] =
+        record["stepsize_s"].get<double>() + timer.getElapsedTimeInSec();
+
+    // Keep the results alive so the computations cannot be optimized away.
+    volatile double sink = potential + grad.norm() + hess.norm() + alpha;
+    (void)sink;
+}
+
+int main(int argc, char* argv[])
+{
+    const int num_repetitions = argc > 1 ? std::atoi(argv[1]) : 5;
+    if (num_repetitions <= 0) {
+        std::cerr << "usage: " << argv[0] << " [num_repetitions]" << std::endl;
+        return 1;
+    }
+
+    // Coarse to fine; dhat values matching the unit tests.
+    const std::vector<BenchmarkCase> cases = {
+        { "cube.obj", std::sqrt(2.0) },
+        { "two-cubes-close.obj", 1e-1 },
+        { "bunny.obj", 1e-2 },
+    };
+
+    const std::vector<BroadPhaseMethod> methods = {
+        BroadPhaseMethod::HASH_GRID,
+        BroadPhaseMethod::SPATIAL_HASH,
+        BroadPhaseMethod::BVH,
+        BroadPhaseMethod::TWO_LEVEL_SPATIAL_HASH,
+    };
+
+    std::vector<int> num_threads = { 1 };
+    const int max_threads = tbb::info::default_concurrency();
+    if (max_threads / 2 > 1) {
+        num_threads.push_back(max_threads / 2);
+    }
+    if (max_threads > 1) {
+        num_threads.push_back(max_threads);
+    }
+
+    nlohmann::json records = nlohmann::json::array();
+
+    for (const BenchmarkCase& benchmark_case : cases) {
+        Eigen::MatrixXd V0;
+        Eigen::MatrixXi E, F;
+        if (!igl::read_triangle_mesh(
+                TEST_DATA_DIR + benchmark_case.mesh_name, V0, F)) {
+            std::cerr << "unable to load " << benchmark_case.mesh_name
+                      << std::endl;
+            return 1;
+        }
+        igl::edges(F, E);
+
+        const CollisionMesh mesh(V0, E, F);
+
+        // Squish the mesh toward its center plane so the step both activates
+        // the barrier and triggers CCD, as a compressive solver step would.
+        Eigen::MatrixXd V1 = V0;
+        const double center = V0.col(0).mean();
+        V1.col(0) =
+            (0.5 * (V0.col(0).array() - center) + center).matrix();
+
+        for (const int n : num_threads) {
+            tbb::global_control thread_limiter(
+                tbb::global_control::max_allowed_parallelism, n);
+
+            for (const BroadPhaseMethod method : methods) {
+                nlohmann::json record = {
+                    { "mesh", benchmark_case.mesh_name },
+                    { "num_vertices", V0.rows() },
+                    { "dhat", benchmark_case.dhat },
+                    { "method", method_name(method) },
+                    { "num_threads", n },
+                    { "num_repetitions", num_repetitions },
+                    { "candidates_s", 0.0 }, { "build_s", 0.0 },
+                    { "potential_s", 0.0 },  { "gradient_s", 0.0 },
+                    { "hessian_s", 0.0 },    { "stepsize_s", 0.0 },
+                };
+
+                // Warm-up run excluded from the averages (first-touch page
+                // faults and lazy TBB worker startup would skew them).
+                nlohmann::json warmup = record;
+                run_step(
+                    mesh, V0, V1, benchmark_case.dhat, method, warmup);
+
+                for (int i = 0; i < num_repetitions; i++) {
+                    run_step(
+                        mesh, V0, V1, benchmark_case.dhat, method, record);
+                }
+
+                // Report the average seconds per phase.
+                for (const std::string phase :
+                     { "candidates_s", "build_s", "potential_s", "gradient_s",
+                       "hessian_s", "stepsize_s" }) {
+                    record[phase] =
+                        record[phase].get<double>() / num_repetitions;
+                }
+
+                records.push_back(record);
+                std::cerr << record["mesh"] << " " << record["method"] << " "
+                          << n << " threads done" << std::endl;
+            }
+        }
+    }
+
+    std::cout << records.dump(2) << std::endl;
+    return 0;
+}
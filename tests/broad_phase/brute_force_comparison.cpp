@@ -125,8 +125,8 @@ void brute_force_comparison(
             // Perform CCD to make sure the candidate is not a collision
             double toi;
             bool hit = bf_candidates[bf_ci].ccd(
-                V0, V1, mesh.edges(), mesh.faces(), toi, /*tmax=*/1.0,
-                /*tolerance=*/1e-6, /*max_iterations=*/1e7,
+                V0, V1, mesh.edges(), mesh.faces(), toi, /*min_distance=*/0,
+                /*tmax=*/1.0, /*tolerance=*/1e-6, /*max_iterations=*/1e7,
                 /*conservative_rescaling=*/1.0);
             CHECK(!hit); // Check for FN
         } else {
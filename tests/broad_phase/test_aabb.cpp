@@ -103,3 +103,67 @@ TEST_CASE("AABB overlapping", "[broad_phase][AABB]")
     }
     CHECK(a.intersects(b) == are_overlapping);
 }
+
+TEST_CASE("Float AABB is conservative", "[broad_phase][AABB]")
+{
+    // Random double boxes, including near-touching pairs built by sharing a
+    // face: the float boxes may overlap where the double boxes do not, but
+    // never the other way around.
+    for (int i = 0; i < 1000; i++) {
+        const Eigen::Array3d c_a = Eigen::Array3d::Random();
+        const Eigen::Array3d c_b = Eigen::Array3d::Random();
+        const Eigen::Array3d h_a = Eigen::Array3d::Random().abs() + 1e-12;
+        const Eigen::Array3d h_b = Eigen::Array3d::Random().abs() + 1e-12;
+
+        const AABB a(c_a - h_a, c_a + h_a);
+        AABB b(c_b - h_b, c_b + h_b);
+        if (i % 2 == 0) {
+            // Make the boxes exactly touch along x.
+            const double shift = (a.max - b.min).x();
+            b = AABB(b.min + shift, b.max + shift);
+        }
+
+        const FloatAABB fa(a), fb(b);
+        if (a.intersects(b)) {
+            CHECK(fa.intersects(fb));
+        }
+
+        AABBSoA soa(std::vector<AABB>(1, b));
+        unsigned char overlap;
+        soa.batch_intersects(a, 0, 1, &overlap);
+        CHECK(bool(overlap) == fa.intersects(fb));
+    }
+}
+
+TEST_CASE("2D AABBSoA batch is conservative", "[broad_phase][AABB][2D]")
+{
+    // More than eight boxes so the batched (SIMD) loop is exercised, not
+    // just the scalar tail.
+    constexpr int N = 100;
+    std::vector<AABB> boxes;
+    boxes.reserve(N);
+    for (int i = 0; i < N; i++) {
+        const Eigen::Array2d c = Eigen::Array2d::Random();
+        const Eigen::Array2d h = Eigen::Array2d::Random().abs() + 1e-12;
+        boxes.emplace_back(c - h, c + h);
+    }
+
+    const AABBSoA soa(boxes);
+    CHECK(soa.dim() == 2);
+
+    for (int i = 0; i < 10; i++) {
+        const Eigen::Array2d c = Eigen::Array2d::Random();
+        const Eigen::Array2d h = Eigen::Array2d::Random().abs() + 1e-12;
+        const AABB query(c - h, c + h);
+
+        unsigned char overlaps[N];
+        soa.batch_intersects(query, 0, N, overlaps);
+
+        for (int j = 0; j < N; j++) {
+            CAPTURE(i, j);
+            if (query.intersects(boxes[j])) {
+                CHECK(bool(overlaps[j])); // no false negatives
+            }
+        }
+    }
+}
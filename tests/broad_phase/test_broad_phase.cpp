@@ -6,7 +6,11 @@
 #include <igl/edges.h>
 
 #include <ipc/ipc.hpp>
+#include <ipc/broad_phase/adaptive_broad_phase.hpp>
 #include <ipc/broad_phase/broad_phase.hpp>
+#include <ipc/broad_phase/component_broad_phase.hpp>
+#include <ipc/broad_phase/hash_grid.hpp>
+#include <ipc/broad_phase/static_obstacle.hpp>
 #include <ipc/ccd/ccd.hpp>
 
 #include "brute_force_comparison.hpp"
@@ -82,7 +86,7 @@ TEST_CASE("Vertex-Vertex Broad Phase", "[ccd][broad_phase][2D]")
 
     BroadPhaseMethod method = GENERATE(
         BroadPhaseMethod::BRUTE_FORCE, BroadPhaseMethod::HASH_GRID,
-        BroadPhaseMethod::SPATIAL_HASH);
+        BroadPhaseMethod::SPATIAL_HASH, BroadPhaseMethod::BVH);
 
     test_broad_phase(mesh, V0, V1, method);
 }
@@ -112,7 +116,7 @@ TEST_CASE("Entire 2D Mesh", "[ccd][broad_phase][2D][!hide]")
 
     BroadPhaseMethod method = GENERATE(
         BroadPhaseMethod::BRUTE_FORCE, BroadPhaseMethod::HASH_GRID,
-        BroadPhaseMethod::SPATIAL_HASH);
+        BroadPhaseMethod::SPATIAL_HASH, BroadPhaseMethod::BVH);
 
     test_broad_phase(mesh, V0, V1, method);
 }
@@ -206,6 +210,736 @@ TEST_CASE("Compare BP against brute force", "[broad_phase]")
     }
 }
 
+TEST_CASE("HashGrid update", "[broad_phase][hash_grid]")
+{
+    Eigen::MatrixXd V;
+    Eigen::MatrixXi E, F;
+    REQUIRE(igl::read_triangle_mesh(TEST_DATA_DIR + "cube.obj", V, F));
+    igl::edges(F, E);
+
+    HashGrid hash_grid;
+    hash_grid.build(V, E, F, /*inflation_radius=*/1e-2);
+
+    // Small motions should reuse the grid; large ones trigger a rebuild.
+    const double scale = GENERATE(1e-8, 1e-3, 1e-1, 1.0);
+
+    Eigen::MatrixXd U = Eigen::MatrixXd::Random(V.rows(), V.cols());
+    hash_grid.update(V + scale * U);
+
+    HashGrid expected_hash_grid;
+    expected_hash_grid.build(V + scale * U, E, F, /*inflation_radius=*/1e-2);
+
+    // The grids may differ (update keeps the old cell size), but the
+    // candidates are exactly the overlapping box pairs, so they must match.
+    std::vector<EdgeEdgeCandidate> ee_candidates, expected_ee_candidates;
+    hash_grid.detect_edge_edge_candidates(ee_candidates);
+    expected_hash_grid.detect_edge_edge_candidates(expected_ee_candidates);
+    CHECK(ee_candidates == expected_ee_candidates);
+
+    std::vector<FaceVertexCandidate> fv_candidates, expected_fv_candidates;
+    hash_grid.detect_face_vertex_candidates(fv_candidates);
+    expected_hash_grid.detect_face_vertex_candidates(expected_fv_candidates);
+    CHECK(fv_candidates == expected_fv_candidates);
+}
+
+TEST_CASE("Static obstacle broad phase", "[broad_phase][static_obstacle]")
+{
+    Eigen::MatrixXd V_cube;
+    Eigen::MatrixXi E_cube, F_cube;
+    REQUIRE(
+        igl::read_triangle_mesh(TEST_DATA_DIR + "cube.obj", V_cube, F_cube));
+    igl::edges(F_cube, E_cube);
+
+    // One static cube with a second cube falling onto it.
+    const long n = V_cube.rows();
+    Eigen::MatrixXd V0(2 * n, 3);
+    V0.topRows(n) = V_cube;
+    V0.bottomRows(n) = V_cube.rowwise() + Eigen::RowVector3d(0, 1.5, 0);
+    Eigen::MatrixXd V1 = V0;
+    V1.bottomRows(n).col(1).array() -= 1.0;
+
+    Eigen::MatrixXi E(2 * E_cube.rows(), 2), F(2 * F_cube.rows(), 3);
+    E << E_cube, E_cube.array() + n;
+    F << F_cube, F_cube.array() + n;
+
+    std::vector<bool> is_static_vertex(2 * n, false);
+    std::fill(is_static_vertex.begin(), is_static_vertex.begin() + n, true);
+
+    CollisionMesh mesh(V0, E, F);
+
+    const double inflation_radius = GENERATE(0.0, 1e-2);
+    const bool ccd = GENERATE(false, true);
+    CAPTURE(inflation_radius, ccd);
+
+    StaticObstacleBroadPhase static_obstacle_broad_phase;
+    static_obstacle_broad_phase.set_static_vertices(is_static_vertex);
+    HashGrid expected_broad_phase;
+
+    // Rebuild twice to exercise the build-once static structure.
+    for (int step = 0; step < 2; step++) {
+        if (ccd) {
+            static_obstacle_broad_phase.build(V0, V1, E, F, inflation_radius);
+            expected_broad_phase.build(V0, V1, E, F, inflation_radius);
+        } else {
+            static_obstacle_broad_phase.build(V0, E, F, inflation_radius);
+            expected_broad_phase.build(V0, E, F, inflation_radius);
+        }
+
+        // The composite must produce the reference candidates minus the
+        // static-static pairs, which it never emits.
+        const auto is_static_edge = [&](const long ei) {
+            return is_static_vertex[E(ei, 0)] && is_static_vertex[E(ei, 1)];
+        };
+        const auto is_static_face = [&](const long fi) {
+            return is_static_vertex[F(fi, 0)] && is_static_vertex[F(fi, 1)]
+                && is_static_vertex[F(fi, 2)];
+        };
+
+        std::vector<EdgeEdgeCandidate> ee, expected_ee;
+        static_obstacle_broad_phase.detect_edge_edge_candidates(ee);
+        expected_broad_phase.detect_edge_edge_candidates(expected_ee);
+        expected_ee.erase(
+            std::remove_if(
+                expected_ee.begin(), expected_ee.end(),
+                [&](const EdgeEdgeCandidate& c) {
+                    return is_static_edge(c.edge0_index)
+                        && is_static_edge(c.edge1_index);
+                }),
+            expected_ee.end());
+        std::sort(ee.begin(), ee.end());
+        std::sort(expected_ee.begin(), expected_ee.end());
+        CHECK(ee == expected_ee);
+
+        std::vector<FaceVertexCandidate> fv, expected_fv;
+        static_obstacle_broad_phase.detect_face_vertex_candidates(fv);
+        expected_broad_phase.detect_face_vertex_candidates(expected_fv);
+        expected_fv.erase(
+            std::remove_if(
+                expected_fv.begin(), expected_fv.end(),
+                [&](const FaceVertexCandidate& c) {
+                    return is_static_face(c.face_index)
+                        && is_static_vertex[c.vertex_index];
+                }),
+            expected_fv.end());
+        std::sort(fv.begin(), fv.end());
+        std::sort(expected_fv.begin(), expected_fv.end());
+        CHECK(fv == expected_fv);
+
+        std::vector<EdgeVertexCandidate> ev, expected_ev;
+        static_obstacle_broad_phase.detect_edge_vertex_candidates(ev);
+        expected_broad_phase.detect_edge_vertex_candidates(expected_ev);
+        expected_ev.erase(
+            std::remove_if(
+                expected_ev.begin(), expected_ev.end(),
+                [&](const EdgeVertexCandidate& c) {
+                    return is_static_edge(c.edge_index)
+                        && is_static_vertex[c.vertex_index];
+                }),
+            expected_ev.end());
+        std::sort(ev.begin(), ev.end());
+        std::sort(expected_ev.begin(), expected_ev.end());
+        CHECK(ev == expected_ev);
+    }
+}
+
+TEST_CASE("Rest detection broad phase", "[broad_phase][static_obstacle]")
+{
+    Eigen::MatrixXd V_cube;
+    Eigen::MatrixXi E_cube, F_cube;
+    REQUIRE(
+        igl::read_triangle_mesh(TEST_DATA_DIR + "cube.obj", V_cube, F_cube));
+    igl::edges(F_cube, E_cube);
+
+    // A settled cube with a second cube falling onto it. Nothing is marked
+    // static by hand; the resting cube must be detected from its motion.
+    const long n = V_cube.rows();
+    Eigen::MatrixXd V0(2 * n, 3);
+    V0.topRows(n) = V_cube;
+    V0.bottomRows(n) = V_cube.rowwise() + Eigen::RowVector3d(0, 1.5, 0);
+    Eigen::MatrixXd V1 = V0;
+    V1.bottomRows(n).col(1).array() -= 1.0;
+
+    Eigen::MatrixXi E(2 * E_cube.rows(), 2), F(2 * F_cube.rows(), 3);
+    E << E_cube, E_cube.array() + n;
+    F << F_cube, F_cube.array() + n;
+
+    const double inflation_radius = GENERATE(0.0, 1e-2);
+    CAPTURE(inflation_radius);
+
+    StaticObstacleBroadPhase rest_broad_phase;
+    rest_broad_phase.set_rest_epsilon(1e-8);
+    HashGrid expected_broad_phase;
+
+    const auto is_resting_vertex = [&](const long vi) { return vi < n; };
+    const auto is_resting_edge = [&](const long ei) {
+        return is_resting_vertex(E(ei, 0)) && is_resting_vertex(E(ei, 1));
+    };
+    const auto is_resting_face = [&](const long fi) {
+        return is_resting_vertex(F(fi, 0)) && is_resting_vertex(F(fi, 1))
+            && is_resting_vertex(F(fi, 2));
+    };
+
+    for (int step = 0; step < 3; step++) {
+        rest_broad_phase.build(V0, V1, E, F, inflation_radius);
+        expected_broad_phase.build(V0, V1, E, F, inflation_radius);
+
+        // The first build has no motion history, so nothing rests yet;
+        // afterwards the settled cube's pairs must be culled.
+        const bool culled = step > 0;
+
+        std::vector<EdgeEdgeCandidate> ee, expected_ee;
+        rest_broad_phase.detect_edge_edge_candidates(ee);
+        expected_broad_phase.detect_edge_edge_candidates(expected_ee);
+        if (culled) {
+            expected_ee.erase(
+                std::remove_if(
+                    expected_ee.begin(), expected_ee.end(),
+                    [&](const EdgeEdgeCandidate& c) {
+                        return is_resting_edge(c.edge0_index)
+                            && is_resting_edge(c.edge1_index);
+                    }),
+                expected_ee.end());
+        }
+        std::sort(ee.begin(), ee.end());
+        std::sort(expected_ee.begin(), expected_ee.end());
+        CHECK(ee == expected_ee);
+
+        std::vector<FaceVertexCandidate> fv, expected_fv;
+        rest_broad_phase.detect_face_vertex_candidates(fv);
+        expected_broad_phase.detect_face_vertex_candidates(expected_fv);
+        if (culled) {
+            expected_fv.erase(
+                std::remove_if(
+                    expected_fv.begin(), expected_fv.end(),
+                    [&](const FaceVertexCandidate& c) {
+                        return is_resting_face(c.face_index)
+                            && is_resting_vertex(c.vertex_index);
+                    }),
+                expected_fv.end());
+        }
+        std::sort(fv.begin(), fv.end());
+        std::sort(expected_fv.begin(), expected_fv.end());
+        CHECK(fv == expected_fv);
+    }
+}
+
+TEST_CASE("Component broad phase", "[broad_phase][component]")
+{
+    Eigen::MatrixXd V_cube;
+    Eigen::MatrixXi E_cube, F_cube;
+    REQUIRE(
+        igl::read_triangle_mesh(TEST_DATA_DIR + "cube.obj", V_cube, F_cube));
+    igl::edges(F_cube, E_cube);
+
+    // Three disconnected cubes: one falling onto another and a third far
+    // away, so both the within-component and the cross-component paths are
+    // exercised, and one component pair fails the bounding-box pretest.
+    const long n = V_cube.rows();
+    Eigen::MatrixXd V0(3 * n, 3);
+    V0.topRows(n) = V_cube;
+    V0.middleRows(n, n) = V_cube.rowwise() + Eigen::RowVector3d(0, 1.5, 0);
+    V0.bottomRows(n) = V_cube.rowwise() + Eigen::RowVector3d(100, 0, 0);
+    Eigen::MatrixXd V1 = V0;
+    V1.middleRows(n, n).col(1).array() -= 1.0;
+
+    Eigen::MatrixXi E(3 * E_cube.rows(), 2), F(3 * F_cube.rows(), 3);
+    E << E_cube, E_cube.array() + n, E_cube.array() + 2 * n;
+    F << F_cube, F_cube.array() + n, F_cube.array() + 2 * n;
+
+    const double inflation_radius = GENERATE(0.0, 1e-2);
+    const bool ccd = GENERATE(false, true);
+    CAPTURE(inflation_radius, ccd);
+
+    ComponentBroadPhase component_broad_phase;
+    HashGrid expected_broad_phase;
+
+    // Rebuild twice to exercise the cached partition.
+    for (int step = 0; step < 2; step++) {
+        if (ccd) {
+            component_broad_phase.build(V0, V1, E, F, inflation_radius);
+            expected_broad_phase.build(V0, V1, E, F, inflation_radius);
+        } else {
+            component_broad_phase.build(V0, E, F, inflation_radius);
+            expected_broad_phase.build(V0, E, F, inflation_radius);
+        }
+
+        CHECK(component_broad_phase.num_components() == 3);
+
+        // The partitioned candidates must match the global reference.
+        std::vector<EdgeVertexCandidate> ev, expected_ev;
+        component_broad_phase.detect_edge_vertex_candidates(ev);
+        expected_broad_phase.detect_edge_vertex_candidates(expected_ev);
+        std::sort(ev.begin(), ev.end());
+        std::sort(expected_ev.begin(), expected_ev.end());
+        CHECK(ev == expected_ev);
+
+        std::vector<EdgeEdgeCandidate> ee, expected_ee;
+        component_broad_phase.detect_edge_edge_candidates(ee);
+        expected_broad_phase.detect_edge_edge_candidates(expected_ee);
+        std::sort(ee.begin(), ee.end());
+        std::sort(expected_ee.begin(), expected_ee.end());
+        CHECK(ee == expected_ee);
+
+        std::vector<FaceVertexCandidate> fv, expected_fv;
+        component_broad_phase.detect_face_vertex_candidates(fv);
+        expected_broad_phase.detect_face_vertex_candidates(expected_fv);
+        std::sort(fv.begin(), fv.end());
+        std::sort(expected_fv.begin(), expected_fv.end());
+        CHECK(fv == expected_fv);
+    }
+}
+
+TEST_CASE("Adaptive broad phase", "[broad_phase][adaptive]")
+{
+    Eigen::MatrixXd V;
+    Eigen::MatrixXi E, F;
+    REQUIRE(igl::read_triangle_mesh(TEST_DATA_DIR + "cube.obj", V, F));
+    igl::edges(F, E);
+
+    AdaptiveBroadPhase adaptive_broad_phase;
+    // A short cadence so the measurement rounds are exercised repeatedly.
+    adaptive_broad_phase.reevaluation_period = 2;
+
+    HashGrid expected_broad_phase;
+
+    const int num_candidate_methods = 4; // the default candidate set
+    for (int step = 0; step < 3 * num_candidate_methods; step++) {
+        CAPTURE(step);
+
+        adaptive_broad_phase.build(V, E, F, /*inflation_radius=*/1e-2);
+        expected_broad_phase.build(V, E, F, /*inflation_radius=*/1e-2);
+
+        // Whatever method is selected, the candidates must match a fixed
+        // reference method.
+        std::vector<EdgeEdgeCandidate> ee, expected_ee;
+        adaptive_broad_phase.detect_edge_edge_candidates(ee);
+        expected_broad_phase.detect_edge_edge_candidates(expected_ee);
+        std::sort(ee.begin(), ee.end());
+        std::sort(expected_ee.begin(), expected_ee.end());
+        CHECK(ee == expected_ee);
+
+        std::vector<FaceVertexCandidate> fv, expected_fv;
+        adaptive_broad_phase.detect_face_vertex_candidates(fv);
+        expected_broad_phase.detect_face_vertex_candidates(expected_fv);
+        std::sort(fv.begin(), fv.end());
+        std::sort(expected_fv.begin(), expected_fv.end());
+        CHECK(fv == expected_fv);
+
+        CHECK(adaptive_broad_phase.current_method() < BroadPhaseMethod::AUTO);
+    }
+
+    // The factory constructs the adaptive wrapper for the AUTO method.
+    std::unique_ptr<BroadPhase> made =
+        BroadPhase::make_broad_phase(BroadPhaseMethod::AUTO);
+    CHECK(dynamic_cast<AdaptiveBroadPhase*>(made.get()) != nullptr);
+}
+
+TEST_CASE("Patch-based culling", "[broad_phase]")
+{
+    Eigen::MatrixXd V_cube;
+    Eigen::MatrixXi E_cube, F_cube;
+    REQUIRE(
+        igl::read_triangle_mesh(TEST_DATA_DIR + "cube.obj", V_cube, F_cube));
+    igl::edges(F_cube, E_cube);
+
+    // Two interpenetrating cubes, one patch each, with self-collision
+    // disabled within each patch.
+    const long n = V_cube.rows();
+    Eigen::MatrixXd V(2 * n, 3);
+    V.topRows(n) = V_cube;
+    V.bottomRows(n) = V_cube.rowwise() + Eigen::RowVector3d(0, 0.5, 0);
+
+    Eigen::MatrixXi E(2 * E_cube.rows(), 2), F(2 * F_cube.rows(), 3);
+    E << E_cube, E_cube.array() + n;
+    F << F_cube, F_cube.array() + n;
+
+    Eigen::VectorXi patch_ids(2 * n);
+    patch_ids.head(n).setZero();
+    patch_ids.tail(n).setOnes();
+    Eigen::Matrix<bool, Eigen::Dynamic, Eigen::Dynamic> can_patches_collide(
+        2, 2);
+    can_patches_collide << false, true, //
+        true, false;
+
+    CollisionMesh patch_mesh(V, E, F);
+    patch_mesh.set_vertex_patch_ids(patch_ids, can_patches_collide);
+
+    // Reference: the same culling through the per-pair callback.
+    CollisionMesh callback_mesh(V, E, F);
+    callback_mesh.can_collide = [&patch_ids](size_t vi, size_t vj) {
+        return patch_ids[vi] != patch_ids[vj];
+    };
+
+    const double inflation_radius = GENERATE(0.0, 1e-2);
+    const BroadPhaseMethod method = GENERATE_BROAD_PHASE_METHODS();
+    CAPTURE(inflation_radius, method);
+
+    Candidates candidates, expected_candidates;
+    construct_collision_candidates(
+        patch_mesh, V, candidates, inflation_radius, method);
+    construct_collision_candidates(
+        callback_mesh, V, expected_candidates, inflation_radius, method);
+
+    CHECK(!expected_candidates.empty()); // The cross-patch pairs remain.
+
+    const auto sorted = [](auto candidates) {
+        std::sort(candidates.begin(), candidates.end());
+        return candidates;
+    };
+    CHECK(
+        sorted(candidates.ev_candidates)
+        == sorted(expected_candidates.ev_candidates));
+    CHECK(
+        sorted(candidates.ee_candidates)
+        == sorted(expected_candidates.ee_candidates));
+    CHECK(
+        sorted(candidates.fv_candidates)
+        == sorted(expected_candidates.fv_candidates));
+}
+
+TEST_CASE("Build margin", "[broad_phase]")
+{
+    Eigen::MatrixXd V;
+    Eigen::MatrixXi E, F;
+    REQUIRE(igl::read_triangle_mesh(TEST_DATA_DIR + "cube.obj", V, F));
+    igl::edges(F, E);
+    CollisionMesh mesh(V, E, F);
+
+    const double inflation_radius = 1e-3, margin = 1e-2;
+
+    HashGrid hash_grid;
+    hash_grid.set_build_margin(margin);
+
+    Candidates candidates;
+    construct_collision_candidates(
+        hash_grid, mesh, V, candidates, inflation_radius);
+
+    // Moving the vertices by less than the margin skips the rebuild but must
+    // still produce a superset of the exact candidates.
+    Eigen::MatrixXd U = Eigen::MatrixXd::Random(V.rows(), V.cols());
+    const Eigen::MatrixXd V1 = V + 0.5 * margin * U;
+
+    construct_collision_candidates(
+        hash_grid, mesh, V1, candidates, inflation_radius);
+
+    HashGrid exact_hash_grid;
+    Candidates exact_candidates;
+    construct_collision_candidates(
+        exact_hash_grid, mesh, V1, exact_candidates, inflation_radius);
+
+    std::sort(candidates.ee_candidates.begin(), candidates.ee_candidates.end());
+    std::sort(
+        exact_candidates.ee_candidates.begin(),
+        exact_candidates.ee_candidates.end());
+    CHECK(std::includes(
+        candidates.ee_candidates.begin(), candidates.ee_candidates.end(),
+        exact_candidates.ee_candidates.begin(),
+        exact_candidates.ee_candidates.end()));
+
+    std::sort(candidates.fv_candidates.begin(), candidates.fv_candidates.end());
+    std::sort(
+        exact_candidates.fv_candidates.begin(),
+        exact_candidates.fv_candidates.end());
+    CHECK(std::includes(
+        candidates.fv_candidates.begin(), candidates.fv_candidates.end(),
+        exact_candidates.fv_candidates.begin(),
+        exact_candidates.fv_candidates.end()));
+}
+
+TEST_CASE("Asynchronous broad phase build", "[broad_phase][async]")
+{
+    Eigen::MatrixXd V;
+    Eigen::MatrixXi E, F;
+    REQUIRE(igl::read_triangle_mesh(TEST_DATA_DIR + "cube.obj", V, F));
+    igl::edges(F, E);
+
+    const BroadPhaseMethod method = GENERATE_BROAD_PHASE_METHODS();
+
+    std::unique_ptr<BroadPhase> broad_phase =
+        BroadPhase::make_broad_phase(method);
+
+    // The inputs are copied, so the caller's matrices may be overwritten
+    // while the build runs.
+    Eigen::MatrixXd V_predicted = V;
+    std::future<void> build_done =
+        broad_phase->begin_build(V_predicted, E, F, /*inflation_radius=*/1e-2);
+    V_predicted.setZero();
+    build_done.wait();
+
+    Candidates candidates;
+    broad_phase->detect_collision_candidates(V.cols(), candidates);
+
+    std::unique_ptr<BroadPhase> sync_broad_phase =
+        BroadPhase::make_broad_phase(method);
+    sync_broad_phase->build(V, E, F, /*inflation_radius=*/1e-2);
+    Candidates sync_candidates;
+    sync_broad_phase->detect_collision_candidates(V.cols(), sync_candidates);
+
+    REQUIRE(candidates.size() == sync_candidates.size());
+    CHECK(candidates.ee_candidates == sync_candidates.ee_candidates);
+    CHECK(candidates.fv_candidates == sync_candidates.fv_candidates);
+}
+
+TEST_CASE("Broad phase stats", "[broad_phase]")
+{
+    Eigen::MatrixXd V;
+    Eigen::MatrixXi E, F;
+    REQUIRE(igl::read_triangle_mesh(TEST_DATA_DIR + "cube.obj", V, F));
+    igl::edges(F, E);
+
+    HashGrid hash_grid;
+    hash_grid.enable_stats();
+    hash_grid.build(V, E, F, /*inflation_radius=*/1e-2);
+
+    Candidates candidates;
+    hash_grid.detect_collision_candidates(V.cols(), candidates);
+
+    const BroadPhaseStats stats = hash_grid.stats();
+    CHECK(stats.num_boxes[0] == size_t(V.rows()));
+    CHECK(stats.num_boxes[1] == size_t(E.rows()));
+    CHECK(stats.num_boxes[2] == size_t(F.rows()));
+    CHECK(stats.num_candidates == candidates.size());
+    CHECK(stats.build_time > 0);
+    CHECK(stats.detect_time > 0);
+    CHECK(!stats.boxes_per_cell_histogram.empty());
+}
+
+TEST_CASE("Broad phase memory accounting", "[broad_phase]")
+{
+    Eigen::MatrixXd V;
+    Eigen::MatrixXi E, F;
+    REQUIRE(igl::read_triangle_mesh(TEST_DATA_DIR + "cube.obj", V, F));
+    igl::edges(F, E);
+
+    const BroadPhaseMethod method = GENERATE_BROAD_PHASE_METHODS();
+
+    std::unique_ptr<BroadPhase> broad_phase =
+        BroadPhase::make_broad_phase(method);
+    broad_phase->build(V, E, F, /*inflation_radius=*/1e-2);
+
+    const size_t built_bytes = broad_phase->bytes_used();
+    CHECK(built_bytes > 0);
+    CHECK(broad_phase->peak_bytes_used() >= built_bytes);
+
+    // The peak persists across clear() (which keeps vector capacities, so
+    // bytes_used() itself may not shrink).
+    broad_phase->clear();
+    CHECK(broad_phase->peak_bytes_used() >= built_bytes);
+}
+
+TEST_CASE("Morton ordering", "[broad_phase]")
+{
+    Eigen::MatrixXd V;
+    Eigen::MatrixXi E, F;
+    REQUIRE(igl::read_triangle_mesh(TEST_DATA_DIR + "cube.obj", V, F));
+    igl::edges(F, E);
+
+    const BroadPhaseMethod method = GENERATE_BROAD_PHASE_METHODS();
+
+    std::unique_ptr<BroadPhase> broad_phase =
+        BroadPhase::make_broad_phase(method, /*use_morton_ordering=*/true);
+    broad_phase->build(V, E, F, /*inflation_radius=*/1e-2);
+
+    std::unique_ptr<BroadPhase> expected_broad_phase =
+        BroadPhase::make_broad_phase(method, /*use_morton_ordering=*/false);
+    expected_broad_phase->build(V, E, F, /*inflation_radius=*/1e-2);
+
+    // Reordering only changes the storage; the sorted candidates must match.
+    std::vector<EdgeEdgeCandidate> ee_candidates, expected_ee_candidates;
+    broad_phase->detect_edge_edge_candidates(ee_candidates);
+    expected_broad_phase->detect_edge_edge_candidates(expected_ee_candidates);
+    std::sort(ee_candidates.begin(), ee_candidates.end());
+    std::sort(expected_ee_candidates.begin(), expected_ee_candidates.end());
+    CHECK(ee_candidates == expected_ee_candidates);
+
+    std::vector<FaceVertexCandidate> fv_candidates, expected_fv_candidates;
+    broad_phase->detect_face_vertex_candidates(fv_candidates);
+    expected_broad_phase->detect_face_vertex_candidates(
+        expected_fv_candidates);
+    std::sort(fv_candidates.begin(), fv_candidates.end());
+    std::sort(expected_fv_candidates.begin(), expected_fv_candidates.end());
+    CHECK(fv_candidates == expected_fv_candidates);
+}
+
+TEST_CASE("Active-zone collision detection", "[broad_phase]")
+{
+    Eigen::MatrixXd V;
+    Eigen::MatrixXi E, F;
+    REQUIRE(igl::read_triangle_mesh(TEST_DATA_DIR + "cube.obj", V, F));
+    igl::edges(F, E);
+
+    const double inflation_radius = 1e-2;
+
+    HashGrid full;
+    full.build(V, E, F, inflation_radius);
+    Candidates full_candidates;
+    full.detect_collision_candidates(V.cols(), full_candidates);
+    REQUIRE(full_candidates.size() > 0);
+
+    const ArrayMax3d scene_min = V.colwise().minCoeff().transpose().array();
+    const ArrayMax3d scene_max = V.colwise().maxCoeff().transpose().array();
+    const AABB scene_zone(scene_min - 1, scene_max + 1);
+    const AABB far_zone(scene_min + 100, scene_max + 100);
+
+    // A zone covering the scene changes nothing.
+    HashGrid zoned;
+    zoned.set_active_zones({ scene_zone }, /*fallback_period=*/0);
+    zoned.build(V, E, F, inflation_radius);
+    Candidates zoned_candidates;
+    zoned.detect_collision_candidates(V.cols(), zoned_candidates);
+    CHECK(zoned_candidates.size() == full_candidates.size());
+
+    // A zone away from the scene leaves nothing to detect.
+    zoned.set_active_zones({ far_zone }, /*fallback_period=*/0);
+    zoned.build(V, E, F, inflation_radius);
+    zoned.detect_collision_candidates(V.cols(), zoned_candidates);
+    CHECK(zoned_candidates.size() == 0);
+
+    // With a fallback period, every period-th build runs the full scene.
+    zoned.set_active_zones({ far_zone }, /*fallback_period=*/2);
+    for (int build = 1; build <= 4; build++) {
+        CAPTURE(build);
+        zoned.build(V, E, F, inflation_radius);
+        zoned.detect_collision_candidates(V.cols(), zoned_candidates);
+        if (build % 2 == 0) {
+            CHECK(zoned_candidates.size() == full_candidates.size());
+        } else {
+            CHECK(zoned_candidates.size() == 0);
+        }
+    }
+
+    // The filter composes with Morton ordering: the remapped candidates of a
+    // scene-covering zone must match the unordered full build.
+    std::unique_ptr<BroadPhase> morton = BroadPhase::make_broad_phase(
+        BroadPhaseMethod::HASH_GRID, /*use_morton_ordering=*/true);
+    morton->set_active_zones({ scene_zone }, /*fallback_period=*/0);
+    morton->build(V, E, F, inflation_radius);
+    std::vector<FaceVertexCandidate> fv_candidates, expected_fv_candidates;
+    morton->detect_face_vertex_candidates(fv_candidates);
+    full.detect_face_vertex_candidates(expected_fv_candidates);
+    std::sort(fv_candidates.begin(), fv_candidates.end());
+    std::sort(expected_fv_candidates.begin(), expected_fv_candidates.end());
+    CHECK(fv_candidates == expected_fv_candidates);
+}
+
+TEST_CASE("Hash-grid cell-size tuning", "[broad_phase][hash_grid]")
+{
+    Eigen::MatrixXd V;
+    Eigen::MatrixXi E, F;
+    REQUIRE(igl::read_triangle_mesh(TEST_DATA_DIR + "cube.obj", V, F));
+    igl::edges(F, E);
+
+    const double inflation_radius = 1e-2;
+
+    HashGrid untuned;
+    untuned.build(V, E, F, inflation_radius);
+    Candidates expected_candidates;
+    untuned.detect_collision_candidates(V.cols(), expected_candidates);
+    REQUIRE(expected_candidates.size() > 0);
+    CHECK(untuned.cell_size_scale() == 1.0);
+
+    constexpr double min_scale = 0.25, max_scale = 4.0;
+    HashGrid tuned;
+    tuned.set_cell_size_tuning(true, min_scale, max_scale);
+
+    // The grid is exact at every cell size, so each build of the feedback
+    // loop must find the same candidates while the scale stays in bounds.
+    for (int build = 0; build < 16; build++) {
+        CAPTURE(build);
+        tuned.build(V, E, F, inflation_radius);
+        Candidates tuned_candidates;
+        tuned.detect_collision_candidates(V.cols(), tuned_candidates);
+        CHECK(tuned_candidates.size() == expected_candidates.size());
+        CHECK(tuned.cell_size_scale() >= min_scale);
+        CHECK(tuned.cell_size_scale() <= max_scale);
+    }
+    // The tuner probed away from the heuristic suggestion.
+    CHECK(tuned.cell_size_scale() != 1.0);
+}
+
+TEST_CASE("Batched box query", "[broad_phase]")
+{
+    Eigen::MatrixXd V;
+    Eigen::MatrixXi E, F;
+    REQUIRE(igl::read_triangle_mesh(TEST_DATA_DIR + "cube.obj", V, F));
+    igl::edges(F, E);
+
+    const ArrayMax3d scene_min = V.colwise().minCoeff().transpose().array();
+    const ArrayMax3d scene_max = V.colwise().maxCoeff().transpose().array();
+    const ArrayMax3d v0 = V.row(0).transpose().array();
+
+    std::vector<AABB> queries;
+    // The entire scene, a box around the first vertex, and an empty box.
+    queries.emplace_back(scene_min - 1, scene_max + 1);
+    queries.emplace_back(v0 - 1e-2, v0 + 1e-2);
+    queries.emplace_back(scene_max + 1, scene_max + 2);
+
+    // The brute-force scan of the base class is the reference.
+    BoxQueryResult expected;
+    {
+        std::unique_ptr<BroadPhase> brute_force =
+            BroadPhase::make_broad_phase(BroadPhaseMethod::BRUTE_FORCE);
+        brute_force->build(V, E, F);
+        brute_force->query_boxes(queries, expected);
+    }
+    REQUIRE(expected.vertex_ids.size() == size_t(V.rows())); // first query
+    REQUIRE(expected.face_offsets.back() == expected.face_offsets[2]); // last
+
+    const BroadPhaseMethod method = GENERATE(
+        BroadPhaseMethod::HASH_GRID, BroadPhaseMethod::SPATIAL_HASH,
+        BroadPhaseMethod::BVH, BroadPhaseMethod::TWO_LEVEL_SPATIAL_HASH);
+
+    std::unique_ptr<BroadPhase> broad_phase =
+        BroadPhase::make_broad_phase(method);
+    broad_phase->build(V, E, F);
+
+    BoxQueryResult result;
+    broad_phase->query_boxes(queries, result);
+
+    CHECK(result.vertex_offsets == expected.vertex_offsets);
+    CHECK(result.vertex_ids == expected.vertex_ids);
+    CHECK(result.edge_offsets == expected.edge_offsets);
+    CHECK(result.edge_ids == expected.edge_ids);
+    CHECK(result.face_offsets == expected.face_offsets);
+    CHECK(result.face_ids == expected.face_ids);
+}
+
+TEST_CASE("Candidates SoA", "[broad_phase]")
+{
+    Eigen::MatrixXd V;
+    Eigen::MatrixXi E, F;
+    REQUIRE(igl::read_triangle_mesh(TEST_DATA_DIR + "cube.obj", V, F));
+    igl::edges(F, E);
+
+    HashGrid hash_grid;
+    hash_grid.build(V, E, F, /*inflation_radius=*/1e-2);
+
+    Candidates candidates;
+    hash_grid.detect_collision_candidates(V.cols(), candidates);
+    REQUIRE(!candidates.empty());
+
+    CandidatesSoA soa;
+    soa.build(candidates);
+
+    REQUIRE(soa.size() == candidates.size());
+    REQUIRE(soa.ee_edges0.size() == candidates.ee_candidates.size());
+    REQUIRE(soa.fv_faces.size() == candidates.fv_candidates.size());
+    for (size_t i = 0; i < candidates.ee_candidates.size(); i++) {
+        CHECK(soa.ee_edges0[i] == candidates.ee_candidates[i].edge0_index);
+        CHECK(soa.ee_edges1[i] == candidates.ee_candidates[i].edge1_index);
+    }
+    for (size_t i = 0; i < candidates.fv_candidates.size(); i++) {
+        CHECK(soa.fv_faces[i] == candidates.fv_candidates[i].face_index);
+        CHECK(soa.fv_vertices[i] == candidates.fv_candidates[i].vertex_index);
+    }
+
+    // Rebuilding reuses the arrays without reallocating.
+    const long* ee_data = soa.ee_edges0.data();
+    soa.build(candidates);
+    CHECK(soa.ee_edges0.data() == ee_data);
+    CHECK(soa.size() == candidates.size());
+}
+
 TEST_CASE("Cloth-Ball", "[ccd][broad_phase][cloth-ball][!hide]")
 {
     Eigen::MatrixXd V0, V1;
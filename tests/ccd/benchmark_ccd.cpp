@@ -8,6 +8,10 @@
 
 #include <ipc/ipc.hpp>
 
+#include <fmt/format.h>
+
+#include <array>
+
 #include "test_utils.hpp"
 
 using namespace ipc;
@@ -72,7 +76,100 @@ TEST_CASE("Benchmark earliest toi", "[!benchmark][ccd][earliest_toi]")
     BENCHMARK(fmt::format("Earliest ToI Narrow-Phase"))
     {
         stepsize = compute_collision_free_stepsize(
-            candidates, mesh, V0, V1, tolerance, max_iterations);
+            candidates, mesh, V0, V1, /*min_distance=*/0, tolerance,
+            max_iterations);
     };
     // }
 }
+
+TEST_CASE("Benchmark CCD replay", "[!benchmark][ccd][replay]")
+{
+    Eigen::MatrixXd V0, V1;
+    Eigen::MatrixXi E, F;
+
+    const std::string dir = TEST_DATA_DIR;
+
+    bool success = igl::read_triangle_mesh(dir + "cloth_ball92.ply", V0, F);
+    if (!success) {
+        return; // Data is private
+    }
+
+    success = igl::read_triangle_mesh(dir + "cloth_ball93.ply", V1, F);
+    if (!success) {
+        return; // Data is private
+    }
+
+    igl::edges(F, E);
+
+    CollisionMesh mesh = CollisionMesh::build_from_full_mesh(V0, E, F);
+    // Discard codimensional/internal vertices
+    V0 = mesh.vertices(V0);
+    V1 = mesh.vertices(V1);
+
+    Candidates candidates;
+    construct_collision_candidates(
+        mesh, V0, V1, candidates, /*inflation_radius=*/0,
+        BroadPhaseMethod::HASH_GRID);
+
+    // Replay every candidate through the narrow phase one query at a time,
+    // reporting the throughput per candidate type and a latency histogram so
+    // performance changes to the CCD stack are quantified per commit.
+    const std::vector<std::pair<std::string, std::pair<size_t, size_t>>>
+        batches = {
+            { "edge-vertex", { 0, candidates.ev_candidates.size() } },
+            { "edge-edge",
+              { candidates.ev_candidates.size(),
+                candidates.ev_candidates.size()
+                    + candidates.ee_candidates.size() } },
+            { "point-triangle",
+              { candidates.ev_candidates.size()
+                    + candidates.ee_candidates.size(),
+                candidates.size() } },
+        };
+
+    igl::Timer timer;
+    for (const auto& [name, range] : batches) {
+        if (range.first == range.second) {
+            continue;
+        }
+
+        // Histogram of per-query latencies in decade buckets starting at 1us.
+        std::array<size_t, 5> histogram = { { 0, 0, 0, 0, 0 } };
+        double total_time = 0; // seconds
+
+        for (size_t i = range.first; i < range.second; i++) {
+            double toi;
+            timer.start();
+            candidates[i].ccd(V0, V1, mesh.edges(), mesh.faces(), toi);
+            timer.stop();
+
+            const double elapsed = timer.getElapsedTimeInSec();
+            total_time += elapsed;
+
+            size_t bucket = 0;
+            for (double upper = 1e-6; bucket + 1 < histogram.size()
+                 && elapsed >= upper;
+                 upper *= 10) {
+                bucket++;
+            }
+            histogram[bucket]++;
+        }
+
+        const size_t num_queries = range.second - range.first;
+        fmt::print(
+            "{}: {} queries in {:g} s ({:g} queries/s)\n", name, num_queries,
+            total_time, num_queries / total_time);
+        fmt::print(
+            "  latency histogram: <1us: {}; 1-10us: {}; 10-100us: {}; "
+            "0.1-1ms: {}; >=1ms: {}\n",
+            histogram[0], histogram[1], histogram[2], histogram[3],
+            histogram[4]);
+    }
+
+    double stepsize;
+    BENCHMARK("Replay earliest ToI")
+    {
+        stepsize = compute_collision_free_stepsize(
+            candidates, mesh, V0, V1);
+    };
+}
@@ -0,0 +1,54 @@
+#include <catch2/catch.hpp>
+
+#include <ipc/ccd/additive_ccd.hpp>
+#include <ipc/distance/point_triangle.hpp>
+
+using namespace ipc;
+
+TEST_CASE("Point-Triangle additive CCD", "[ccd][additive][point-triangle]")
+{
+    // Point above the triangle moving straight down.
+    Eigen::Vector3d p_t0(0, 1, 0);
+    Eigen::Vector3d t0(-1, 0, 1);
+    Eigen::Vector3d t1(1, 0, 1);
+    Eigen::Vector3d t2(0, 0, -1);
+
+    double y_displacement = GENERATE(-1.0, 0.5, 1.0, 2.0);
+    Eigen::Vector3d p_t1 = p_t0 - Eigen::Vector3d(0, y_displacement, 0);
+
+    double toi;
+    bool is_colliding =
+        point_triangle_additive_ccd(p_t0, t0, t1, t2, p_t1, t0, t1, t2, toi);
+
+    CAPTURE(y_displacement);
+    CHECK(is_colliding == (y_displacement >= 1.0));
+    if (is_colliding) {
+        // The impact happens at t = 1 / y_displacement; the reported toi must
+        // be conservative and stop before the primitives touch.
+        CHECK(toi <= 1.0 / y_displacement);
+        Eigen::Vector3d p_toi = p_t0 + toi * (p_t1 - p_t0);
+        CHECK(point_triangle_distance(p_toi, t0, t1, t2) > 0);
+    }
+}
+
+TEST_CASE("Edge-Edge additive CCD", "[ccd][additive][edge-edge]")
+{
+    // Crossed edges approaching along y.
+    Eigen::Vector3d ea0(-1, -1, 0), ea1(1, -1, 0);
+    Eigen::Vector3d eb0(0, 1, -1), eb1(0, 1, 1);
+
+    double y_displacement = GENERATE(-1.0, 0.0, 1.0, 2.0);
+    Eigen::Vector3d u_a(0, y_displacement, 0);
+    Eigen::Vector3d u_b(0, -y_displacement, 0);
+
+    double toi;
+    bool is_colliding = edge_edge_additive_ccd(
+        ea0, ea1, eb0, eb1, ea0 + u_a, ea1 + u_a, eb0 + u_b, eb1 + u_b, toi);
+
+    CAPTURE(y_displacement);
+    CHECK(is_colliding == (y_displacement >= 1.0));
+    if (is_colliding) {
+        CHECK(toi <= 1.0 / y_displacement);
+        CHECK(toi > 0);
+    }
+}
@@ -3,6 +3,7 @@
 #include <ipc/ipc.hpp>
 #include <ipc/ccd/ccd.hpp>
 #include <ipc/ccd/point_static_plane.hpp>
+#include <ipc/distance/point_triangle.hpp>
 
 #include <test_utils.hpp>
 
@@ -120,6 +121,7 @@ TEST_CASE("Point-edge 2D CCD", "[ccd]")
     double toi, alpha;
     bool is_colliding = point_edge_ccd(
         p_t0, e0_t0, e1_t0, p_t1, e0_t1, e1_t1, toi,
+        /*min_distance=*/0,
         /*tmax=*/1.0,
         /*tolerance=*/1e-6,
         /*max_iterations=*/1e7,
@@ -153,6 +155,7 @@ void check_toi(
     toi_actual = -1.0;
     bool has_collision = point_edge_ccd(
         p_t0, e0_t0, e1_t0, p_t1, e0_t1, e1_t1, toi_actual,
+        /*min_distance=*/0,
         /*tmax=*/1.0,
         /*tolerance=*/1e-6,
         /*max_iterations=*/1e7,
@@ -325,7 +328,8 @@ TEST_CASE("Repeated CCD", "[ccd][repeat]")
         candidates, mesh, V0, V1, FIRST_TOL, FIRST_MAX_ITER);
 
     double stepsize = compute_collision_free_stepsize(
-        candidates, mesh, V0, V1, FIRST_TOL, FIRST_MAX_ITER);
+        candidates, mesh, V0, V1, /*min_distance=*/0, FIRST_TOL,
+        FIRST_MAX_ITER);
 
     if (!has_collisions) {
         CHECK(stepsize == 1.0);
@@ -348,7 +352,8 @@ TEST_CASE("Repeated CCD", "[ccd][repeat]")
             candidates, mesh, V0, Vt, SECOND_TOL, SECOND_MAX_ITER);
 
         stepsize_repeated = compute_collision_free_stepsize(
-            candidates, mesh, V0, Vt, SECOND_TOL, SECOND_MAX_ITER);
+            candidates, mesh, V0, Vt, /*min_distance=*/0, SECOND_TOL,
+            SECOND_MAX_ITER);
 
         CAPTURE(
             t0_filename, t1_filename, broadphase_method, recompute_candidates,
@@ -361,6 +366,152 @@ TEST_CASE("Repeated CCD", "[ccd][repeat]")
     } while (has_collisions_repeated && stepsize_repeated != 1.0);
 }
 
+TEST_CASE("Line-search CCD context", "[ccd][line-search]")
+{
+    std::string t0_filename, t1_filename;
+    SECTION("tooth")
+    {
+        t0_filename = "ccd-failure/repeated_toi_tooth_0.obj";
+        t1_filename = "ccd-failure/repeated_toi_tooth_1.obj";
+    }
+    SECTION("hip")
+    {
+        t0_filename = "ccd-failure/repeated_toi_hip_0.obj";
+        t1_filename = "ccd-failure/repeated_toi_hip_1.obj";
+    }
+
+    Eigen::MatrixXd V0, V1;
+    Eigen::MatrixXi E, F;
+    bool success =
+        load_mesh(t0_filename, V0, E, F) && load_mesh(t1_filename, V1, E, F);
+    if (!success) {
+        return;
+    }
+
+    CollisionMesh mesh = CollisionMesh::build_from_full_mesh(V0, E, F);
+    V0 = mesh.vertices(V0);
+    V1 = mesh.vertices(V1);
+
+    CCDContext context;
+    context.build(mesh, V0, V1);
+
+    // Same direction, so the candidate set matches a direct construction.
+    Candidates candidates;
+    construct_collision_candidates(mesh, V0, V1, candidates);
+    CHECK(context.candidates().size() == candidates.size());
+
+    const double full_step = context.compute_collision_free_stepsize(mesh);
+    CHECK(full_step >= 0);
+    CHECK(full_step <= 1.0);
+
+    // A trial step scaled by α sweeps the prefix of the full direction, so
+    // its collision-free fraction is the full step's earliest toi rescaled.
+    for (const double alpha : { 0.9, 0.5, 0.25, 0.1, 0.01 }) {
+        CAPTURE(t0_filename, alpha, full_step);
+        const double expected = std::min(1.0, full_step / alpha);
+        CHECK(
+            context.compute_collision_free_stepsize(mesh, alpha)
+            == Approx(expected));
+    }
+}
+
+TEST_CASE("Deadline-bounded CCD", "[ccd][budget]")
+{
+    std::string t0_filename, t1_filename;
+    SECTION("tooth")
+    {
+        t0_filename = "ccd-failure/repeated_toi_tooth_0.obj";
+        t1_filename = "ccd-failure/repeated_toi_tooth_1.obj";
+    }
+    SECTION("hip")
+    {
+        t0_filename = "ccd-failure/repeated_toi_hip_0.obj";
+        t1_filename = "ccd-failure/repeated_toi_hip_1.obj";
+    }
+
+    Eigen::MatrixXd V0, V1;
+    Eigen::MatrixXi E, F;
+    bool success =
+        load_mesh(t0_filename, V0, E, F) && load_mesh(t1_filename, V1, E, F);
+    if (!success) {
+        return;
+    }
+
+    CollisionMesh mesh = CollisionMesh::build_from_full_mesh(V0, E, F);
+    V0 = mesh.vertices(V0);
+    V1 = mesh.vertices(V1);
+
+    Candidates candidates;
+    construct_collision_candidates(mesh, V0, V1, candidates);
+
+    const double full_step =
+        compute_collision_free_stepsize(candidates, mesh, V0, V1);
+
+    // An unlimited budget should not change the answer.
+    CCDBudget unlimited;
+    CHECK(
+        compute_collision_free_stepsize(
+            candidates, mesh, V0, V1, /*min_distance=*/0, /*tolerance=*/1e-6,
+            /*max_iterations=*/long(1e7), /*adaptive_tolerance=*/false,
+            &unlimited)
+        == full_step);
+    CHECK(!unlimited.expired);
+
+    // An exhausted budget must still return a certified collision-free
+    // (if smaller) step from the conservative bounds.
+    CCDBudget exhausted;
+    exhausted.max_queries = 0;
+    const double budgeted_step = compute_collision_free_stepsize(
+        candidates, mesh, V0, V1, /*min_distance=*/0, /*tolerance=*/1e-6,
+        /*max_iterations=*/long(1e7), /*adaptive_tolerance=*/false,
+        &exhausted);
+    CAPTURE(t0_filename, full_step, budgeted_step);
+    CHECK(exhausted.expired);
+    CHECK(budgeted_step >= 0);
+    CHECK(budgeted_step <= full_step);
+    const Eigen::MatrixXd Vt = (V1 - V0) * budgeted_step + V0;
+    CHECK(is_step_collision_free(candidates, mesh, V0, Vt));
+}
+
+TEST_CASE("CCD stats", "[ccd][stats]")
+{
+    Eigen::MatrixXd V0, V1;
+    Eigen::MatrixXi E, F;
+    bool success =
+        load_mesh("ccd-failure/repeated_toi_tooth_0.obj", V0, E, F)
+        && load_mesh("ccd-failure/repeated_toi_tooth_1.obj", V1, E, F);
+    if (!success) {
+        return;
+    }
+
+    CollisionMesh mesh = CollisionMesh::build_from_full_mesh(V0, E, F);
+    V0 = mesh.vertices(V0);
+    V1 = mesh.vertices(V1);
+
+    enable_ccd_stats();
+    reset_ccd_stats();
+    compute_collision_free_stepsize(mesh, V0, V1);
+
+    const CCDStats stats = ccd_stats();
+    CAPTURE(
+        stats.num_queries, stats.num_impacts, stats.num_tolerance_unmet,
+        stats.max_reached_tolerance);
+    CHECK(stats.num_queries > 0);
+    CHECK(stats.num_impacts <= stats.num_queries);
+    CHECK(stats.num_tolerance_unmet <= stats.num_queries);
+    CHECK(stats.max_reached_tolerance > 0);
+    CHECK(stats.sum_reached_tolerance > 0);
+    CHECK(
+        stats.sum_reached_tolerance
+        <= stats.num_queries * stats.max_reached_tolerance);
+
+    // Disabled collection must not record.
+    enable_ccd_stats(false);
+    reset_ccd_stats();
+    compute_collision_free_stepsize(mesh, V0, V1);
+    CHECK(ccd_stats().num_queries == 0);
+}
+
 // This test takes too long
 // TEST_CASE("Point-Triangle 3D CCD", "[ccd][point-triangle][timeout]")
 // {
@@ -576,6 +727,30 @@ TEST_CASE("No Zero ToI CCD", "[ccd][no-zero-toi]")
     CHECK(!is_impacting);
 }
 
+TEST_CASE(
+    "Point-triangle CCD with minimum separation", "[ccd][min-separation]")
+{
+    // Point moving straight through the triangle's interior.
+    Eigen::Vector3d p_t0(0, 1, 0), p_t1(0, -1, 0);
+    Eigen::Vector3d t0(-1, 0, 1), t1(1, 0, 1), t2(0, 0, -1);
+
+    double min_distance = GENERATE(0.0, 1e-4, 1e-2, 0.1);
+
+    double toi;
+    bool is_impacting = point_triangle_ccd(
+        p_t0, t0, t1, t2, p_t1, t0, t1, t2, toi, min_distance);
+
+    CAPTURE(min_distance);
+    CHECK(is_impacting);
+    // The point reaches the plane at t = 0.5, so a minimum separation must
+    // stop strictly earlier.
+    CHECK(toi < 0.5);
+    Eigen::Vector3d p_toi = p_t0 + toi * (p_t1 - p_t0);
+    CHECK(
+        point_triangle_distance(p_toi, t0, t1, t2)
+        > min_distance * min_distance);
+}
+
 TEST_CASE("Slow EE CCD", "[ccd][edge-edge][slow]")
 {
     Eigen::Vector3d ea0_t0, ea1_t0, eb0_t0, eb1_t0, ea0_t1, ea1_t1, eb0_t1,
@@ -603,7 +778,7 @@ TEST_CASE("Slow EE CCD", "[ccd][edge-edge][slow]")
         double toi;
         bool is_impacting = edge_edge_ccd(
             ea0_t0, ea1_t0, eb0_t0, eb1_t0, ea0_t1, ea1_t1, eb0_t1, eb1_t1, toi,
-            1.0, tol, max_iter);
+            /*min_distance=*/0, 1.0, tol, max_iter);
         tol *= 10;
 
         CAPTURE(toi);
@@ -631,7 +806,7 @@ TEST_CASE("Slow EE CCD 2", "[ccd][edge-edge][slow][thisone]")
     double toi;
     bool is_impacting = edge_edge_ccd(
         ea0_t0, ea1_t0, eb0_t0, eb1_t0, ea0_t1, ea1_t1, eb0_t1, eb1_t1, toi,
-        tmax, tol, max_iter);
+        /*min_distance=*/0, tmax, tol, max_iter);
 
     CAPTURE(toi);
     CHECK(is_impacting);
@@ -0,0 +1,146 @@
+#include <catch2/catch.hpp>
+
+#include <ipc/ccd/inexact_ccd_batch.hpp>
+#include <ipc/ccd/inexact_point_edge.hpp>
+
+#include <cmath>
+#include <limits>
+
+using namespace ipc;
+
+TEST_CASE("Batched inexact point-edge CCD 2D", "[ccd][batch]")
+{
+    // Random queries around an impact course so the batch mixes hits,
+    // misses, and near-parallel motion; every lane must match the scalar
+    // kernel exactly.
+    const int n = 256;
+    Eigen::MatrixXd P_t0(n, 2), E0_t0(n, 2), E1_t0(n, 2);
+    Eigen::MatrixXd P_t1(n, 2), E0_t1(n, 2), E1_t1(n, 2);
+
+    std::srand(42);
+    for (int i = 0; i < n; i++) {
+        P_t0.row(i) = Eigen::RowVector2d(0, 1) + 0.5 * Eigen::RowVector2d::Random();
+        E0_t0.row(i) = Eigen::RowVector2d(-1, 0) + 0.5 * Eigen::RowVector2d::Random();
+        E1_t0.row(i) = Eigen::RowVector2d(1, 0) + 0.5 * Eigen::RowVector2d::Random();
+        P_t1.row(i) = P_t0.row(i) + Eigen::RowVector2d(0, -2)
+            + 0.5 * Eigen::RowVector2d::Random();
+        E0_t1.row(i) = E0_t0.row(i) + 0.1 * Eigen::RowVector2d::Random();
+        E1_t1.row(i) = E1_t0.row(i) + 0.1 * Eigen::RowVector2d::Random();
+    }
+
+    Eigen::ArrayXd toi;
+    inexact_point_edge_ccd_2D_batch(
+        P_t0, E0_t0, E1_t0, P_t1, E0_t1, E1_t1, toi);
+
+    REQUIRE(toi.size() == n);
+    int num_hits = 0;
+    for (int i = 0; i < n; i++) {
+        CAPTURE(i);
+        double scalar_toi;
+        const bool scalar_hit = inexact_point_edge_ccd_2D(
+            P_t0.row(i).transpose(), E0_t0.row(i).transpose(),
+            E1_t0.row(i).transpose(), P_t1.row(i).transpose(),
+            E0_t1.row(i).transpose(), E1_t1.row(i).transpose(), scalar_toi);
+        if (scalar_hit) {
+            num_hits++;
+            CHECK(toi[i] == Approx(scalar_toi).margin(1e-12));
+        } else {
+            CHECK(std::isinf(toi[i]));
+        }
+    }
+    CHECK(num_hits > 0); // the setup should produce some impacts
+}
+
+TEST_CASE("Batched inexact point-triangle CCD", "[ccd][batch]")
+{
+    // A point dropping straight onto the unit triangle from height h at
+    // speed s hits at t = h/s; vary the height, start some lanes outside
+    // the triangle's interior, and move some lanes away instead.
+    const int n = 64;
+    Eigen::MatrixXd P_t0(n, 3), T0_t0(n, 3), T1_t0(n, 3), T2_t0(n, 3);
+    Eigen::MatrixXd P_t1(n, 3), T0_t1(n, 3), T1_t1(n, 3), T2_t1(n, 3);
+
+    std::vector<double> expected_toi(n);
+    for (int i = 0; i < n; i++) {
+        T0_t0.row(i) = Eigen::RowVector3d(0, 0, 0);
+        T1_t0.row(i) = Eigen::RowVector3d(1, 0, 0);
+        T2_t0.row(i) = Eigen::RowVector3d(0, 1, 0);
+        T0_t1.row(i) = T0_t0.row(i);
+        T1_t1.row(i) = T1_t0.row(i);
+        T2_t1.row(i) = T2_t0.row(i);
+
+        const double h = 0.1 + 0.8 * (i % 8) / 8.0;
+        const bool misses_plane = i % 4 == 1;  // moves away from the plane
+        const bool misses_inside = i % 4 == 2; // crosses outside the triangle
+
+        const double x = misses_inside ? 2.0 : 0.25;
+        P_t0.row(i) = Eigen::RowVector3d(x, 0.25, h);
+        P_t1.row(i) =
+            P_t0.row(i) + Eigen::RowVector3d(0, 0, misses_plane ? 1 : -1);
+        expected_toi[i] = misses_plane || misses_inside
+            ? std::numeric_limits<double>::infinity()
+            : h;
+    }
+
+    const double conservative_rescaling = 0.9;
+    Eigen::ArrayXd toi;
+    inexact_point_triangle_ccd_batch(
+        P_t0, T0_t0, T1_t0, T2_t0, P_t1, T0_t1, T1_t1, T2_t1, toi,
+        conservative_rescaling);
+
+    REQUIRE(toi.size() == n);
+    for (int i = 0; i < n; i++) {
+        CAPTURE(i, expected_toi[i]);
+        if (std::isinf(expected_toi[i])) {
+            CHECK(std::isinf(toi[i]));
+        } else {
+            CHECK(
+                toi[i]
+                == Approx(expected_toi[i] * conservative_rescaling)
+                       .margin(1e-10));
+        }
+    }
+
+    // tmax cuts off later impacts.
+    inexact_point_triangle_ccd_batch(
+        P_t0, T0_t0, T1_t0, T2_t0, P_t1, T0_t1, T1_t1, T2_t1, toi,
+        conservative_rescaling, /*tmax=*/0.5);
+    for (int i = 0; i < n; i++) {
+        CAPTURE(i, expected_toi[i]);
+        if (expected_toi[i] > 0.5) {
+            CHECK(std::isinf(toi[i]));
+        } else {
+            CHECK(
+                toi[i]
+                == Approx(expected_toi[i] * conservative_rescaling)
+                       .margin(1e-10));
+        }
+    }
+}
+
+TEST_CASE("Batched inexact point-triangle CCD moving triangle", "[ccd][batch]")
+{
+    // Triangle rises to meet a falling point: relative approach speed 2,
+    // gap 1 ⟹ impact at t = 0.5.
+    Eigen::MatrixXd P_t0(1, 3), T0_t0(1, 3), T1_t0(1, 3), T2_t0(1, 3);
+    Eigen::MatrixXd P_t1(1, 3), T0_t1(1, 3), T1_t1(1, 3), T2_t1(1, 3);
+
+    T0_t0.row(0) = Eigen::RowVector3d(0, 0, 0);
+    T1_t0.row(0) = Eigen::RowVector3d(1, 0, 0);
+    T2_t0.row(0) = Eigen::RowVector3d(0, 1, 0);
+    P_t0.row(0) = Eigen::RowVector3d(0.25, 0.25, 1);
+
+    const Eigen::RowVector3d up(0, 0, 1);
+    T0_t1.row(0) = T0_t0.row(0) + up;
+    T1_t1.row(0) = T1_t0.row(0) + up;
+    T2_t1.row(0) = T2_t0.row(0) + up;
+    P_t1.row(0) = P_t0.row(0) - up;
+
+    Eigen::ArrayXd toi;
+    inexact_point_triangle_ccd_batch(
+        P_t0, T0_t0, T1_t0, T2_t0, P_t1, T0_t1, T1_t1, T2_t1, toi,
+        /*conservative_rescaling=*/1.0);
+
+    REQUIRE(toi.size() == 1);
+    CHECK(toi[0] == Approx(0.5).margin(1e-10));
+}
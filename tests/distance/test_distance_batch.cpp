@@ -0,0 +1,122 @@
+#include <catch2/catch.hpp>
+
+#include <ipc/distance/distance_batch.hpp>
+#include <ipc/distance/distance_type.hpp>
+#include <ipc/distance/edge_edge.hpp>
+#include <ipc/distance/point_triangle.hpp>
+#include <ipc/utils/positions_soa.hpp>
+
+using namespace ipc;
+
+TEST_CASE(
+    "Batched point-triangle classification matches the per-query classifier",
+    "[distance][point-triangle][batch]")
+{
+    const int num_candidates = 1000;
+
+    const Eigen::MatrixXd P = Eigen::MatrixXd::Random(num_candidates, 3);
+    const Eigen::MatrixXd T0 = Eigen::MatrixXd::Random(num_candidates, 3);
+    const Eigen::MatrixXd T1 = Eigen::MatrixXd::Random(num_candidates, 3);
+    const Eigen::MatrixXd T2 = Eigen::MatrixXd::Random(num_candidates, 3);
+
+    const std::vector<PointTriangleDistanceType> dtypes =
+        point_triangle_distance_types(P, T0, T1, T2);
+    REQUIRE(dtypes.size() == num_candidates);
+
+    for (int i = 0; i < num_candidates; i++) {
+        CHECK(
+            dtypes[i]
+            == point_triangle_distance_type(
+                P.row(i), T0.row(i), T1.row(i), T2.row(i)));
+    }
+}
+
+TEST_CASE(
+    "Batched point-triangle distances match the per-query distances",
+    "[distance][point-triangle][batch]")
+{
+    const int num_candidates = 100;
+
+    // Random candidates hit every distance type.
+    const Eigen::MatrixXd P = Eigen::MatrixXd::Random(num_candidates, 3);
+    const Eigen::MatrixXd T0 = Eigen::MatrixXd::Random(num_candidates, 3);
+    const Eigen::MatrixXd T1 = Eigen::MatrixXd::Random(num_candidates, 3);
+    const Eigen::MatrixXd T2 = Eigen::MatrixXd::Random(num_candidates, 3);
+
+    const Eigen::VectorXd distances =
+        point_triangle_distances(P, T0, T1, T2);
+    REQUIRE(distances.size() == num_candidates);
+
+    for (int i = 0; i < num_candidates; i++) {
+        CHECK(
+            distances[i]
+            == Approx(point_triangle_distance(
+                P.row(i), T0.row(i), T1.row(i), T2.row(i))));
+    }
+}
+
+TEST_CASE(
+    "Batched edge-edge distances match the per-query distances",
+    "[distance][edge-edge][batch]")
+{
+    const int num_candidates = 100;
+
+    const Eigen::MatrixXd EA0 = Eigen::MatrixXd::Random(num_candidates, 3);
+    const Eigen::MatrixXd EA1 = Eigen::MatrixXd::Random(num_candidates, 3);
+    const Eigen::MatrixXd EB0 = Eigen::MatrixXd::Random(num_candidates, 3);
+    const Eigen::MatrixXd EB1 = Eigen::MatrixXd::Random(num_candidates, 3);
+
+    const Eigen::VectorXd distances =
+        edge_edge_distances(EA0, EA1, EB0, EB1);
+    REQUIRE(distances.size() == num_candidates);
+
+    for (int i = 0; i < num_candidates; i++) {
+        CHECK(
+            distances[i]
+            == Approx(edge_edge_distance(
+                EA0.row(i), EA1.row(i), EB0.row(i), EB1.row(i))));
+    }
+}
+
+TEST_CASE(
+    "SoA position mirror feeds the batched kernels",
+    "[distance][batch][positions-soa]")
+{
+    const int num_vertices = 100;
+    const Eigen::MatrixXd V = Eigen::MatrixXd::Random(num_vertices, 3);
+
+    PositionsSoA positions;
+    positions.update(V);
+    REQUIRE(positions.num_vertices() == size_t(num_vertices));
+    REQUIRE(positions.dim() == 3);
+
+    // Gather four pseudo-random index streams and check the batch distances
+    // against per-query evaluation on the original matrix.
+    std::vector<index_t> p_ids, t0_ids, t1_ids, t2_ids;
+    for (int i = 0; i < num_vertices; i++) {
+        p_ids.push_back(i);
+        t0_ids.push_back((7 * i + 1) % num_vertices);
+        t1_ids.push_back((13 * i + 2) % num_vertices);
+        t2_ids.push_back((29 * i + 3) % num_vertices);
+    }
+
+    Eigen::MatrixXd P, T0, T1, T2;
+    positions.gather(p_ids, P);
+    positions.gather(t0_ids, T0);
+    positions.gather(t1_ids, T1);
+    positions.gather(t2_ids, T2);
+
+    for (int i = 0; i < num_vertices; i++) {
+        CHECK(P.row(i).isApprox(V.row(p_ids[i])));
+    }
+
+    const Eigen::VectorXd distances =
+        point_triangle_distances(P, T0, T1, T2);
+    for (int i = 0; i < num_vertices; i++) {
+        CHECK(
+            distances[i]
+            == Approx(point_triangle_distance(
+                V.row(p_ids[i]), V.row(t0_ids[i]), V.row(t1_ids[i]),
+                V.row(t2_ids[i]))));
+    }
+}
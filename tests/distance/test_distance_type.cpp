@@ -3,6 +3,7 @@
 #include <test_utils.hpp>
 
 #include <ipc/distance/distance_type.hpp>
+#include <ipc/distance/edge_edge.hpp>
 #include <ipc/distance/point_triangle.hpp>
 
 using namespace ipc;
@@ -377,6 +378,72 @@ TEST_CASE(
     }
 }
 
+TEST_CASE(
+    "Point-triangle distance type with hint",
+    "[distance][distance-type][point-triangle]")
+{
+    const int n_random_queries = 1000;
+
+    for (int i = 0; i < n_random_queries; i++) {
+        const Eigen::Vector3d p = Eigen::Vector3d::Random();
+        const Eigen::Vector3d t0 = Eigen::Vector3d::Random();
+        const Eigen::Vector3d t1 = Eigen::Vector3d::Random();
+        const Eigen::Vector3d t2 = Eigen::Vector3d::Random();
+
+        const PointTriangleDistanceType dtype =
+            point_triangle_distance_type(p, t0, t1, t2);
+        const double distance = point_triangle_distance(p, t0, t1, t2, dtype);
+
+        // A correct hint must verify and be returned unchanged.
+        CHECK(point_triangle_distance_type(p, t0, t1, t2, dtype) == dtype);
+
+        // Any hint must produce a region with the same closest distance
+        // (regions may legitimately differ on their shared boundaries).
+        for (int hint_i = 0; hint_i < 7; hint_i++) {
+            const auto hint = static_cast<PointTriangleDistanceType>(hint_i);
+            const PointTriangleDistanceType hinted_dtype =
+                point_triangle_distance_type(p, t0, t1, t2, hint);
+            CAPTURE(i, hint_i, dtype, hinted_dtype);
+            CHECK(
+                point_triangle_distance(p, t0, t1, t2, hinted_dtype)
+                == Approx(distance));
+        }
+    }
+}
+
+TEST_CASE(
+    "Edge-edge distance type with hint",
+    "[distance][distance-type][edge-edge]")
+{
+    const int n_random_queries = 1000;
+
+    for (int i = 0; i < n_random_queries; i++) {
+        const Eigen::Vector3d ea0 = Eigen::Vector3d::Random();
+        const Eigen::Vector3d ea1 = Eigen::Vector3d::Random();
+        const Eigen::Vector3d eb0 = Eigen::Vector3d::Random();
+        const Eigen::Vector3d eb1 = Eigen::Vector3d::Random();
+
+        const EdgeEdgeDistanceType dtype =
+            edge_edge_distance_type(ea0, ea1, eb0, eb1);
+        const double distance = edge_edge_distance(ea0, ea1, eb0, eb1, dtype);
+
+        // A correct hint must verify and be returned unchanged.
+        CHECK(edge_edge_distance_type(ea0, ea1, eb0, eb1, dtype) == dtype);
+
+        // Any hint must produce a region with the same closest distance
+        // (regions may legitimately differ on their shared boundaries).
+        for (int hint_i = 0; hint_i < 9; hint_i++) {
+            const auto hint = static_cast<EdgeEdgeDistanceType>(hint_i);
+            const EdgeEdgeDistanceType hinted_dtype =
+                edge_edge_distance_type(ea0, ea1, eb0, eb1, hint);
+            CAPTURE(i, hint_i, dtype, hinted_dtype);
+            CHECK(
+                edge_edge_distance(ea0, ea1, eb0, eb1, hinted_dtype)
+                == Approx(distance));
+        }
+    }
+}
+
 TEST_CASE(
     "Edge-edge parallel distance type",
     "[distance][distance-type][edge-edge][parallel]")
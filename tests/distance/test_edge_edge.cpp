@@ -295,3 +295,38 @@ TEST_CASE(
     CHECK(fd::compare_gradient(grad, fgrad));
     // CHECK(distance.getHessian().squaredNorm() != Approx(0.0));
 }
+
+TEST_CASE(
+    "Edge-edge distance threshold test", "[distance][edge-edge][is-within]")
+{
+    const double threshold_sqr = GENERATE(1e-4, 1e-2, 1.0, 1e2);
+
+    for (int i = 0; i < 100; i++) {
+        const Eigen::Vector3d ea0 = Eigen::Vector3d::Random();
+        const Eigen::Vector3d ea1 = Eigen::Vector3d::Random();
+        const Eigen::Vector3d eb0 = Eigen::Vector3d::Random();
+        const Eigen::Vector3d eb1 = Eigen::Vector3d::Random();
+
+        CHECK(
+            edge_edge_distance_is_within(ea0, ea1, eb0, eb1, threshold_sqr)
+            == (edge_edge_distance(ea0, ea1, eb0, eb1) < threshold_sqr));
+    }
+}
+
+TEST_CASE(
+    "Edge-edge distance in single precision", "[distance][edge-edge][float]")
+{
+    for (int i = 0; i < 100; i++) {
+        const Eigen::Vector3f ea0 = Eigen::Vector3f::Random();
+        const Eigen::Vector3f ea1 = Eigen::Vector3f::Random();
+        const Eigen::Vector3f eb0 = Eigen::Vector3f::Random();
+        const Eigen::Vector3f eb1 = Eigen::Vector3f::Random();
+
+        const float distance = edge_edge_distance(ea0, ea1, eb0, eb1);
+        const double expected_distance = edge_edge_distance(
+            ea0.cast<double>().eval(), ea1.cast<double>().eval(),
+            eb0.cast<double>().eval(), eb1.cast<double>().eval());
+
+        CHECK(distance == Approx(expected_distance).margin(1e-6));
+    }
+}
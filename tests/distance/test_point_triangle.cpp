@@ -263,3 +263,40 @@ TEST_CASE("Point-triangle distance hessian", "[distance][point-triangle][hess]")
     CAPTURE(dtype);
     CHECK(fd::compare_hessian(hess, fhess, 1e-2));
 }
+
+TEST_CASE(
+    "Point-triangle distance threshold test",
+    "[distance][point-triangle][is-within]")
+{
+    const double threshold_sqr = GENERATE(1e-4, 1e-2, 1.0, 1e2);
+
+    for (int i = 0; i < 100; i++) {
+        const Eigen::Vector3d p = Eigen::Vector3d::Random();
+        const Eigen::Vector3d t0 = Eigen::Vector3d::Random();
+        const Eigen::Vector3d t1 = Eigen::Vector3d::Random();
+        const Eigen::Vector3d t2 = Eigen::Vector3d::Random();
+
+        CHECK(
+            point_triangle_distance_is_within(p, t0, t1, t2, threshold_sqr)
+            == (point_triangle_distance(p, t0, t1, t2) < threshold_sqr));
+    }
+}
+
+TEST_CASE(
+    "Point-triangle distance in single precision",
+    "[distance][point-triangle][float]")
+{
+    for (int i = 0; i < 100; i++) {
+        const Eigen::Vector3f p = Eigen::Vector3f::Random();
+        const Eigen::Vector3f t0 = Eigen::Vector3f::Random();
+        const Eigen::Vector3f t1 = Eigen::Vector3f::Random();
+        const Eigen::Vector3f t2 = Eigen::Vector3f::Random();
+
+        const float distance = point_triangle_distance(p, t0, t1, t2);
+        const double expected_distance = point_triangle_distance(
+            p.cast<double>().eval(), t0.cast<double>().eval(),
+            t1.cast<double>().eval(), t2.cast<double>().eval());
+
+        CHECK(distance == Approx(expected_distance).margin(1e-6));
+    }
+}
@@ -325,3 +325,50 @@ TEST_CASE(
     check_friction_force_jacobian(
         mesh, Ut, U, constraints, mu, epsv_dt, dhat, kappa, true);
 }
+
+TEST_CASE(
+    "Cached friction force jacobian matches the uncached jacobian",
+    "[friction][force-jacobian][cache]")
+{
+    FrictionData data = friction_data_generator();
+    const auto& [V0, V1, E, F, constraints, mu, epsv_times_h, dhat, barrier_stiffness] =
+        data;
+
+    const Eigen::MatrixXd& X = V0;
+    const Eigen::MatrixXd Ut = Eigen::MatrixXd::Zero(V0.rows(), V0.cols());
+    const Eigen::MatrixXd U = V1 - V0;
+
+    CollisionMesh mesh(X, E, F);
+
+    FrictionConstraints friction_constraints;
+    construct_friction_constraint_set(
+        mesh, X + Ut, constraints, dhat, barrier_stiffness, mu,
+        friction_constraints);
+
+    HessianAssemblyCache cache;
+    for (const FrictionConstraint::DiffWRT wrt :
+         { FrictionConstraint::DiffWRT::X, FrictionConstraint::DiffWRT::Ut,
+           FrictionConstraint::DiffWRT::U }) {
+        if (wrt == FrictionConstraint::DiffWRT::X
+            && !constraints.compute_shape_derivatives) {
+            continue;
+        }
+
+        const Eigen::SparseMatrix<double> expected_jacobian =
+            compute_friction_force_jacobian(
+                mesh, X, Ut, U, friction_constraints, dhat, barrier_stiffness,
+                epsv_times_h, wrt);
+
+        // Evaluate twice: the first call builds the cached sparsity pattern
+        // and the second reuses it.
+        for (int trial = 0; trial < 2; trial++) {
+            const Eigen::SparseMatrix<double> jacobian =
+                compute_friction_force_jacobian(
+                    mesh, X, Ut, U, friction_constraints, dhat,
+                    barrier_stiffness, epsv_times_h, wrt, cache);
+            CHECK(
+                (jacobian - expected_jacobian).norm()
+                == Approx(0).margin(1e-12));
+        }
+    }
+}
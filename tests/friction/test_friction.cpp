@@ -9,8 +9,11 @@
 #include <ipc/ipc.hpp>
 #include <ipc/friction/friction.hpp>
 #include <ipc/utils/logger.hpp>
+#include <ipc/utils/serialization.hpp>
 #include <ipc/config.hpp>
 
+#include <sstream>
+
 #include "friction_data_generator.hpp"
 #include "../test_utils.hpp"
 
@@ -51,6 +54,182 @@ TEST_CASE("Test friction gradient and hessian", "[friction][gradient][hessian]")
     CHECK(fd::compare_hessian(hess, fhess, 1e-3));
 }
 
+TEST_CASE("Lazy friction constraint set update", "[friction][update]")
+{
+    FrictionData data = friction_data_generator();
+    const auto& [V0, V1, E, F, contact_constraint_set, mu, epsv_times_h, dhat, barrier_stiffness] =
+        data;
+
+    CollisionMesh mesh(V0, E, F);
+
+    FrictionConstraints friction_constraint_set;
+    construct_friction_constraint_set(
+        mesh, V0, contact_constraint_set, dhat, barrier_stiffness, mu,
+        friction_constraint_set);
+
+    // Unmoved vertices: the update must succeed and leave the set identical
+    // to a fresh build.
+    REQUIRE(update_friction_constraint_set(
+        mesh, V0, contact_constraint_set, dhat, barrier_stiffness,
+        friction_constraint_set, /*rebuild_tolerance=*/1e-4));
+
+    FrictionConstraints rebuilt_set;
+    construct_friction_constraint_set(
+        mesh, V0, contact_constraint_set, dhat, barrier_stiffness, mu,
+        rebuilt_set);
+    REQUIRE(friction_constraint_set.size() == rebuilt_set.size());
+    for (size_t i = 0; i < rebuilt_set.size(); i++) {
+        CHECK(
+            friction_constraint_set[i].normal_force_magnitude
+            == Approx(rebuilt_set[i].normal_force_magnitude));
+        CHECK(friction_constraint_set[i].tangent_basis.isApprox(
+            rebuilt_set[i].tangent_basis));
+    }
+
+    // Vertices moved beyond the tolerance: the caller has to rebuild.
+    Eigen::MatrixXd V_moved = V0;
+    V_moved(0, 0) += 1.0;
+    CHECK(!update_friction_constraint_set(
+        mesh, V_moved, contact_constraint_set, dhat, barrier_stiffness,
+        friction_constraint_set, /*rebuild_tolerance=*/1e-4));
+
+    // A never-built set cannot be updated in place.
+    FrictionConstraints empty_set;
+    CHECK(!update_friction_constraint_set(
+        mesh, V0, contact_constraint_set, dhat, barrier_stiffness, empty_set,
+        /*rebuild_tolerance=*/1e-4));
+}
+
+TEST_CASE(
+    "Fused friction gradient and hessian", "[friction][gradient][hessian]")
+{
+    FrictionData data = friction_data_generator();
+    const auto& [V0, V1, E, F, contact_constraint_set, mu, epsv_times_h, dhat, barrier_stiffness] =
+        data;
+
+    CollisionMesh mesh(V0, E, F);
+
+    FrictionConstraints friction_constraint_set;
+    construct_friction_constraint_set(
+        mesh, V0, contact_constraint_set, dhat, barrier_stiffness, mu,
+        friction_constraint_set);
+
+    Eigen::VectorXd grad;
+    Eigen::SparseMatrix<double> hess;
+    compute_friction_potential_gradient_and_hessian(
+        mesh, V0, V1, friction_constraint_set, epsv_times_h, grad, hess);
+
+    CHECK(grad.isApprox(compute_friction_potential_gradient(
+        mesh, V0, V1, friction_constraint_set, epsv_times_h)));
+    CHECK(Eigen::MatrixXd(hess).isApprox(
+        Eigen::MatrixXd(compute_friction_potential_hessian(
+            mesh, V0, V1, friction_constraint_set, epsv_times_h))));
+}
+
+TEST_CASE("Cached friction hessian assembly", "[friction][hessian]")
+{
+    FrictionData data = friction_data_generator();
+    const auto& [V0, V1, E, F, contact_constraint_set, mu, epsv_times_h, dhat, barrier_stiffness] =
+        data;
+
+    CollisionMesh mesh(V0, E, F);
+
+    FrictionConstraints friction_constraint_set;
+    construct_friction_constraint_set(
+        mesh, V0, contact_constraint_set, dhat, barrier_stiffness, mu,
+        friction_constraint_set);
+
+    HessianAssemblyCache cache;
+
+    Eigen::MatrixXd hess = compute_friction_potential_hessian(
+        mesh, V0, V1, friction_constraint_set, epsv_times_h, cache);
+    Eigen::MatrixXd expected_hess = compute_friction_potential_hessian(
+        mesh, V0, V1, friction_constraint_set, epsv_times_h);
+    CHECK(hess.isApprox(expected_hess));
+
+    // A second assembly reuses the cached pattern; perturb the displacements
+    // to make sure the values are recomputed.
+    Eigen::MatrixXd V1_moved =
+        V1 + 1e-4 * epsv_times_h * Eigen::MatrixXd::Random(V1.rows(), V1.cols());
+
+    hess = compute_friction_potential_hessian(
+        mesh, V0, V1_moved, friction_constraint_set, epsv_times_h, cache);
+    expected_hess = compute_friction_potential_hessian(
+        mesh, V0, V1_moved, friction_constraint_set, epsv_times_h);
+    CHECK(hess.isApprox(expected_hess));
+}
+
+TEST_CASE(
+    "Batched friction potential matches the per-constraint potential",
+    "[friction][soa]")
+{
+    FrictionData data = friction_data_generator();
+    const auto& [V0, V1, E, F, contact_constraint_set, mu, epsv_times_h, dhat, barrier_stiffness] =
+        data;
+
+    CollisionMesh mesh(V0, E, F);
+
+    FrictionConstraints friction_constraint_set;
+    construct_friction_constraint_set(
+        mesh, V0, contact_constraint_set, dhat, barrier_stiffness, mu,
+        friction_constraint_set);
+
+    const FrictionConstraintsSoA soa(friction_constraint_set);
+    REQUIRE(soa.coeffs.size() == long(friction_constraint_set.size()));
+
+    CHECK(
+        compute_friction_potential(
+            mesh, V0, V1, friction_constraint_set, soa, epsv_times_h)
+        == Approx(compute_friction_potential(
+            mesh, V0, V1, friction_constraint_set, epsv_times_h)));
+}
+
+TEST_CASE(
+    "Friction constraint set serialization round-trip",
+    "[friction][serialization]")
+{
+    FrictionData data = friction_data_generator();
+    const auto& [V0, V1, E, F, contact_constraint_set, mu, epsv_times_h, dhat, barrier_stiffness] =
+        data;
+
+    CollisionMesh mesh(V0, E, F);
+
+    FrictionConstraints friction_constraint_set;
+    construct_friction_constraint_set(
+        mesh, V0, contact_constraint_set, dhat, barrier_stiffness, mu,
+        friction_constraint_set);
+
+    std::stringstream stream(
+        std::ios_base::in | std::ios_base::out | std::ios_base::binary);
+    save_friction_constraints(stream, friction_constraint_set);
+
+    FrictionConstraints loaded_set;
+    load_friction_constraints(stream, loaded_set);
+
+    REQUIRE(loaded_set.size() == friction_constraint_set.size());
+    for (size_t i = 0; i < friction_constraint_set.size(); i++) {
+        CHECK(
+            loaded_set[i].normal_force_magnitude
+            == friction_constraint_set[i].normal_force_magnitude);
+        CHECK(loaded_set[i].mu == friction_constraint_set[i].mu);
+        CHECK(loaded_set[i].closest_point.isApprox(
+            friction_constraint_set[i].closest_point));
+        CHECK(loaded_set[i].tangent_basis.isApprox(
+            friction_constraint_set[i].tangent_basis));
+    }
+
+    // The loaded set must evaluate identically to the original.
+    CHECK(
+        compute_friction_potential(
+            mesh, V0, V1, loaded_set, epsv_times_h)
+        == Approx(compute_friction_potential(
+            mesh, V0, V1, friction_constraint_set, epsv_times_h)));
+    CHECK(compute_friction_potential_gradient(
+              mesh, V0, V1, loaded_set, epsv_times_h)
+              .isApprox(compute_friction_potential_gradient(
+                  mesh, V0, V1, friction_constraint_set, epsv_times_h)));
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 void mmcvids_to_friction_constraints(
@@ -155,6 +155,36 @@ TEST_CASE(
     CHECK(fd::compare_gradient(grad, fgrad));
 }
 
+TEST_CASE(
+    "Batched normal force magnitude matches the scalar version",
+    "[friction][normal_force_magnitude]")
+{
+    const double dhat = 1e-3, barrier_stiffness = 1e2;
+    const double dmin = GENERATE(0.0, 1e-4);
+
+    Eigen::ArrayXd distances_squared(5);
+    distances_squared << 1e-8, 1e-6, 2.5e-7, 9e-7, 4e-8;
+    distances_squared += dmin * dmin;
+
+    const Eigen::ArrayXd magnitudes = compute_normal_force_magnitude(
+        distances_squared, dhat, barrier_stiffness, dmin);
+    const Eigen::ArrayXd coeffs =
+        compute_normal_force_magnitude_gradient_coeffs(
+            distances_squared, dhat, barrier_stiffness, dmin);
+
+    for (int i = 0; i < distances_squared.size(); i++) {
+        CAPTURE(dmin, i);
+        CHECK(
+            magnitudes[i]
+            == Approx(compute_normal_force_magnitude(
+                distances_squared[i], dhat, barrier_stiffness, dmin)));
+        const VectorMax12d grad = compute_normal_force_magnitude_gradient(
+            distances_squared[i], Eigen::VectorXd::Ones(1), dhat,
+            barrier_stiffness, dmin);
+        CHECK(coeffs[i] == Approx(grad[0]));
+    }
+}
+
 TEST_CASE(
     "Point-point normal force magnitude (2D)",
     "[friction][point-triangle][normal_force_magnitude][2D]")
@@ -57,4 +57,28 @@ TEST_CASE("Smooth friction gradient", "[friction][mollifier]")
     double f2 = ipc::df1_x_minus_f1_over_x3(x, epsv_times_h);
 
     CHECK(f2 * x == Approx(fd_f2[0]).margin(MARGIN).epsilon(EPSILON));
-}
\ No newline at end of file
+}
+TEST_CASE(
+    "Batched smooth friction mollifier matches the scalar mollifier",
+    "[friction][mollifier]")
+{
+    const double epsv_times_h = std::pow(10, GENERATE(range(-8, 0, 1)));
+
+    Eigen::ArrayXd x(5);
+    x << 1e-3 * epsv_times_h, 0.5 * epsv_times_h, epsv_times_h,
+        2 * epsv_times_h, 1.0;
+
+    const Eigen::ArrayXd f0 = ipc::f0_SF(x, epsv_times_h);
+    const Eigen::ArrayXd f1_over_x = ipc::f1_SF_over_x(x, epsv_times_h);
+    const Eigen::ArrayXd f2 = ipc::df1_x_minus_f1_over_x3(x, epsv_times_h);
+
+    for (long i = 0; i < x.size(); i++) {
+        CAPTURE(x[i], epsv_times_h);
+        CHECK(f0[i] == Approx(ipc::f0_SF(x[i], epsv_times_h)));
+        CHECK(
+            f1_over_x[i] == Approx(ipc::f1_SF_over_x(x[i], epsv_times_h)));
+        CHECK(
+            f2[i]
+            == Approx(ipc::df1_x_minus_f1_over_x3(x[i], epsv_times_h)));
+    }
+}
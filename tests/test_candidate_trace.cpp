@@ -0,0 +1,123 @@
+#include <catch2/catch.hpp>
+
+#include <cstdlib> // std::getenv
+#include <filesystem>
+#include <string>
+
+#include <ipc/ipc.hpp>
+#include <ipc/utils/candidate_trace.hpp>
+
+#include "test_utils.hpp"
+
+using namespace ipc;
+
+namespace {
+
+/// Replay every step of a trace through Constraints::build and
+/// compute_collision_free_stepsize (the paths the trace was recorded to
+/// profile offline).
+void replay_candidate_trace(const std::string& filename)
+{
+    CandidateTraceReader reader(filename);
+    CollisionMesh mesh(
+        reader.vertices_at_rest(), reader.edges(), reader.faces());
+
+    Eigen::MatrixXd V0, V1;
+    double dhat;
+    Candidates candidates;
+    while (reader.read_step(V0, V1, dhat, candidates)) {
+        Constraints constraint_set;
+        constraint_set.build(candidates, mesh, V0, dhat);
+        compute_collision_free_stepsize(candidates, mesh, V0, V1);
+    }
+}
+
+} // namespace
+
+TEST_CASE("Candidate trace round trip", "[ipc][trace]")
+{
+    Eigen::MatrixXd V;
+    Eigen::MatrixXi E, F;
+    bool success = load_mesh("bunny.obj", V, E, F);
+    REQUIRE(success);
+
+    CollisionMesh mesh(V, E, F);
+
+    const double dhat = 1e-2;
+
+    // Two steps with distinct endpoints and candidate sets.
+    const Eigen::MatrixXd V0 = V;
+    Eigen::MatrixXd V1 = V;
+    V1.col(1).array() -= 1e-3;
+    Eigen::MatrixXd V2 = V1;
+    V2.col(0).array() += 1e-3;
+
+    Candidates step0, step1;
+    construct_collision_candidates(mesh, V0, V1, step0, dhat / 2);
+    construct_collision_candidates(mesh, V1, V2, step1, dhat / 2);
+    REQUIRE(!step0.empty());
+
+    const std::string filename =
+        (std::filesystem::temp_directory_path() / "ipc_trace_test.bin")
+            .string();
+    {
+        CandidateTraceWriter writer(filename, mesh);
+        writer.write_step(V0, V1, dhat, step0);
+        writer.write_step(V1, V2, 2 * dhat, step1);
+    }
+
+    CandidateTraceReader reader(filename);
+    CHECK(reader.vertices_at_rest() == mesh.vertices_at_rest());
+    CHECK(reader.edges() == mesh.edges());
+    CHECK(reader.faces() == mesh.faces());
+
+    Eigen::MatrixXd V0_loaded, V1_loaded;
+    double dhat_loaded;
+    Candidates loaded;
+
+    REQUIRE(reader.read_step(V0_loaded, V1_loaded, dhat_loaded, loaded));
+    CHECK(V0_loaded == V0);
+    CHECK(V1_loaded == V1);
+    CHECK(dhat_loaded == dhat);
+    REQUIRE(loaded.size() == step0.size());
+    CHECK(loaded.ev_candidates == step0.ev_candidates);
+    CHECK(loaded.ee_candidates == step0.ee_candidates);
+    CHECK(loaded.fv_candidates == step0.fv_candidates);
+
+    // The loaded stream must replay identically to the recorded inputs.
+    Constraints expected_set, loaded_set;
+    expected_set.build(step0, mesh, V0, dhat);
+    loaded_set.build(loaded, mesh, V0_loaded, dhat_loaded);
+    REQUIRE(loaded_set.size() == expected_set.size());
+    CHECK(
+        compute_collision_free_stepsize(loaded, mesh, V0_loaded, V1_loaded)
+        == compute_collision_free_stepsize(step0, mesh, V0, V1));
+
+    REQUIRE(reader.read_step(V0_loaded, V1_loaded, dhat_loaded, loaded));
+    CHECK(V0_loaded == V1);
+    CHECK(V1_loaded == V2);
+    CHECK(dhat_loaded == 2 * dhat);
+    CHECK(loaded.size() == step1.size());
+
+    CHECK(!reader.read_step(V0_loaded, V1_loaded, dhat_loaded, loaded));
+
+    // A file without a trace must be rejected.
+    CHECK_THROWS(CandidateTraceReader(TEST_DATA_DIR + "cube.obj"));
+
+    std::filesystem::remove(filename);
+}
+
+// Offline profiling entry point: replays a production trace through the
+// recorded pipeline, e.g.
+//
+//   IPC_TOOLKIT_TRACE=/path/to/trace.bin \
+//     ipc_toolkit_tests "Candidate trace replay" [!benchmark]
+TEST_CASE("Candidate trace replay", "[!benchmark][ipc][trace]")
+{
+    const char* filename = std::getenv("IPC_TOOLKIT_TRACE");
+    if (filename == nullptr) {
+        return; // No trace to replay.
+    }
+
+    BENCHMARK("Replay trace") { replay_candidate_trace(filename); };
+}
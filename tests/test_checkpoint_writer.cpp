@@ -0,0 +1,109 @@
+#include <catch2/catch.hpp>
+
+#include <ipc/ipc.hpp>
+#include <ipc/friction/friction.hpp>
+#include <ipc/utils/checkpoint_writer.hpp>
+#include <ipc/utils/serialization.hpp>
+
+#include "test_utils.hpp"
+
+#include <cstdio> // std::remove
+#include <fstream>
+#include <sstream>
+
+using namespace ipc;
+
+TEST_CASE("Checkpoint round trip", "[utils][checkpoint]")
+{
+    Eigen::MatrixXd V;
+    Eigen::MatrixXi E, F;
+    REQUIRE(load_mesh("two-cubes-close.obj", V, E, F));
+
+    const CollisionMesh mesh(V, E, F);
+    const double dhat = 1e-1;
+
+    Constraints constraint_set;
+    constraint_set.build(mesh, V, dhat);
+    REQUIRE(constraint_set.size() > 0);
+
+    FrictionConstraints friction_constraint_set;
+    construct_friction_constraint_set(
+        mesh, V, constraint_set, dhat, /*barrier_stiffness=*/1e3,
+        Eigen::VectorXd::Constant(mesh.num_vertices(), 0.5),
+        friction_constraint_set);
+
+    std::stringstream stream(
+        std::ios_base::in | std::ios_base::out | std::ios_base::binary);
+    save_checkpoint(stream, V, constraint_set, friction_constraint_set);
+
+    Eigen::MatrixXd loaded_V;
+    Constraints loaded_set;
+    FrictionConstraints loaded_friction_set;
+    load_checkpoint(stream, loaded_V, loaded_set, loaded_friction_set);
+
+    CHECK(loaded_V == V);
+    REQUIRE(loaded_set.size() == constraint_set.size());
+    REQUIRE(loaded_friction_set.size() == friction_constraint_set.size());
+    CHECK(
+        ipc::compute_barrier_potential(mesh, V, loaded_set, dhat)
+        == Approx(
+            ipc::compute_barrier_potential(mesh, V, constraint_set, dhat)));
+
+    // A stream without a checkpoint must be rejected.
+    std::stringstream garbage("not a checkpoint");
+    CHECK_THROWS(
+        load_checkpoint(garbage, loaded_V, loaded_set, loaded_friction_set));
+}
+
+TEST_CASE("Background checkpoint writer", "[utils][checkpoint]")
+{
+    Eigen::MatrixXd V;
+    Eigen::MatrixXi E, F;
+    REQUIRE(load_mesh("two-cubes-close.obj", V, E, F));
+
+    const CollisionMesh mesh(V, E, F);
+    const double dhat = 1e-1;
+
+    const std::string filename = "checkpoint_writer_test.bin";
+
+    Constraints constraint_set;
+    Eigen::MatrixXd V_last;
+    {
+        CheckpointWriter writer;
+
+        // Step and checkpoint every step; only the flushed state below is
+        // guaranteed on disk (earlier snapshots may be replaced).
+        for (int step = 0; step < 4; step++) {
+            V_last = V;
+            V_last.col(0).array() += 1e-3 * step;
+            constraint_set.build(mesh, V_last, dhat);
+            REQUIRE(constraint_set.size() > 0);
+            writer.submit(filename, V_last, constraint_set);
+        }
+
+        writer.flush();
+        CHECK(writer.num_written() + writer.num_dropped() == 4);
+        CHECK(writer.num_written() >= 1);
+    } // The destructor joins the worker.
+
+    // The file holds the last submitted snapshot (nothing was submitted
+    // after the flush).
+    std::ifstream in(filename, std::ios::binary);
+    REQUIRE(in.is_open());
+    Eigen::MatrixXd loaded_V;
+    Constraints loaded_set;
+    FrictionConstraints loaded_friction_set;
+    load_checkpoint(in, loaded_V, loaded_set, loaded_friction_set);
+
+    CHECK(loaded_V == V_last);
+    CHECK(loaded_set.size() == constraint_set.size());
+    CHECK(loaded_friction_set.empty());
+
+    // A write failure surfaces on the next flush, not in submit.
+    CheckpointWriter failing_writer;
+    failing_writer.submit(
+        "nonexistent-directory/checkpoint.bin", V, constraint_set);
+    CHECK_THROWS(failing_writer.flush());
+
+    std::remove(filename.c_str());
+}
@@ -0,0 +1,99 @@
+#include <catch2/catch.hpp>
+
+#include <ipc/ipc.hpp>
+#include <ipc/scene.hpp>
+#include <ipc/utils/execution_context.hpp>
+
+#include "test_utils.hpp"
+
+#include <thread>
+#include <vector>
+
+using namespace ipc;
+
+TEST_CASE("Concurrent scenes", "[ipc][scene][threads]")
+{
+    Eigen::MatrixXd V;
+    Eigen::MatrixXi E, F;
+    REQUIRE(load_mesh("two-cubes-close.obj", V, E, F));
+
+    const CollisionMesh mesh(V, E, F);
+    const double dhat = 1e-1;
+    const int num_workers = 4;
+    const int num_steps = 4;
+
+    // Warm up the exact predicates serially before spawning workers.
+    REQUIRE(!has_intersections(mesh, V));
+
+    // Each worker steps its own scene; the per-worker translation makes the
+    // scenes distinct, so cross-scene state leakage would show up as a
+    // mismatch against the serial reference below. Catch assertions are not
+    // thread-safe, so the workers only record results.
+    struct WorkerResults {
+        std::vector<double> potentials;
+        std::vector<Eigen::VectorXd> gradients;
+        std::vector<double> step_sizes;
+    };
+    std::vector<WorkerResults> results(num_workers);
+
+    std::vector<std::thread> workers;
+    for (int w = 0; w < num_workers; w++) {
+        workers.emplace_back([&, w]() {
+            // Half the workers isolate their scene in a dedicated arena.
+            ExecutionContext context;
+            std::unique_ptr<ScopedExecutionContext> scope;
+            if (w % 2 == 0) {
+                context.set_max_concurrency(2);
+                scope = std::make_unique<ScopedExecutionContext>(context);
+            }
+
+            Scene scene(mesh, dhat);
+            for (int step = 0; step < num_steps; step++) {
+                Eigen::MatrixXd V_step = V;
+                V_step.col(0).array() += 1e-3 * (w + num_workers * step);
+
+                scene.build_constraints(V_step);
+                results[w].potentials.push_back(
+                    scene.compute_barrier_potential(V_step));
+                results[w].gradients.push_back(
+                    scene.compute_barrier_potential_gradient(V_step));
+
+                Eigen::MatrixXd V_target = V_step;
+                V_target.col(0).array() += 2.0;
+                results[w].step_sizes.push_back(
+                    scene.compute_collision_free_stepsize(V_step, V_target));
+            }
+        });
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+
+    // Serial reference for every (worker, step) position.
+    for (int w = 0; w < num_workers; w++) {
+        for (int step = 0; step < num_steps; step++) {
+            CAPTURE(w, step);
+            Eigen::MatrixXd V_step = V;
+            V_step.col(0).array() += 1e-3 * (w + num_workers * step);
+
+            Constraints expected_set;
+            expected_set.build(mesh, V_step, dhat);
+            REQUIRE(expected_set.size() > 0);
+
+            CHECK(
+                results[w].potentials[step]
+                == Approx(ipc::compute_barrier_potential(
+                    mesh, V_step, expected_set, dhat)));
+            CHECK(results[w].gradients[step].isApprox(
+                ipc::compute_barrier_potential_gradient(
+                    mesh, V_step, expected_set, dhat)));
+
+            Eigen::MatrixXd V_target = V_step;
+            V_target.col(0).array() += 2.0;
+            CHECK(
+                results[w].step_sizes[step]
+                == Approx(ipc::compute_collision_free_stepsize(
+                    mesh, V_step, V_target)));
+        }
+    }
+}
@@ -15,6 +15,8 @@
 
 #include <Eigen/Geometry>
 
+#include <array>
+
 using namespace ipc;
 
 Eigen::MatrixXi remove_faces_with_degenerate_edges(
@@ -177,6 +179,104 @@ bool combine_meshes(
 //     CAPTURE(mesh1_name, mesh2_name, R1, R2);
 // }
 
+TEST_CASE("Edge-triangle intersection predicate", "[intersection]")
+{
+    const Eigen::Vector3d t0(0, 0, 0), t1(1, 0, 0), t2(0, 1, 0);
+
+    // Proper crossing through the interior
+    CHECK(is_edge_intersecting_triangle(
+        Eigen::Vector3d(0.25, 0.25, -1), Eigen::Vector3d(0.25, 0.25, 1), //
+        t0, t1, t2));
+
+    // Crosses the supporting plane outside the triangle
+    CHECK(!is_edge_intersecting_triangle(
+        Eigen::Vector3d(2, 2, -1), Eigen::Vector3d(2, 2, 1), t0, t1, t2));
+
+    // Entirely on one side of the supporting plane
+    CHECK(!is_edge_intersecting_triangle(
+        Eigen::Vector3d(0.25, 0.25, 0.5), Eigen::Vector3d(0.25, 0.25, 1), //
+        t0, t1, t2));
+
+    // Touches the triangle exactly at a vertex
+    CHECK(is_edge_intersecting_triangle(
+        Eigen::Vector3d(0, 0, -1), Eigen::Vector3d(0, 0, 1), t0, t1, t2));
+
+    // Passes exactly through an edge of the triangle
+    CHECK(is_edge_intersecting_triangle(
+        Eigen::Vector3d(0.5, 0, -1), Eigen::Vector3d(0.5, 0, 1), t0, t1, t2));
+
+    // Endpoint exactly on the triangle
+    CHECK(is_edge_intersecting_triangle(
+        Eigen::Vector3d(0.25, 0.25, 0), Eigen::Vector3d(0.25, 0.25, 1), //
+        t0, t1, t2));
+}
+
+TEST_CASE("Batched edge-triangle intersection", "[intersection]")
+{
+    // Mix of clear verdicts (decided by the filtered batch arithmetic) and
+    // exactly degenerate contacts (deferred to the exact predicate); the
+    // batch must agree with the scalar predicate on every row.
+    std::vector<std::array<Eigen::Vector3d, 5>> tests;
+    const Eigen::Vector3d t0(0, 0, 0), t1(1, 0, 0), t2(0, 1, 0);
+    tests.push_back({ Eigen::Vector3d(0.25, 0.25, -1),
+                      Eigen::Vector3d(0.25, 0.25, 1), t0, t1, t2 });
+    tests.push_back(
+        { Eigen::Vector3d(2, 2, -1), Eigen::Vector3d(2, 2, 1), t0, t1, t2 });
+    tests.push_back({ Eigen::Vector3d(0.25, 0.25, 0.5),
+                      Eigen::Vector3d(0.25, 0.25, 1), t0, t1, t2 });
+    tests.push_back(
+        { Eigen::Vector3d(0, 0, -1), Eigen::Vector3d(0, 0, 1), t0, t1, t2 });
+    tests.push_back({ Eigen::Vector3d(0.25, 0.25, 0),
+                      Eigen::Vector3d(0.25, 0.25, 1), t0, t1, t2 });
+    tests.push_back({ Eigen::Vector3d(-1, 0.25, 0), Eigen::Vector3d(2, 0.25, 0),
+                      t0, t1, t2 }); // coplanar
+    // Random segments against random triangles
+    for (int i = 0; i < 1000; i++) {
+        tests.push_back({ Eigen::Vector3d::Random(), Eigen::Vector3d::Random(),
+                          Eigen::Vector3d::Random(), Eigen::Vector3d::Random(),
+                          Eigen::Vector3d::Random() });
+    }
+    // Near-coplanar segments barely above or below a random triangle
+    for (int i = 0; i < 1000; i++) {
+        std::array<Eigen::Vector3d, 5> test = {
+            Eigen::Vector3d::Random(), Eigen::Vector3d::Random(),
+            Eigen::Vector3d::Random(), Eigen::Vector3d::Random(),
+            Eigen::Vector3d::Random()
+        };
+        const Eigen::Vector3d n =
+            (test[3] - test[2]).cross(test[4] - test[2]).normalized();
+        for (int j = 0; j < 2; j++) {
+            test[j] -= n.dot(test[j] - test[2]) * n;
+            test[j] += (i % 2 == 0 ? 1e-14 : -1e-14) * n;
+        }
+        tests.push_back(test);
+    }
+
+    const Eigen::Index n = Eigen::Index(tests.size());
+    Eigen::MatrixXd e0(n, 3), e1(n, 3), f0(n, 3), f1(n, 3), f2(n, 3);
+    for (Eigen::Index i = 0; i < n; i++) {
+        e0.row(i) = tests[i][0];
+        e1.row(i) = tests[i][1];
+        f0.row(i) = tests[i][2];
+        f1.row(i) = tests[i][3];
+        f2.row(i) = tests[i][4];
+    }
+
+    ArrayXb batch_is_intersecting;
+    are_edges_intersecting_triangles(
+        e0, e1, f0, f1, f2, batch_is_intersecting);
+    REQUIRE(batch_is_intersecting.size() == n);
+
+    for (Eigen::Index i = 0; i < n; i++) {
+        CAPTURE(i);
+        CHECK(
+            batch_is_intersecting[i]
+            == is_edge_intersecting_triangle(
+                tests[i][0], tests[i][1], tests[i][2], tests[i][3],
+                tests[i][4]));
+    }
+}
+
 TEST_CASE("Test has_intersections()", "[intersection][thisone]")
 {
     std::string mesh1_name = GENERATE("cube.obj", "bunny.obj");
@@ -199,3 +299,28 @@ TEST_CASE("Test has_intersections()", "[intersection][thisone]")
     CAPTURE(mesh1_name, mesh2_name, R1, R2);
     CHECK(has_intersections(CollisionMesh(V, E, F), V));
 }
+
+TEST_CASE(
+    "Test has_intersections() with a prebuilt broad phase", "[intersection]")
+{
+    std::string mesh1_name = GENERATE("cube.obj", "bunny.obj");
+    int dim = GENERATE(2, 3);
+
+    Eigen::Matrix3d R1 = GENERATE(take(2, RotationGenerator::create()));
+    Eigen::Matrix3d R2 = GENERATE(take(2, RotationGenerator::create()));
+
+    Eigen::MatrixXd V;
+    Eigen::MatrixXi E, F;
+    bool success = combine_meshes(mesh1_name, mesh1_name, R1, R2, dim, V, E, F);
+    REQUIRE(success);
+
+    const CollisionMesh mesh(V, E, F);
+
+    HashGrid broad_phase;
+    broad_phase.can_vertices_collide = mesh.can_collide;
+    broad_phase.build(V, E, F, /*inflation_radius=*/0);
+
+    CAPTURE(mesh1_name, R1, R2);
+    CHECK(
+        has_intersections(broad_phase, mesh, V) == has_intersections(mesh, V));
+}
@@ -6,8 +6,17 @@
 #include <finitediff.hpp>
 
 #include <ipc/ipc.hpp>
+#include <ipc/approximate_potential.hpp>
+#include <ipc/broad_phase/hash_grid.hpp>
+#include <ipc/utils/execution_context.hpp>
+#include <ipc/utils/serialization.hpp>
 #include <ipc/config.hpp>
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <sstream>
+
 #include "test_utils.hpp"
 
 using namespace ipc;
@@ -65,6 +74,929 @@ TEST_CASE("Dummy test for IPC compilation", "[!benchmark][ipc]")
     };
 }
 
+TEST_CASE("Constraint set memory accounting", "[ipc][constraints]")
+{
+    Eigen::MatrixXd V;
+    Eigen::MatrixXi E, F;
+    REQUIRE(load_mesh("bunny.obj", V, E, F));
+
+    CollisionMesh mesh(V, E, F);
+
+    const double dhat = 1e-2;
+
+    Candidates candidates;
+    construct_collision_candidates(mesh, V, candidates, dhat / 2);
+    CHECK(candidates.bytes_used() > 0);
+    CHECK(candidates.peak_bytes_used() >= candidates.bytes_used());
+
+    Constraints constraint_set;
+    constraint_set.build(mesh, V, dhat);
+    REQUIRE(constraint_set.size() > 0);
+    const size_t built_bytes = constraint_set.bytes_used();
+    CHECK(built_bytes > 0);
+    CHECK(constraint_set.peak_bytes_used() >= built_bytes);
+    // The peak persists across clear().
+    constraint_set.clear();
+    CHECK(constraint_set.peak_bytes_used() >= built_bytes);
+    constraint_set.build(mesh, V, dhat);
+
+    FrictionConstraints friction_constraint_set;
+    construct_friction_constraint_set(
+        mesh, V, constraint_set, dhat, /*barrier_stiffness=*/1e3,
+        /*mus=*/Eigen::VectorXd::Constant(V.rows(), 0.5),
+        friction_constraint_set);
+    CHECK(friction_constraint_set.bytes_used() > 0);
+    CHECK(
+        friction_constraint_set.peak_bytes_used()
+        >= friction_constraint_set.bytes_used());
+}
+
+TEST_CASE("Execution context", "[ipc][execution-context]")
+{
+    Eigen::MatrixXd V;
+    Eigen::MatrixXi E, F;
+    REQUIRE(load_mesh("cube.obj", V, E, F));
+
+    CollisionMesh mesh(V, E, F);
+    const double dhat = sqrt(2.0);
+
+    Constraints constraint_set;
+    constraint_set.build(mesh, V, dhat);
+    const double expected_potential =
+        compute_barrier_potential(mesh, V, constraint_set, dhat);
+
+    // Rerun the pipeline inside a two-thread arena; only the thread count
+    // may change, not the results.
+    execution_context().set_max_concurrency(2);
+    CHECK(execution_context().max_concurrency() == 2);
+
+    Constraints arena_constraint_set;
+    arena_constraint_set.build(mesh, V, dhat);
+    CHECK(arena_constraint_set.size() == constraint_set.size());
+    CHECK(
+        compute_barrier_potential(mesh, V, arena_constraint_set, dhat)
+        == Approx(expected_potential));
+
+    // Restore the implicit global arena for the rest of the tests.
+    execution_context().set_max_concurrency(
+        ExecutionContext::AUTOMATIC_CONCURRENCY);
+    CHECK(
+        execution_context().max_concurrency()
+        == ExecutionContext::AUTOMATIC_CONCURRENCY);
+}
+
+TEST_CASE("Deterministic reductions", "[ipc][execution-context]")
+{
+    Eigen::MatrixXd V;
+    Eigen::MatrixXi E, F;
+    REQUIRE(load_mesh("bunny.obj", V, E, F));
+
+    CollisionMesh mesh(V, E, F);
+    const double dhat = 1e-2;
+
+    Constraints constraint_set;
+    constraint_set.build(mesh, V, dhat);
+    REQUIRE(constraint_set.size() > 0);
+
+    const double default_potential =
+        compute_barrier_potential(mesh, V, constraint_set, dhat);
+    const Eigen::VectorXd default_grad =
+        compute_barrier_potential_gradient(mesh, V, constraint_set, dhat);
+
+    execution_context().set_deterministic(true);
+    CHECK(execution_context().deterministic());
+
+    // Reruns of identical inputs must agree bitwise, not just to tolerance.
+    const double potential =
+        compute_barrier_potential(mesh, V, constraint_set, dhat);
+    CHECK(
+        potential == compute_barrier_potential(mesh, V, constraint_set, dhat));
+    const Eigen::VectorXd grad =
+        compute_barrier_potential_gradient(mesh, V, constraint_set, dhat);
+    CHECK(grad == compute_barrier_potential_gradient(
+              mesh, V, constraint_set, dhat));
+
+    // The blocked reduction only reorders the sums, so it stays within
+    // rounding of the thread-local result.
+    CHECK(potential == Approx(default_potential));
+    CHECK(grad.isApprox(default_grad));
+
+    execution_context().set_deterministic(false);
+    CHECK(!execution_context().deterministic());
+}
+
+TEST_CASE("Strided vertex views", "[ipc]")
+{
+    Eigen::MatrixXd V;
+    Eigen::MatrixXi E, F;
+    REQUIRE(load_mesh("cube.obj", V, E, F));
+
+    CollisionMesh mesh(V, E, F);
+    const double dhat = sqrt(2.0);
+
+    Constraints constraint_set;
+    constraint_set.build(mesh, V, dhat);
+
+    const double expected_potential =
+        compute_barrier_potential(mesh, V, constraint_set, dhat);
+    const Eigen::VectorXd expected_grad =
+        compute_barrier_potential_gradient(mesh, V, constraint_set, dhat);
+
+    // Row-major storage seen through runtime strides, as the Python bindings
+    // map a C-contiguous NumPy array (see ConstMatrixXdRef).
+    const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>
+        V_rowmajor = V;
+    const Eigen::Map<
+        const Eigen::MatrixXd, 0, Eigen::Stride<Eigen::Dynamic, Eigen::Dynamic>>
+        V_view(
+            V_rowmajor.data(), V.rows(), V.cols(),
+            Eigen::Stride<Eigen::Dynamic, Eigen::Dynamic>(1, V.cols()));
+    REQUIRE(V_view == V);
+
+    CHECK(
+        compute_barrier_potential(mesh, V_view, constraint_set, dhat)
+        == Approx(expected_potential));
+    CHECK(compute_barrier_potential_gradient(mesh, V_view, constraint_set, dhat)
+              .isApprox(expected_grad));
+}
+
+TEST_CASE("Warm-start constraint set update", "[ipc][constraints]")
+{
+    Eigen::MatrixXd V;
+    Eigen::MatrixXi E, F;
+    bool success = load_mesh("bunny.obj", V, E, F);
+    REQUIRE(success);
+
+    CollisionMesh mesh(V, E, F);
+
+    const double dhat = 1e-2;
+    const double margin = 1e-3;
+
+    HashGrid broad_phase;
+    broad_phase.set_build_margin(margin);
+
+    Constraints constraint_set;
+    constraint_set.update(broad_phase, mesh, V, dhat);
+    CHECK(constraint_set.size() > 0);
+
+    // Move the vertices by less than the build margin so the update reuses
+    // the cached candidates and skips the broad phase.
+    V += 0.1 * margin
+        * Eigen::MatrixXd::Random(V.rows(), V.cols()).cwiseAbs();
+    REQUIRE(!broad_phase.needs_rebuild(V, dhat / 1.99));
+
+    constraint_set.update(broad_phase, mesh, V, dhat);
+
+    Constraints expected_constraint_set;
+    expected_constraint_set.build(mesh, V, dhat);
+
+    CHECK(constraint_set.size() == expected_constraint_set.size());
+    CHECK(
+        ipc::compute_barrier_potential(mesh, V, constraint_set, dhat)
+        == Approx(ipc::compute_barrier_potential(
+            mesh, V, expected_constraint_set, dhat)));
+}
+
+TEST_CASE("Cached constraint distances", "[ipc][constraints]")
+{
+    Eigen::MatrixXd V;
+    Eigen::MatrixXi E, F;
+    bool success = load_mesh("bunny.obj", V, E, F);
+    REQUIRE(success);
+
+    CollisionMesh mesh(V, E, F);
+
+    const double dhat = 1e-2;
+
+    Constraints constraint_set;
+    constraint_set.build(mesh, V, dhat);
+    CHECK(constraint_set.size() > 0);
+    REQUIRE(constraint_set.are_cached_distances_valid(V));
+
+    // The cached distances must match a fresh evaluation.
+    for (size_t i = 0; i < constraint_set.size(); i++) {
+        CHECK(
+            constraint_set[i].cached_distance
+            == Approx(constraint_set[i].compute_distance(
+                V, mesh.edges(), mesh.faces())));
+    }
+
+    const double b =
+        ipc::compute_barrier_potential(mesh, V, constraint_set, dhat);
+    const Eigen::VectorXd grad_b =
+        ipc::compute_barrier_potential_gradient(mesh, V, constraint_set, dhat);
+
+    // The cached fast path must match an evaluation without the cache.
+    Constraints uncached_set = constraint_set;
+    for (size_t i = 0; i < uncached_set.size(); i++) {
+        uncached_set[i].cached_distance = -1;
+    }
+    CHECK(
+        b
+        == Approx(
+            ipc::compute_barrier_potential(mesh, V, uncached_set, dhat)));
+    CHECK(grad_b.isApprox(ipc::compute_barrier_potential_gradient(
+        mesh, V, uncached_set, dhat)));
+
+    // Moving any vertex invalidates the cache and the potential has to be
+    // recomputed from the new distances.
+    Eigen::MatrixXd V1 = V;
+    V1(0, 0) += 1e-8;
+    CHECK(!constraint_set.are_cached_distances_valid(V1));
+
+    constraint_set.build(mesh, V1, dhat);
+    CHECK(constraint_set.are_cached_distances_valid(V1));
+    CHECK(!constraint_set.are_cached_distances_valid(V));
+}
+
+TEST_CASE("Constraint set serialization round-trip", "[ipc][serialization]")
+{
+    Eigen::MatrixXd V;
+    Eigen::MatrixXi E, F;
+    bool success = load_mesh("bunny.obj", V, E, F);
+    REQUIRE(success);
+
+    CollisionMesh mesh(V, E, F);
+
+    const double dhat = 1e-2;
+
+    Constraints constraint_set;
+    constraint_set.build(mesh, V, dhat);
+    REQUIRE(constraint_set.size() > 0);
+
+    std::stringstream stream(
+        std::ios_base::in | std::ios_base::out | std::ios_base::binary);
+    save_constraints(stream, constraint_set);
+
+    Constraints loaded_set;
+    load_constraints(stream, loaded_set);
+
+    REQUIRE(loaded_set.size() == constraint_set.size());
+    REQUIRE(loaded_set.ee_constraints.size() > 0);
+    for (size_t i = 0; i < constraint_set.size(); i++) {
+        CHECK(loaded_set[i].weight == constraint_set[i].weight);
+        CHECK(
+            loaded_set[i].cached_distance
+            == constraint_set[i].cached_distance);
+    }
+    for (size_t i = 0; i < constraint_set.ee_constraints.size(); i++) {
+        CHECK(
+            loaded_set.ee_constraints[i].eps_x
+            == constraint_set.ee_constraints[i].eps_x);
+    }
+
+    // The loaded set must evaluate identically to the original.
+    CHECK(
+        ipc::compute_barrier_potential(mesh, V, loaded_set, dhat)
+        == Approx(
+            ipc::compute_barrier_potential(mesh, V, constraint_set, dhat)));
+    CHECK(ipc::compute_barrier_potential_gradient(mesh, V, loaded_set, dhat)
+              .isApprox(ipc::compute_barrier_potential_gradient(
+                  mesh, V, constraint_set, dhat)));
+
+    // A stream without a constraint set must be rejected.
+    std::stringstream garbage("not a constraint set");
+    CHECK_THROWS(load_constraints(garbage, loaded_set));
+}
+
+TEST_CASE("Potential with fused minimum distance", "[ipc][constraints]")
+{
+    Eigen::MatrixXd V;
+    Eigen::MatrixXi E, F;
+    bool success = load_mesh("bunny.obj", V, E, F);
+    REQUIRE(success);
+
+    CollisionMesh mesh(V, E, F);
+
+    const double dhat = 1e-2;
+
+    Constraints constraint_set;
+    constraint_set.build(mesh, V, dhat);
+    CHECK(constraint_set.size() > 0);
+
+    // Both the cached (batched) and the uncached evaluation must report the
+    // same minimum distance as a dedicated pass.
+    const double expected_min_dist =
+        ipc::compute_minimum_distance(mesh, V, constraint_set);
+    const double expected_b =
+        ipc::compute_barrier_potential(mesh, V, constraint_set, dhat);
+
+    double min_dist;
+    double b = ipc::compute_barrier_potential(
+        mesh, V, constraint_set, dhat, min_dist);
+    CHECK(b == Approx(expected_b));
+    CHECK(min_dist == Approx(expected_min_dist));
+
+    Constraints uncached_set = constraint_set;
+    for (size_t i = 0; i < uncached_set.size(); i++) {
+        uncached_set[i].cached_distance = -1;
+    }
+    b = ipc::compute_barrier_potential(mesh, V, uncached_set, dhat, min_dist);
+    CHECK(b == Approx(expected_b));
+    CHECK(min_dist == Approx(expected_min_dist));
+}
+
+TEST_CASE("Per-vertex dhat", "[ipc][constraints]")
+{
+    Eigen::MatrixXd V;
+    Eigen::MatrixXi E, F;
+    bool success = load_mesh("bunny.obj", V, E, F);
+    REQUIRE(success);
+
+    CollisionMesh mesh(V, E, F);
+
+    const double dhat_small = 1e-3, dhat_large = 1e-2;
+
+    Constraints scalar_set;
+    scalar_set.build(mesh, V, dhat_small);
+    REQUIRE(scalar_set.size() > 0);
+
+    // A uniform vertex_dhat must reproduce the scalar build, and the stamped
+    // local_dhat must override the dhat argument of the evaluations.
+    Constraints uniform_set;
+    uniform_set.vertex_dhat = Eigen::VectorXd::Constant(V.rows(), dhat_small);
+    uniform_set.build(mesh, V, dhat_large);
+    REQUIRE(uniform_set.size() == scalar_set.size());
+    for (size_t i = 0; i < uniform_set.size(); i++) {
+        CHECK(uniform_set[i].local_dhat == dhat_small);
+    }
+
+    const double expected_b =
+        ipc::compute_barrier_potential(mesh, V, scalar_set, dhat_small);
+    CHECK(
+        ipc::compute_barrier_potential(mesh, V, uniform_set, dhat_large)
+        == Approx(expected_b));
+    CHECK(
+        ipc::compute_barrier_potential_gradient(
+            mesh, V, uniform_set, dhat_large)
+            .isApprox(ipc::compute_barrier_potential_gradient(
+                mesh, V, scalar_set, dhat_small)));
+
+    // A mixed vertex_dhat produces a set between the two uniform ones.
+    Eigen::VectorXd vertex_dhat =
+        Eigen::VectorXd::Constant(V.rows(), dhat_small);
+    vertex_dhat.head(V.rows() / 2).setConstant(dhat_large);
+
+    Constraints large_set;
+    large_set.build(mesh, V, dhat_large);
+
+    Constraints mixed_set;
+    mixed_set.vertex_dhat = vertex_dhat;
+    mixed_set.build(mesh, V, dhat_large);
+    CHECK(mixed_set.size() >= scalar_set.size());
+    CHECK(mixed_set.size() <= large_set.size());
+    for (size_t i = 0; i < mixed_set.size(); i++) {
+        const double local_dhat = mixed_set[i].local_dhat;
+        CHECK((local_dhat == dhat_small || local_dhat == dhat_large));
+    }
+
+    const double mixed_b =
+        ipc::compute_barrier_potential(mesh, V, mixed_set, dhat_large);
+    CHECK(std::isfinite(mixed_b));
+    CHECK(mixed_b >= 0);
+}
+
+TEST_CASE("Vertex-locality constraint ordering", "[ipc][constraints]")
+{
+    Eigen::MatrixXd V;
+    Eigen::MatrixXi E, F;
+    bool success = load_mesh("bunny.obj", V, E, F);
+    REQUIRE(success);
+
+    CollisionMesh mesh(V, E, F);
+    const double dhat = 1e-2;
+
+    Constraints unsorted_set;
+    unsorted_set.build(mesh, V, dhat);
+    REQUIRE(unsorted_set.size() > 0);
+
+    Constraints sorted_set;
+    sorted_set.use_vertex_locality_ordering = true;
+    sorted_set.build(mesh, V, dhat);
+    REQUIRE(sorted_set.size() == unsorted_set.size());
+
+    // The reorder must not change what is evaluated.
+    CHECK(
+        ipc::compute_barrier_potential(mesh, V, sorted_set, dhat)
+        == Approx(ipc::compute_barrier_potential(mesh, V, unsorted_set, dhat)));
+    CHECK(ipc::compute_barrier_potential_gradient(mesh, V, sorted_set, dhat)
+              .isApprox(
+                  ipc::compute_barrier_potential_gradient(
+                      mesh, V, unsorted_set, dhat),
+                  1e-12));
+
+    // Each constraint vector is non-decreasing in minimum vertex index.
+    const auto min_vertex = [&](const CollisionConstraint& constraint) {
+        index_t min_id = std::numeric_limits<index_t>::max();
+        for (const index_t id : constraint.vertex_indices(E, F)) {
+            if (id >= 0) {
+                min_id = std::min(min_id, id);
+            }
+        }
+        return min_id;
+    };
+    index_t prev = -1;
+    size_t offset = 0;
+    for (const size_t count : { sorted_set.vv_constraints.size(),
+                                sorted_set.ev_constraints.size(),
+                                sorted_set.ee_constraints.size(),
+                                sorted_set.fv_constraints.size() }) {
+        prev = -1;
+        for (size_t i = 0; i < count; i++) {
+            const index_t key = min_vertex(sorted_set[offset + i]);
+            CHECK(key >= prev);
+            prev = key;
+        }
+        offset += count;
+    }
+}
+
+TEST_CASE("Edge-edge type bucketing", "[ipc][constraints]")
+{
+    Eigen::MatrixXd V;
+    Eigen::MatrixXi E, F;
+    bool success = load_mesh("bunny.obj", V, E, F);
+    REQUIRE(success);
+
+    CollisionMesh mesh(V, E, F);
+    const double dhat = 1e-2;
+
+    Constraints plain_set;
+    plain_set.build(mesh, V, dhat);
+    REQUIRE(plain_set.ee_constraints.size() > 0);
+
+    Constraints bucketed_set;
+    bucketed_set.use_edge_edge_type_bucketing = true;
+    bucketed_set.build(mesh, V, dhat);
+    REQUIRE(bucketed_set.size() == plain_set.size());
+
+    // The bucketed iteration must evaluate the same math.
+    CHECK(ipc::compute_barrier_potential_gradient(mesh, V, bucketed_set, dhat)
+              .isApprox(
+                  ipc::compute_barrier_potential_gradient(
+                      mesh, V, plain_set, dhat),
+                  1e-12));
+    const Eigen::MatrixXd plain_hess =
+        ipc::compute_barrier_potential_hessian(mesh, V, plain_set, dhat);
+    const Eigen::MatrixXd bucketed_hess =
+        ipc::compute_barrier_potential_hessian(mesh, V, bucketed_set, dhat);
+    CHECK(bucketed_hess.isApprox(plain_hess, 1e-12));
+
+    // The buckets partition the edge-edge indices and agree with a direct
+    // classification.
+    const auto& buckets = bucketed_set.edge_edge_type_buckets(V, E);
+    size_t num_bucketed = 0;
+    for (size_t t = 0; t < buckets.by_type.size(); t++) {
+        for (const size_t i : buckets.by_type[t]) {
+            REQUIRE(i < bucketed_set.ee_constraints.size());
+            const EdgeEdgeConstraint& ee = bucketed_set.ee_constraints[i];
+            CHECK(
+                edge_edge_distance_type(
+                    V.row(E(ee.edge0_index, 0)), V.row(E(ee.edge0_index, 1)),
+                    V.row(E(ee.edge1_index, 0)), V.row(E(ee.edge1_index, 1)))
+                == static_cast<EdgeEdgeDistanceType>(t));
+        }
+        num_bucketed += buckets.by_type[t].size();
+    }
+    CHECK(num_bucketed == bucketed_set.ee_constraints.size());
+}
+
+TEST_CASE("Top-k closest pairs", "[ipc][constraints]")
+{
+    Eigen::MatrixXd V;
+    Eigen::MatrixXi E, F;
+    bool success = load_mesh("bunny.obj", V, E, F);
+    REQUIRE(success);
+
+    CollisionMesh mesh(V, E, F);
+
+    Constraints constraint_set;
+    constraint_set.build(mesh, V, /*dhat=*/1e-2);
+    REQUIRE(constraint_set.size() > 0);
+
+    const int k = GENERATE(1, 10);
+    CAPTURE(k);
+
+    std::vector<std::pair<size_t, double>> closest_pairs;
+    const double min_dist = ipc::compute_minimum_distance(
+        mesh, V, constraint_set, k, closest_pairs);
+
+    CHECK(
+        min_dist == ipc::compute_minimum_distance(mesh, V, constraint_set));
+
+    // Compare against a full sort of all distances.
+    std::vector<std::pair<double, size_t>> all_dists;
+    for (size_t i = 0; i < constraint_set.size(); i++) {
+        all_dists.emplace_back(
+            constraint_set[i].compute_distance(V, mesh.edges(), mesh.faces()),
+            i);
+    }
+    std::sort(all_dists.begin(), all_dists.end());
+
+    REQUIRE(
+        closest_pairs.size() == std::min(size_t(k), constraint_set.size()));
+    CHECK(closest_pairs.front().second == min_dist);
+    for (size_t i = 0; i < closest_pairs.size(); i++) {
+        CHECK(closest_pairs[i].first == all_dists[i].second);
+        CHECK(closest_pairs[i].second == all_dists[i].first);
+    }
+}
+
+TEST_CASE("Cached hessian assembly", "[ipc][hessian]")
+{
+    Eigen::MatrixXd V;
+    Eigen::MatrixXi E, F;
+    bool success = load_mesh("bunny.obj", V, E, F);
+    REQUIRE(success);
+
+    CollisionMesh mesh(V, E, F);
+
+    const double dhat = 1e-2;
+
+    Constraints constraint_set;
+    constraint_set.build(mesh, V, dhat);
+    CHECK(constraint_set.size() > 0);
+
+    HessianAssemblyCache cache;
+
+    Eigen::MatrixXd hess_b = ipc::compute_barrier_potential_hessian(
+        mesh, V, constraint_set, dhat, cache);
+    Eigen::MatrixXd expected_hess_b = ipc::compute_barrier_potential_hessian(
+        mesh, V, constraint_set, dhat);
+    CHECK(hess_b.isApprox(expected_hess_b));
+
+    // A second assembly with the same constraint set reuses the cached
+    // pattern; perturb the vertices to make sure the values are recomputed.
+    V += 1e-4 * dhat * Eigen::MatrixXd::Random(V.rows(), V.cols());
+
+    hess_b = ipc::compute_barrier_potential_hessian(
+        mesh, V, constraint_set, dhat, cache);
+    expected_hess_b = ipc::compute_barrier_potential_hessian(
+        mesh, V, constraint_set, dhat);
+    CHECK(hess_b.isApprox(expected_hess_b));
+}
+
+TEST_CASE("Upper-triangular hessian assembly", "[ipc][hessian]")
+{
+    Eigen::MatrixXd V;
+    Eigen::MatrixXi E, F;
+    bool success = load_mesh("bunny.obj", V, E, F);
+    REQUIRE(success);
+
+    CollisionMesh mesh(V, E, F);
+
+    const double dhat = 1e-2;
+
+    Constraints constraint_set;
+    constraint_set.build(mesh, V, dhat);
+    CHECK(constraint_set.size() > 0);
+
+    const bool project_hessian_to_psd = GENERATE(false, true);
+    CAPTURE(project_hessian_to_psd);
+
+    const Eigen::SparseMatrix<double> upper =
+        ipc::compute_barrier_potential_hessian_upper(
+            mesh, V, constraint_set, dhat, project_hessian_to_psd);
+
+    // Only the upper triangle is stored.
+    for (int k = 0; k < upper.outerSize(); k++) {
+        for (Eigen::SparseMatrix<double>::InnerIterator it(upper, k); it;
+             ++it) {
+            REQUIRE(it.row() <= it.col());
+        }
+    }
+
+    const Eigen::SparseMatrix<double> full =
+        ipc::compute_barrier_potential_hessian(
+            mesh, V, constraint_set, dhat, project_hessian_to_psd);
+    CHECK(upper.nonZeros() < full.nonZeros());
+    CHECK(Eigen::MatrixXd(upper.selfadjointView<Eigen::Upper>())
+              .isApprox(Eigen::MatrixXd(full)));
+
+    // The bucketed edge-edge path owns its own scatter loops.
+    constraint_set.use_edge_edge_type_bucketing = true;
+    CHECK(Eigen::MatrixXd(
+              ipc::compute_barrier_potential_hessian_upper(
+                  mesh, V, constraint_set, dhat, project_hessian_to_psd)
+                  .selfadjointView<Eigen::Upper>())
+              .isApprox(Eigen::MatrixXd(full)));
+}
+
+TEST_CASE("Hessian assembly into caller-owned CSR", "[ipc][hessian]")
+{
+    Eigen::MatrixXd V;
+    Eigen::MatrixXi E, F;
+    bool success = load_mesh("bunny.obj", V, E, F);
+    REQUIRE(success);
+
+    CollisionMesh mesh(V, E, F);
+
+    const double dhat = 1e-2;
+
+    Constraints constraint_set;
+    constraint_set.build(mesh, V, dhat);
+    CHECK(constraint_set.size() > 0);
+
+    HessianAssemblyCache cache;
+
+    // Assembling values before agreeing on the pattern is an error.
+    std::vector<double> values;
+    CHECK_THROWS(ipc::compute_barrier_potential_hessian(
+        mesh, V, constraint_set, dhat, cache, values.data()));
+
+    CHECK(ipc::update_barrier_potential_hessian_pattern(
+        mesh, constraint_set, cache));
+
+    std::vector<int> row_offsets(mesh.ndof() + 1);
+    std::vector<int> column_indices(cache.num_non_zeros());
+    values.resize(cache.num_non_zeros());
+    cache.export_pattern(row_offsets.data(), column_indices.data());
+
+    ipc::compute_barrier_potential_hessian(
+        mesh, V, constraint_set, dhat, cache, values.data());
+
+    const Eigen::SparseMatrix<double> expected_hess =
+        ipc::compute_barrier_potential_hessian(mesh, V, constraint_set, dhat);
+
+    // Rebuild a matrix from the exported pattern and the values (the
+    // hessian is symmetric, so reading the CSR arrays as CSC is exact).
+    const Eigen::Map<const Eigen::SparseMatrix<double>> hess(
+        mesh.ndof(), mesh.ndof(), cache.num_non_zeros(), row_offsets.data(),
+        column_indices.data(), values.data());
+    CHECK(Eigen::MatrixXd(hess).isApprox(Eigen::MatrixXd(expected_hess)));
+
+    // The same constraint set leaves the agreed pattern unchanged.
+    CHECK(!ipc::update_barrier_potential_hessian_pattern(
+        mesh, constraint_set, cache));
+}
+
+TEST_CASE("Parallel triplet compression", "[ipc][hessian]")
+{
+    const long n = 101;
+    const int num_triplets = 20'000;
+
+    // Random entries with plenty of duplicate (row, col) pairs and some
+    // untouched rows and columns.
+    const Eigen::MatrixXd R = Eigen::MatrixXd::Random(num_triplets, 3);
+    std::vector<Eigen::Triplet<double>> triplets;
+    triplets.reserve(num_triplets);
+    for (int k = 0; k < num_triplets; k++) {
+        triplets.emplace_back(
+            int((R(k, 0) + 1) / 2 * (n - 2)), //
+            int((R(k, 1) + 1) / 2 * (n - 2)), //
+            R(k, 2));
+    }
+
+    Eigen::SparseMatrix<double> expected(n, n);
+    expected.setFromTriplets(triplets.begin(), triplets.end());
+
+    const Eigen::SparseMatrix<double> actual =
+        ipc::sparse_from_triplets(n, n, triplets);
+
+    CHECK(actual.isCompressed());
+    CHECK(actual.nonZeros() == expected.nonZeros());
+    CHECK(Eigen::MatrixXd(actual).isApprox(Eigen::MatrixXd(expected)));
+
+    std::vector<Eigen::Triplet<double>> no_triplets;
+    CHECK(ipc::sparse_from_triplets(n, n, no_triplets).nonZeros() == 0);
+}
+
+TEST_CASE("Approximate potential for line search", "[ipc][line-search]")
+{
+    Eigen::MatrixXd V;
+    Eigen::MatrixXi E, F;
+    bool success = load_mesh("bunny.obj", V, E, F);
+    REQUIRE(success);
+
+    CollisionMesh mesh(V, E, F);
+
+    const double dhat = 1e-2;
+
+    Constraints constraint_set;
+    constraint_set.build(mesh, V, dhat);
+    REQUIRE(constraint_set.size() > 0);
+
+    ApproximateBarrierPotential approx_potential;
+    const double p0 =
+        approx_potential.initialize(mesh, V, constraint_set, dhat);
+    CHECK(
+        p0 == Approx(compute_barrier_potential(mesh, V, constraint_set, dhat)));
+
+    // At the search origin the estimate matches the exact potential.
+    CHECK(approx_potential(V) == Approx(p0));
+
+    // A tiny trial step stays within the linearization's trust region for
+    // most constraints and the estimate stays close to the exact potential.
+    const Eigen::MatrixXd dV = Eigen::MatrixXd::Random(V.rows(), V.cols());
+    const Eigen::MatrixXd V_small = V + 1e-8 * dV;
+    CHECK(
+        approx_potential(V_small)
+        == Approx(compute_barrier_potential(mesh, V_small, constraint_set, dhat))
+               .epsilon(1e-6));
+    CHECK(approx_potential.num_exact() < constraint_set.size());
+
+    // A large trial step falls back to exact recomputation for the
+    // constraints it moves, so the estimate degrades gracefully.
+    const Eigen::MatrixXd V_large = V + dhat * dV;
+    CHECK(
+        approx_potential(V_large)
+        == Approx(compute_barrier_potential(mesh, V_large, constraint_set, dhat))
+               .epsilon(1e-2));
+    CHECK(approx_potential.num_exact() > 0);
+}
+
+TEST_CASE("Instanced collision mesh", "[ipc][collision-mesh]")
+{
+    Eigen::MatrixXd V;
+    Eigen::MatrixXi E, F;
+    bool success = load_mesh("bunny.obj", V, E, F);
+    REQUIRE(success);
+
+    const CollisionMesh prototype(V, E, F);
+
+    const Eigen::MatrixXd V2 =
+        V.rowwise() + Eigen::RowVector3d(1.0, -2.0, 3.0);
+    const CollisionMesh instance(prototype, V2);
+
+    // The topology is shared, not copied.
+    CHECK(&instance.edges() == &prototype.edges());
+    CHECK(&instance.faces() == &prototype.faces());
+    CHECK(&instance.faces_to_edges() == &prototype.faces_to_edges());
+
+    CHECK(instance.vertices_at_rest().isApprox(V2));
+
+    // The areas are recomputed per instance; a rigid translation leaves
+    // them unchanged.
+    CHECK(instance.vertex_areas().isApprox(prototype.vertex_areas()));
+    CHECK(instance.edge_areas().isApprox(prototype.edge_areas()));
+
+    const double dhat = 1e-2;
+    Constraints constraint_set;
+    constraint_set.build(instance, V2, dhat);
+    CHECK(constraint_set.size() > 0);
+}
+
+TEST_CASE("Cached full-DOF triple product", "[ipc][hessian]")
+{
+    Eigen::MatrixXd V;
+    Eigen::MatrixXi E, F;
+    bool success = load_mesh("bunny.obj", V, E, F);
+    REQUIRE(success);
+
+    // Append an unreferenced interior vertex so the DOF map is a proper
+    // selection and the cached product is not short-circuited by the
+    // identity fast path.
+    V.conservativeResize(V.rows() + 1, V.cols());
+    V.row(V.rows() - 1).setZero();
+
+    std::vector<bool> is_on_surface =
+        CollisionMesh::construct_is_on_surface(V.rows(), E);
+    CollisionMesh mesh(is_on_surface, V, E, F);
+    REQUIRE(!mesh.is_identity_dof_map());
+
+    const Eigen::MatrixXd V_collision = mesh.vertices(V);
+
+    const double dhat = 1e-2;
+
+    Constraints constraint_set;
+    constraint_set.build(mesh, V_collision, dhat);
+    CHECK(constraint_set.size() > 0);
+
+    const Eigen::SparseMatrix<double> hess_b =
+        ipc::compute_barrier_potential_hessian(
+            mesh, V_collision, constraint_set, dhat);
+
+    DofMapProductCache cache;
+    const Eigen::SparseMatrix<double> expected = mesh.to_full_dof(hess_b);
+
+    // Evaluate twice: the first call builds the cached symbolic product and
+    // the second reuses it.
+    for (int trial = 0; trial < 2; trial++) {
+        const Eigen::SparseMatrix<double> full_hess =
+            mesh.to_full_dof(hess_b, cache);
+        CHECK(Eigen::MatrixXd(full_hess)
+                  .isApprox(Eigen::MatrixXd(expected)));
+    }
+}
+
+TEST_CASE("Selection DOF map fast paths", "[ipc][collision-mesh]")
+{
+    Eigen::MatrixXd V;
+    Eigen::MatrixXi E, F;
+    bool success = load_mesh("bunny.obj", V, E, F);
+    REQUIRE(success);
+
+    // Append an unreferenced interior vertex so the DOF map is a proper
+    // selection rather than the identity.
+    V.conservativeResize(V.rows() + 1, V.cols());
+    V.row(V.rows() - 1).setZero();
+
+    std::vector<bool> is_on_surface =
+        CollisionMesh::construct_is_on_surface(V.rows(), E);
+    CollisionMesh mesh(is_on_surface, V, E, F);
+    REQUIRE(!mesh.is_identity_dof_map());
+    REQUIRE(mesh.is_selection_dof_map());
+
+    // The gather keeps each included vertex's row of the full positions.
+    const Eigen::MatrixXd V_collision = mesh.vertices(V);
+    for (int vi = 0; vi < mesh.num_vertices(); vi++) {
+        CHECK(V_collision.row(vi).isApprox(V.row(mesh.to_full_vertex_id(vi))));
+    }
+
+    const double dhat = 1e-2;
+    Constraints constraint_set;
+    constraint_set.build(mesh, V_collision, dhat);
+    REQUIRE(constraint_set.size() > 0);
+
+    // The gradient scatter fills the included DOF slots and leaves the
+    // excluded vertex's slots zero.
+    const Eigen::VectorXd grad =
+        ipc::compute_barrier_potential_gradient(
+            mesh, V_collision, constraint_set, dhat);
+    const Eigen::VectorXd full_grad = mesh.to_full_dof(grad);
+    REQUIRE(full_grad.size() == mesh.full_ndof());
+    const int dim = V.cols();
+    for (int vi = 0; vi < mesh.num_vertices(); vi++) {
+        CHECK(full_grad.segment(dim * mesh.to_full_vertex_id(vi), dim)
+                  .isApprox(grad.segment(dim * vi, dim)));
+    }
+    CHECK(
+        full_grad.segment(dim * (V.rows() - 1), dim).squaredNorm() == 0.0);
+
+    // The hessian's permuted copy matches the cached triple product, which
+    // still runs the real Tᵀ X T.
+    const Eigen::SparseMatrix<double> hess =
+        ipc::compute_barrier_potential_hessian(
+            mesh, V_collision, constraint_set, dhat);
+    const Eigen::SparseMatrix<double> full_hess = mesh.to_full_dof(hess);
+    DofMapProductCache cache;
+    const Eigen::SparseMatrix<double> expected =
+        mesh.to_full_dof(hess, cache);
+    CHECK(Eigen::MatrixXd(full_hess).isApprox(Eigen::MatrixXd(expected)));
+}
+
+TEST_CASE("Block sparse hessian assembly", "[ipc][hessian]")
+{
+    Eigen::MatrixXd V;
+    Eigen::MatrixXi E, F;
+    bool success = load_mesh("bunny.obj", V, E, F);
+    REQUIRE(success);
+
+    CollisionMesh mesh(V, E, F);
+
+    const double dhat = 1e-2;
+
+    Constraints constraint_set;
+    constraint_set.build(mesh, V, dhat);
+    CHECK(constraint_set.size() > 0);
+
+    BlockSparseMatrix hess_b = ipc::compute_barrier_potential_block_hessian(
+        mesh, V, constraint_set, dhat);
+    CHECK(hess_b.block_size() == V.cols());
+    CHECK(hess_b.num_block_rows() == V.rows());
+    CHECK(hess_b.num_block_cols() == V.rows());
+
+    const Eigen::MatrixXd expected_hess_b =
+        ipc::compute_barrier_potential_hessian(mesh, V, constraint_set, dhat);
+    CHECK(Eigen::MatrixXd(hess_b.to_sparse_matrix()).isApprox(
+        expected_hess_b));
+}
+
+TEST_CASE("Fused potential and derivatives", "[ipc][fused]")
+{
+    Eigen::MatrixXd V;
+    Eigen::MatrixXi E, F;
+    bool success = load_mesh("bunny.obj", V, E, F);
+    REQUIRE(success);
+
+    CollisionMesh mesh(V, E, F);
+
+    const double dhat = 1e-2;
+
+    Constraints constraint_set;
+    constraint_set.use_convergent_formulation = GENERATE(true, false);
+    constraint_set.build(mesh, V, dhat);
+    CHECK(constraint_set.size() > 0);
+
+    const bool project_hessian_to_psd = GENERATE(true, false);
+
+    Eigen::VectorXd grad_b;
+    Eigen::SparseMatrix<double> hess_b;
+    const double b = ipc::compute_barrier_potential_and_derivatives(
+        mesh, V, constraint_set, dhat, grad_b, hess_b,
+        project_hessian_to_psd);
+
+    CHECK(
+        b
+        == Approx(
+            ipc::compute_barrier_potential(mesh, V, constraint_set, dhat)));
+    CHECK(grad_b.isApprox(ipc::compute_barrier_potential_gradient(
+        mesh, V, constraint_set, dhat)));
+    CHECK(Eigen::MatrixXd(hess_b).isApprox(
+        Eigen::MatrixXd(ipc::compute_barrier_potential_hessian(
+            mesh, V, constraint_set, dhat, project_hessian_to_psd))));
+}
+
 TEST_CASE("Test IPC full gradient", "[ipc][gradient]")
 {
     double dhat = -1;
@@ -259,6 +1191,42 @@ TEST_CASE("Test IPC shape derivative", "[ipc][shape_opt]")
     if (!fd::compare_jacobian(JF_wrt_X, fd_JF_wrt_X)) {
         print_compare_nonzero(JF_wrt_X, fd_JF_wrt_X);
     }
+
+    // The cached-pattern assembly matches the triplet build. Evaluate twice:
+    // the first call builds the cached pattern and the second reuses it.
+    ShapeDerivativeAssemblyCache cache;
+    for (int trial = 0; trial < 2; trial++) {
+        const Eigen::MatrixXd cached_JF_wrt_X =
+            compute_barrier_shape_derivative(
+                mesh, V, constraint_set, dhat, cache);
+        CHECK(cached_JF_wrt_X.isApprox(JF_wrt_X));
+    }
+
+    // The fused hessian + shape-derivative pass matches the separate calls.
+    const bool project_hessian_to_psd = GENERATE(true, false);
+    const Eigen::MatrixXd expected_hess = compute_barrier_potential_hessian(
+        mesh, V, constraint_set, dhat, project_hessian_to_psd);
+
+    Eigen::SparseMatrix<double> fused_hess, fused_JF_wrt_X;
+    SECTION("Triplet assembly")
+    {
+        compute_barrier_potential_hessian_and_shape_derivative(
+            mesh, V, constraint_set, dhat, fused_hess, fused_JF_wrt_X,
+            project_hessian_to_psd);
+    }
+    SECTION("Cached assembly")
+    {
+        HessianAssemblyCache hessian_cache;
+        ShapeDerivativeAssemblyCache shape_derivative_cache;
+        for (int trial = 0; trial < 2; trial++) {
+            compute_barrier_potential_hessian_and_shape_derivative(
+                mesh, V, constraint_set, dhat, hessian_cache,
+                shape_derivative_cache, fused_hess, fused_JF_wrt_X,
+                project_hessian_to_psd);
+        }
+    }
+    CHECK(Eigen::MatrixXd(fused_hess).isApprox(expected_hess));
+    CHECK(Eigen::MatrixXd(fused_JF_wrt_X).isApprox(JF_wrt_X));
 }
 
 TEST_CASE("Benchmark IPC shape derivative", "[ipc][shape_opt][!benchmark]")
@@ -0,0 +1,74 @@
+#include <catch2/catch.hpp>
+
+#include <ipc/utils/save_obj.hpp>
+
+#include <cstdio> // std::remove
+#include <fstream>
+#include <sstream>
+
+using namespace ipc;
+
+TEST_CASE("Mesh dump round trip", "[utils][mesh_dump]")
+{
+    const int dim = GENERATE(2, 3);
+    CAPTURE(dim);
+
+    const Eigen::MatrixXd V = Eigen::MatrixXd::Random(25, dim);
+    Eigen::MatrixXi E(2, 2);
+    E << 0, 1, 2, 3;
+    Eigen::MatrixXi F(1, 3);
+    F << 4, 5, 6;
+
+    const std::string dump_filename = "mesh_dump_test.bin";
+    const std::string obj_filename = "mesh_dump_test.obj";
+
+    SECTION("Synchronous") { REQUIRE(save_mesh_dump(dump_filename, V, E, F)); }
+    SECTION("Asynchronous")
+    {
+        std::future<bool> done = save_mesh_dump_async(dump_filename, V, E, F);
+        REQUIRE(done.get());
+    }
+
+    REQUIRE(convert_mesh_dump_to_obj(dump_filename, obj_filename));
+
+    // The OBJ should contain exactly one element line per vertex/edge/face.
+    std::ifstream obj(obj_filename);
+    REQUIRE(obj.is_open());
+    int num_v = 0, num_l = 0, num_f = 0;
+    std::string line;
+    while (std::getline(obj, line)) {
+        std::istringstream tokens(line);
+        std::string tag;
+        tokens >> tag;
+        if (tag == "v") {
+            Eigen::Vector3d x;
+            tokens >> x.x() >> x.y() >> x.z();
+            CHECK(x.head(dim).transpose() == V.row(num_v));
+            if (dim == 2) {
+                CHECK(x.z() == 0);
+            }
+            num_v++;
+        } else if (tag == "l") {
+            num_l++;
+        } else if (tag == "f") {
+            num_f++;
+        }
+    }
+    CHECK(num_v == V.rows());
+    CHECK(num_l == E.rows());
+    CHECK(num_f == F.rows());
+
+    std::remove(dump_filename.c_str());
+    std::remove(obj_filename.c_str());
+}
+
+TEST_CASE("Truncated mesh dump", "[utils][mesh_dump]")
+{
+    const std::string dump_filename = "mesh_dump_truncated.bin";
+    {
+        std::ofstream out(dump_filename, std::ios::binary);
+        out.write("IPCMESH1", 8); // header only, no matrices
+    }
+    CHECK_THROWS(convert_mesh_dump_to_obj(dump_filename, "unused.obj"));
+    std::remove(dump_filename.c_str());
+}
@@ -0,0 +1,89 @@
+#include <catch2/catch.hpp>
+
+#include <ipc/ipc.hpp>
+#include <ipc/mesh_partition.hpp>
+
+#include <algorithm>
+#include <limits>
+
+#include "test_utils.hpp"
+
+using namespace ipc;
+
+TEST_CASE("Mesh partition", "[ipc][partition]")
+{
+    constexpr double inf = std::numeric_limits<double>::infinity();
+
+    Eigen::MatrixXd V0;
+    Eigen::MatrixXi E, F;
+    REQUIRE(load_mesh("bunny.obj", V0, E, F));
+
+    // Flip the mesh vertically so every element passes through the interior
+    // and the earliest time of impact is strictly less than one.
+    Eigen::MatrixXd V1 = V0;
+    V1.col(1) *= -1;
+
+    // Split space along x at the midpoint of the bounding box into two
+    // half-open domains that tile space.
+    const double x_mid =
+        0.5 * (V0.col(0).minCoeff() + V0.col(0).maxCoeff());
+    const std::vector<std::pair<Eigen::Array3d, Eigen::Array3d>> domains = {
+        { Eigen::Array3d(-inf, -inf, -inf), Eigen::Array3d(x_mid, inf, inf) },
+        { Eigen::Array3d(x_mid, -inf, -inf), Eigen::Array3d(inf, inf, inf) },
+    };
+
+    // Generous halo: more than any element's motion box diameter, so every
+    // colliding pair lands in the partition that owns one of its elements.
+    const double halo_radius =
+        0.25 * (V0.colwise().maxCoeff() - V0.colwise().minCoeff()).norm();
+
+    const CollisionMesh full_mesh(V0, E, F);
+    const double full_alpha =
+        compute_collision_free_stepsize(full_mesh, V0, V1);
+    REQUIRE(full_alpha < 1.0);
+
+    std::vector<int> vertex_owners(V0.rows(), 0);
+    std::vector<int> edge_owners(E.rows(), 0);
+    std::vector<int> face_owners(F.rows(), 0);
+
+    double min_partition_alpha = 1.0;
+    for (const auto& [domain_min, domain_max] : domains) {
+        const MeshPartition partition = build_mesh_partition(
+            V0, V1, E, F, domain_min, domain_max, halo_radius);
+        CAPTURE(partition.vertex_map.size(), partition.edge_map.size());
+        REQUIRE(partition.face_map.size() > 0);
+
+        for (size_t i = 0; i < partition.vertex_map.size(); i++) {
+            vertex_owners[partition.vertex_map[i]] +=
+                partition.is_vertex_owned[i];
+        }
+        for (size_t i = 0; i < partition.edge_map.size(); i++) {
+            edge_owners[partition.edge_map[i]] += partition.is_edge_owned[i];
+        }
+        for (size_t i = 0; i < partition.face_map.size(); i++) {
+            face_owners[partition.face_map[i]] += partition.is_face_owned[i];
+        }
+
+        // The partition is a valid collision mesh on its own (in particular
+        // every edge of every included face is included).
+        const CollisionMesh mesh(
+            partition.vertices(V0), partition.edges, partition.faces);
+
+        min_partition_alpha = std::min(
+            min_partition_alpha,
+            compute_collision_free_stepsize(
+                mesh, partition.vertices(V0), partition.vertices(V1)));
+    }
+
+    // The domains tile space, so every element is owned by exactly one.
+    CHECK(std::count(vertex_owners.begin(), vertex_owners.end(), 1)
+          == long(vertex_owners.size()));
+    CHECK(std::count(edge_owners.begin(), edge_owners.end(), 1)
+          == long(edge_owners.size()));
+    CHECK(std::count(face_owners.begin(), face_owners.end(), 1)
+          == long(face_owners.size()));
+
+    // The caller-side reduction: the minimum over the partition step sizes
+    // matches the full-mesh step size.
+    CHECK(min_partition_alpha == Approx(full_alpha));
+}
@@ -0,0 +1,84 @@
+#include <catch2/catch.hpp>
+
+#include <ipc/ipc.hpp>
+#include <ipc/scene.hpp>
+
+#include "test_utils.hpp"
+
+using namespace ipc;
+
+TEST_CASE("Stateful scene", "[ipc][scene]")
+{
+    Eigen::MatrixXd V;
+    Eigen::MatrixXi E, F;
+    REQUIRE(load_mesh("two-cubes-close.obj", V, E, F));
+
+    const CollisionMesh mesh(V, E, F);
+    const double dhat = 1e-1;
+
+    Scene scene(mesh, dhat);
+
+    // Two steps through the same scene so the warm caches are exercised.
+    for (int step = 0; step < 2; step++) {
+        CAPTURE(step);
+        Eigen::MatrixXd V_step = V;
+        V_step.col(0).array() += 1e-3 * step;
+
+        scene.build_constraints(V_step);
+
+        // The scene's results must match the free functions on a freshly
+        // built constraint set.
+        Constraints expected_set;
+        expected_set.build(mesh, V_step, dhat);
+        REQUIRE(scene.constraint_set().size() == expected_set.size());
+        REQUIRE(expected_set.size() > 0);
+
+        CHECK(
+            scene.compute_barrier_potential(V_step)
+            == Approx(ipc::compute_barrier_potential(
+                mesh, V_step, expected_set, dhat)));
+        CHECK(scene.compute_barrier_potential_gradient(V_step)
+                  .isApprox(ipc::compute_barrier_potential_gradient(
+                      mesh, V_step, expected_set, dhat)));
+        CHECK(
+            scene.compute_minimum_distance(V_step)
+            == Approx(
+                ipc::compute_minimum_distance(mesh, V_step, expected_set)));
+
+        // The fused iteration derivatives agree with the separate calls.
+        const IterationDerivatives derivatives =
+            scene.compute_iteration_derivatives(V_step);
+        CHECK(
+            derivatives.barrier_potential
+            == Approx(scene.compute_barrier_potential(V_step)));
+        CHECK(derivatives.barrier_gradient.isApprox(
+            scene.compute_barrier_potential_gradient(V_step)));
+        CHECK(Eigen::MatrixXd(derivatives.barrier_hessian)
+                  .isApprox(Eigen::MatrixXd(
+                      scene.compute_barrier_potential_hessian(V_step))));
+
+        CHECK(!scene.has_intersections(V_step));
+
+        // A step towards the other cube is limited by CCD; a tiny step is
+        // not.
+        Eigen::MatrixXd V_target = V_step;
+        V_target.col(0).array() += 2.0;
+        CHECK(scene.compute_collision_free_stepsize(V_step, V_target) < 1.0);
+        CHECK(
+            scene.compute_collision_free_stepsize(V_step, V_step) == 1.0);
+
+        // Friction terms appear in the derivatives once a set is built.
+        scene.build_friction_constraints(
+            V_step, /*barrier_stiffness=*/1e3,
+            Eigen::VectorXd::Constant(mesh.num_vertices(), 0.5),
+            /*epsv_times_h=*/1e-3);
+        if (!scene.friction_constraint_set().empty()) {
+            Eigen::MatrixXd V_slide = V_step;
+            V_slide.col(1).array() += 1e-3;
+            CHECK(scene.compute_friction_potential(V_slide) > 0);
+            const IterationDerivatives with_friction =
+                scene.compute_iteration_derivatives(V_slide);
+            CHECK(with_friction.friction_gradient.size() == V.size());
+        }
+    }
+}
@@ -0,0 +1,76 @@
+#include <catch2/catch.hpp>
+
+#include <ipc/ipc.hpp>
+#include <ipc/scene_batch.hpp>
+
+#include "test_utils.hpp"
+
+#include <cmath>
+
+using namespace ipc;
+
+TEST_CASE("Batched multi-scene evaluation", "[ipc][scene-batch]")
+{
+    Eigen::MatrixXd V_cubes, V_bunny;
+    Eigen::MatrixXi E_cubes, F_cubes, E_bunny, F_bunny;
+    REQUIRE(load_mesh("two-cubes-close.obj", V_cubes, E_cubes, F_cubes));
+    REQUIRE(load_mesh("bunny.obj", V_bunny, E_bunny, F_bunny));
+
+    CollisionMesh cubes_mesh(V_cubes, E_cubes, F_cubes);
+    CollisionMesh bunny_mesh(V_bunny, E_bunny, F_bunny);
+
+    const double dhat = GENERATE(1e-1, 1e-2);
+    CAPTURE(dhat);
+
+    // Alternate the two meshes and translate each scene so the batch is not
+    // just one scene repeated.
+    const size_t num_scenes = 6;
+    SceneBatch batch;
+    std::vector<Eigen::MatrixXd> positions;
+    std::vector<const CollisionMesh*> meshes;
+    for (size_t s = 0; s < num_scenes; s++) {
+        const bool use_bunny = s % 2 == 1;
+        meshes.push_back(use_bunny ? &bunny_mesh : &cubes_mesh);
+        batch.add_scene(*meshes.back());
+        positions.push_back(use_bunny ? V_bunny : V_cubes);
+        positions.back().col(0).array() += double(s);
+    }
+
+    batch.build_constraints(positions, dhat);
+
+    Eigen::VectorXd potentials, min_dists;
+    batch.compute_barrier_potentials(positions, dhat, potentials, &min_dists);
+    std::vector<Eigen::VectorXd> gradients;
+    batch.compute_barrier_potential_gradients(positions, dhat, gradients);
+
+    REQUIRE(potentials.size() == long(num_scenes));
+    REQUIRE(min_dists.size() == long(num_scenes));
+    REQUIRE(gradients.size() == num_scenes);
+
+    // Every scene must match the per-scene entry points.
+    for (size_t s = 0; s < num_scenes; s++) {
+        CAPTURE(s);
+        const CollisionMesh& mesh = *meshes[s];
+        const Eigen::MatrixXd& V = positions[s];
+
+        Constraints expected_set;
+        expected_set.build(mesh, V, dhat);
+        REQUIRE(batch.constraint_set(s).size() == expected_set.size());
+
+        CHECK(
+            potentials[s]
+            == Approx(ipc::compute_barrier_potential(
+                mesh, V, expected_set, dhat)));
+        if (expected_set.size() > 0) {
+            CHECK(
+                min_dists[s]
+                == Approx(
+                    ipc::compute_minimum_distance(mesh, V, expected_set)));
+        } else {
+            CHECK(std::isinf(min_dists[s]));
+        }
+        CHECK(gradients[s].isApprox(
+            ipc::compute_barrier_potential_gradient(
+                mesh, V, expected_set, dhat)));
+    }
+}
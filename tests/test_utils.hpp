@@ -14,8 +14,9 @@
 #ifdef IPC_TOOLKIT_WITH_CUDA
 #define NUM_BROAD_PHASE_METHODS static_cast<int>(BroadPhaseMethod::NUM_METHODS)
 #else
+// Skip the two GPU methods at the end of the enumeration.
 #define NUM_BROAD_PHASE_METHODS                                                \
-    (static_cast<int>(BroadPhaseMethod::NUM_METHODS) - 1)
+    (static_cast<int>(BroadPhaseMethod::NUM_METHODS) - 2)
 #endif
 
 #define GENERATE_BROAD_PHASE_METHODS()                                         \